@@ -53,12 +53,41 @@ typedef struct
     FACILEDB_RECORD_T *p_data_records;
 } FACILEDB_DATA_T;
 
+// Access path of an equal search, chosen by the estimated cost of reading the data.
+typedef enum
+{
+    FACILEDB_SEARCH_PLAN_SEQUENTIAL, // read all the blocks in order
+    FACILEDB_SEARCH_PLAN_INDEXED,    // read the data found by the index of a record
+    FACILEDB_SEARCH_PLAN_COMPOSITE,  // read the data found by a composite index
+    FACILEDB_SEARCH_PLAN_NUM
+} FACILEDB_SEARCH_PLAN_E;
+
+// Costs are counted in blocks read in order.
+typedef struct
+{
+    FACILEDB_SEARCH_PLAN_E search_plan;
+    uint32_t record_position;    // record searched by FACILEDB_SEARCH_PLAN_INDEXED, the other records are compared with its results
+    uint64_t estimated_data_num; // data read by the plan
+    uint64_t estimated_cost;
+    uint64_t sequential_cost;
+} FACILEDB_SEARCH_PLAN_T;
+
 void FacileDB_Api_Init(char *p_db_directory_path);
 void FacileDB_Api_Close();
 bool FacileDB_Api_Check_Set_Exist(char *p_db_set_name);
 uint32_t FacileDB_Api_Insert_Data(char *p_db_set_name, FACILEDB_DATA_T *p_faciledb_data);
 FACILEDB_DATA_T *FacileDB_Api_Search_Equal(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_record, uint32_t *p_faciledb_data_num);
 uint32_t FacileDB_Api_Delete_Equal(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_record);
+// Search the data having all the records.
+// The equal searches choose among the sequential search and the indexes by the estimated cost.
+FACILEDB_DATA_T *FacileDB_Api_Search_Equal_Records(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_records, uint32_t record_num, uint32_t *p_faciledb_data_num);
+// Explain the plan of FacileDB_Api_Search_Equal_Records() without reading the data.
+bool FacileDB_Api_Explain_Search_Equal_Records(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_records, uint32_t record_num, FACILEDB_SEARCH_PLAN_T *p_faciledb_search_plan);
+// Cost of reading a block at random, reading a block in order costs 1.
+// The lower cost favors the indexes, 0 always uses an index if any.
+void FacileDB_Api_Set_Search_Plan_Random_Block_Cost(uint32_t random_block_cost);
+// Set the max number of set files kept open, the least recently used idle one is closed to open another set.
+void FacileDB_Api_Set_Open_Set_File_Num(uint32_t open_set_file_num);
 
 void FacileDB_Api_Free_Data_Buffer(FACILEDB_DATA_T *p_faciledb_data);
 void FacileDB_Api_Free_Record_Buffer(FACILEDB_RECORD_T *p_facilledb_record);
@@ -66,6 +95,18 @@ void FacileDB_Api_Free_Record_Buffer(FACILEDB_RECORD_T *p_facilledb_record);
 #if ENABLE_DB_INDEX
 // p_faciledb_record: p_value and value_size could be any value.
 bool FacileDB_Api_Make_Record_Index(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_record);
+// Make a covering index which also stores the records of the covered keys of each data in the index side.
+// p_covered_records: p_key and key_size of each covered key, the other fields could be any value.
+// covered_record_num = 0 means all the records of the data are covered, and FacileDB_Api_Search_Equal() doesn't read the set file.
+bool FacileDB_Api_Make_Covering_Record_Index(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_record, FACILEDB_RECORD_T *p_covered_records, uint32_t covered_record_num);
+// Search by the covering index of the record key without reading the set file.
+// Each result data contains the indexed record and the covered records only.
+// Return NULL if the record key doesn't have a covering index.
+FACILEDB_DATA_T *FacileDB_Api_Search_Equal_Covered(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_record, uint32_t *p_faciledb_data_num);
+// Make a composite index over the record keys in order, the data are indexed in the order of the value tuples of their leading keys.
+// p_faciledb_records: p_key, key_size and record_value_type of each key, 2 to DB_COMPOSITE_INDEX_MAX_COLUMN_NUM keys.
+// The searches whose records cover the leading keys use the composite index.
+bool FacileDB_Api_Make_Composite_Record_Index(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_records, uint32_t record_num);
 #endif
 
 #endif // __FACILEDB_H__
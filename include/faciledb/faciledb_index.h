@@ -6,7 +6,11 @@
 typedef struct
 {
     uint64_t data_tag;
-    uint64_t start_db_block_tag; // The first block tag of the data.
+    union
+    {
+        uint64_t start_db_block_tag;    // The first block tag of the data.
+        uint64_t covering_entry_offset; // Offset of the data entry in the covering file, used by the covering indexes.
+    };
 } DB_INDEX_PAYLOAD_T;
 
 #define INDEX_PAYLOAD_SIZE (sizeof(DB_INDEX_PAYLOAD_T))
@@ -8,12 +8,44 @@
 #include "faciledb_index.h"
 #endif
 
-#ifndef INDEX_ORDER
-#define INDEX_ORDER (5)
+// Default size in bytes of an index node in the index file, the order of a new index file is derived from it.
+// Define INDEX_ORDER to create index files with a fixed order instead, until Index_Api_Set_Node_Size() is called.
+#ifndef INDEX_NODE_SIZE
+#define INDEX_NODE_SIZE (4096)
+#endif
+
+// Range of the node size, the buffers of a node split are allocated on the stack by the order.
+#define INDEX_MIN_NODE_SIZE (256)
+#define INDEX_MAX_NODE_SIZE (65536)
+
+#if (INDEX_NODE_SIZE < INDEX_MIN_NODE_SIZE) || (INDEX_NODE_SIZE > INDEX_MAX_NODE_SIZE)
+#error "INDEX_NODE_SIZE is out of [INDEX_MIN_NODE_SIZE, INDEX_MAX_NODE_SIZE]"
+#endif
+
+#define INDEX_MIN_ORDER (3)
+
+// Percentage of each node filled by Index_Api_Bulk_Build(), the rest is reserved for the later insertions.
+#ifndef INDEX_BULK_BUILD_FILL_FACTOR
+#define INDEX_BULK_BUILD_FILL_FACTOR (90)
+#endif
+
+#define INDEX_BULK_BUILD_MIN_FILL_FACTOR (50)
+#define INDEX_BULK_BUILD_MAX_FILL_FACTOR (100)
+
+// Number of insertions buffered per B+ tree index before they are merged into the tree in a batch.
+// 0 inserts every element into the tree directly.
+#ifndef INDEX_WRITE_BUFFER_ELEMENT_NUM
+#define INDEX_WRITE_BUFFER_ELEMENT_NUM (64)
+#endif
+
+// Length of a run of equal index ids in a B+ tree leaf node at which the run is gathered into a posting list.
+// The payloads of the index id are then stored in posting nodes linked from a single element, 0 keeps every duplicate as an element.
+#ifndef INDEX_POSTING_LIST_MIN_LENGTH
+#define INDEX_POSTING_LIST_MIN_LENGTH (64)
 #endif
 
 #ifndef INDEX_PAYLOAD_SIZE
-// ((INDEX_PAYLOAD_SIZE + sizeof(index_id)) * INDEX_ORDER) should be divisible by 4.
+// ((INDEX_PAYLOAD_SIZE + sizeof(index_id)) * order) should be divisible by 4.
 #define INDEX_PAYLOAD_SIZE (16)
 #endif
 
@@ -21,7 +53,6 @@
 #define INDEX_FILE_PATH_BUFFER_LENGTH (256)
 #endif
 
-#define INDEX_CHILD_TAG_ORDER (INDEX_ORDER + 1)
 #define INDEX_FILE_PATH_MAX_LENGTH (INDEX_FILE_PATH_BUFFER_LENGTH - 1)
 
 typedef enum
@@ -36,11 +67,40 @@ typedef enum
     INDEX_ID_TYPE_INVALID = INDEX_ID_TYPE_NUM
 } INDEX_ID_TYPE_E;
 
+// Structure of an index file, decided when the index file is created.
+typedef enum
+{
+    INDEX_STRUCTURE_BTREE = 0, // B+ tree, supports the equal and range search.
+    INDEX_STRUCTURE_HASH,      // Linear hashing with bucket nodes, supports the equal search only.
+    INDEX_STRUCTURE_NUM
+} INDEX_STRUCTURE_E;
+
+// Statistics of the elements of an index file, collected by a scan of the index and kept until enough elements are changed.
+typedef struct
+{
+    uint64_t element_num;          // number of elements, each duplicated index id is counted by its payloads.
+    uint64_t distinct_num;         // number of distinct index ids
+    uint32_t histogram_bucket_num; // buckets of the equi-depth histogram of a B+ tree, a hash index has no histogram.
+} INDEX_STATISTICS_T;
+
 void Index_Api_Init(char *p_index_directory_path);
+void Index_Api_Set_Node_Size(uint32_t node_size);
+void Index_Api_Set_Bulk_Build_Fill_Factor(uint32_t fill_factor);
+void Index_Api_Set_Index_Structure(INDEX_STRUCTURE_E structure);
+void Index_Api_Set_Open_Index_File_Num(uint32_t open_index_file_num);
+void Index_Api_Set_Write_Buffer_Size(uint32_t element_num);
+void Index_Api_Set_Posting_List_Min_Length(uint32_t min_length);
 bool Index_Api_Index_Key_Exist(char *p_index_key);
+INDEX_ID_TYPE_E Index_Api_Get_Index_Id_Type(char *p_index_key);
+INDEX_STRUCTURE_E Index_Api_Get_Index_Structure(char *p_index_key);
 void Index_Api_Insert_Element(char *p_index_key, void *p_index_id, INDEX_ID_TYPE_E index_id_type, void *p_index_payload, uint32_t payload_size);
+void Index_Api_Bulk_Build(char *p_index_key, INDEX_ID_TYPE_E index_id_type, void *p_index_ids, void *p_index_payloads, uint32_t payload_size, uint32_t element_num);
+bool Index_Api_Delete_Element(char *p_index_key, void *p_index_id, INDEX_ID_TYPE_E index_id_type, void *p_index_payload, uint32_t payload_size);
 void *Index_Api_Search_Equal(char *p_index_key, void *p_target_index_id, INDEX_ID_TYPE_E index_id_type, uint32_t *p_result_length);
+void *Index_Api_Search_Range(char *p_index_key, void *p_lower_index_id, void *p_upper_index_id, INDEX_ID_TYPE_E index_id_type, uint32_t *p_result_length);
 void Index_Api_Free_Search_Result(void *p_result);
+bool Index_Api_Get_Statistics(char *p_index_key, INDEX_ID_TYPE_E index_id_type, INDEX_STATISTICS_T *p_index_statistics);
+uint64_t Index_Api_Estimate_Range(char *p_index_key, void *p_lower_index_id, void *p_upper_index_id, INDEX_ID_TYPE_E index_id_type);
 void Index_Api_Close();
 
 #endif // __INDEX_H__
\ No newline at end of file
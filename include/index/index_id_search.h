@@ -0,0 +1,25 @@
+#ifndef __INDEX_ID_SEARCH_H__
+#define __INDEX_ID_SEARCH_H__
+
+#include <stdint.h>
+
+#include "index.h"
+
+typedef enum
+{
+    INDEX_ID_SEARCH_ISA_SCALAR = 0,
+    INDEX_ID_SEARCH_ISA_SSE,  // SSE4.2
+    INDEX_ID_SEARCH_ISA_AVX2,
+    INDEX_ID_SEARCH_ISA_NUM
+} INDEX_ID_SEARCH_ISA_E;
+
+// Return the minimum position in the sorted index id array where the index id is equal or greater than the target,
+// which is also the number of index ids smaller than the target.
+typedef uint32_t (*INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION_T)(const void *p_index_ids, uint32_t length, const void *p_target);
+
+// Choose the fastest search function supported by the CPU for the index id type.
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION_T Index_Id_Search_Get_Lower_Bound_Function(INDEX_ID_TYPE_E index_id_type);
+// Return NULL if the instruction set is not supported by the CPU or the build.
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION_T Index_Id_Search_Get_Lower_Bound_Function_By_Isa(INDEX_ID_TYPE_E index_id_type, INDEX_ID_SEARCH_ISA_E isa);
+
+#endif // __INDEX_ID_SEARCH_H__
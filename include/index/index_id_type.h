@@ -2,8 +2,41 @@
 #define __INDEX_ID_TYPE_COMPARE_H__
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "index.h"
+#include "hash.h"
+
+// Number of leading bytes of a string kept in the string index id.
+#ifndef INDEX_ID_STRING_PREFIX_SIZE
+#define INDEX_ID_STRING_PREFIX_SIZE (24)
+#endif
+
+// String index id, ordered by the zero-padded prefix and then by the 64-bit hash of the whole string.
+// Strings shorter than the prefix are stored entirely, so their index ids are equal only if the strings are equal.
+// Longer strings sharing the prefix are ordered by the hash, and the equality should be verified by the strings.
+// Index_Api_Search_Range() rejects the string ranges whose order depends on the hash.
+typedef struct
+{
+    uint8_t prefix[INDEX_ID_STRING_PREFIX_SIZE];
+    HASH64_VALUE_T hash_value;
+} INDEX_ID_STRING_T;
+
+// Number of leading bytes of the encoded columns kept in the composite index id.
+#ifndef INDEX_ID_COMPOSITE_PREFIX_SIZE
+#define INDEX_ID_COMPOSITE_PREFIX_SIZE (32)
+#endif
+
+// Composite index id of an ordered list of columns, ordered by the zero-padded prefix of the encoded columns and then by the 64-bit hash of them.
+// The columns are encoded by Index_Id_Type_Encode_Composite_Column(), whose bytes keep the order of the column tuples.
+typedef struct
+{
+    uint8_t prefix[INDEX_ID_COMPOSITE_PREFIX_SIZE];
+    HASH64_VALUE_T hash_value;
+} INDEX_ID_COMPOSITE_T;
+
+// Size of the largest index id type, for the buffers holding an index id of any type.
+#define INDEX_ID_MAX_SIZE ((sizeof(INDEX_ID_COMPOSITE_T) > sizeof(INDEX_ID_STRING_T)) ? sizeof(INDEX_ID_COMPOSITE_T) : sizeof(INDEX_ID_STRING_T))
 
 typedef enum
 {
@@ -14,5 +47,34 @@ typedef enum
 
 INDEX_ID_COMPARE_RESULT_E Index_Id_Type_Compare(INDEX_ID_TYPE_E index_id_type, void *value1, void *value2);
 uint32_t Index_Id_Type_Get_Size(INDEX_ID_TYPE_E index_id_type);
+// Return the leading bytes of the index id which are ordered by memcmp(), 0 if the index id type isn't ordered by its bytes.
+uint32_t Index_Id_Type_Get_Ordered_Prefix_Size(INDEX_ID_TYPE_E index_id_type);
+// Set up the separator of two index ids, p_left_index_id < separator <= p_right_index_id, with the most trailing zero bytes.
+// It's the leading bytes of the right index id up to the first byte differing from the left one, the rest are zero.
+// Return false if the ordered prefixes of the index ids are equal, the separator is the right index id.
+bool Index_Id_Type_Set_Separator(INDEX_ID_TYPE_E index_id_type, void *p_separator, void *p_left_index_id, void *p_right_index_id);
+// Set up the string index id from p_string, which ends at the first '\0' or string_size bytes.
+void Index_Id_Type_Set_String(void *p_index_id, const uint8_t *p_string, uint32_t string_size);
+// Return true if the string index id holds the whole string.
+bool Index_Id_Type_Is_String_Complete(void *p_index_id);
+// Return true if the string index id can bound a range search: it holds the whole string, or it's set by Index_Id_Type_Set_String_Prefix_Range().
+// A truncated string index id is ordered by the hash among the strings sharing its prefix, so it can't bound them.
+bool Index_Id_Type_Is_String_Range_Bound(void *p_index_id);
+// Return true if the lexicographic order of the strings of two index ids can't be decided by them.
+// They're truncated strings sharing the prefix, and the strings are different.
+bool Index_Id_Type_Is_String_Order_Unknown(void *p_index_id_1, void *p_index_id_2);
+// Set up the bounds of the string index ids whose strings start with p_prefix.
+// Return false if the prefix is longer than INDEX_ID_STRING_PREFIX_SIZE, the range may also contain other strings sharing the leading bytes.
+bool Index_Id_Type_Set_String_Prefix_Range(void *p_lower_index_id, void *p_upper_index_id, const uint8_t *p_prefix, uint32_t prefix_size);
+// Return the maximum bytes of an encoded column whose value has value_size bytes.
+uint32_t Index_Id_Type_Get_Composite_Column_Max_Size(uint32_t value_size);
+// Encode the column value of column_index_id_type into p_buffer, the bytes compare by memcmp() in the order of the values.
+// Strings are encoded until the first '\0' or value_size bytes. Return the encoded bytes, 0 if the type can't be a column.
+uint32_t Index_Id_Type_Encode_Composite_Column(uint8_t *p_buffer, INDEX_ID_TYPE_E column_index_id_type, const void *p_value, uint32_t value_size);
+// Set up the composite index id from the encoded columns.
+void Index_Id_Type_Set_Composite(void *p_index_id, const uint8_t *p_encoded_columns, uint32_t encoded_columns_size);
+// Set up the bounds of the composite index ids whose leading columns are encoded as p_encoded_prefix.
+// Return false if the encoded prefix is longer than INDEX_ID_COMPOSITE_PREFIX_SIZE, the range may also contain other columns sharing the leading bytes.
+bool Index_Id_Type_Set_Composite_Prefix_Range(void *p_lower_index_id, void *p_upper_index_id, const uint8_t *p_encoded_prefix, uint32_t encoded_prefix_size);
 
 #endif
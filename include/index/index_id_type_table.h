@@ -11,4 +11,7 @@ INDEX_ID_TYPE_CONFIG(INDEX_ID_TYPE_INT32, sizeof(int32_t))
 INDEX_ID_TYPE_CONFIG(INDEX_ID_TYPE_UINT64, sizeof(uint64_t))
 INDEX_ID_TYPE_CONFIG(INDEX_ID_TYPE_INT64, sizeof(int64_t))
 INDEX_ID_TYPE_CONFIG(INDEX_ID_TYPE_FLOAT, sizeof(float))
-INDEX_ID_TYPE_CONFIG(INDEX_ID_TYPE_DOUBLE, sizeof(double))
\ No newline at end of file
+INDEX_ID_TYPE_CONFIG(INDEX_ID_TYPE_DOUBLE, sizeof(double))
+INDEX_ID_TYPE_CONFIG(INDEX_ID_TYPE_STRING, sizeof(INDEX_ID_STRING_T))
+INDEX_ID_TYPE_CONFIG(INDEX_ID_TYPE_HASH64, sizeof(HASH64_VALUE_T))
+INDEX_ID_TYPE_CONFIG(INDEX_ID_TYPE_COMPOSITE, sizeof(INDEX_ID_COMPOSITE_T))
\ No newline at end of file
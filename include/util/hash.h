@@ -5,6 +5,7 @@
 #include <stdbool.h>
 
 #define HASH_VALUE_T uint32_t
+#define HASH64_VALUE_T uint64_t
 
 typedef enum
 {
@@ -14,6 +15,8 @@ typedef enum
 } HASH_VALUE_COMPARE_RESULT_E;
 
 HASH_VALUE_T Hash(uint8_t *str, uint32_t length);
+// 64-bit hash reading 8 bytes at a time, for the index ids of long or numerous values.
+HASH64_VALUE_T Hash64(uint8_t *p_str, uint32_t length);
 HASH_VALUE_COMPARE_RESULT_E Hash_Api_Compare(HASH_VALUE_T val1, HASH_VALUE_T val2);
 
 #endif
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include "faciledb.h"
 #include "faciledb_utils.h"
 #include "faciledb_record_value_type.h"
+#include "hash.h"
 
 #if defined(_POSIX_VERSION)
 #define IS_POSIX_API_SUPPORT (1)
@@ -22,27 +23,67 @@
 #if IS_POSIX_API_SUPPORT
 #include <fcntl.h>
 #include <pthread.h>
+#include <dirent.h>
+#include <stdatomic.h>
 #else
 #error "POSIX API is not supported."
 #endif
 
 #if ENABLE_DB_INDEX
 #include "faciledb_index.h"
-#include "hash.h"
 #include "index.h"
+#include "index_id_type.h"
 #endif
 
+// Max number of set files kept open at the same time, the number in use is set by FacileDB_Api_Set_Open_Set_File_Num().
 #ifndef DB_SET_INFO_INSTANCE_NUM
-#define DB_SET_INFO_INSTANCE_NUM (1)
-// TODO: FIFO, LRU
+#define DB_SET_INFO_INSTANCE_NUM (8)
 #endif // DB_SET_INFO_INSTANCE_NUM
 
+// Number of hash buckets of the loaded set info instances, looked up by set name.
+#define DB_SET_INFO_BUCKET_NUM (DB_SET_INFO_INSTANCE_NUM * 2)
+#define DB_SET_INFO_NULL_INSTANCE (-1)
+
 #ifndef DB_SEARCH_DATA_INFO_BUFFER_LEN
 #define DB_SEARCH_DATA_INFO_BUFFER_LEN (8)
 #endif // DB_SEARCH_DATA_INFO_BUFFER_LEN
 
+// Cost of reading a block at random in the search plans, reading a block in order costs 1.
+#ifndef DB_SEARCH_PLAN_RANDOM_BLOCK_COST
+#define DB_SEARCH_PLAN_RANDOM_BLOCK_COST (4)
+#endif
+
+// Cost of descending an index to its first result.
+#ifndef DB_SEARCH_PLAN_INDEX_PROBE_COST
+#define DB_SEARCH_PLAN_INDEX_PROBE_COST (4)
+#endif
+
+#if ENABLE_DB_INDEX
+// Index id type of the new string indexes.
+// INDEX_ID_TYPE_STRING keeps the string order, INDEX_ID_TYPE_HASH64 makes smaller nodes for the equality search only.
+#ifndef DB_STRING_INDEX_ID_TYPE
+#define DB_STRING_INDEX_ID_TYPE (INDEX_ID_TYPE_STRING)
+#endif
+
+// Max number of the record keys of a composite index.
+#ifndef DB_COMPOSITE_INDEX_MAX_COLUMN_NUM
+#define DB_COMPOSITE_INDEX_MAX_COLUMN_NUM (8)
+#endif
+#endif // ENABLE_DB_INDEX
+
+// The set properties start with the magic number and the format version, a set file of another version is not opened.
+// Format versions:
+// 1: delete_sequence of the deletes and reserved_block_num of the appenders,
+//    block_num, valid_record_num and delete_sequence are published in two snapshot slots chosen by snapshot_sequence.
+// 2: skipped_block_tag in the snapshot slots.
+#define DB_SET_FILE_MAGIC (0x53424446U) // "FDBS"
+#define DB_SET_FILE_FORMAT_VERSION (2)
+// Number of the snapshot slots, the writers fill the slot not read by the readers and then publish it by snapshot_sequence.
+#define DB_SET_SNAPSHOT_SLOT_NUM (2)
+
 #define DB_FILE_OPEN_CHECK_TIMEOUT (30)
 #define DB_FILE_OPEN_CHECK_INTERVAL_US (100000) // 100ms
+#define DB_SET_FILE_LOCK_RETRY_INTERVAL_US (1000) // 1ms
 
 // Enum definition
 typedef enum
@@ -53,6 +94,14 @@ typedef enum
     DB_CONTEXT_STATUS_READY
 } DB_CONTEXT_STATUS_E;
 
+// Result of checking the properties of an existing set file.
+typedef enum
+{
+    DB_SET_FILE_FORMAT_MATCHED,
+    DB_SET_FILE_FORMAT_INCOMPLETE, // the set file is being created by another process
+    DB_SET_FILE_FORMAT_MISMATCHED  // another format version or set name
+} DB_SET_FILE_FORMAT_CHECK_E;
+
 typedef enum
 {
     DB_SET_INFO_STATUS_RELEASED,
@@ -119,14 +168,40 @@ typedef struct
 
 typedef struct
 {
+    uint32_t magic;
+    uint32_t format_version;
+    uint64_t snapshot_sequence; // sequence of the published snapshot slot, see write_db_set_snapshot_slot().
+    // Snapshot slot, stored in the slot of snapshot_sequence.
     uint64_t block_num;
+    uint64_t valid_record_num;
+    uint32_t delete_sequence; // sequence of the last delete, written into the deleted flags of the data deleted by it.
+    uint64_t skipped_block_tag; // last block skipped for the dead appenders, see skip_db_blocks().
     uint64_t created_time;
     uint64_t modified_time;
-    uint64_t valid_record_num;
+    uint64_t reserved_block_num; // blocks reserved by the appenders, the blocks after block_num are being written.
     uint32_t set_name_size;
     void *p_set_name;
 } DB_SET_PROPERTIES_T;
 
+// Set properties published when a reader starts, the reader ignores the blocks appended and the data deleted after them.
+typedef struct
+{
+    uint64_t block_num;
+    uint64_t valid_record_num;
+    uint32_t delete_sequence;
+    uint64_t skipped_block_tag;
+} DB_SET_SNAPSHOT_T;
+
+// Blocks of a data reserved by an appender, written without locking the db set info and published by the order of the reservations.
+typedef struct
+{
+    uint64_t first_block_tag;
+    uint64_t last_block_tag;
+    uint64_t next_block_tag; // block tag of the next block written by insert_db_data()
+    uint64_t data_tag;
+    uint64_t ticket; // order of the reservations in this process
+} DB_BLOCK_RESERVATION_T;
+
 // in-memory structure
 typedef struct
 {
@@ -135,12 +210,44 @@ typedef struct
     pthread_cond_t read_cond;
     pthread_cond_t write_cond;
     pthread_cond_t close_cond;
+    pthread_cond_t snapshot_write_cond;
+    pthread_cond_t publish_cond;
 #endif
     uint32_t writer_waiting_count;
     uint32_t reader_waiting_count;
     uint32_t reader_count;
+    // The snapshot writers (appenders and deleters) run with the readers, the other writers run alone.
+    // The appenders run together, a deleter runs without the other snapshot writers.
+    uint32_t snapshot_writer_waiting_count;
+    uint32_t snapshot_writer_count;
+    uint32_t deleter_waiting_count;
+    uint32_t deleter_count;
+    // The appenders publish their blocks by the order of the reservations, see publish_db_set_blocks().
+    uint64_t append_ticket;
+    uint64_t publish_ticket;
 } DB_SET_INFO_SYNC_T;
 
+#if ENABLE_DB_INDEX
+// Index of a record key in the catalog.
+typedef struct
+{
+    uint32_t key_length; // The record key is cut at the first '\0' as the index key, see set_db_index_key().
+    uint32_t index_id_type;
+    uint32_t is_covering;
+    char *p_key;
+} DB_INDEX_CATALOG_ENTRY_T;
+
+// In-memory catalog of the indexes of a set, loaded from the catalog file in the index directory.
+// The catalog file is rewritten with a new version when an index is made, the other processes reload it by the version.
+typedef struct
+{
+    FILE *file;
+    uint64_t version; // 0 means the catalog isn't loaded.
+    uint32_t entry_num;
+    DB_INDEX_CATALOG_ENTRY_T *p_entries;
+} DB_INDEX_CATALOG_T;
+#endif
+
 typedef struct
 {
     DB_SET_INFO_STATUS_E status;
@@ -148,14 +255,46 @@ typedef struct
 
     FILE *file;
     DB_SET_PROPERTIES_T db_set_properties;
+#if ENABLE_DB_INDEX
+    DB_INDEX_CATALOG_T index_catalog;
+#endif
+    atomic_uint_fast64_t last_used_tick; // pool tick of the last lookup, see touch_db_set_info_instance()
+    // Protected by the bucket mutex of the set name, the name is also protected by the db set info mutex.
+    int32_t next_instance; // next loaded instance in the same hash bucket
+    uint32_t db_set_name_size;
+    char db_set_name[FACILEDB_FILE_PATH_BUFFER_LENGTH]; // name of the set loaded or being loaded, the key of the hash bucket
 } DB_SET_INFO_T;
 
+// Loaded set info instances keep their set files open, looked up by the hash of set name and evicted by LRU.
+// A lookup locks the bucket of the set name only, the pool mutex is locked to load a set or request an instance.
+// A set file is opened with its db set info locked.
+// Lock order: pool mutex > db set info mutex > bucket mutex and release mutex.
+typedef struct
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_t mutex;
+    pthread_mutex_t bucket_mutex[DB_SET_INFO_BUCKET_NUM];
+    pthread_mutex_t release_mutex;
+    pthread_cond_t release_cond;
+#endif
+    uint32_t instance_num; // instances in use, at most DB_SET_INFO_INSTANCE_NUM
+    atomic_uint_fast64_t tick;
+    // Counted whenever an instance may be requested again, the requests finding all the instances busy wait for it to change.
+    atomic_uint_fast64_t release_sequence;
+    atomic_uint release_waiting_count;
+    bool is_sync_initialized; // mutexes and conditions of the instances and buckets are initialized by the first FacileDB_Api_Init()
+    int32_t bucket[DB_SET_INFO_BUCKET_NUM];
+} DB_SET_INFO_POOL_T;
+
+// The mutex is locked by FacileDB_Api_Init() and FacileDB_Api_Close() only, the requests check the status atomically.
 typedef struct
 {
 #if IS_POSIX_API_SUPPORT
     pthread_mutex_t mutex;
+    pthread_cond_t close_cond;
 #endif
-    DB_CONTEXT_STATUS_E status; // TODO: move status to DB_CONTEXT_T
+    _Atomic(DB_CONTEXT_STATUS_E) status; // TODO: move status to DB_CONTEXT_T
+    atomic_uint request_num;             // requests using the db context, see enter_db_context_request()
 } DB_CONTEXT_SYNC_T;
 
 // TODO: using context
@@ -165,29 +304,83 @@ typedef struct
     DB_SET_INFO_T *p_db_set_info_instances_list;
     char db_directory_path[FACILEDB_FILE_PATH_BUFFER_LENGTH];
 } DB_CONTEXT_T;
+
+#if ENABLE_DB_INDEX
+// Buffer of the index id converted from the record value.
+typedef union
+{
+    HASH_VALUE_T hash_value;
+    HASH64_VALUE_T hash64_value;
+    INDEX_ID_STRING_T string_id;
+} DB_INDEX_ID_BUFFER_T;
+
+// Column of a composite index, parsed from the key of its catalog entry, see set_db_composite_index_catalog_key().
+typedef struct
+{
+    union
+    {
+        FACILEDB_RECORD_VALUE_TYPE_E record_value_type;
+        uint32_t record_value_type_32;
+    };
+    uint32_t key_length;
+    char *p_key; // points into the catalog entry key
+} DB_COMPOSITE_COLUMN_T;
+
+// Head of the covering file, the keys of the records stored with the indexed record.
+typedef struct
+{
+    uint32_t covered_key_num; // 0 means all the records of the data are covered.
+    uint32_t keys_size;       // bytes of p_keys
+    uint8_t *p_keys;          // key_size (uint32) and the key of each covered key
+} DB_COVERING_PROPERTIES_T;
+
+// Entry of a data in the covering file, followed by the covered records in the same format as the db blocks.
+typedef struct
+{
+    uint64_t data_tag;
+    uint64_t start_db_block_tag;
+    uint64_t created_time;
+    uint32_t deleted;
+    uint32_t record_num;
+    uint32_t records_size; // bytes of the records behind the entry
+} DB_COVERING_ENTRY_T;
+#endif
+
+// Plan of an equal search, see plan_db_search_equal_records().
+typedef struct
+{
+    FACILEDB_SEARCH_PLAN_T faciledb_search_plan;
+#if ENABLE_DB_INDEX
+    DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry; // composite index of FACILEDB_SEARCH_PLAN_COMPOSITE
+#endif
+} DB_SEARCH_PLAN_T;
 // End of structure definition
 
 // static variables
 static DB_CONTEXT_SYNC_T db_context_sync = {
 #if IS_POSIX_API_SUPPORT
     .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .close_cond = PTHREAD_COND_INITIALIZER,
 #endif
-    .status = DB_CONTEXT_STATUS_UNUSED};
+    .status = DB_CONTEXT_STATUS_UNUSED,
+    .request_num = 0};
 
-static DB_SET_INFO_T db_set_info_instance[DB_SET_INFO_INSTANCE_NUM] = {
-    {.status = DB_SET_INFO_STATUS_RELEASED,
-     .db_set_info_sync = {
+// status of the instances is DB_SET_INFO_STATUS_RELEASED (0).
+static DB_SET_INFO_T db_set_info_instance[DB_SET_INFO_INSTANCE_NUM];
+static DB_SET_INFO_POOL_T db_set_info_pool = {
 #if IS_POSIX_API_SUPPORT
-         .db_set_info_mutex = PTHREAD_MUTEX_INITIALIZER,
-         .read_cond = PTHREAD_COND_INITIALIZER,
-         .write_cond = PTHREAD_COND_INITIALIZER,
-         .close_cond = PTHREAD_COND_INITIALIZER,
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .release_mutex = PTHREAD_MUTEX_INITIALIZER,
+    .release_cond = PTHREAD_COND_INITIALIZER,
 #endif
-         .reader_waiting_count = 0,
-         .writer_waiting_count = 0,
-         .reader_count = 0}}};
+    .instance_num = DB_SET_INFO_INSTANCE_NUM};
 
 static char db_directory_path[FACILEDB_FILE_PATH_BUFFER_LENGTH] = {0};
+// The searches read the search plan costs in the middle of a request, they're locked separately from the db context.
+#if IS_POSIX_API_SUPPORT
+static pthread_mutex_t db_search_plan_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+static uint32_t db_search_plan_random_block_cost = DB_SEARCH_PLAN_RANDOM_BLOCK_COST;
 // End of static vaiables
 
 // Local function declaration
@@ -195,16 +388,32 @@ static inline void lock_db_context_sync();
 static inline void unlock_db_context_sync();
 void update_db_context_status(DB_CONTEXT_STATUS_E new_status);
 static inline bool check_db_context_status(DB_CONTEXT_STATUS_E target_status);
+static inline bool enter_db_context_request();
+static inline void leave_db_context_request();
 bool set_db_directory_path(char *p_db_directory_path);
 void clear_db_directory_path();
 
+static inline void lock_db_set_info_pool_sync();
+static inline void unlock_db_set_info_pool_sync();
+static inline void lock_db_set_info_bucket_sync(uint32_t bucket);
+static inline void unlock_db_set_info_bucket_sync(uint32_t bucket);
+static inline void db_set_info_pool_sync_release_wait(uint64_t release_sequence);
+static inline void db_set_info_pool_sync_release_notify();
 void db_set_info_instances_init();
+static inline void touch_db_set_info_instance(DB_SET_INFO_T *p_db_set_info);
+DB_SET_INFO_T *query_db_set_info_instance(char *p_db_set_name, uint32_t db_set_name_size);
+void link_db_set_info_instance(DB_SET_INFO_T *p_db_set_info);
+void unlink_db_set_info_instance(DB_SET_INFO_T *p_db_set_info);
+static inline bool is_db_set_info_instance_busy(DB_SET_INFO_T *p_db_set_info);
+void release_db_set_info_instance(DB_SET_INFO_T *p_db_set_info);
 DB_SET_INFO_T *request_and_lock_released_db_set_info_instance();
 DB_SET_INFO_T *query_and_lock_db_set_info_loaded(char *p_db_set_name_string);
 DB_SET_INFO_T *load_and_lock_db_set_info(char *p_db_set_name);
+void abort_db_set_info_loading(DB_SET_INFO_T *p_db_set_info);
+void release_excess_db_set_info_instance(uint32_t instance_position);
 void close_db_set_info_instances();
 void create_new_db_set_file_format(DB_SET_INFO_T *p_db_set_info, uint8_t *p_db_set_name, uint32_t db_set_name_size);
-bool read_and_check_db_set_file_format(DB_SET_INFO_T *p_db_set_info, uint8_t *p_db_set_name, uint32_t db_set_name_size);
+DB_SET_FILE_FORMAT_CHECK_E read_and_check_db_set_file_format(DB_SET_INFO_T *p_db_set_info, uint8_t *p_db_set_name, uint32_t db_set_name_size);
 
 void db_set_info_init(DB_SET_INFO_T *p_db_set_info);
 bool is_db_set_file_exist(char *p_db_set_file_path);
@@ -214,15 +423,29 @@ void close_db_set_info(DB_SET_INFO_T *p_db_set_info);
 void db_set_info_sync_init(DB_SET_INFO_SYNC_T *p_db_set_info_sync);
 static inline void db_set_info_file_lock_write(DB_SET_INFO_T *p_db_set_info);
 static inline void db_set_info_file_unlock_write(DB_SET_INFO_T *p_db_set_info);
-static inline void db_set_info_file_lock_read(DB_SET_INFO_T *p_db_set_info);
-static inline void db_set_info_file_unlock_read(DB_SET_INFO_T *p_db_set_info);
+static inline void db_set_info_file_lock_blocks_write(DB_SET_INFO_T *p_db_set_info);
+static inline void db_set_info_file_lock_header_write(DB_SET_INFO_T *p_db_set_info);
+static inline void db_set_info_file_unlock_header(DB_SET_INFO_T *p_db_set_info);
+#if IS_POSIX_API_SUPPORT
+static inline void lock_db_set_file_range(DB_SET_INFO_T *p_db_set_info, short lock_type, off_t start, off_t length);
+static inline void unlock_db_set_file_range(DB_SET_INFO_T *p_db_set_info, off_t start, off_t length);
+static inline void lock_db_set_file_written_blocks(DB_SET_INFO_T *p_db_set_info, short lock_type);
+static inline void wait_db_set_file_range_unlocked(DB_SET_INFO_T *p_db_set_info, off_t start, off_t length);
+#endif
 static inline void lock_db_set_info_sync(DB_SET_INFO_T *p_db_set_info);
 static inline void unlock_db_set_info_sync(DB_SET_INFO_T *p_db_set_info);
 static inline void db_set_info_sync_close_wait(DB_SET_INFO_T *p_db_set_info);
+static inline void db_set_info_sync_idle_wait(DB_SET_INFO_T *p_db_set_info);
 static inline void db_set_info_sync_write_wait(DB_SET_INFO_T *p_db_set_info);
 static inline void db_set_info_sync_write_unblock(DB_SET_INFO_T *p_db_set_info);
 static inline void db_set_info_sync_read_wait(DB_SET_INFO_T *p_db_set_info);
 static inline void db_set_info_sync_read_unblock(DB_SET_INFO_T *p_db_set_info);
+static inline bool is_db_set_info_sync_snapshot_write_blocked(DB_SET_INFO_T *p_db_set_info, bool is_appending);
+static inline void db_set_info_sync_snapshot_write_wait(DB_SET_INFO_T *p_db_set_info, bool is_appending);
+static inline void db_set_info_sync_snapshot_write_unblock(DB_SET_INFO_T *p_db_set_info, bool is_appending);
+#if ENABLE_DB_INDEX
+static inline void db_set_info_sync_catalog_wait(DB_SET_INFO_T *p_db_set_info);
+#endif
 void update_db_set_info_status(DB_SET_INFO_T *p_db_set_info, DB_SET_INFO_STATUS_E new_status);
 void update_db_set_info_status_from_reading(DB_SET_INFO_T *p_db_set_info);
 static inline bool check_db_set_info_status(DB_SET_INFO_T *p_db_set_info, DB_SET_INFO_STATUS_E target_status);
@@ -233,7 +456,26 @@ bool allocate_db_set_properties_resources(DB_SET_PROPERTIES_T *p_db_set_properti
 void free_db_set_properties_resources(DB_SET_PROPERTIES_T *p_db_set_properties);
 void write_db_set_properties(DB_SET_INFO_T *p_db_set_info);
 void read_db_set_properties(DB_SET_INFO_T *p_db_set_info);
+void refresh_db_set_properties(DB_SET_INFO_T *p_db_set_info);
+off_t get_db_set_snapshot_sequence_offset(DB_SET_PROPERTIES_T *p_db_set_properties);
+size_t get_db_set_snapshot_slot_size(DB_SET_PROPERTIES_T *p_db_set_properties);
+off_t get_db_set_snapshot_slot_offset(DB_SET_PROPERTIES_T *p_db_set_properties, uint64_t snapshot_sequence);
+off_t get_db_set_created_time_offset(DB_SET_PROPERTIES_T *p_db_set_properties);
+off_t get_db_set_modified_time_offset(DB_SET_PROPERTIES_T *p_db_set_properties);
+off_t get_db_set_reserved_block_num_offset(DB_SET_PROPERTIES_T *p_db_set_properties);
+void read_db_set_snapshot_slot(DB_SET_INFO_T *p_db_set_info, uint64_t snapshot_sequence, DB_SET_SNAPSHOT_T *p_db_set_snapshot);
+void write_db_set_snapshot_slot(DB_SET_INFO_T *p_db_set_info);
+void write_db_set_delete_sequence(DB_SET_INFO_T *p_db_set_info);
+void write_db_set_reservation(DB_SET_INFO_T *p_db_set_info);
+void write_db_set_block_num(DB_SET_INFO_T *p_db_set_info);
+void read_db_set_snapshot(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot);
+void get_db_set_latest_snapshot(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot);
+static inline bool is_db_block_visible(DB_SET_SNAPSHOT_T *p_db_set_snapshot, uint64_t block_tag, uint32_t deleted);
+static inline bool is_db_start_block_written(DB_SET_INFO_T *p_db_set_info, uint64_t block_tag);
 static inline uint64_t add_db_set_properties_valid_record_num(DB_SET_PROPERTIES_T *p_db_set_properties);
+bool reserve_db_set_blocks(DB_SET_INFO_T *p_db_set_info, DB_BLOCK_RESERVATION_T *p_db_block_reservation, uint64_t block_num);
+void publish_db_set_blocks(DB_SET_INFO_T *p_db_set_info, DB_BLOCK_RESERVATION_T *p_db_block_reservation);
+void skip_db_blocks(DB_SET_INFO_T *p_db_set_info, uint64_t first_block_tag, uint64_t last_block_tag);
 
 void db_block_init(DB_BLOCK_T *p_db_block);
 off_t get_db_block_offset(DB_SET_PROPERTIES_T *p_db_set_properties, uint64_t block_tag);
@@ -241,7 +483,6 @@ size_t get_db_block_size();
 void write_db_block(DB_BLOCK_T *p_db_block, DB_SET_INFO_T *p_db_set_info);
 void read_db_block(DB_SET_INFO_T *p_db_set_info, uint64_t block_tag, DB_BLOCK_T *p_db_block);
 void read_db_block_attributes(DB_SET_INFO_T *p_db_set_info, uint64_t block_tag, DB_BLOCK_T *p_db_block);
-void update_db_block_next_block_tag(uint64_t block_tag, uint64_t next_block_tag, DB_SET_INFO_T *p_db_set_info);
 
 void db_record_info_init(DB_RECORD_INFO_T *p_db_record_info);
 bool allocate_db_record_info_resources(DB_RECORD_INFO_T *p_db_record_info);
@@ -261,21 +502,67 @@ void db_record_init(DB_RECORD_T *p_db_record);
 bool allocate_db_record_resources(DB_RECORD_T *p_db_record, uint32_t key_size, uint32_t value_size);
 void free_db_record_resources(DB_RECORD_T *p_db_record);
 
-uint32_t insert_db_data(DB_SET_INFO_T *p_db_set_info, DB_DATA_INFO_T *p_db_data_info, uint64_t data_tag);
-DB_DATA_INFO_T *search_db_data_sequential(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_target_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E compare_type, uint32_t *p_result_db_data_info_num);
-uint64_t insert_db_data_handler_write_new_db_block(DB_BLOCK_T *p_db_block, DB_SET_INFO_T *p_db_set_info);
+uint32_t insert_db_data(DB_SET_INFO_T *p_db_set_info, DB_DATA_INFO_T *p_db_data_info, DB_BLOCK_RESERVATION_T *p_db_block_reservation);
+uint64_t get_db_data_block_num(DB_DATA_INFO_T *p_db_data_info);
+FACILEDB_DATA_T *search_db_data_equal(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_record, uint32_t *p_faciledb_data_num, bool is_covered_only);
+DB_DATA_INFO_T *search_db_data_sequential(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot, DB_RECORD_INFO_T *p_target_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E compare_type, uint32_t *p_result_db_data_info_num);
+uint64_t insert_db_data_handler_write_new_db_block(DB_BLOCK_T *p_db_block, DB_SET_INFO_T *p_db_set_info, DB_BLOCK_RESERVATION_T *p_db_block_reservation);
 void insert_db_data_handler_assign_db_block_value(DB_BLOCK_T *p_db_block, uint64_t prev_block_tag, uint32_t valid_record_num, uint64_t data_tag);
-DB_DATA_INFO_T *search_db_data(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_target_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E compare_type, uint32_t *p_result_db_data_info_num);
+DB_DATA_INFO_T *search_db_data(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot, DB_RECORD_INFO_T *p_target_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E compare_type, uint32_t *p_result_db_data_info_num);
 void delete_db_data_handler_write_delete_flag(DB_SET_INFO_T *p_db_set_info, uint64_t db_block_tag, uint32_t deleted);
 void delete_db_data(DB_SET_INFO_T *p_db_set_info, DB_DATA_INFO_T *p_db_data_info, uint32_t db_data_num);
+DB_DATA_INFO_T *search_db_data_equal_records(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot, DB_RECORD_INFO_T *p_target_db_record_infos, uint32_t target_num, uint32_t *p_result_db_data_info_num);
+bool is_db_data_matched(DB_DATA_INFO_T *p_db_data_info, DB_RECORD_INFO_T *p_target_db_record_infos, uint32_t target_num);
+void plan_db_search_equal_records(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot, DB_RECORD_INFO_T *p_target_db_record_infos, uint32_t target_num, DB_SEARCH_PLAN_T *p_db_search_plan);
+bool consider_db_search_plan(DB_SEARCH_PLAN_T *p_db_search_plan, FACILEDB_SEARCH_PLAN_E search_plan, uint32_t record_position, uint64_t estimated_data_num, uint64_t estimated_cost);
 
 #if ENABLE_DB_INDEX
 bool get_db_index_directory_path(char *p_db_index_directory_path);
 char *set_db_index_key(void *db_set_name, uint32_t set_name_size, void *p_key, uint32_t key_size);
 INDEX_ID_TYPE_E get_db_index_id_type(FACILEDB_RECORD_VALUE_TYPE_E record_value_type);
-uint32_t make_db_record_index(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_db_record_info);
-void insert_db_record_index(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_db_record_info, DB_INDEX_PAYLOAD_T *p_db_index_payload);
-DB_DATA_INFO_T *search_db_data_indexed(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_target_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E compare_type, uint32_t *p_result_db_data_info_num);
+INDEX_ID_TYPE_E get_db_existing_index_id_type(DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry, FACILEDB_RECORD_VALUE_TYPE_E record_value_type);
+void *get_db_record_index_id(DB_RECORD_INFO_T *p_db_record_info, INDEX_ID_TYPE_E index_id_type, DB_INDEX_ID_BUFFER_T *p_index_id_buffer);
+uint32_t make_db_record_index(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_db_record_info, DB_COVERING_PROPERTIES_T *p_db_covering_properties);
+void insert_db_record_index(DB_SET_INFO_T *p_db_set_info, DB_DATA_INFO_T *p_db_data_info, DB_RECORD_INFO_T *p_db_record_info, DB_INDEX_PAYLOAD_T *p_db_index_payload);
+void delete_db_record_covering_entry(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_db_record_info, uint64_t data_tag, uint32_t delete_sequence);
+DB_DATA_INFO_T *search_db_data_indexed(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot, DB_RECORD_INFO_T *p_target_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E compare_type, uint32_t *p_result_db_data_info_num, bool is_covered_only);
+DB_DATA_INFO_T *search_db_data_covered(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot, DB_RECORD_INFO_T *p_target_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E compare_type, uint32_t *p_result_db_data_info_num);
+
+void db_covering_properties_init(DB_COVERING_PROPERTIES_T *p_db_covering_properties);
+bool set_db_covering_properties(DB_COVERING_PROPERTIES_T *p_db_covering_properties, FACILEDB_RECORD_T *p_covered_records, uint32_t covered_record_num);
+void free_db_covering_properties_resources(DB_COVERING_PROPERTIES_T *p_db_covering_properties);
+void get_db_covering_file_path(char *p_db_covering_file_path, char *p_index_key);
+FILE *create_db_covering_file(char *p_index_key, DB_COVERING_PROPERTIES_T *p_db_covering_properties);
+FILE *open_db_covering_file(char *p_index_key, DB_COVERING_PROPERTIES_T *p_db_covering_properties);
+bool is_db_record_covered(DB_COVERING_PROPERTIES_T *p_db_covering_properties, DB_RECORD_INFO_T *p_indexed_db_record_info, DB_RECORD_INFO_T *p_db_record_info);
+uint64_t append_db_covering_entry(FILE *p_covering_file, DB_COVERING_PROPERTIES_T *p_db_covering_properties, DB_DATA_INFO_T *p_db_data_info, DB_RECORD_INFO_T *p_indexed_db_record_info, DB_INDEX_PAYLOAD_T *p_db_index_payload);
+bool read_db_covering_entry(FILE *p_covering_file, uint64_t entry_offset, DB_DATA_INFO_T *p_db_data_info);
+void delete_db_covering_entry(FILE *p_covering_file, uint64_t entry_offset, uint32_t delete_sequence);
+
+void db_index_catalog_init(DB_INDEX_CATALOG_T *p_db_index_catalog);
+void free_db_index_catalog_entries(DB_INDEX_CATALOG_ENTRY_T *p_entries, uint32_t entry_num);
+void close_db_index_catalog(DB_INDEX_CATALOG_T *p_db_index_catalog);
+void get_db_index_catalog_file_path(char *p_db_index_catalog_file_path, DB_SET_PROPERTIES_T *p_db_set_properties);
+bool open_db_index_catalog(DB_SET_INFO_T *p_db_set_info);
+void scan_db_index_catalog_entries(DB_SET_INFO_T *p_db_set_info);
+void refresh_db_index_catalog(DB_SET_INFO_T *p_db_set_info);
+bool is_db_index_catalog_changed(DB_SET_INFO_T *p_db_set_info);
+void write_db_index_catalog(DB_INDEX_CATALOG_T *p_db_index_catalog);
+bool add_db_index_catalog_entry(DB_INDEX_CATALOG_T *p_db_index_catalog, void *p_key, uint32_t key_length, INDEX_ID_TYPE_E index_id_type, bool is_covering);
+DB_INDEX_CATALOG_ENTRY_T *query_db_index_catalog_entry(DB_SET_INFO_T *p_db_set_info, void *p_key, uint32_t key_size);
+
+INDEX_ID_TYPE_E get_db_composite_column_index_id_type(FACILEDB_RECORD_VALUE_TYPE_E record_value_type);
+uint8_t *set_db_composite_index_catalog_key(DB_RECORD_INFO_T *p_db_record_infos, uint32_t record_num, uint32_t *p_catalog_key_size);
+uint32_t get_db_composite_index_columns(DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry, DB_COMPOSITE_COLUMN_T *p_columns);
+char *set_db_composite_index_key(DB_SET_PROPERTIES_T *p_db_set_properties, DB_COMPOSITE_COLUMN_T *p_columns, uint32_t column_num);
+DB_RECORD_INFO_T *find_db_composite_column_record(DB_COMPOSITE_COLUMN_T *p_column, DB_RECORD_INFO_T *p_db_record_infos, uint32_t record_num);
+uint32_t encode_db_composite_columns(DB_COMPOSITE_COLUMN_T *p_columns, uint32_t column_num, DB_RECORD_INFO_T *p_db_record_infos, uint32_t record_num, uint8_t **pp_encoded_columns, uint32_t *p_encoded_columns_size);
+uint32_t make_db_composite_record_index(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_db_record_infos, uint32_t record_num);
+void update_db_composite_record_indexes(DB_SET_INFO_T *p_db_set_info, DB_DATA_INFO_T *p_db_data_info, DB_INDEX_PAYLOAD_T *p_db_index_payload);
+DB_INDEX_CATALOG_ENTRY_T *query_db_composite_index_catalog_entry(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_target_db_record_infos, uint32_t target_num, uint32_t *p_leading_column_num);
+DB_DATA_INFO_T *search_db_data_composite(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot, DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry, DB_RECORD_INFO_T *p_target_db_record_infos, uint32_t target_num, uint32_t *p_result_db_data_info_num);
+uint64_t estimate_db_indexed_data_num(DB_SET_INFO_T *p_db_set_info, DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry, DB_RECORD_INFO_T *p_target_db_record_info, INDEX_ID_TYPE_E index_id_type, bool *p_is_covered);
+uint64_t estimate_db_composite_data_num(DB_SET_INFO_T *p_db_set_info, DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry, DB_RECORD_INFO_T *p_target_db_record_infos, uint32_t target_num);
 #endif
 
 // End of local function declaration
@@ -298,7 +585,7 @@ void FacileDB_Api_Init(char *p_db_directory_path)
     update_db_context_status(DB_CONTEXT_STATUS_INITIALIZING);
 
     set_db_directory_path(temp_db_directory_path);
-    // db_set_info_instances_init();
+    db_set_info_instances_init();
 
 #if ENABLE_DB_INDEX
     char temp_db_index_directory_path[INDEX_FILE_PATH_BUFFER_LENGTH] = {0};
@@ -322,6 +609,14 @@ void FacileDB_Api_Close()
     }
     update_db_context_status(DB_CONTEXT_STATUS_CLOSING);
 
+    // The new requests return since the db context is closing, wait for the requests using the db context.
+#if IS_POSIX_API_SUPPORT
+    while (atomic_load(&(db_context_sync.request_num)) > 0)
+    {
+        pthread_cond_wait(&(db_context_sync.close_cond), &(db_context_sync.mutex));
+    }
+#endif
+
     close_db_set_info_instances();
     clear_db_directory_path();
 
@@ -338,15 +633,13 @@ bool FacileDB_Api_Check_Set_Exist(char *p_db_set_name)
     char db_set_file_path[FACILEDB_FILE_PATH_BUFFER_LENGTH] = {0};
     bool existed = false;
 
-    lock_db_context_sync();
-
-    if (check_db_context_status(DB_CONTEXT_STATUS_READY) == true)
+    if (enter_db_context_request() == true)
     {
         get_db_set_file_path_by_db_set_name(p_db_set_name, db_set_file_path);
         existed = is_db_set_file_exist(db_set_file_path);
+        leave_db_context_request();
     }
 
-    unlock_db_context_sync();
     return existed;
 }
 
@@ -355,7 +648,7 @@ uint32_t FacileDB_Api_Insert_Data(char *p_db_set_name, FACILEDB_DATA_T *p_facile
 {
     char temp_db_set_name[FACILEDB_FILE_PATH_BUFFER_LENGTH] = {0};
     DB_SET_INFO_T *p_db_set_info = NULL;
-    uint64_t data_tag = 0;
+    DB_BLOCK_RESERVATION_T db_block_reservation;
     DB_DATA_INFO_T db_data_info;
 
     // Check input parameters
@@ -364,11 +657,9 @@ uint32_t FacileDB_Api_Insert_Data(char *p_db_set_name, FACILEDB_DATA_T *p_facile
         return 0;
     }
 
-    lock_db_context_sync();
-    // If the db context is not ready, return directly.
-    if (check_db_context_status(DB_CONTEXT_STATUS_READY) == false)
+    if (enter_db_context_request() == false)
     {
-        unlock_db_context_sync();
+        // db context is not ready
         return 0;
     }
 
@@ -376,30 +667,35 @@ uint32_t FacileDB_Api_Insert_Data(char *p_db_set_name, FACILEDB_DATA_T *p_facile
     temp_db_set_name[FACILEDB_FILE_PATH_MAX_LENGTH] = '\0';
 
     p_db_set_info = load_and_lock_db_set_info(temp_db_set_name);
-    unlock_db_context_sync();
+    if (p_db_set_info == NULL)
+    {
+        leave_db_context_request();
+        return 0;
+    }
 
     // convert format from FACILEDB_DATA_T to DB_DATA_INFO_T
     db_data_info_init(&db_data_info);
     shallow_assign_faciledb_data_to_db_data_info(&db_data_info, p_faciledb_data);
 
-    db_set_info_sync_write_wait(p_db_set_info);
-    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_WRITING);
-    db_set_info_file_lock_write(p_db_set_info);
+    // The appenders write their reserved blocks together, the readers read the set with them by their snapshots.
+    db_set_info_sync_snapshot_write_wait(p_db_set_info, true);
+    while (reserve_db_set_blocks(p_db_set_info, &db_block_reservation, get_db_data_block_num(&db_data_info)) == false)
+    {
+        // The catalog was changed by the writer of other process, wait to reload it until the others don't use it.
+        db_set_info_sync_snapshot_write_unblock(p_db_set_info, true);
+        db_set_info_sync_snapshot_write_wait(p_db_set_info, true);
+    }
     unlock_db_set_info_sync(p_db_set_info);
 
-    data_tag = add_db_set_properties_valid_record_num(&(p_db_set_info->db_set_properties));
-    insert_db_data(p_db_set_info, &db_data_info, data_tag);
-
-    // write due to add valid record number.
-    // TODO: update when close operation.
-    write_db_set_properties(p_db_set_info);
+    insert_db_data(p_db_set_info, &db_data_info, &db_block_reservation);
 
     // start of sync
     lock_db_set_info_sync(p_db_set_info);
-    db_set_info_file_unlock_write(p_db_set_info);
-    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READY);
-    db_set_info_sync_write_unblock(p_db_set_info);
+    // The snapshots of the readers have the new blocks after the block number is published.
+    publish_db_set_blocks(p_db_set_info, &db_block_reservation);
+    db_set_info_sync_snapshot_write_unblock(p_db_set_info, true);
     unlock_db_set_info_sync(p_db_set_info);
+    leave_db_context_request();
     // end of sync
 
     // free dynamic resources allocated at shallow_assign_faciledb_data_to_db_data_info.
@@ -410,177 +706,420 @@ uint32_t FacileDB_Api_Insert_Data(char *p_db_set_name, FACILEDB_DATA_T *p_facile
 
 // Return value: FACILEDB_DATA_T array and *p_faciledb_data_num
 FACILEDB_DATA_T *FacileDB_Api_Search_Equal(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_record, uint32_t *p_faciledb_data_num)
+{
+    return search_db_data_equal(p_db_set_name, p_faciledb_record, p_faciledb_data_num, false);
+}
+
+#if ENABLE_DB_INDEX
+FACILEDB_DATA_T *FacileDB_Api_Search_Equal_Covered(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_record, uint32_t *p_faciledb_data_num)
+{
+    return search_db_data_equal(p_db_set_name, p_faciledb_record, p_faciledb_data_num, true);
+}
+#endif
+
+// Return value: FACILEDB_DATA_T array and *p_faciledb_data_num, each data matches all the records.
+FACILEDB_DATA_T *FacileDB_Api_Search_Equal_Records(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_records, uint32_t record_num, uint32_t *p_faciledb_data_num)
 {
     char temp_db_set_name[FACILEDB_FILE_PATH_BUFFER_LENGTH] = {0};
     DB_SET_INFO_T *p_db_set_info = NULL;
-    DB_RECORD_INFO_T target_db_record;
+    DB_SET_SNAPSHOT_T db_set_snapshot;
+    DB_RECORD_INFO_T *p_target_db_records = NULL;
     DB_DATA_INFO_T *p_db_result_data = NULL;
     FACILEDB_DATA_T *p_faciledb_data_result_array = NULL;
     uint32_t result_data_num = 0;
 
+    *p_faciledb_data_num = 0;
+
     // Check input parameters
-    if (p_db_set_name == NULL || p_faciledb_record == NULL ||
-        Faciledb_Record_Value_Type_Check_Size_Valid(p_faciledb_record->record_value_type, p_faciledb_record->value_size) == false)
+    if (p_db_set_name == NULL || p_faciledb_records == NULL || record_num == 0)
+    {
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < record_num; i++)
+    {
+        if (Faciledb_Record_Value_Type_Check_Size_Valid(p_faciledb_records[i].record_value_type, p_faciledb_records[i].value_size) == false)
+        {
+            return NULL;
+        }
+    }
+
+    p_target_db_records = calloc(record_num, sizeof(DB_RECORD_INFO_T));
+    if (p_target_db_records == NULL)
     {
-        // invalid
-        *p_faciledb_data_num = 0;
         return NULL;
     }
 
+    for (uint32_t i = 0; i < record_num; i++)
+    {
+        db_record_info_init(&(p_target_db_records[i]));
+        shallow_assign_faciledb_record_to_db_record_info(&(p_target_db_records[i]), &(p_faciledb_records[i]));
+    }
+
     strncpy(temp_db_set_name, p_db_set_name, FACILEDB_FILE_PATH_MAX_LENGTH);
     temp_db_set_name[FACILEDB_FILE_PATH_MAX_LENGTH] = '\0';
 
-    lock_db_context_sync();
-
-    if (check_db_context_status(DB_CONTEXT_STATUS_READY) == false)
+    if (enter_db_context_request() == false)
     {
         // db context is not ready
-        unlock_db_context_sync();
-        *p_faciledb_data_num = 0;
+        free(p_target_db_records);
         return NULL;
     }
 
     p_db_set_info = load_and_lock_db_set_info(temp_db_set_name);
-    unlock_db_context_sync();
-
-    db_record_info_init(&target_db_record);
-    shallow_assign_faciledb_record_to_db_record_info(&target_db_record, p_faciledb_record);
+    if (p_db_set_info == NULL)
+    {
+        leave_db_context_request();
+        free(p_target_db_records);
+        return NULL;
+    }
 
     db_set_info_sync_read_wait(p_db_set_info);
     update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READING);
-    db_set_info_file_lock_read(p_db_set_info);
+    read_db_set_snapshot(p_db_set_info, &db_set_snapshot);
     unlock_db_set_info_sync(p_db_set_info);
 
-    p_db_result_data = search_db_data(p_db_set_info, &target_db_record, FACILEDB_RECORD_VALUE_TYPE_COMPARE_EQUAL, &result_data_num);
+    p_db_result_data = search_db_data_equal_records(p_db_set_info, &db_set_snapshot, p_target_db_records, record_num, &result_data_num);
 
     lock_db_set_info_sync(p_db_set_info);
-    db_set_info_file_unlock_read(p_db_set_info);
     update_db_set_info_status_from_reading(p_db_set_info);
     db_set_info_sync_read_unblock(p_db_set_info);
     unlock_db_set_info_sync(p_db_set_info);
+    leave_db_context_request();
 
     // Fill to faciledb structure
-    p_faciledb_data_result_array = calloc(result_data_num, sizeof(FACILEDB_DATA_T));
+    if (result_data_num > 0)
+    {
+        p_faciledb_data_result_array = calloc(result_data_num, sizeof(FACILEDB_DATA_T));
+    }
     for (uint32_t i = 0; i < result_data_num; i++)
     {
-        // p_faciledb_data_result_array[i].p_data_records buffer will be freed in the below function.
         shallow_assign_db_data_info_to_failedb_data(&(p_faciledb_data_result_array[i]), &(p_db_result_data[i]));
-
-        // free dynamic buffers with different data type, and the content is shallow assigned to p_faciledb_data_result_array[i].
         free(p_db_result_data[i].p_db_record_info);
     }
 
-    // free reuslt buffer
     free(p_db_result_data);
-
-    if (result_data_num == 0)
-    {
-        free(p_faciledb_data_result_array);
-        p_faciledb_data_result_array = NULL;
-    }
+    free(p_target_db_records);
 
     *p_faciledb_data_num = result_data_num;
     return p_faciledb_data_result_array;
 }
 
-// Return value: delete data number
-uint32_t FacileDB_Api_Delete_Equal(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_record)
+// Return false if the records are invalid or the db context isn't ready.
+bool FacileDB_Api_Explain_Search_Equal_Records(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_records, uint32_t record_num, FACILEDB_SEARCH_PLAN_T *p_faciledb_search_plan)
 {
     char temp_db_set_name[FACILEDB_FILE_PATH_BUFFER_LENGTH] = {0};
     DB_SET_INFO_T *p_db_set_info = NULL;
-    DB_RECORD_INFO_T target_db_record;
-    DB_DATA_INFO_T *p_target_db_data = NULL;
-    uint32_t delete_data_num = 0;
+    DB_SET_SNAPSHOT_T db_set_snapshot;
+    DB_RECORD_INFO_T *p_target_db_records = NULL;
+    DB_SEARCH_PLAN_T db_search_plan;
 
     // Check input parameters
-    if (p_db_set_name == NULL || p_faciledb_record == NULL || Faciledb_Record_Value_Type_Check_Size_Valid(p_faciledb_record->record_value_type, p_faciledb_record->value_size) == false)
+    if (p_db_set_name == NULL || p_faciledb_records == NULL || record_num == 0 || p_faciledb_search_plan == NULL)
     {
-        // invalid
-        return 0;
+        return false;
+    }
+
+    for (uint32_t i = 0; i < record_num; i++)
+    {
+        if (Faciledb_Record_Value_Type_Check_Size_Valid(p_faciledb_records[i].record_value_type, p_faciledb_records[i].value_size) == false)
+        {
+            return false;
+        }
+    }
+
+    p_target_db_records = calloc(record_num, sizeof(DB_RECORD_INFO_T));
+    if (p_target_db_records == NULL)
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < record_num; i++)
+    {
+        db_record_info_init(&(p_target_db_records[i]));
+        shallow_assign_faciledb_record_to_db_record_info(&(p_target_db_records[i]), &(p_faciledb_records[i]));
     }
 
     strncpy(temp_db_set_name, p_db_set_name, FACILEDB_FILE_PATH_MAX_LENGTH);
     temp_db_set_name[FACILEDB_FILE_PATH_MAX_LENGTH] = '\0';
 
-    lock_db_context_sync();
-    if (check_db_context_status(DB_CONTEXT_STATUS_READY) == false)
+    if (enter_db_context_request() == false)
     {
         // db context is not ready
-        unlock_db_context_sync();
-        return 0;
+        free(p_target_db_records);
+        return false;
     }
 
     p_db_set_info = load_and_lock_db_set_info(temp_db_set_name);
-    unlock_db_context_sync();
-
-    db_record_info_init(&target_db_record);
-    shallow_assign_faciledb_record_to_db_record_info(&target_db_record, p_faciledb_record);
+    if (p_db_set_info == NULL)
+    {
+        leave_db_context_request();
+        free(p_target_db_records);
+        return false;
+    }
 
-    db_set_info_sync_write_wait(p_db_set_info);
-    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_WRITING);
-    db_set_info_file_lock_write(p_db_set_info);
+    db_set_info_sync_read_wait(p_db_set_info);
+    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READING);
+    read_db_set_snapshot(p_db_set_info, &db_set_snapshot);
     unlock_db_set_info_sync(p_db_set_info);
 
-    p_target_db_data = search_db_data(p_db_set_info, &target_db_record, FACILEDB_RECORD_VALUE_TYPE_COMPARE_EQUAL, &delete_data_num);
-    // Delete the target data
-    delete_db_data(p_db_set_info, p_target_db_data, delete_data_num);
+    plan_db_search_equal_records(p_db_set_info, &db_set_snapshot, p_target_db_records, record_num, &db_search_plan);
 
     lock_db_set_info_sync(p_db_set_info);
-    db_set_info_file_unlock_write(p_db_set_info);
-    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READY);
-    db_set_info_sync_write_unblock(p_db_set_info);
+    update_db_set_info_status_from_reading(p_db_set_info);
+    db_set_info_sync_read_unblock(p_db_set_info);
     unlock_db_set_info_sync(p_db_set_info);
+    leave_db_context_request();
 
-    return delete_data_num;
+    free(p_target_db_records);
+
+    *p_faciledb_search_plan = db_search_plan.faciledb_search_plan;
+    return true;
 }
 
-void FacileDB_Api_Free_Data_Buffer(FACILEDB_DATA_T *p_faciledb_data)
+void FacileDB_Api_Set_Search_Plan_Random_Block_Cost(uint32_t random_block_cost)
 {
-    uint32_t record_num = 0;
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_lock(&db_search_plan_mutex);
+#endif
+    db_search_plan_random_block_cost = random_block_cost;
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_unlock(&db_search_plan_mutex);
+#endif
+}
 
-    if (p_faciledb_data == NULL)
+// Set the max number of set files kept open, the least recently used one is closed to open another.
+// The number is limited to [1, DB_SET_INFO_INSTANCE_NUM], the set files over the new number are closed.
+void FacileDB_Api_Set_Open_Set_File_Num(uint32_t open_set_file_num)
+{
+    if (open_set_file_num < 1)
     {
-        return;
+        open_set_file_num = 1;
     }
-
-    record_num = p_faciledb_data->record_num;
-    for (uint32_t i = 0; i < record_num; i++)
+    else if (open_set_file_num > DB_SET_INFO_INSTANCE_NUM)
     {
-        FacileDB_Api_Free_Record_Buffer(&(p_faciledb_data->p_data_records[i]));
+        open_set_file_num = DB_SET_INFO_INSTANCE_NUM;
     }
-}
 
-void FacileDB_Api_Free_Record_Buffer(FACILEDB_RECORD_T *p_facilledb_record)
-{
-    if (p_facilledb_record == NULL)
+    uint32_t former_instance_num = 0;
+    bool is_sync_initialized = false;
+
+    // No request picks the instances over the new number once it's lowered.
+    lock_db_set_info_pool_sync();
+    former_instance_num = db_set_info_pool.instance_num;
+    is_sync_initialized = db_set_info_pool.is_sync_initialized;
+    db_set_info_pool.instance_num = open_set_file_num;
+    unlock_db_set_info_pool_sync();
+
+    if (is_sync_initialized)
     {
-        return;
+        for (uint32_t i = open_set_file_num; i < former_instance_num; i++)
+        {
+            release_excess_db_set_info_instance(i);
+        }
     }
 
-    free(p_facilledb_record->p_key);
-    free(p_facilledb_record->p_value);
-}
-
-static inline void lock_db_context_sync()
-{
-#if IS_POSIX_API_SUPPORT
-    pthread_mutex_t *p_db_context_mutex = &(db_context_sync.mutex);
-    pthread_mutex_lock(p_db_context_mutex);
-#endif
+    // The requests waiting for an instance may use the new ones.
+    db_set_info_pool_sync_release_notify();
 }
 
-static inline void unlock_db_context_sync()
+// is_covered_only: search by the covering index only, see search_db_data_covered().
+FACILEDB_DATA_T *search_db_data_equal(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_record, uint32_t *p_faciledb_data_num, bool is_covered_only)
 {
-#if IS_POSIX_API_SUPPORT
-    pthread_mutex_t *p_db_context_mutex = &(db_context_sync.mutex);
-    pthread_mutex_unlock(p_db_context_mutex);
-#endif
-}
+    char temp_db_set_name[FACILEDB_FILE_PATH_BUFFER_LENGTH] = {0};
+    DB_SET_INFO_T *p_db_set_info = NULL;
+    DB_SET_SNAPSHOT_T db_set_snapshot;
+    DB_RECORD_INFO_T target_db_record;
+    DB_DATA_INFO_T *p_db_result_data = NULL;
+    FACILEDB_DATA_T *p_faciledb_data_result_array = NULL;
+    uint32_t result_data_num = 0;
 
+    // Check input parameters
+    if (p_db_set_name == NULL || p_faciledb_record == NULL ||
+        Faciledb_Record_Value_Type_Check_Size_Valid(p_faciledb_record->record_value_type, p_faciledb_record->value_size) == false)
+    {
+        // invalid
+        *p_faciledb_data_num = 0;
+        return NULL;
+    }
+
+    strncpy(temp_db_set_name, p_db_set_name, FACILEDB_FILE_PATH_MAX_LENGTH);
+    temp_db_set_name[FACILEDB_FILE_PATH_MAX_LENGTH] = '\0';
+
+    if (enter_db_context_request() == false)
+    {
+        // db context is not ready
+        *p_faciledb_data_num = 0;
+        return NULL;
+    }
+
+    p_db_set_info = load_and_lock_db_set_info(temp_db_set_name);
+    if (p_db_set_info == NULL)
+    {
+        leave_db_context_request();
+        *p_faciledb_data_num = 0;
+        return NULL;
+    }
+
+    db_record_info_init(&target_db_record);
+    shallow_assign_faciledb_record_to_db_record_info(&target_db_record, p_faciledb_record);
+
+    db_set_info_sync_read_wait(p_db_set_info);
+    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READING);
+    read_db_set_snapshot(p_db_set_info, &db_set_snapshot);
+    unlock_db_set_info_sync(p_db_set_info);
+
+#if ENABLE_DB_INDEX
+    if (is_covered_only)
+    {
+        p_db_result_data = search_db_data_covered(p_db_set_info, &db_set_snapshot, &target_db_record, FACILEDB_RECORD_VALUE_TYPE_COMPARE_EQUAL, &result_data_num);
+    }
+    else
+#endif
+    {
+        p_db_result_data = search_db_data(p_db_set_info, &db_set_snapshot, &target_db_record, FACILEDB_RECORD_VALUE_TYPE_COMPARE_EQUAL, &result_data_num);
+    }
+
+    lock_db_set_info_sync(p_db_set_info);
+    update_db_set_info_status_from_reading(p_db_set_info);
+    db_set_info_sync_read_unblock(p_db_set_info);
+    unlock_db_set_info_sync(p_db_set_info);
+    leave_db_context_request();
+
+    // Fill to faciledb structure
+    p_faciledb_data_result_array = calloc(result_data_num, sizeof(FACILEDB_DATA_T));
+    for (uint32_t i = 0; i < result_data_num; i++)
+    {
+        // p_faciledb_data_result_array[i].p_data_records buffer will be freed in the below function.
+        shallow_assign_db_data_info_to_failedb_data(&(p_faciledb_data_result_array[i]), &(p_db_result_data[i]));
+
+        // free dynamic buffers with different data type, and the content is shallow assigned to p_faciledb_data_result_array[i].
+        free(p_db_result_data[i].p_db_record_info);
+    }
+
+    // free reuslt buffer
+    free(p_db_result_data);
+
+    if (result_data_num == 0)
+    {
+        free(p_faciledb_data_result_array);
+        p_faciledb_data_result_array = NULL;
+    }
+
+    *p_faciledb_data_num = result_data_num;
+    return p_faciledb_data_result_array;
+}
+
+// Return value: delete data number
+uint32_t FacileDB_Api_Delete_Equal(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_record)
+{
+    char temp_db_set_name[FACILEDB_FILE_PATH_BUFFER_LENGTH] = {0};
+    DB_SET_INFO_T *p_db_set_info = NULL;
+    DB_SET_SNAPSHOT_T db_set_snapshot;
+    DB_RECORD_INFO_T target_db_record;
+    DB_DATA_INFO_T *p_target_db_data = NULL;
+    uint32_t delete_data_num = 0;
+
+    // Check input parameters
+    if (p_db_set_name == NULL || p_faciledb_record == NULL || Faciledb_Record_Value_Type_Check_Size_Valid(p_faciledb_record->record_value_type, p_faciledb_record->value_size) == false)
+    {
+        // invalid
+        return 0;
+    }
+
+    strncpy(temp_db_set_name, p_db_set_name, FACILEDB_FILE_PATH_MAX_LENGTH);
+    temp_db_set_name[FACILEDB_FILE_PATH_MAX_LENGTH] = '\0';
+
+    if (enter_db_context_request() == false)
+    {
+        // db context is not ready
+        return 0;
+    }
+
+    p_db_set_info = load_and_lock_db_set_info(temp_db_set_name);
+    if (p_db_set_info == NULL)
+    {
+        leave_db_context_request();
+        return 0;
+    }
+
+    db_record_info_init(&target_db_record);
+    shallow_assign_faciledb_record_to_db_record_info(&target_db_record, p_faciledb_record);
+
+    // The readers read the set with the deleter by their snapshots, the deleted data are visible to the earlier snapshots.
+    db_set_info_sync_snapshot_write_wait(p_db_set_info, false);
+    db_set_info_file_lock_blocks_write(p_db_set_info);
+    get_db_set_latest_snapshot(p_db_set_info, &db_set_snapshot);
+    unlock_db_set_info_sync(p_db_set_info);
+
+    p_target_db_data = search_db_data(p_db_set_info, &db_set_snapshot, &target_db_record, FACILEDB_RECORD_VALUE_TYPE_COMPARE_EQUAL, &delete_data_num);
+    // Delete the target data
+    delete_db_data(p_db_set_info, p_target_db_data, delete_data_num);
+
+    lock_db_set_info_sync(p_db_set_info);
+    if (delete_data_num > 0)
+    {
+        // The later snapshots ignore the data deleted by this sequence.
+        db_set_info_file_lock_header_write(p_db_set_info);
+        write_db_set_delete_sequence(p_db_set_info);
+        db_set_info_file_unlock_header(p_db_set_info);
+    }
+
+    db_set_info_file_unlock_write(p_db_set_info);
+    db_set_info_sync_snapshot_write_unblock(p_db_set_info, false);
+    unlock_db_set_info_sync(p_db_set_info);
+    leave_db_context_request();
+
+    return delete_data_num;
+}
+
+void FacileDB_Api_Free_Data_Buffer(FACILEDB_DATA_T *p_faciledb_data)
+{
+    uint32_t record_num = 0;
+
+    if (p_faciledb_data == NULL)
+    {
+        return;
+    }
+
+    record_num = p_faciledb_data->record_num;
+    for (uint32_t i = 0; i < record_num; i++)
+    {
+        FacileDB_Api_Free_Record_Buffer(&(p_faciledb_data->p_data_records[i]));
+    }
+}
+
+void FacileDB_Api_Free_Record_Buffer(FACILEDB_RECORD_T *p_facilledb_record)
+{
+    if (p_facilledb_record == NULL)
+    {
+        return;
+    }
+
+    free(p_facilledb_record->p_key);
+    free(p_facilledb_record->p_value);
+}
+
+static inline void lock_db_context_sync()
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_t *p_db_context_mutex = &(db_context_sync.mutex);
+    pthread_mutex_lock(p_db_context_mutex);
+#endif
+}
+
+static inline void unlock_db_context_sync()
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_t *p_db_context_mutex = &(db_context_sync.mutex);
+    pthread_mutex_unlock(p_db_context_mutex);
+#endif
+}
+
+// Lock the db_context_mutex before using this function.
 void update_db_context_status(DB_CONTEXT_STATUS_E new_status)
 {
-    DB_CONTEXT_STATUS_E *p_db_context_sync_status = &(db_context_sync.status);
-    DB_CONTEXT_STATUS_E current_status = *p_db_context_sync_status;
+    DB_CONTEXT_STATUS_E current_status = atomic_load(&(db_context_sync.status));
     bool is_valid_transition = false;
 
     switch (current_status)
@@ -622,7 +1161,7 @@ void update_db_context_status(DB_CONTEXT_STATUS_E new_status)
 
     if (is_valid_transition)
     {
-        *p_db_context_sync_status = new_status;
+        atomic_store(&(db_context_sync.status), new_status);
     }
     else
     {
@@ -631,10 +1170,36 @@ void update_db_context_status(DB_CONTEXT_STATUS_E new_status)
     }
 }
 
-// Lock the db_context_mutex before using this function.
 static inline bool check_db_context_status(DB_CONTEXT_STATUS_E target_status)
 {
-    return (db_context_sync.status == target_status);
+    return (atomic_load(&(db_context_sync.status)) == target_status);
+}
+
+// Count the request before checking the status, FacileDB_Api_Close() changes the status before waiting for the counted requests.
+// Return false if the db context is not ready, the request is not counted then.
+static inline bool enter_db_context_request()
+{
+    atomic_fetch_add(&(db_context_sync.request_num), 1);
+    if (check_db_context_status(DB_CONTEXT_STATUS_READY) == false)
+    {
+        leave_db_context_request();
+        return false;
+    }
+
+    return true;
+}
+
+static inline void leave_db_context_request()
+{
+    if ((atomic_fetch_sub(&(db_context_sync.request_num), 1) == 1) && (check_db_context_status(DB_CONTEXT_STATUS_READY) == false))
+    {
+        // The last request wakes up FacileDB_Api_Close().
+        lock_db_context_sync();
+#if IS_POSIX_API_SUPPORT
+        pthread_cond_broadcast(&(db_context_sync.close_cond));
+#endif
+        unlock_db_context_sync();
+    }
 }
 
 bool set_db_directory_path(char *p_db_directory_path)
@@ -700,140 +1265,378 @@ void clear_db_directory_path()
     memset(db_directory_path, '\0', sizeof(db_directory_path));
 }
 
-void db_set_info_instances_init()
+static inline void lock_db_set_info_pool_sync()
 {
-    for (uint32_t i = 0; i < DB_SET_INFO_INSTANCE_NUM; i++)
-    {
-        DB_SET_INFO_T *p_db_set_info = &(db_set_info_instance[i]);
 #if IS_POSIX_API_SUPPORT
-        pthread_mutex_t *p_db_set_info_mutex = &(p_db_set_info->db_set_info_sync.db_set_info_mutex);
-        pthread_mutex_lock(p_db_set_info_mutex);
+    pthread_mutex_lock(&(db_set_info_pool.mutex));
 #endif
+}
 
-        db_set_info_init(&(db_set_info_instance[i]));
-
-        update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_RELEASED);
+static inline void unlock_db_set_info_pool_sync()
+{
 #if IS_POSIX_API_SUPPORT
-        pthread_mutex_unlock(p_db_set_info_mutex);
+    pthread_mutex_unlock(&(db_set_info_pool.mutex));
 #endif
-    }
 }
 
-DB_SET_INFO_T *request_and_lock_released_db_set_info_instance()
+static inline void lock_db_set_info_bucket_sync(uint32_t bucket)
 {
-    DB_SET_INFO_T *p_db_set_info = NULL;
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_lock(&(db_set_info_pool.bucket_mutex[bucket]));
+#endif
+}
 
-    // Current: only one instance
-#if (DB_SET_INFO_INSTANCE_NUM == 1)
-    p_db_set_info = &(db_set_info_instance[0]);
+static inline void unlock_db_set_info_bucket_sync(uint32_t bucket)
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_unlock(&(db_set_info_pool.bucket_mutex[bucket]));
+#endif
+}
 
-    lock_db_set_info_sync(p_db_set_info);
-    if (check_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_RELEASED) == false)
+// Wait until the release sequence is counted after release_sequence was read, i.e. an instance may be requested again.
+// The pool must not be locked, release_sequence is read before the instances are checked.
+static inline void db_set_info_pool_sync_release_wait(uint64_t release_sequence)
+{
+#if IS_POSIX_API_SUPPORT
+    atomic_fetch_add(&(db_set_info_pool.release_waiting_count), 1);
+    pthread_mutex_lock(&(db_set_info_pool.release_mutex));
+    while (atomic_load(&(db_set_info_pool.release_sequence)) == release_sequence)
     {
-        // not released, close it first.
-        db_set_info_sync_close_wait(p_db_set_info);
-        update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_CLOSING);
-        close_db_set_info(p_db_set_info);
-        update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_RELEASED);
+        pthread_cond_wait(&(db_set_info_pool.release_cond), &(db_set_info_pool.release_mutex));
     }
-#else  // DB_SET_INFO_INSTANCE_NUM == 1
-#endif // DB_SET_INFO_INSTANCE_NUM == 1
-
-    return p_db_set_info;
+    pthread_mutex_unlock(&(db_set_info_pool.release_mutex));
+    atomic_fetch_sub(&(db_set_info_pool.release_waiting_count), 1);
+#endif
 }
 
-// Lock the target db_set_info and check if the set_name matches.
-// If matches, return the pointer of the target db_set_info.
-// If not matches, unlock the target db_set_info and return NULL.
-DB_SET_INFO_T *query_and_lock_db_set_info_loaded(char *p_db_set_name_string)
+// Count the release sequence after an instance becomes idle or released, the db set info may be locked.
+// The waiters count themselves before checking the sequence, so the condition is broadcast only if someone waits.
+static inline void db_set_info_pool_sync_release_notify()
 {
-    DB_SET_INFO_T *p_target_db_set_info = NULL;
-    uint32_t db_set_name_string_size = strnlen(p_db_set_name_string, FACILEDB_FILE_PATH_MAX_LENGTH);
-
-#if (DB_SET_INFO_INSTANCE_NUM == 1)
-    p_target_db_set_info = &(db_set_info_instance[0]);
-
-    lock_db_set_info_sync(p_target_db_set_info);
-
-    if (p_target_db_set_info->status >= DB_SET_INFO_STATUS_READY &&
-        (p_target_db_set_info->db_set_properties.set_name_size == db_set_name_string_size) &&
-        (memcmp(p_target_db_set_info->db_set_properties.p_set_name, p_db_set_name_string, db_set_name_string_size) == 0))
-    {
-        return p_target_db_set_info;
-    }
-    else
+    atomic_fetch_add(&(db_set_info_pool.release_sequence), 1);
+#if IS_POSIX_API_SUPPORT
+    if (atomic_load(&(db_set_info_pool.release_waiting_count)) > 0)
     {
-        unlock_db_set_info_sync(p_target_db_set_info);
-        return NULL;
+        pthread_mutex_lock(&(db_set_info_pool.release_mutex));
+        pthread_cond_broadcast(&(db_set_info_pool.release_cond));
+        pthread_mutex_unlock(&(db_set_info_pool.release_mutex));
     }
 #endif
 }
 
-void create_new_db_set_file_format(DB_SET_INFO_T *p_db_set_info, uint8_t *p_db_set_name, uint32_t db_set_name_size)
+// Initialize all set info instances when db_context_status is DB_CONTEXT_STATUS_INITIALIZING.
+void db_set_info_instances_init()
 {
-    uint64_t current_time = get_current_time();
+    atomic_store(&(db_set_info_pool.tick), 0);
+    for (uint32_t i = 0; i < DB_SET_INFO_BUCKET_NUM; i++)
+    {
+#if IS_POSIX_API_SUPPORT
+        if (db_set_info_pool.is_sync_initialized == false)
+        {
+            pthread_mutex_init(&(db_set_info_pool.bucket_mutex[i]), NULL);
+        }
+#endif
+        db_set_info_pool.bucket[i] = DB_SET_INFO_NULL_INSTANCE;
+    }
 
-    // Setup set_name nad write new db properties into file.
-    // store the db_set_name without the '\0'.
-    allocate_db_set_properties_resources(&(p_db_set_info->db_set_properties), db_set_name_size);
-    p_db_set_info->db_set_properties.set_name_size = db_set_name_size;
-    memcpy(p_db_set_info->db_set_properties.p_set_name, p_db_set_name, p_db_set_info->db_set_properties.set_name_size);
-    p_db_set_info->db_set_properties.created_time = current_time;
-    p_db_set_info->db_set_properties.modified_time = current_time;
+    for (uint32_t i = 0; i < DB_SET_INFO_INSTANCE_NUM; i++)
+    {
+        DB_SET_INFO_T *p_db_set_info = &(db_set_info_instance[i]);
 
-    write_db_set_properties(p_db_set_info);
+#if IS_POSIX_API_SUPPORT
+        if (db_set_info_pool.is_sync_initialized == false)
+        {
+            pthread_mutex_init(&(p_db_set_info->db_set_info_sync.db_set_info_mutex), NULL);
+            pthread_cond_init(&(p_db_set_info->db_set_info_sync.read_cond), NULL);
+            pthread_cond_init(&(p_db_set_info->db_set_info_sync.write_cond), NULL);
+            pthread_cond_init(&(p_db_set_info->db_set_info_sync.close_cond), NULL);
+            pthread_cond_init(&(p_db_set_info->db_set_info_sync.snapshot_write_cond), NULL);
+            pthread_cond_init(&(p_db_set_info->db_set_info_sync.publish_cond), NULL);
+        }
+#endif
+
+        lock_db_set_info_sync(p_db_set_info);
+
+        db_set_info_init(p_db_set_info);
+        atomic_store(&(p_db_set_info->last_used_tick), 0);
+        p_db_set_info->next_instance = DB_SET_INFO_NULL_INSTANCE;
+
+        unlock_db_set_info_sync(p_db_set_info);
+    }
+    db_set_info_pool.is_sync_initialized = true;
 }
 
-bool read_and_check_db_set_file_format(DB_SET_INFO_T *p_db_set_info, uint8_t *p_db_set_name, uint32_t db_set_name_size)
+static inline uint32_t get_db_set_info_bucket(char *p_db_set_name, uint32_t db_set_name_size)
 {
-    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
-    DB_SET_PROPERTIES_T expected_db_set_properties = {.set_name_size = db_set_name_size};
-    size_t expected_db_set_properties_size = get_db_set_properties_size(&expected_db_set_properties);
+    return Hash((uint8_t *)p_db_set_name, db_set_name_size) % DB_SET_INFO_BUCKET_NUM;
+}
 
-#if IS_POSIX_API_SUPPORT
-    // read db properties from file and check set_name_size & set_name
+// The least recently used instance is closed first, the tick is updated without the pool locked.
+static inline void touch_db_set_info_instance(DB_SET_INFO_T *p_db_set_info)
+{
+    atomic_store(&(p_db_set_info->last_used_tick), atomic_fetch_add(&(db_set_info_pool.tick), 1) + 1);
+}
 
-    int fd = fileno(p_db_set_info->file);
-    off_t file_size = lseek(fd, 0, SEEK_END);
+// Return the instance linked to the set name, or NULL if the set file is not open or being opened.
+// Only the bucket of the set name is locked, the instance should be checked again after it's locked.
+DB_SET_INFO_T *query_db_set_info_instance(char *p_db_set_name, uint32_t db_set_name_size)
+{
+    uint32_t bucket = get_db_set_info_bucket(p_db_set_name, db_set_name_size);
+    DB_SET_INFO_T *p_target_db_set_info = NULL;
 
-    if (file_size >= expected_db_set_properties_size)
+    lock_db_set_info_bucket_sync(bucket);
+    for (int32_t instance_position = db_set_info_pool.bucket[bucket]; instance_position != DB_SET_INFO_NULL_INSTANCE;)
     {
-        read_db_set_properties(p_db_set_info);
+        DB_SET_INFO_T *p_db_set_info = &(db_set_info_instance[instance_position]);
 
-        if ((p_db_set_properties->set_name_size == db_set_name_size) && (memcmp(p_db_set_properties->p_set_name, p_db_set_name, db_set_name_size) == 0))
+        if ((p_db_set_info->db_set_name_size == db_set_name_size) && (memcmp(p_db_set_info->db_set_name, p_db_set_name, db_set_name_size) == 0))
         {
-            return true;
+            p_target_db_set_info = p_db_set_info;
+            break;
         }
-        else
+        instance_position = p_db_set_info->next_instance;
+    }
+    unlock_db_set_info_bucket_sync(bucket);
+
+    return p_target_db_set_info;
+}
+
+// Link the instance to the hash bucket of its set name.
+// Lock the pool and the db set info before using this function.
+void link_db_set_info_instance(DB_SET_INFO_T *p_db_set_info)
+{
+    uint32_t bucket = get_db_set_info_bucket(p_db_set_info->db_set_name, p_db_set_info->db_set_name_size);
+
+    lock_db_set_info_bucket_sync(bucket);
+    p_db_set_info->next_instance = db_set_info_pool.bucket[bucket];
+    db_set_info_pool.bucket[bucket] = (int32_t)(p_db_set_info - db_set_info_instance);
+    unlock_db_set_info_bucket_sync(bucket);
+}
+
+// Lock the pool and the db set info before using this function.
+void unlink_db_set_info_instance(DB_SET_INFO_T *p_db_set_info)
+{
+    uint32_t bucket = get_db_set_info_bucket(p_db_set_info->db_set_name, p_db_set_info->db_set_name_size);
+
+    lock_db_set_info_bucket_sync(bucket);
+    for (int32_t *p_instance_position = &(db_set_info_pool.bucket[bucket]); *p_instance_position != DB_SET_INFO_NULL_INSTANCE;)
+    {
+        DB_SET_INFO_T *p_current_db_set_info = &(db_set_info_instance[*p_instance_position]);
+        if (p_current_db_set_info == p_db_set_info)
         {
-            free_db_set_properties_resources(p_db_set_properties);
-            db_set_properties_init(p_db_set_properties);
-            return false;
+            *p_instance_position = p_db_set_info->next_instance;
+            break;
         }
+        p_instance_position = &(p_current_db_set_info->next_instance);
     }
-    else
+    p_db_set_info->next_instance = DB_SET_INFO_NULL_INSTANCE;
+    unlock_db_set_info_bucket_sync(bucket);
+    p_db_set_info->db_set_name_size = 0;
+    p_db_set_info->db_set_name[0] = '\0';
+}
+
+// Writers and readers using or waiting for the instance are its references, a referenced instance is busy.
+// Lock the db set info before using this function.
+static inline bool is_db_set_info_instance_busy(DB_SET_INFO_T *p_db_set_info)
+{
+    DB_SET_INFO_SYNC_T *p_db_set_info_sync = &(p_db_set_info->db_set_info_sync);
+
+    return (check_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READY) == false) || (p_db_set_info_sync->writer_waiting_count > 0) || (p_db_set_info_sync->reader_waiting_count > 0) || (p_db_set_info_sync->reader_count > 0) ||
+           (p_db_set_info_sync->snapshot_writer_waiting_count > 0) || (p_db_set_info_sync->snapshot_writer_count > 0);
+}
+
+// Wait until the instance is not busy, then close its set file.
+// Lock the pool and the db set info before using this function.
+void release_db_set_info_instance(DB_SET_INFO_T *p_db_set_info)
+{
+    if (check_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_RELEASED))
     {
-        return false;
+        return;
+    }
+
+    db_set_info_sync_close_wait(p_db_set_info);
+    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_CLOSING);
+
+    unlink_db_set_info_instance(p_db_set_info);
+    close_db_set_info(p_db_set_info);
+
+    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_RELEASED);
+}
+
+// Return a released instance, or close the least recently used set file which is not busy.
+// Return NULL if all the instances are busy, the busy instances are not waited with the pool locked, see db_set_info_pool_sync_release_wait().
+// Lock the pool before using this function.
+DB_SET_INFO_T *request_and_lock_released_db_set_info_instance()
+{
+    DB_SET_INFO_T *p_victim_db_set_info = NULL;
+
+    for (uint32_t i = 0; i < db_set_info_pool.instance_num; i++)
+    {
+        DB_SET_INFO_T *p_db_set_info = &(db_set_info_instance[i]);
+
+        lock_db_set_info_sync(p_db_set_info);
+        if (check_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_RELEASED))
+        {
+            return p_db_set_info;
+        }
+
+        if ((is_db_set_info_instance_busy(p_db_set_info) == false) &&
+            ((p_victim_db_set_info == NULL) || (atomic_load(&(p_db_set_info->last_used_tick)) < atomic_load(&(p_victim_db_set_info->last_used_tick)))))
+        {
+            p_victim_db_set_info = p_db_set_info;
+        }
+        unlock_db_set_info_sync(p_db_set_info);
+    }
+
+    if (p_victim_db_set_info == NULL)
+    {
+        return NULL;
+    }
+
+    // The requests using the victim lock it after the lookup with the pool locked, it may be busy again.
+    lock_db_set_info_sync(p_victim_db_set_info);
+    if (is_db_set_info_instance_busy(p_victim_db_set_info))
+    {
+        unlock_db_set_info_sync(p_victim_db_set_info);
+        return NULL;
+    }
+    release_db_set_info_instance(p_victim_db_set_info);
+
+    return p_victim_db_set_info;
+}
+
+// Lock the db_set_info of the set name and check if it's loaded.
+// The pool isn't locked, the instance is checked again after it's locked since it could be closed and reused meanwhile.
+// Return NULL if the set is not loaded.
+DB_SET_INFO_T *query_and_lock_db_set_info_loaded(char *p_db_set_name_string)
+{
+    uint32_t db_set_name_string_size = strnlen(p_db_set_name_string, FACILEDB_FILE_PATH_MAX_LENGTH);
+    DB_SET_INFO_T *p_target_db_set_info = query_db_set_info_instance(p_db_set_name_string, db_set_name_string_size);
+
+    if (p_target_db_set_info == NULL)
+    {
+        return NULL;
+    }
+    touch_db_set_info_instance(p_target_db_set_info);
+
+    lock_db_set_info_sync(p_target_db_set_info);
+    if ((p_target_db_set_info->status < DB_SET_INFO_STATUS_READY) ||
+        (p_target_db_set_info->db_set_name_size != db_set_name_string_size) || (memcmp(p_target_db_set_info->db_set_name, p_db_set_name_string, db_set_name_string_size) != 0))
+    {
+        unlock_db_set_info_sync(p_target_db_set_info);
+        return NULL;
+    }
+
+    return p_target_db_set_info;
+}
+
+void create_new_db_set_file_format(DB_SET_INFO_T *p_db_set_info, uint8_t *p_db_set_name, uint32_t db_set_name_size)
+{
+    uint64_t current_time = get_current_time();
+
+    // Setup set_name nad write new db properties into file.
+    // store the db_set_name without the '\0'.
+    allocate_db_set_properties_resources(&(p_db_set_info->db_set_properties), db_set_name_size);
+    p_db_set_info->db_set_properties.set_name_size = db_set_name_size;
+    memcpy(p_db_set_info->db_set_properties.p_set_name, p_db_set_name, p_db_set_info->db_set_properties.set_name_size);
+    p_db_set_info->db_set_properties.created_time = current_time;
+    p_db_set_info->db_set_properties.modified_time = current_time;
+
+    write_db_set_properties(p_db_set_info);
+}
+
+// The header is locked while it's read, the creator of the set file locks the whole file until the properties are written.
+DB_SET_FILE_FORMAT_CHECK_E read_and_check_db_set_file_format(DB_SET_INFO_T *p_db_set_info, uint8_t *p_db_set_name, uint32_t db_set_name_size)
+{
+    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
+    DB_SET_PROPERTIES_T expected_db_set_properties = {.set_name_size = db_set_name_size};
+    off_t expected_db_set_properties_size = get_db_set_properties_size(&expected_db_set_properties);
+    DB_SET_FILE_FORMAT_CHECK_E format_check = DB_SET_FILE_FORMAT_INCOMPLETE;
+
+#if IS_POSIX_API_SUPPORT
+    // read db properties from file and check the format version & set_name
+    int fd = fileno(p_db_set_info->file);
+    uint32_t format_header[2] = {0}; // magic and format_version
+
+    lock_db_set_file_range(p_db_set_info, F_RDLCK, 0, expected_db_set_properties_size);
+    off_t file_size = lseek(fd, 0, SEEK_END);
+
+    if (file_size >= (off_t)sizeof(format_header))
+    {
+        // Check the magic number and the format version before reading the rest, their layout may differ.
+        pread(fd, format_header, sizeof(format_header), 0);
+        if ((format_header[0] != DB_SET_FILE_MAGIC) || (format_header[1] != DB_SET_FILE_FORMAT_VERSION))
+        {
+            format_check = DB_SET_FILE_FORMAT_MISMATCHED;
+        }
+        else if (file_size >= expected_db_set_properties_size)
+        {
+            read_db_set_properties(p_db_set_info);
+
+            if ((p_db_set_properties->set_name_size == db_set_name_size) && (memcmp(p_db_set_properties->p_set_name, p_db_set_name, db_set_name_size) == 0))
+            {
+                format_check = DB_SET_FILE_FORMAT_MATCHED;
+            }
+            else
+            {
+                free_db_set_properties_resources(p_db_set_properties);
+                db_set_properties_init(p_db_set_properties);
+                format_check = DB_SET_FILE_FORMAT_MISMATCHED;
+            }
+        }
     }
+    unlock_db_set_file_range(p_db_set_info, 0, expected_db_set_properties_size);
 #endif
+
+    return format_check;
 }
 
+// Return NULL if the set file is unavailable, e.g. it has another format version.
 DB_SET_INFO_T *load_and_lock_db_set_info(char *p_db_set_name)
 {
     DB_SET_INFO_T *p_db_set_info = NULL;
     char db_set_file_path[FACILEDB_FILE_PATH_BUFFER_LENGTH] = {0};
 
-    p_db_set_info = query_and_lock_db_set_info_loaded(p_db_set_name);
-    if (p_db_set_info != NULL)
+    while (p_db_set_info == NULL)
     {
-        return p_db_set_info;
-    }
+        bool is_loading = false;
+        uint64_t release_sequence = 0;
 
-    // db_set_info is not loaded, load it from file.
-    p_db_set_info = request_and_lock_released_db_set_info_instance();
-    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_STARTING);
+        p_db_set_info = query_and_lock_db_set_info_loaded(p_db_set_name);
+        if (p_db_set_info != NULL)
+        {
+            return p_db_set_info;
+        }
 
-    db_set_info_init(p_db_set_info);
+        // db_set_info is not loaded, link an instance to the set name with the pool locked, the others wait for it by the db set info mutex.
+        lock_db_set_info_pool_sync();
+        release_sequence = atomic_load(&(db_set_info_pool.release_sequence));
+        is_loading = (query_db_set_info_instance(p_db_set_name, strnlen(p_db_set_name, FACILEDB_FILE_PATH_MAX_LENGTH)) != NULL);
+        if (is_loading == false)
+        {
+            p_db_set_info = request_and_lock_released_db_set_info_instance();
+        }
+
+        if (p_db_set_info != NULL)
+        {
+            update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_STARTING);
+            db_set_info_init(p_db_set_info);
+            p_db_set_info->db_set_name_size = strnlen(p_db_set_name, FACILEDB_FILE_PATH_MAX_LENGTH);
+            memcpy(p_db_set_info->db_set_name, p_db_set_name, p_db_set_info->db_set_name_size);
+            p_db_set_info->db_set_name[p_db_set_info->db_set_name_size] = '\0';
+            link_db_set_info_instance(p_db_set_info);
+            touch_db_set_info_instance(p_db_set_info);
+        }
+        unlock_db_set_info_pool_sync();
+
+        if ((p_db_set_info == NULL) && (is_loading == false))
+        {
+            // All the instances are busy, wait for one of them to be idle.
+            db_set_info_pool_sync_release_wait(release_sequence);
+        }
+    }
+
+    // Load it from file.
     get_db_set_file_path_by_db_set_name(p_db_set_name, db_set_file_path);
 
 #if IS_POSIX_API_SUPPORT
@@ -849,7 +1652,7 @@ DB_SET_INFO_T *load_and_lock_db_set_info(char *p_db_set_name)
             perror("DB set file unavailable: ");
 
             close(fd);
-            unlock_db_set_info_sync(p_db_set_info);
+            abort_db_set_info_loading(p_db_set_info);
             return NULL;
         }
 
@@ -860,14 +1663,14 @@ DB_SET_INFO_T *load_and_lock_db_set_info(char *p_db_set_name)
     }
     else if (errno == EEXIST)
     {
-        bool timeout = true;
+        DB_SET_FILE_FORMAT_CHECK_E format_check = DB_SET_FILE_FORMAT_INCOMPLETE;
 
         // File exists
         fd = open(db_set_file_path, O_RDWR);
         if (fd < 0)
         {
             perror("DB set file unavailable: ");
-            unlock_db_set_info_sync(p_db_set_info);
+            abort_db_set_info_loading(p_db_set_info);
             return NULL;
         }
 
@@ -878,38 +1681,35 @@ DB_SET_INFO_T *load_and_lock_db_set_info(char *p_db_set_name)
             perror("DB set file unavailable: ");
 
             close(fd);
-            unlock_db_set_info_sync(p_db_set_info);
+            abort_db_set_info_loading(p_db_set_info);
             return NULL;
         }
 
         // Try to read db_properties and check if db_properties writed done
         for (uint32_t check_time = 0; check_time < DB_FILE_OPEN_CHECK_TIMEOUT; check_time++)
         {
-            db_set_info_file_lock_read(p_db_set_info);
-
-            if (read_and_check_db_set_file_format(p_db_set_info, (uint8_t *)p_db_set_name, strlen(p_db_set_name)) == true)
+            format_check = read_and_check_db_set_file_format(p_db_set_info, (uint8_t *)p_db_set_name, strlen(p_db_set_name));
+            if (format_check != DB_SET_FILE_FORMAT_INCOMPLETE)
             {
-                db_set_info_file_unlock_read(p_db_set_info);
-                timeout = false;
                 break;
             }
-            else
-            {
-                db_set_info_file_unlock_read(p_db_set_info);
-                usleep(DB_FILE_OPEN_CHECK_INTERVAL_US);
-            }
+            // wait and retry
+            usleep(DB_FILE_OPEN_CHECK_INTERVAL_US);
         }
 
-        if (timeout)
+        if (format_check != DB_SET_FILE_FORMAT_MATCHED)
         {
-            assert(0);
+            fprintf(stderr, "DB set file unavailable: %s has another format version or set name, or it's not created completely.\n", db_set_file_path);
+
+            abort_db_set_info_loading(p_db_set_info);
+            return NULL;
         }
     }
     else
     {
         // error
         perror("DB set file unavailable: ");
-        unlock_db_set_info_sync(p_db_set_info);
+        abort_db_set_info_loading(p_db_set_info);
         return NULL;
     }
 
@@ -924,9 +1724,10 @@ DB_SET_INFO_T *load_and_lock_db_set_info(char *p_db_set_name)
             return NULL;
         }
 
-        // read db properties from file and check set_name
+        // read db properties from file and check the format version & set_name
         read_db_set_properties(p_db_set_info);
-        if (!((strlen(p_db_set_name) == p_db_set_info->db_set_properties.set_name_size) &&
+        if (!((p_db_set_info->db_set_properties.magic == DB_SET_FILE_MAGIC) && (p_db_set_info->db_set_properties.format_version == DB_SET_FILE_FORMAT_VERSION) &&
+              (strlen(p_db_set_name) == p_db_set_info->db_set_properties.set_name_size) &&
               (memcmp(p_db_set_name, p_db_set_info->db_set_properties.p_set_name, p_db_set_info->db_set_properties.set_name_size) == 0)))
         {
             close_db_set_info(p_db_set_info);
@@ -963,30 +1764,68 @@ DB_SET_INFO_T *load_and_lock_db_set_info(char *p_db_set_name)
     return p_db_set_info;
 }
 
-void close_db_set_info_instances()
+// Release the instance whose set file fails to load, the pool is locked before the db set info as the lookup does.
+// The others find the instance starting meanwhile and query it again.
+void abort_db_set_info_loading(DB_SET_INFO_T *p_db_set_info)
 {
-    for (uint32_t i = 0; i < DB_SET_INFO_INSTANCE_NUM; i++)
+    unlock_db_set_info_sync(p_db_set_info);
+
+    lock_db_set_info_pool_sync();
+    lock_db_set_info_sync(p_db_set_info);
+
+    unlink_db_set_info_instance(p_db_set_info);
+    close_db_set_info(p_db_set_info);
+    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_RELEASED);
+#if IS_POSIX_API_SUPPORT
+    // The release of an excess instance waits for the loading, see db_set_info_sync_idle_wait().
+    pthread_cond_broadcast(&(p_db_set_info->db_set_info_sync.close_cond));
+#endif
+
+    unlock_db_set_info_sync(p_db_set_info);
+    unlock_db_set_info_pool_sync();
+    db_set_info_pool_sync_release_notify();
+}
+
+// Release the instance over the open set file number, its references are waited without the pool locked.
+// The set file is closed with the pool locked as the other releases do, so no request opens it meanwhile.
+void release_excess_db_set_info_instance(uint32_t instance_position)
+{
+    DB_SET_INFO_T *p_db_set_info = &(db_set_info_instance[instance_position]);
+
+    lock_db_set_info_pool_sync();
+    lock_db_set_info_sync(p_db_set_info);
+    // The instance is kept if the number is raised again meanwhile.
+    while ((instance_position >= db_set_info_pool.instance_num) && is_db_set_info_instance_busy(p_db_set_info) &&
+           (check_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_RELEASED) == false))
     {
-        DB_SET_INFO_T *p_db_set_info = &(db_set_info_instance[i]);
+        unlock_db_set_info_pool_sync();
+        db_set_info_sync_idle_wait(p_db_set_info);
+        unlock_db_set_info_sync(p_db_set_info);
 
+        lock_db_set_info_pool_sync();
         lock_db_set_info_sync(p_db_set_info);
+    }
 
-        // check db_set_info_status released
-        if (check_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_RELEASED))
-        {
-            // already released
-            unlock_db_set_info_sync(p_db_set_info);
-            continue;
-        }
-
-        db_set_info_sync_close_wait(p_db_set_info);
-        update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_CLOSING);
+    if (instance_position >= db_set_info_pool.instance_num)
+    {
+        release_db_set_info_instance(p_db_set_info);
+    }
+    unlock_db_set_info_sync(p_db_set_info);
+    unlock_db_set_info_pool_sync();
+}
 
-        close_db_set_info(p_db_set_info);
+void close_db_set_info_instances()
+{
+    lock_db_set_info_pool_sync();
+    for (uint32_t i = 0; i < DB_SET_INFO_INSTANCE_NUM; i++)
+    {
+        DB_SET_INFO_T *p_db_set_info = &(db_set_info_instance[i]);
 
-        update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_RELEASED);
+        lock_db_set_info_sync(p_db_set_info);
+        release_db_set_info_instance(p_db_set_info);
         unlock_db_set_info_sync(p_db_set_info);
     }
+    unlock_db_set_info_pool_sync();
 }
 
 void db_set_info_init(DB_SET_INFO_T *p_db_set_info)
@@ -994,6 +1833,9 @@ void db_set_info_init(DB_SET_INFO_T *p_db_set_info)
     p_db_set_info->file = NULL;
     db_set_properties_init(&(p_db_set_info->db_set_properties));
     db_set_info_sync_init(&(p_db_set_info->db_set_info_sync));
+#if ENABLE_DB_INDEX
+    db_index_catalog_init(&(p_db_set_info->index_catalog));
+#endif
 }
 
 // check if set file is in the db_set_directory
@@ -1041,6 +1883,9 @@ void free_db_set_info_resources(DB_SET_INFO_T *p_db_set_info)
         p_db_set_info->file = NULL;
     }
 
+#if ENABLE_DB_INDEX
+    close_db_index_catalog(&(p_db_set_info->index_catalog));
+#endif
     free_db_set_properties_resources(&(p_db_set_info->db_set_properties));
 }
 
@@ -1060,6 +1905,12 @@ void db_set_info_sync_init(DB_SET_INFO_SYNC_T *p_db_set_info_sync)
     p_db_set_info_sync->reader_waiting_count = 0;
     p_db_set_info_sync->reader_count = 0;
     p_db_set_info_sync->writer_waiting_count = 0;
+    p_db_set_info_sync->snapshot_writer_waiting_count = 0;
+    p_db_set_info_sync->snapshot_writer_count = 0;
+    p_db_set_info_sync->deleter_waiting_count = 0;
+    p_db_set_info_sync->deleter_count = 0;
+    p_db_set_info_sync->append_ticket = 0;
+    p_db_set_info_sync->publish_ticket = 0;
 }
 
 static inline void db_set_info_file_lock_write(DB_SET_INFO_T *p_db_set_info)
@@ -1074,7 +1925,7 @@ static inline void db_set_info_file_lock_write(DB_SET_INFO_T *p_db_set_info)
         .l_pid = 0  // unused
     };
 
-    // file level synchronization
+    // file level synchronization, the writers changing the whole set (e.g. making an index) block the appenders too.
     // fcntl F_SETLKW will block until the lock is acquired.
     // return value:  -1 means error.
     if (fcntl(fd, F_SETLKW, &fl) == -1)
@@ -1082,6 +1933,11 @@ static inline void db_set_info_file_lock_write(DB_SET_INFO_T *p_db_set_info)
         // TODO: error handling
         assert(0);
     }
+    refresh_db_set_properties(p_db_set_info);
+#endif
+
+#if ENABLE_DB_INDEX
+    refresh_db_index_catalog(p_db_set_info);
 #endif
 }
 
@@ -1107,59 +1963,120 @@ static inline void db_set_info_file_unlock_write(DB_SET_INFO_T *p_db_set_info)
 #endif
 }
 
-static inline void db_set_info_file_lock_read(DB_SET_INFO_T *p_db_set_info)
+// Lock the written blocks to write the deleted flags, the appenders of other processes can append blocks meanwhile.
+// The db set info is unlocked while waiting for the header and the blocks as publish_db_set_blocks() does, the deleter holding the blocks locks the header to write the delete sequence.
+// The written blocks are unlocked by db_set_info_file_unlock_write(), it unlocks all the ranges locked by this process, the deleter runs without the appenders.
+// Lock the db set info and count the deleter before using this function, the other requests of this process don't use the properties meanwhile.
+static inline void db_set_info_file_lock_blocks_write(DB_SET_INFO_T *p_db_set_info)
+{
+#if IS_POSIX_API_SUPPORT
+    off_t header_size = get_db_set_properties_size(&(p_db_set_info->db_set_properties));
+
+    unlock_db_set_info_sync(p_db_set_info);
+    lock_db_set_file_range(p_db_set_info, F_RDLCK, 0, header_size);
+    refresh_db_set_properties(p_db_set_info);
+    unlock_db_set_file_range(p_db_set_info, 0, header_size);
+
+    lock_db_set_file_written_blocks(p_db_set_info, F_WRLCK);
+
+    // The former deleter has written its delete sequence before unlocking the blocks.
+    lock_db_set_file_range(p_db_set_info, F_RDLCK, 0, header_size);
+    refresh_db_set_properties(p_db_set_info);
+    unlock_db_set_file_range(p_db_set_info, 0, header_size);
+    lock_db_set_info_sync(p_db_set_info);
+#endif
+
+#if ENABLE_DB_INDEX
+    db_set_info_sync_catalog_wait(p_db_set_info);
+    refresh_db_index_catalog(p_db_set_info);
+#endif
+}
+
+static inline void db_set_info_file_lock_header_write(DB_SET_INFO_T *p_db_set_info)
+{
+#if IS_POSIX_API_SUPPORT
+    lock_db_set_file_range(p_db_set_info, F_WRLCK, 0, get_db_set_properties_size(&(p_db_set_info->db_set_properties)));
+#endif
+}
+
+static inline void db_set_info_file_unlock_header(DB_SET_INFO_T *p_db_set_info)
 {
-    uint32_t *p_db_set_info_sync_reader_count = &(p_db_set_info->db_set_info_sync.reader_count);
 #if IS_POSIX_API_SUPPORT
+    unlock_db_set_file_range(p_db_set_info, 0, get_db_set_properties_size(&(p_db_set_info->db_set_properties)));
+#endif
+}
+
+#if IS_POSIX_API_SUPPORT
+// length = 0 means the range until the end of the file, including the region appended later.
+static inline void lock_db_set_file_range(DB_SET_INFO_T *p_db_set_info, short lock_type, off_t start, off_t length)
+{
     int fd = fileno(p_db_set_info->file);
     struct flock fl = {
-        .l_type = F_RDLCK, // read lock
+        .l_type = lock_type,
         .l_whence = SEEK_SET,
-        .l_start = 0,
-        .l_len = 0, // l_start = 0 && l_len = 0 means lock the whole file
-        .l_pid = 0  // unused
+        .l_start = start,
+        .l_len = length,
+        .l_pid = 0 // unused
     };
 
-    if (*p_db_set_info_sync_reader_count == 1)
+    // fcntl F_SETLKW will block until the lock is acquired.
+    // return value: -1 means error.
+    while (fcntl(fd, F_SETLKW, &fl) == -1)
     {
-        // first reader, get file lock
-        // fcntl F_SETLKW will block until the lock is acquired.
-        // return value: -1 means error.
-        if (fcntl(fd, F_SETLKW, &fl) == -1)
+        if (errno == EDEADLK)
+        {
+            // The locks are owned by the process, the range waited by the other process may be held by another thread of this process, which releases it without waiting.
+            // The blocks are waited with the db set info unlocked, the retry doesn't stall the other requests of this process.
+            usleep(DB_SET_FILE_LOCK_RETRY_INTERVAL_US);
+        }
+        else if (errno != EINTR)
         {
             // TODO: error handling
             assert(0);
         }
     }
-#endif
 }
 
-static inline void db_set_info_file_unlock_read(DB_SET_INFO_T *p_db_set_info)
+static inline void unlock_db_set_file_range(DB_SET_INFO_T *p_db_set_info, off_t start, off_t length)
 {
-    uint32_t *p_db_set_info_sync_reader_count = &(p_db_set_info->db_set_info_sync.reader_count);
-#if IS_POSIX_API_SUPPORT
     int fd = fileno(p_db_set_info->file);
     struct flock fl = {
         .l_type = F_UNLCK, // unlock
         .l_whence = SEEK_SET,
-        .l_start = 0,
-        .l_len = 0, // l_start = 0 && l_len = 0 means lock the whole file
-        .l_pid = 0  // unused
+        .l_start = start,
+        .l_len = length,
+        .l_pid = 0 // unused
     };
 
-    if (*p_db_set_info_sync_reader_count == 1)
+    // unlock doesn't need to wait.
+    // return value: -1 means error.
+    if (fcntl(fd, F_SETLK, &fl) == -1)
     {
-        // last reader.
-        // unlock file, return value: -1 means error.
-        if (fcntl(fd, F_SETLK, &fl) == -1)
-        {
-            // TODO: error handling
-            assert(0);
-        }
+        // TODO: error handling
+        assert(0);
     }
-#endif
 }
 
+// Lock the blocks whose tags are not greater than the block number, the blocks appended later are not locked.
+// The first byte of the blocks is locked if there is no block, the lockers of the written blocks always overlap.
+static inline void lock_db_set_file_written_blocks(DB_SET_INFO_T *p_db_set_info, short lock_type)
+{
+    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
+    off_t start = get_db_block_offset(p_db_set_properties, 1);
+    off_t length = get_db_block_offset(p_db_set_properties, p_db_set_properties->block_num + 1) - start;
+
+    // length = 0 means the whole file.
+    lock_db_set_file_range(p_db_set_info, lock_type, start, (length > 0) ? length : 1);
+}
+
+// Wait until the other processes unlock the range, the range isn't locked by this process.
+static inline void wait_db_set_file_range_unlocked(DB_SET_INFO_T *p_db_set_info, off_t start, off_t length)
+{
+    lock_db_set_file_range(p_db_set_info, F_RDLCK, start, length);
+    unlock_db_set_file_range(p_db_set_info, start, length);
+}
+#endif
+
 static inline void lock_db_set_info_sync(DB_SET_INFO_T *p_db_set_info)
 {
 #if IS_POSIX_API_SUPPORT
@@ -1181,12 +2098,30 @@ static inline void db_set_info_sync_close_wait(DB_SET_INFO_T *p_db_set_info)
     uint32_t *p_writer_waiting_count = &(p_db_set_info->db_set_info_sync.writer_waiting_count);
     uint32_t *p_reader_count = &(p_db_set_info->db_set_info_sync.reader_count);
     uint32_t *p_reader_waiting_count = &(p_db_set_info->db_set_info_sync.reader_waiting_count);
+    uint32_t *p_snapshot_writer_waiting_count = &(p_db_set_info->db_set_info_sync.snapshot_writer_waiting_count);
+    uint32_t *p_snapshot_writer_count = &(p_db_set_info->db_set_info_sync.snapshot_writer_count);
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_t *p_mutex = &(p_db_set_info->db_set_info_sync.db_set_info_mutex);
+    pthread_cond_t *p_close_cond = &(p_db_set_info->db_set_info_sync.close_cond);
+
+    // using while loop for spurious wakeup
+    while (check_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READY) == false || *p_writer_waiting_count > 0 || *p_reader_count > 0 || *p_reader_waiting_count > 0 ||
+           *p_snapshot_writer_waiting_count > 0 || *p_snapshot_writer_count > 0)
+    {
+        pthread_cond_wait(p_close_cond, p_mutex);
+    }
+#endif
+}
+
+// Wait until the instance is not busy or its loading is aborted, the pool is not locked.
+static inline void db_set_info_sync_idle_wait(DB_SET_INFO_T *p_db_set_info)
+{
 #if IS_POSIX_API_SUPPORT
     pthread_mutex_t *p_mutex = &(p_db_set_info->db_set_info_sync.db_set_info_mutex);
     pthread_cond_t *p_close_cond = &(p_db_set_info->db_set_info_sync.close_cond);
 
     // using while loop for spurious wakeup
-    while (check_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READY) == false || *p_writer_waiting_count > 0 || *p_reader_count > 0 || *p_reader_waiting_count > 0)
+    while (is_db_set_info_instance_busy(p_db_set_info) && (check_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_RELEASED) == false))
     {
         pthread_cond_wait(p_close_cond, p_mutex);
     }
@@ -1196,13 +2131,14 @@ static inline void db_set_info_sync_close_wait(DB_SET_INFO_T *p_db_set_info)
 static inline void db_set_info_sync_write_wait(DB_SET_INFO_T *p_db_set_info)
 {
     uint32_t *p_writer_waiting_count = &(p_db_set_info->db_set_info_sync.writer_waiting_count);
+    uint32_t *p_snapshot_writer_count = &(p_db_set_info->db_set_info_sync.snapshot_writer_count);
 
     (*p_writer_waiting_count)++;
 #if IS_POSIX_API_SUPPORT
     pthread_mutex_t *p_mutex = &(p_db_set_info->db_set_info_sync.db_set_info_mutex);
     pthread_cond_t *p_write_cond = &(p_db_set_info->db_set_info_sync.write_cond);
 
-    while (check_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READY) == false)
+    while (check_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READY) == false || *p_snapshot_writer_count > 0)
     {
         pthread_cond_wait(p_write_cond, p_mutex);
     }
@@ -1214,26 +2150,30 @@ static inline void db_set_info_sync_write_unblock(DB_SET_INFO_T *p_db_set_info)
 {
     uint32_t *p_writer_waiting_count = &(p_db_set_info->db_set_info_sync.writer_waiting_count);
     uint32_t *p_reader_waiting_count = &(p_db_set_info->db_set_info_sync.reader_waiting_count);
+    uint32_t *p_snapshot_writer_waiting_count = &(p_db_set_info->db_set_info_sync.snapshot_writer_waiting_count);
 #if IS_POSIX_API_SUPPORT
     pthread_cond_t *p_write_cond = &(p_db_set_info->db_set_info_sync.write_cond);
     pthread_cond_t *p_read_cond = &(p_db_set_info->db_set_info_sync.read_cond);
     pthread_cond_t *p_close_cond = &(p_db_set_info->db_set_info_sync.close_cond);
+    pthread_cond_t *p_snapshot_write_cond = &(p_db_set_info->db_set_info_sync.snapshot_write_cond);
 
-    // Priority: write > read > close
+    // Priority: write > snapshot write and read > close
     if (*p_writer_waiting_count > 0)
     {
         // notify the next writer
         pthread_cond_signal(p_write_cond);
     }
-    else if (*p_reader_waiting_count > 0)
+    else if (*p_snapshot_writer_waiting_count > 0 || *p_reader_waiting_count > 0)
     {
-        // notify all readers
+        // notify the snapshot writers and all readers, they run together.
+        pthread_cond_broadcast(p_snapshot_write_cond);
         pthread_cond_broadcast(p_read_cond);
     }
     else
     {
         // notify to close
-        pthread_cond_signal(p_close_cond);
+        pthread_cond_broadcast(p_close_cond);
+        db_set_info_pool_sync_release_notify();
     }
 #endif
 }
@@ -1263,14 +2203,23 @@ static inline void db_set_info_sync_read_unblock(DB_SET_INFO_T *p_db_set_info)
     uint32_t *p_reader_count = &(p_db_set_info->db_set_info_sync.reader_count);
     uint32_t *p_writer_waiting_count = &(p_db_set_info->db_set_info_sync.writer_waiting_count);
     uint32_t *p_reader_waiting_count = &(p_db_set_info->db_set_info_sync.reader_waiting_count);
+    uint32_t *p_snapshot_writer_waiting_count = &(p_db_set_info->db_set_info_sync.snapshot_writer_waiting_count);
+    uint32_t *p_snapshot_writer_count = &(p_db_set_info->db_set_info_sync.snapshot_writer_count);
 
     (*p_reader_count)--;
 #if IS_POSIX_API_SUPPORT
     pthread_cond_t *p_write_cond = &(p_db_set_info->db_set_info_sync.write_cond);
     pthread_cond_t *p_close_cond = &(p_db_set_info->db_set_info_sync.close_cond);
+    pthread_cond_t *p_snapshot_write_cond = &(p_db_set_info->db_set_info_sync.snapshot_write_cond);
 
     if (*p_reader_count == 0)
     {
+        if (*p_snapshot_writer_count > 0 || *p_snapshot_writer_waiting_count > 0)
+        {
+            // notify the snapshot writers waiting for the readers to refresh the catalog.
+            pthread_cond_broadcast(p_snapshot_write_cond);
+        }
+
         if (*p_writer_waiting_count > 0)
         {
             pthread_cond_signal(p_write_cond);
@@ -1278,32 +2227,151 @@ static inline void db_set_info_sync_read_unblock(DB_SET_INFO_T *p_db_set_info)
         else if (*p_reader_waiting_count == 0)
         {
             // reader_count = 0 && writer_waiting_count = 0 && reader_waiting_count = 0
-            pthread_cond_signal(p_close_cond);
+            pthread_cond_broadcast(p_close_cond);
+            db_set_info_pool_sync_release_notify();
         }
     }
 #endif
 }
 
-void update_db_set_info_status(DB_SET_INFO_T *p_db_set_info, DB_SET_INFO_STATUS_E new_status)
+// Return true if the snapshot writer waits, lock the db set info before using this function.
+// The writers changing the whole set go first, the appenders run together and the deleter runs alone.
+// The appender also waits to reload the catalog changed by the writer of other process, until the others don't use the catalog.
+static inline bool is_db_set_info_sync_snapshot_write_blocked(DB_SET_INFO_T *p_db_set_info, bool is_appending)
 {
-    DB_SET_INFO_STATUS_E *p_db_set_info_sync_status = &(p_db_set_info->status);
-    DB_SET_INFO_STATUS_E current_status = *p_db_set_info_sync_status;
-    bool is_valid_transition = false;
+    DB_SET_INFO_SYNC_T *p_db_set_info_sync = &(p_db_set_info->db_set_info_sync);
 
-    switch (current_status)
+    if ((check_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READY) == false && check_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READING) == false) ||
+        p_db_set_info_sync->writer_waiting_count > 0 || p_db_set_info_sync->deleter_count > 0)
     {
-    case DB_SET_INFO_STATUS_RELEASED:
+        return true;
+    }
+
+    if (is_appending == false)
     {
-        if (new_status == DB_SET_INFO_STATUS_STARTING)
-        {
-            is_valid_transition = true;
-        }
-        break;
+        return (p_db_set_info_sync->snapshot_writer_count > 0);
     }
-    case DB_SET_INFO_STATUS_STARTING:
+
+#if ENABLE_DB_INDEX
+    if ((p_db_set_info_sync->reader_count > 0 || p_db_set_info_sync->snapshot_writer_count > 0) && is_db_index_catalog_changed(p_db_set_info))
     {
-        if (new_status == DB_SET_INFO_STATUS_READY)
-        {
+        return true;
+    }
+#endif
+
+    return (p_db_set_info_sync->deleter_waiting_count > 0);
+}
+
+// The snapshot writers don't change the status, the readers read the set with them by the snapshots.
+static inline void db_set_info_sync_snapshot_write_wait(DB_SET_INFO_T *p_db_set_info, bool is_appending)
+{
+    uint32_t *p_snapshot_writer_waiting_count = &(p_db_set_info->db_set_info_sync.snapshot_writer_waiting_count);
+    uint32_t *p_snapshot_writer_count = &(p_db_set_info->db_set_info_sync.snapshot_writer_count);
+    uint32_t *p_deleter_waiting_count = &(p_db_set_info->db_set_info_sync.deleter_waiting_count);
+    uint32_t *p_deleter_count = &(p_db_set_info->db_set_info_sync.deleter_count);
+
+    (*p_snapshot_writer_waiting_count)++;
+    if (is_appending == false)
+    {
+        (*p_deleter_waiting_count)++;
+    }
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_t *p_mutex = &(p_db_set_info->db_set_info_sync.db_set_info_mutex);
+    pthread_cond_t *p_snapshot_write_cond = &(p_db_set_info->db_set_info_sync.snapshot_write_cond);
+
+    while (is_db_set_info_sync_snapshot_write_blocked(p_db_set_info, is_appending))
+    {
+        pthread_cond_wait(p_snapshot_write_cond, p_mutex);
+    }
+#endif
+    (*p_snapshot_writer_waiting_count)--;
+    (*p_snapshot_writer_count)++;
+    if (is_appending == false)
+    {
+        (*p_deleter_waiting_count)--;
+        (*p_deleter_count)++;
+    }
+}
+
+static inline void db_set_info_sync_snapshot_write_unblock(DB_SET_INFO_T *p_db_set_info, bool is_appending)
+{
+    uint32_t *p_writer_waiting_count = &(p_db_set_info->db_set_info_sync.writer_waiting_count);
+    uint32_t *p_reader_count = &(p_db_set_info->db_set_info_sync.reader_count);
+    uint32_t *p_reader_waiting_count = &(p_db_set_info->db_set_info_sync.reader_waiting_count);
+    uint32_t *p_snapshot_writer_waiting_count = &(p_db_set_info->db_set_info_sync.snapshot_writer_waiting_count);
+    uint32_t *p_snapshot_writer_count = &(p_db_set_info->db_set_info_sync.snapshot_writer_count);
+    uint32_t *p_deleter_count = &(p_db_set_info->db_set_info_sync.deleter_count);
+
+    (*p_snapshot_writer_count)--;
+    if (is_appending == false)
+    {
+        (*p_deleter_count)--;
+    }
+#if IS_POSIX_API_SUPPORT
+    pthread_cond_t *p_write_cond = &(p_db_set_info->db_set_info_sync.write_cond);
+    pthread_cond_t *p_close_cond = &(p_db_set_info->db_set_info_sync.close_cond);
+    pthread_cond_t *p_snapshot_write_cond = &(p_db_set_info->db_set_info_sync.snapshot_write_cond);
+
+    // Priority: write > snapshot write > close, the writer waiting for the readers is notified by the last reader.
+    if (*p_writer_waiting_count > 0)
+    {
+        if (*p_snapshot_writer_count == 0)
+        {
+            pthread_cond_signal(p_write_cond);
+        }
+    }
+    else if (*p_snapshot_writer_waiting_count > 0)
+    {
+        // notify the appenders together, or the deleter waiting for the others.
+        pthread_cond_broadcast(p_snapshot_write_cond);
+    }
+    else if (*p_snapshot_writer_count == 0 && *p_reader_count == 0 && *p_reader_waiting_count == 0)
+    {
+        pthread_cond_broadcast(p_close_cond);
+        db_set_info_pool_sync_release_notify();
+    }
+#endif
+}
+
+#if ENABLE_DB_INDEX
+// The readers use the catalog without locking the db set info, wait for them before reloading the catalog changed by the other processes.
+// Lock the db set info and count the snapshot writer before using this function, the readers starting meanwhile don't reload the catalog.
+static inline void db_set_info_sync_catalog_wait(DB_SET_INFO_T *p_db_set_info)
+{
+#if IS_POSIX_API_SUPPORT
+    uint32_t *p_reader_count = &(p_db_set_info->db_set_info_sync.reader_count);
+    pthread_mutex_t *p_mutex = &(p_db_set_info->db_set_info_sync.db_set_info_mutex);
+    pthread_cond_t *p_snapshot_write_cond = &(p_db_set_info->db_set_info_sync.snapshot_write_cond);
+
+    while (*p_reader_count > 0 && is_db_index_catalog_changed(p_db_set_info))
+    {
+        pthread_cond_wait(p_snapshot_write_cond, p_mutex);
+    }
+#endif
+}
+#endif
+
+void update_db_set_info_status(DB_SET_INFO_T *p_db_set_info, DB_SET_INFO_STATUS_E new_status)
+{
+    DB_SET_INFO_STATUS_E *p_db_set_info_sync_status = &(p_db_set_info->status);
+    DB_SET_INFO_STATUS_E current_status = *p_db_set_info_sync_status;
+    bool is_valid_transition = false;
+
+    switch (current_status)
+    {
+    case DB_SET_INFO_STATUS_RELEASED:
+    {
+        if (new_status == DB_SET_INFO_STATUS_STARTING)
+        {
+            is_valid_transition = true;
+        }
+        break;
+    }
+    case DB_SET_INFO_STATUS_STARTING:
+    {
+        // RELEASED: the set file fails to load.
+        if (new_status == DB_SET_INFO_STATUS_READY || new_status == DB_SET_INFO_STATUS_RELEASED)
+        {
             is_valid_transition = true;
         }
         break;
@@ -1376,10 +2444,16 @@ static inline bool check_db_set_info_status(DB_SET_INFO_T *p_db_set_info, DB_SET
 
 void db_set_properties_init(DB_SET_PROPERTIES_T *p_db_set_properties)
 {
+    p_db_set_properties->magic = DB_SET_FILE_MAGIC;
+    p_db_set_properties->format_version = DB_SET_FILE_FORMAT_VERSION;
+    p_db_set_properties->snapshot_sequence = 0;
     p_db_set_properties->block_num = 0;
+    p_db_set_properties->valid_record_num = 0;
+    p_db_set_properties->delete_sequence = 0;
+    p_db_set_properties->skipped_block_tag = 0;
     p_db_set_properties->created_time = 0;
     p_db_set_properties->modified_time = 0;
-    p_db_set_properties->valid_record_num = 0;
+    p_db_set_properties->reserved_block_num = 0;
     p_db_set_properties->set_name_size = 0;
 
     p_db_set_properties->p_set_name = NULL;
@@ -1390,7 +2464,8 @@ size_t get_db_set_properties_size(DB_SET_PROPERTIES_T *p_db_set_properties)
     size_t set_properties_size = 0;
 
     // static variable
-    set_properties_size = sizeof(p_db_set_properties->block_num) + sizeof(p_db_set_properties->created_time) + sizeof(p_db_set_properties->modified_time) + sizeof(p_db_set_properties->valid_record_num) + sizeof(p_db_set_properties->set_name_size);
+    set_properties_size = get_db_set_created_time_offset(p_db_set_properties) + sizeof(p_db_set_properties->created_time) + sizeof(p_db_set_properties->modified_time) +
+                          sizeof(p_db_set_properties->reserved_block_num) + sizeof(p_db_set_properties->set_name_size);
     // dynamic variables
     set_properties_size += p_db_set_properties->set_name_size;
 
@@ -1434,14 +2509,29 @@ void write_db_set_properties(DB_SET_INFO_T *p_db_set_info)
     off_t offset = 0;
 
     // write static variables
-    pwrite(fd, &(p_db_set_properties->block_num), sizeof(p_db_set_properties->block_num), offset);
-    offset += sizeof(p_db_set_properties->block_num);
+    pwrite(fd, &(p_db_set_properties->magic), sizeof(p_db_set_properties->magic), offset);
+    offset += sizeof(p_db_set_properties->magic);
+    pwrite(fd, &(p_db_set_properties->format_version), sizeof(p_db_set_properties->format_version), offset);
+    offset += sizeof(p_db_set_properties->format_version);
+    pwrite(fd, &(p_db_set_properties->snapshot_sequence), sizeof(p_db_set_properties->snapshot_sequence), offset);
+    offset += sizeof(p_db_set_properties->snapshot_sequence);
+    for (uint64_t slot = 0; slot < DB_SET_SNAPSHOT_SLOT_NUM; slot++)
+    {
+        pwrite(fd, &(p_db_set_properties->block_num), sizeof(p_db_set_properties->block_num), offset);
+        offset += sizeof(p_db_set_properties->block_num);
+        pwrite(fd, &(p_db_set_properties->valid_record_num), sizeof(p_db_set_properties->valid_record_num), offset);
+        offset += sizeof(p_db_set_properties->valid_record_num);
+        pwrite(fd, &(p_db_set_properties->delete_sequence), sizeof(p_db_set_properties->delete_sequence), offset);
+        offset += sizeof(p_db_set_properties->delete_sequence);
+        pwrite(fd, &(p_db_set_properties->skipped_block_tag), sizeof(p_db_set_properties->skipped_block_tag), offset);
+        offset += sizeof(p_db_set_properties->skipped_block_tag);
+    }
     pwrite(fd, &(p_db_set_properties->created_time), sizeof(p_db_set_properties->created_time), offset);
     offset += sizeof(p_db_set_properties->created_time);
     pwrite(fd, &(p_db_set_properties->modified_time), sizeof(p_db_set_properties->modified_time), offset);
     offset += sizeof(p_db_set_properties->modified_time);
-    pwrite(fd, &(p_db_set_properties->valid_record_num), sizeof(p_db_set_properties->valid_record_num), offset);
-    offset += sizeof(p_db_set_properties->valid_record_num);
+    pwrite(fd, &(p_db_set_properties->reserved_block_num), sizeof(p_db_set_properties->reserved_block_num), offset);
+    offset += sizeof(p_db_set_properties->reserved_block_num);
     pwrite(fd, &(p_db_set_properties->set_name_size), sizeof(p_db_set_properties->set_name_size), offset);
     offset += sizeof(p_db_set_properties->set_name_size);
 
@@ -1451,10 +2541,19 @@ void write_db_set_properties(DB_SET_INFO_T *p_db_set_info)
     fseek(p_db_set_file, 0, SEEK_SET);
 
     // write static variables
-    fwrite(&(p_db_set_properties->block_num), sizeof(p_db_set_properties->block_num), 1, p_db_set_file);
+    fwrite(&(p_db_set_properties->magic), sizeof(p_db_set_properties->magic), 1, p_db_set_file);
+    fwrite(&(p_db_set_properties->format_version), sizeof(p_db_set_properties->format_version), 1, p_db_set_file);
+    fwrite(&(p_db_set_properties->snapshot_sequence), sizeof(p_db_set_properties->snapshot_sequence), 1, p_db_set_file);
+    for (uint64_t slot = 0; slot < DB_SET_SNAPSHOT_SLOT_NUM; slot++)
+    {
+        fwrite(&(p_db_set_properties->block_num), sizeof(p_db_set_properties->block_num), 1, p_db_set_file);
+        fwrite(&(p_db_set_properties->valid_record_num), sizeof(p_db_set_properties->valid_record_num), 1, p_db_set_file);
+        fwrite(&(p_db_set_properties->delete_sequence), sizeof(p_db_set_properties->delete_sequence), 1, p_db_set_file);
+        fwrite(&(p_db_set_properties->skipped_block_tag), sizeof(p_db_set_properties->skipped_block_tag), 1, p_db_set_file);
+    }
     fwrite(&(p_db_set_properties->created_time), sizeof(p_db_set_properties->created_time), 1, p_db_set_file);
     fwrite(&(p_db_set_properties->modified_time), sizeof(p_db_set_properties->modified_time), 1, p_db_set_file);
-    fwrite(&(p_db_set_properties->valid_record_num), sizeof(p_db_set_properties->valid_record_num), 1, p_db_set_file);
+    fwrite(&(p_db_set_properties->reserved_block_num), sizeof(p_db_set_properties->reserved_block_num), 1, p_db_set_file);
     fwrite(&(p_db_set_properties->set_name_size), sizeof(p_db_set_properties->set_name_size), 1, p_db_set_file);
 
     // write dynamic variables
@@ -1469,19 +2568,24 @@ void read_db_set_properties(DB_SET_INFO_T *p_db_set_info)
 {
     FILE *p_db_set_file = p_db_set_info->file;
     DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
+    DB_SET_SNAPSHOT_T db_set_snapshot;
 
 #if IS_POSIX_API_SUPPORT
     int fd = fileno(p_db_set_file);
     off_t offset = 0;
 
-    pread(fd, &(p_db_set_properties->block_num), sizeof(p_db_set_properties->block_num), offset);
-    offset += sizeof(p_db_set_properties->block_num);
+    pread(fd, &(p_db_set_properties->magic), sizeof(p_db_set_properties->magic), offset);
+    offset += sizeof(p_db_set_properties->magic);
+    pread(fd, &(p_db_set_properties->format_version), sizeof(p_db_set_properties->format_version), offset);
+    offset += sizeof(p_db_set_properties->format_version);
+    pread(fd, &(p_db_set_properties->snapshot_sequence), sizeof(p_db_set_properties->snapshot_sequence), offset);
+    offset = get_db_set_created_time_offset(p_db_set_properties);
     pread(fd, &(p_db_set_properties->created_time), sizeof(p_db_set_properties->created_time), offset);
     offset += sizeof(p_db_set_properties->created_time);
     pread(fd, &(p_db_set_properties->modified_time), sizeof(p_db_set_properties->modified_time), offset);
     offset += sizeof(p_db_set_properties->modified_time);
-    pread(fd, &(p_db_set_properties->valid_record_num), sizeof(p_db_set_properties->valid_record_num), offset);
-    offset += sizeof(p_db_set_properties->valid_record_num);
+    pread(fd, &(p_db_set_properties->reserved_block_num), sizeof(p_db_set_properties->reserved_block_num), offset);
+    offset += sizeof(p_db_set_properties->reserved_block_num);
     pread(fd, &(p_db_set_properties->set_name_size), sizeof(p_db_set_properties->set_name_size), offset);
     offset += sizeof(p_db_set_properties->set_name_size);
 
@@ -1492,460 +2596,643 @@ void read_db_set_properties(DB_SET_INFO_T *p_db_set_info)
     fseek(p_db_set_file, 0, SEEK_SET);
 
     // read ststic variables
-    fread(&(p_db_set_properties->block_num), sizeof(p_db_set_properties->block_num), 1, p_db_set_file);
+    fread(&(p_db_set_properties->magic), sizeof(p_db_set_properties->magic), 1, p_db_set_file);
+    fread(&(p_db_set_properties->format_version), sizeof(p_db_set_properties->format_version), 1, p_db_set_file);
+    fread(&(p_db_set_properties->snapshot_sequence), sizeof(p_db_set_properties->snapshot_sequence), 1, p_db_set_file);
+    fseek(p_db_set_file, get_db_set_created_time_offset(p_db_set_properties), SEEK_SET);
     fread(&(p_db_set_properties->created_time), sizeof(p_db_set_properties->created_time), 1, p_db_set_file);
     fread(&(p_db_set_properties->modified_time), sizeof(p_db_set_properties->modified_time), 1, p_db_set_file);
-    fread(&(p_db_set_properties->valid_record_num), sizeof(p_db_set_properties->valid_record_num), 1, p_db_set_file);
+    fread(&(p_db_set_properties->reserved_block_num), sizeof(p_db_set_properties->reserved_block_num), 1, p_db_set_file);
     fread(&(p_db_set_properties->set_name_size), sizeof(p_db_set_properties->set_name_size), 1, p_db_set_file);
 
     // allocate dynamic variable buffer and read dynamic variables from file
     allocate_db_set_properties_resources(p_db_set_properties, p_db_set_properties->set_name_size);
     fread(p_db_set_properties->p_set_name, p_db_set_properties->set_name_size, 1, p_db_set_file);
 #endif // IS_POSIX_API_SUPPORT
+
+    // The set file isn't changed by the others while it's checked with the header locked.
+    read_db_set_snapshot_slot(p_db_set_info, p_db_set_properties->snapshot_sequence, &db_set_snapshot);
+    p_db_set_properties->block_num = db_set_snapshot.block_num;
+    p_db_set_properties->valid_record_num = db_set_snapshot.valid_record_num;
+    p_db_set_properties->delete_sequence = db_set_snapshot.delete_sequence;
+    p_db_set_properties->skipped_block_tag = db_set_snapshot.skipped_block_tag;
 }
 
-// return the updated value
-static inline uint64_t add_db_set_properties_valid_record_num(DB_SET_PROPERTIES_T *p_db_set_properties)
+// Read the properties changed by the writers of other processes, lock the header before using this function.
+void refresh_db_set_properties(DB_SET_INFO_T *p_db_set_info)
 {
-    // add and return the added value.
-    return ++(p_db_set_properties->valid_record_num);
+    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
+    DB_SET_SNAPSHOT_T db_set_snapshot;
+
+    // The set properties aren't written yet if the set file is just created.
+    if (p_db_set_properties->set_name_size == 0)
+    {
+        return;
+    }
+
+#if IS_POSIX_API_SUPPORT
+    int fd = fileno(p_db_set_info->file);
+    off_t offset = get_db_set_modified_time_offset(p_db_set_properties);
+
+    pread(fd, &(p_db_set_properties->snapshot_sequence), sizeof(p_db_set_properties->snapshot_sequence), get_db_set_snapshot_sequence_offset(p_db_set_properties));
+    pread(fd, &(p_db_set_properties->modified_time), sizeof(p_db_set_properties->modified_time), offset);
+    offset += sizeof(p_db_set_properties->modified_time);
+    pread(fd, &(p_db_set_properties->reserved_block_num), sizeof(p_db_set_properties->reserved_block_num), offset);
+
+    read_db_set_snapshot_slot(p_db_set_info, p_db_set_properties->snapshot_sequence, &db_set_snapshot);
+    p_db_set_properties->block_num = db_set_snapshot.block_num;
+    p_db_set_properties->valid_record_num = db_set_snapshot.valid_record_num;
+    p_db_set_properties->delete_sequence = db_set_snapshot.delete_sequence;
+    p_db_set_properties->skipped_block_tag = db_set_snapshot.skipped_block_tag;
+#else
+    (void)db_set_snapshot;
+#endif
 }
 
-void db_block_init(DB_BLOCK_T *p_db_block)
+off_t get_db_set_snapshot_sequence_offset(DB_SET_PROPERTIES_T *p_db_set_properties)
 {
-    p_db_block->block_tag = 0;
-    p_db_block->data_tag = 0;
-    p_db_block->prev_block_tag = 0;
-    p_db_block->next_block_tag = 0;
-    p_db_block->created_time = 0;
-    p_db_block->modified_time = 0;
-    p_db_block->deleted = 0;
-    p_db_block->valid_record_num = 0;
-    p_db_block->record_properties_num = 0;
+    return sizeof(p_db_set_properties->magic) + sizeof(p_db_set_properties->format_version);
+}
 
-    memset(p_db_block->block_data, 0, FACILEDB_BLOCK_DATA_SIZE);
+size_t get_db_set_snapshot_slot_size(DB_SET_PROPERTIES_T *p_db_set_properties)
+{
+    return sizeof(p_db_set_properties->block_num) + sizeof(p_db_set_properties->valid_record_num) + sizeof(p_db_set_properties->delete_sequence) + sizeof(p_db_set_properties->skipped_block_tag);
 }
 
-off_t get_db_block_offset(DB_SET_PROPERTIES_T *p_db_set_properties, uint64_t block_tag)
+// The snapshot sequences take the slots in turn.
+off_t get_db_set_snapshot_slot_offset(DB_SET_PROPERTIES_T *p_db_set_properties, uint64_t snapshot_sequence)
 {
-    size_t set_properties_size = get_db_set_properties_size(p_db_set_properties);
-    size_t block_size = get_db_block_size();
+    off_t first_slot_offset = get_db_set_snapshot_sequence_offset(p_db_set_properties) + sizeof(p_db_set_properties->snapshot_sequence);
 
-    return (set_properties_size + ((block_tag - 1) * block_size));
+    return first_slot_offset + ((snapshot_sequence % DB_SET_SNAPSHOT_SLOT_NUM) * get_db_set_snapshot_slot_size(p_db_set_properties));
 }
 
-size_t get_db_block_size()
+off_t get_db_set_created_time_offset(DB_SET_PROPERTIES_T *p_db_set_properties)
 {
-    DB_BLOCK_T dummy_db_block;
-    size_t attribute_size = sizeof(dummy_db_block.block_tag) + sizeof(dummy_db_block.data_tag) + sizeof(dummy_db_block.prev_block_tag) + sizeof(dummy_db_block.next_block_tag);
-    size_t time_attribute_size = sizeof(dummy_db_block.created_time) + sizeof(dummy_db_block.modified_time);
-    size_t other_attribute_size = sizeof(dummy_db_block.deleted) + sizeof(dummy_db_block.valid_record_num) + sizeof(dummy_db_block.record_properties_num);
+    off_t first_slot_offset = get_db_set_snapshot_sequence_offset(p_db_set_properties) + sizeof(p_db_set_properties->snapshot_sequence);
 
-    size_t block_data_size = sizeof(dummy_db_block.block_data);
+    return first_slot_offset + (DB_SET_SNAPSHOT_SLOT_NUM * get_db_set_snapshot_slot_size(p_db_set_properties));
+}
 
-    return (attribute_size + time_attribute_size + other_attribute_size + block_data_size);
+off_t get_db_set_modified_time_offset(DB_SET_PROPERTIES_T *p_db_set_properties)
+{
+    return get_db_set_created_time_offset(p_db_set_properties) + sizeof(p_db_set_properties->created_time);
 }
 
-void write_db_block(DB_BLOCK_T *p_db_block, DB_SET_INFO_T *p_db_set_info)
+off_t get_db_set_reserved_block_num_offset(DB_SET_PROPERTIES_T *p_db_set_properties)
 {
-    FILE *p_db_set_file = p_db_set_info->file;
-    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
-    uint64_t block_tag = p_db_block->block_tag;
-    off_t block_offset = get_db_block_offset(p_db_set_properties, block_tag);
+    return get_db_set_modified_time_offset(p_db_set_properties) + sizeof(p_db_set_properties->modified_time);
+}
 
-    assert((block_tag > 0) && (block_tag <= p_db_set_properties->block_num));
+// Read the snapshot slot of the sequence by a single read, the slot not published may be written meanwhile.
+void read_db_set_snapshot_slot(DB_SET_INFO_T *p_db_set_info, uint64_t snapshot_sequence, DB_SET_SNAPSHOT_T *p_db_set_snapshot)
+{
+    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
+    size_t slot_size = get_db_set_snapshot_slot_size(p_db_set_properties);
+    off_t offset = get_db_set_snapshot_slot_offset(p_db_set_properties, snapshot_sequence);
+    uint8_t slot_buffer[sizeof(DB_SET_SNAPSHOT_T)] = {0};
 
-    // write static variables
 #if IS_POSIX_API_SUPPORT
-    int fd = fileno(p_db_set_file);
-
-    // alignment makes sizeof and get_db_block_size() different.
-    if(sizeof(DB_BLOCK_T) == get_db_block_size())
-    {
-        pwrite(fd, p_db_block, sizeof(DB_BLOCK_T), block_offset);
-    }
-    else
-    {
-        pwrite(fd, &(p_db_block->block_tag), sizeof(p_db_block->block_tag), block_offset);
-        block_offset += sizeof(p_db_block->block_tag);
-        pwrite(fd, &(p_db_block->data_tag), sizeof(p_db_block->data_tag), block_offset);
-        block_offset += sizeof(p_db_block->data_tag);
-        pwrite(fd, &(p_db_block->prev_block_tag), sizeof(p_db_block->prev_block_tag), block_offset);
-        block_offset += sizeof(p_db_block->prev_block_tag);
-        pwrite(fd, &(p_db_block->next_block_tag), sizeof(p_db_block->next_block_tag), block_offset);
-        block_offset += sizeof(p_db_block->next_block_tag);
-        pwrite(fd, &(p_db_block->created_time), sizeof(p_db_block->created_time), block_offset);
-        block_offset += sizeof(p_db_block->created_time);
-        pwrite(fd, &(p_db_block->modified_time), sizeof(p_db_block->modified_time), block_offset);
-        block_offset += sizeof(p_db_block->modified_time);
-        pwrite(fd, &(p_db_block->deleted), sizeof(p_db_block->deleted), block_offset);
-        block_offset += sizeof(p_db_block->deleted);
-        pwrite(fd, &(p_db_block->valid_record_num), sizeof(p_db_block->valid_record_num), block_offset);
-        block_offset += sizeof(p_db_block->valid_record_num);
-        pwrite(fd, &(p_db_block->record_properties_num), sizeof(p_db_block->record_properties_num), block_offset);
-        block_offset += sizeof(p_db_block->record_properties_num);
-        pwrite(fd, p_db_block->block_data, sizeof(p_db_block->block_data), block_offset);
-    }
-#else  // IS_POSIX_API_SUPPORT
-    fseek(p_db_set_file, block_offset, SEEK_SET);
-
-    if (sizeof(DB_BLOCK_T) == get_db_block_size())
-    {
-        fwrite(p_db_block, sizeof(DB_BLOCK_T), 1, p_db_set_file);
-    }
-    else
-    {
-        fwrite(&(p_db_block->block_tag), sizeof(p_db_block->block_tag), 1, p_db_set_file);
-        fwrite(&(p_db_block->data_tag), sizeof(p_db_block->data_tag), 1, p_db_set_file);
-        fwrite(&(p_db_block->prev_block_tag), sizeof(p_db_block->prev_block_tag), 1, p_db_set_file);
-        fwrite(&(p_db_block->next_block_tag), sizeof(p_db_block->next_block_tag), 1, p_db_set_file);
-        fwrite(&(p_db_block->created_time), sizeof(p_db_block->created_time), 1, p_db_set_file);
-        fwrite(&(p_db_block->modified_time), sizeof(p_db_block->modified_time), 1, p_db_set_file);
-        fwrite(&(p_db_block->deleted), sizeof(p_db_block->deleted), 1, p_db_set_file);
-        fwrite(&(p_db_block->valid_record_num), sizeof(p_db_block->valid_record_num), 1, p_db_set_file);
-        fwrite(&(p_db_block->record_properties_num), sizeof(p_db_block->record_properties_num), 1, p_db_set_file);
+    pread(fileno(p_db_set_info->file), slot_buffer, slot_size, offset);
+#else
+    fseek(p_db_set_info->file, offset, SEEK_SET);
+    fread(slot_buffer, slot_size, 1, p_db_set_info->file);
+#endif
 
-        fwrite(p_db_block->block_data, sizeof(p_db_block->block_data), 1, p_db_set_file);
-    }
-#endif // IS_POSIX_API_SUPPORT
+    offset = 0;
+    memcpy(&(p_db_set_snapshot->block_num), slot_buffer + offset, sizeof(p_db_set_snapshot->block_num));
+    offset += sizeof(p_db_set_snapshot->block_num);
+    memcpy(&(p_db_set_snapshot->valid_record_num), slot_buffer + offset, sizeof(p_db_set_snapshot->valid_record_num));
+    offset += sizeof(p_db_set_snapshot->valid_record_num);
+    memcpy(&(p_db_set_snapshot->delete_sequence), slot_buffer + offset, sizeof(p_db_set_snapshot->delete_sequence));
+    offset += sizeof(p_db_set_snapshot->delete_sequence);
+    memcpy(&(p_db_set_snapshot->skipped_block_tag), slot_buffer + offset, sizeof(p_db_set_snapshot->skipped_block_tag));
 }
 
-void read_db_block(DB_SET_INFO_T *p_db_set_info, uint64_t block_tag, DB_BLOCK_T *p_db_block)
+// Publish block_num, valid_record_num, delete_sequence and skipped_block_tag by writing them to the slot of the next sequence and then the sequence.
+// The readers read the published slot without locking the header, the slot of a writer dying before the sequence is never read.
+// Refresh the properties with the header locked before using this function.
+void write_db_set_snapshot_slot(DB_SET_INFO_T *p_db_set_info)
 {
-    assert((block_tag > 0) && (block_tag <= p_db_set_info->db_set_properties.block_num));
+    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
+    uint64_t snapshot_sequence = p_db_set_properties->snapshot_sequence + 1;
+    size_t slot_size = get_db_set_snapshot_slot_size(p_db_set_properties);
+    off_t slot_offset = get_db_set_snapshot_slot_offset(p_db_set_properties, snapshot_sequence);
+    off_t sequence_offset = get_db_set_snapshot_sequence_offset(p_db_set_properties);
+    uint8_t slot_buffer[sizeof(DB_SET_SNAPSHOT_T)] = {0};
+    off_t offset = 0;
 
-    FILE *p_db_set_file = p_db_set_info->file;
-    off_t block_offset = get_db_block_offset(&(p_db_set_info->db_set_properties), block_tag);
+    memcpy(slot_buffer + offset, &(p_db_set_properties->block_num), sizeof(p_db_set_properties->block_num));
+    offset += sizeof(p_db_set_properties->block_num);
+    memcpy(slot_buffer + offset, &(p_db_set_properties->valid_record_num), sizeof(p_db_set_properties->valid_record_num));
+    offset += sizeof(p_db_set_properties->valid_record_num);
+    memcpy(slot_buffer + offset, &(p_db_set_properties->delete_sequence), sizeof(p_db_set_properties->delete_sequence));
+    offset += sizeof(p_db_set_properties->delete_sequence);
+    memcpy(slot_buffer + offset, &(p_db_set_properties->skipped_block_tag), sizeof(p_db_set_properties->skipped_block_tag));
 
-    // read static variables
 #if IS_POSIX_API_SUPPORT
-    int fd = fileno(p_db_set_file);
-
-    // Alignment may make sizeof and get_db_block_size() different.
-    if (sizeof(DB_BLOCK_T) == get_db_block_size())
-    {
-        pread(fd, p_db_block, sizeof(DB_BLOCK_T), block_offset);
-    }
-    else
-    {
-        pread(fd, &(p_db_block->block_tag), sizeof(p_db_block->block_tag), block_offset);
-        block_offset += sizeof(p_db_block->block_tag);
-        pread(fd, &(p_db_block->data_tag), sizeof(p_db_block->data_tag), block_offset);
-        block_offset += sizeof(p_db_block->data_tag);
-        pread(fd, &(p_db_block->prev_block_tag), sizeof(p_db_block->prev_block_tag), block_offset);
-        block_offset += sizeof(p_db_block->prev_block_tag);
-        pread(fd, &(p_db_block->next_block_tag), sizeof(p_db_block->next_block_tag), block_offset);
-        block_offset += sizeof(p_db_block->next_block_tag);
-        pread(fd, &(p_db_block->created_time), sizeof(p_db_block->created_time), block_offset);
-        block_offset += sizeof(p_db_block->created_time);
-        pread(fd, &(p_db_block->modified_time), sizeof(p_db_block->modified_time), block_offset);
-        block_offset += sizeof(p_db_block->modified_time);
-        pread(fd, &(p_db_block->deleted), sizeof(p_db_block->deleted), block_offset);
-        block_offset += sizeof(p_db_block->deleted);
-        pread(fd, &(p_db_block->valid_record_num), sizeof(p_db_block->valid_record_num), block_offset);
-        block_offset += sizeof(p_db_block->valid_record_num);
-        pread(fd, &(p_db_block->record_properties_num), sizeof(p_db_block->record_properties_num), block_offset);
-        block_offset += sizeof(p_db_block->record_properties_num);
-        pread(fd, p_db_block->block_data, sizeof(p_db_block->block_data), block_offset);
-    }
-#else // IS_POSIX_API_SUPPORT
-    fseek(p_db_set_file, block_offset, SEEK_SET);
-
-    if (sizeof(DB_BLOCK_T) == get_db_block_size())
-    {
-        fread(p_db_block, sizeof(DB_BLOCK_T), 1, p_db_set_file);
-    }
-    else
-    {
-        fread(&(p_db_block->block_tag), sizeof(p_db_block->block_tag), 1, p_db_set_file);
-        fread(&(p_db_block->data_tag), sizeof(p_db_block->data_tag), 1, p_db_set_file);
-        fread(&(p_db_block->prev_block_tag), sizeof(p_db_block->prev_block_tag), 1, p_db_set_file);
-        fread(&(p_db_block->next_block_tag), sizeof(p_db_block->next_block_tag), 1, p_db_set_file);
-        fread(&(p_db_block->created_time), sizeof(p_db_block->created_time), 1, p_db_set_file);
-        fread(&(p_db_block->modified_time), sizeof(p_db_block->modified_time), 1, p_db_set_file);
-        fread(&(p_db_block->deleted), sizeof(p_db_block->deleted), 1, p_db_set_file);
-        fread(&(p_db_block->valid_record_num), sizeof(p_db_block->valid_record_num), 1, p_db_set_file);
-        fread(&(p_db_block->record_properties_num), sizeof(p_db_block->record_properties_num), 1, p_db_set_file);
+    int fd = fileno(p_db_set_info->file);
 
-        fread(p_db_block->block_data, sizeof(p_db_block->block_data), 1, p_db_set_file);
-    }
+    pwrite(fd, slot_buffer, slot_size, slot_offset);
+    pwrite(fd, &snapshot_sequence, sizeof(snapshot_sequence), sequence_offset);
+#else
+    fseek(p_db_set_info->file, slot_offset, SEEK_SET);
+    fwrite(slot_buffer, slot_size, 1, p_db_set_info->file);
+    fseek(p_db_set_info->file, sequence_offset, SEEK_SET);
+    fwrite(&snapshot_sequence, sizeof(snapshot_sequence), 1, p_db_set_info->file);
 #endif
+
+    p_db_set_properties->snapshot_sequence = snapshot_sequence;
 }
 
-void read_db_block_attributes(DB_SET_INFO_T *p_db_set_info, uint64_t block_tag, DB_BLOCK_T *p_db_block)
+// The deleter publishes the delete sequence with the block number published by the appenders of other processes.
+// Lock the header before using this function.
+void write_db_set_delete_sequence(DB_SET_INFO_T *p_db_set_info)
 {
-    assert((block_tag > 0) && (block_tag <= p_db_set_info->db_set_properties.block_num));
+    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
+    uint32_t delete_sequence = p_db_set_properties->delete_sequence;
 
-    FILE *p_db_set_file = p_db_set_info->file;
-    off_t block_offset = get_db_block_offset(&(p_db_set_info->db_set_properties), block_tag);
+    // The deleters run alone, the published delete sequence is the former one.
+    refresh_db_set_properties(p_db_set_info);
+    p_db_set_properties->delete_sequence = delete_sequence;
+    write_db_set_snapshot_slot(p_db_set_info);
+}
 
+// The appender reserving the blocks writes the reserved block number and the data tag, the other fields are changed by the other writers.
+// Lock the header before using this function.
+void write_db_set_reservation(DB_SET_INFO_T *p_db_set_info)
+{
+    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
+    off_t reserved_block_num_offset = get_db_set_reserved_block_num_offset(p_db_set_properties);
+
+    write_db_set_snapshot_slot(p_db_set_info);
 #if IS_POSIX_API_SUPPORT
-    int fd = fileno(p_db_set_file);
+    pwrite(fileno(p_db_set_info->file), &(p_db_set_properties->reserved_block_num), sizeof(p_db_set_properties->reserved_block_num), reserved_block_num_offset);
+#else
+    fseek(p_db_set_info->file, reserved_block_num_offset, SEEK_SET);
+    fwrite(&(p_db_set_properties->reserved_block_num), sizeof(p_db_set_properties->reserved_block_num), 1, p_db_set_info->file);
+#endif
+}
 
-    pread(fd, &(p_db_block->block_tag), sizeof(p_db_block->block_tag), block_offset);
-    block_offset += sizeof(p_db_block->block_tag);
-    pread(fd, &(p_db_block->data_tag), sizeof(p_db_block->data_tag), block_offset);
-    block_offset += sizeof(p_db_block->data_tag);
-    pread(fd, &(p_db_block->prev_block_tag), sizeof(p_db_block->prev_block_tag), block_offset);
-    block_offset += sizeof(p_db_block->prev_block_tag);
-    pread(fd, &(p_db_block->next_block_tag), sizeof(p_db_block->next_block_tag), block_offset);
-    block_offset += sizeof(p_db_block->next_block_tag);
-    pread(fd, &(p_db_block->created_time), sizeof(p_db_block->created_time), block_offset);
-    block_offset += sizeof(p_db_block->created_time);
-    pread(fd, &(p_db_block->modified_time), sizeof(p_db_block->modified_time), block_offset);
-    block_offset += sizeof(p_db_block->modified_time);
-    pread(fd, &(p_db_block->deleted), sizeof(p_db_block->deleted), block_offset);
-    block_offset += sizeof(p_db_block->deleted);
-    pread(fd, &(p_db_block->valid_record_num), sizeof(p_db_block->valid_record_num), block_offset);
-    block_offset += sizeof(p_db_block->valid_record_num);
-    pread(fd, &(p_db_block->record_properties_num), sizeof(p_db_block->record_properties_num), block_offset);
-#else  // IS_POSIX_API_SUPPORT
-    fseek(p_db_set_file, block_offset, SEEK_SET);
+// The appender publishing the blocks writes the block number and the modified time.
+// Lock the header before using this function.
+void write_db_set_block_num(DB_SET_INFO_T *p_db_set_info)
+{
+    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
+    off_t modified_time_offset = get_db_set_modified_time_offset(p_db_set_properties);
 
-    fread(&(p_db_block->block_tag), sizeof(p_db_block->block_tag), 1, p_db_set_file);
-    fread(&(p_db_block->data_tag), sizeof(p_db_block->data_tag), 1, p_db_set_file);
-    fread(&(p_db_block->prev_block_tag), sizeof(p_db_block->prev_block_tag), 1, p_db_set_file);
-    fread(&(p_db_block->next_block_tag), sizeof(p_db_block->next_block_tag), 1, p_db_set_file);
-    fread(&(p_db_block->created_time), sizeof(p_db_block->created_time), 1, p_db_set_file);
-    fread(&(p_db_block->modified_time), sizeof(p_db_block->modified_time), 1, p_db_set_file);
-    fread(&(p_db_block->deleted), sizeof(p_db_block->deleted), 1, p_db_set_file);
-    fread(&(p_db_block->valid_record_num), sizeof(p_db_block->valid_record_num), 1, p_db_set_file);
-    fread(&(p_db_block->record_properties_num), sizeof(p_db_block->record_properties_num), 1, p_db_set_file);
-#endif // IS_POSIX_API_SUPPORT
+#if IS_POSIX_API_SUPPORT
+    pwrite(fileno(p_db_set_info->file), &(p_db_set_properties->modified_time), sizeof(p_db_set_properties->modified_time), modified_time_offset);
+#else
+    fseek(p_db_set_info->file, modified_time_offset, SEEK_SET);
+    fwrite(&(p_db_set_properties->modified_time), sizeof(p_db_set_properties->modified_time), 1, p_db_set_info->file);
+#endif
+    write_db_set_snapshot_slot(p_db_set_info);
 }
 
-// traverse backward
-void update_db_block_next_block_tag(uint64_t block_tag, uint64_t next_block_tag, DB_SET_INFO_T *p_db_set_info)
+// Read the snapshot of a reader from the published slot, which has the blocks and the deletes published by the writers of all the processes.
+// The header isn't locked, the slot is read again if another slot is published meanwhile.
+// Lock the db set info and count the reader before using this function.
+void read_db_set_snapshot(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot)
 {
-    DB_BLOCK_T db_block;
-    db_block_init(&db_block);
+#if IS_POSIX_API_SUPPORT
+    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
+    int fd = fileno(p_db_set_info->file);
+    off_t sequence_offset = get_db_set_snapshot_sequence_offset(p_db_set_properties);
+    uint64_t snapshot_sequence = 0;
+    uint64_t published_sequence = 0;
 
-    read_db_block(p_db_set_info, block_tag, &db_block);
-    db_block.next_block_tag = next_block_tag;
-    // TODO: only write the next_block_tag value
-    write_db_block(&db_block, p_db_set_info);
+    pread(fd, &published_sequence, sizeof(published_sequence), sequence_offset);
+    do
+    {
+        // The slot of the sequence is rewritten after the next sequence is published, the sequence read again differs then.
+        snapshot_sequence = published_sequence;
+        read_db_set_snapshot_slot(p_db_set_info, snapshot_sequence, p_db_set_snapshot);
+        pread(fd, &published_sequence, sizeof(published_sequence), sequence_offset);
+    } while (published_sequence != snapshot_sequence);
 
-    if (db_block.prev_block_tag != 0)
+#if ENABLE_DB_INDEX
+    // The other readers and the snapshot writer are using the catalog, the writers of other processes don't change it with the header locked.
+    if (p_db_set_info->db_set_info_sync.reader_count == 1 && p_db_set_info->db_set_info_sync.snapshot_writer_count == 0 && is_db_index_catalog_changed(p_db_set_info))
     {
-        update_db_block_next_block_tag(db_block.prev_block_tag, block_tag, p_db_set_info);
+        off_t header_size = get_db_set_properties_size(p_db_set_properties);
+
+        lock_db_set_file_range(p_db_set_info, F_RDLCK, 0, header_size);
+        refresh_db_index_catalog(p_db_set_info);
+        unlock_db_set_file_range(p_db_set_info, 0, header_size);
     }
+#endif
+#else
+    get_db_set_latest_snapshot(p_db_set_info, p_db_set_snapshot);
+#endif
 }
 
-void extract_db_data_info_from_db_blocks_handler_update_time(DB_DATA_INFO_T *p_db_data_info, DB_BLOCK_T *p_db_block)
+// The snapshot of the writers, who have the latest properties.
+void get_db_set_latest_snapshot(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot)
 {
-    if (p_db_block->created_time > p_db_data_info->created_time)
-    {
-        p_db_data_info->created_time = p_db_block->created_time;
-    }
+    p_db_set_snapshot->block_num = p_db_set_info->db_set_properties.block_num;
+    p_db_set_snapshot->valid_record_num = p_db_set_info->db_set_properties.valid_record_num;
+    p_db_set_snapshot->delete_sequence = p_db_set_info->db_set_properties.delete_sequence;
+    p_db_set_snapshot->skipped_block_tag = p_db_set_info->db_set_properties.skipped_block_tag;
+}
 
-    if (p_db_block->modified_time > p_db_data_info->modified_time)
-    {
-        p_db_data_info->modified_time = p_db_block->modified_time;
-    }
+// The block is visible if it's appended before the snapshot, and it's not deleted or deleted after the snapshot.
+// The deleted blocks are kept in the set file, their space isn't reclaimed since the snapshots taken before the delete still read them.
+static inline bool is_db_block_visible(DB_SET_SNAPSHOT_T *p_db_set_snapshot, uint64_t block_tag, uint32_t deleted)
+{
+    return (block_tag <= p_db_set_snapshot->block_num) && ((deleted == 0) || (deleted > p_db_set_snapshot->delete_sequence));
 }
 
-void extract_db_data_info_from_db_blocks(DB_DATA_INFO_T *p_db_data_info, uint64_t start_block_tag, DB_SET_INFO_T *p_db_set_info)
+// Return false if the published block isn't the first block of a data, e.g. it's skipped for a dead appender.
+static inline bool is_db_start_block_written(DB_SET_INFO_T *p_db_set_info, uint64_t block_tag)
 {
     DB_BLOCK_T db_block;
-    uint32_t record_num = 0;
-    DB_RECORD_INFO_T *result = NULL;
-    uint8_t *p_block_data = NULL;
-    uint8_t *p_block_end_address = NULL;
 
     db_block_init(&db_block);
-    read_db_block(p_db_set_info, start_block_tag, &db_block);
-
-    p_db_data_info->data_tag = db_block.data_tag;
-    p_db_data_info->start_db_block_tag = start_block_tag;
-    extract_db_data_info_from_db_blocks_handler_update_time(p_db_data_info, &db_block);
-    // update record_num at the end of this function.
-    p_db_data_info->deleted = db_block.deleted;
+    read_db_block_attributes(p_db_set_info, block_tag, &db_block);
 
-    record_num = db_block.valid_record_num;
-    result = malloc(record_num * sizeof(DB_RECORD_INFO_T));
-    p_block_data = db_block.block_data;
-    p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
+    return (db_block.block_tag == block_tag) && (db_block.prev_block_tag == 0);
+}
 
-    if (result == NULL)
-    {
-        p_db_data_info->record_num = 0;
-        p_db_data_info->p_db_record_info = NULL;
-        return;
-    }
+// return the updated value
+static inline uint64_t add_db_set_properties_valid_record_num(DB_SET_PROPERTIES_T *p_db_set_properties)
+{
+    // add and return the added value.
+    return ++(p_db_set_properties->valid_record_num);
+}
 
-    for (uint32_t i = 0; i < record_num; i++)
-    {
-        bool find_valid_db_record = false;
-        uint32_t remaining_size = 0;
+// Reserve the blocks and the data tag of a data after the blocks reserved by the appenders of all the processes.
+// The header is locked shortly to count the reservation, the reserved blocks are locked until they're published.
+// Return false if the catalog is changed by the writer of other process while the others use it, wait and reserve again.
+// Lock the db set info and count the appender before using this function.
+bool reserve_db_set_blocks(DB_SET_INFO_T *p_db_set_info, DB_BLOCK_RESERVATION_T *p_db_block_reservation, uint64_t block_num)
+{
+    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
+    DB_SET_INFO_SYNC_T *p_db_set_info_sync = &(p_db_set_info->db_set_info_sync);
+    uint64_t reserved_block_num = 0;
 
-        db_record_info_init(&(result[i]));
+    db_set_info_file_lock_header_write(p_db_set_info);
 
-        // check if valid record (deleted == false) and reaches to the valid one.
-        while (find_valid_db_record == false)
+#if ENABLE_DB_INDEX
+    // The writers of other processes don't change the catalog with the header or the reserved blocks locked.
+    if (is_db_index_catalog_changed(p_db_set_info))
+    {
+        if (p_db_set_info_sync->reader_count > 0 || p_db_set_info_sync->snapshot_writer_count > 1)
         {
-            if ((p_block_data + get_db_record_properties_size()) > p_block_end_address)
-            {
-                // clear the current block and read next block from next_block_tag and update the variables.
-                int next_block_tag = db_block.next_block_tag;
-                assert(next_block_tag != 0);
+            db_set_info_file_unlock_header(p_db_set_info);
+            return false;
+        }
+        refresh_db_index_catalog(p_db_set_info);
+    }
+#endif
 
-                db_block_init(&db_block);
-                read_db_block(p_db_set_info, next_block_tag, &db_block);
-                extract_db_data_info_from_db_blocks_handler_update_time(p_db_data_info, &db_block);
-                p_block_data = db_block.block_data;
-                p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
-            }
+    refresh_db_set_properties(p_db_set_info);
+    reserved_block_num = (p_db_set_properties->reserved_block_num > p_db_set_properties->block_num) ? p_db_set_properties->reserved_block_num : p_db_set_properties->block_num;
 
-            // check if the record deleted or not.
-            if (((DB_RECORD_PROPERTIES_T *)p_block_data)->deleted == 0)
-            {
-                find_valid_db_record = true;
-                break;
-            }
-            else
-            {
-                // record was deleted, bypass it.
-                uint32_t key_size = ((DB_RECORD_PROPERTIES_T *)p_block_data)->key_size;
-                uint32_t value_size = ((DB_RECORD_PROPERTIES_T *)p_block_data)->value_size;
+    p_db_block_reservation->first_block_tag = reserved_block_num + 1;
+    p_db_block_reservation->last_block_tag = reserved_block_num + block_num;
+    p_db_block_reservation->next_block_tag = p_db_block_reservation->first_block_tag;
+    p_db_block_reservation->data_tag = add_db_set_properties_valid_record_num(p_db_set_properties);
+    p_db_block_reservation->ticket = p_db_set_info_sync->append_ticket++;
 
-                find_valid_db_record = false;
-                p_block_data += get_db_record_properties_size();
+    p_db_set_properties->reserved_block_num = p_db_block_reservation->last_block_tag;
+    write_db_set_reservation(p_db_set_info);
 
-                remaining_size = key_size;
-                while (remaining_size > 0)
-                {
-                    uint32_t remaining_block_size = p_block_end_address - p_block_data;
-                    uint32_t forward_size = (remaining_block_size > remaining_size) ? (remaining_size) : (remaining_block_size);
+#if IS_POSIX_API_SUPPORT
+    // Nobody locks the blocks after the reserved block number, this lock doesn't wait.
+    off_t start = get_db_block_offset(p_db_set_properties, p_db_block_reservation->first_block_tag);
+    off_t end = get_db_block_offset(p_db_set_properties, p_db_block_reservation->last_block_tag + 1);
 
-                    p_block_data += forward_size;
-                    if (forward_size == 0)
-                    {
-                        // p_block_data reaches the end of the block, load next block and update variables.
-                        int next_block_tag = db_block.next_block_tag;
-                        assert(next_block_tag != 0);
+    lock_db_set_file_range(p_db_set_info, F_WRLCK, start, end - start);
+#endif
+    db_set_info_file_unlock_header(p_db_set_info);
 
-                        db_block_init(&db_block);
-                        read_db_block(p_db_set_info, next_block_tag, &db_block);
-                        extract_db_data_info_from_db_blocks_handler_update_time(p_db_data_info, &db_block);
-                        p_block_data = db_block.block_data;
-                        p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
-                    }
-                    remaining_size -= forward_size;
-                }
+    return true;
+}
 
-                remaining_size = value_size;
-                while (remaining_size > 0)
-                {
-                    uint32_t remaining_block_size = p_block_end_address - p_block_data;
-                    uint32_t forward_size = (remaining_block_size > remaining_size) ? (remaining_size) : (remaining_block_size);
+// Publish the reserved blocks after the blocks reserved before them, the block number is written without a gap.
+// The appender of other process releases its blocks after publishing them, the blocks of a dead appender are skipped.
+// Lock the db set info before using this function, it's unlocked while waiting for the appenders of other processes.
+void publish_db_set_blocks(DB_SET_INFO_T *p_db_set_info, DB_BLOCK_RESERVATION_T *p_db_block_reservation)
+{
+    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
+    DB_SET_INFO_SYNC_T *p_db_set_info_sync = &(p_db_set_info->db_set_info_sync);
 
-                    p_block_data += forward_size;
-                    if (forward_size == 0)
-                    {
-                        // p_block_data reaches the end of the block, load next block and update variables.
-                        int next_block_tag = db_block.next_block_tag;
-                        assert(next_block_tag != 0);
+#if IS_POSIX_API_SUPPORT
+    off_t start = get_db_block_offset(p_db_set_properties, p_db_block_reservation->first_block_tag);
+    off_t end = get_db_block_offset(p_db_set_properties, p_db_block_reservation->last_block_tag + 1);
 
-                        db_block_init(&db_block);
-                        read_db_block(p_db_set_info, next_block_tag, &db_block);
-                        extract_db_data_info_from_db_blocks_handler_update_time(p_db_data_info, &db_block);
-                        p_block_data = db_block.block_data;
-                        p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
-                    }
-                    remaining_size -= forward_size;
-                }
-            }
-        }
-        // Setting record properties offset and copy db_record_properties from db_block_data.
-        result[i].db_record_properties_offset = get_db_block_offset(&(p_db_set_info->db_set_properties), db_block.block_tag) + (p_block_data - ((uint8_t *)&db_block));
-        memcpy(&(result[i].db_record_properties), p_block_data, get_db_record_properties_size());
-        p_block_data += get_db_record_properties_size();
+    // The appenders of this process publish by the order of their reservations.
+    while (p_db_set_info_sync->publish_ticket != p_db_block_reservation->ticket)
+    {
+        pthread_cond_wait(&(p_db_set_info_sync->publish_cond), &(p_db_set_info_sync->db_set_info_mutex));
+    }
+#endif
 
-        // Copy db_record from the db blocks.
-        allocate_db_record_resources(&(result[i].db_record), result[i].db_record_properties.key_size, result[i].db_record_properties.value_size);
+    db_set_info_file_lock_header_write(p_db_set_info);
+    refresh_db_set_properties(p_db_set_info);
 
-        // copy db_record key from db block data.
-        remaining_size = result[i].db_record_properties.key_size;
-        while (remaining_size > 0)
-        {
-            uint32_t remaining_block_size = p_block_end_address - p_block_data;
-            uint32_t copy_size = (remaining_block_size > remaining_size) ? (remaining_size) : (remaining_block_size);
-            uint8_t *p_key = NULL;
+#if IS_POSIX_API_SUPPORT
+    // The former appenders of other processes hold their blocks until they're published with the header locked, the former appenders of this process have published theirs.
+    // Wait for their blocks without locking the header and the db set info, the fcntl locks are owned by the process and the other threads keep using them.
+    if ((p_db_set_properties->block_num + 1) < p_db_block_reservation->first_block_tag)
+    {
+        off_t waited_start = get_db_block_offset(p_db_set_properties, p_db_set_properties->block_num + 1);
 
-            if (copy_size == 0)
-            {
-                // read next block and update variables.
-                int next_block_tag = db_block.next_block_tag;
-                assert(next_block_tag != 0);
+        db_set_info_file_unlock_header(p_db_set_info);
+        unlock_db_set_info_sync(p_db_set_info);
+        wait_db_set_file_range_unlocked(p_db_set_info, waited_start, start - waited_start);
+        lock_db_set_info_sync(p_db_set_info);
 
-                db_block_init(&db_block);
-                read_db_block(p_db_set_info, next_block_tag, &db_block);
-                extract_db_data_info_from_db_blocks_handler_update_time(p_db_data_info, &db_block);
-                p_block_data = db_block.block_data;
-                p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
+        db_set_info_file_lock_header_write(p_db_set_info);
+        refresh_db_set_properties(p_db_set_info);
+    }
+#endif
 
-                continue;
-            }
+    if ((p_db_set_properties->block_num + 1) < p_db_block_reservation->first_block_tag)
+    {
+        // The appenders reserving the blocks are dead.
+        skip_db_blocks(p_db_set_info, p_db_set_properties->block_num + 1, p_db_block_reservation->first_block_tag - 1);
+    }
 
-            p_key = result[i].db_record.p_key + result[i].db_record_properties.key_size - remaining_size;
-            memcpy(p_key, p_block_data, copy_size);
-            p_block_data += copy_size;
-            remaining_size -= copy_size;
-        }
+    p_db_set_properties->block_num = p_db_block_reservation->last_block_tag;
+    p_db_set_properties->modified_time = (uint64_t)get_current_time();
+    write_db_set_block_num(p_db_set_info);
 
-        remaining_size = result[i].db_record_properties.value_size;
-        while (remaining_size > 0)
-        {
-            uint32_t remaining_block_size = p_block_end_address - p_block_data;
-            uint32_t copy_size = (remaining_block_size > remaining_size) ? (remaining_size) : (remaining_block_size);
-            uint8_t *p_value = NULL;
+#if IS_POSIX_API_SUPPORT
+    unlock_db_set_file_range(p_db_set_info, start, end - start);
+#endif
+    db_set_info_file_unlock_header(p_db_set_info);
 
-            if (copy_size == 0)
-            {
-                // read next block and update variables.
-                int next_block_tag = db_block.next_block_tag;
-                assert(next_block_tag != 0);
+    p_db_set_info_sync->publish_ticket++;
+#if IS_POSIX_API_SUPPORT
+    pthread_cond_broadcast(&(p_db_set_info_sync->publish_cond));
+#endif
+}
 
-                db_block_init(&db_block);
-                read_db_block(p_db_set_info, next_block_tag, &db_block);
-                extract_db_data_info_from_db_blocks_handler_update_time(p_db_data_info, &db_block);
-                p_block_data = db_block.block_data;
-                p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
-            }
+// Write the blocks left by the dead appenders as the following blocks of no data, the searches skip them.
+// The dead appenders may have written the index and covering entries of their data, the covered searches check the blocks up to skipped_block_tag.
+// The skipped block tag is published with the block number.
+void skip_db_blocks(DB_SET_INFO_T *p_db_set_info, uint64_t first_block_tag, uint64_t last_block_tag)
+{
+    DB_BLOCK_T db_block;
 
-            p_value = result[i].db_record.p_value + result[i].db_record_properties.value_size - remaining_size;
-            memcpy(p_value, p_block_data, copy_size);
-            p_block_data += copy_size;
-            remaining_size -= copy_size;
-        }
+    for (uint64_t block_tag = first_block_tag; block_tag <= last_block_tag; block_tag++)
+    {
+        db_block_init(&db_block);
+        db_block.block_tag = block_tag;
+        db_block.prev_block_tag = block_tag;
+        write_db_block(&db_block, p_db_set_info);
     }
-
-    p_db_data_info->p_db_record_info = result;
-    p_db_data_info->record_num = record_num;
+    p_db_set_info->db_set_properties.skipped_block_tag = last_block_tag;
 }
 
-// currently, this function only work for unit test.
-DB_RECORD_INFO_T *extract_db_record_info_from_db_blocks(uint64_t block_tag, DB_SET_INFO_T *p_db_set_info, uint32_t *p_record_num)
+void db_block_init(DB_BLOCK_T *p_db_block)
+{
+    p_db_block->block_tag = 0;
+    p_db_block->data_tag = 0;
+    p_db_block->prev_block_tag = 0;
+    p_db_block->next_block_tag = 0;
+    p_db_block->created_time = 0;
+    p_db_block->modified_time = 0;
+    p_db_block->deleted = 0;
+    p_db_block->valid_record_num = 0;
+    p_db_block->record_properties_num = 0;
+
+    memset(p_db_block->block_data, 0, FACILEDB_BLOCK_DATA_SIZE);
+}
+
+off_t get_db_block_offset(DB_SET_PROPERTIES_T *p_db_set_properties, uint64_t block_tag)
+{
+    size_t set_properties_size = get_db_set_properties_size(p_db_set_properties);
+    size_t block_size = get_db_block_size();
+
+    return (set_properties_size + ((block_tag - 1) * block_size));
+}
+
+size_t get_db_block_size()
+{
+    DB_BLOCK_T dummy_db_block;
+    size_t attribute_size = sizeof(dummy_db_block.block_tag) + sizeof(dummy_db_block.data_tag) + sizeof(dummy_db_block.prev_block_tag) + sizeof(dummy_db_block.next_block_tag);
+    size_t time_attribute_size = sizeof(dummy_db_block.created_time) + sizeof(dummy_db_block.modified_time);
+    size_t other_attribute_size = sizeof(dummy_db_block.deleted) + sizeof(dummy_db_block.valid_record_num) + sizeof(dummy_db_block.record_properties_num);
+
+    size_t block_data_size = sizeof(dummy_db_block.block_data);
+
+    return (attribute_size + time_attribute_size + other_attribute_size + block_data_size);
+}
+
+void write_db_block(DB_BLOCK_T *p_db_block, DB_SET_INFO_T *p_db_set_info)
+{
+    FILE *p_db_set_file = p_db_set_info->file;
+    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
+    uint64_t block_tag = p_db_block->block_tag;
+    off_t block_offset = get_db_block_offset(p_db_set_properties, block_tag);
+
+    // The appenders write their reserved blocks after the block number.
+    assert(block_tag > 0);
+
+    // write static variables
+#if IS_POSIX_API_SUPPORT
+    int fd = fileno(p_db_set_file);
+
+    // alignment makes sizeof and get_db_block_size() different.
+    if(sizeof(DB_BLOCK_T) == get_db_block_size())
+    {
+        pwrite(fd, p_db_block, sizeof(DB_BLOCK_T), block_offset);
+    }
+    else
+    {
+        pwrite(fd, &(p_db_block->block_tag), sizeof(p_db_block->block_tag), block_offset);
+        block_offset += sizeof(p_db_block->block_tag);
+        pwrite(fd, &(p_db_block->data_tag), sizeof(p_db_block->data_tag), block_offset);
+        block_offset += sizeof(p_db_block->data_tag);
+        pwrite(fd, &(p_db_block->prev_block_tag), sizeof(p_db_block->prev_block_tag), block_offset);
+        block_offset += sizeof(p_db_block->prev_block_tag);
+        pwrite(fd, &(p_db_block->next_block_tag), sizeof(p_db_block->next_block_tag), block_offset);
+        block_offset += sizeof(p_db_block->next_block_tag);
+        pwrite(fd, &(p_db_block->created_time), sizeof(p_db_block->created_time), block_offset);
+        block_offset += sizeof(p_db_block->created_time);
+        pwrite(fd, &(p_db_block->modified_time), sizeof(p_db_block->modified_time), block_offset);
+        block_offset += sizeof(p_db_block->modified_time);
+        pwrite(fd, &(p_db_block->deleted), sizeof(p_db_block->deleted), block_offset);
+        block_offset += sizeof(p_db_block->deleted);
+        pwrite(fd, &(p_db_block->valid_record_num), sizeof(p_db_block->valid_record_num), block_offset);
+        block_offset += sizeof(p_db_block->valid_record_num);
+        pwrite(fd, &(p_db_block->record_properties_num), sizeof(p_db_block->record_properties_num), block_offset);
+        block_offset += sizeof(p_db_block->record_properties_num);
+        pwrite(fd, p_db_block->block_data, sizeof(p_db_block->block_data), block_offset);
+    }
+#else  // IS_POSIX_API_SUPPORT
+    fseek(p_db_set_file, block_offset, SEEK_SET);
+
+    if (sizeof(DB_BLOCK_T) == get_db_block_size())
+    {
+        fwrite(p_db_block, sizeof(DB_BLOCK_T), 1, p_db_set_file);
+    }
+    else
+    {
+        fwrite(&(p_db_block->block_tag), sizeof(p_db_block->block_tag), 1, p_db_set_file);
+        fwrite(&(p_db_block->data_tag), sizeof(p_db_block->data_tag), 1, p_db_set_file);
+        fwrite(&(p_db_block->prev_block_tag), sizeof(p_db_block->prev_block_tag), 1, p_db_set_file);
+        fwrite(&(p_db_block->next_block_tag), sizeof(p_db_block->next_block_tag), 1, p_db_set_file);
+        fwrite(&(p_db_block->created_time), sizeof(p_db_block->created_time), 1, p_db_set_file);
+        fwrite(&(p_db_block->modified_time), sizeof(p_db_block->modified_time), 1, p_db_set_file);
+        fwrite(&(p_db_block->deleted), sizeof(p_db_block->deleted), 1, p_db_set_file);
+        fwrite(&(p_db_block->valid_record_num), sizeof(p_db_block->valid_record_num), 1, p_db_set_file);
+        fwrite(&(p_db_block->record_properties_num), sizeof(p_db_block->record_properties_num), 1, p_db_set_file);
+
+        fwrite(p_db_block->block_data, sizeof(p_db_block->block_data), 1, p_db_set_file);
+    }
+#endif // IS_POSIX_API_SUPPORT
+}
+
+void read_db_block(DB_SET_INFO_T *p_db_set_info, uint64_t block_tag, DB_BLOCK_T *p_db_block)
+{
+    // The readers check the block tags by their snapshots, the block number is changed by the appender meanwhile.
+    assert(block_tag > 0);
+
+    FILE *p_db_set_file = p_db_set_info->file;
+    off_t block_offset = get_db_block_offset(&(p_db_set_info->db_set_properties), block_tag);
+
+    // read static variables
+#if IS_POSIX_API_SUPPORT
+    int fd = fileno(p_db_set_file);
+
+    // Alignment may make sizeof and get_db_block_size() different.
+    if (sizeof(DB_BLOCK_T) == get_db_block_size())
+    {
+        pread(fd, p_db_block, sizeof(DB_BLOCK_T), block_offset);
+    }
+    else
+    {
+        pread(fd, &(p_db_block->block_tag), sizeof(p_db_block->block_tag), block_offset);
+        block_offset += sizeof(p_db_block->block_tag);
+        pread(fd, &(p_db_block->data_tag), sizeof(p_db_block->data_tag), block_offset);
+        block_offset += sizeof(p_db_block->data_tag);
+        pread(fd, &(p_db_block->prev_block_tag), sizeof(p_db_block->prev_block_tag), block_offset);
+        block_offset += sizeof(p_db_block->prev_block_tag);
+        pread(fd, &(p_db_block->next_block_tag), sizeof(p_db_block->next_block_tag), block_offset);
+        block_offset += sizeof(p_db_block->next_block_tag);
+        pread(fd, &(p_db_block->created_time), sizeof(p_db_block->created_time), block_offset);
+        block_offset += sizeof(p_db_block->created_time);
+        pread(fd, &(p_db_block->modified_time), sizeof(p_db_block->modified_time), block_offset);
+        block_offset += sizeof(p_db_block->modified_time);
+        pread(fd, &(p_db_block->deleted), sizeof(p_db_block->deleted), block_offset);
+        block_offset += sizeof(p_db_block->deleted);
+        pread(fd, &(p_db_block->valid_record_num), sizeof(p_db_block->valid_record_num), block_offset);
+        block_offset += sizeof(p_db_block->valid_record_num);
+        pread(fd, &(p_db_block->record_properties_num), sizeof(p_db_block->record_properties_num), block_offset);
+        block_offset += sizeof(p_db_block->record_properties_num);
+        pread(fd, p_db_block->block_data, sizeof(p_db_block->block_data), block_offset);
+    }
+#else // IS_POSIX_API_SUPPORT
+    fseek(p_db_set_file, block_offset, SEEK_SET);
+
+    if (sizeof(DB_BLOCK_T) == get_db_block_size())
+    {
+        fread(p_db_block, sizeof(DB_BLOCK_T), 1, p_db_set_file);
+    }
+    else
+    {
+        fread(&(p_db_block->block_tag), sizeof(p_db_block->block_tag), 1, p_db_set_file);
+        fread(&(p_db_block->data_tag), sizeof(p_db_block->data_tag), 1, p_db_set_file);
+        fread(&(p_db_block->prev_block_tag), sizeof(p_db_block->prev_block_tag), 1, p_db_set_file);
+        fread(&(p_db_block->next_block_tag), sizeof(p_db_block->next_block_tag), 1, p_db_set_file);
+        fread(&(p_db_block->created_time), sizeof(p_db_block->created_time), 1, p_db_set_file);
+        fread(&(p_db_block->modified_time), sizeof(p_db_block->modified_time), 1, p_db_set_file);
+        fread(&(p_db_block->deleted), sizeof(p_db_block->deleted), 1, p_db_set_file);
+        fread(&(p_db_block->valid_record_num), sizeof(p_db_block->valid_record_num), 1, p_db_set_file);
+        fread(&(p_db_block->record_properties_num), sizeof(p_db_block->record_properties_num), 1, p_db_set_file);
+
+        fread(p_db_block->block_data, sizeof(p_db_block->block_data), 1, p_db_set_file);
+    }
+#endif
+}
+
+void read_db_block_attributes(DB_SET_INFO_T *p_db_set_info, uint64_t block_tag, DB_BLOCK_T *p_db_block)
+{
+    // The readers check the block tags by their snapshots.
+    assert(block_tag > 0);
+
+    FILE *p_db_set_file = p_db_set_info->file;
+    off_t block_offset = get_db_block_offset(&(p_db_set_info->db_set_properties), block_tag);
+
+#if IS_POSIX_API_SUPPORT
+    int fd = fileno(p_db_set_file);
+
+    pread(fd, &(p_db_block->block_tag), sizeof(p_db_block->block_tag), block_offset);
+    block_offset += sizeof(p_db_block->block_tag);
+    pread(fd, &(p_db_block->data_tag), sizeof(p_db_block->data_tag), block_offset);
+    block_offset += sizeof(p_db_block->data_tag);
+    pread(fd, &(p_db_block->prev_block_tag), sizeof(p_db_block->prev_block_tag), block_offset);
+    block_offset += sizeof(p_db_block->prev_block_tag);
+    pread(fd, &(p_db_block->next_block_tag), sizeof(p_db_block->next_block_tag), block_offset);
+    block_offset += sizeof(p_db_block->next_block_tag);
+    pread(fd, &(p_db_block->created_time), sizeof(p_db_block->created_time), block_offset);
+    block_offset += sizeof(p_db_block->created_time);
+    pread(fd, &(p_db_block->modified_time), sizeof(p_db_block->modified_time), block_offset);
+    block_offset += sizeof(p_db_block->modified_time);
+    pread(fd, &(p_db_block->deleted), sizeof(p_db_block->deleted), block_offset);
+    block_offset += sizeof(p_db_block->deleted);
+    pread(fd, &(p_db_block->valid_record_num), sizeof(p_db_block->valid_record_num), block_offset);
+    block_offset += sizeof(p_db_block->valid_record_num);
+    pread(fd, &(p_db_block->record_properties_num), sizeof(p_db_block->record_properties_num), block_offset);
+#else  // IS_POSIX_API_SUPPORT
+    fseek(p_db_set_file, block_offset, SEEK_SET);
+
+    fread(&(p_db_block->block_tag), sizeof(p_db_block->block_tag), 1, p_db_set_file);
+    fread(&(p_db_block->data_tag), sizeof(p_db_block->data_tag), 1, p_db_set_file);
+    fread(&(p_db_block->prev_block_tag), sizeof(p_db_block->prev_block_tag), 1, p_db_set_file);
+    fread(&(p_db_block->next_block_tag), sizeof(p_db_block->next_block_tag), 1, p_db_set_file);
+    fread(&(p_db_block->created_time), sizeof(p_db_block->created_time), 1, p_db_set_file);
+    fread(&(p_db_block->modified_time), sizeof(p_db_block->modified_time), 1, p_db_set_file);
+    fread(&(p_db_block->deleted), sizeof(p_db_block->deleted), 1, p_db_set_file);
+    fread(&(p_db_block->valid_record_num), sizeof(p_db_block->valid_record_num), 1, p_db_set_file);
+    fread(&(p_db_block->record_properties_num), sizeof(p_db_block->record_properties_num), 1, p_db_set_file);
+#endif // IS_POSIX_API_SUPPORT
+}
+
+void extract_db_data_info_from_db_blocks_handler_update_time(DB_DATA_INFO_T *p_db_data_info, DB_BLOCK_T *p_db_block)
+{
+    if (p_db_block->created_time > p_db_data_info->created_time)
+    {
+        p_db_data_info->created_time = p_db_block->created_time;
+    }
+
+    if (p_db_block->modified_time > p_db_data_info->modified_time)
+    {
+        p_db_data_info->modified_time = p_db_block->modified_time;
+    }
+}
+
+void extract_db_data_info_from_db_blocks(DB_DATA_INFO_T *p_db_data_info, uint64_t start_block_tag, DB_SET_INFO_T *p_db_set_info)
 {
     DB_BLOCK_T db_block;
     uint32_t record_num = 0;
     DB_RECORD_INFO_T *result = NULL;
-    uint64_t next_block_tag = 0;
     uint8_t *p_block_data = NULL;
     uint8_t *p_block_end_address = NULL;
 
     db_block_init(&db_block);
-    read_db_block(p_db_set_info, block_tag, &db_block);
+    read_db_block(p_db_set_info, start_block_tag, &db_block);
+
+    p_db_data_info->data_tag = db_block.data_tag;
+    p_db_data_info->start_db_block_tag = start_block_tag;
+    extract_db_data_info_from_db_blocks_handler_update_time(p_db_data_info, &db_block);
+    // update record_num at the end of this function.
+    p_db_data_info->deleted = db_block.deleted;
+
     record_num = db_block.valid_record_num;
     result = malloc(record_num * sizeof(DB_RECORD_INFO_T));
-    next_block_tag = db_block.next_block_tag;
     p_block_data = db_block.block_data;
     p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
 
     if (result == NULL)
     {
-        *p_record_num = 0;
-        return NULL;
+        p_db_data_info->record_num = 0;
+        p_db_data_info->p_db_record_info = NULL;
+        return;
     }
 
     for (uint32_t i = 0; i < record_num; i++)
@@ -1961,11 +3248,12 @@ DB_RECORD_INFO_T *extract_db_record_info_from_db_blocks(uint64_t block_tag, DB_S
             if ((p_block_data + get_db_record_properties_size()) > p_block_end_address)
             {
                 // clear the current block and read next block from next_block_tag and update the variables.
+                int next_block_tag = db_block.next_block_tag;
                 assert(next_block_tag != 0);
 
                 db_block_init(&db_block);
                 read_db_block(p_db_set_info, next_block_tag, &db_block);
-                next_block_tag = db_block.next_block_tag;
+                extract_db_data_info_from_db_blocks_handler_update_time(p_db_data_info, &db_block);
                 p_block_data = db_block.block_data;
                 p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
             }
@@ -1995,11 +3283,12 @@ DB_RECORD_INFO_T *extract_db_record_info_from_db_blocks(uint64_t block_tag, DB_S
                     if (forward_size == 0)
                     {
                         // p_block_data reaches the end of the block, load next block and update variables.
+                        int next_block_tag = db_block.next_block_tag;
                         assert(next_block_tag != 0);
 
                         db_block_init(&db_block);
                         read_db_block(p_db_set_info, next_block_tag, &db_block);
-                        next_block_tag = db_block.next_block_tag;
+                        extract_db_data_info_from_db_blocks_handler_update_time(p_db_data_info, &db_block);
                         p_block_data = db_block.block_data;
                         p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
                     }
@@ -2016,11 +3305,12 @@ DB_RECORD_INFO_T *extract_db_record_info_from_db_blocks(uint64_t block_tag, DB_S
                     if (forward_size == 0)
                     {
                         // p_block_data reaches the end of the block, load next block and update variables.
+                        int next_block_tag = db_block.next_block_tag;
                         assert(next_block_tag != 0);
 
                         db_block_init(&db_block);
                         read_db_block(p_db_set_info, next_block_tag, &db_block);
-                        next_block_tag = db_block.next_block_tag;
+                        extract_db_data_info_from_db_blocks_handler_update_time(p_db_data_info, &db_block);
                         p_block_data = db_block.block_data;
                         p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
                     }
@@ -2047,11 +3337,12 @@ DB_RECORD_INFO_T *extract_db_record_info_from_db_blocks(uint64_t block_tag, DB_S
             if (copy_size == 0)
             {
                 // read next block and update variables.
+                int next_block_tag = db_block.next_block_tag;
                 assert(next_block_tag != 0);
 
                 db_block_init(&db_block);
                 read_db_block(p_db_set_info, next_block_tag, &db_block);
-                next_block_tag = db_block.next_block_tag;
+                extract_db_data_info_from_db_blocks_handler_update_time(p_db_data_info, &db_block);
                 p_block_data = db_block.block_data;
                 p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
 
@@ -2074,11 +3365,12 @@ DB_RECORD_INFO_T *extract_db_record_info_from_db_blocks(uint64_t block_tag, DB_S
             if (copy_size == 0)
             {
                 // read next block and update variables.
+                int next_block_tag = db_block.next_block_tag;
                 assert(next_block_tag != 0);
 
                 db_block_init(&db_block);
                 read_db_block(p_db_set_info, next_block_tag, &db_block);
-                next_block_tag = db_block.next_block_tag;
+                extract_db_data_info_from_db_blocks_handler_update_time(p_db_data_info, &db_block);
                 p_block_data = db_block.block_data;
                 p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
             }
@@ -2090,16 +3382,186 @@ DB_RECORD_INFO_T *extract_db_record_info_from_db_blocks(uint64_t block_tag, DB_S
         }
     }
 
-    *p_record_num = record_num;
-    return result;
+    p_db_data_info->p_db_record_info = result;
+    p_db_data_info->record_num = record_num;
 }
 
-void db_record_properties_init(DB_RECORD_PROPERTIES_T *p_db_record_properties)
+// currently, this function only work for unit test.
+DB_RECORD_INFO_T *extract_db_record_info_from_db_blocks(uint64_t block_tag, DB_SET_INFO_T *p_db_set_info, uint32_t *p_record_num)
 {
-    p_db_record_properties->deleted = 0;
-    p_db_record_properties->key_size = 0;
-    p_db_record_properties->value_size = 0;
-    p_db_record_properties->record_value_type = FACILEDB_RECORD_VALUE_TYPE_INVALID;
+    DB_BLOCK_T db_block;
+    uint32_t record_num = 0;
+    DB_RECORD_INFO_T *result = NULL;
+    uint64_t next_block_tag = 0;
+    uint8_t *p_block_data = NULL;
+    uint8_t *p_block_end_address = NULL;
+
+    db_block_init(&db_block);
+    read_db_block(p_db_set_info, block_tag, &db_block);
+    record_num = db_block.valid_record_num;
+    result = malloc(record_num * sizeof(DB_RECORD_INFO_T));
+    next_block_tag = db_block.next_block_tag;
+    p_block_data = db_block.block_data;
+    p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
+
+    if (result == NULL)
+    {
+        *p_record_num = 0;
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < record_num; i++)
+    {
+        bool find_valid_db_record = false;
+        uint32_t remaining_size = 0;
+
+        db_record_info_init(&(result[i]));
+
+        // check if valid record (deleted == false) and reaches to the valid one.
+        while (find_valid_db_record == false)
+        {
+            if ((p_block_data + get_db_record_properties_size()) > p_block_end_address)
+            {
+                // clear the current block and read next block from next_block_tag and update the variables.
+                assert(next_block_tag != 0);
+
+                db_block_init(&db_block);
+                read_db_block(p_db_set_info, next_block_tag, &db_block);
+                next_block_tag = db_block.next_block_tag;
+                p_block_data = db_block.block_data;
+                p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
+            }
+
+            // check if the record deleted or not.
+            if (((DB_RECORD_PROPERTIES_T *)p_block_data)->deleted == 0)
+            {
+                find_valid_db_record = true;
+                break;
+            }
+            else
+            {
+                // record was deleted, bypass it.
+                uint32_t key_size = ((DB_RECORD_PROPERTIES_T *)p_block_data)->key_size;
+                uint32_t value_size = ((DB_RECORD_PROPERTIES_T *)p_block_data)->value_size;
+
+                find_valid_db_record = false;
+                p_block_data += get_db_record_properties_size();
+
+                remaining_size = key_size;
+                while (remaining_size > 0)
+                {
+                    uint32_t remaining_block_size = p_block_end_address - p_block_data;
+                    uint32_t forward_size = (remaining_block_size > remaining_size) ? (remaining_size) : (remaining_block_size);
+
+                    p_block_data += forward_size;
+                    if (forward_size == 0)
+                    {
+                        // p_block_data reaches the end of the block, load next block and update variables.
+                        assert(next_block_tag != 0);
+
+                        db_block_init(&db_block);
+                        read_db_block(p_db_set_info, next_block_tag, &db_block);
+                        next_block_tag = db_block.next_block_tag;
+                        p_block_data = db_block.block_data;
+                        p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
+                    }
+                    remaining_size -= forward_size;
+                }
+
+                remaining_size = value_size;
+                while (remaining_size > 0)
+                {
+                    uint32_t remaining_block_size = p_block_end_address - p_block_data;
+                    uint32_t forward_size = (remaining_block_size > remaining_size) ? (remaining_size) : (remaining_block_size);
+
+                    p_block_data += forward_size;
+                    if (forward_size == 0)
+                    {
+                        // p_block_data reaches the end of the block, load next block and update variables.
+                        assert(next_block_tag != 0);
+
+                        db_block_init(&db_block);
+                        read_db_block(p_db_set_info, next_block_tag, &db_block);
+                        next_block_tag = db_block.next_block_tag;
+                        p_block_data = db_block.block_data;
+                        p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
+                    }
+                    remaining_size -= forward_size;
+                }
+            }
+        }
+        // Setting record properties offset and copy db_record_properties from db_block_data.
+        result[i].db_record_properties_offset = get_db_block_offset(&(p_db_set_info->db_set_properties), db_block.block_tag) + (p_block_data - ((uint8_t *)&db_block));
+        memcpy(&(result[i].db_record_properties), p_block_data, get_db_record_properties_size());
+        p_block_data += get_db_record_properties_size();
+
+        // Copy db_record from the db blocks.
+        allocate_db_record_resources(&(result[i].db_record), result[i].db_record_properties.key_size, result[i].db_record_properties.value_size);
+
+        // copy db_record key from db block data.
+        remaining_size = result[i].db_record_properties.key_size;
+        while (remaining_size > 0)
+        {
+            uint32_t remaining_block_size = p_block_end_address - p_block_data;
+            uint32_t copy_size = (remaining_block_size > remaining_size) ? (remaining_size) : (remaining_block_size);
+            uint8_t *p_key = NULL;
+
+            if (copy_size == 0)
+            {
+                // read next block and update variables.
+                assert(next_block_tag != 0);
+
+                db_block_init(&db_block);
+                read_db_block(p_db_set_info, next_block_tag, &db_block);
+                next_block_tag = db_block.next_block_tag;
+                p_block_data = db_block.block_data;
+                p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
+
+                continue;
+            }
+
+            p_key = result[i].db_record.p_key + result[i].db_record_properties.key_size - remaining_size;
+            memcpy(p_key, p_block_data, copy_size);
+            p_block_data += copy_size;
+            remaining_size -= copy_size;
+        }
+
+        remaining_size = result[i].db_record_properties.value_size;
+        while (remaining_size > 0)
+        {
+            uint32_t remaining_block_size = p_block_end_address - p_block_data;
+            uint32_t copy_size = (remaining_block_size > remaining_size) ? (remaining_size) : (remaining_block_size);
+            uint8_t *p_value = NULL;
+
+            if (copy_size == 0)
+            {
+                // read next block and update variables.
+                assert(next_block_tag != 0);
+
+                db_block_init(&db_block);
+                read_db_block(p_db_set_info, next_block_tag, &db_block);
+                next_block_tag = db_block.next_block_tag;
+                p_block_data = db_block.block_data;
+                p_block_end_address = ((uint8_t *)&(db_block)) + get_db_block_size();
+            }
+
+            p_value = result[i].db_record.p_value + result[i].db_record_properties.value_size - remaining_size;
+            memcpy(p_value, p_block_data, copy_size);
+            p_block_data += copy_size;
+            remaining_size -= copy_size;
+        }
+    }
+
+    *p_record_num = record_num;
+    return result;
+}
+
+void db_record_properties_init(DB_RECORD_PROPERTIES_T *p_db_record_properties)
+{
+    p_db_record_properties->deleted = 0;
+    p_db_record_properties->key_size = 0;
+    p_db_record_properties->value_size = 0;
+    p_db_record_properties->record_value_type = FACILEDB_RECORD_VALUE_TYPE_INVALID;
 }
 
 void copy_db_record_properties(DB_RECORD_PROPERTIES_T *p_dest_db_record_properties, DB_RECORD_PROPERTIES_T *p_src_db_record_properties)
@@ -2181,747 +3643,2509 @@ bool shallow_assign_faciledb_data_to_db_data_info(DB_DATA_INFO_T *p_db_data_info
         return false;
     }
 
-    // assign db_data_info content
-    for (uint32_t i = 0; i < p_faciledb_data->record_num; i++)
+    // assign db_data_info content
+    for (uint32_t i = 0; i < p_faciledb_data->record_num; i++)
+    {
+        shallow_assign_faciledb_record_to_db_record_info(&(p_db_data_info->p_db_record_info[i]), &(p_faciledb_data->p_data_records[i]));
+    }
+
+    return true;
+}
+
+void db_record_init(DB_RECORD_T *p_db_record)
+{
+    p_db_record->p_key = NULL;
+    p_db_record->p_value = NULL;
+}
+
+bool allocate_db_record_resources(DB_RECORD_T *p_db_record, uint32_t key_size, uint32_t value_size)
+{
+    if (p_db_record->p_key || p_db_record->p_value)
+    {
+        free_db_record_resources(p_db_record);
+    }
+
+    p_db_record->p_key = calloc(1, key_size * sizeof(uint8_t));
+    if (p_db_record->p_key == NULL)
+    {
+        return false;
+    }
+
+    p_db_record->p_value = calloc(1, value_size * sizeof(uint8_t));
+    if (p_db_record->p_value == NULL)
+    {
+        free_db_record_resources(p_db_record);
+        return false;
+    }
+
+    return true;
+}
+
+void free_db_record_resources(DB_RECORD_T *p_db_record)
+{
+    if (p_db_record->p_key != NULL)
+    {
+        free(p_db_record->p_key);
+        p_db_record->p_key = NULL;
+    }
+
+    if (p_db_record->p_value != NULL)
+    {
+        free(p_db_record->p_value);
+        p_db_record->p_value = NULL;
+    }
+}
+
+void copy_db_record(DB_RECORD_T *p_dest_db_record, DB_RECORD_T *p_src_db_record, uint32_t key_size, uint32_t value_size)
+{
+    assert(p_dest_db_record->p_key != NULL && p_dest_db_record->p_value != NULL);
+
+    memcpy(p_dest_db_record->p_key, p_src_db_record->p_key, key_size);
+    memcpy(p_dest_db_record->p_value, p_src_db_record->p_value, value_size);
+}
+
+void db_record_info_init(DB_RECORD_INFO_T *p_db_record_info)
+{
+    db_record_properties_init(&(p_db_record_info->db_record_properties));
+    db_record_init(&(p_db_record_info->db_record));
+    p_db_record_info->db_record_properties_offset = 0;
+}
+
+// Setup key_size and value_size before calling this function.
+bool allocate_db_record_info_resources(DB_RECORD_INFO_T *p_db_record_info)
+{
+    uint32_t key_size = p_db_record_info->db_record_properties.key_size;
+    uint32_t value_size = p_db_record_info->db_record_properties.value_size;
+
+    return allocate_db_record_resources(&(p_db_record_info->db_record), key_size, value_size);
+}
+
+void free_db_record_info_resources(DB_RECORD_INFO_T *p_db_record_info)
+{
+    free_db_record_resources(&(p_db_record_info->db_record));
+}
+
+bool faciledb_record_to_db_record_info(FACILEDB_RECORD_T *p_faciledb_record, DB_RECORD_INFO_T *p_db_record_info)
+{
+    DB_RECORD_PROPERTIES_T *p_db_record_properties = &(p_db_record_info->db_record_properties);
+    DB_RECORD_T *p_db_record = &(p_db_record_info->db_record);
+
+    p_db_record_properties->deleted = 0;
+    p_db_record_properties->key_size = p_faciledb_record->key_size;
+    p_db_record_properties->value_size = p_faciledb_record->value_size;
+    p_db_record_properties->record_value_type = p_faciledb_record->record_value_type;
+
+    allocate_db_record_resources(p_db_record, p_db_record_properties->key_size, p_db_record_properties->value_size);
+    memcpy(p_db_record->p_key, p_faciledb_record->p_key, p_db_record_properties->key_size);
+    memcpy(p_db_record->p_value, p_faciledb_record->p_value, p_db_record_properties->value_size);
+
+    return true;
+}
+
+// shallow assign values and pointers, would not allocate space for dynamic resources.
+void shallow_assign_faciledb_record_to_db_record_info(DB_RECORD_INFO_T *p_db_record_info, FACILEDB_RECORD_T *p_faciledb_record)
+{
+    DB_RECORD_PROPERTIES_T *p_db_record_properties = &(p_db_record_info->db_record_properties);
+    DB_RECORD_T *p_db_record = &(p_db_record_info->db_record);
+
+    p_db_record_properties->deleted = 0;
+    p_db_record_properties->key_size = p_faciledb_record->key_size;
+    p_db_record_properties->value_size = p_faciledb_record->value_size;
+    p_db_record_properties->record_value_type = p_faciledb_record->record_value_type;
+
+    p_db_record->p_key = p_faciledb_record->p_key;
+    p_db_record->p_value = p_faciledb_record->p_value;
+
+    p_db_record_info->db_record_properties_offset = 0; // invalid
+}
+
+// shallow assgin values and pointers, would not allocate memory for dynamic resources.
+void shallow_assign_db_record_info_to_faciledb_record(FACILEDB_RECORD_T *p_faciledb_record, DB_RECORD_INFO_T *p_db_record_info)
+{
+    p_faciledb_record->key_size = p_db_record_info->db_record_properties.key_size;
+    p_faciledb_record->value_size = p_db_record_info->db_record_properties.value_size;
+    p_faciledb_record->record_value_type = p_db_record_info->db_record_properties.record_value_type;
+
+    p_faciledb_record->p_key = p_db_record_info->db_record.p_key;
+    p_faciledb_record->p_value = p_db_record_info->db_record.p_value;
+}
+
+// p_db_data_info is a pointer to a DB_DATA_INFO_T, not a pointer to an array.
+// The data is written into the reserved blocks, whose number is counted by get_db_data_block_num().
+// return value: the number of inserted data.
+uint32_t insert_db_data(DB_SET_INFO_T *p_db_set_info, DB_DATA_INFO_T *p_db_data_info, DB_BLOCK_RESERVATION_T *p_db_block_reservation)
+{
+    DB_BLOCK_T new_db_block;
+    uint8_t *p_db_block_write = new_db_block.block_data;
+    uint8_t *p_db_block_end = new_db_block.block_data + FACILEDB_BLOCK_DATA_SIZE;
+    size_t db_record_properties_size = get_db_record_properties_size();
+    uint64_t data_tag = p_db_block_reservation->data_tag;
+    uint64_t first_db_block_tag = 0;
+    uint64_t last_db_block_tag = 0;
+
+    db_block_init(&new_db_block);
+    // Set first block prev/next block tag as 0.
+    insert_db_data_handler_assign_db_block_value(&new_db_block, 0, p_db_data_info->record_num, data_tag);
+    for (uint32_t i = 0; i < (p_db_data_info->record_num); i++)
+    {
+        uint32_t remaining_size = 0;
+        DB_RECORD_INFO_T *p_current_db_record_info = &p_db_data_info->p_db_record_info[i];
+
+        if ((p_db_block_write + db_record_properties_size) > p_db_block_end)
+        {
+            // new_db_block is full, write new_db_block into file.
+            uint64_t write_block_tag = insert_db_data_handler_write_new_db_block(&new_db_block, p_db_set_info, p_db_block_reservation);
+            if (first_db_block_tag == 0)
+            {
+                // first block tag is not set, assign it.
+                first_db_block_tag = write_block_tag;
+            }
+
+            // Clear and reassgin the new_block and local variables for new data.
+            db_block_init(&new_db_block);
+            insert_db_data_handler_assign_db_block_value(&new_db_block, write_block_tag, p_db_data_info->record_num, data_tag);
+            // update local variables.
+            p_db_block_write = new_db_block.block_data;
+            p_db_block_end = new_db_block.block_data + FACILEDB_BLOCK_DATA_SIZE;
+        }
+
+        // copy record properties to block data.
+        memcpy(p_db_block_write, &(p_current_db_record_info->db_record_properties), db_record_properties_size);
+        new_db_block.record_properties_num++;
+        p_db_block_write += db_record_properties_size;
+
+        // copy record key to block data.
+        remaining_size = p_current_db_record_info->db_record_properties.key_size;
+        while (remaining_size > 0)
+        {
+            assert(p_db_block_end >= p_db_block_write);
+
+            uint32_t remaining_block_size = (p_db_block_end - p_db_block_write);
+            uint32_t copy_size = (remaining_block_size < remaining_size) ? (remaining_block_size) : (remaining_size);
+            uint8_t *p_key = NULL;
+
+            if (copy_size == 0)
+            {
+                // Current db_block is full, write db_block into file.
+                uint64_t write_block_tag = insert_db_data_handler_write_new_db_block(&new_db_block, p_db_set_info, p_db_block_reservation);
+                if (first_db_block_tag == 0)
+                {
+                    first_db_block_tag = write_block_tag;
+                }
+
+                // Clear and reassign the current block data and local variables for new data.
+                db_block_init(&new_db_block);
+                insert_db_data_handler_assign_db_block_value(&new_db_block, write_block_tag, p_db_data_info->record_num, data_tag);
+                p_db_block_write = new_db_block.block_data;
+                p_db_block_end = new_db_block.block_data + FACILEDB_BLOCK_DATA_SIZE;
+
+                continue;
+            }
+
+            p_key = p_current_db_record_info->db_record.p_key + p_current_db_record_info->db_record_properties.key_size - remaining_size;
+            memcpy(p_db_block_write, p_key, copy_size);
+            p_db_block_write += copy_size;
+            remaining_size -= copy_size;
+        }
+
+        // copy record value to block data
+        remaining_size = p_current_db_record_info->db_record_properties.value_size;
+        while (remaining_size > 0)
+        {
+            assert(p_db_block_end >= p_db_block_write);
+
+            uint32_t remaining_block_size = p_db_block_end - p_db_block_write;
+            uint32_t copy_size = (remaining_block_size < remaining_size) ? (remaining_block_size) : (remaining_size);
+            uint8_t *p_value = NULL;
+
+            if (copy_size == 0)
+            {
+                // block is full, write into file and clear the current block and pointer for new data.
+                uint64_t write_block_tag = insert_db_data_handler_write_new_db_block(&new_db_block, p_db_set_info, p_db_block_reservation);
+                if (first_db_block_tag == 0)
+                {
+                    first_db_block_tag = write_block_tag;
+                }
+
+                // Clear and reassign the current block data and local variables for new data.
+                db_block_init(&new_db_block);
+                insert_db_data_handler_assign_db_block_value(&new_db_block, write_block_tag, p_db_data_info->record_num, data_tag);
+                // update local variables / pointers
+                p_db_block_write = new_db_block.block_data;
+                p_db_block_end = new_db_block.block_data + FACILEDB_BLOCK_DATA_SIZE;
+
+                continue;
+            }
+
+            p_value = p_current_db_record_info->db_record.p_value + p_current_db_record_info->db_record_properties.value_size - remaining_size;
+            memcpy(p_db_block_write, p_value, copy_size);
+            p_db_block_write += copy_size;
+            remaining_size -= copy_size;
+        }
+    }
+
+    // write the last db_block
+    last_db_block_tag = insert_db_data_handler_write_new_db_block(&new_db_block, p_db_set_info, p_db_block_reservation);
+    if (first_db_block_tag == 0)
+    {
+        first_db_block_tag = last_db_block_tag;
+    }
+
+    // The next block tags are assigned by the reserved blocks.
+    assert(last_db_block_tag == p_db_block_reservation->last_block_tag);
+
+#if ENABLE_DB_INDEX
+    // insert index if existed
+    for (uint32_t i = 0; i < (p_db_data_info->record_num); i++)
+    {
+        DB_RECORD_INFO_T *p_current_db_record_info = &p_db_data_info->p_db_record_info[i];
+        DB_INDEX_PAYLOAD_T db_index_payload = {
+            .data_tag = data_tag,
+            .start_db_block_tag = first_db_block_tag};
+
+        // If p_key index has been created, insert new index element.
+        insert_db_record_index(p_db_set_info, p_db_data_info, p_current_db_record_info, &db_index_payload);
+    }
+
+    // insert composite indexes whose first key is in the data
+    DB_INDEX_PAYLOAD_T db_index_payload = {
+        .data_tag = data_tag,
+        .start_db_block_tag = first_db_block_tag};
+    update_db_composite_record_indexes(p_db_set_info, p_db_data_info, &db_index_payload);
+#endif
+
+    // free db block resources if needed.
+    // currently there is no dynamic resources in db block structure.
+
+    // return the number of inserted data.
+    return 1;
+}
+
+// Return the number of blocks written by insert_db_data(), the record properties are not split into two blocks.
+uint64_t get_db_data_block_num(DB_DATA_INFO_T *p_db_data_info)
+{
+    size_t db_record_properties_size = get_db_record_properties_size();
+    uint64_t block_num = 1;
+    size_t used_size = 0;
+
+    for (uint32_t i = 0; i < (p_db_data_info->record_num); i++)
+    {
+        DB_RECORD_PROPERTIES_T *p_db_record_properties = &(p_db_data_info->p_db_record_info[i].db_record_properties);
+        uint32_t sizes[2] = {p_db_record_properties->key_size, p_db_record_properties->value_size};
+
+        if ((used_size + db_record_properties_size) > FACILEDB_BLOCK_DATA_SIZE)
+        {
+            block_num++;
+            used_size = 0;
+        }
+        used_size += db_record_properties_size;
+
+        // The key and the value are split, a full block is written before the next part.
+        for (uint32_t j = 0; j < 2; j++)
+        {
+            uint32_t remaining_size = sizes[j];
+
+            while (remaining_size > 0)
+            {
+                size_t copy_size = FACILEDB_BLOCK_DATA_SIZE - used_size;
+
+                if (copy_size == 0)
+                {
+                    block_num++;
+                    used_size = 0;
+                    continue;
+                }
+
+                copy_size = (copy_size < remaining_size) ? copy_size : remaining_size;
+                used_size += copy_size;
+                remaining_size -= copy_size;
+            }
+        }
+    }
+
+    return block_num;
+}
+
+// return value: new block_tag, the next reserved block.
+uint64_t insert_db_data_handler_write_new_db_block(DB_BLOCK_T *p_db_block, DB_SET_INFO_T *p_db_set_info, DB_BLOCK_RESERVATION_T *p_db_block_reservation)
+{
+    uint64_t block_tag = p_db_block_reservation->next_block_tag++;
+    uint64_t current_time = 0;
+
+    assert(block_tag <= p_db_block_reservation->last_block_tag);
+    p_db_block->block_tag = block_tag;
+    // The reserved blocks are contiguous, the next block is known before it's written.
+    p_db_block->next_block_tag = (block_tag < p_db_block_reservation->last_block_tag) ? (block_tag + 1) : 0;
+
+    current_time = (uint64_t)get_current_time();
+    p_db_block->created_time = current_time;
+    p_db_block->modified_time = current_time;
+
+    write_db_block(p_db_block, p_db_set_info);
+
+    return block_tag;
+}
+
+void insert_db_data_handler_assign_db_block_value(DB_BLOCK_T *p_db_block, uint64_t prev_block_tag, uint32_t valid_record_num, uint64_t data_tag)
+{
+    p_db_block->data_tag = data_tag;
+    p_db_block->prev_block_tag = prev_block_tag;
+    p_db_block->next_block_tag = 0;
+    p_db_block->deleted = 0;
+    p_db_block->record_properties_num = 0;
+    p_db_block->valid_record_num = valid_record_num;
+}
+
+// return value: DB_DATA_INFO_T array whose length is *p_result_db_data_info_num
+DB_DATA_INFO_T *search_db_data(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot, DB_RECORD_INFO_T *p_target_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E compare_type, uint32_t *p_result_db_data_info_num)
+{
+    // The equal search chooses among the indexes and the sequential search by the estimated cost.
+    if (compare_type == FACILEDB_RECORD_VALUE_TYPE_COMPARE_EQUAL)
+    {
+        return search_db_data_equal_records(p_db_set_info, p_db_set_snapshot, p_target_db_record_info, 1, p_result_db_data_info_num);
+    }
+
+#if ENABLE_DB_INDEX
+    // check if index existed in the catalog and call search_db_data_indexed.
+    DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry = query_db_index_catalog_entry(p_db_set_info, p_target_db_record_info->db_record.p_key, p_target_db_record_info->db_record_properties.key_size);
+    if (get_db_existing_index_id_type(p_db_index_catalog_entry, p_target_db_record_info->db_record_properties.record_value_type) != INDEX_ID_TYPE_INVALID)
+    {
+        return search_db_data_indexed(p_db_set_info, p_db_set_snapshot, p_target_db_record_info, compare_type, p_result_db_data_info_num, false);
+    }
+#endif
+    // General sequential search
+    return search_db_data_sequential(p_db_set_info, p_db_set_snapshot, p_target_db_record_info, compare_type, p_result_db_data_info_num);
+}
+
+// General sequential search
+DB_DATA_INFO_T *search_db_data_sequential(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot, DB_RECORD_INFO_T *p_target_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E compare_type, uint32_t *p_result_db_data_info_num)
+{
+    uint64_t block_num = p_db_set_snapshot->block_num;
+
+    void *p_target_key = p_target_db_record_info->db_record.p_key;
+    uint32_t target_key_size = p_target_db_record_info->db_record_properties.key_size;
+    void *p_target_value = p_target_db_record_info->db_record.p_value;
+    FACILEDB_RECORD_VALUE_TYPE_E target_value_type = p_target_db_record_info->db_record_properties.record_value_type;
+
+    DB_DATA_INFO_T *p_result_db_data_infos = malloc(DB_SEARCH_DATA_INFO_BUFFER_LEN * sizeof(DB_DATA_INFO_T));
+    uint32_t result_db_data_infos_buffer_len = DB_SEARCH_DATA_INFO_BUFFER_LEN;
+    uint32_t result_db_data_info_num = 0;
+
+    if (p_result_db_data_infos == NULL)
+    {
+        *p_result_db_data_info_num = 0;
+        return NULL;
+    }
+
+    for (uint64_t block_tag = 1; block_tag <= block_num; block_tag++)
+    {
+        DB_DATA_INFO_T db_data_info;
+        DB_BLOCK_T db_block;
+        bool record_match = false;
+
+        db_data_info_init(&db_data_info);
+        db_block_init(&db_block);
+
+        // read attribute only for checking delete flag and first block flag.
+        read_db_block_attributes(p_db_set_info, block_tag, &db_block);
+
+        if (is_db_block_visible(p_db_set_snapshot, block_tag, db_block.deleted) == false || db_block.prev_block_tag != 0)
+        {
+            continue;
+        }
+
+        // Read the whole block and next blocks if they exists. The buffers will be allocated, and the record content will be copied into the record_info
+        extract_db_data_info_from_db_blocks(&db_data_info, block_tag, p_db_set_info);
+
+        // Search if the target record matched or not.
+        for (uint32_t record_idx = 0; record_idx < db_data_info.record_num; record_idx++)
+        {
+            if (target_key_size == db_data_info.p_db_record_info[record_idx].db_record_properties.key_size &&
+                memcmp(db_data_info.p_db_record_info[record_idx].db_record.p_key, p_target_key, target_key_size) == 0 &&
+                target_value_type == db_data_info.p_db_record_info[record_idx].db_record_properties.record_value_type &&
+                // value size comparison doesn't need (?)
+                (compare_type == FACILEDB_RECORD_VALUE_TYPE_COMPARE_ANY || Faciledb_Record_Value_Type_Compare(target_value_type, db_data_info.p_db_record_info[record_idx].db_record.p_value, p_target_value) == compare_type))
+            {
+                record_match = true;
+                break;
+            }
+        }
+
+        // Copy the matched key and value to p_result_db_data_infos array.
+        if (record_match)
+        {
+            // Check if buffer length enough to store new matched data.
+            if (result_db_data_info_num == result_db_data_infos_buffer_len)
+            {
+                DB_DATA_INFO_T *tmp = NULL;
+
+                // TODO: buffer size optimization
+                result_db_data_infos_buffer_len *= 2;
+                tmp = realloc(p_result_db_data_infos, result_db_data_infos_buffer_len * sizeof(DB_DATA_INFO_T));
+                if (tmp == NULL)
+                {
+                    // Not enough memory
+                    // Return current results even if there are more matches data.
+                    // TODO: error handling
+                    break;
+                }
+                p_result_db_data_infos = tmp;
+            }
+
+            db_data_info_init(&(p_result_db_data_infos[result_db_data_info_num]));
+            shallow_copy_db_data_info(&(p_result_db_data_infos[result_db_data_info_num]), &db_data_info);
+            result_db_data_info_num++;
+
+            // Do not free db_data_info here, because the dynamic resources are still used in p_result_db_data_infos.
+        }
+        else
+        {
+            free_db_data_info_resources(&db_data_info);
+        }
+    }
+
+    *p_result_db_data_info_num = result_db_data_info_num;
+    return p_result_db_data_infos;
+}
+
+void delete_db_data_handler_write_delete_flag(DB_SET_INFO_T *p_db_set_info, uint64_t db_block_tag, uint32_t deleted)
+{
+    FILE *p_db_set_file = p_db_set_info->file;
+    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
+    off_t delete_flag_offset = get_db_block_offset(p_db_set_properties, db_block_tag) + offsetof(DB_BLOCK_T, deleted);
+    uint64_t current_time = (uint64_t)get_current_time();
+    off_t modified_time_offset = get_db_block_offset(p_db_set_properties, db_block_tag) + offsetof(DB_BLOCK_T, modified_time);
+
+#if IS_POSIX_API_SUPPORT
+    int fd = fileno(p_db_set_file);
+
+    // write delete flag
+    pwrite(fd, &deleted, sizeof(deleted), delete_flag_offset);
+    // write modified time
+    pwrite(fd, &current_time, sizeof(current_time), modified_time_offset);
+#else  // IS_POSIX_API_SUPPORT
+    fseek(p_db_set_file, delete_flag_offset, SEEK_SET);
+    fwrite(&deleted, sizeof(deleted), 1, p_db_set_file);
+
+    fseek(p_db_set_file, modified_time_offset, SEEK_SET);
+    fwrite(&current_time, sizeof(current_time), 1, p_db_set_file);
+#endif // IS_POSIX_API_SUPPORT
+}
+
+// The deleted flags are the new delete sequence, the readers whose snapshots are taken before it still see the data.
+// The delete sequence is written into the header by the caller after the deleted flags.
+void delete_db_data(DB_SET_INFO_T *p_db_set_info, DB_DATA_INFO_T *p_db_data_info, uint32_t db_data_num)
+{
+    DB_BLOCK_T db_block;
+    uint64_t block_tag = 0;
+    uint32_t delete_sequence = 0;
+    db_block_init(&db_block);
+
+    if (db_data_num > 0)
+    {
+        delete_sequence = ++(p_db_set_info->db_set_properties.delete_sequence);
+    }
+
+    for (uint32_t i = 0; i < db_data_num; i++)
+    {
+        block_tag = p_db_data_info[i].start_db_block_tag;
+
+        while (block_tag != 0)
+        {
+            read_db_block(p_db_set_info, block_tag, &db_block);
+            delete_db_data_handler_write_delete_flag(p_db_set_info, db_block.block_tag, delete_sequence);
+            // continue to the next block.
+            block_tag = db_block.next_block_tag;
+        }
+
+#if ENABLE_DB_INDEX
+        // The index elements are kept for the snapshots taken before the delete, the indexed searches check the deleted flags of the blocks.
+        for (uint32_t j = 0; j < p_db_data_info[i].record_num; j++)
+        {
+            delete_db_record_covering_entry(p_db_set_info, &(p_db_data_info[i].p_db_record_info[j]), p_db_data_info[i].data_tag, delete_sequence);
+        }
+#endif
+    }
+}
+
+// Search the data matching all the target records by the plan of the least estimated cost, see plan_db_search_equal_records().
+// return value: an array of DB_DATA_INFO_T, whose length is *p_result_db_data_info_num.
+DB_DATA_INFO_T *search_db_data_equal_records(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot, DB_RECORD_INFO_T *p_target_db_record_infos, uint32_t target_num, uint32_t *p_result_db_data_info_num)
+{
+    DB_DATA_INFO_T *p_db_data_infos = NULL;
+    uint32_t db_data_info_num = 0, match_num = 0;
+    DB_SEARCH_PLAN_T db_search_plan;
+    // The target record searched by the plan, the other target records are compared with the results.
+    DB_RECORD_INFO_T *p_planned_target_db_record_info = NULL;
+
+    plan_db_search_equal_records(p_db_set_info, p_db_set_snapshot, p_target_db_record_infos, target_num, &db_search_plan);
+    p_planned_target_db_record_info = &(p_target_db_record_infos[db_search_plan.faciledb_search_plan.record_position]);
+
+#if ENABLE_DB_INDEX
+    if (db_search_plan.faciledb_search_plan.search_plan == FACILEDB_SEARCH_PLAN_COMPOSITE)
+    {
+        return search_db_data_composite(p_db_set_info, p_db_set_snapshot, db_search_plan.p_db_index_catalog_entry, p_target_db_record_infos, target_num, p_result_db_data_info_num);
+    }
+
+    if (db_search_plan.faciledb_search_plan.search_plan == FACILEDB_SEARCH_PLAN_INDEXED)
+    {
+        p_db_data_infos = search_db_data_indexed(p_db_set_info, p_db_set_snapshot, p_planned_target_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_EQUAL, &db_data_info_num, false);
+    }
+    else
+#endif
+    {
+        p_db_data_infos = search_db_data_sequential(p_db_set_info, p_db_set_snapshot, p_planned_target_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_EQUAL, &db_data_info_num);
+    }
+
+    for (uint32_t i = 0; i < db_data_info_num; i++)
+    {
+        if (is_db_data_matched(&(p_db_data_infos[i]), p_target_db_record_infos, target_num))
+        {
+            shallow_copy_db_data_info(&(p_db_data_infos[match_num]), &(p_db_data_infos[i]));
+            match_num++;
+        }
+        else
+        {
+            free_db_data_info_resources(&(p_db_data_infos[i]));
+            free(p_db_data_infos[i].p_db_record_info);
+        }
+    }
+
+    *p_result_db_data_info_num = match_num;
+    return p_db_data_infos;
+}
+
+// Choose the plan of searching the data matching all the target records by the estimated cost.
+// The sequential search reads every block in order, the index plans read the estimated data at random.
+void plan_db_search_equal_records(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot, DB_RECORD_INFO_T *p_target_db_record_infos, uint32_t target_num, DB_SEARCH_PLAN_T *p_db_search_plan)
+{
+    FACILEDB_SEARCH_PLAN_T *p_faciledb_search_plan = &(p_db_search_plan->faciledb_search_plan);
+    uint64_t block_num = p_db_set_snapshot->block_num;
+    uint64_t data_num = p_db_set_snapshot->valid_record_num;
+
+    p_faciledb_search_plan->search_plan = FACILEDB_SEARCH_PLAN_SEQUENTIAL;
+    p_faciledb_search_plan->record_position = 0;
+    p_faciledb_search_plan->estimated_data_num = data_num;
+    p_faciledb_search_plan->sequential_cost = block_num;
+    p_faciledb_search_plan->estimated_cost = block_num;
+
+#if ENABLE_DB_INDEX
+    uint64_t random_block_cost = 0;
+    uint64_t data_block_num = 0, data_cost = 0;
+    uint32_t leading_column_num = 0;
+    DB_INDEX_CATALOG_ENTRY_T *p_db_composite_index_catalog_entry = NULL;
+
+    p_db_search_plan->p_db_index_catalog_entry = NULL;
+
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_lock(&db_search_plan_mutex);
+#endif
+    random_block_cost = db_search_plan_random_block_cost;
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_unlock(&db_search_plan_mutex);
+#endif
+
+    // A data found by an index reads its first block at random, then its blocks again to extract the records.
+    data_block_num = (data_num > 0) ? ((block_num + data_num - 1) / data_num) : (1);
+    data_cost = random_block_cost * (1 + data_block_num);
+
+    p_db_composite_index_catalog_entry = query_db_composite_index_catalog_entry(p_db_set_info, p_target_db_record_infos, target_num, &leading_column_num);
+    if (leading_column_num > 0)
+    {
+        uint64_t estimated_data_num = estimate_db_composite_data_num(p_db_set_info, p_db_composite_index_catalog_entry, p_target_db_record_infos, target_num);
+
+        if (consider_db_search_plan(p_db_search_plan, FACILEDB_SEARCH_PLAN_COMPOSITE, 0, estimated_data_num, DB_SEARCH_PLAN_INDEX_PROBE_COST + estimated_data_num * data_cost))
+        {
+            p_db_search_plan->p_db_index_catalog_entry = p_db_composite_index_catalog_entry;
+        }
+    }
+
+    for (uint32_t i = 0; i < target_num; i++)
+    {
+        DB_RECORD_INFO_T *p_target_db_record_info = &(p_target_db_record_infos[i]);
+        DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry = query_db_index_catalog_entry(p_db_set_info, p_target_db_record_info->db_record.p_key, p_target_db_record_info->db_record_properties.key_size);
+        INDEX_ID_TYPE_E index_id_type = get_db_existing_index_id_type(p_db_index_catalog_entry, p_target_db_record_info->db_record_properties.record_value_type);
+        bool is_covered = false;
+        uint64_t estimated_data_num = 0;
+
+        if (index_id_type == INDEX_ID_TYPE_INVALID)
+        {
+            continue;
+        }
+
+        // The covering entries of a fully covering index are read instead of the blocks.
+        estimated_data_num = estimate_db_indexed_data_num(p_db_set_info, p_db_index_catalog_entry, p_target_db_record_info, index_id_type, &is_covered);
+        consider_db_search_plan(p_db_search_plan, FACILEDB_SEARCH_PLAN_INDEXED, i, estimated_data_num,
+                                DB_SEARCH_PLAN_INDEX_PROBE_COST + estimated_data_num * (is_covered ? random_block_cost : data_cost));
+    }
+#endif
+}
+
+// Take the plan if it costs less than the current plan of p_db_search_plan.
+bool consider_db_search_plan(DB_SEARCH_PLAN_T *p_db_search_plan, FACILEDB_SEARCH_PLAN_E search_plan, uint32_t record_position, uint64_t estimated_data_num, uint64_t estimated_cost)
+{
+    FACILEDB_SEARCH_PLAN_T *p_faciledb_search_plan = &(p_db_search_plan->faciledb_search_plan);
+
+    if (estimated_cost >= p_faciledb_search_plan->estimated_cost)
+    {
+        return false;
+    }
+
+    p_faciledb_search_plan->search_plan = search_plan;
+    p_faciledb_search_plan->record_position = record_position;
+    p_faciledb_search_plan->estimated_data_num = estimated_data_num;
+    p_faciledb_search_plan->estimated_cost = estimated_cost;
+    return true;
+}
+
+// Return true if the data has a record equal to each target record.
+bool is_db_data_matched(DB_DATA_INFO_T *p_db_data_info, DB_RECORD_INFO_T *p_target_db_record_infos, uint32_t target_num)
+{
+    for (uint32_t i = 0; i < target_num; i++)
+    {
+        DB_RECORD_INFO_T *p_target_db_record_info = &(p_target_db_record_infos[i]);
+        bool record_match = false;
+
+        for (uint32_t record_idx = 0; (record_match == false) && (record_idx < p_db_data_info->record_num); record_idx++)
+        {
+            DB_RECORD_INFO_T *p_db_record_info = &(p_db_data_info->p_db_record_info[record_idx]);
+
+            record_match = (p_target_db_record_info->db_record_properties.key_size == p_db_record_info->db_record_properties.key_size) &&
+                           (memcmp(p_db_record_info->db_record.p_key, p_target_db_record_info->db_record.p_key, p_target_db_record_info->db_record_properties.key_size) == 0) &&
+                           (p_target_db_record_info->db_record_properties.record_value_type == p_db_record_info->db_record_properties.record_value_type) &&
+                           (Faciledb_Record_Value_Type_Compare(p_target_db_record_info->db_record_properties.record_value_type, p_db_record_info->db_record.p_value, p_target_db_record_info->db_record.p_value) == FACILEDB_RECORD_VALUE_TYPE_COMPARE_EQUAL);
+        }
+
+        if (record_match == false)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+#if ENABLE_DB_INDEX
+bool FacileDB_Api_Make_Record_Index(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_record)
+{
+    DB_SET_INFO_T *p_db_set_info = NULL;
+    DB_RECORD_INFO_T target_db_record;
+    uint32_t result_data_num = 0;
+
+    if (p_faciledb_record == NULL)
+    {
+        // invalid input
+        return false;
+    }
+
+    if (enter_db_context_request() == false)
+    {
+        // db context is not ready
+        return false;
+    }
+
+    p_db_set_info = load_and_lock_db_set_info(p_db_set_name);
+    if (p_db_set_info == NULL)
+    {
+        leave_db_context_request();
+        return false;
+    }
+
+    db_record_info_init(&target_db_record);
+    shallow_assign_faciledb_record_to_db_record_info(&target_db_record, p_faciledb_record);
+
+    // The index catalog of the set is written under the write lock of the set.
+    db_set_info_sync_write_wait(p_db_set_info);
+    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_WRITING);
+    db_set_info_file_lock_write(p_db_set_info);
+    unlock_db_set_info_sync(p_db_set_info);
+
+    result_data_num = make_db_record_index(p_db_set_info, &target_db_record, NULL);
+
+    lock_db_set_info_sync(p_db_set_info);
+    db_set_info_file_unlock_write(p_db_set_info);
+    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READY);
+    db_set_info_sync_write_unblock(p_db_set_info);
+    unlock_db_set_info_sync(p_db_set_info);
+    leave_db_context_request();
+
+    if (result_data_num > 0)
+    {
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+bool FacileDB_Api_Make_Covering_Record_Index(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_record, FACILEDB_RECORD_T *p_covered_records, uint32_t covered_record_num)
+{
+    DB_SET_INFO_T *p_db_set_info = NULL;
+    DB_RECORD_INFO_T target_db_record;
+    DB_COVERING_PROPERTIES_T db_covering_properties;
+    uint32_t result_data_num = 0;
+
+    if ((p_faciledb_record == NULL) || ((p_covered_records == NULL) && (covered_record_num > 0)))
+    {
+        // invalid input
+        return false;
+    }
+
+    db_covering_properties_init(&db_covering_properties);
+    if (set_db_covering_properties(&db_covering_properties, p_covered_records, covered_record_num) == false)
+    {
+        return false;
+    }
+
+    if (enter_db_context_request() == false)
+    {
+        // db context is not ready
+        free_db_covering_properties_resources(&db_covering_properties);
+        return false;
+    }
+
+    p_db_set_info = load_and_lock_db_set_info(p_db_set_name);
+    if (p_db_set_info == NULL)
+    {
+        leave_db_context_request();
+        free_db_covering_properties_resources(&db_covering_properties);
+        return false;
+    }
+
+    db_record_info_init(&target_db_record);
+    shallow_assign_faciledb_record_to_db_record_info(&target_db_record, p_faciledb_record);
+
+    // The covering file and the index catalog are written under the write lock of the set, the same as the insertion and deletion.
+    db_set_info_sync_write_wait(p_db_set_info);
+    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_WRITING);
+    db_set_info_file_lock_write(p_db_set_info);
+    unlock_db_set_info_sync(p_db_set_info);
+
+    result_data_num = make_db_record_index(p_db_set_info, &target_db_record, &db_covering_properties);
+
+    lock_db_set_info_sync(p_db_set_info);
+    db_set_info_file_unlock_write(p_db_set_info);
+    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READY);
+    db_set_info_sync_write_unblock(p_db_set_info);
+    unlock_db_set_info_sync(p_db_set_info);
+    leave_db_context_request();
+
+    free_db_covering_properties_resources(&db_covering_properties);
+
+    return (result_data_num > 0);
+}
+
+bool FacileDB_Api_Make_Composite_Record_Index(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_records, uint32_t record_num)
+{
+    DB_SET_INFO_T *p_db_set_info = NULL;
+    DB_RECORD_INFO_T target_db_records[DB_COMPOSITE_INDEX_MAX_COLUMN_NUM];
+    uint32_t result_data_num = 0;
+
+    if ((p_faciledb_records == NULL) || (record_num < 2) || (record_num > DB_COMPOSITE_INDEX_MAX_COLUMN_NUM))
+    {
+        // invalid input
+        return false;
+    }
+
+    for (uint32_t i = 0; i < record_num; i++)
+    {
+        if ((get_db_composite_column_index_id_type(p_faciledb_records[i].record_value_type) == INDEX_ID_TYPE_INVALID) ||
+            (p_faciledb_records[i].p_key == NULL) || (strnlen((char *)p_faciledb_records[i].p_key, p_faciledb_records[i].key_size) == 0))
+        {
+            return false;
+        }
+        db_record_info_init(&(target_db_records[i]));
+        shallow_assign_faciledb_record_to_db_record_info(&(target_db_records[i]), &(p_faciledb_records[i]));
+    }
+
+    if (enter_db_context_request() == false)
+    {
+        // db context is not ready
+        return false;
+    }
+
+    p_db_set_info = load_and_lock_db_set_info(p_db_set_name);
+    if (p_db_set_info == NULL)
+    {
+        leave_db_context_request();
+        return false;
+    }
+
+    // The index catalog of the set is written under the write lock of the set.
+    db_set_info_sync_write_wait(p_db_set_info);
+    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_WRITING);
+    db_set_info_file_lock_write(p_db_set_info);
+    unlock_db_set_info_sync(p_db_set_info);
+
+    result_data_num = make_db_composite_record_index(p_db_set_info, target_db_records, record_num);
+
+    lock_db_set_info_sync(p_db_set_info);
+    db_set_info_file_unlock_write(p_db_set_info);
+    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READY);
+    db_set_info_sync_write_unblock(p_db_set_info);
+    unlock_db_set_info_sync(p_db_set_info);
+    leave_db_context_request();
+
+    return (result_data_num > 0);
+}
+
+// This function must be called after setting db_directory_path.
+bool get_db_index_directory_path(char *p_db_index_directory_path)
+{
+    const char index_directory_suffix[] = "index/";
+
+    if ((strlen(db_directory_path) + strlen(index_directory_suffix)) > INDEX_FILE_PATH_MAX_LENGTH)
+    {
+        p_db_index_directory_path[0] = '\0';
+        return false;
+    }
+
+    strncpy(p_db_index_directory_path, db_directory_path, INDEX_FILE_PATH_MAX_LENGTH);
+    strcat(p_db_index_directory_path, index_directory_suffix);
+    p_db_index_directory_path[INDEX_FILE_PATH_MAX_LENGTH] = '\0';
+
+    return true;
+}
+
+// index key defined as the file that contains the index data.
+// Default index key is db_set_name + "_" + p_key (DB_RECORD_T).
+// TODO: db_set_name is a fake string that doesn't contain '\0' at the end, and p_key is not expected to be a string all the time.
+// TODO: to_printable or toString
+char *set_db_index_key(void *db_set_name, uint32_t set_name_size, void *p_key, uint32_t key_size)
+{
+    // TODO: toString(p_key)
+    char *p_db_index_key = calloc(set_name_size + key_size + 2, sizeof(char));
+
+    if (p_db_index_key == NULL)
+    {
+        return NULL;
+    }
+
+    memcpy(p_db_index_key, db_set_name, set_name_size);
+    p_db_index_key[set_name_size] = '_';
+    memcpy(p_db_index_key + set_name_size + 1, p_key, key_size);
+
+    p_db_index_key[set_name_size + key_size + 1] = '\0';
+
+    return p_db_index_key;
+}
+
+INDEX_ID_TYPE_E get_db_index_id_type(FACILEDB_RECORD_VALUE_TYPE_E record_value_type)
+{
+    switch (record_value_type)
+    {
+    case FACILEDB_RECORD_VALUE_TYPE_UINT32:
+        return INDEX_ID_TYPE_UINT32;
+    case FACILEDB_RECORD_VALUE_TYPE_INT32:
+        return INDEX_ID_TYPE_INT32;
+    case FACILEDB_RECORD_VALUE_TYPE_UINT64:
+        return INDEX_ID_TYPE_UINT64;
+    case FACILEDB_RECORD_VALUE_TYPE_INT64:
+        return INDEX_ID_TYPE_INT64;
+    case FACILEDB_RECORD_VALUE_TYPE_FLOAT:
+        return INDEX_ID_TYPE_FLOAT;
+    case FACILEDB_RECORD_VALUE_TYPE_DOUBLE:
+        return INDEX_ID_TYPE_DOUBLE;
+    case FACILEDB_RECORD_VALUE_TYPE_STRING:
+        return DB_STRING_INDEX_ID_TYPE;
+    default:
+        return INDEX_ID_TYPE_INVALID;
+    }
+}
+
+// Return the index id type of the existing p_key index if the records of record_value_type are indexed by it.
+// Otherwise, return INDEX_ID_TYPE_INVALID.
+// p_db_index_catalog_entry: catalog entry of p_key, NULL if p_key isn't indexed.
+INDEX_ID_TYPE_E get_db_existing_index_id_type(DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry, FACILEDB_RECORD_VALUE_TYPE_E record_value_type)
+{
+    INDEX_ID_TYPE_E index_id_type = (p_db_index_catalog_entry != NULL) ? (INDEX_ID_TYPE_E)p_db_index_catalog_entry->index_id_type : INDEX_ID_TYPE_INVALID;
+
+    if ((index_id_type != INDEX_ID_TYPE_INVALID) && (index_id_type == get_db_index_id_type(record_value_type)))
+    {
+        return index_id_type;
+    }
+    else if ((record_value_type == FACILEDB_RECORD_VALUE_TYPE_STRING) &&
+             ((index_id_type == INDEX_ID_TYPE_HASH) || (index_id_type == INDEX_ID_TYPE_HASH64) || (index_id_type == INDEX_ID_TYPE_STRING)))
+    {
+        // String indexes keep the index id type they were created with, e.g. the 32-bit hash of the former versions.
+        return index_id_type;
+    }
+    else
+    {
+        return INDEX_ID_TYPE_INVALID;
+    }
+}
+
+// Return the pointer of the index id of the record value.
+// p_index_id_buffer: buffer of the converted value if the record value isn't the index id itself.
+void *get_db_record_index_id(DB_RECORD_INFO_T *p_db_record_info, INDEX_ID_TYPE_E index_id_type, DB_INDEX_ID_BUFFER_T *p_index_id_buffer)
+{
+    if (index_id_type == INDEX_ID_TYPE_HASH)
+    {
+        // hash the value
+        p_index_id_buffer->hash_value = Hash(p_db_record_info->db_record.p_value, p_db_record_info->db_record_properties.value_size);
+        return &(p_index_id_buffer->hash_value);
+    }
+    else if (index_id_type == INDEX_ID_TYPE_HASH64)
+    {
+        p_index_id_buffer->hash64_value = Hash64(p_db_record_info->db_record.p_value, p_db_record_info->db_record_properties.value_size);
+        return &(p_index_id_buffer->hash64_value);
+    }
+    else if (index_id_type == INDEX_ID_TYPE_STRING)
+    {
+        Index_Id_Type_Set_String(&(p_index_id_buffer->string_id), p_db_record_info->db_record.p_value, p_db_record_info->db_record_properties.value_size);
+        return &(p_index_id_buffer->string_id);
+    }
+    else
+    {
+        return p_db_record_info->db_record.p_value;
+    }
+}
+
+// p_db_covering_properties: make a covering index if it isn't NULL.
+uint32_t make_db_record_index(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_db_record_info, DB_COVERING_PROPERTIES_T *p_db_covering_properties)
+{
+    char *p_index_key = NULL;
+    DB_SET_SNAPSHOT_T db_set_snapshot;
+    // array of db_data_info
+    DB_DATA_INFO_T *p_db_result_data = NULL;
+    uint32_t result_data_num = 0;
+    INDEX_ID_TYPE_E index_id_type = get_db_index_id_type(p_db_record_info->db_record_properties.record_value_type);
+    // The matched records are collected and built into the index at once.
+    uint8_t *p_index_ids = NULL;
+    DB_INDEX_PAYLOAD_T *p_db_index_payloads = NULL;
+    uint32_t index_id_size = 0, element_num = 0;
+    FILE *p_covering_file = NULL;
+    char db_covering_file_path[FACILEDB_FILE_PATH_BUFFER_LENGTH] = {0};
+
+    // check if index existed.
+    p_index_key = set_db_index_key(p_db_set_info->db_set_properties.p_set_name, p_db_set_info->db_set_properties.set_name_size, p_db_record_info->db_record.p_key, p_db_record_info->db_record_properties.key_size);
+    if (query_db_index_catalog_entry(p_db_set_info, p_db_record_info->db_record.p_key, p_db_record_info->db_record_properties.key_size) != NULL)
+    {
+        // Already in the catalog.
+    }
+    else if (Index_Api_Index_Key_Exist(p_index_key))
+    {
+        // The index file is made by the index APIs after the catalog file, add it to the catalog.
+        get_db_covering_file_path(db_covering_file_path, p_index_key);
+        if (add_db_index_catalog_entry(&(p_db_set_info->index_catalog), p_db_record_info->db_record.p_key, strnlen((char *)p_db_record_info->db_record.p_key, p_db_record_info->db_record_properties.key_size), Index_Api_Get_Index_Id_Type(p_index_key), (access(db_covering_file_path, F_OK) == 0)))
+        {
+            write_db_index_catalog(&(p_db_set_info->index_catalog));
+        }
+    }
+    else
+    {
+        // search for all matched db_records
+        get_db_set_latest_snapshot(p_db_set_info, &db_set_snapshot);
+        p_db_result_data = search_db_data(p_db_set_info, &db_set_snapshot, p_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_ANY, &result_data_num);
+
+        if ((index_id_type != INDEX_ID_TYPE_INVALID) && (result_data_num > 0))
+        {
+            index_id_size = Index_Id_Type_Get_Size(index_id_type);
+            p_index_ids = malloc(index_id_size * result_data_num);
+            p_db_index_payloads = malloc(sizeof(DB_INDEX_PAYLOAD_T) * result_data_num);
+        }
+
+        // The index is covering if the covering file exists, create it before the index and remove the stale one.
+        get_db_covering_file_path(db_covering_file_path, p_index_key);
+        if ((p_db_covering_properties != NULL) && (p_index_ids != NULL) && (p_db_index_payloads != NULL))
+        {
+            p_covering_file = create_db_covering_file(p_index_key, p_db_covering_properties);
+        }
+        else
+        {
+            remove(db_covering_file_path);
+        }
+
+        for (uint32_t i = 0; i < result_data_num; i++)
+        {
+            for (uint32_t j = 0; j < p_db_result_data[i].record_num; j++)
+            {
+                if ((p_db_result_data[i].p_db_record_info[j].db_record_properties.key_size == p_db_record_info->db_record_properties.key_size) &&
+                    (memcmp(p_db_result_data[i].p_db_record_info[j].db_record.p_key, p_db_record_info->db_record.p_key, p_db_record_info->db_record_properties.key_size) == 0) &&
+                    (p_db_result_data[i].p_db_record_info[j].db_record_properties.record_value_type == p_db_record_info->db_record_properties.record_value_type))
+                {
+                    if ((p_index_ids != NULL) && (p_db_index_payloads != NULL) && ((p_db_covering_properties == NULL) || (p_covering_file != NULL)))
+                    {
+                        DB_INDEX_ID_BUFFER_T index_id_buffer;
+                        void *p_index_id = get_db_record_index_id(&(p_db_result_data[i].p_db_record_info[j]), index_id_type, &index_id_buffer);
+                        DB_INDEX_PAYLOAD_T db_index_payload = {
+                            .data_tag = p_db_result_data[i].data_tag,
+                            .start_db_block_tag = p_db_result_data[i].start_db_block_tag};
+
+                        if (p_covering_file != NULL)
+                        {
+                            db_index_payload.covering_entry_offset = append_db_covering_entry(p_covering_file, p_db_covering_properties, &(p_db_result_data[i]), &(p_db_result_data[i].p_db_record_info[j]), &db_index_payload);
+                        }
+
+                        // Error handling: the data isn't indexed if its covering entry can't be written.
+                        if ((p_covering_file == NULL) || (db_index_payload.covering_entry_offset != 0))
+                        {
+                            memcpy(p_index_ids + (index_id_size * element_num), p_index_id, index_id_size);
+                            p_db_index_payloads[element_num] = db_index_payload;
+                            element_num++;
+                        }
+                    }
+
+                    break;
+                }
+            }
+
+            // free resource
+            free_db_data_info_resources(&(p_db_result_data[i]));
+        }
+
+        if (element_num > 0)
+        {
+            Index_Api_Bulk_Build(p_index_key, index_id_type, p_index_ids, p_db_index_payloads, sizeof(DB_INDEX_PAYLOAD_T), element_num);
+            if (add_db_index_catalog_entry(&(p_db_set_info->index_catalog), p_db_record_info->db_record.p_key, strnlen((char *)p_db_record_info->db_record.p_key, p_db_record_info->db_record_properties.key_size), index_id_type, (p_covering_file != NULL)))
+            {
+                write_db_index_catalog(&(p_db_set_info->index_catalog));
+            }
+        }
+
+        if (p_covering_file != NULL)
+        {
+            fclose(p_covering_file);
+            if (element_num == 0)
+            {
+                // The index isn't created.
+                remove(db_covering_file_path);
+            }
+        }
+    }
+
+    free(p_index_key);
+    free(p_db_result_data);
+    free(p_index_ids);
+    free(p_db_index_payloads);
+
+    return result_data_num;
+}
+
+// p_db_data_info: the data which p_db_record_info belongs to, its records are stored if the index is covering.
+void insert_db_record_index(DB_SET_INFO_T *p_db_set_info, DB_DATA_INFO_T *p_db_data_info, DB_RECORD_INFO_T *p_db_record_info, DB_INDEX_PAYLOAD_T *p_db_index_payload)
+{
+    DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry = query_db_index_catalog_entry(p_db_set_info, p_db_record_info->db_record.p_key, p_db_record_info->db_record_properties.key_size);
+    INDEX_ID_TYPE_E index_id_type = get_db_existing_index_id_type(p_db_index_catalog_entry, p_db_record_info->db_record_properties.record_value_type);
+    char *p_index_key = NULL;
+    void *p_index_id = NULL;
+    DB_INDEX_ID_BUFFER_T index_id_buffer;
+
+    if (index_id_type != INDEX_ID_TYPE_INVALID)
+    {
+        DB_INDEX_PAYLOAD_T db_index_payload = *p_db_index_payload;
+        DB_COVERING_PROPERTIES_T db_covering_properties;
+        FILE *p_covering_file = NULL;
+
+        // TODO: toString(p_set_name) and toString(p_key)
+        p_index_key = set_db_index_key(p_db_set_info->db_set_properties.p_set_name, p_db_set_info->db_set_properties.set_name_size, p_db_record_info->db_record.p_key, p_db_record_info->db_record_properties.key_size);
+
+        // Setup p_index_id based on the index_id_type.
+        p_index_id = get_db_record_index_id(p_db_record_info, index_id_type, &index_id_buffer);
+
+        db_covering_properties_init(&db_covering_properties);
+        if (p_db_index_catalog_entry->is_covering)
+        {
+            p_covering_file = open_db_covering_file(p_index_key, &db_covering_properties);
+        }
+        if (p_covering_file != NULL)
+        {
+            db_index_payload.covering_entry_offset = append_db_covering_entry(p_covering_file, &db_covering_properties, p_db_data_info, p_db_record_info, p_db_index_payload);
+            fclose(p_covering_file);
+            free_db_covering_properties_resources(&db_covering_properties);
+        }
+
+        /*
+        **  p_index_key: p_db_set_name + p_key (DB_RECORD_T)
+        **  p_index_id: p_value (DB_RECORD_T)
+        **  index_id_type: type (uint32 / string / ...)
+        **  p_index_payload: a structure with the data offset / data tag / data start block tag / ...
+        **  payload_size: sizeof the payload
+        **  return value: pointer of the payload array, size of each element size is INDEX_PAYLOAD_SIZE
+        */
+        if ((p_covering_file == NULL) || (db_index_payload.covering_entry_offset != 0))
+        {
+            Index_Api_Insert_Element(p_index_key, p_index_id, index_id_type, &db_index_payload, sizeof(DB_INDEX_PAYLOAD_T));
+        }
+    }
+
+    free(p_index_key);
+}
+
+// Write the delete sequence into the covering entry of the data if p_key covering index has been created.
+// The covered searches don't read the blocks, the entry has its own deleted flag, see search_db_data_indexed().
+void delete_db_record_covering_entry(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_db_record_info, uint64_t data_tag, uint32_t delete_sequence)
+{
+    DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry = query_db_index_catalog_entry(p_db_set_info, p_db_record_info->db_record.p_key, p_db_record_info->db_record_properties.key_size);
+    INDEX_ID_TYPE_E index_id_type = get_db_existing_index_id_type(p_db_index_catalog_entry, p_db_record_info->db_record_properties.record_value_type);
+    char *p_index_key = NULL;
+    void *p_index_id = NULL;
+    DB_INDEX_ID_BUFFER_T index_id_buffer;
+    DB_COVERING_PROPERTIES_T db_covering_properties;
+    FILE *p_covering_file = NULL;
+
+    if ((index_id_type == INDEX_ID_TYPE_INVALID) || (p_db_index_catalog_entry->is_covering == false))
+    {
+        return;
+    }
+
+    p_index_key = set_db_index_key(p_db_set_info->db_set_properties.p_set_name, p_db_set_info->db_set_properties.set_name_size, p_db_record_info->db_record.p_key, p_db_record_info->db_record_properties.key_size);
+    p_index_id = get_db_record_index_id(p_db_record_info, index_id_type, &index_id_buffer);
+
+    db_covering_properties_init(&db_covering_properties);
+    p_covering_file = open_db_covering_file(p_index_key, &db_covering_properties);
+    if (p_covering_file != NULL)
+    {
+        // The payloads of a covering index have the entry offsets instead of the start block tags, find the element by the data tag.
+        uint32_t result_length = 0;
+        DB_INDEX_PAYLOAD_T *p_result_index_payloads = (DB_INDEX_PAYLOAD_T *)Index_Api_Search_Equal(p_index_key, p_index_id, index_id_type, &result_length);
+
+        for (uint32_t i = 0; i < result_length; i++)
+        {
+            if (p_result_index_payloads[i].data_tag == data_tag)
+            {
+                delete_db_covering_entry(p_covering_file, p_result_index_payloads[i].covering_entry_offset, delete_sequence);
+                break;
+            }
+        }
+
+        Index_Api_Free_Search_Result(p_result_index_payloads);
+        fclose(p_covering_file);
+        free_db_covering_properties_resources(&db_covering_properties);
+    }
+
+    free(p_index_key);
+}
+
+// return value: an array of DB_DATA_INFO_T, whose length is *p_result_db_data_info_num.
+// The data are read from the covering file instead of the set file if the index covers all the records or is_covered_only is true.
+// is_covered_only: return the covered records only, there is no result if the index isn't covering.
+DB_DATA_INFO_T *search_db_data_indexed(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot, DB_RECORD_INFO_T *p_target_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E compare_type, uint32_t *p_result_db_data_info_num, bool is_covered_only)
+{
+    char *p_index_key = set_db_index_key(p_db_set_info->db_set_properties.p_set_name, p_db_set_info->db_set_properties.set_name_size, p_target_db_record_info->db_record.p_key, p_target_db_record_info->db_record_properties.key_size);
+    void *p_index_id = NULL;
+    DB_INDEX_ID_BUFFER_T index_id_buffer;
+    DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry = query_db_index_catalog_entry(p_db_set_info, p_target_db_record_info->db_record.p_key, p_target_db_record_info->db_record_properties.key_size);
+    INDEX_ID_TYPE_E index_id_type = get_db_existing_index_id_type(p_db_index_catalog_entry, p_target_db_record_info->db_record_properties.record_value_type);
+    DB_INDEX_PAYLOAD_T *p_result_index_payloads = NULL;
+    DB_DATA_INFO_T *p_result_db_data_infos = NULL;
+    uint32_t result_length = 0;
+    uint32_t match_length = 0;
+    DB_COVERING_PROPERTIES_T db_covering_properties;
+    FILE *p_covering_file = NULL;
+
+    db_covering_properties_init(&db_covering_properties);
+    if ((index_id_type != INDEX_ID_TYPE_INVALID) && p_db_index_catalog_entry->is_covering)
+    {
+        p_covering_file = open_db_covering_file(p_index_key, &db_covering_properties);
+    }
+
+    if ((index_id_type != INDEX_ID_TYPE_INVALID) && ((is_covered_only == false) || (p_covering_file != NULL)))
+    {
+        // Setup p_index_id based on the index_id_type.
+        p_index_id = get_db_record_index_id(p_target_db_record_info, index_id_type, &index_id_buffer);
+
+        // if(compare_type == FACILEDB_RECORD_VALUE_TYPE_COMPARE_ANY)
+        // {
+        //     // TODO: compare_any, aka all value
+        // }
+        if (compare_type == FACILEDB_RECORD_VALUE_TYPE_COMPARE_EQUAL)
+        {
+            p_result_index_payloads = (DB_INDEX_PAYLOAD_T *)Index_Api_Search_Equal(p_index_key, p_index_id, index_id_type, &result_length);
+        }
+
+        // Transfer db_index_payloads to db_data_infos
+        if (result_length > 0)
+        {
+            p_result_db_data_infos = calloc(result_length, sizeof(DB_DATA_INFO_T));
+
+            for (uint32_t i = 0; i < result_length; i++)
+            {
+                DB_BLOCK_T db_block;
+                DB_DATA_INFO_T read_db_data_info;
+                bool record_match = false;
+                uint64_t start_db_block_tag = p_result_index_payloads[i].start_db_block_tag;
+
+                db_data_info_init(&read_db_data_info);
+                db_block_init(&db_block);
+
+                if (p_covering_file != NULL)
+                {
+                    // The entry has the start block tag of the data, and all the records if the index covers all of them.
+                    if (read_db_covering_entry(p_covering_file, p_result_index_payloads[i].covering_entry_offset, &read_db_data_info) == false)
+                    {
+                        continue;
+                    }
+
+                    if ((is_db_block_visible(p_db_set_snapshot, read_db_data_info.start_db_block_tag, read_db_data_info.deleted) == false) ||
+                        ((read_db_data_info.start_db_block_tag <= p_db_set_snapshot->skipped_block_tag) && (is_db_start_block_written(p_db_set_info, read_db_data_info.start_db_block_tag) == false)))
+                    {
+                        free_db_data_info_resources(&read_db_data_info);
+                        free(read_db_data_info.p_db_record_info);
+                        continue;
+                    }
+
+                    if ((is_covered_only == false) && (db_covering_properties.covered_key_num > 0))
+                    {
+                        start_db_block_tag = read_db_data_info.start_db_block_tag;
+                        free_db_data_info_resources(&read_db_data_info);
+                        free(read_db_data_info.p_db_record_info);
+                        db_data_info_init(&read_db_data_info);
+                    }
+                }
+
+                if (read_db_data_info.p_db_record_info == NULL)
+                {
+                    // The data appended after the snapshot may be indexed already.
+                    if (start_db_block_tag > p_db_set_snapshot->block_num)
+                    {
+                        continue;
+                    }
+
+                    // read attribute only for checking delete flag and first block flag.
+                    read_db_block_attributes(p_db_set_info, start_db_block_tag, &db_block);
+
+                    if (is_db_block_visible(p_db_set_snapshot, start_db_block_tag, db_block.deleted) == false || db_block.prev_block_tag != 0)
+                    {
+                        continue;
+                    }
+
+                    // Read the whole block and next blocks if they exists. The buffers will be allocated, and the record content will be copied into the record_info
+                    extract_db_data_info_from_db_blocks(&read_db_data_info, start_db_block_tag, p_db_set_info);
+                }
+
+                // Compare again to prevent collision.
+                for (uint32_t record_idx = 0; record_idx < read_db_data_info.record_num; record_idx++)
+                {
+                    if (p_target_db_record_info->db_record_properties.key_size == read_db_data_info.p_db_record_info[record_idx].db_record_properties.key_size &&
+                        memcmp(read_db_data_info.p_db_record_info[record_idx].db_record.p_key, p_target_db_record_info->db_record.p_key, p_target_db_record_info->db_record_properties.key_size) == 0 &&
+                        p_target_db_record_info->db_record_properties.record_value_type == read_db_data_info.p_db_record_info[record_idx].db_record_properties.record_value_type &&
+                        // value size comparison doesn't need (?)
+                        (compare_type == FACILEDB_RECORD_VALUE_TYPE_COMPARE_ANY || Faciledb_Record_Value_Type_Compare(p_target_db_record_info->db_record_properties.record_value_type, read_db_data_info.p_db_record_info[record_idx].db_record.p_value, p_target_db_record_info->db_record.p_value) == compare_type))
+                    {
+                        record_match = true;
+                        break;
+                    }
+                }
+
+                if (record_match)
+                {
+                    db_data_info_init(&(p_result_db_data_infos[match_length]));
+                    shallow_copy_db_data_info(&(p_result_db_data_infos[match_length]), &read_db_data_info);
+                    match_length++;
+
+                    // Because the data info resources still in-used for result, don't free data info resources here.
+                }
+                else
+                {
+                    free_db_data_info_resources(&read_db_data_info);
+                    free(read_db_data_info.p_db_record_info);
+                }
+            }
+
+            free(p_result_index_payloads);
+            result_length = 0;
+        }
+    }
+
+    if (p_covering_file != NULL)
+    {
+        fclose(p_covering_file);
+        free_db_covering_properties_resources(&db_covering_properties);
+    }
+    free(p_index_key);
+    *p_result_db_data_info_num = match_length;
+    return p_result_db_data_infos;
+}
+
+// Search by the covering index of the target record key without reading the set file.
+DB_DATA_INFO_T *search_db_data_covered(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot, DB_RECORD_INFO_T *p_target_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E compare_type, uint32_t *p_result_db_data_info_num)
+{
+    DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry = query_db_index_catalog_entry(p_db_set_info, p_target_db_record_info->db_record.p_key, p_target_db_record_info->db_record_properties.key_size);
+    bool is_indexed = (get_db_existing_index_id_type(p_db_index_catalog_entry, p_target_db_record_info->db_record_properties.record_value_type) != INDEX_ID_TYPE_INVALID);
+
+    if (is_indexed && p_db_index_catalog_entry->is_covering)
     {
-        shallow_assign_faciledb_record_to_db_record_info(&(p_db_data_info->p_db_record_info[i]), &(p_faciledb_data->p_data_records[i]));
+        return search_db_data_indexed(p_db_set_info, p_db_set_snapshot, p_target_db_record_info, compare_type, p_result_db_data_info_num, true);
     }
 
-    return true;
+    *p_result_db_data_info_num = 0;
+    return NULL;
 }
 
-void db_record_init(DB_RECORD_T *p_db_record)
+void db_covering_properties_init(DB_COVERING_PROPERTIES_T *p_db_covering_properties)
 {
-    p_db_record->p_key = NULL;
-    p_db_record->p_value = NULL;
+    p_db_covering_properties->covered_key_num = 0;
+    p_db_covering_properties->keys_size = 0;
+    p_db_covering_properties->p_keys = NULL;
 }
 
-bool allocate_db_record_resources(DB_RECORD_T *p_db_record, uint32_t key_size, uint32_t value_size)
+// Serialize the keys of the covered records.
+bool set_db_covering_properties(DB_COVERING_PROPERTIES_T *p_db_covering_properties, FACILEDB_RECORD_T *p_covered_records, uint32_t covered_record_num)
 {
-    if (p_db_record->p_key || p_db_record->p_value)
+    uint8_t *p_keys_write = NULL;
+
+    p_db_covering_properties->covered_key_num = covered_record_num;
+    p_db_covering_properties->keys_size = 0;
+    for (uint32_t i = 0; i < covered_record_num; i++)
     {
-        free_db_record_resources(p_db_record);
+        p_db_covering_properties->keys_size += sizeof(uint32_t) + p_covered_records[i].key_size;
     }
 
-    p_db_record->p_key = calloc(1, key_size * sizeof(uint8_t));
-    if (p_db_record->p_key == NULL)
+    if (p_db_covering_properties->keys_size == 0)
     {
-        return false;
+        return true;
     }
 
-    p_db_record->p_value = calloc(1, value_size * sizeof(uint8_t));
-    if (p_db_record->p_value == NULL)
+    p_db_covering_properties->p_keys = malloc(p_db_covering_properties->keys_size);
+    if (p_db_covering_properties->p_keys == NULL)
     {
-        free_db_record_resources(p_db_record);
         return false;
     }
 
-    return true;
-}
-
-void free_db_record_resources(DB_RECORD_T *p_db_record)
-{
-    if (p_db_record->p_key != NULL)
+    p_keys_write = p_db_covering_properties->p_keys;
+    for (uint32_t i = 0; i < covered_record_num; i++)
     {
-        free(p_db_record->p_key);
-        p_db_record->p_key = NULL;
+        memcpy(p_keys_write, &(p_covered_records[i].key_size), sizeof(uint32_t));
+        p_keys_write += sizeof(uint32_t);
+        memcpy(p_keys_write, p_covered_records[i].p_key, p_covered_records[i].key_size);
+        p_keys_write += p_covered_records[i].key_size;
     }
 
-    if (p_db_record->p_value != NULL)
-    {
-        free(p_db_record->p_value);
-        p_db_record->p_value = NULL;
-    }
+    return true;
 }
 
-void copy_db_record(DB_RECORD_T *p_dest_db_record, DB_RECORD_T *p_src_db_record, uint32_t key_size, uint32_t value_size)
+void free_db_covering_properties_resources(DB_COVERING_PROPERTIES_T *p_db_covering_properties)
 {
-    assert(p_dest_db_record->p_key != NULL && p_dest_db_record->p_value != NULL);
-
-    memcpy(p_dest_db_record->p_key, p_src_db_record->p_key, key_size);
-    memcpy(p_dest_db_record->p_value, p_src_db_record->p_value, value_size);
+    free(p_db_covering_properties->p_keys);
+    p_db_covering_properties->p_keys = NULL;
 }
 
-void db_record_info_init(DB_RECORD_INFO_T *p_db_record_info)
+void get_db_covering_file_path(char *p_db_covering_file_path, char *p_index_key)
 {
-    db_record_properties_init(&(p_db_record_info->db_record_properties));
-    db_record_init(&(p_db_record_info->db_record));
-    p_db_record_info->db_record_properties_offset = 0;
-}
+    // file path: /db/directory/path/index/index_key.faciledb_covering
+    char file_extension[] = ".faciledb_covering";
+    char db_index_directory_path[INDEX_FILE_PATH_BUFFER_LENGTH] = {0};
 
-// Setup key_size and value_size before calling this function.
-bool allocate_db_record_info_resources(DB_RECORD_INFO_T *p_db_record_info)
-{
-    uint32_t key_size = p_db_record_info->db_record_properties.key_size;
-    uint32_t value_size = p_db_record_info->db_record_properties.value_size;
+    if ((get_db_index_directory_path(db_index_directory_path) == false) ||
+        ((strlen(db_index_directory_path) + strlen(p_index_key) + strlen(file_extension)) > FACILEDB_FILE_PATH_MAX_LENGTH))
+    {
+        p_db_covering_file_path[0] = '\0';
+    }
+    else
+    {
+        strcpy(p_db_covering_file_path, db_index_directory_path);
+        strcat(p_db_covering_file_path, p_index_key);
+        strcat(p_db_covering_file_path, file_extension);
 
-    return allocate_db_record_resources(&(p_db_record_info->db_record), key_size, value_size);
+        p_db_covering_file_path[FACILEDB_FILE_PATH_MAX_LENGTH] = '\0';
+    }
 }
 
-void free_db_record_info_resources(DB_RECORD_INFO_T *p_db_record_info)
+// Create the covering file and write the covered keys, the existed one is truncated.
+FILE *create_db_covering_file(char *p_index_key, DB_COVERING_PROPERTIES_T *p_db_covering_properties)
 {
-    free_db_record_resources(&(p_db_record_info->db_record));
-}
+    char db_covering_file_path[FACILEDB_FILE_PATH_BUFFER_LENGTH] = {0};
+    FILE *p_covering_file = NULL;
 
-bool faciledb_record_to_db_record_info(FACILEDB_RECORD_T *p_faciledb_record, DB_RECORD_INFO_T *p_db_record_info)
-{
-    DB_RECORD_PROPERTIES_T *p_db_record_properties = &(p_db_record_info->db_record_properties);
-    DB_RECORD_T *p_db_record = &(p_db_record_info->db_record);
+    get_db_covering_file_path(db_covering_file_path, p_index_key);
+    if (db_covering_file_path[0] == '\0')
+    {
+        return NULL;
+    }
 
-    p_db_record_properties->deleted = 0;
-    p_db_record_properties->key_size = p_faciledb_record->key_size;
-    p_db_record_properties->value_size = p_faciledb_record->value_size;
-    p_db_record_properties->record_value_type = p_faciledb_record->record_value_type;
+    p_covering_file = fopen(db_covering_file_path, "w+b");
+    if (p_covering_file == NULL)
+    {
+        return NULL;
+    }
 
-    allocate_db_record_resources(p_db_record, p_db_record_properties->key_size, p_db_record_properties->value_size);
-    memcpy(p_db_record->p_key, p_faciledb_record->p_key, p_db_record_properties->key_size);
-    memcpy(p_db_record->p_value, p_faciledb_record->p_value, p_db_record_properties->value_size);
+#if IS_POSIX_API_SUPPORT
+    int fd = fileno(p_covering_file);
+    off_t offset = 0;
 
-    return true;
+    pwrite(fd, &(p_db_covering_properties->covered_key_num), sizeof(p_db_covering_properties->covered_key_num), offset);
+    offset += sizeof(p_db_covering_properties->covered_key_num);
+    pwrite(fd, &(p_db_covering_properties->keys_size), sizeof(p_db_covering_properties->keys_size), offset);
+    offset += sizeof(p_db_covering_properties->keys_size);
+    pwrite(fd, p_db_covering_properties->p_keys, p_db_covering_properties->keys_size, offset);
+#else
+    fwrite(&(p_db_covering_properties->covered_key_num), sizeof(p_db_covering_properties->covered_key_num), 1, p_covering_file);
+    fwrite(&(p_db_covering_properties->keys_size), sizeof(p_db_covering_properties->keys_size), 1, p_covering_file);
+    fwrite(p_db_covering_properties->p_keys, p_db_covering_properties->keys_size, 1, p_covering_file);
+#endif
+
+    return p_covering_file;
 }
 
-// shallow assign values and pointers, would not allocate space for dynamic resources.
-void shallow_assign_faciledb_record_to_db_record_info(DB_RECORD_INFO_T *p_db_record_info, FACILEDB_RECORD_T *p_faciledb_record)
+// Open the covering file and read the covered keys.
+// Return NULL if the index isn't covering.
+FILE *open_db_covering_file(char *p_index_key, DB_COVERING_PROPERTIES_T *p_db_covering_properties)
 {
-    DB_RECORD_PROPERTIES_T *p_db_record_properties = &(p_db_record_info->db_record_properties);
-    DB_RECORD_T *p_db_record = &(p_db_record_info->db_record);
+    char db_covering_file_path[FACILEDB_FILE_PATH_BUFFER_LENGTH] = {0};
+    FILE *p_covering_file = NULL;
+    bool is_read = false;
 
-    p_db_record_properties->deleted = 0;
-    p_db_record_properties->key_size = p_faciledb_record->key_size;
-    p_db_record_properties->value_size = p_faciledb_record->value_size;
-    p_db_record_properties->record_value_type = p_faciledb_record->record_value_type;
+    get_db_covering_file_path(db_covering_file_path, p_index_key);
+    if (db_covering_file_path[0] == '\0')
+    {
+        return NULL;
+    }
 
-    p_db_record->p_key = p_faciledb_record->p_key;
-    p_db_record->p_value = p_faciledb_record->p_value;
+    p_covering_file = fopen(db_covering_file_path, "r+b");
+    if (p_covering_file == NULL)
+    {
+        return NULL;
+    }
 
-    p_db_record_info->db_record_properties_offset = 0; // invalid
-}
+#if IS_POSIX_API_SUPPORT
+    int fd = fileno(p_covering_file);
+    off_t offset = sizeof(p_db_covering_properties->covered_key_num) + sizeof(p_db_covering_properties->keys_size);
 
-// shallow assgin values and pointers, would not allocate memory for dynamic resources.
-void shallow_assign_db_record_info_to_faciledb_record(FACILEDB_RECORD_T *p_faciledb_record, DB_RECORD_INFO_T *p_db_record_info)
-{
-    p_faciledb_record->key_size = p_db_record_info->db_record_properties.key_size;
-    p_faciledb_record->value_size = p_db_record_info->db_record_properties.value_size;
-    p_faciledb_record->record_value_type = p_db_record_info->db_record_properties.record_value_type;
+    if ((pread(fd, &(p_db_covering_properties->covered_key_num), sizeof(p_db_covering_properties->covered_key_num), 0) == sizeof(p_db_covering_properties->covered_key_num)) &&
+        (pread(fd, &(p_db_covering_properties->keys_size), sizeof(p_db_covering_properties->keys_size), sizeof(p_db_covering_properties->covered_key_num)) == sizeof(p_db_covering_properties->keys_size)))
+    {
+        p_db_covering_properties->p_keys = (p_db_covering_properties->keys_size > 0) ? malloc(p_db_covering_properties->keys_size) : NULL;
+        is_read = (p_db_covering_properties->keys_size == 0) ||
+                  ((p_db_covering_properties->p_keys != NULL) && (pread(fd, p_db_covering_properties->p_keys, p_db_covering_properties->keys_size, offset) == p_db_covering_properties->keys_size));
+    }
+#else
+    if ((fread(&(p_db_covering_properties->covered_key_num), sizeof(p_db_covering_properties->covered_key_num), 1, p_covering_file) == 1) &&
+        (fread(&(p_db_covering_properties->keys_size), sizeof(p_db_covering_properties->keys_size), 1, p_covering_file) == 1))
+    {
+        p_db_covering_properties->p_keys = (p_db_covering_properties->keys_size > 0) ? malloc(p_db_covering_properties->keys_size) : NULL;
+        is_read = (p_db_covering_properties->keys_size == 0) ||
+                  ((p_db_covering_properties->p_keys != NULL) && (fread(p_db_covering_properties->p_keys, p_db_covering_properties->keys_size, 1, p_covering_file) == 1));
+    }
+#endif
 
-    p_faciledb_record->p_key = p_db_record_info->db_record.p_key;
-    p_faciledb_record->p_value = p_db_record_info->db_record.p_value;
+    if (is_read == false)
+    {
+        free_db_covering_properties_resources(p_db_covering_properties);
+        db_covering_properties_init(p_db_covering_properties);
+        fclose(p_covering_file);
+        return NULL;
+    }
+
+    return p_covering_file;
 }
 
-// p_db_data_info is a pointer to a DB_DATA_INFO_T, not a pointer to an array.
-// return value: the number of inserted data.
-uint32_t insert_db_data(DB_SET_INFO_T *p_db_set_info, DB_DATA_INFO_T *p_db_data_info, uint64_t data_tag)
+// The indexed record is always covered, which is used to verify the search result.
+bool is_db_record_covered(DB_COVERING_PROPERTIES_T *p_db_covering_properties, DB_RECORD_INFO_T *p_indexed_db_record_info, DB_RECORD_INFO_T *p_db_record_info)
 {
-    DB_BLOCK_T new_db_block;
-    uint8_t *p_db_block_write = new_db_block.block_data;
-    uint8_t *p_db_block_end = new_db_block.block_data + FACILEDB_BLOCK_DATA_SIZE;
-    size_t db_record_properties_size = get_db_record_properties_size();
-    uint64_t first_db_block_tag = 0;
-    uint64_t last_db_block_tag = 0;
+    uint32_t key_size = p_db_record_info->db_record_properties.key_size;
+    uint8_t *p_keys_read = p_db_covering_properties->p_keys;
 
-    db_block_init(&new_db_block);
-    // Set first block prev/next block tag as 0.
-    insert_db_data_handler_assign_db_block_value(&new_db_block, 0, p_db_data_info->record_num, data_tag);
-    for (uint32_t i = 0; i < (p_db_data_info->record_num); i++)
+    if ((p_db_covering_properties->covered_key_num == 0) ||
+        ((key_size == p_indexed_db_record_info->db_record_properties.key_size) && (memcmp(p_db_record_info->db_record.p_key, p_indexed_db_record_info->db_record.p_key, key_size) == 0)))
     {
-        uint32_t remaining_size = 0;
-        DB_RECORD_INFO_T *p_current_db_record_info = &p_db_data_info->p_db_record_info[i];
+        return true;
+    }
 
-        if ((p_db_block_write + db_record_properties_size) > p_db_block_end)
-        {
-            // new_db_block is full, write new_db_block into file.
-            uint64_t write_block_tag = insert_db_data_handler_write_new_db_block(&new_db_block, p_db_set_info);
-            if (first_db_block_tag == 0)
-            {
-                // first block tag is not set, assign it.
-                first_db_block_tag = write_block_tag;
-            }
+    for (uint32_t i = 0; i < p_db_covering_properties->covered_key_num; i++)
+    {
+        uint32_t covered_key_size = 0;
 
-            // Clear and reassgin the new_block and local variables for new data.
-            db_block_init(&new_db_block);
-            insert_db_data_handler_assign_db_block_value(&new_db_block, write_block_tag, p_db_data_info->record_num, data_tag);
-            // update local variables.
-            p_db_block_write = new_db_block.block_data;
-            p_db_block_end = new_db_block.block_data + FACILEDB_BLOCK_DATA_SIZE;
+        memcpy(&covered_key_size, p_keys_read, sizeof(uint32_t));
+        p_keys_read += sizeof(uint32_t);
+        if ((covered_key_size == key_size) && (memcmp(p_keys_read, p_db_record_info->db_record.p_key, key_size) == 0))
+        {
+            return true;
         }
+        p_keys_read += covered_key_size;
+    }
 
-        // copy record properties to block data.
-        memcpy(p_db_block_write, &(p_current_db_record_info->db_record_properties), db_record_properties_size);
-        new_db_block.record_properties_num++;
-        p_db_block_write += db_record_properties_size;
+    return false;
+}
 
-        // copy record key to block data.
-        remaining_size = p_current_db_record_info->db_record_properties.key_size;
-        while (remaining_size > 0)
-        {
-            assert(p_db_block_end >= p_db_block_write);
+// Append the entry of the data with its covered records by their order in the data.
+// Return the offset of the entry, or 0 if the entry can't be written.
+uint64_t append_db_covering_entry(FILE *p_covering_file, DB_COVERING_PROPERTIES_T *p_db_covering_properties, DB_DATA_INFO_T *p_db_data_info, DB_RECORD_INFO_T *p_indexed_db_record_info, DB_INDEX_PAYLOAD_T *p_db_index_payload)
+{
+    DB_COVERING_ENTRY_T db_covering_entry;
+    uint8_t *p_entry_buffer = NULL, *p_entry_write = NULL;
+    off_t entry_offset = 0;
 
-            uint32_t remaining_block_size = (p_db_block_end - p_db_block_write);
-            uint32_t copy_size = (remaining_block_size < remaining_size) ? (remaining_block_size) : (remaining_size);
-            uint8_t *p_key = NULL;
+    memset(&db_covering_entry, 0, sizeof(DB_COVERING_ENTRY_T));
+    db_covering_entry.data_tag = p_db_index_payload->data_tag;
+    db_covering_entry.start_db_block_tag = p_db_index_payload->start_db_block_tag;
+    db_covering_entry.created_time = (uint64_t)get_current_time();
+    db_covering_entry.deleted = 0;
 
-            if (copy_size == 0)
-            {
-                // Current db_block is full, write db_block into file.
-                uint64_t write_block_tag = insert_db_data_handler_write_new_db_block(&new_db_block, p_db_set_info);
-                if (first_db_block_tag == 0)
-                {
-                    first_db_block_tag = write_block_tag;
-                }
+    for (uint32_t i = 0; i < p_db_data_info->record_num; i++)
+    {
+        DB_RECORD_INFO_T *p_db_record_info = &(p_db_data_info->p_db_record_info[i]);
 
-                // Clear and reassign the current block data and local variables for new data.
-                db_block_init(&new_db_block);
-                insert_db_data_handler_assign_db_block_value(&new_db_block, write_block_tag, p_db_data_info->record_num, data_tag);
-                p_db_block_write = new_db_block.block_data;
-                p_db_block_end = new_db_block.block_data + FACILEDB_BLOCK_DATA_SIZE;
+        if (is_db_record_covered(p_db_covering_properties, p_indexed_db_record_info, p_db_record_info))
+        {
+            db_covering_entry.record_num++;
+            db_covering_entry.records_size += get_db_record_properties_size() + p_db_record_info->db_record_properties.key_size + p_db_record_info->db_record_properties.value_size;
+        }
+    }
 
-                continue;
-            }
+    // Write the entry and its records at once.
+    p_entry_buffer = malloc(sizeof(DB_COVERING_ENTRY_T) + db_covering_entry.records_size);
+    if (p_entry_buffer == NULL)
+    {
+        return 0;
+    }
 
-            p_key = p_current_db_record_info->db_record.p_key + p_current_db_record_info->db_record_properties.key_size - remaining_size;
-            memcpy(p_db_block_write, p_key, copy_size);
-            p_db_block_write += copy_size;
-            remaining_size -= copy_size;
-        }
+    memcpy(p_entry_buffer, &db_covering_entry, sizeof(DB_COVERING_ENTRY_T));
+    p_entry_write = p_entry_buffer + sizeof(DB_COVERING_ENTRY_T);
+    for (uint32_t i = 0; i < p_db_data_info->record_num; i++)
+    {
+        DB_RECORD_INFO_T *p_db_record_info = &(p_db_data_info->p_db_record_info[i]);
+        DB_RECORD_PROPERTIES_T db_record_properties = p_db_record_info->db_record_properties;
 
-        // copy record value to block data
-        remaining_size = p_current_db_record_info->db_record_properties.value_size;
-        while (remaining_size > 0)
+        if (is_db_record_covered(p_db_covering_properties, p_indexed_db_record_info, p_db_record_info) == false)
         {
-            assert(p_db_block_end >= p_db_block_write);
+            continue;
+        }
 
-            uint32_t remaining_block_size = p_db_block_end - p_db_block_write;
-            uint32_t copy_size = (remaining_block_size < remaining_size) ? (remaining_block_size) : (remaining_size);
-            uint8_t *p_value = NULL;
+        db_record_properties.deleted = 0;
+        memcpy(p_entry_write, &db_record_properties, get_db_record_properties_size());
+        p_entry_write += get_db_record_properties_size();
+        memcpy(p_entry_write, p_db_record_info->db_record.p_key, db_record_properties.key_size);
+        p_entry_write += db_record_properties.key_size;
+        memcpy(p_entry_write, p_db_record_info->db_record.p_value, db_record_properties.value_size);
+        p_entry_write += db_record_properties.value_size;
+    }
 
-            if (copy_size == 0)
-            {
-                // block is full, write into file and clear the current block and pointer for new data.
-                uint64_t write_block_tag = insert_db_data_handler_write_new_db_block(&new_db_block, p_db_set_info);
-                if (first_db_block_tag == 0)
-                {
-                    first_db_block_tag = write_block_tag;
-                }
+#if IS_POSIX_API_SUPPORT
+    int fd = fileno(p_covering_file);
 
-                // Clear and reassign the current block data and local variables for new data.
-                db_block_init(&new_db_block);
-                insert_db_data_handler_assign_db_block_value(&new_db_block, write_block_tag, p_db_data_info->record_num, data_tag);
-                // update local variables / pointers
-                p_db_block_write = new_db_block.block_data;
-                p_db_block_end = new_db_block.block_data + FACILEDB_BLOCK_DATA_SIZE;
+    entry_offset = lseek(fd, 0, SEEK_END);
+    pwrite(fd, p_entry_buffer, sizeof(DB_COVERING_ENTRY_T) + db_covering_entry.records_size, entry_offset);
+#else
+    fseek(p_covering_file, 0, SEEK_END);
+    entry_offset = ftell(p_covering_file);
+    fwrite(p_entry_buffer, sizeof(DB_COVERING_ENTRY_T) + db_covering_entry.records_size, 1, p_covering_file);
+#endif
 
-                continue;
-            }
+    free(p_entry_buffer);
 
-            p_value = p_current_db_record_info->db_record.p_value + p_current_db_record_info->db_record_properties.value_size - remaining_size;
-            memcpy(p_db_block_write, p_value, copy_size);
-            p_db_block_write += copy_size;
-            remaining_size -= copy_size;
-        }
-    }
+    return (entry_offset > 0) ? ((uint64_t)entry_offset) : (0);
+}
 
-    // write the last db_block
-    last_db_block_tag = insert_db_data_handler_write_new_db_block(&new_db_block, p_db_set_info);
-    if (first_db_block_tag == 0)
+// Read the entry and its records into p_db_data_info, the buffers are allocated like extract_db_data_info_from_db_blocks().
+bool read_db_covering_entry(FILE *p_covering_file, uint64_t entry_offset, DB_DATA_INFO_T *p_db_data_info)
+{
+    DB_COVERING_ENTRY_T db_covering_entry;
+    uint8_t *p_records_buffer = NULL, *p_records_read = NULL;
+    bool is_read = false;
+
+#if IS_POSIX_API_SUPPORT
+    int fd = fileno(p_covering_file);
+
+    if (pread(fd, &db_covering_entry, sizeof(DB_COVERING_ENTRY_T), entry_offset) == sizeof(DB_COVERING_ENTRY_T))
     {
-        first_db_block_tag = last_db_block_tag;
+        p_records_buffer = malloc(db_covering_entry.records_size);
+        is_read = (p_records_buffer != NULL) && (pread(fd, p_records_buffer, db_covering_entry.records_size, entry_offset + sizeof(DB_COVERING_ENTRY_T)) == db_covering_entry.records_size);
+    }
+#else
+    fseek(p_covering_file, entry_offset, SEEK_SET);
+    if (fread(&db_covering_entry, sizeof(DB_COVERING_ENTRY_T), 1, p_covering_file) == 1)
+    {
+        p_records_buffer = malloc(db_covering_entry.records_size);
+        is_read = (p_records_buffer != NULL) && (fread(p_records_buffer, db_covering_entry.records_size, 1, p_covering_file) == 1);
     }
+#endif
 
-    // recurssively update the next block tag of each db blocks.
-    update_db_block_next_block_tag(last_db_block_tag, 0, p_db_set_info);
+    if (is_read)
+    {
+        p_db_data_info->p_db_record_info = calloc(db_covering_entry.record_num, sizeof(DB_RECORD_INFO_T));
+        is_read = (p_db_data_info->p_db_record_info != NULL);
+    }
 
-#if ENABLE_DB_INDEX
-    // insert index if existed
-    for (uint32_t i = 0; i < (p_db_data_info->record_num); i++)
+    if (is_read == false)
     {
-        DB_RECORD_INFO_T *p_current_db_record_info = &p_db_data_info->p_db_record_info[i];
-        char *p_index_key = set_db_index_key(p_db_set_info->db_set_properties.p_set_name, p_db_set_info->db_set_properties.set_name_size, p_current_db_record_info->db_record.p_key, p_current_db_record_info->db_record_properties.key_size);
-        DB_INDEX_PAYLOAD_T db_index_payload = {
-            .data_tag = data_tag,
-            .start_db_block_tag = first_db_block_tag};
+        free(p_records_buffer);
+        return false;
+    }
 
-        // If p_key index has been created, insert new index element.
-        if (Index_Api_Index_Key_Exist(p_index_key))
-        {
-            insert_db_record_index(p_db_set_info, p_current_db_record_info, &db_index_payload);
-        }
+    p_db_data_info->data_tag = db_covering_entry.data_tag;
+    p_db_data_info->start_db_block_tag = db_covering_entry.start_db_block_tag;
+    p_db_data_info->created_time = db_covering_entry.created_time;
+    p_db_data_info->modified_time = db_covering_entry.created_time;
+    p_db_data_info->deleted = db_covering_entry.deleted;
+    p_db_data_info->record_num = db_covering_entry.record_num;
+
+    p_records_read = p_records_buffer;
+    for (uint32_t i = 0; i < db_covering_entry.record_num; i++)
+    {
+        DB_RECORD_INFO_T *p_db_record_info = &(p_db_data_info->p_db_record_info[i]);
 
-        free(p_index_key);
+        db_record_info_init(p_db_record_info);
+        memcpy(&(p_db_record_info->db_record_properties), p_records_read, get_db_record_properties_size());
+        p_records_read += get_db_record_properties_size();
+
+        allocate_db_record_info_resources(p_db_record_info);
+        memcpy(p_db_record_info->db_record.p_key, p_records_read, p_db_record_info->db_record_properties.key_size);
+        p_records_read += p_db_record_info->db_record_properties.key_size;
+        memcpy(p_db_record_info->db_record.p_value, p_records_read, p_db_record_info->db_record_properties.value_size);
+        p_records_read += p_db_record_info->db_record_properties.value_size;
     }
-#endif
+    assert(p_records_read == p_records_buffer + db_covering_entry.records_size);
 
-    // free db block resources if needed.
-    // currently there is no dynamic resources in db block structure.
+    free(p_records_buffer);
 
-    // return the number of inserted data.
-    return 1;
+    return true;
 }
 
-// return value: new block_tag
-uint64_t insert_db_data_handler_write_new_db_block(DB_BLOCK_T *p_db_block, DB_SET_INFO_T *p_db_set_info)
+// The deleted flag is the delete sequence like the blocks, see delete_db_data().
+void delete_db_covering_entry(FILE *p_covering_file, uint64_t entry_offset, uint32_t delete_sequence)
 {
-    uint64_t block_tag = 0;
-    uint64_t current_time = 0;
+    off_t delete_flag_offset = entry_offset + offsetof(DB_COVERING_ENTRY_T, deleted);
 
-    p_db_set_info->db_set_properties.block_num++;
-    block_tag = p_db_set_info->db_set_properties.block_num;
-    p_db_block->block_tag = block_tag;
+#if IS_POSIX_API_SUPPORT
+    pwrite(fileno(p_covering_file), &delete_sequence, sizeof(delete_sequence), delete_flag_offset);
+#else
+    fseek(p_covering_file, delete_flag_offset, SEEK_SET);
+    fwrite(&delete_sequence, sizeof(delete_sequence), 1, p_covering_file);
+#endif
+}
 
-    current_time = (uint64_t)get_current_time();
-    p_db_block->created_time = current_time;
-    p_db_block->modified_time = current_time;
-    // update db_set_properties time records
-    p_db_set_info->db_set_properties.modified_time = current_time;
+void db_index_catalog_init(DB_INDEX_CATALOG_T *p_db_index_catalog)
+{
+    p_db_index_catalog->file = NULL;
+    p_db_index_catalog->version = 0;
+    p_db_index_catalog->entry_num = 0;
+    p_db_index_catalog->p_entries = NULL;
+}
 
-    write_db_block(p_db_block, p_db_set_info);
+void free_db_index_catalog_entries(DB_INDEX_CATALOG_ENTRY_T *p_entries, uint32_t entry_num)
+{
+    if (p_entries == NULL)
+    {
+        return;
+    }
 
-    return block_tag;
+    for (uint32_t i = 0; i < entry_num; i++)
+    {
+        free(p_entries[i].p_key);
+    }
+    free(p_entries);
 }
 
-void insert_db_data_handler_assign_db_block_value(DB_BLOCK_T *p_db_block, uint64_t prev_block_tag, uint32_t valid_record_num, uint64_t data_tag)
+void close_db_index_catalog(DB_INDEX_CATALOG_T *p_db_index_catalog)
 {
-    p_db_block->data_tag = data_tag;
-    p_db_block->prev_block_tag = prev_block_tag;
-    p_db_block->next_block_tag = 0;
-    p_db_block->deleted = 0;
-    p_db_block->record_properties_num = 0;
-    p_db_block->valid_record_num = valid_record_num;
+    if (p_db_index_catalog->file != NULL)
+    {
+        fclose(p_db_index_catalog->file);
+    }
+    free_db_index_catalog_entries(p_db_index_catalog->p_entries, p_db_index_catalog->entry_num);
+
+    db_index_catalog_init(p_db_index_catalog);
 }
 
-// return value: DB_DATA_INFO_T array whose length is *p_result_db_data_info_num
-DB_DATA_INFO_T *search_db_data(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_target_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E compare_type, uint32_t *p_result_db_data_info_num)
+void get_db_index_catalog_file_path(char *p_db_index_catalog_file_path, DB_SET_PROPERTIES_T *p_db_set_properties)
 {
-#if ENABLE_DB_INDEX
-    // check if index existed and call search_db_data_indexed.
-    char *p_index_key = set_db_index_key(p_db_set_info->db_set_properties.p_set_name, p_db_set_info->db_set_properties.set_name_size, p_target_db_record_info->db_record.p_key, p_target_db_record_info->db_record_properties.key_size);
-    if (Index_Api_Index_Key_Exist(p_index_key))
+    // file path: /db/directory/path/index/set_name.faciledb_catalog
+    char file_extension[] = ".faciledb_catalog";
+    char db_index_directory_path[INDEX_FILE_PATH_BUFFER_LENGTH] = {0};
+
+    if ((get_db_index_directory_path(db_index_directory_path) == false) ||
+        ((strlen(db_index_directory_path) + p_db_set_properties->set_name_size + strlen(file_extension)) > FACILEDB_FILE_PATH_MAX_LENGTH))
     {
-        free(p_index_key);
-        return search_db_data_indexed(p_db_set_info, p_target_db_record_info, compare_type, p_result_db_data_info_num);
+        p_db_index_catalog_file_path[0] = '\0';
     }
     else
     {
-        free(p_index_key);
+        strcpy(p_db_index_catalog_file_path, db_index_directory_path);
+        strncat(p_db_index_catalog_file_path, (char *)p_db_set_properties->p_set_name, p_db_set_properties->set_name_size);
+        strcat(p_db_index_catalog_file_path, file_extension);
+
+        p_db_index_catalog_file_path[FACILEDB_FILE_PATH_MAX_LENGTH] = '\0';
     }
-#endif
-    // General sequential search
-    return search_db_data_sequential(p_db_set_info, p_target_db_record_info, compare_type, p_result_db_data_info_num);
 }
 
-// General sequential search
-DB_DATA_INFO_T *search_db_data_sequential(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_target_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E compare_type, uint32_t *p_result_db_data_info_num)
+// Open the catalog file of the set, a new catalog file is made of the existing index files of the set.
+// Lock the set file before using this function.
+bool open_db_index_catalog(DB_SET_INFO_T *p_db_set_info)
 {
-    uint64_t block_num = p_db_set_info->db_set_properties.block_num;
+    DB_INDEX_CATALOG_T *p_db_index_catalog = &(p_db_set_info->index_catalog);
+    char db_index_catalog_file_path[FACILEDB_FILE_PATH_BUFFER_LENGTH] = {0};
 
-    void *p_target_key = p_target_db_record_info->db_record.p_key;
-    uint32_t target_key_size = p_target_db_record_info->db_record_properties.key_size;
-    void *p_target_value = p_target_db_record_info->db_record.p_value;
-    FACILEDB_RECORD_VALUE_TYPE_E target_value_type = p_target_db_record_info->db_record_properties.record_value_type;
+    get_db_index_catalog_file_path(db_index_catalog_file_path, &(p_db_set_info->db_set_properties));
+    if (db_index_catalog_file_path[0] == '\0')
+    {
+        return false;
+    }
 
-    DB_DATA_INFO_T *p_result_db_data_infos = malloc(DB_SEARCH_DATA_INFO_BUFFER_LEN * sizeof(DB_DATA_INFO_T));
-    uint32_t result_db_data_infos_buffer_len = DB_SEARCH_DATA_INFO_BUFFER_LEN;
-    uint32_t result_db_data_info_num = 0;
+#if IS_POSIX_API_SUPPORT
+    int fd = open(db_index_catalog_file_path, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd >= 0)
+    {
+        p_db_index_catalog->file = fdopen(fd, "wb+");
+        if (p_db_index_catalog->file == NULL)
+        {
+            close(fd);
+            remove(db_index_catalog_file_path);
+            return false;
+        }
 
-    if (p_result_db_data_infos == NULL)
+        scan_db_index_catalog_entries(p_db_set_info);
+        write_db_index_catalog(p_db_index_catalog);
+    }
+    else if (errno == EEXIST)
     {
-        *p_result_db_data_info_num = 0;
-        return NULL;
+        // The catalog is read by refresh_db_index_catalog().
+        p_db_index_catalog->file = fopen(db_index_catalog_file_path, "rb+");
     }
-
-    for (uint64_t block_tag = 1; block_tag <= block_num; block_tag++)
+#else
+    p_db_index_catalog->file = fopen(db_index_catalog_file_path, "rb+");
+    if (p_db_index_catalog->file == NULL)
     {
-        DB_DATA_INFO_T db_data_info;
-        DB_BLOCK_T db_block;
-        bool record_match = false;
+        p_db_index_catalog->file = fopen(db_index_catalog_file_path, "wb+");
+        if (p_db_index_catalog->file != NULL)
+        {
+            write_db_index_catalog(p_db_index_catalog);
+        }
+    }
+#endif
 
-        db_data_info_init(&db_data_info);
-        db_block_init(&db_block);
+    return (p_db_index_catalog->file != NULL);
+}
 
-        // read attribute only for checking delete flag and first block flag.
-        read_db_block_attributes(p_db_set_info, block_tag, &db_block);
+// Add the existing index files of the set to the catalog, which are made before the catalog file, e.g. by the former versions.
+void scan_db_index_catalog_entries(DB_SET_INFO_T *p_db_set_info)
+{
+#if IS_POSIX_API_SUPPORT
+    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
+    char db_index_directory_path[INDEX_FILE_PATH_BUFFER_LENGTH] = {0};
+    char index_file_extension[] = ".faciledb_index";
+    size_t extension_length = strlen(index_file_extension);
+    DIR *p_directory = NULL;
+    struct dirent *p_directory_entry = NULL;
+
+    if ((get_db_index_directory_path(db_index_directory_path) == false) || ((p_directory = opendir(db_index_directory_path)) == NULL))
+    {
+        return;
+    }
 
-        if (db_block.deleted || db_block.prev_block_tag != 0)
+    while ((p_directory_entry = readdir(p_directory)) != NULL)
+    {
+        // index file name: index key (set_name + "_" + key) + extension
+        char *p_file_name = p_directory_entry->d_name;
+        size_t file_name_length = strlen(p_file_name);
+        char index_key[INDEX_FILE_PATH_BUFFER_LENGTH] = {0};
+        char db_covering_file_path[FACILEDB_FILE_PATH_BUFFER_LENGTH] = {0};
+        INDEX_ID_TYPE_E index_id_type = INDEX_ID_TYPE_INVALID;
+        char *p_key = NULL;
+
+        if ((file_name_length < p_db_set_properties->set_name_size + 1 + extension_length) || (file_name_length > INDEX_FILE_PATH_MAX_LENGTH) ||
+            (memcmp(p_file_name, p_db_set_properties->p_set_name, p_db_set_properties->set_name_size) != 0) || (p_file_name[p_db_set_properties->set_name_size] != '_') ||
+            (strcmp(p_file_name + file_name_length - extension_length, index_file_extension) != 0))
         {
             continue;
         }
 
-        // Read the whole block and next blocks if they exists. The buffers will be allocated, and the record content will be copied into the record_info
-        extract_db_data_info_from_db_blocks(&db_data_info, block_tag, p_db_set_info);
-
-        // Search if the target record matched or not.
-        for (uint32_t record_idx = 0; record_idx < db_data_info.record_num; record_idx++)
+        memcpy(index_key, p_file_name, file_name_length - extension_length);
+        index_id_type = Index_Api_Get_Index_Id_Type(index_key);
+        if (index_id_type != INDEX_ID_TYPE_INVALID)
         {
-            if (target_key_size == db_data_info.p_db_record_info[record_idx].db_record_properties.key_size &&
-                memcmp(db_data_info.p_db_record_info[record_idx].db_record.p_key, p_target_key, target_key_size) == 0 &&
-                target_value_type == db_data_info.p_db_record_info[record_idx].db_record_properties.record_value_type &&
-                // value size comparison doesn't need (?)
-                (compare_type == FACILEDB_RECORD_VALUE_TYPE_COMPARE_ANY || Faciledb_Record_Value_Type_Compare(target_value_type, db_data_info.p_db_record_info[record_idx].db_record.p_value, p_target_value) == compare_type))
-            {
-                record_match = true;
-                break;
-            }
+            p_key = index_key + p_db_set_properties->set_name_size + 1;
+            get_db_covering_file_path(db_covering_file_path, index_key);
+            add_db_index_catalog_entry(&(p_db_set_info->index_catalog), p_key, strlen(p_key), index_id_type, (access(db_covering_file_path, F_OK) == 0));
         }
+    }
 
-        // Copy the matched key and value to p_result_db_data_infos array.
-        if (record_match)
-        {
-            // Check if buffer length enough to store new matched data.
-            if (result_db_data_info_num == result_db_data_infos_buffer_len)
-            {
-                DB_DATA_INFO_T *tmp = NULL;
-
-                // TODO: buffer size optimization
-                result_db_data_infos_buffer_len *= 2;
-                tmp = realloc(p_result_db_data_infos, result_db_data_infos_buffer_len * sizeof(DB_DATA_INFO_T));
-                if (tmp == NULL)
-                {
-                    // Not enough memory
-                    // Return current results even if there are more matches data.
-                    // TODO: error handling
-                    break;
-                }
-                p_result_db_data_infos = tmp;
-            }
+    closedir(p_directory);
+#endif
+}
 
-            db_data_info_init(&(p_result_db_data_infos[result_db_data_info_num]));
-            shallow_copy_db_data_info(&(p_result_db_data_infos[result_db_data_info_num]), &db_data_info);
-            result_db_data_info_num++;
+// Reload the catalog if it's changed by the other processes.
+// Lock the set file before using this function, the catalog isn't changed by the others while the set file is locked.
+void refresh_db_index_catalog(DB_SET_INFO_T *p_db_set_info)
+{
+    DB_INDEX_CATALOG_T *p_db_index_catalog = &(p_db_set_info->index_catalog);
+    DB_INDEX_CATALOG_ENTRY_T *p_entries = NULL;
+    uint64_t version = 0;
+    uint32_t entry_num = 0;
+    bool is_read = false;
 
-            // Do not free db_data_info here, because the dynamic resources are still used in p_result_db_data_infos.
-        }
-        else
+    if (p_db_index_catalog->file == NULL)
+    {
+        // The set properties aren't written yet if the set file is just created.
+        if ((p_db_set_info->db_set_properties.set_name_size == 0) || (open_db_index_catalog(p_db_set_info) == false))
         {
-            free_db_data_info_resources(&db_data_info);
+            return;
         }
     }
 
-    *p_result_db_data_info_num = result_db_data_info_num;
-    return p_result_db_data_infos;
+#if IS_POSIX_API_SUPPORT
+    int fd = fileno(p_db_index_catalog->file);
+    off_t offset = sizeof(version) + sizeof(entry_num);
+
+    // The version is written at last, a catalog being written has the former version or 0.
+    if ((pread(fd, &version, sizeof(version), 0) != sizeof(version)) || (version == p_db_index_catalog->version))
+    {
+        return;
+    }
+
+    if (pread(fd, &entry_num, sizeof(entry_num), sizeof(version)) == sizeof(entry_num))
+    {
+        p_entries = (entry_num > 0) ? calloc(entry_num, sizeof(DB_INDEX_CATALOG_ENTRY_T)) : NULL;
+        is_read = (entry_num == 0) || (p_entries != NULL);
+    }
+
+    for (uint32_t i = 0; is_read && (i < entry_num); i++)
+    {
+        DB_INDEX_CATALOG_ENTRY_T *p_entry = &(p_entries[i]);
+
+        is_read = (pread(fd, &(p_entry->key_length), sizeof(p_entry->key_length), offset) == sizeof(p_entry->key_length));
+        offset += sizeof(p_entry->key_length);
+        is_read = is_read && (pread(fd, &(p_entry->index_id_type), sizeof(p_entry->index_id_type), offset) == sizeof(p_entry->index_id_type));
+        offset += sizeof(p_entry->index_id_type);
+        is_read = is_read && (pread(fd, &(p_entry->is_covering), sizeof(p_entry->is_covering), offset) == sizeof(p_entry->is_covering));
+        offset += sizeof(p_entry->is_covering);
+
+        p_entry->p_key = is_read ? malloc(p_entry->key_length + 1) : NULL;
+        is_read = is_read && (p_entry->p_key != NULL) && (pread(fd, p_entry->p_key, p_entry->key_length, offset) == p_entry->key_length);
+        offset += p_entry->key_length;
+    }
+#else
+    fseek(p_db_index_catalog->file, 0, SEEK_SET);
+    if ((fread(&version, sizeof(version), 1, p_db_index_catalog->file) != 1) || (version == p_db_index_catalog->version))
+    {
+        return;
+    }
+
+    if (fread(&entry_num, sizeof(entry_num), 1, p_db_index_catalog->file) == 1)
+    {
+        p_entries = (entry_num > 0) ? calloc(entry_num, sizeof(DB_INDEX_CATALOG_ENTRY_T)) : NULL;
+        is_read = (entry_num == 0) || (p_entries != NULL);
+    }
+
+    for (uint32_t i = 0; is_read && (i < entry_num); i++)
+    {
+        DB_INDEX_CATALOG_ENTRY_T *p_entry = &(p_entries[i]);
+
+        is_read = (fread(&(p_entry->key_length), sizeof(p_entry->key_length), 1, p_db_index_catalog->file) == 1) &&
+                  (fread(&(p_entry->index_id_type), sizeof(p_entry->index_id_type), 1, p_db_index_catalog->file) == 1) &&
+                  (fread(&(p_entry->is_covering), sizeof(p_entry->is_covering), 1, p_db_index_catalog->file) == 1);
+        p_entry->p_key = is_read ? malloc(p_entry->key_length + 1) : NULL;
+        is_read = is_read && (p_entry->p_key != NULL) && (fread(p_entry->p_key, p_entry->key_length, 1, p_db_index_catalog->file) == 1);
+    }
+#endif
+
+    if (is_read == false)
+    {
+        // Keep the current catalog, it's reloaded by the next refresh.
+        free_db_index_catalog_entries(p_entries, entry_num);
+        return;
+    }
+
+    free_db_index_catalog_entries(p_db_index_catalog->p_entries, p_db_index_catalog->entry_num);
+    p_db_index_catalog->p_entries = p_entries;
+    p_db_index_catalog->entry_num = entry_num;
+    p_db_index_catalog->version = version;
 }
 
-void delete_db_data_handler_write_delete_flag(DB_SET_INFO_T *p_db_set_info, uint64_t db_block_tag, uint32_t deleted)
+// Return true if refresh_db_index_catalog() changes the catalog, the catalog file isn't opened or has another version.
+bool is_db_index_catalog_changed(DB_SET_INFO_T *p_db_set_info)
 {
-    FILE *p_db_set_file = p_db_set_info->file;
-    DB_SET_PROPERTIES_T *p_db_set_properties = &(p_db_set_info->db_set_properties);
-    off_t delete_flag_offset = get_db_block_offset(p_db_set_properties, db_block_tag) + offsetof(DB_BLOCK_T, deleted);
-    uint64_t current_time = (uint64_t)get_current_time();
-    off_t modified_time_offset = get_db_block_offset(p_db_set_properties, db_block_tag) + offsetof(DB_BLOCK_T, modified_time);
+    DB_INDEX_CATALOG_T *p_db_index_catalog = &(p_db_set_info->index_catalog);
+    uint64_t version = 0;
 
-#if IS_POSIX_API_SUPPORT
-    int fd = fileno(p_db_set_file);
+    if (p_db_index_catalog->file == NULL)
+    {
+        return true;
+    }
 
-    // write delete flag
-    pwrite(fd, &deleted, sizeof(deleted), delete_flag_offset);
-    // write modified time
-    pwrite(fd, &current_time, sizeof(current_time), modified_time_offset);
-#else  // IS_POSIX_API_SUPPORT
-    fseek(p_db_set_file, delete_flag_offset, SEEK_SET);
-    fwrite(&deleted, sizeof(deleted), 1, p_db_set_file);
+#if IS_POSIX_API_SUPPORT
+    if (pread(fileno(p_db_index_catalog->file), &version, sizeof(version), 0) != sizeof(version))
+#else
+    fseek(p_db_index_catalog->file, 0, SEEK_SET);
+    if (fread(&version, sizeof(version), 1, p_db_index_catalog->file) != 1)
+#endif
+    {
+        return false;
+    }
 
-    fseek(p_db_set_file, modified_time_offset, SEEK_SET);
-    fwrite(&current_time, sizeof(current_time), 1, p_db_set_file);
-#endif // IS_POSIX_API_SUPPORT
+    return (version != p_db_index_catalog->version);
 }
 
-void delete_db_data(DB_SET_INFO_T *p_db_set_info, DB_DATA_INFO_T *p_db_data_info, uint32_t db_data_num)
+// Write the catalog with a new version, the version is written at last.
+// Lock the set file before using this function.
+void write_db_index_catalog(DB_INDEX_CATALOG_T *p_db_index_catalog)
 {
-    DB_BLOCK_T db_block;
-    uint64_t block_tag = 0;
-    db_block_init(&db_block);
+    p_db_index_catalog->version++;
 
-    for (uint32_t i = 0; i < db_data_num; i++)
+#if IS_POSIX_API_SUPPORT
+    int fd = fileno(p_db_index_catalog->file);
+    off_t offset = sizeof(p_db_index_catalog->version) + sizeof(p_db_index_catalog->entry_num);
+
+    for (uint32_t i = 0; i < p_db_index_catalog->entry_num; i++)
     {
-        block_tag = p_db_data_info[i].start_db_block_tag;
+        DB_INDEX_CATALOG_ENTRY_T *p_entry = &(p_db_index_catalog->p_entries[i]);
+
+        pwrite(fd, &(p_entry->key_length), sizeof(p_entry->key_length), offset);
+        offset += sizeof(p_entry->key_length);
+        pwrite(fd, &(p_entry->index_id_type), sizeof(p_entry->index_id_type), offset);
+        offset += sizeof(p_entry->index_id_type);
+        pwrite(fd, &(p_entry->is_covering), sizeof(p_entry->is_covering), offset);
+        offset += sizeof(p_entry->is_covering);
+        pwrite(fd, p_entry->p_key, p_entry->key_length, offset);
+        offset += p_entry->key_length;
+    }
 
-        while (block_tag != 0)
-        {
-            read_db_block(p_db_set_info, block_tag, &db_block);
-            delete_db_data_handler_write_delete_flag(p_db_set_info, db_block.block_tag, 1);
-            // continue to the next block.
-            block_tag = db_block.next_block_tag;
-        }
+    pwrite(fd, &(p_db_index_catalog->entry_num), sizeof(p_db_index_catalog->entry_num), sizeof(p_db_index_catalog->version));
+    pwrite(fd, &(p_db_index_catalog->version), sizeof(p_db_index_catalog->version), 0);
+#else
+    fseek(p_db_index_catalog->file, sizeof(p_db_index_catalog->version) + sizeof(p_db_index_catalog->entry_num), SEEK_SET);
+    for (uint32_t i = 0; i < p_db_index_catalog->entry_num; i++)
+    {
+        DB_INDEX_CATALOG_ENTRY_T *p_entry = &(p_db_index_catalog->p_entries[i]);
+
+        fwrite(&(p_entry->key_length), sizeof(p_entry->key_length), 1, p_db_index_catalog->file);
+        fwrite(&(p_entry->index_id_type), sizeof(p_entry->index_id_type), 1, p_db_index_catalog->file);
+        fwrite(&(p_entry->is_covering), sizeof(p_entry->is_covering), 1, p_db_index_catalog->file);
+        fwrite(p_entry->p_key, p_entry->key_length, 1, p_db_index_catalog->file);
     }
+
+    fseek(p_db_index_catalog->file, sizeof(p_db_index_catalog->version), SEEK_SET);
+    fwrite(&(p_db_index_catalog->entry_num), sizeof(p_db_index_catalog->entry_num), 1, p_db_index_catalog->file);
+    fseek(p_db_index_catalog->file, 0, SEEK_SET);
+    fwrite(&(p_db_index_catalog->version), sizeof(p_db_index_catalog->version), 1, p_db_index_catalog->file);
+    fflush(p_db_index_catalog->file);
+#endif
 }
 
-#if ENABLE_DB_INDEX
-bool FacileDB_Api_Make_Record_Index(char *p_db_set_name, FACILEDB_RECORD_T *p_faciledb_record)
+// Add the index of the record key to the in-memory catalog, write_db_index_catalog() writes it into the catalog file.
+// key_length: bytes of p_key, the record key cut at the first '\0' or the columns of a composite index.
+bool add_db_index_catalog_entry(DB_INDEX_CATALOG_T *p_db_index_catalog, void *p_key, uint32_t key_length, INDEX_ID_TYPE_E index_id_type, bool is_covering)
 {
-    DB_SET_INFO_T *p_db_set_info = NULL;
-    DB_RECORD_INFO_T target_db_record;
-    uint32_t result_data_num = 0;
+    DB_INDEX_CATALOG_ENTRY_T *p_entries = realloc(p_db_index_catalog->p_entries, sizeof(DB_INDEX_CATALOG_ENTRY_T) * (p_db_index_catalog->entry_num + 1));
+    DB_INDEX_CATALOG_ENTRY_T *p_entry = NULL;
 
-    if (p_faciledb_record == NULL)
+    if (p_entries == NULL)
     {
-        // invalid input
         return false;
     }
+    p_db_index_catalog->p_entries = p_entries;
 
-    lock_db_context_sync();
-    if (check_db_context_status(DB_CONTEXT_STATUS_READY) == false)
+    p_entry = &(p_entries[p_db_index_catalog->entry_num]);
+    p_entry->p_key = malloc(key_length + 1);
+    if (p_entry->p_key == NULL)
     {
-        // db context is not ready
-        unlock_db_context_sync();
         return false;
     }
 
-    p_db_set_info = load_and_lock_db_set_info(p_db_set_name);
-    unlock_db_context_sync();
+    memcpy(p_entry->p_key, p_key, key_length);
+    p_entry->p_key[key_length] = '\0';
+    p_entry->key_length = key_length;
+    p_entry->index_id_type = index_id_type;
+    p_entry->is_covering = is_covering ? 1 : 0;
+    p_db_index_catalog->entry_num++;
 
-    db_record_info_init(&target_db_record);
-    shallow_assign_faciledb_record_to_db_record_info(&target_db_record, p_faciledb_record);
+    return true;
+}
 
-    db_set_info_sync_read_wait(p_db_set_info);
-    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READING);
-    db_set_info_file_lock_read(p_db_set_info);
-    unlock_db_set_info_sync(p_db_set_info);
+// Return the catalog entry of the record key, or NULL if the record key isn't indexed.
+// The composite indexes are queried by query_db_composite_index_catalog_entry().
+// The catalog is in memory, no file is accessed.
+DB_INDEX_CATALOG_ENTRY_T *query_db_index_catalog_entry(DB_SET_INFO_T *p_db_set_info, void *p_key, uint32_t key_size)
+{
+    DB_INDEX_CATALOG_T *p_db_index_catalog = &(p_db_set_info->index_catalog);
+    uint32_t key_length = strnlen((char *)p_key, key_size);
+
+    for (uint32_t i = 0; i < p_db_index_catalog->entry_num; i++)
+    {
+        DB_INDEX_CATALOG_ENTRY_T *p_entry = &(p_db_index_catalog->p_entries[i]);
 
-    result_data_num = make_db_record_index(p_db_set_info, &target_db_record);
+        if ((p_entry->index_id_type != INDEX_ID_TYPE_COMPOSITE) && (p_entry->key_length == key_length) && (memcmp(p_entry->p_key, p_key, key_length) == 0))
+        {
+            return p_entry;
+        }
+    }
 
-    lock_db_set_info_sync(p_db_set_info);
-    db_set_info_file_unlock_read(p_db_set_info);
-    update_db_set_info_status(p_db_set_info, DB_SET_INFO_STATUS_READY);
-    db_set_info_sync_read_unblock(p_db_set_info);
-    unlock_db_set_info_sync(p_db_set_info);
+    return NULL;
+}
+
+// Index id type of a composite index column of the record value type, strings are always ordered by their bytes.
+INDEX_ID_TYPE_E get_db_composite_column_index_id_type(FACILEDB_RECORD_VALUE_TYPE_E record_value_type)
+{
+    if (record_value_type == FACILEDB_RECORD_VALUE_TYPE_STRING)
+    {
+        return INDEX_ID_TYPE_STRING;
+    }
+
+    return get_db_index_id_type(record_value_type);
+}
+
+// Key of the composite index in the catalog: record_value_type (uint32), key_length (uint32) and the key of each column.
+// Return NULL if the buffer can't be allocated.
+uint8_t *set_db_composite_index_catalog_key(DB_RECORD_INFO_T *p_db_record_infos, uint32_t record_num, uint32_t *p_catalog_key_size)
+{
+    uint32_t catalog_key_size = 0;
+    uint8_t *p_catalog_key = NULL;
+    uint8_t *p_write = NULL;
 
-    if (result_data_num > 0)
+    for (uint32_t i = 0; i < record_num; i++)
     {
-        return true;
+        catalog_key_size += sizeof(uint32_t) * 2 + strnlen((char *)p_db_record_infos[i].db_record.p_key, p_db_record_infos[i].db_record_properties.key_size);
     }
-    else
+
+    p_catalog_key = malloc(catalog_key_size);
+    if (p_catalog_key == NULL)
     {
-        return false;
+        return NULL;
     }
+
+    p_write = p_catalog_key;
+    for (uint32_t i = 0; i < record_num; i++)
+    {
+        uint32_t record_value_type = p_db_record_infos[i].db_record_properties.record_value_type_32;
+        uint32_t key_length = strnlen((char *)p_db_record_infos[i].db_record.p_key, p_db_record_infos[i].db_record_properties.key_size);
+
+        memcpy(p_write, &record_value_type, sizeof(uint32_t));
+        memcpy(p_write + sizeof(uint32_t), &key_length, sizeof(uint32_t));
+        memcpy(p_write + sizeof(uint32_t) * 2, p_db_record_infos[i].db_record.p_key, key_length);
+        p_write += sizeof(uint32_t) * 2 + key_length;
+    }
+
+    *p_catalog_key_size = catalog_key_size;
+    return p_catalog_key;
 }
 
-// This function must be called after setting db_directory_path.
-bool get_db_index_directory_path(char *p_db_index_directory_path)
+// Parse the columns of the composite index from its catalog entry, return the number of the columns.
+// p_columns: the keys point into the catalog entry.
+uint32_t get_db_composite_index_columns(DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry, DB_COMPOSITE_COLUMN_T *p_columns)
 {
-    const char index_directory_suffix[] = "index/";
+    uint8_t *p_read = (uint8_t *)p_db_index_catalog_entry->p_key;
+    uint8_t *p_end = p_read + p_db_index_catalog_entry->key_length;
+    uint32_t column_num = 0;
 
-    if ((strlen(db_directory_path) + strlen(index_directory_suffix)) > INDEX_FILE_PATH_MAX_LENGTH)
+    while ((column_num < DB_COMPOSITE_INDEX_MAX_COLUMN_NUM) && ((p_read + sizeof(uint32_t) * 2) <= p_end))
     {
-        p_db_index_directory_path[0] = '\0';
-        return false;
-    }
+        DB_COMPOSITE_COLUMN_T *p_column = &(p_columns[column_num]);
 
-    strncpy(p_db_index_directory_path, db_directory_path, INDEX_FILE_PATH_MAX_LENGTH);
-    strcat(p_db_index_directory_path, index_directory_suffix);
-    p_db_index_directory_path[INDEX_FILE_PATH_MAX_LENGTH] = '\0';
+        memcpy(&(p_column->record_value_type_32), p_read, sizeof(uint32_t));
+        memcpy(&(p_column->key_length), p_read + sizeof(uint32_t), sizeof(uint32_t));
+        p_column->p_key = (char *)p_read + sizeof(uint32_t) * 2;
+        if ((uint8_t *)p_column->p_key + p_column->key_length > p_end)
+        {
+            break;
+        }
 
-    return true;
+        p_read = (uint8_t *)p_column->p_key + p_column->key_length;
+        column_num++;
+    }
+
+    return column_num;
 }
 
-// index key defined as the file that contains the index data.
-// Default index key is db_set_name + "_" + p_key (DB_RECORD_T).
-// TODO: db_set_name is a fake string that doesn't contain '\0' at the end, and p_key is not expected to be a string all the time.
-// TODO: to_printable or toString
-char *set_db_index_key(void *db_set_name, uint32_t set_name_size, void *p_key, uint32_t key_size)
+// index key of the composite index: db_set_name + "+" + key of each column separated by "+".
+char *set_db_composite_index_key(DB_SET_PROPERTIES_T *p_db_set_properties, DB_COMPOSITE_COLUMN_T *p_columns, uint32_t column_num)
 {
-    // TODO: toString(p_key)
-    char *p_db_index_key = calloc(set_name_size + key_size + 2, sizeof(char));
+    uint32_t index_key_size = p_db_set_properties->set_name_size + 1;
+    char *p_db_index_key = NULL;
+    char *p_write = NULL;
 
+    for (uint32_t i = 0; i < column_num; i++)
+    {
+        index_key_size += p_columns[i].key_length + 1;
+    }
+
+    p_db_index_key = calloc(index_key_size, sizeof(char));
     if (p_db_index_key == NULL)
     {
         return NULL;
     }
 
-    memcpy(p_db_index_key, db_set_name, set_name_size);
-    p_db_index_key[set_name_size] = '_';
-    memcpy(p_db_index_key + set_name_size + 1, p_key, key_size);
-
-    p_db_index_key[set_name_size + key_size + 1] = '\0';
+    memcpy(p_db_index_key, p_db_set_properties->p_set_name, p_db_set_properties->set_name_size);
+    p_write = p_db_index_key + p_db_set_properties->set_name_size;
+    for (uint32_t i = 0; i < column_num; i++)
+    {
+        *p_write = '+';
+        memcpy(p_write + 1, p_columns[i].p_key, p_columns[i].key_length);
+        p_write += p_columns[i].key_length + 1;
+    }
+    *p_write = '\0';
 
     return p_db_index_key;
 }
 
-INDEX_ID_TYPE_E get_db_index_id_type(FACILEDB_RECORD_VALUE_TYPE_E record_value_type)
+// Return the first record of the column key and value type, or NULL if the records don't have the column.
+DB_RECORD_INFO_T *find_db_composite_column_record(DB_COMPOSITE_COLUMN_T *p_column, DB_RECORD_INFO_T *p_db_record_infos, uint32_t record_num)
 {
-    switch (record_value_type)
+    for (uint32_t i = 0; i < record_num; i++)
     {
-    case FACILEDB_RECORD_VALUE_TYPE_UINT32:
-        return INDEX_ID_TYPE_UINT32;
-    case FACILEDB_RECORD_VALUE_TYPE_STRING:
-        return INDEX_ID_TYPE_HASH;
-    default:
-        return INDEX_ID_TYPE_INVALID;
+        DB_RECORD_INFO_T *p_db_record_info = &(p_db_record_infos[i]);
+
+        if ((p_db_record_info->db_record_properties.record_value_type == p_column->record_value_type) &&
+            (strnlen((char *)p_db_record_info->db_record.p_key, p_db_record_info->db_record_properties.key_size) == p_column->key_length) &&
+            (memcmp(p_db_record_info->db_record.p_key, p_column->p_key, p_column->key_length) == 0))
+        {
+            return p_db_record_info;
+        }
+    }
+
+    return NULL;
+}
+
+// Encode the leading columns found in the records, the encoded bytes are allocated into *pp_encoded_columns.
+// Return the number of the encoded leading columns, nothing is allocated if it's 0.
+uint32_t encode_db_composite_columns(DB_COMPOSITE_COLUMN_T *p_columns, uint32_t column_num, DB_RECORD_INFO_T *p_db_record_infos, uint32_t record_num, uint8_t **pp_encoded_columns, uint32_t *p_encoded_columns_size)
+{
+    DB_RECORD_INFO_T *p_column_records[DB_COMPOSITE_INDEX_MAX_COLUMN_NUM];
+    uint32_t leading_column_num = 0, encoded_columns_size = 0;
+    uint8_t *p_encoded_columns = NULL;
+
+    while (leading_column_num < column_num)
+    {
+        DB_RECORD_INFO_T *p_column_record = find_db_composite_column_record(&(p_columns[leading_column_num]), p_db_record_infos, record_num);
+
+        if (p_column_record == NULL)
+        {
+            break;
+        }
+        p_column_records[leading_column_num] = p_column_record;
+        encoded_columns_size += Index_Id_Type_Get_Composite_Column_Max_Size(p_column_record->db_record_properties.value_size);
+        leading_column_num++;
+    }
+
+    if ((leading_column_num == 0) || ((p_encoded_columns = malloc(encoded_columns_size)) == NULL))
+    {
+        return 0;
+    }
+
+    encoded_columns_size = 0;
+    for (uint32_t i = 0; i < leading_column_num; i++)
+    {
+        DB_RECORD_INFO_T *p_column_record = p_column_records[i];
+
+        encoded_columns_size += Index_Id_Type_Encode_Composite_Column(p_encoded_columns + encoded_columns_size, get_db_composite_column_index_id_type(p_column_record->db_record_properties.record_value_type),
+                                                                      p_column_record->db_record.p_value, p_column_record->db_record_properties.value_size);
     }
+
+    *pp_encoded_columns = p_encoded_columns;
+    *p_encoded_columns_size = encoded_columns_size;
+    return leading_column_num;
 }
 
-uint32_t make_db_record_index(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_db_record_info)
+// Make the composite index over the keys of the records in order.
+// Each data is indexed by its leading columns, so it's found by the prefix of them, the data without the first key aren't indexed.
+// Return the number of the indexed data.
+uint32_t make_db_composite_record_index(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_db_record_infos, uint32_t record_num)
 {
+    DB_INDEX_CATALOG_T *p_db_index_catalog = &(p_db_set_info->index_catalog);
+    DB_INDEX_CATALOG_ENTRY_T db_index_catalog_entry;
+    DB_COMPOSITE_COLUMN_T columns[DB_COMPOSITE_INDEX_MAX_COLUMN_NUM];
+    uint32_t column_num = 0;
     char *p_index_key = NULL;
-    // array of db_data_info
+    DB_SET_SNAPSHOT_T db_set_snapshot;
     DB_DATA_INFO_T *p_db_result_data = NULL;
     uint32_t result_data_num = 0;
+    INDEX_ID_COMPOSITE_T *p_index_ids = NULL;
+    DB_INDEX_PAYLOAD_T *p_db_index_payloads = NULL;
+    uint32_t element_num = 0;
 
-    // check if index existed.
-    p_index_key = set_db_index_key(p_db_set_info->db_set_properties.p_set_name, p_db_set_info->db_set_properties.set_name_size, p_db_record_info->db_record.p_key, p_db_record_info->db_record_properties.key_size);
-    if (!Index_Api_Index_Key_Exist(p_index_key))
+    db_index_catalog_entry.p_key = (char *)set_db_composite_index_catalog_key(p_db_record_infos, record_num, &(db_index_catalog_entry.key_length));
+    if (db_index_catalog_entry.p_key == NULL)
     {
-        // search for all matched db_records
-        p_db_result_data = search_db_data(p_db_set_info, p_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_ANY, &result_data_num);
+        return 0;
+    }
 
-        for (uint32_t i = 0; i < result_data_num; i++)
+    for (uint32_t i = 0; i < p_db_index_catalog->entry_num; i++)
+    {
+        DB_INDEX_CATALOG_ENTRY_T *p_entry = &(p_db_index_catalog->p_entries[i]);
+
+        if ((p_entry->index_id_type == INDEX_ID_TYPE_COMPOSITE) && (p_entry->key_length == db_index_catalog_entry.key_length) &&
+            (memcmp(p_entry->p_key, db_index_catalog_entry.p_key, db_index_catalog_entry.key_length) == 0))
         {
-            for (uint32_t j = 0; j < p_db_result_data[i].record_num; j++)
-            {
-                if ((p_db_result_data[i].p_db_record_info[j].db_record_properties.key_size == p_db_record_info->db_record_properties.key_size) &&
-                    (memcmp(p_db_result_data[i].p_db_record_info[j].db_record.p_key, p_db_record_info->db_record.p_key, p_db_record_info->db_record_properties.key_size) == 0) &&
-                    (p_db_result_data[i].p_db_record_info[j].db_record_properties.record_value_type == p_db_record_info->db_record_properties.record_value_type))
-                {
-                    DB_INDEX_PAYLOAD_T db_index_payload = {
-                        .data_tag = p_db_result_data[i].data_tag,
-                        .start_db_block_tag = p_db_result_data[i].start_db_block_tag};
-                    insert_db_record_index(p_db_set_info, &(p_db_result_data[i].p_db_record_info[j]), &db_index_payload);
+            // Already in the catalog.
+            free(db_index_catalog_entry.p_key);
+            return 0;
+        }
+    }
 
-                    break;
-                }
-            }
+    column_num = get_db_composite_index_columns(&db_index_catalog_entry, columns);
+    p_index_key = set_db_composite_index_key(&(p_db_set_info->db_set_properties), columns, column_num);
 
-            // free resource
-            free_db_data_info_resources(&(p_db_result_data[i]));
+    // The data with the first key are read sequentially, the single key indexes don't return all of them.
+    if (p_index_key != NULL)
+    {
+        get_db_set_latest_snapshot(p_db_set_info, &db_set_snapshot);
+        p_db_result_data = search_db_data_sequential(p_db_set_info, &db_set_snapshot, &(p_db_record_infos[0]), FACILEDB_RECORD_VALUE_TYPE_COMPARE_ANY, &result_data_num);
+    }
+
+    if (result_data_num > 0)
+    {
+        p_index_ids = malloc(sizeof(INDEX_ID_COMPOSITE_T) * result_data_num);
+        p_db_index_payloads = calloc(result_data_num, sizeof(DB_INDEX_PAYLOAD_T));
+    }
+
+    for (uint32_t i = 0; i < result_data_num; i++)
+    {
+        uint8_t *p_encoded_columns = NULL;
+        uint32_t encoded_columns_size = 0;
+
+        if ((p_index_ids != NULL) && (p_db_index_payloads != NULL) &&
+            (encode_db_composite_columns(columns, column_num, p_db_result_data[i].p_db_record_info, p_db_result_data[i].record_num, &p_encoded_columns, &encoded_columns_size) > 0))
+        {
+            Index_Id_Type_Set_Composite(&(p_index_ids[element_num]), p_encoded_columns, encoded_columns_size);
+            p_db_index_payloads[element_num].data_tag = p_db_result_data[i].data_tag;
+            p_db_index_payloads[element_num].start_db_block_tag = p_db_result_data[i].start_db_block_tag;
+            element_num++;
+        }
+        free(p_encoded_columns);
+
+        // free resource
+        free_db_data_info_resources(&(p_db_result_data[i]));
+        free(p_db_result_data[i].p_db_record_info);
+    }
+
+    if (element_num > 0)
+    {
+        Index_Api_Bulk_Build(p_index_key, INDEX_ID_TYPE_COMPOSITE, p_index_ids, p_db_index_payloads, sizeof(DB_INDEX_PAYLOAD_T), element_num);
+        if (add_db_index_catalog_entry(p_db_index_catalog, db_index_catalog_entry.p_key, db_index_catalog_entry.key_length, INDEX_ID_TYPE_COMPOSITE, false))
+        {
+            write_db_index_catalog(p_db_index_catalog);
         }
     }
 
+    free(db_index_catalog_entry.p_key);
     free(p_index_key);
     free(p_db_result_data);
+    free(p_index_ids);
+    free(p_db_index_payloads);
 
-    return result_data_num;
+    return element_num;
 }
 
-void insert_db_record_index(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_db_record_info, DB_INDEX_PAYLOAD_T *p_db_index_payload)
+// Insert the data into the composite indexes whose first key is in the data.
+// The deleted data are kept in them for the earlier snapshots like the other indexes, see delete_db_data().
+void update_db_composite_record_indexes(DB_SET_INFO_T *p_db_set_info, DB_DATA_INFO_T *p_db_data_info, DB_INDEX_PAYLOAD_T *p_db_index_payload)
 {
-    // TODO: toString(p_set_name) and toString(p_key)
-    char *p_index_key = set_db_index_key(p_db_set_info->db_set_properties.p_set_name, p_db_set_info->db_set_properties.set_name_size, p_db_record_info->db_record.p_key, p_db_record_info->db_record_properties.key_size);
-    void *p_record_value = p_db_record_info->db_record.p_value;
-    void *p_index_id = NULL;
-    INDEX_ID_TYPE_E index_id_type = get_db_index_id_type(p_db_record_info->db_record_properties.record_value_type);
-    HASH_VALUE_T hash_value = 0;
+    DB_INDEX_CATALOG_T *p_db_index_catalog = &(p_db_set_info->index_catalog);
 
-    if (index_id_type != INDEX_ID_TYPE_INVALID)
+    for (uint32_t i = 0; i < p_db_index_catalog->entry_num; i++)
     {
-        // Setup p_index_id based on the index_id_type.
-        if (index_id_type == INDEX_ID_TYPE_HASH)
+        DB_INDEX_CATALOG_ENTRY_T *p_entry = &(p_db_index_catalog->p_entries[i]);
+        DB_COMPOSITE_COLUMN_T columns[DB_COMPOSITE_INDEX_MAX_COLUMN_NUM];
+        uint32_t column_num = 0, encoded_columns_size = 0;
+        uint8_t *p_encoded_columns = NULL;
+        INDEX_ID_COMPOSITE_T index_id;
+        char *p_index_key = NULL;
+
+        if (p_entry->index_id_type != INDEX_ID_TYPE_COMPOSITE)
         {
-            // hash the value
-            hash_value = Hash(p_record_value, p_db_record_info->db_record_properties.value_size);
-            p_index_id = &hash_value;
+            continue;
         }
-        else
+
+        column_num = get_db_composite_index_columns(p_entry, columns);
+        if (encode_db_composite_columns(columns, column_num, p_db_data_info->p_db_record_info, p_db_data_info->record_num, &p_encoded_columns, &encoded_columns_size) > 0)
         {
-            p_index_id = p_record_value;
+            Index_Id_Type_Set_Composite(&index_id, p_encoded_columns, encoded_columns_size);
+            p_index_key = set_db_composite_index_key(&(p_db_set_info->db_set_properties), columns, column_num);
+            if (p_index_key != NULL)
+            {
+                Index_Api_Insert_Element(p_index_key, &index_id, INDEX_ID_TYPE_COMPOSITE, p_db_index_payload, sizeof(DB_INDEX_PAYLOAD_T));
+            }
         }
 
-        /*
-        **  p_index_key: p_db_set_name + p_key (DB_RECORD_T)
-        **  p_index_id: p_value (DB_RECORD_T)
-        **  index_id_type: type (uint32 / string / ...)
-        **  p_index_payload: a structure with the data offset / data tag / data start block tag / ...
-        **  payload_size: sizeof the payload
-        **  return value: pointer of the payload array, size of each element size is INDEX_PAYLOAD_SIZE
-        */
-        Index_Api_Insert_Element(p_index_key, p_index_id, index_id_type, p_db_index_payload, sizeof(DB_INDEX_PAYLOAD_T));
+        free(p_encoded_columns);
+        free(p_index_key);
     }
-
-    free(p_index_key);
 }
 
-// return value: an array of DB_DATA_INFO_T, whose length is *p_result_db_data_info_num.
-DB_DATA_INFO_T *search_db_data_indexed(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_target_db_record_info, FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E compare_type, uint32_t *p_result_db_data_info_num)
+// Return the composite index whose leading columns are covered by the most target records, or NULL if no composite index can be searched by them.
+// *p_leading_column_num: number of the covered leading columns.
+DB_INDEX_CATALOG_ENTRY_T *query_db_composite_index_catalog_entry(DB_SET_INFO_T *p_db_set_info, DB_RECORD_INFO_T *p_target_db_record_infos, uint32_t target_num, uint32_t *p_leading_column_num)
 {
-    char *p_index_key = set_db_index_key(p_db_set_info->db_set_properties.p_set_name, p_db_set_info->db_set_properties.set_name_size, p_target_db_record_info->db_record.p_key, p_target_db_record_info->db_record_properties.key_size);
-    void *p_record_value = p_target_db_record_info->db_record.p_value;
-    void *p_index_id = NULL;
-    HASH_VALUE_T hash_value = 0;
-    INDEX_ID_TYPE_E index_id_type = get_db_index_id_type(p_target_db_record_info->db_record_properties.record_value_type);
-    DB_INDEX_PAYLOAD_T *p_result_index_payloads = NULL;
-    DB_DATA_INFO_T *p_result_db_data_infos = NULL;
-    uint32_t result_length = 0;
-    uint32_t match_length = 0;
+    DB_INDEX_CATALOG_T *p_db_index_catalog = &(p_db_set_info->index_catalog);
+    DB_INDEX_CATALOG_ENTRY_T *p_best_entry = NULL;
+    uint32_t best_leading_column_num = 0, best_column_num = 0;
 
-    if (index_id_type != INDEX_ID_TYPE_INVALID)
+    for (uint32_t i = 0; i < p_db_index_catalog->entry_num; i++)
     {
-        // Setup p_index_id based on the index_id_type.
-        if (index_id_type == INDEX_ID_TYPE_HASH)
+        DB_INDEX_CATALOG_ENTRY_T *p_entry = &(p_db_index_catalog->p_entries[i]);
+        DB_COMPOSITE_COLUMN_T columns[DB_COMPOSITE_INDEX_MAX_COLUMN_NUM];
+        uint32_t column_num = 0, leading_column_num = 0;
+
+        if (p_entry->index_id_type != INDEX_ID_TYPE_COMPOSITE)
         {
-            // hash the value
-            hash_value = Hash(p_record_value, p_target_db_record_info->db_record_properties.value_size);
-            p_index_id = &hash_value;
+            continue;
         }
-        else
+
+        column_num = get_db_composite_index_columns(p_entry, columns);
+        while ((leading_column_num < column_num) && (find_db_composite_column_record(&(columns[leading_column_num]), p_target_db_record_infos, target_num) != NULL))
         {
-            p_index_id = p_record_value;
+            leading_column_num++;
         }
 
-        // if(compare_type == FACILEDB_RECORD_VALUE_TYPE_COMPARE_ANY)
-        // {
-        //     // TODO: compare_any, aka all value
-        // }
-        if (compare_type == FACILEDB_RECORD_VALUE_TYPE_COMPARE_EQUAL)
+        if (leading_column_num > best_leading_column_num)
         {
-            p_result_index_payloads = (DB_INDEX_PAYLOAD_T *)Index_Api_Search_Equal(p_index_key, p_index_id, index_id_type, &result_length);
+            p_best_entry = p_entry;
+            best_leading_column_num = leading_column_num;
+            best_column_num = column_num;
         }
+    }
 
-        // Transfer db_index_payloads to db_data_infos
-        if (result_length > 0)
+    if ((p_best_entry != NULL) && (best_leading_column_num < best_column_num))
+    {
+        // The leading columns are searched by the range, which isn't supported by the hash indexes.
+        DB_COMPOSITE_COLUMN_T columns[DB_COMPOSITE_INDEX_MAX_COLUMN_NUM];
+        char *p_index_key = set_db_composite_index_key(&(p_db_set_info->db_set_properties), columns, get_db_composite_index_columns(p_best_entry, columns));
+
+        if ((p_index_key == NULL) || (Index_Api_Get_Index_Structure(p_index_key) != INDEX_STRUCTURE_BTREE))
         {
-            p_result_db_data_infos = calloc(result_length, sizeof(DB_DATA_INFO_T));
+            p_best_entry = NULL;
+            best_leading_column_num = 0;
+        }
+        free(p_index_key);
+    }
 
-            for (uint32_t i = 0; i < result_length; i++)
-            {
-                DB_BLOCK_T db_block;
-                DB_DATA_INFO_T read_db_data_info;
-                bool record_match = false;
+    *p_leading_column_num = best_leading_column_num;
+    return p_best_entry;
+}
 
-                db_data_info_init(&read_db_data_info);
-                db_block_init(&db_block);
+// Search by the leading columns of the composite index covered by the target records.
+// All the columns are searched by the index id, and the leading columns are searched by the range of their prefix.
+// return value: an array of DB_DATA_INFO_T matching all the target records, whose length is *p_result_db_data_info_num.
+DB_DATA_INFO_T *search_db_data_composite(DB_SET_INFO_T *p_db_set_info, DB_SET_SNAPSHOT_T *p_db_set_snapshot, DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry, DB_RECORD_INFO_T *p_target_db_record_infos, uint32_t target_num, uint32_t *p_result_db_data_info_num)
+{
+    DB_COMPOSITE_COLUMN_T columns[DB_COMPOSITE_INDEX_MAX_COLUMN_NUM];
+    uint32_t column_num = get_db_composite_index_columns(p_db_index_catalog_entry, columns);
+    uint32_t leading_column_num = 0, encoded_columns_size = 0;
+    uint8_t *p_encoded_columns = NULL;
+    char *p_index_key = set_db_composite_index_key(&(p_db_set_info->db_set_properties), columns, column_num);
+    DB_INDEX_PAYLOAD_T *p_result_index_payloads = NULL;
+    DB_DATA_INFO_T *p_result_db_data_infos = NULL;
+    uint32_t result_length = 0, match_length = 0;
 
-                // read attribute only for checking delete flag and first block flag.
-                read_db_block_attributes(p_db_set_info, p_result_index_payloads[i].start_db_block_tag, &db_block);
+    leading_column_num = encode_db_composite_columns(columns, column_num, p_target_db_record_infos, target_num, &p_encoded_columns, &encoded_columns_size);
+    if ((p_index_key != NULL) && (leading_column_num == column_num))
+    {
+        INDEX_ID_COMPOSITE_T index_id;
 
-                if (db_block.deleted || db_block.prev_block_tag != 0)
-                {
-                    continue;
-                }
+        Index_Id_Type_Set_Composite(&index_id, p_encoded_columns, encoded_columns_size);
+        p_result_index_payloads = (DB_INDEX_PAYLOAD_T *)Index_Api_Search_Equal(p_index_key, &index_id, INDEX_ID_TYPE_COMPOSITE, &result_length);
+    }
+    else if ((p_index_key != NULL) && (leading_column_num > 0))
+    {
+        INDEX_ID_COMPOSITE_T lower_index_id, upper_index_id;
 
-                // Read the whole block and next blocks if they exists. The buffers will be allocated, and the record content will be copied into the record_info
-                extract_db_data_info_from_db_blocks(&read_db_data_info, p_result_index_payloads[i].start_db_block_tag, p_db_set_info);
+        Index_Id_Type_Set_Composite_Prefix_Range(&lower_index_id, &upper_index_id, p_encoded_columns, encoded_columns_size);
+        p_result_index_payloads = (DB_INDEX_PAYLOAD_T *)Index_Api_Search_Range(p_index_key, &lower_index_id, &upper_index_id, INDEX_ID_TYPE_COMPOSITE, &result_length);
+    }
 
-                // Compare again to prevent collision.
-                for (uint32_t record_idx = 0; record_idx < read_db_data_info.record_num; record_idx++)
-                {
-                    if (p_target_db_record_info->db_record_properties.key_size == read_db_data_info.p_db_record_info[record_idx].db_record_properties.key_size &&
-                        memcmp(read_db_data_info.p_db_record_info[record_idx].db_record.p_key, p_target_db_record_info->db_record.p_key, p_target_db_record_info->db_record_properties.key_size) == 0 &&
-                        p_target_db_record_info->db_record_properties.record_value_type == read_db_data_info.p_db_record_info[record_idx].db_record_properties.record_value_type &&
-                        // value size comparison doesn't need (?)
-                        (compare_type == FACILEDB_RECORD_VALUE_TYPE_COMPARE_ANY || Faciledb_Record_Value_Type_Compare(p_target_db_record_info->db_record_properties.record_value_type, read_db_data_info.p_db_record_info[record_idx].db_record.p_value, p_target_db_record_info->db_record.p_value) == compare_type))
-                    {
-                        record_match = true;
-                        break;
-                    }
-                }
+    if (result_length > 0)
+    {
+        p_result_db_data_infos = calloc(result_length, sizeof(DB_DATA_INFO_T));
+    }
 
-                if (record_match)
-                {
-                    db_data_info_init(&(p_result_db_data_infos[match_length]));
-                    shallow_copy_db_data_info(&(p_result_db_data_infos[match_length]), &read_db_data_info);
-                    match_length++;
+    for (uint32_t i = 0; (p_result_db_data_infos != NULL) && (i < result_length); i++)
+    {
+        DB_BLOCK_T db_block;
+        DB_DATA_INFO_T read_db_data_info;
 
-                    // Because the data info resources still in-used for result, don't free data info resources here.
-                }
-                else
-                {
-                    free_db_data_info_resources(&read_db_data_info);
-                }
-            }
+        db_data_info_init(&read_db_data_info);
+        db_block_init(&db_block);
 
-            free(p_result_index_payloads);
-            result_length = 0;
+        // The data appended after the snapshot may be indexed already.
+        if (p_result_index_payloads[i].start_db_block_tag > p_db_set_snapshot->block_num)
+        {
+            continue;
+        }
+
+        // read attribute only for checking delete flag and first block flag.
+        read_db_block_attributes(p_db_set_info, p_result_index_payloads[i].start_db_block_tag, &db_block);
+        if (is_db_block_visible(p_db_set_snapshot, p_result_index_payloads[i].start_db_block_tag, db_block.deleted) == false || db_block.prev_block_tag != 0)
+        {
+            continue;
+        }
+        extract_db_data_info_from_db_blocks(&read_db_data_info, p_result_index_payloads[i].start_db_block_tag, p_db_set_info);
+
+        // Compare again, the prefix range and the hash of the index ids may match the other values.
+        if (is_db_data_matched(&read_db_data_info, p_target_db_record_infos, target_num))
+        {
+            db_data_info_init(&(p_result_db_data_infos[match_length]));
+            shallow_copy_db_data_info(&(p_result_db_data_infos[match_length]), &read_db_data_info);
+            match_length++;
+        }
+        else
+        {
+            free_db_data_info_resources(&read_db_data_info);
+            free(read_db_data_info.p_db_record_info);
         }
     }
 
+    Index_Api_Free_Search_Result(p_result_index_payloads);
+    free(p_encoded_columns);
     free(p_index_key);
+
     *p_result_db_data_info_num = match_length;
     return p_result_db_data_infos;
 }
+
+// Estimate the number of data found by the index of the target record.
+// *p_is_covered: the index covers all the records of the data, its covering entries are read instead of the blocks.
+uint64_t estimate_db_indexed_data_num(DB_SET_INFO_T *p_db_set_info, DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry, DB_RECORD_INFO_T *p_target_db_record_info, INDEX_ID_TYPE_E index_id_type, bool *p_is_covered)
+{
+    char *p_index_key = set_db_index_key(p_db_set_info->db_set_properties.p_set_name, p_db_set_info->db_set_properties.set_name_size, p_target_db_record_info->db_record.p_key, p_target_db_record_info->db_record_properties.key_size);
+    DB_INDEX_ID_BUFFER_T index_id_buffer;
+    void *p_index_id = get_db_record_index_id(p_target_db_record_info, index_id_type, &index_id_buffer);
+    uint64_t estimated_data_num = 0;
+
+    *p_is_covered = false;
+    if (p_index_key == NULL)
+    {
+        return 0;
+    }
+
+    if (p_db_index_catalog_entry->is_covering)
+    {
+        DB_COVERING_PROPERTIES_T db_covering_properties;
+        FILE *p_covering_file = NULL;
+
+        db_covering_properties_init(&db_covering_properties);
+        p_covering_file = open_db_covering_file(p_index_key, &db_covering_properties);
+        if (p_covering_file != NULL)
+        {
+            *p_is_covered = (db_covering_properties.covered_key_num == 0);
+            fclose(p_covering_file);
+            free_db_covering_properties_resources(&db_covering_properties);
+        }
+    }
+
+    estimated_data_num = Index_Api_Estimate_Range(p_index_key, p_index_id, p_index_id, index_id_type);
+    free(p_index_key);
+    return estimated_data_num;
+}
+
+// Estimate the number of data found by the composite index, in the same way as search_db_data_composite().
+uint64_t estimate_db_composite_data_num(DB_SET_INFO_T *p_db_set_info, DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry, DB_RECORD_INFO_T *p_target_db_record_infos, uint32_t target_num)
+{
+    DB_COMPOSITE_COLUMN_T columns[DB_COMPOSITE_INDEX_MAX_COLUMN_NUM];
+    uint32_t column_num = get_db_composite_index_columns(p_db_index_catalog_entry, columns);
+    uint32_t leading_column_num = 0, encoded_columns_size = 0;
+    uint8_t *p_encoded_columns = NULL;
+    char *p_index_key = set_db_composite_index_key(&(p_db_set_info->db_set_properties), columns, column_num);
+    uint64_t estimated_data_num = 0;
+
+    leading_column_num = encode_db_composite_columns(columns, column_num, p_target_db_record_infos, target_num, &p_encoded_columns, &encoded_columns_size);
+    if ((p_index_key != NULL) && (leading_column_num == column_num))
+    {
+        INDEX_ID_COMPOSITE_T index_id;
+
+        Index_Id_Type_Set_Composite(&index_id, p_encoded_columns, encoded_columns_size);
+        estimated_data_num = Index_Api_Estimate_Range(p_index_key, &index_id, &index_id, INDEX_ID_TYPE_COMPOSITE);
+    }
+    else if ((p_index_key != NULL) && (leading_column_num > 0))
+    {
+        INDEX_ID_COMPOSITE_T lower_index_id, upper_index_id;
+
+        Index_Id_Type_Set_Composite_Prefix_Range(&lower_index_id, &upper_index_id, p_encoded_columns, encoded_columns_size);
+        estimated_data_num = Index_Api_Estimate_Range(p_index_key, &lower_index_id, &upper_index_id, INDEX_ID_TYPE_COMPOSITE);
+    }
+
+    free(p_encoded_columns);
+    free(p_index_key);
+    return estimated_data_num;
+}
 #endif // ENABLE_DB_INDEX
@@ -12,6 +12,10 @@
 FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E record_value_type_hash_compare(void *value1, void *value2);
 FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E record_value_type_uint32_compare(void *value1, void *value2);
 FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E record_value_type_int32_compare(void *value1, void *value2);
+FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E record_value_type_uint64_compare(void *value1, void *value2);
+FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E record_value_type_int64_compare(void *value1, void *value2);
+FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E record_value_type_float_compare(void *value1, void *value2);
+FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E record_value_type_double_compare(void *value1, void *value2);
 FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E record_value_type_string_compare(void *value1, void *value2);
 
 static const uint32_t record_value_type_size_table[] = {
@@ -31,6 +35,16 @@ FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E Faciledb_Record_Value_Type_Compare(F
             return record_value_type_hash_compare(value1, value2);
         case FACILEDB_RECORD_VALUE_TYPE_UINT32:
             return record_value_type_uint32_compare(value1, value2);
+        case FACILEDB_RECORD_VALUE_TYPE_INT32:
+            return record_value_type_int32_compare(value1, value2);
+        case FACILEDB_RECORD_VALUE_TYPE_UINT64:
+            return record_value_type_uint64_compare(value1, value2);
+        case FACILEDB_RECORD_VALUE_TYPE_INT64:
+            return record_value_type_int64_compare(value1, value2);
+        case FACILEDB_RECORD_VALUE_TYPE_FLOAT:
+            return record_value_type_float_compare(value1, value2);
+        case FACILEDB_RECORD_VALUE_TYPE_DOUBLE:
+            return record_value_type_double_compare(value1, value2);
         case FACILEDB_RECORD_VALUE_TYPE_STRING:
             return record_value_type_string_compare(value1, value2);
         default:
@@ -135,6 +149,63 @@ FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E record_value_type_uint64_compare(voi
     }
 }
 
+FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E record_value_type_int64_compare(void *value1, void *value2)
+{
+    int64_t val_1 = *(int64_t *)value1, val_2 = *(int64_t *)value2;
+
+    if (val_1 > val_2)
+    {
+        return FACILEDB_RECORD_VALUE_TYPE_COMPARE_LEFT_GREATER;
+    }
+    else if (val_1 < val_2)
+    {
+        return FACILEDB_RECORD_VALUE_TYPE_COMPARE_RIGHT_GREATER;
+    }
+    else
+    {
+        // val_1 == val_2
+        return FACILEDB_RECORD_VALUE_TYPE_COMPARE_EQUAL;
+    }
+}
+
+FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E record_value_type_float_compare(void *value1, void *value2)
+{
+    float val_1 = *(float *)value1, val_2 = *(float *)value2;
+
+    if (val_1 > val_2)
+    {
+        return FACILEDB_RECORD_VALUE_TYPE_COMPARE_LEFT_GREATER;
+    }
+    else if (val_1 < val_2)
+    {
+        return FACILEDB_RECORD_VALUE_TYPE_COMPARE_RIGHT_GREATER;
+    }
+    else
+    {
+        // val_1 == val_2
+        return FACILEDB_RECORD_VALUE_TYPE_COMPARE_EQUAL;
+    }
+}
+
+FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E record_value_type_double_compare(void *value1, void *value2)
+{
+    double val_1 = *(double *)value1, val_2 = *(double *)value2;
+
+    if (val_1 > val_2)
+    {
+        return FACILEDB_RECORD_VALUE_TYPE_COMPARE_LEFT_GREATER;
+    }
+    else if (val_1 < val_2)
+    {
+        return FACILEDB_RECORD_VALUE_TYPE_COMPARE_RIGHT_GREATER;
+    }
+    else
+    {
+        // val_1 == val_2
+        return FACILEDB_RECORD_VALUE_TYPE_COMPARE_EQUAL;
+    }
+}
+
 FACILEDB_RECORD_VALUE_TYPE_COMPARE_RESULT_E record_value_type_string_compare(void *value1, void *value2)
 {
     int32_t str_cmp_result = strcmp((char *)value1, (char *)value2);
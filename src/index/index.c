@@ -17,19 +17,85 @@
 #if IS_POSIX_API_SUPPORT
 #include <fcntl.h>
 #include <pthread.h>
+#include <stdatomic.h>
 #else
 // #error "POSIX API is not supported. Please use a POSIX compliant system."
 #endif
 
 #include "index.h"
 #include "index_id_type.h"
+#include "index_id_search.h"
+#include "hash.h"
 
+// Max number of index files kept open at the same time, the number in use is set by Index_Api_Set_Open_Index_File_Num().
 #ifndef INDEX_INFO_INSTANCE_NUM
-#define INDEX_INFO_INSTANCE_NUM (1)
+#define INDEX_INFO_INSTANCE_NUM (8)
 #endif
 
+// Number of hash buckets of the loaded index info instances, looked up by index key.
+#define INDEX_INFO_BUCKET_NUM (INDEX_INFO_INSTANCE_NUM * 2)
+#define INDEX_INFO_NULL_INSTANCE (-1)
+
+// Number of deserialized index nodes kept in memory per index file.
+#ifndef INDEX_NODE_CACHE_SIZE
+#define INDEX_NODE_CACHE_SIZE (64)
+#endif
+
+// Number of hash buckets of the node cache, should be a power of 2.
+#define INDEX_NODE_CACHE_BUCKET_NUM (INDEX_NODE_CACHE_SIZE * 2)
+#define INDEX_NODE_CACHE_NULL_ENTRY (-1)
+
+// tag, level, length, parent_tag, next_tag
+#define INDEX_NODE_HEADER_FIELD_NUM (5)
+// prefix_size and end_size of a prefix compressed node image, stored after its child tags.
+#define INDEX_NODE_COMPRESSED_FIELD_NUM (2)
+
+// Max number of levels created by the bulk build, every level has at most half of the nodes of its child level.
+#define INDEX_BULK_BUILD_MAX_LEVEL (32)
+
+// Max number of nodes on the root-to-leaf path, every non-leaf node has at least two children and node tags are uint32.
+#define INDEX_PATH_MAX_DEPTH (32)
+
+// index_id_type and index_structure are stored in the lower and upper 16 bits of a uint32.
+#define INDEX_FORMAT_STRUCTURE_SHIFT (16)
+#define INDEX_FORMAT_ID_TYPE_MASK (0xFFFFU)
+#define INDEX_FORMAT_STRUCTURE_MASK (0xFFU)
+
+// Levels of the nodes of a hash index, the root directory holds the directory nodes and they hold the primary bucket nodes.
+#define INDEX_HASH_ROOT_DIRECTORY_LEVEL (2)
+#define INDEX_HASH_DIRECTORY_LEVEL (1)
+#define INDEX_HASH_BUCKET_LEVEL (0)
+
+// Level of the posting nodes, which hold the payloads of a duplicated index id of a B+ tree.
+#define INDEX_POSTING_LIST_LEVEL (UINT32_MAX)
+// Each payload is stored as 64-bit words, each word is a zigzag varint of its difference from the previous payload.
+#define INDEX_POSTING_WORD_NUM ((INDEX_PAYLOAD_SIZE + sizeof(uint64_t) - 1) / sizeof(uint64_t))
+#define INDEX_VARINT_MAX_SIZE (10)
+
+// Max number of buckets of the equi-depth histogram of the B+ tree statistics.
+#ifndef INDEX_STATISTICS_HISTOGRAM_BUCKET_NUM
+#define INDEX_STATISTICS_HISTOGRAM_BUCKET_NUM (32)
+#endif
+
+// The statistics are collected again after the inserted and deleted elements reach this percentage of the collected elements.
+#ifndef INDEX_STATISTICS_STALE_PERCENT
+#define INDEX_STATISTICS_STALE_PERCENT (10)
+#endif
+
+// The index properties start with the magic number and the format version, an index file of another version is not opened.
+// Format versions:
+// 1: change_sequence of the node cache.
+// 2: node_size, order and internal_order, the nodes start at node_size-aligned offsets.
+// 3: no separator node flag in index_format_32, a non-zero internal_order means the non-leaf nodes store the separator index ids only.
+// 4: compressed_order and compressed_internal_order, the B+ tree nodes of the string and composite index ids are prefix compressed.
+#define INDEX_FILE_MAGIC (0x58444946U) // "FIDX"
+#define INDEX_FILE_FORMAT_VERSION (4)
+// Bytes of the magic number and the format version, the other index properties are stored after them.
+#define INDEX_FILE_FORMAT_HEADER_SIZE (sizeof(uint32_t) * 2)
+
 #define INDEX_FILE_OPEN_CHECK_TIMEOUT (30)
 #define INDEX_FILE_OPEN_CHECK_INTERVAL_US (100000) // 100ms
+#define INDEX_FILE_LOCK_RETRY_INTERVAL_US (1000)    // 1ms
 
 // Enumeration definition
 typedef enum
@@ -40,8 +106,18 @@ typedef enum
     INDEX_INFO_STATUS_READY,
     INDEX_INFO_STATUS_WRITING,
     INDEX_INFO_STATUS_READING,
+    INDEX_INFO_STATUS_LATCH_WRITING, // a writer changes the B+ tree with node latches, readers can read at the same time.
 } INDEX_INFO_STATUS_E;
 
+// Lock of the index file held by this process, shared by the readers and the writer of the index info.
+typedef enum
+{
+    INDEX_FILE_LOCK_NONE,
+    INDEX_FILE_LOCK_READ,
+    INDEX_FILE_LOCK_CONVERTING, // the latch writer is converting the read lock, see index_info_file_lock_latch_write()
+    INDEX_FILE_LOCK_WRITE
+} INDEX_FILE_LOCK_E;
+
 typedef enum
 {
     INDEX_CONTEXT_STATUS_UNUSED,
@@ -50,6 +126,14 @@ typedef enum
     INDEX_CONTEXT_STATUS_READY
 } INDEX_CONTEXT_STATUS_E;
 
+// Result of checking the properties of an existing index file.
+typedef enum
+{
+    INDEX_FILE_FORMAT_MATCHED,
+    INDEX_FILE_FORMAT_INCOMPLETE, // the index file is being created by another process
+    INDEX_FILE_FORMAT_MISMATCHED  // another format version, index key or index id type
+} INDEX_FILE_FORMAT_CHECK_E;
+
 // Structure definition
 typedef struct
 {
@@ -67,22 +151,61 @@ typedef struct
 
     uint32_t parent_tag;
     uint32_t next_tag;
-    // child_tag is a 1-based number and initilized as 0.
-    uint32_t child_tag[INDEX_CHILD_TAG_ORDER];
 
-    INDEX_ELEMENT_T elements[INDEX_ORDER];
+    uint32_t order; // capacity of elements, the order or the internal order of the index file, or their compressed orders.
+    uint32_t index_id_size;
+    uint32_t node_size;  // bytes of the node in the index file
+    uint32_t image_size; // bytes of p_node_image, a prefix compressed node is decoded into more elements than node_size holds.
+
+    // Node image, fixed-size index ids are stored inline (structure of arrays):
+    // tag | level | length | parent_tag | next_tag | child_tag[order + 1] | padding | index_ids[order] | payloads[order]
+    // The non-leaf nodes of a separator node B+ tree have no payloads[], p_payloads is NULL.
+    // The node is loaded and stored by a single read/write of the image, a prefix compressed node is decoded and encoded around it,
+    // see encode_index_node_image().
+    uint8_t *p_node_image;
+    // child_tag is a 1-based number and initilized as 0.
+    uint32_t *child_tag;  // point to child_tag[] in the node image
+    uint8_t *p_index_ids; // point to index_ids[] in the node image
+    uint8_t *p_payloads;  // point to payloads[] in the node image
 } INDEX_NODE_T;
 
+// Root-to-leaf path of a descent, the nodes are pinned in the node cache until the path is released.
+// The nodes are latched, shared by the readers and exclusive by the writer.
+typedef struct
+{
+    bool is_exclusive;
+    bool is_root_latched;
+    uint32_t depth;
+    INDEX_NODE_T *p_index_nodes[INDEX_PATH_MAX_DEPTH];
+    uint32_t positions[INDEX_PATH_MAX_DEPTH]; // position of the child_tag descended from each node
+} INDEX_PATH_T;
+
 typedef struct
 {
+    uint32_t magic;
+    uint32_t format_version;
     // tag_num == max(tag)
     uint32_t tag_num;
     uint32_t root_tag;
-    union
-    {
-        INDEX_ID_TYPE_E index_id_type;
-        uint32_t index_id_type_32; // write and read as uint32
-    };
+    INDEX_ID_TYPE_E index_id_type;
+    INDEX_STRUCTURE_E index_structure;
+    // index_id_type and index_structure are written and read as a uint32.
+    // The index files created before index_structure existed are B+ trees, whose upper bits are 0.
+    uint32_t index_format_32;
+    // Increased by every write operation, used to detect index file changes made by other processes.
+    uint32_t change_sequence;
+    // Bytes of each node in the index file and the max number of elements of each node.
+    // All are decided when the index file is created.
+    uint32_t node_size;
+    uint32_t order;
+    // Max number of elements of each non-leaf node storing the separator index ids only, derived from node_size.
+    // 0: the non-leaf nodes have the same layout as the leaf nodes (hash index).
+    uint32_t internal_order;
+    // Max number of elements of each prefix compressed leaf and non-leaf node, whose index ids share the leading bytes.
+    // order and internal_order elements always fit in a compressed node, the elements between them fit if their index ids are compressed enough.
+    // 0: the nodes aren't compressed (hash index and the index ids not ordered by their bytes).
+    uint32_t compressed_order;
+    uint32_t compressed_internal_order;
     // HASH_VALUE_T integrity;
 
     uint32_t key_size; // bytes
@@ -100,23 +223,111 @@ typedef struct
     uint32_t writer_waiting_count; // number of writers is writing (at most one) or waiting to write
     uint32_t reader_waiting_count;
     uint32_t reader_count; // readers can read simultaneously
+    INDEX_FILE_LOCK_E file_lock;
 } INDEX_INFO_SYNC_T;
 
+typedef struct
+{
+    // index_node must be the first member, a cached node pointer is also the pointer of its entry.
+    INDEX_NODE_T index_node;
+#if IS_POSIX_API_SUPPORT
+    pthread_rwlock_t latch; // latched by the B+ tree descents after pinning, a latched entry is always pinned.
+#endif
+    uint32_t pin_count; // entry can't be evicted while pin_count > 0
+    bool is_dirty;      // index_node should be written back to the index file
+    uint64_t last_used_tick;
+    int32_t next_entry; // next entry in the same hash bucket
+} INDEX_NODE_CACHE_ENTRY_T;
+
+// Cache of deserialized index nodes, keyed by node tag of the index file.
+typedef struct
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_t mutex; // readers share the cache
+    pthread_rwlock_t root_latch; // protects root_tag while a descent latches the root node
+#endif
+    uint32_t change_sequence; // change_sequence of the index file which the cached nodes belong to.
+    uint64_t tick;
+    bool is_index_properties_dirty;
+    int32_t bucket[INDEX_NODE_CACHE_BUCKET_NUM];
+    INDEX_NODE_CACHE_ENTRY_T entries[INDEX_NODE_CACHE_SIZE];
+} INDEX_NODE_CACHE_T;
+
+// Insertions into a B+ tree index which are not merged into the tree yet, searched together with the tree.
+// The elements are also stored in the write buffer file by insertion order, so other processes can load them.
+// Protected by the node cache mutex, the write buffer file is protected by the index file lock.
+typedef struct
+{
+    char file_path[INDEX_FILE_PATH_BUFFER_LENGTH];
+    FILE *write_buffer_file; // NULL until the write buffer file is opened or created.
+    bool is_loaded;
+    uint32_t length;   // number of buffered elements
+    uint32_t capacity; // number of elements allocated
+    uint8_t *p_index_ids; // by insertion order
+    uint8_t *p_payloads;  // by insertion order, INDEX_PAYLOAD_SIZE bytes each
+} INDEX_WRITE_BUFFER_T;
+
+// Statistics of the elements collected by a scan of the index, used to estimate the result length of the searches.
+// The B+ tree statistics have an equi-depth histogram over the leaf nodes, bucket i covers the index ids in [bounds[2i], bounds[2i + 1]].
+// Protected by the node cache mutex.
+typedef struct
+{
+    bool is_collected;
+    INDEX_STATISTICS_T statistics;
+    uint64_t modified_num;             // elements inserted or deleted after the collection, including the changes of other processes.
+    uint8_t *p_bucket_bounds;          // the first and the last index ids of each bucket
+    uint64_t *p_bucket_element_nums;   // number of elements of each bucket
+    uint64_t *p_bucket_distinct_nums;  // number of index ids starting in each bucket
+} INDEX_STATISTICS_INFO_T;
+
 typedef struct
 {
     FILE *index_file;
     INDEX_PROPERTIES_T index_properties;
     INDEX_INFO_SYNC_T index_info_sync;
+    INDEX_NODE_CACHE_T index_node_cache;
+    INDEX_WRITE_BUFFER_T index_write_buffer;
+    INDEX_STATISTICS_INFO_T index_statistics_info;
+    INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION_T lower_bound_function; // in-node search function chosen by index_id_type.
 
     INDEX_INFO_STATUS_E status;
+    atomic_uint_fast64_t last_used_tick; // pool tick of the last lookup, see touch_index_info_instance()
+    // Protected by the bucket mutex of the index key, the key is also protected by the index info mutex.
+    int32_t next_instance; // next loaded instance in the same hash bucket
+    uint32_t index_key_size;
+    char index_key[INDEX_FILE_PATH_BUFFER_LENGTH]; // index key loaded or being loaded, the key of the hash bucket
 } INDEX_INFO_T;
 
+// Loaded index info instances keep their index files open, looked up by the hash of index key and evicted by LRU.
+// A lookup locks the bucket of the index key only, the pool mutex is locked to load an index or request an instance.
+// An index file is opened with its index info locked.
+// Lock order: pool mutex > index info mutex > bucket mutex and release mutex.
+typedef struct
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_t mutex;
+    pthread_mutex_t bucket_mutex[INDEX_INFO_BUCKET_NUM];
+    pthread_mutex_t release_mutex;
+    pthread_cond_t release_cond;
+#endif
+    uint32_t instance_num; // instances in use, at most INDEX_INFO_INSTANCE_NUM
+    atomic_uint_fast64_t tick;
+    // Counted whenever an instance may be requested again, the requests finding all the instances busy wait for it to change.
+    atomic_uint_fast64_t release_sequence;
+    atomic_uint release_waiting_count;
+    bool is_sync_initialized; // mutexes and conditions of the instances and buckets are initialized by the first Index_Api_Init()
+    int32_t bucket[INDEX_INFO_BUCKET_NUM];
+} INDEX_INFO_POOL_T;
+
+// The mutex is locked by Index_Api_Init() and Index_Api_Close() only, the requests check the status atomically.
 typedef struct
 {
 #if IS_POSIX_API_SUPPORT
-    pthread_mutex_t mutex; // TODO: scenario condition. e.g. close wait for all load
+    pthread_mutex_t mutex;
+    pthread_cond_t close_cond;
 #endif
-    INDEX_CONTEXT_STATUS_E status; // TODO: move to INDEX_CONTEXT_T
+    _Atomic(INDEX_CONTEXT_STATUS_E) status; // TODO: move to INDEX_CONTEXT_T
+    atomic_uint request_num;                // requests using the index context, see enter_index_context_request()
 } INDEX_CONTEXT_SYNC_T;
 
 // TODO: using singleton context
@@ -130,22 +341,33 @@ typedef struct
 // End of structure definition
 
 // Static Varialbes
-static INDEX_INFO_T index_info_instance[INDEX_INFO_INSTANCE_NUM] = {
-    {.index_info_sync = {
+// status of the instances is INDEX_INFO_STATUS_RELEASED (0).
+static INDEX_INFO_T index_info_instance[INDEX_INFO_INSTANCE_NUM];
+static INDEX_INFO_POOL_T index_info_pool = {
 #if IS_POSIX_API_SUPPORT
-         .mutex = PTHREAD_MUTEX_INITIALIZER,
-         .read_cond = PTHREAD_COND_INITIALIZER,
-         .write_cond = PTHREAD_COND_INITIALIZER,
-         .close_cond = PTHREAD_COND_INITIALIZER
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .release_mutex = PTHREAD_MUTEX_INITIALIZER,
+    .release_cond = PTHREAD_COND_INITIALIZER,
 #endif
-     },
-     .status = INDEX_INFO_STATUS_RELEASED}};
+    .instance_num = INDEX_INFO_INSTANCE_NUM};
 static char index_directory_path[INDEX_FILE_PATH_BUFFER_LENGTH] = {0};
+// The settings are changed and read without the index context locked.
+#ifdef INDEX_ORDER
+static atomic_uint index_node_size = 0; // the new index files have the fixed order INDEX_ORDER
+#else
+static atomic_uint index_node_size = INDEX_NODE_SIZE; // node size of the new index files
+#endif
+static atomic_uint index_bulk_build_fill_factor = INDEX_BULK_BUILD_FILL_FACTOR;  // percentage
+static _Atomic(INDEX_STRUCTURE_E) index_structure = INDEX_STRUCTURE_BTREE;         // structure of the new index files
+static atomic_uint index_write_buffer_size = INDEX_WRITE_BUFFER_ELEMENT_NUM;      // buffered insertions per B+ tree index
+static atomic_uint index_posting_list_min_length = INDEX_POSTING_LIST_MIN_LENGTH; // equal index ids gathered into a posting list
 static INDEX_CONTEXT_SYNC_T index_context_sync = {
 #if IS_POSIX_API_SUPPORT
     .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .close_cond = PTHREAD_COND_INITIALIZER,
 #endif
-    .status = INDEX_CONTEXT_STATUS_UNUSED};
+    .status = INDEX_CONTEXT_STATUS_UNUSED,
+    .request_num = 0};
 
 // End of Static Variables
 
@@ -154,33 +376,58 @@ static inline void lock_index_context_sync();
 static inline void unlock_index_context_sync();
 void update_index_context_status(INDEX_CONTEXT_STATUS_E new_status);
 static inline bool check_index_context_status(INDEX_CONTEXT_STATUS_E status);
+static inline bool enter_index_context_request();
+static inline void leave_index_context_request();
 bool set_index_directory_path(char *p_index_directory_path);
 bool is_index_key_file_exists(char *p_index_key);
+INDEX_ID_TYPE_E read_index_file_index_format(char *p_index_key, INDEX_STRUCTURE_E *p_index_structure);
 void get_index_file_path_by_index_key(char *p_index_file_path, char *p_index_key);
-
+void get_index_write_buffer_file_path_by_index_key(char *p_write_buffer_file_path, char *p_index_key);
+
+static inline void lock_index_info_pool_sync();
+static inline void unlock_index_info_pool_sync();
+static inline void lock_index_info_bucket_sync(uint32_t bucket);
+static inline void unlock_index_info_bucket_sync(uint32_t bucket);
+static inline void index_info_pool_sync_release_wait(uint64_t release_sequence);
+static inline void index_info_pool_sync_release_notify();
 void index_info_instances_init();
 void index_info_instances_close();
+static inline uint32_t get_index_info_bucket(char *p_index_key, uint32_t index_key_size);
+static inline void touch_index_info_instance(INDEX_INFO_T *p_index_info);
+INDEX_INFO_T *query_index_info_instance(char *p_index_key, uint32_t index_key_size);
+void link_index_info_instance(INDEX_INFO_T *p_index_info);
+void unlink_index_info_instance(INDEX_INFO_T *p_index_info);
+static inline bool is_index_info_instance_busy(INDEX_INFO_T *p_index_info);
+void release_index_info_instance(INDEX_INFO_T *p_index_info);
+void release_excess_index_info_instance(uint32_t instance_position);
 INDEX_INFO_T *request_and_lock_released_index_info_instance();
 void create_new_index_file_format(INDEX_INFO_T *p_index_info, uint8_t *p_key, uint32_t key_size, INDEX_ID_TYPE_E index_id_type);
 
 void index_info_init(INDEX_INFO_T *p_index_info);
 void close_index_info(INDEX_INFO_T *index_info);
-INDEX_INFO_T *query_and_lock_index_info_loaded(char *p_index_key, uint32_t index_key_size, INDEX_ID_TYPE_E index_id_type);
+INDEX_INFO_T *query_and_lock_index_info_loaded(char *p_index_key, uint32_t index_key_size);
 INDEX_INFO_T *load_and_lock_index_info(char *p_key, INDEX_ID_TYPE_E index_id_type);
+void abort_index_info_loading(INDEX_INFO_T *p_index_info);
 
 void index_info_sync_init(INDEX_INFO_SYNC_T *p_index_info_sync);
 static void inline index_info_file_lock_write(INDEX_INFO_T *p_index_info);
 static void inline index_info_file_unlock_write(INDEX_INFO_T *p_index_info);
+static void inline index_info_file_lock_latch_write(INDEX_INFO_T *p_index_info);
+static void inline index_info_file_unlock_latch_write(INDEX_INFO_T *p_index_info);
 static void inline index_info_file_lock_read(INDEX_INFO_T *p_index_info);
 static void inline index_info_file_unlock_read(INDEX_INFO_T *p_index_info);
 static void lock_index_info_sync(INDEX_INFO_T *p_index_info);
 static void unlock_index_info_sync(INDEX_INFO_T *p_index_info);
 void update_index_info_status(INDEX_INFO_T *p_index_info, INDEX_INFO_STATUS_E new_status);
+void update_index_info_status_to_reading(INDEX_INFO_T *p_index_info);
 void update_index_info_status_from_reading(INDEX_INFO_T *p_index_info);
+void update_index_info_status_from_latch_writing(INDEX_INFO_T *p_index_info);
 static inline bool check_index_info_status(INDEX_INFO_T *p_index_info, INDEX_INFO_STATUS_E target_status);
 static inline bool check_index_info_status_available(INDEX_INFO_T *p_index_info);
 static inline void index_info_sync_close_wait(INDEX_INFO_T *p_index_info);
+static inline void index_info_sync_idle_wait(INDEX_INFO_T *p_index_info);
 static inline void index_info_sync_write_wait(INDEX_INFO_T *p_index_info);
+static inline void index_info_sync_latch_write_wait(INDEX_INFO_T *p_index_info);
 static inline void index_info_sync_read_wait(INDEX_INFO_T *p_index_info);
 static inline void index_info_sync_write_unblock(INDEX_INFO_T *p_index_info);
 static inline void index_info_sync_read_unblock(INDEX_INFO_T *p_index_info);
@@ -190,30 +437,153 @@ void allocate_index_properties_resources(INDEX_PROPERTIES_T *p_index_properties,
 void read_index_properties(INDEX_INFO_T *p_index_info);
 void write_index_properties(INDEX_INFO_T *p_index_info);
 size_t get_index_properties_size(INDEX_PROPERTIES_T *p_index_properties);
+static inline void pack_index_format(INDEX_PROPERTIES_T *p_index_properties);
+static inline void unpack_index_format(INDEX_PROPERTIES_T *p_index_properties);
 void free_index_properties_resources(INDEX_PROPERTIES_T *p_index_properties);
 void close_index_properties(INDEX_PROPERTIES_T *p_index_properties);
 
-void index_node_init(INDEX_NODE_T *p_index_node, uint32_t tag);
+void index_node_init(INDEX_NODE_T *p_index_node, uint32_t tag, INDEX_PROPERTIES_T *p_index_properties);
+void reset_index_node(INDEX_NODE_T *p_index_node, uint32_t tag, INDEX_PROPERTIES_T *p_index_properties);
+void set_index_node_level(INDEX_NODE_T *p_index_node, uint32_t level, INDEX_PROPERTIES_T *p_index_properties);
+static inline bool is_index_node_layout_matched(INDEX_NODE_T *p_index_node, INDEX_PROPERTIES_T *p_index_properties);
 void write_index_node(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node);
 bool read_index_node(INDEX_INFO_T *p_index_info, uint32_t tag, INDEX_NODE_T *p_index_node);
 off_t get_node_offset(INDEX_PROPERTIES_T *p_index_properties, uint32_t tag);
+size_t get_index_node_fields_size(uint32_t order);
+size_t get_index_node_image_size(uint32_t order, uint32_t index_id_size);
+uint32_t get_index_order_by_node_size(uint32_t node_size, INDEX_ID_TYPE_E index_id_type);
+uint32_t get_index_internal_order_by_node_size(uint32_t node_size, INDEX_ID_TYPE_E index_id_type);
+static inline size_t get_index_node_compressed_size(uint32_t length, uint32_t prefix_size, uint32_t end_size, bool has_payloads);
+void get_index_compressed_orders_by_node_size(uint32_t node_size, uint32_t index_id_size, bool has_payloads, uint32_t *p_order, uint32_t *p_compressed_order);
+void set_index_compressed_orders(INDEX_PROPERTIES_T *p_index_properties);
+size_t get_index_node_buffer_size(INDEX_PROPERTIES_T *p_index_properties);
+static inline bool is_index_node_compressed(INDEX_PROPERTIES_T *p_index_properties, uint32_t level);
+static inline void add_index_id_bounds(uint32_t index_id_size, const uint8_t *p_first_index_id, const uint8_t *p_index_id, uint32_t *p_prefix_size, uint32_t *p_end_size);
+void get_index_node_index_id_bounds(INDEX_NODE_T *p_index_node, uint32_t skip_position, const uint8_t *p_first_index_id, uint32_t *p_prefix_size, uint32_t *p_end_size);
+size_t encode_index_node_image(INDEX_NODE_T *p_index_node, uint8_t *p_image);
+void decode_index_node_image(INDEX_NODE_T *p_index_node, const uint8_t *p_image);
 void free_index_node_resources(INDEX_NODE_T *p_index_node);
 
+void index_node_cache_init(INDEX_NODE_CACHE_T *p_index_node_cache);
+static inline void lock_index_node_cache(INDEX_NODE_CACHE_T *p_index_node_cache);
+static inline void unlock_index_node_cache(INDEX_NODE_CACHE_T *p_index_node_cache);
+static inline uint32_t get_index_node_cache_bucket(uint32_t tag);
+INDEX_NODE_CACHE_ENTRY_T *query_index_node_cache_entry(INDEX_NODE_CACHE_T *p_index_node_cache, uint32_t tag);
+static inline uint32_t get_index_node_eviction_level(INDEX_NODE_T *p_index_node);
+INDEX_NODE_CACHE_ENTRY_T *request_index_node_cache_entry(INDEX_INFO_T *p_index_info, uint32_t tag);
+void evict_index_node_cache_entry(INDEX_INFO_T *p_index_info, INDEX_NODE_CACHE_ENTRY_T *p_entry);
+INDEX_NODE_T *fetch_index_node(INDEX_INFO_T *p_index_info, uint32_t tag);
+INDEX_NODE_T *create_index_node(INDEX_INFO_T *p_index_info);
+void release_index_node(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node);
+void mark_index_node_dirty(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node);
+void mark_index_properties_dirty(INDEX_INFO_T *p_index_info);
+void sync_index_node_cache(INDEX_INFO_T *p_index_info);
+void flush_index_node_cache(INDEX_INFO_T *p_index_info);
+void close_index_node_cache(INDEX_INFO_T *p_index_info);
+uint32_t read_index_change_sequence(INDEX_INFO_T *p_index_info);
+
+void index_write_buffer_init(INDEX_WRITE_BUFFER_T *p_index_write_buffer);
+void close_index_write_buffer(INDEX_WRITE_BUFFER_T *p_index_write_buffer);
+bool open_index_write_buffer_file(INDEX_WRITE_BUFFER_T *p_index_write_buffer, bool is_creating);
+bool reserve_index_write_buffer(INDEX_WRITE_BUFFER_T *p_index_write_buffer, uint32_t element_num, uint32_t index_id_size);
+void load_index_write_buffer(INDEX_INFO_T *p_index_info);
+void write_index_write_buffer_file(INDEX_INFO_T *p_index_info, uint32_t start, bool is_truncating);
+uint32_t get_index_write_buffer_length(INDEX_INFO_T *p_index_info);
+void append_index_write_buffer_element(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_index_element);
+bool remove_index_write_buffer_element(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_index_element);
+void merge_index_write_buffer(INDEX_INFO_T *p_index_info);
+uint32_t collect_index_write_buffer_elements(INDEX_INFO_T *p_index_info, void *p_lower_index_id, void *p_upper_index_id, uint8_t **pp_index_ids, uint8_t **pp_payloads);
+bool is_index_string_range_order_unknown(INDEX_INFO_T *p_index_info, void *p_lower_index_id, void *p_upper_index_id, uint8_t *p_result_index_ids, uint32_t result_length);
+uint8_t *search_index_write_buffer_equal(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_target_index_element, uint8_t *p_search_result, uint32_t *result_length);
+uint8_t *search_index_write_buffer_range(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_lower_index_element, void *p_upper_index_id, uint8_t *p_search_result, uint8_t *p_search_result_index_ids, uint32_t *result_length);
+
 void index_element_init(INDEX_ELEMENT_T *p_index_element);
 void setup_index_element(INDEX_ELEMENT_T *p_index_element, void *p_target, INDEX_ID_TYPE_E index_id_type, void *p_payload, uint32_t payload_size);
-void write_index_elements(INDEX_INFO_T *p_index_info, uint32_t tag, uint32_t index_element_position, uint32_t write_length, INDEX_ELEMENT_T *p_index_element);
-void read_index_elements(INDEX_INFO_T *p_index_info, const uint32_t tag, const uint32_t index_element_position, const uint32_t read_length, INDEX_ELEMENT_T *p_index_element);
-off_t get_index_element_offset(INDEX_PROPERTIES_T *p_index_properties, uint32_t tag, uint32_t index_element_position);
+static inline void *get_index_node_index_id(INDEX_NODE_T *p_index_node, uint32_t position);
+static inline uint8_t *get_index_node_payload(INDEX_NODE_T *p_index_node, uint32_t position);
+void set_index_node_element(INDEX_NODE_T *p_index_node, uint32_t position, void *p_index_id, void *p_payload, uint32_t payload_size);
 void allocate_index_element_resources(INDEX_ELEMENT_T *p_index_element, uint32_t index_id_size);
 void free_index_element_resources(INDEX_ELEMENT_T *p_index_element);
-void deep_copy_index_element(INDEX_ELEMENT_T *p_dest_index_element, INDEX_ELEMENT_T *p_src_index_element, INDEX_ID_TYPE_E index_id_type);
-uint32_t find_element_position_in_the_node(INDEX_NODE_T *p_index_node, INDEX_ELEMENT_T *p_index_element, INDEX_ID_TYPE_E index_id_type);
-void split_index_elements_into_two_index_node(INDEX_ELEMENT_T *p_index_element_buffer, uint32_t index_element_buffer_length, INDEX_NODE_T *p_index_node_current, INDEX_NODE_T *p_index_node_sibling);
+uint32_t find_element_position_in_the_node(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node, INDEX_ELEMENT_T *p_index_element);
+void split_index_elements_into_two_index_node(uint8_t *p_index_ids_buffer, uint8_t *p_payloads_buffer, uint32_t buffer_length, INDEX_NODE_T *p_index_node_current, INDEX_NODE_T *p_index_node_sibling);
 void split_child_tags_into_two_index_node(INDEX_INFO_T *p_index_info, uint32_t *p_child_tag_buffer, uint32_t child_tag_buffer_length, INDEX_NODE_T *p_index_node_current, INDEX_NODE_T *p_index_node_sibling);
-void insert_index_element_handler(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node, INDEX_ELEMENT_T *p_index_element, uint32_t new_child_tag);
-void insert_index_element(INDEX_INFO_T *p_index_info, uint32_t tag, INDEX_ELEMENT_T *p_index_element);
-void *search_index_element(INDEX_INFO_T *p_index_info, uint32_t tag, INDEX_ELEMENT_T *p_target_index_element, uint32_t *result_length);
+uint32_t find_child_tag_position_in_the_node(INDEX_NODE_T *p_index_node, uint32_t child_tag);
+void insert_element_into_index_node(INDEX_NODE_T *p_index_node, uint32_t position, void *p_index_id, void *p_payload, uint32_t tag_position, uint32_t child_tag);
+void remove_element_from_index_node(INDEX_NODE_T *p_index_node, uint32_t position, uint32_t tag_position);
+void insert_index_element_handler(INDEX_INFO_T *p_index_info, INDEX_PATH_T *p_index_path, INDEX_ELEMENT_T *p_index_element);
+static inline bool is_index_node_fit(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node, uint32_t length, uint32_t prefix_size, uint32_t end_size);
+bool is_index_node_fit_with_index_id(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node, void *p_index_id, uint32_t replace_position);
+bool is_index_node_merge_fit(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node, INDEX_NODE_T *p_right_node, void *p_separator_index_id);
+static inline bool is_index_node_insertion_safe(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node);
+static inline void latch_index_node(INDEX_NODE_T *p_index_node, bool is_exclusive);
+static inline void unlatch_index_node(INDEX_NODE_T *p_index_node);
+INDEX_NODE_T *fetch_and_latch_index_node(INDEX_INFO_T *p_index_info, uint32_t tag, bool is_exclusive);
+void unlatch_and_release_index_node(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node);
+static inline void latch_index_root(INDEX_INFO_T *p_index_info, bool is_exclusive);
+static inline void unlatch_index_root(INDEX_INFO_T *p_index_info);
+void set_index_root_tag(INDEX_INFO_T *p_index_info, uint32_t root_tag);
+void index_path_init(INDEX_PATH_T *p_index_path, bool is_exclusive);
+bool descend_index_path(INDEX_INFO_T *p_index_info, INDEX_PATH_T *p_index_path, INDEX_ELEMENT_T *p_index_element);
+void release_index_path_ancestors(INDEX_INFO_T *p_index_info, INDEX_PATH_T *p_index_path);
+void release_index_path(INDEX_INFO_T *p_index_info, INDEX_PATH_T *p_index_path);
+void insert_index_element(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_index_element);
+void *search_index_element(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_target_index_element, uint32_t *result_length);
 uint8_t *search_index_element_handler(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node, INDEX_ELEMENT_T *p_target_index_element, uint32_t *result_length);
+uint8_t *search_index_range(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_lower_index_element, void *p_upper_index_id, uint8_t **pp_result_index_ids, uint32_t *result_length);
+void reverse_index_payloads(uint8_t *p_payloads, uint32_t start, uint32_t end);
+bool delete_index_element(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_index_element);
+static inline uint32_t get_index_node_min_length(uint32_t order);
+void rebalance_index_node(INDEX_INFO_T *p_index_info, uint32_t tag);
+void borrow_element_from_left_sibling(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_parent_node, uint32_t position, INDEX_NODE_T *p_left_node, INDEX_NODE_T *p_index_node);
+void borrow_element_from_right_sibling(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_parent_node, uint32_t position, INDEX_NODE_T *p_index_node, INDEX_NODE_T *p_right_node);
+void merge_index_node_with_right_sibling(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_parent_node, uint32_t position, INDEX_NODE_T *p_index_node, INDEX_NODE_T *p_right_node);
+
+void sort_index_element_positions(uint32_t *p_positions, uint32_t element_num, uint8_t *p_index_ids, INDEX_ID_TYPE_E index_id_type);
+static inline bool is_index_element_position_before(uint32_t position_1, uint32_t position_2, uint8_t *p_index_ids, INDEX_ID_TYPE_E index_id_type);
+uint32_t get_bulk_build_node_num(uint32_t item_num, uint32_t max_item_num, uint32_t min_item_num);
+static inline uint32_t get_bulk_build_node_item_num(uint32_t item_num, uint32_t node_num, uint32_t node_index);
+static inline uint32_t get_bulk_build_node_index_of_item(uint32_t item_num, uint32_t node_num, uint32_t item_index);
+void bulk_build_index_nodes(INDEX_INFO_T *p_index_info, uint8_t *p_index_ids, uint8_t *p_payloads, uint32_t payload_size, uint32_t *p_positions, uint32_t element_num);
+uint32_t *get_bulk_build_leaf_item_starts(INDEX_INFO_T *p_index_info, uint8_t *p_index_ids, uint32_t *p_positions, uint32_t element_num, uint32_t *p_item_num);
+void attach_bulk_build_posting_lists(INDEX_INFO_T *p_index_info, uint8_t *p_payloads, uint32_t payload_size, uint32_t *p_positions, uint32_t *p_item_starts, uint32_t leaf_node_num);
+void bulk_insert_index_elements(INDEX_INFO_T *p_index_info, uint8_t *p_index_ids, uint8_t *p_payloads, uint32_t payload_size, uint32_t *p_positions, uint32_t element_num);
+
+static inline uint32_t get_index_node_posting_tag(INDEX_NODE_T *p_index_node, uint32_t position);
+static inline uint8_t *get_index_posting_node_data(INDEX_NODE_T *p_index_node);
+static inline uint32_t get_index_posting_node_capacity(INDEX_NODE_T *p_index_node);
+static inline uint32_t encode_index_varint(uint8_t *p_buffer, uint64_t value);
+static inline uint32_t decode_index_varint(const uint8_t *p_buffer, uint64_t *p_value);
+uint32_t encode_index_posting_payloads(uint8_t *p_buffer, uint32_t buffer_size, uint8_t *p_payloads, uint32_t payload_num, uint32_t *p_encoded_size);
+void decode_index_posting_payloads(const uint8_t *p_buffer, uint8_t *p_payloads, uint32_t payload_num);
+uint32_t set_index_posting_node_payloads(INDEX_NODE_T *p_index_node, uint8_t *p_payloads, uint32_t payload_num, bool is_partial);
+uint32_t create_index_posting_list(INDEX_INFO_T *p_index_info, uint8_t *p_payloads, uint32_t payload_num);
+void prepend_index_posting_list(INDEX_INFO_T *p_index_info, uint32_t *p_head_tag, void *p_payload);
+bool remove_index_posting_list_payload(INDEX_INFO_T *p_index_info, uint32_t *p_head_tag, void *p_payload);
+uint8_t *read_index_posting_list(INDEX_INFO_T *p_index_info, uint32_t head_tag, uint32_t *p_payload_num);
+bool insert_index_element_into_posting_list(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_leaf_node, INDEX_ELEMENT_T *p_index_element);
+void gather_index_elements_into_posting_list(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_leaf_node, uint32_t position, uint32_t run_length, INDEX_ELEMENT_T *p_index_element);
+
+void create_new_hash_index_nodes(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_root_directory_node);
+static inline uint64_t get_hash_index_id_hash(INDEX_INFO_T *p_index_info, void *p_index_id);
+static inline uint32_t get_hash_index_bucket(uint32_t bucket_num, uint64_t hash_value);
+static inline uint32_t get_hash_index_max_bucket_num(uint32_t order);
+uint32_t get_hash_index_bucket_tag(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_root_directory_node, uint32_t bucket);
+bool append_hash_index_element(INDEX_INFO_T *p_index_info, uint32_t bucket_tag, void *p_index_id, void *p_payload);
+void insert_hash_index_element(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_index_element);
+void split_hash_index_bucket(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_root_directory_node);
+uint8_t *search_hash_index_element(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_target_index_element, uint32_t *result_length);
+bool delete_hash_index_element(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_index_element);
+
+void index_statistics_info_init(INDEX_STATISTICS_INFO_T *p_index_statistics_info);
+void free_index_statistics_info_resources(INDEX_STATISTICS_INFO_T *p_index_statistics_info);
+void add_index_statistics_modified_num(INDEX_INFO_T *p_index_info, uint64_t modified_num);
+static inline bool is_index_statistics_stale(INDEX_STATISTICS_INFO_T *p_index_statistics_info);
+void update_index_statistics(INDEX_INFO_T *p_index_info);
+uint32_t get_index_posting_list_length(INDEX_INFO_T *p_index_info, uint32_t head_tag);
+void collect_index_statistics(INDEX_INFO_T *p_index_info, INDEX_STATISTICS_INFO_T *p_index_statistics_info);
+void build_index_statistics_histogram(INDEX_STATISTICS_INFO_T *p_index_statistics_info, uint32_t index_id_size, uint8_t *p_segment_bounds, uint64_t *p_segment_element_nums, uint64_t *p_segment_distinct_nums, uint32_t segment_num);
+void collect_hash_index_statistics(INDEX_INFO_T *p_index_info, INDEX_STATISTICS_INFO_T *p_index_statistics_info);
+uint64_t estimate_index_statistics_range(INDEX_INFO_T *p_index_info, void *p_lower_index_id, void *p_upper_index_id);
 // End of local function declaration
 
 void Index_Api_Init(char *p_index_directory_path)
@@ -223,8 +593,13 @@ void Index_Api_Init(char *p_index_directory_path)
     strncpy(temp_index_directory_path, p_index_directory_path, INDEX_FILE_PATH_MAX_LENGTH);
     temp_index_directory_path[INDEX_FILE_PATH_MAX_LENGTH] = '\0';
 
-    // lock_index_context_init();
     lock_index_context_sync();
+    if (check_index_context_status(INDEX_CONTEXT_STATUS_UNUSED) == false)
+    {
+        // Already initialized.
+        unlock_index_context_sync();
+        return;
+    }
     update_index_context_status(INDEX_CONTEXT_STATUS_INITIALIZING);
 
     // Initialize index dorectory path.
@@ -232,20 +607,130 @@ void Index_Api_Init(char *p_index_directory_path)
     // Initialize index info instances.
     index_info_instances_init();
 
-    // unlock_index_context_init();
     update_index_context_status(INDEX_CONTEXT_STATUS_READY);
     unlock_index_context_sync();
 }
 
+// Set the node size (bytes) of the index files created afterwards, existed index files keep their own node size.
+// The size is limited to [INDEX_MIN_NODE_SIZE, INDEX_MAX_NODE_SIZE], 0 restores the fixed order if INDEX_ORDER is defined.
+void Index_Api_Set_Node_Size(uint32_t node_size)
+{
+#ifdef INDEX_ORDER
+    if (node_size == 0)
+    {
+        atomic_store(&index_node_size, 0);
+        return;
+    }
+#endif
+
+    if (node_size < INDEX_MIN_NODE_SIZE)
+    {
+        node_size = INDEX_MIN_NODE_SIZE;
+    }
+    else if (node_size > INDEX_MAX_NODE_SIZE)
+    {
+        node_size = INDEX_MAX_NODE_SIZE;
+    }
+
+    atomic_store(&index_node_size, node_size);
+}
+
+// Set the fill factor (percentage) of the nodes written by Index_Api_Bulk_Build().
+void Index_Api_Set_Bulk_Build_Fill_Factor(uint32_t fill_factor)
+{
+    if (fill_factor < INDEX_BULK_BUILD_MIN_FILL_FACTOR)
+    {
+        fill_factor = INDEX_BULK_BUILD_MIN_FILL_FACTOR;
+    }
+    else if (fill_factor > INDEX_BULK_BUILD_MAX_FILL_FACTOR)
+    {
+        fill_factor = INDEX_BULK_BUILD_MAX_FILL_FACTOR;
+    }
+
+    atomic_store(&index_bulk_build_fill_factor, fill_factor);
+}
+
+// Set the structure of the index files created afterwards, existed index files keep their own structure.
+void Index_Api_Set_Index_Structure(INDEX_STRUCTURE_E structure)
+{
+    if (structure >= INDEX_STRUCTURE_NUM)
+    {
+        return;
+    }
+
+    atomic_store(&index_structure, structure);
+}
+
+// Set the max number of index files kept open, the least recently used one is closed to open another.
+// The number is limited to [1, INDEX_INFO_INSTANCE_NUM], the index files over the new number are closed.
+void Index_Api_Set_Open_Index_File_Num(uint32_t open_index_file_num)
+{
+    if (open_index_file_num < 1)
+    {
+        open_index_file_num = 1;
+    }
+    else if (open_index_file_num > INDEX_INFO_INSTANCE_NUM)
+    {
+        open_index_file_num = INDEX_INFO_INSTANCE_NUM;
+    }
+
+    uint32_t former_instance_num = 0;
+    bool is_sync_initialized = false;
+
+    // No request picks the instances over the new number once it's lowered.
+    lock_index_info_pool_sync();
+    former_instance_num = index_info_pool.instance_num;
+    is_sync_initialized = index_info_pool.is_sync_initialized;
+    index_info_pool.instance_num = open_index_file_num;
+    unlock_index_info_pool_sync();
+
+    if (is_sync_initialized)
+    {
+        for (uint32_t i = open_index_file_num; i < former_instance_num; i++)
+        {
+            release_excess_index_info_instance(i);
+        }
+    }
+
+    // The requests waiting for an instance may use the new ones.
+    index_info_pool_sync_release_notify();
+}
+
+// Set the number of insertions buffered per B+ tree index before they are merged into the tree.
+// 0 inserts the elements into the tree directly, the elements already buffered are merged by the next insertion.
+void Index_Api_Set_Write_Buffer_Size(uint32_t element_num)
+{
+    atomic_store(&index_write_buffer_size, element_num);
+}
+
+// Set the length of a run of equal index ids at which the B+ tree gathers them into a posting list.
+// 0 keeps every duplicated index id as an element, the posting lists already created are kept.
+void Index_Api_Set_Posting_List_Min_Length(uint32_t min_length)
+{
+    atomic_store(&index_posting_list_min_length, min_length);
+}
+
 void Index_Api_Close()
 {
-    // lock_index_context_close();
     lock_index_context_sync();
+    if (check_index_context_status(INDEX_CONTEXT_STATUS_READY) == false)
+    {
+        // Not initialized or already closed.
+        unlock_index_context_sync();
+        return;
+    }
     update_index_context_status(INDEX_CONTEXT_STATUS_CLOSING);
 
+    // The new requests return since the index context is closing, wait for the requests using the index context.
+#if IS_POSIX_API_SUPPORT
+    while (atomic_load(&(index_context_sync.request_num)) > 0)
+    {
+        pthread_cond_wait(&(index_context_sync.close_cond), &(index_context_sync.mutex));
+    }
+#endif
+
     index_info_instances_close();
 
-    // unlock_index_context_close();
     update_index_context_status(INDEX_CONTEXT_STATUS_UNUSED);
     unlock_index_context_sync();
 }
@@ -253,129 +738,559 @@ void Index_Api_Close()
 bool Index_Api_Index_Key_Exist(char *p_index_key)
 {
     bool result = false;
-    // INDEX_CONTEXT_STATUS_E *p_index_context_status = &(index_context_sync.status);
     char temp_index_key[INDEX_FILE_PATH_BUFFER_LENGTH] = {0};
 
     strncpy(temp_index_key, p_index_key, INDEX_FILE_PATH_MAX_LENGTH);
     temp_index_key[INDEX_FILE_PATH_MAX_LENGTH] = '\0';
 
-    lock_index_context_sync();
-    if (check_index_context_status(INDEX_CONTEXT_STATUS_READY) == true)
+    if (enter_index_context_request() == true)
     {
         result = is_index_key_file_exists(temp_index_key);
+        leave_index_context_request();
     }
-    unlock_index_context_sync();
 
     return result;
 }
 
+// Return the index id type of the existing index, INDEX_ID_TYPE_INVALID if the index doesn't exist.
+INDEX_ID_TYPE_E Index_Api_Get_Index_Id_Type(char *p_index_key)
+{
+    INDEX_ID_TYPE_E index_id_type = INDEX_ID_TYPE_INVALID;
+    char temp_index_key[INDEX_FILE_PATH_BUFFER_LENGTH] = {0};
+
+    strncpy(temp_index_key, p_index_key, INDEX_FILE_PATH_MAX_LENGTH);
+    temp_index_key[INDEX_FILE_PATH_MAX_LENGTH] = '\0';
+
+    if (enter_index_context_request() == true)
+    {
+        index_id_type = read_index_file_index_format(temp_index_key, NULL);
+        leave_index_context_request();
+    }
+
+    return index_id_type;
+}
+
+// Return INDEX_STRUCTURE_NUM if the index file doesn't exist.
+INDEX_STRUCTURE_E Index_Api_Get_Index_Structure(char *p_index_key)
+{
+    INDEX_STRUCTURE_E structure = INDEX_STRUCTURE_NUM;
+    char temp_index_key[INDEX_FILE_PATH_BUFFER_LENGTH] = {0};
+
+    strncpy(temp_index_key, p_index_key, INDEX_FILE_PATH_MAX_LENGTH);
+    temp_index_key[INDEX_FILE_PATH_MAX_LENGTH] = '\0';
+
+    if (enter_index_context_request() == true)
+    {
+        read_index_file_index_format(temp_index_key, &structure);
+        leave_index_context_request();
+    }
+
+    return structure;
+}
+
+// The element is appended to the write buffer of a B+ tree, the readers can search at the same time.
+// The insertion which finds the write buffer full merges it into the tree exclusively first.
+// Without the write buffer, the element is inserted into the tree with node latches.
 void Index_Api_Insert_Element(char *p_index_key, void *p_index_id, INDEX_ID_TYPE_E index_id_type, void *p_index_payload, uint32_t payload_size)
 {
     INDEX_INFO_T *p_index_info = NULL;
     INDEX_ELEMENT_T index_element;
+    uint32_t write_buffer_size = 0, write_buffer_length = 0;
+    bool is_btree = false, is_latched = false;
 
     index_element_init(&index_element);
     setup_index_element(&index_element, p_index_id, index_id_type, p_index_payload, payload_size);
 
-    lock_index_context_sync();
-    if (check_index_context_status(INDEX_CONTEXT_STATUS_READY) == false)
+    if (enter_index_context_request() == false)
     {
-        unlock_index_context_sync();
         free_index_element_resources(&index_element);
         return;
     }
 
+    write_buffer_size = atomic_load(&index_write_buffer_size);
     p_index_info = load_and_lock_index_info(p_index_key, index_id_type);
-    unlock_index_context_sync();
 
-    index_info_sync_write_wait(p_index_info);
-    update_index_info_status(p_index_info, INDEX_INFO_STATUS_WRITING);
-    index_info_file_lock_write(p_index_info);
+    // The index file can't be loaded, e.g. it has another format version.
+    if (p_index_info == NULL)
+    {
+        leave_index_context_request();
+        free_index_element_resources(&index_element);
+        return;
+    }
+
+    // index_structure is decided when the index file is created and never changed.
+    // The buffered length may be changed by other processes, it only decides whether to merge.
+    is_btree = (p_index_info->index_properties.index_structure == INDEX_STRUCTURE_BTREE);
+    write_buffer_length = (is_btree) ? get_index_write_buffer_length(p_index_info) : (0);
+    is_latched = is_btree && ((write_buffer_length == 0) || (write_buffer_length < write_buffer_size));
+    if (is_latched)
+    {
+        index_info_sync_latch_write_wait(p_index_info);
+        update_index_info_status(p_index_info, INDEX_INFO_STATUS_LATCH_WRITING);
+        index_info_file_lock_latch_write(p_index_info);
+    }
+    else
+    {
+        index_info_sync_write_wait(p_index_info);
+        update_index_info_status(p_index_info, INDEX_INFO_STATUS_WRITING);
+        index_info_file_lock_write(p_index_info);
+    }
     unlock_index_info_sync(p_index_info);
 
-    insert_index_element(p_index_info, p_index_info->index_properties.root_tag, &index_element);
+    sync_index_node_cache(p_index_info);
+    if (is_btree)
+    {
+        if (is_latched == false)
+        {
+            merge_index_write_buffer(p_index_info);
+        }
+
+        // Keep buffering if other processes buffered elements, the equal index ids stay in insertion order.
+        if ((write_buffer_size > 0) || (get_index_write_buffer_length(p_index_info) > 0))
+        {
+            append_index_write_buffer_element(p_index_info, &index_element);
+        }
+        else
+        {
+            insert_index_element(p_index_info, &index_element);
+        }
+    }
+    else
+    {
+        insert_hash_index_element(p_index_info, &index_element);
+    }
+    add_index_statistics_modified_num(p_index_info, 1);
+    // Write back the changed nodes before other processes can access the index file.
+    flush_index_node_cache(p_index_info);
 
     lock_index_info_sync(p_index_info);
-    index_info_file_unlock_write(p_index_info);
-    update_index_info_status(p_index_info, INDEX_INFO_STATUS_READY);
+    if (is_latched)
+    {
+        index_info_file_unlock_latch_write(p_index_info);
+        update_index_info_status_from_latch_writing(p_index_info);
+    }
+    else
+    {
+        index_info_file_unlock_write(p_index_info);
+        update_index_info_status(p_index_info, INDEX_INFO_STATUS_READY);
+    }
     index_info_sync_write_unblock(p_index_info);
     unlock_index_info_sync(p_index_info);
+    leave_index_context_request();
 
     free_index_element_resources(&index_element);
 }
 
-// return value: result array
-// result_length: integer, number of results in result array
-void *Index_Api_Search_Equal(char *p_index_key, void *p_target_index_id, INDEX_ID_TYPE_E index_id_type, uint32_t *p_result_length)
+// Insert element_num elements at once.
+// p_index_ids: array of index ids, p_index_payloads: array of payloads whose size is payload_size.
+// The elements are sorted by index id, and the nodes are written bottom-up if the index is empty.
+// Otherwise, the sorted elements are inserted one by one.
+// The elements of a hash index are inserted one by one in the input order.
+void Index_Api_Bulk_Build(char *p_index_key, INDEX_ID_TYPE_E index_id_type, void *p_index_ids, void *p_index_payloads, uint32_t payload_size, uint32_t element_num)
 {
     INDEX_INFO_T *p_index_info = NULL;
-    uint32_t root_tag = 0;
-    INDEX_ELEMENT_T target_index_element;
-    void *result = NULL;
-
-    index_element_init(&target_index_element);
-    setup_index_element(&target_index_element, p_target_index_id, index_id_type, NULL, 0);
+    INDEX_NODE_T *p_root_index_node = NULL;
+    uint32_t *p_positions = NULL;
+    bool is_index_empty = false;
 
-    lock_index_context_sync();
+    assert(payload_size <= INDEX_PAYLOAD_SIZE);
 
-    // Check if index key exists or not.
-    if (!(is_index_key_file_exists(p_index_key)))
+    // Sort the positions of the elements instead of moving the index ids and payloads.
+    p_positions = malloc(sizeof(uint32_t) * element_num);
+    if ((p_positions == NULL) && (element_num > 0))
     {
-        unlock_index_context_sync();
+        return;
+    }
+    for (uint32_t i = 0; i < element_num; i++)
+    {
+        p_positions[i] = i;
+    }
+    sort_index_element_positions(p_positions, element_num, p_index_ids, index_id_type);
 
-        free_index_element_resources(&target_index_element);
-        *p_result_length = 0;
-        return NULL;
+    if (enter_index_context_request() == false)
+    {
+        free(p_positions);
+        return;
     }
 
     p_index_info = load_and_lock_index_info(p_index_key, index_id_type);
-    unlock_index_context_sync();
+    if (p_index_info == NULL)
+    {
+        leave_index_context_request();
+        free(p_positions);
+        return;
+    }
 
-    index_info_sync_read_wait(p_index_info);
-    index_info_file_lock_read(p_index_info);
-    update_index_info_status(p_index_info, INDEX_INFO_STATUS_READING);
+    index_info_sync_write_wait(p_index_info);
+    update_index_info_status(p_index_info, INDEX_INFO_STATUS_WRITING);
+    index_info_file_lock_write(p_index_info);
     unlock_index_info_sync(p_index_info);
 
-    root_tag = p_index_info->index_properties.root_tag;
-    result = search_index_element(p_index_info, root_tag, &target_index_element, p_result_length);
+    sync_index_node_cache(p_index_info);
+    if (p_index_info->index_properties.index_structure == INDEX_STRUCTURE_BTREE)
+    {
+        // The buffered elements are inserted before the new ones.
+        merge_index_write_buffer(p_index_info);
+    }
+    p_root_index_node = fetch_index_node(p_index_info, p_index_info->index_properties.root_tag);
+    is_index_empty = (p_index_info->index_properties.tag_num == 1) && (p_root_index_node->length == 0);
+    release_index_node(p_index_info, p_root_index_node);
 
-    lock_index_info_sync(p_index_info);
-    index_info_file_unlock_read(p_index_info);
-    update_index_info_status_from_reading(p_index_info);
-    index_info_sync_read_unblock(p_index_info);
-    unlock_index_info_sync(p_index_info);
+    if (p_index_info->index_properties.index_structure == INDEX_STRUCTURE_HASH)
+    {
+        for (uint32_t i = 0; i < element_num; i++)
+        {
+            INDEX_ELEMENT_T index_element;
 
-    free_index_element_resources(&target_index_element);
+            // The element refers to the input array, there is no resource to free.
+            index_element.p_index_id = (uint8_t *)p_index_ids + (Index_Id_Type_Get_Size(index_id_type) * i);
+            memset(index_element.index_payload, 0, INDEX_PAYLOAD_SIZE);
+            memcpy(index_element.index_payload, (uint8_t *)p_index_payloads + (payload_size * i), payload_size);
+            insert_hash_index_element(p_index_info, &index_element);
+        }
+    }
+    else if (is_index_empty)
+    {
+        bulk_build_index_nodes(p_index_info, p_index_ids, p_index_payloads, payload_size, p_positions, element_num);
+    }
+    else
+    {
+        bulk_insert_index_elements(p_index_info, p_index_ids, p_index_payloads, payload_size, p_positions, element_num);
+    }
+    add_index_statistics_modified_num(p_index_info, element_num);
+    // Write back the changed nodes before other processes can access the index file.
+    flush_index_node_cache(p_index_info);
 
-    return result;
-}
+    lock_index_info_sync(p_index_info);
+    index_info_file_unlock_write(p_index_info);
+    update_index_info_status(p_index_info, INDEX_INFO_STATUS_READY);
+    index_info_sync_write_unblock(p_index_info);
+    unlock_index_info_sync(p_index_info);
+    leave_index_context_request();
 
-void Index_Api_Free_Search_Result(void *p_result)
-{
-    free(p_result);
+    free(p_positions);
 }
 
-static inline void lock_index_context_sync()
+// Delete the element whose index id and payload are both equal to the inputted ones.
+// Return false if the element doesn't exist.
+bool Index_Api_Delete_Element(char *p_index_key, void *p_index_id, INDEX_ID_TYPE_E index_id_type, void *p_index_payload, uint32_t payload_size)
 {
-#if IS_POSIX_API_SUPPORT
-    pthread_mutex_t *p_mutex = &(index_context_sync.mutex);
-    pthread_mutex_lock(p_mutex);
-#endif
-}
+    INDEX_INFO_T *p_index_info = NULL;
+    INDEX_ELEMENT_T index_element;
+    bool is_deleted = false;
 
-static inline void unlock_index_context_sync()
-{
-#if IS_POSIX_API_SUPPORT
-    pthread_mutex_t *p_mutex = &(index_context_sync.mutex);
-    pthread_mutex_unlock(p_mutex);
-#endif
-}
+    index_element_init(&index_element);
+    setup_index_element(&index_element, p_index_id, index_id_type, p_index_payload, payload_size);
 
-// Lock the index_context before using this funtion.
+    if (enter_index_context_request() == false)
+    {
+        free_index_element_resources(&index_element);
+        return false;
+    }
+
+    p_index_info = (is_index_key_file_exists(p_index_key)) ? (load_and_lock_index_info(p_index_key, index_id_type)) : (NULL);
+    if (p_index_info == NULL)
+    {
+        leave_index_context_request();
+        free_index_element_resources(&index_element);
+        return false;
+    }
+
+    index_info_sync_write_wait(p_index_info);
+    update_index_info_status(p_index_info, INDEX_INFO_STATUS_WRITING);
+    index_info_file_lock_write(p_index_info);
+    unlock_index_info_sync(p_index_info);
+
+    sync_index_node_cache(p_index_info);
+    if (p_index_info->index_properties.index_structure == INDEX_STRUCTURE_HASH)
+    {
+        is_deleted = delete_hash_index_element(p_index_info, &index_element);
+    }
+    else
+    {
+        is_deleted = remove_index_write_buffer_element(p_index_info, &index_element) || delete_index_element(p_index_info, &index_element);
+    }
+    if (is_deleted)
+    {
+        add_index_statistics_modified_num(p_index_info, 1);
+    }
+    // Write back the changed nodes before other processes can access the index file.
+    flush_index_node_cache(p_index_info);
+
+    lock_index_info_sync(p_index_info);
+    index_info_file_unlock_write(p_index_info);
+    update_index_info_status(p_index_info, INDEX_INFO_STATUS_READY);
+    index_info_sync_write_unblock(p_index_info);
+    unlock_index_info_sync(p_index_info);
+    leave_index_context_request();
+
+    free_index_element_resources(&index_element);
+
+    return is_deleted;
+}
+
+// return value: result array
+// result_length: integer, number of results in result array
+void *Index_Api_Search_Equal(char *p_index_key, void *p_target_index_id, INDEX_ID_TYPE_E index_id_type, uint32_t *p_result_length)
+{
+    INDEX_INFO_T *p_index_info = NULL;
+    INDEX_ELEMENT_T target_index_element;
+    void *result = NULL;
+
+    index_element_init(&target_index_element);
+    setup_index_element(&target_index_element, p_target_index_id, index_id_type, NULL, 0);
+
+    if (enter_index_context_request() == false)
+    {
+        free_index_element_resources(&target_index_element);
+        *p_result_length = 0;
+        return NULL;
+    }
+
+    // Check if index key exists or not.
+    p_index_info = (is_index_key_file_exists(p_index_key)) ? (load_and_lock_index_info(p_index_key, index_id_type)) : (NULL);
+    if (p_index_info == NULL)
+    {
+        leave_index_context_request();
+        free_index_element_resources(&target_index_element);
+        *p_result_length = 0;
+        return NULL;
+    }
+
+    index_info_sync_read_wait(p_index_info);
+    index_info_file_lock_read(p_index_info);
+    update_index_info_status_to_reading(p_index_info);
+    unlock_index_info_sync(p_index_info);
+
+    sync_index_node_cache(p_index_info);
+    if (p_index_info->index_properties.index_structure == INDEX_STRUCTURE_HASH)
+    {
+        result = search_hash_index_element(p_index_info, &target_index_element, p_result_length);
+    }
+    else
+    {
+        result = search_index_element(p_index_info, &target_index_element, p_result_length);
+        result = search_index_write_buffer_equal(p_index_info, &target_index_element, result, p_result_length);
+    }
+
+    lock_index_info_sync(p_index_info);
+    index_info_file_unlock_read(p_index_info);
+    update_index_info_status_from_reading(p_index_info);
+    index_info_sync_read_unblock(p_index_info);
+    unlock_index_info_sync(p_index_info);
+    leave_index_context_request();
+
+    free_index_element_resources(&target_index_element);
+
+    return result;
+}
+
+// Search the elements whose index ids are in [lower, upper], NULL bound means unbounded.
+// A hash index keeps no order, no result is returned.
+// A string range has no result either if its order depends on the hashes of the truncated strings, see Index_Id_Type_Is_String_Range_Bound() and Index_Id_Type_Is_String_Order_Unknown().
+// return value: payload array sorted by index id, the equal index ids are in insertion order.
+// result_length: integer, number of results in result array
+void *Index_Api_Search_Range(char *p_index_key, void *p_lower_index_id, void *p_upper_index_id, INDEX_ID_TYPE_E index_id_type, uint32_t *p_result_length)
+{
+    INDEX_INFO_T *p_index_info = NULL;
+    INDEX_ELEMENT_T lower_index_element;
+    uint8_t *p_result_index_ids = NULL;
+    void *result = NULL;
+    bool is_buffered = false, is_string = false;
+
+    // A truncated string index id can't bound the strings sharing its prefix in their order.
+    if ((index_id_type == INDEX_ID_TYPE_STRING) &&
+        (((p_lower_index_id != NULL) && (Index_Id_Type_Is_String_Range_Bound(p_lower_index_id) == false)) ||
+         ((p_upper_index_id != NULL) && (Index_Id_Type_Is_String_Range_Bound(p_upper_index_id) == false))))
+    {
+        *p_result_length = 0;
+        return NULL;
+    }
+
+    index_element_init(&lower_index_element);
+    if (p_lower_index_id != NULL)
+    {
+        setup_index_element(&lower_index_element, p_lower_index_id, index_id_type, NULL, 0);
+    }
+
+    if (enter_index_context_request() == false)
+    {
+        free_index_element_resources(&lower_index_element);
+        *p_result_length = 0;
+        return NULL;
+    }
+
+    p_index_info = (is_index_key_file_exists(p_index_key)) ? (load_and_lock_index_info(p_index_key, index_id_type)) : (NULL);
+    if (p_index_info == NULL)
+    {
+        leave_index_context_request();
+        free_index_element_resources(&lower_index_element);
+        *p_result_length = 0;
+        return NULL;
+    }
+
+    index_info_sync_read_wait(p_index_info);
+    index_info_file_lock_read(p_index_info);
+    update_index_info_status_to_reading(p_index_info);
+    unlock_index_info_sync(p_index_info);
+
+    sync_index_node_cache(p_index_info);
+    if (p_index_info->index_properties.index_structure == INDEX_STRUCTURE_HASH)
+    {
+        *p_result_length = 0;
+    }
+    else
+    {
+        // The index ids of the tree elements are collected to merge the buffered elements in order, and to check the order of the strings.
+        is_buffered = (get_index_write_buffer_length(p_index_info) > 0);
+        is_string = (index_id_type == INDEX_ID_TYPE_STRING);
+        result = search_index_range(p_index_info, (p_lower_index_id != NULL) ? (&lower_index_element) : (NULL), p_upper_index_id, (is_buffered || is_string) ? (&p_result_index_ids) : (NULL), p_result_length);
+        if (is_string && is_index_string_range_order_unknown(p_index_info, p_lower_index_id, p_upper_index_id, p_result_index_ids, *p_result_length))
+        {
+            free(result);
+            result = NULL;
+            *p_result_length = 0;
+        }
+        else if (is_buffered)
+        {
+            result = search_index_write_buffer_range(p_index_info, (p_lower_index_id != NULL) ? (&lower_index_element) : (NULL), p_upper_index_id, result, p_result_index_ids, p_result_length);
+        }
+        free(p_result_index_ids);
+    }
+
+    lock_index_info_sync(p_index_info);
+    index_info_file_unlock_read(p_index_info);
+    update_index_info_status_from_reading(p_index_info);
+    index_info_sync_read_unblock(p_index_info);
+    unlock_index_info_sync(p_index_info);
+    leave_index_context_request();
+
+    free_index_element_resources(&lower_index_element);
+
+    return result;
+}
+
+void Index_Api_Free_Search_Result(void *p_result)
+{
+    free(p_result);
+}
+
+// Get the statistics of the index, they're collected by a scan of the index if they're stale.
+// The elements in the write buffer are counted, but not in distinct_num.
+// Return false if the index doesn't exist.
+bool Index_Api_Get_Statistics(char *p_index_key, INDEX_ID_TYPE_E index_id_type, INDEX_STATISTICS_T *p_index_statistics)
+{
+    INDEX_INFO_T *p_index_info = NULL;
+
+    memset(p_index_statistics, 0, sizeof(INDEX_STATISTICS_T));
+
+    if (enter_index_context_request() == false)
+    {
+        return false;
+    }
+
+    p_index_info = (is_index_key_file_exists(p_index_key)) ? (load_and_lock_index_info(p_index_key, index_id_type)) : (NULL);
+    if (p_index_info == NULL)
+    {
+        leave_index_context_request();
+        return false;
+    }
+
+    index_info_sync_read_wait(p_index_info);
+    index_info_file_lock_read(p_index_info);
+    update_index_info_status_to_reading(p_index_info);
+    unlock_index_info_sync(p_index_info);
+
+    sync_index_node_cache(p_index_info);
+    update_index_statistics(p_index_info);
+
+    lock_index_node_cache(&(p_index_info->index_node_cache));
+    *p_index_statistics = p_index_info->index_statistics_info.statistics;
+    unlock_index_node_cache(&(p_index_info->index_node_cache));
+    if (p_index_info->index_properties.index_structure == INDEX_STRUCTURE_BTREE)
+    {
+        p_index_statistics->element_num += get_index_write_buffer_length(p_index_info);
+    }
+
+    lock_index_info_sync(p_index_info);
+    index_info_file_unlock_read(p_index_info);
+    update_index_info_status_from_reading(p_index_info);
+    index_info_sync_read_unblock(p_index_info);
+    unlock_index_info_sync(p_index_info);
+    leave_index_context_request();
+
+    return true;
+}
+
+// Estimate the number of elements whose index ids are in [lower, upper] by the statistics, NULL bound means unbounded.
+// Set both bounds to the same index id to estimate the equal search. A hash index estimates the equal search only.
+// return value: estimated number of elements, 0 if the index doesn't exist.
+uint64_t Index_Api_Estimate_Range(char *p_index_key, void *p_lower_index_id, void *p_upper_index_id, INDEX_ID_TYPE_E index_id_type)
+{
+    INDEX_INFO_T *p_index_info = NULL;
+    uint64_t estimated_num = 0;
+
+    if (enter_index_context_request() == false)
+    {
+        return 0;
+    }
+
+    p_index_info = (is_index_key_file_exists(p_index_key)) ? (load_and_lock_index_info(p_index_key, index_id_type)) : (NULL);
+    if (p_index_info == NULL)
+    {
+        leave_index_context_request();
+        return 0;
+    }
+
+    index_info_sync_read_wait(p_index_info);
+    index_info_file_lock_read(p_index_info);
+    update_index_info_status_to_reading(p_index_info);
+    unlock_index_info_sync(p_index_info);
+
+    sync_index_node_cache(p_index_info);
+    update_index_statistics(p_index_info);
+    estimated_num = estimate_index_statistics_range(p_index_info, p_lower_index_id, p_upper_index_id);
+
+    // The buffered elements are counted exactly.
+    if (p_index_info->index_properties.index_structure == INDEX_STRUCTURE_BTREE)
+    {
+        uint8_t *p_buffered_index_ids = NULL, *p_buffered_payloads = NULL;
+
+        estimated_num += collect_index_write_buffer_elements(p_index_info, p_lower_index_id, p_upper_index_id, &p_buffered_index_ids, &p_buffered_payloads);
+        free(p_buffered_index_ids);
+        free(p_buffered_payloads);
+    }
+
+    lock_index_info_sync(p_index_info);
+    index_info_file_unlock_read(p_index_info);
+    update_index_info_status_from_reading(p_index_info);
+    index_info_sync_read_unblock(p_index_info);
+    unlock_index_info_sync(p_index_info);
+    leave_index_context_request();
+
+    return estimated_num;
+}
+
+static inline void lock_index_context_sync()
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_t *p_mutex = &(index_context_sync.mutex);
+    pthread_mutex_lock(p_mutex);
+#endif
+}
+
+static inline void unlock_index_context_sync()
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_t *p_mutex = &(index_context_sync.mutex);
+    pthread_mutex_unlock(p_mutex);
+#endif
+}
+
+// Lock the index_context before using this funtion.
 void update_index_context_status(INDEX_CONTEXT_STATUS_E new_status)
 {
-    INDEX_CONTEXT_STATUS_E *p_status = &(index_context_sync.status);
-    INDEX_CONTEXT_STATUS_E current_status = *p_status;
+    INDEX_CONTEXT_STATUS_E current_status = atomic_load(&(index_context_sync.status));
     bool is_valid_transition = false;
 
     switch (current_status)
@@ -416,7 +1331,7 @@ void update_index_context_status(INDEX_CONTEXT_STATUS_E new_status)
 
     if (is_valid_transition)
     {
-        *p_status = new_status;
+        atomic_store(&(index_context_sync.status), new_status);
     }
     else
     {
@@ -426,7 +1341,34 @@ void update_index_context_status(INDEX_CONTEXT_STATUS_E new_status)
 
 static inline bool check_index_context_status(INDEX_CONTEXT_STATUS_E status)
 {
-    return (index_context_sync.status == status);
+    return (atomic_load(&(index_context_sync.status)) == status);
+}
+
+// Count the request before checking the status, Index_Api_Close() changes the status before waiting for the counted requests.
+// Return false if the index context is not ready, the request is not counted then.
+static inline bool enter_index_context_request()
+{
+    atomic_fetch_add(&(index_context_sync.request_num), 1);
+    if (check_index_context_status(INDEX_CONTEXT_STATUS_READY) == false)
+    {
+        leave_index_context_request();
+        return false;
+    }
+
+    return true;
+}
+
+static inline void leave_index_context_request()
+{
+    if ((atomic_fetch_sub(&(index_context_sync.request_num), 1) == 1) && (check_index_context_status(INDEX_CONTEXT_STATUS_READY) == false))
+    {
+        // The last request wakes up Index_Api_Close().
+        lock_index_context_sync();
+#if IS_POSIX_API_SUPPORT
+        pthread_cond_broadcast(&(index_context_sync.close_cond));
+#endif
+        unlock_index_context_sync();
+    }
 }
 
 bool set_index_directory_path(char *p_index_directory_path)
@@ -492,109 +1434,471 @@ bool is_index_key_file_exists(char *p_index_key)
     }
 }
 
-void get_index_file_path_by_index_key(char *p_index_file_path, char *p_index_key)
+// index_id_type and index_structure are decided when the index file is created and never changed, so they're read without the file lock.
+// p_index_structure: set to the index structure if the index file exists and it isn't NULL.
+INDEX_ID_TYPE_E read_index_file_index_format(char *p_index_key, INDEX_STRUCTURE_E *p_index_structure)
 {
-    // Default: index_directory_path/index_key.index
-    // TODO: check p_key contains sensitive keywords. e.g. '/'
-
-    char file_extension[] = ".faciledb_index";
+    INDEX_ID_TYPE_E index_id_type = INDEX_ID_TYPE_INVALID;
+    uint32_t index_id_type_32 = INDEX_ID_TYPE_INVALID;
+    uint32_t format_header[2] = {0}; // magic and format_version
+    char index_file_path[INDEX_FILE_PATH_BUFFER_LENGTH] = {0};
+    // index_id_type is stored in the lower bits of the uint32 after magic, format_version, tag_num and root_tag.
+    off_t offset = INDEX_FILE_FORMAT_HEADER_SIZE + sizeof(uint32_t) * 2;
 
-    if (strlen(index_directory_path) + strlen(p_index_key) + strlen(file_extension) > INDEX_FILE_PATH_MAX_LENGTH)
+    // The loaded index info has the same index_id_type as its index file.
+    INDEX_INFO_T *p_index_info = query_and_lock_index_info_loaded(p_index_key, strlen(p_index_key));
+    if (p_index_info != NULL)
     {
-        p_index_file_path[0] = '\0';
+        if (p_index_structure != NULL)
+        {
+            *p_index_structure = p_index_info->index_properties.index_structure;
+        }
+        index_id_type = p_index_info->index_properties.index_id_type;
+        unlock_index_info_sync(p_index_info);
+        return index_id_type;
     }
-    else
+
+    get_index_file_path_by_index_key(index_file_path, p_index_key);
+    if (index_file_path[0] == '\0')
     {
-        strcpy(p_index_file_path, index_directory_path);
-        strcat(p_index_file_path, p_index_key);
-        strcat(p_index_file_path, file_extension);
-        p_index_file_path[INDEX_FILE_PATH_MAX_LENGTH] = '\0';
+        return INDEX_ID_TYPE_INVALID;
     }
-}
 
-// Initialize all index info instances when index_context_status is INDEX_CONTEXT_STATUS_UNUSED.
-void index_info_instances_init()
-{
-    for (uint32_t i = 0; i < INDEX_INFO_INSTANCE_NUM; i++)
+#if IS_POSIX_API_SUPPORT
+    int fd = open(index_file_path, O_RDONLY);
+    if (fd >= 0)
     {
-        lock_index_info_sync(&(index_info_instance[i]));
-
-        index_info_init(&(index_info_instance[i]));
-
-        unlock_index_info_sync(&(index_info_instance[i]));
+        if ((pread(fd, format_header, sizeof(format_header), 0) != sizeof(format_header)) ||
+            (pread(fd, &index_id_type_32, sizeof(index_id_type_32), offset) != sizeof(index_id_type_32)))
+        {
+            // The index file is being created.
+            index_id_type_32 = INDEX_ID_TYPE_INVALID;
+        }
+        close(fd);
     }
-}
-
-void index_info_instances_close()
-{
-    for (uint32_t i = 0; i < INDEX_INFO_INSTANCE_NUM; i++)
+#else  // IS_POSIX_API_SUPPORT
+    FILE *p_index_file = fopen(index_file_path, "rb");
+    if (p_index_file != NULL)
+    {
+        if ((fread(format_header, sizeof(format_header), 1, p_index_file) != 1) ||
+            (fseek(p_index_file, offset, SEEK_SET) != 0) ||
+            (fread(&index_id_type_32, sizeof(index_id_type_32), 1, p_index_file) != 1))
+        {
+            index_id_type_32 = INDEX_ID_TYPE_INVALID;
+        }
+        fclose(p_index_file);
+    }
+#endif // IS_POSIX_API_SUPPORT
+
+    // The index file of another format version can't be loaded.
+    if ((format_header[0] != INDEX_FILE_MAGIC) || (format_header[1] != INDEX_FILE_FORMAT_VERSION))
+    {
+        index_id_type_32 = INDEX_ID_TYPE_INVALID;
+    }
+
+    if (((index_id_type_32 & INDEX_FORMAT_ID_TYPE_MASK) < INDEX_ID_TYPE_NUM) && (p_index_structure != NULL))
+    {
+        *p_index_structure = (INDEX_STRUCTURE_E)((index_id_type_32 >> INDEX_FORMAT_STRUCTURE_SHIFT) & INDEX_FORMAT_STRUCTURE_MASK);
+    }
+
+    index_id_type_32 &= INDEX_FORMAT_ID_TYPE_MASK;
+    if (index_id_type_32 < INDEX_ID_TYPE_NUM)
+    {
+        index_id_type = (INDEX_ID_TYPE_E)index_id_type_32;
+    }
+
+    return index_id_type;
+}
+
+void get_index_file_path_by_index_key(char *p_index_file_path, char *p_index_key)
+{
+    // Default: index_directory_path/index_key.index
+    // TODO: check p_key contains sensitive keywords. e.g. '/'
+
+    char file_extension[] = ".faciledb_index";
+
+    if (strlen(index_directory_path) + strlen(p_index_key) + strlen(file_extension) > INDEX_FILE_PATH_MAX_LENGTH)
+    {
+        p_index_file_path[0] = '\0';
+    }
+    else
+    {
+        strcpy(p_index_file_path, index_directory_path);
+        strcat(p_index_file_path, p_index_key);
+        strcat(p_index_file_path, file_extension);
+        p_index_file_path[INDEX_FILE_PATH_MAX_LENGTH] = '\0';
+    }
+}
+
+// index_directory_path/index_key.faciledb_index_buffer, the empty string if the path is too long.
+void get_index_write_buffer_file_path_by_index_key(char *p_write_buffer_file_path, char *p_index_key)
+{
+    char file_extension[] = ".faciledb_index_buffer";
+
+    if (strlen(index_directory_path) + strlen(p_index_key) + strlen(file_extension) > INDEX_FILE_PATH_MAX_LENGTH)
+    {
+        p_write_buffer_file_path[0] = '\0';
+    }
+    else
+    {
+        strcpy(p_write_buffer_file_path, index_directory_path);
+        strcat(p_write_buffer_file_path, p_index_key);
+        strcat(p_write_buffer_file_path, file_extension);
+    }
+}
+
+static inline void lock_index_info_pool_sync()
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_lock(&(index_info_pool.mutex));
+#endif
+}
+
+static inline void unlock_index_info_pool_sync()
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_unlock(&(index_info_pool.mutex));
+#endif
+}
+
+static inline void lock_index_info_bucket_sync(uint32_t bucket)
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_lock(&(index_info_pool.bucket_mutex[bucket]));
+#endif
+}
+
+static inline void unlock_index_info_bucket_sync(uint32_t bucket)
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_unlock(&(index_info_pool.bucket_mutex[bucket]));
+#endif
+}
+
+// Wait until the release sequence is counted after release_sequence was read, i.e. an instance may be requested again.
+// The pool must not be locked, release_sequence is read before the instances are checked.
+static inline void index_info_pool_sync_release_wait(uint64_t release_sequence)
+{
+#if IS_POSIX_API_SUPPORT
+    atomic_fetch_add(&(index_info_pool.release_waiting_count), 1);
+    pthread_mutex_lock(&(index_info_pool.release_mutex));
+    while (atomic_load(&(index_info_pool.release_sequence)) == release_sequence)
+    {
+        pthread_cond_wait(&(index_info_pool.release_cond), &(index_info_pool.release_mutex));
+    }
+    pthread_mutex_unlock(&(index_info_pool.release_mutex));
+    atomic_fetch_sub(&(index_info_pool.release_waiting_count), 1);
+#endif
+}
+
+// Count the release sequence after an instance becomes idle or released, the index info may be locked.
+// The waiters count themselves before checking the sequence, so the condition is broadcast only if someone waits.
+static inline void index_info_pool_sync_release_notify()
+{
+    atomic_fetch_add(&(index_info_pool.release_sequence), 1);
+#if IS_POSIX_API_SUPPORT
+    if (atomic_load(&(index_info_pool.release_waiting_count)) > 0)
+    {
+        pthread_mutex_lock(&(index_info_pool.release_mutex));
+        pthread_cond_broadcast(&(index_info_pool.release_cond));
+        pthread_mutex_unlock(&(index_info_pool.release_mutex));
+    }
+#endif
+}
+
+// Initialize all index info instances when index_context_status is INDEX_CONTEXT_STATUS_INITIALIZING.
+void index_info_instances_init()
+{
+    atomic_store(&(index_info_pool.tick), 0);
+    for (uint32_t i = 0; i < INDEX_INFO_BUCKET_NUM; i++)
+    {
+#if IS_POSIX_API_SUPPORT
+        if (index_info_pool.is_sync_initialized == false)
+        {
+            pthread_mutex_init(&(index_info_pool.bucket_mutex[i]), NULL);
+        }
+#endif
+        index_info_pool.bucket[i] = INDEX_INFO_NULL_INSTANCE;
+    }
+
+    for (uint32_t i = 0; i < INDEX_INFO_INSTANCE_NUM; i++)
+    {
+        INDEX_INFO_T *p_index_info = &(index_info_instance[i]);
+
+#if IS_POSIX_API_SUPPORT
+        if (index_info_pool.is_sync_initialized == false)
+        {
+            pthread_mutex_init(&(p_index_info->index_info_sync.mutex), NULL);
+            pthread_cond_init(&(p_index_info->index_info_sync.read_cond), NULL);
+            pthread_cond_init(&(p_index_info->index_info_sync.write_cond), NULL);
+            pthread_cond_init(&(p_index_info->index_info_sync.close_cond), NULL);
+            pthread_mutex_init(&(p_index_info->index_node_cache.mutex), NULL);
+            pthread_rwlock_init(&(p_index_info->index_node_cache.root_latch), NULL);
+            for (uint32_t j = 0; j < INDEX_NODE_CACHE_SIZE; j++)
+            {
+                pthread_rwlock_init(&(p_index_info->index_node_cache.entries[j].latch), NULL);
+            }
+        }
+#endif
+
+        lock_index_info_sync(p_index_info);
+
+        index_info_init(p_index_info);
+        atomic_store(&(p_index_info->last_used_tick), 0);
+        p_index_info->next_instance = INDEX_INFO_NULL_INSTANCE;
+        p_index_info->index_key_size = 0;
+        p_index_info->index_key[0] = '\0';
+
+        unlock_index_info_sync(p_index_info);
+    }
+    index_info_pool.is_sync_initialized = true;
+}
+
+void index_info_instances_close()
+{
+    lock_index_info_pool_sync();
+    for (uint32_t i = 0; i < INDEX_INFO_INSTANCE_NUM; i++)
     {
         INDEX_INFO_T *p_index_info = &(index_info_instance[i]);
 
         lock_index_info_sync(p_index_info);
+        release_index_info_instance(p_index_info);
+        unlock_index_info_sync(p_index_info);
+    }
+    unlock_index_info_pool_sync();
+}
 
-        if (check_index_info_status(p_index_info, INDEX_INFO_STATUS_RELEASED))
+static inline uint32_t get_index_info_bucket(char *p_index_key, uint32_t index_key_size)
+{
+    return Hash((uint8_t *)p_index_key, index_key_size) % INDEX_INFO_BUCKET_NUM;
+}
+
+// The least recently used instance is closed first, the tick is updated without the pool locked.
+static inline void touch_index_info_instance(INDEX_INFO_T *p_index_info)
+{
+    atomic_store(&(p_index_info->last_used_tick), atomic_fetch_add(&(index_info_pool.tick), 1) + 1);
+}
+
+// Return the instance linked to the index key, or NULL if the index file is not open or being opened.
+// Only the bucket of the index key is locked, the instance should be checked again after it's locked.
+INDEX_INFO_T *query_index_info_instance(char *p_index_key, uint32_t index_key_size)
+{
+    uint32_t bucket = get_index_info_bucket(p_index_key, index_key_size);
+    INDEX_INFO_T *p_target_index_info = NULL;
+
+    lock_index_info_bucket_sync(bucket);
+    for (int32_t instance_position = index_info_pool.bucket[bucket]; instance_position != INDEX_INFO_NULL_INSTANCE;)
+    {
+        INDEX_INFO_T *p_index_info = &(index_info_instance[instance_position]);
+
+        if ((p_index_info->index_key_size == index_key_size) && (memcmp(p_index_info->index_key, p_index_key, index_key_size) == 0))
         {
-            unlock_index_info_sync(p_index_info);
-            continue;
+            p_target_index_info = p_index_info;
+            break;
         }
+        instance_position = p_index_info->next_instance;
+    }
+    unlock_index_info_bucket_sync(bucket);
+
+    return p_target_index_info;
+}
+
+// Link the instance to the hash bucket of its index key.
+// Lock the pool and the index info before using this function.
+void link_index_info_instance(INDEX_INFO_T *p_index_info)
+{
+    uint32_t bucket = get_index_info_bucket(p_index_info->index_key, p_index_info->index_key_size);
+
+    lock_index_info_bucket_sync(bucket);
+    p_index_info->next_instance = index_info_pool.bucket[bucket];
+    index_info_pool.bucket[bucket] = (int32_t)(p_index_info - index_info_instance);
+    unlock_index_info_bucket_sync(bucket);
+}
+
+// Lock the pool and the index info before using this function.
+void unlink_index_info_instance(INDEX_INFO_T *p_index_info)
+{
+    uint32_t bucket = get_index_info_bucket(p_index_info->index_key, p_index_info->index_key_size);
+
+    lock_index_info_bucket_sync(bucket);
+    for (int32_t *p_instance_position = &(index_info_pool.bucket[bucket]); *p_instance_position != INDEX_INFO_NULL_INSTANCE;)
+    {
+        INDEX_INFO_T *p_current_index_info = &(index_info_instance[*p_instance_position]);
+        if (p_current_index_info == p_index_info)
+        {
+            *p_instance_position = p_index_info->next_instance;
+            break;
+        }
+        p_instance_position = &(p_current_index_info->next_instance);
+    }
+    p_index_info->next_instance = INDEX_INFO_NULL_INSTANCE;
+    unlock_index_info_bucket_sync(bucket);
+
+    p_index_info->index_key_size = 0;
+    p_index_info->index_key[0] = '\0';
+}
+
+// Writers and readers using or waiting for the instance are its references, a referenced instance is busy.
+// Lock the index info before using this function.
+static inline bool is_index_info_instance_busy(INDEX_INFO_T *p_index_info)
+{
+    INDEX_INFO_SYNC_T *p_index_info_sync = &(p_index_info->index_info_sync);
+
+    return (check_index_info_status(p_index_info, INDEX_INFO_STATUS_READY) == false) || (p_index_info_sync->writer_waiting_count > 0) || (p_index_info_sync->reader_waiting_count > 0) || (p_index_info_sync->reader_count > 0);
+}
+
+// Wait until the instance is not busy, then close its index file.
+// Lock the pool and the index info before using this function.
+void release_index_info_instance(INDEX_INFO_T *p_index_info)
+{
+    if (check_index_info_status(p_index_info, INDEX_INFO_STATUS_RELEASED))
+    {
+        return;
+    }
+
+    index_info_sync_close_wait(p_index_info);
+    update_index_info_status(p_index_info, INDEX_INFO_STATUS_CLOSING);
+
+    unlink_index_info_instance(p_index_info);
+    close_index_info(p_index_info);
 
-        index_info_sync_close_wait(p_index_info);
-        update_index_info_status(p_index_info, INDEX_INFO_STATUS_CLOSING);
+    update_index_info_status(p_index_info, INDEX_INFO_STATUS_RELEASED);
+}
 
-        close_index_info(p_index_info);
+// Release the instance over the open index file number, its references are waited without the pool locked.
+// The index file is closed with the pool locked as the other releases do, so no request opens it meanwhile.
+void release_excess_index_info_instance(uint32_t instance_position)
+{
+    INDEX_INFO_T *p_index_info = &(index_info_instance[instance_position]);
 
-        update_index_info_status(p_index_info, INDEX_INFO_STATUS_RELEASED);
+    lock_index_info_pool_sync();
+    lock_index_info_sync(p_index_info);
+    // The instance is kept if the number is raised again meanwhile.
+    while ((instance_position >= index_info_pool.instance_num) && is_index_info_instance_busy(p_index_info) && (check_index_info_status(p_index_info, INDEX_INFO_STATUS_RELEASED) == false))
+    {
+        unlock_index_info_pool_sync();
+        index_info_sync_idle_wait(p_index_info);
         unlock_index_info_sync(p_index_info);
+
+        lock_index_info_pool_sync();
+        lock_index_info_sync(p_index_info);
+    }
+
+    if (instance_position >= index_info_pool.instance_num)
+    {
+        release_index_info_instance(p_index_info);
     }
+    unlock_index_info_sync(p_index_info);
+    unlock_index_info_pool_sync();
 }
 
-// todo: using fifo queue or lru algorithm.
+// Return a released instance, or close the least recently used index file which is not busy.
+// Return NULL if all the instances are busy, the busy instances are not waited with the pool locked, see index_info_pool_sync_release_wait().
+// Lock the pool before using this function.
 INDEX_INFO_T *request_and_lock_released_index_info_instance()
 {
-    INDEX_INFO_T *p_index_info = NULL;
-#if INDEX_INFO_INSTANCE_NUM == 1
-    p_index_info = &(index_info_instance[0]);
-    lock_index_info_sync(p_index_info);
+    INDEX_INFO_T *p_victim_index_info = NULL;
+
+    for (uint32_t i = 0; i < index_info_pool.instance_num; i++)
+    {
+        INDEX_INFO_T *p_index_info = &(index_info_instance[i]);
+
+        lock_index_info_sync(p_index_info);
+        if (check_index_info_status(p_index_info, INDEX_INFO_STATUS_RELEASED))
+        {
+            return p_index_info;
+        }
 
-    if (check_index_info_status(p_index_info, INDEX_INFO_STATUS_RELEASED) == false)
+        if ((is_index_info_instance_busy(p_index_info) == false) &&
+            ((p_victim_index_info == NULL) || (atomic_load(&(p_index_info->last_used_tick)) < atomic_load(&(p_victim_index_info->last_used_tick)))))
+        {
+            p_victim_index_info = p_index_info;
+        }
+        unlock_index_info_sync(p_index_info);
+    }
+
+    if (p_victim_index_info == NULL)
     {
-        index_info_sync_close_wait(p_index_info);
-        update_index_info_status(p_index_info, INDEX_INFO_STATUS_CLOSING);
-        close_index_info(p_index_info);
-        update_index_info_status(p_index_info, INDEX_INFO_STATUS_RELEASED);
+        return NULL;
     }
 
-    return p_index_info;
-#endif
+    // The requests using the victim lock it after the lookup without the pool locked, it may be busy again.
+    lock_index_info_sync(p_victim_index_info);
+    if (is_index_info_instance_busy(p_victim_index_info))
+    {
+        unlock_index_info_sync(p_victim_index_info);
+        return NULL;
+    }
+    release_index_info_instance(p_victim_index_info);
+
+    return p_victim_index_info;
 }
 
 void create_new_index_file_format(INDEX_INFO_T *p_index_info, uint8_t *p_key, uint32_t key_size, INDEX_ID_TYPE_E index_id_type)
 {
     INDEX_PROPERTIES_T *p_index_properties = &(p_index_info->index_properties);
     INDEX_NODE_T first_node;
+    // The settings may be changed meanwhile, the new index file follows the values read here.
+    INDEX_STRUCTURE_E structure = atomic_load(&index_structure);
+    uint32_t node_size = atomic_load(&index_node_size);
 
     allocate_index_properties_resources(p_index_properties, key_size);
 
-    p_index_properties->p_key = malloc(key_size * sizeof(uint8_t));
     memcpy(p_index_properties->p_key, p_key, key_size);
     p_index_properties->key_size = key_size;
     p_index_properties->root_tag = 0;
     // insert an empty node with node tag: 1
     p_index_properties->tag_num = 1;
     p_index_properties->index_id_type = index_id_type;
+    p_index_properties->index_structure = structure;
+    p_index_properties->change_sequence = 0;
+    p_index_properties->order = get_index_order_by_node_size(node_size, index_id_type);
+    p_index_properties->node_size = get_index_node_image_size(p_index_properties->order, Index_Id_Type_Get_Size(index_id_type));
+    // Keep the node aligned to the configured node size if it fits.
+    if (p_index_properties->node_size < node_size)
+    {
+        p_index_properties->node_size = node_size;
+    }
+    // The non-leaf nodes of the B+ tree route the searches only, they store the separator index ids without the payloads.
+    p_index_properties->internal_order = 0;
+    p_index_properties->compressed_order = 0;
+    p_index_properties->compressed_internal_order = 0;
+    if (structure == INDEX_STRUCTURE_BTREE)
+    {
+        p_index_properties->internal_order = get_index_internal_order_by_node_size(p_index_properties->node_size, index_id_type);
+        set_index_compressed_orders(p_index_properties);
+    }
+#ifdef INDEX_ORDER
+    // fixed order, until the node size is set by Index_Api_Set_Node_Size().
+    if (node_size == 0)
+    {
+        p_index_properties->order = INDEX_ORDER;
+        p_index_properties->node_size = get_index_node_image_size(INDEX_ORDER, Index_Id_Type_Get_Size(index_id_type));
+        p_index_properties->internal_order = (structure == INDEX_STRUCTURE_BTREE) ? (INDEX_ORDER) : (0);
+        p_index_properties->compressed_order = 0;
+        p_index_properties->compressed_internal_order = 0;
+    }
+#endif
 
-    index_node_init(&first_node, p_index_properties->tag_num);
+    index_node_init(&first_node, p_index_properties->tag_num, p_index_properties);
     p_index_properties->root_tag = first_node.tag;
 
+    if (p_index_properties->index_structure == INDEX_STRUCTURE_HASH)
+    {
+        // The first node is the root directory, the directory node and the first bucket are written with it.
+        create_new_hash_index_nodes(p_index_info, &first_node);
+    }
+
     // write to file
     write_index_properties(p_index_info);
     write_index_node(p_index_info, &first_node);
+    // The write buffer file left by a removed index file doesn't belong to the new one.
+    remove(p_index_info->index_write_buffer.file_path);
 
     free_index_node_resources(&first_node);
 }
 
-bool read_and_check_index_file_format(INDEX_INFO_T *p_index_info, uint8_t *p_key, uint32_t key_size, INDEX_ID_TYPE_E index_id_type)
+INDEX_FILE_FORMAT_CHECK_E read_and_check_index_file_format(INDEX_INFO_T *p_index_info, uint8_t *p_key, uint32_t key_size, INDEX_ID_TYPE_E index_id_type)
 {
     INDEX_PROPERTIES_T *p_index_properties = &(p_index_info->index_properties);
     // create a temporary index_properties to calcualte the size.
@@ -604,6 +1908,19 @@ bool read_and_check_index_file_format(INDEX_INFO_T *p_index_info, uint8_t *p_key
 #if IS_POSIX_API_SUPPORT
     int fd = fileno(p_index_info->index_file);
     off_t file_size = lseek(fd, 0, SEEK_END);
+    uint32_t format_header[2] = {0}; // magic and format_version
+
+    if (file_size < (off_t)sizeof(format_header))
+    {
+        return INDEX_FILE_FORMAT_INCOMPLETE;
+    }
+
+    // Check the magic number and the format version before reading the rest, their layout may differ.
+    pread(fd, format_header, sizeof(format_header), 0);
+    if ((format_header[0] != INDEX_FILE_MAGIC) || (format_header[1] != INDEX_FILE_FORMAT_VERSION))
+    {
+        return INDEX_FILE_FORMAT_MISMATCHED;
+    }
 
     if (file_size >= expected_index_properties_size)
     {
@@ -611,18 +1928,18 @@ bool read_and_check_index_file_format(INDEX_INFO_T *p_index_info, uint8_t *p_key
 
         if ((p_index_properties->key_size == key_size) && (memcmp(p_index_properties->p_key, p_key, key_size) == 0) && (p_index_properties->index_id_type == index_id_type))
         {
-            return true;
+            return INDEX_FILE_FORMAT_MATCHED;
         }
         else
         {
             free_index_properties_resources(p_index_properties);
             index_properties_init(p_index_properties);
-            return false;
+            return INDEX_FILE_FORMAT_MISMATCHED;
         }
     }
     else
     {
-        return false;
+        return INDEX_FILE_FORMAT_INCOMPLETE;
     }
 #endif
 }
@@ -633,11 +1950,18 @@ void index_info_init(INDEX_INFO_T *p_index_info)
 
     index_properties_init(&(p_index_info->index_properties));
     index_info_sync_init(&(p_index_info->index_info_sync));
+    index_node_cache_init(&(p_index_info->index_node_cache));
+    index_write_buffer_init(&(p_index_info->index_write_buffer));
+    index_statistics_info_init(&(p_index_info->index_statistics_info));
+    p_index_info->lower_bound_function = NULL;
 }
 
 void close_index_info(INDEX_INFO_T *p_index_info)
 {
     // writeback_index_properties();
+    close_index_node_cache(p_index_info);
+    close_index_write_buffer(&(p_index_info->index_write_buffer));
+    free_index_statistics_info_resources(&(p_index_info->index_statistics_info));
     close_index_properties(&(p_index_info->index_properties));
 
     if (p_index_info->index_file != NULL)
@@ -647,49 +1971,84 @@ void close_index_info(INDEX_INFO_T *p_index_info)
     }
 }
 
-INDEX_INFO_T *query_and_lock_index_info_loaded(char *p_index_key, uint32_t index_key_size, INDEX_ID_TYPE_E index_id_type)
+// Lock the index info of the index key and check if it's loaded.
+// The pool isn't locked, the instance is checked again after it's locked since it could be closed and reused meanwhile.
+// Return NULL if the index file is not loaded.
+INDEX_INFO_T *query_and_lock_index_info_loaded(char *p_index_key, uint32_t index_key_size)
 {
-    INDEX_INFO_T *p_index_info = NULL;
-
-#if (INDEX_INFO_INSTANCE_NUM == 1)
-    p_index_info = &(index_info_instance[0]);
+    INDEX_INFO_T *p_index_info = query_index_info_instance(p_index_key, index_key_size);
 
-    lock_index_info_sync(p_index_info);
-    if (check_index_info_status_available(p_index_info))
+    if (p_index_info == NULL)
     {
-        uint32_t min_key_compare_length = (index_key_size > p_index_info->index_properties.key_size) ? (p_index_info->index_properties.key_size) : (index_key_size);
-        if ((index_key_size != p_index_info->index_properties.key_size) || (memcmp(p_index_info->index_properties.p_key, p_index_key, min_key_compare_length) != 0) || (index_info_instance[0].index_properties.index_id_type != index_id_type))
-        {
-            unlock_index_info_sync(p_index_info);
-            p_index_info = NULL;
-        }
+        return NULL;
     }
-    else
+    touch_index_info_instance(p_index_info);
+
+    lock_index_info_sync(p_index_info);
+    if ((check_index_info_status_available(p_index_info) == false) ||
+        (p_index_info->index_key_size != index_key_size) || (memcmp(p_index_info->index_key, p_index_key, index_key_size) != 0))
     {
         unlock_index_info_sync(p_index_info);
-        p_index_info = NULL;
+        return NULL;
     }
 
     return p_index_info;
-#endif
 }
 
+// The pool is locked only to link an instance to the index key, the index file is read or created with the index info locked.
+// Return NULL if the index file can't be loaded, or it's loaded with another index id type.
 INDEX_INFO_T *load_and_lock_index_info(char *p_key, INDEX_ID_TYPE_E index_id_type)
 {
     INDEX_INFO_T *p_index_info = NULL;
+    uint32_t key_size = strnlen(p_key, INDEX_FILE_PATH_MAX_LENGTH);
     char index_file_path[INDEX_FILE_PATH_BUFFER_LENGTH] = {0};
 
-    p_index_info = query_and_lock_index_info_loaded(p_key, strlen(p_key), index_id_type);
-    if (p_index_info != NULL)
+    while (p_index_info == NULL)
     {
-        return p_index_info;
-    }
+        bool is_loading = false;
+        uint64_t release_sequence = 0;
+
+        p_index_info = query_and_lock_index_info_loaded(p_key, key_size);
+        if (p_index_info != NULL)
+        {
+            if (p_index_info->index_properties.index_id_type != index_id_type)
+            {
+                unlock_index_info_sync(p_index_info);
+                return NULL;
+            }
+            return p_index_info;
+        }
+
+        // The index info is not loaded, link an instance to the index key with the pool locked, the others wait for it by the index info mutex.
+        lock_index_info_pool_sync();
+        release_sequence = atomic_load(&(index_info_pool.release_sequence));
+        is_loading = (query_index_info_instance(p_key, key_size) != NULL);
+        if (is_loading == false)
+        {
+            p_index_info = request_and_lock_released_index_info_instance();
+        }
+
+        if (p_index_info != NULL)
+        {
+            index_info_init(p_index_info);
+            update_index_info_status(p_index_info, INDEX_INFO_STATUS_STARTING);
+            p_index_info->index_key_size = key_size;
+            memcpy(p_index_info->index_key, p_key, key_size);
+            p_index_info->index_key[key_size] = '\0';
+            link_index_info_instance(p_index_info);
+            touch_index_info_instance(p_index_info);
+        }
+        unlock_index_info_pool_sync();
 
-    p_index_info = request_and_lock_released_index_info_instance();
-    index_info_init(p_index_info);
-    update_index_info_status(p_index_info, INDEX_INFO_STATUS_STARTING);
+        if ((p_index_info == NULL) && (is_loading == false))
+        {
+            // All the instances are busy, wait for one of them to be idle.
+            index_info_pool_sync_release_wait(release_sequence);
+        }
+    }
 
     get_index_file_path_by_index_key(index_file_path, p_key);
+    get_index_write_buffer_file_path_by_index_key(p_index_info->index_write_buffer.file_path, p_key);
 
 #if IS_POSIX_API_SUPPORT
     // Create index file if not exist.
@@ -704,7 +2063,7 @@ INDEX_INFO_T *load_and_lock_index_info(char *p_key, INDEX_ID_TYPE_E index_id_typ
             perror("Index file unavailable: ");
 
             close(fd);
-            unlock_index_info_sync(p_index_info);
+            abort_index_info_loading(p_index_info);
             return NULL;
         }
 
@@ -715,7 +2074,7 @@ INDEX_INFO_T *load_and_lock_index_info(char *p_key, INDEX_ID_TYPE_E index_id_typ
     }
     else if (errno == EEXIST)
     {
-        bool timeout = true;
+        INDEX_FILE_FORMAT_CHECK_E format_check = INDEX_FILE_FORMAT_INCOMPLETE;
 
         // File exists
         fd = open(index_file_path, O_RDWR);
@@ -724,7 +2083,7 @@ INDEX_INFO_T *load_and_lock_index_info(char *p_key, INDEX_ID_TYPE_E index_id_typ
             // Open existing file failed
             perror("Index file unavailable: ");
 
-            unlock_index_info_sync(p_index_info);
+            abort_index_info_loading(p_index_info);
             return NULL;
         }
 
@@ -736,33 +2095,32 @@ INDEX_INFO_T *load_and_lock_index_info(char *p_key, INDEX_ID_TYPE_E index_id_typ
             perror("Index file unavailable: ");
 
             close(fd);
-            unlock_index_info_sync(p_index_info);
+            abort_index_info_loading(p_index_info);
             return NULL;
         }
 
         // Read index_properties from file.
-        // Sleep a while and try again
+        // Sleep a while and try again if the index file is being created.
         for (uint32_t check_time = 0; check_time < INDEX_FILE_OPEN_CHECK_TIMEOUT; check_time++)
         {
             index_info_file_lock_read(p_index_info);
-            if (read_and_check_index_file_format(p_index_info, (uint8_t *)p_key, strlen(p_key), index_id_type) == true)
+            format_check = read_and_check_index_file_format(p_index_info, (uint8_t *)p_key, strlen(p_key), index_id_type);
+            index_info_file_unlock_read(p_index_info);
+
+            if (format_check != INDEX_FILE_FORMAT_INCOMPLETE)
             {
-                index_info_file_unlock_read(p_index_info);
-                timeout = false;
                 break;
             }
-            else
-            {
-                // wait and retry
-                index_info_file_unlock_read(p_index_info);
-                usleep(INDEX_FILE_OPEN_CHECK_INTERVAL_US);
-            }
+            // wait and retry
+            usleep(INDEX_FILE_OPEN_CHECK_INTERVAL_US);
         }
 
-        if (timeout)
+        if (format_check != INDEX_FILE_FORMAT_MATCHED)
         {
-            // TODO: error message
-            assert(0);
+            fprintf(stderr, "Index file unavailable: %s has another format version, index key or index id type, or it's not created completely.\n", index_file_path);
+
+            abort_index_info_loading(p_index_info);
+            return NULL;
         }
     }
     else
@@ -770,7 +2128,7 @@ INDEX_INFO_T *load_and_lock_index_info(char *p_key, INDEX_ID_TYPE_E index_id_typ
         // Open file failed
         perror("Index file unavailable: ");
 
-        unlock_index_info_sync(p_index_info);
+        abort_index_info_loading(p_index_info);
         return NULL;
     }
 #else  // IS_POSIX_API_SUPPORT
@@ -788,7 +2146,7 @@ INDEX_INFO_T *load_and_lock_index_info(char *p_key, INDEX_ID_TYPE_E index_id_typ
             // index file unreadable or unwritable
             perror("Index file unavailable");
 
-            unlock_index_info_sync(p_index_info);
+            abort_index_info_loading(p_index_info);
             return NULL;
         }
 
@@ -805,7 +2163,7 @@ INDEX_INFO_T *load_and_lock_index_info(char *p_key, INDEX_ID_TYPE_E index_id_typ
             // create index file failed.
             perror("Index file unavailable: ");
 
-            unlock_index_info_sync(p_index_info);
+            abort_index_info_loading(p_index_info);
             return NULL;
         }
 
@@ -816,17 +2174,45 @@ INDEX_INFO_T *load_and_lock_index_info(char *p_key, INDEX_ID_TYPE_E index_id_typ
     }
 #endif // IS_POSIX_API_SUPPORT
 
+    // The cached nodes (none yet) belong to the loaded version of the index file.
+    p_index_info->index_node_cache.change_sequence = p_index_info->index_properties.change_sequence;
+    p_index_info->lower_bound_function = Index_Id_Search_Get_Lower_Bound_Function(p_index_info->index_properties.index_id_type);
+
     update_index_info_status(p_index_info, INDEX_INFO_STATUS_READY);
     return p_index_info;
 }
 
-// This function doesn't change index_info_status.
-void index_info_sync_init(INDEX_INFO_SYNC_T *p_index_info_sync)
+// Close the index file and release the instance which failed to load, the instance is unlocked.
+// The pool is locked before the index info as the lookup does, the others find the instance starting meanwhile and query it again.
+// Lock the index info before using this function.
+void abort_index_info_loading(INDEX_INFO_T *p_index_info)
 {
-    // p_index_info_sync->index_info_status = INDEX_INFO_STATUS_RELEASED;
-    p_index_info_sync->writer_waiting_count = 0;
-    p_index_info_sync->reader_waiting_count = 0;
+    unlock_index_info_sync(p_index_info);
+
+    lock_index_info_pool_sync();
+    lock_index_info_sync(p_index_info);
+
+    unlink_index_info_instance(p_index_info);
+    close_index_info(p_index_info);
+    update_index_info_status(p_index_info, INDEX_INFO_STATUS_RELEASED);
+#if IS_POSIX_API_SUPPORT
+    // The release of an excess instance waits for the loading, see index_info_sync_idle_wait().
+    pthread_cond_broadcast(&(p_index_info->index_info_sync.close_cond));
+#endif
+
+    unlock_index_info_sync(p_index_info);
+    unlock_index_info_pool_sync();
+    index_info_pool_sync_release_notify();
+}
+
+// This function doesn't change index_info_status.
+void index_info_sync_init(INDEX_INFO_SYNC_T *p_index_info_sync)
+{
+    // p_index_info_sync->index_info_status = INDEX_INFO_STATUS_RELEASED;
+    p_index_info_sync->writer_waiting_count = 0;
+    p_index_info_sync->reader_waiting_count = 0;
     p_index_info_sync->reader_count = 0;
+    p_index_info_sync->file_lock = INDEX_FILE_LOCK_NONE;
 }
 
 static void inline index_info_file_lock_write(INDEX_INFO_T *p_index_info)
@@ -850,6 +2236,7 @@ static void inline index_info_file_lock_write(INDEX_INFO_T *p_index_info)
         assert(0);
     }
 #endif
+    p_index_info->index_info_sync.file_lock = INDEX_FILE_LOCK_WRITE;
 }
 
 static void inline index_info_file_unlock_write(INDEX_INFO_T *p_index_info)
@@ -872,11 +2259,102 @@ static void inline index_info_file_unlock_write(INDEX_INFO_T *p_index_info)
         assert(0);
     }
 #endif
+    p_index_info->index_info_sync.file_lock = INDEX_FILE_LOCK_NONE;
+}
+
+// The read lock held by the readers of this process is converted to the write lock.
+// Lock the index info and update the status to latch writing before using this function, it's unlocked while waiting for the lock.
+// The readers finishing meanwhile keep the read lock for the conversion, the readers starting meanwhile wait for the write lock.
+static void inline index_info_file_lock_latch_write(INDEX_INFO_T *p_index_info)
+{
+#if IS_POSIX_API_SUPPORT
+    struct flock fl = {
+        .l_type = F_WRLCK, // write lock
+        .l_whence = SEEK_SET,
+        .l_start = 0,
+        .l_len = 0, // l_start = 0 && l_len = 0 means lock the whole file
+        .l_pid = 0  // unused
+    };
+    int fd = fileno(p_index_info->index_file);
+    INDEX_FILE_LOCK_E *p_file_lock = &(p_index_info->index_info_sync.file_lock);
+    bool is_locked = false;
+
+    while (is_locked == false)
+    {
+        INDEX_FILE_LOCK_E former_file_lock = *p_file_lock;
+        int result = 0, error = 0;
+
+        *p_file_lock = INDEX_FILE_LOCK_CONVERTING;
+        unlock_index_info_sync(p_index_info);
+        result = fcntl(fd, F_SETLKW, &fl);
+        error = errno;
+        lock_index_info_sync(p_index_info);
+        assert(check_index_info_status(p_index_info, INDEX_INFO_STATUS_LATCH_WRITING));
+
+        if (result != -1)
+        {
+            is_locked = true;
+        }
+        else if (error == EDEADLK)
+        {
+            // Another process is converting its read lock too, the readers of this process release the read lock after reading.
+            if ((former_file_lock == INDEX_FILE_LOCK_READ) && (p_index_info->index_info_sync.reader_count == 0))
+            {
+                index_info_file_unlock_write(p_index_info);
+            }
+            else
+            {
+                *p_file_lock = former_file_lock;
+            }
+            unlock_index_info_sync(p_index_info);
+            usleep(INDEX_FILE_LOCK_RETRY_INTERVAL_US);
+            lock_index_info_sync(p_index_info);
+        }
+        else if (error == EINTR)
+        {
+            *p_file_lock = former_file_lock;
+        }
+        else
+        {
+            // TODO: error handling
+            assert(0);
+        }
+    }
+
+    // The readers waiting for the write lock can read with node latches now.
+    pthread_cond_broadcast(&(p_index_info->index_info_sync.read_cond));
+#endif
+    p_index_info->index_info_sync.file_lock = INDEX_FILE_LOCK_WRITE;
+}
+
+// The write lock is converted to the read lock if the readers of this process are reading.
+static void inline index_info_file_unlock_latch_write(INDEX_INFO_T *p_index_info)
+{
+    bool is_reading = (p_index_info->index_info_sync.reader_count > 0);
+#if IS_POSIX_API_SUPPORT
+    struct flock fl = {
+        .l_type = (is_reading) ? (F_RDLCK) : (F_UNLCK),
+        .l_whence = SEEK_SET,
+        .l_start = 0,
+        .l_len = 0, // l_start = 0 && l_len = 0 means lock the whole file
+        .l_pid = 0  // unused
+    };
+    int fd = fileno(p_index_info->index_file);
+
+    // Converting to the read lock doesn't need to wait.
+    if (fcntl(fd, F_SETLK, &fl) == -1)
+    {
+        // TODO: error handling
+        assert(0);
+    }
+#endif
+    p_index_info->index_info_sync.file_lock = (is_reading) ? (INDEX_FILE_LOCK_READ) : (INDEX_FILE_LOCK_NONE);
 }
 
 static void inline index_info_file_lock_read(INDEX_INFO_T *p_index_info)
 {
     uint32_t *p_reader_count = &(p_index_info->index_info_sync.reader_count);
+    INDEX_FILE_LOCK_E *p_file_lock = &(p_index_info->index_info_sync.file_lock);
 #if IS_POSIX_API_SUPPORT
     struct flock fl = {
         .l_type = F_RDLCK, // read lock
@@ -887,7 +2365,8 @@ static void inline index_info_file_lock_read(INDEX_INFO_T *p_index_info)
     };
     int fd = fileno(p_index_info->index_file);
 
-    if (*p_reader_count == 1)
+    // The write lock of the latch writer also protects the readers.
+    if ((*p_reader_count == 1) && (*p_file_lock == INDEX_FILE_LOCK_NONE))
     {
         // first reader, get file lock
         // fcntl F_SETLKW will block until the lock is acquired.
@@ -897,6 +2376,7 @@ static void inline index_info_file_lock_read(INDEX_INFO_T *p_index_info)
             // TODO: error handling
             assert(0);
         }
+        *p_file_lock = INDEX_FILE_LOCK_READ;
     }
 #endif
 }
@@ -904,6 +2384,7 @@ static void inline index_info_file_lock_read(INDEX_INFO_T *p_index_info)
 static void inline index_info_file_unlock_read(INDEX_INFO_T *p_index_info)
 {
     uint32_t *p_reader_count = &(p_index_info->index_info_sync.reader_count);
+    INDEX_FILE_LOCK_E *p_file_lock = &(p_index_info->index_info_sync.file_lock);
 #if IS_POSIX_API_SUPPORT
     struct flock fl = {
         .l_type = F_UNLCK, // unlock
@@ -914,7 +2395,7 @@ static void inline index_info_file_unlock_read(INDEX_INFO_T *p_index_info)
     };
     int fd = fileno(p_index_info->index_file);
 
-    if (*p_reader_count == 1)
+    if ((*p_reader_count == 1) && (*p_file_lock == INDEX_FILE_LOCK_READ))
     {
         // last reader.
         // unlock file, return value: -1 means error.
@@ -923,6 +2404,7 @@ static void inline index_info_file_unlock_read(INDEX_INFO_T *p_index_info)
             // TODO: error handling
             assert(0);
         }
+        *p_file_lock = INDEX_FILE_LOCK_NONE;
     }
 #endif
 }
@@ -945,7 +2427,8 @@ void update_index_info_status(INDEX_INFO_T *p_index_info, INDEX_INFO_STATUS_E ne
     }
     case INDEX_INFO_STATUS_STARTING:
     {
-        if (new_status == INDEX_INFO_STATUS_READY)
+        // RELEASED: the index file failed to load.
+        if (new_status == INDEX_INFO_STATUS_READY || new_status == INDEX_INFO_STATUS_RELEASED)
         {
             is_valid_transition = true;
         }
@@ -961,7 +2444,7 @@ void update_index_info_status(INDEX_INFO_T *p_index_info, INDEX_INFO_STATUS_E ne
     }
     case INDEX_INFO_STATUS_READY:
     {
-        if (new_status == INDEX_INFO_STATUS_CLOSING || new_status == INDEX_INFO_STATUS_WRITING || new_status == INDEX_INFO_STATUS_READING)
+        if (new_status == INDEX_INFO_STATUS_CLOSING || new_status == INDEX_INFO_STATUS_WRITING || new_status == INDEX_INFO_STATUS_READING || new_status == INDEX_INFO_STATUS_LATCH_WRITING)
         {
             is_valid_transition = true;
         }
@@ -977,7 +2460,15 @@ void update_index_info_status(INDEX_INFO_T *p_index_info, INDEX_INFO_STATUS_E ne
     }
     case INDEX_INFO_STATUS_READING:
     {
-        if (new_status == INDEX_INFO_STATUS_READING || new_status == INDEX_INFO_STATUS_READY)
+        if (new_status == INDEX_INFO_STATUS_READING || new_status == INDEX_INFO_STATUS_READY || new_status == INDEX_INFO_STATUS_LATCH_WRITING)
+        {
+            is_valid_transition = true;
+        }
+        break;
+    }
+    case INDEX_INFO_STATUS_LATCH_WRITING:
+    {
+        if (new_status == INDEX_INFO_STATUS_READY || new_status == INDEX_INFO_STATUS_READING)
         {
             is_valid_transition = true;
         }
@@ -995,8 +2486,22 @@ void update_index_info_status(INDEX_INFO_T *p_index_info, INDEX_INFO_STATUS_E ne
     }
 }
 
+// Readers joining the latch writer keep its status.
+void update_index_info_status_to_reading(INDEX_INFO_T *p_index_info)
+{
+    if (check_index_info_status(p_index_info, INDEX_INFO_STATUS_LATCH_WRITING) == false)
+    {
+        update_index_info_status(p_index_info, INDEX_INFO_STATUS_READING);
+    }
+}
+
 void update_index_info_status_from_reading(INDEX_INFO_T *p_index_info)
 {
+    if (check_index_info_status(p_index_info, INDEX_INFO_STATUS_LATCH_WRITING))
+    {
+        return;
+    }
+
     assert(check_index_info_status(p_index_info, INDEX_INFO_STATUS_READING) == true);
 
     uint32_t *p_reader_count = &(p_index_info->index_info_sync.reader_count);
@@ -1010,6 +2515,19 @@ void update_index_info_status_from_reading(INDEX_INFO_T *p_index_info)
     }
 }
 
+// The readers which joined the latch writer continue reading.
+void update_index_info_status_from_latch_writing(INDEX_INFO_T *p_index_info)
+{
+    if (p_index_info->index_info_sync.reader_count > 0)
+    {
+        update_index_info_status(p_index_info, INDEX_INFO_STATUS_READING);
+    }
+    else
+    {
+        update_index_info_status(p_index_info, INDEX_INFO_STATUS_READY);
+    }
+}
+
 static inline bool check_index_info_status(INDEX_INFO_T *p_index_info, INDEX_INFO_STATUS_E target_status)
 {
     return (p_index_info->status == target_status);
@@ -1053,6 +2571,21 @@ static inline void index_info_sync_close_wait(INDEX_INFO_T *p_index_info)
 #endif
 }
 
+// Wait until the instance is not busy or its loading is aborted, the pool is not locked.
+static inline void index_info_sync_idle_wait(INDEX_INFO_T *p_index_info)
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_t *p_index_info_mutex = &(p_index_info->index_info_sync.mutex);
+    pthread_cond_t *p_close_cond = &(p_index_info->index_info_sync.close_cond);
+
+    // using while loop for spurious wakeup
+    while (is_index_info_instance_busy(p_index_info) && (check_index_info_status(p_index_info, INDEX_INFO_STATUS_RELEASED) == false))
+    {
+        pthread_cond_wait(p_close_cond, p_index_info_mutex);
+    }
+#endif
+}
+
 static inline void index_info_sync_write_wait(INDEX_INFO_T *p_index_info)
 {
     uint32_t *p_writer_waiting_count = &(p_index_info->index_info_sync.writer_waiting_count);
@@ -1069,6 +2602,23 @@ static inline void index_info_sync_write_wait(INDEX_INFO_T *p_index_info)
     (*p_writer_waiting_count)--;
 }
 
+// The latch writer doesn't wait for the readers, but only one writer writes at a time.
+static inline void index_info_sync_latch_write_wait(INDEX_INFO_T *p_index_info)
+{
+    uint32_t *p_writer_waiting_count = &(p_index_info->index_info_sync.writer_waiting_count);
+    (*p_writer_waiting_count)++;
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_t *p_mutex = &(p_index_info->index_info_sync.mutex);
+    pthread_cond_t *p_write_cond = &(p_index_info->index_info_sync.write_cond);
+
+    while ((check_index_info_status(p_index_info, INDEX_INFO_STATUS_READY) == false) && (check_index_info_status(p_index_info, INDEX_INFO_STATUS_READING) == false))
+    {
+        pthread_cond_wait(p_write_cond, p_mutex);
+    }
+#endif
+    (*p_writer_waiting_count)--;
+}
+
 static inline void index_info_sync_read_wait(INDEX_INFO_T *p_index_info)
 {
     uint32_t *p_reader_waiting_count = &(p_index_info->index_info_sync.reader_waiting_count);
@@ -1081,7 +2631,10 @@ static inline void index_info_sync_read_wait(INDEX_INFO_T *p_index_info)
     pthread_cond_t *p_read_cond = &(p_index_info->index_info_sync.read_cond);
 
     // priority: write > read
-    while ((check_index_info_status(p_index_info, INDEX_INFO_STATUS_READING) == false) && (check_index_info_status(p_index_info, INDEX_INFO_STATUS_READY) == false || *p_writer_waiting_count > 0))
+    // Readers join the latch writer after it holds the write lock of the index file.
+    while ((check_index_info_status(p_index_info, INDEX_INFO_STATUS_READING) == false) &&
+           ((check_index_info_status(p_index_info, INDEX_INFO_STATUS_LATCH_WRITING) == false) || (p_index_info->index_info_sync.file_lock != INDEX_FILE_LOCK_WRITE)) &&
+           (check_index_info_status(p_index_info, INDEX_INFO_STATUS_READY) == false || *p_writer_waiting_count > 0))
     {
         pthread_cond_wait(p_read_cond, p_mutex);
     }
@@ -1104,8 +2657,8 @@ static inline void index_info_sync_write_unblock(INDEX_INFO_T *p_index_info)
     // Priority: write > read > close
     if (*p_writer_waiting_count > 0)
     {
-        // notify the next writer
-        pthread_cond_signal(p_write_cond);
+        // notify the writers, the latch writers and the other writers wait for different status.
+        pthread_cond_broadcast(p_write_cond);
     }
     else if (*p_reader_waiting_count > 0)
     {
@@ -1115,7 +2668,8 @@ static inline void index_info_sync_write_unblock(INDEX_INFO_T *p_index_info)
     else
     {
         // notify to close
-        pthread_cond_signal(p_close_cond);
+        pthread_cond_broadcast(p_close_cond);
+        index_info_pool_sync_release_notify();
     }
 #endif
 }
@@ -1129,18 +2683,19 @@ static inline void index_info_sync_read_unblock(INDEX_INFO_T *p_index_info)
     *p_reader_count -= 1;
 #if IS_POSIX_API_SUPPORT
     pthread_cond_t *p_write_cond = &(p_index_info->index_info_sync.write_cond);
-    pthread_cond_t *p_reader_cond = &(p_index_info->index_info_sync.read_cond);
+    pthread_cond_t *p_close_cond = &(p_index_info->index_info_sync.close_cond);
 
     if (*p_reader_count == 0)
     {
         if (*p_writer_waiting_count > 0)
         {
-            pthread_cond_signal(p_write_cond);
+            pthread_cond_broadcast(p_write_cond);
         }
         else if (*p_reader_waiting_count == 0)
         {
             // reader_count = 0 && writer_waiting_count = 0 && reader_waiting_count = 0
-            pthread_cond_signal(p_reader_cond);
+            pthread_cond_broadcast(p_close_cond);
+            index_info_pool_sync_release_notify();
         }
     }
 #endif
@@ -1150,9 +2705,19 @@ void index_properties_init(INDEX_PROPERTIES_T *p_index_properties)
 {
     p_index_properties->p_key = NULL;
     p_index_properties->key_size = 0;
+    p_index_properties->magic = INDEX_FILE_MAGIC;
+    p_index_properties->format_version = INDEX_FILE_FORMAT_VERSION;
     p_index_properties->root_tag = 0;
     p_index_properties->tag_num = 0;
     p_index_properties->index_id_type = INDEX_ID_TYPE_INVALID;
+    p_index_properties->index_structure = INDEX_STRUCTURE_BTREE;
+    p_index_properties->index_format_32 = 0;
+    p_index_properties->change_sequence = 0;
+    p_index_properties->node_size = 0;
+    p_index_properties->order = 0;
+    p_index_properties->internal_order = 0;
+    p_index_properties->compressed_order = 0;
+    p_index_properties->compressed_internal_order = 0;
 }
 
 void allocate_index_properties_resources(INDEX_PROPERTIES_T *p_index_properties, uint32_t key_size)
@@ -1170,15 +2735,38 @@ void read_index_properties(INDEX_INFO_T *p_index_info)
     int fd = fileno(p_index_file);
     off_t offset = 0;
 
+    // Read magic and format_version
+    pread(fd, &(p_index_properties->magic), sizeof(p_index_properties->magic), offset);
+    offset += sizeof(p_index_properties->magic);
+    pread(fd, &(p_index_properties->format_version), sizeof(p_index_properties->format_version), offset);
+    offset += sizeof(p_index_properties->format_version);
+
     // Read tag_num and root_tag
     pread(fd, &(p_index_properties->tag_num), sizeof(p_index_properties->tag_num), offset);
     offset += sizeof(p_index_properties->tag_num);
     pread(fd, &(p_index_properties->root_tag), sizeof(p_index_properties->root_tag), offset);
     offset += sizeof(p_index_properties->root_tag);
 
-    // Read index_id_type (save as uint32)
-    pread(fd, &(p_index_properties->index_id_type_32), sizeof(p_index_properties->index_id_type_32), offset);
-    offset += sizeof(p_index_properties->index_id_type_32);
+    // Read index_id_type and index_structure (save as uint32)
+    pread(fd, &(p_index_properties->index_format_32), sizeof(p_index_properties->index_format_32), offset);
+    offset += sizeof(p_index_properties->index_format_32);
+    unpack_index_format(p_index_properties);
+
+    // Read change_sequence
+    pread(fd, &(p_index_properties->change_sequence), sizeof(p_index_properties->change_sequence), offset);
+    offset += sizeof(p_index_properties->change_sequence);
+
+    // Read node_size, order, internal_order and the compressed orders
+    pread(fd, &(p_index_properties->node_size), sizeof(p_index_properties->node_size), offset);
+    offset += sizeof(p_index_properties->node_size);
+    pread(fd, &(p_index_properties->order), sizeof(p_index_properties->order), offset);
+    offset += sizeof(p_index_properties->order);
+    pread(fd, &(p_index_properties->internal_order), sizeof(p_index_properties->internal_order), offset);
+    offset += sizeof(p_index_properties->internal_order);
+    pread(fd, &(p_index_properties->compressed_order), sizeof(p_index_properties->compressed_order), offset);
+    offset += sizeof(p_index_properties->compressed_order);
+    pread(fd, &(p_index_properties->compressed_internal_order), sizeof(p_index_properties->compressed_internal_order), offset);
+    offset += sizeof(p_index_properties->compressed_internal_order);
 
     // Read key_size
     pread(fd, &(p_index_properties->key_size), sizeof(p_index_properties->key_size), offset);
@@ -1191,14 +2779,29 @@ void read_index_properties(INDEX_INFO_T *p_index_info)
 
 #else  // IS_POSIX_API_SUPPORT
     fseek(p_index_file, 0, SEEK_SET);
+    // Read magic and format_version
+    fread(&(p_index_properties->magic), sizeof(p_index_properties->magic), 1, p_index_file);
+    fread(&(p_index_properties->format_version), sizeof(p_index_properties->format_version), 1, p_index_file);
+
     // Read tag_num and root_tag
     fread(&(p_index_properties->tag_num), sizeof(p_index_properties->tag_num), 1, p_index_file);
     fread(&(p_index_properties->root_tag), sizeof(p_index_properties->root_tag), 1, p_index_file);
 
-    // Read index_id_type (save as uint32)
-    fread(&(p_index_properties->index_id_type_32), sizeof(p_index_properties->index_id_type_32), 1, p_index_file);
+    // Read index_id_type and index_structure (save as uint32)
+    fread(&(p_index_properties->index_format_32), sizeof(p_index_properties->index_format_32), 1, p_index_file);
+    unpack_index_format(p_index_properties);
     assert(p_index_properties->index_id_type <= INDEX_ID_TYPE_NUM);
 
+    // Read change_sequence
+    fread(&(p_index_properties->change_sequence), sizeof(p_index_properties->change_sequence), 1, p_index_file);
+
+    // Read node_size, order, internal_order and the compressed orders
+    fread(&(p_index_properties->node_size), sizeof(p_index_properties->node_size), 1, p_index_file);
+    fread(&(p_index_properties->order), sizeof(p_index_properties->order), 1, p_index_file);
+    fread(&(p_index_properties->internal_order), sizeof(p_index_properties->internal_order), 1, p_index_file);
+    fread(&(p_index_properties->compressed_order), sizeof(p_index_properties->compressed_order), 1, p_index_file);
+    fread(&(p_index_properties->compressed_internal_order), sizeof(p_index_properties->compressed_internal_order), 1, p_index_file);
+
     // Read key_size
     fread(&(p_index_properties->key_size), sizeof(p_index_properties->key_size), 1, p_index_file);
     // Read key
@@ -1216,15 +2819,38 @@ void write_index_properties(INDEX_INFO_T *p_index_info)
     int fd = fileno(p_index_file);
     off_t offset = 0;
 
+    // Write magic and format_version
+    pwrite(fd, &(p_index_properties->magic), sizeof(p_index_properties->magic), offset);
+    offset += sizeof(p_index_properties->magic);
+    pwrite(fd, &(p_index_properties->format_version), sizeof(p_index_properties->format_version), offset);
+    offset += sizeof(p_index_properties->format_version);
+
     // Write tag_num & root_tag
     pwrite(fd, &(p_index_properties->tag_num), sizeof(p_index_properties->tag_num), offset);
     offset += sizeof(p_index_properties->tag_num);
     pwrite(fd, &(p_index_properties->root_tag), sizeof(p_index_properties->root_tag), offset);
     offset += sizeof(p_index_properties->root_tag);
 
-    // write index_id_type as uint32
-    pwrite(fd, &(p_index_properties->index_id_type_32), sizeof(p_index_properties->index_id_type_32), offset);
-    offset += sizeof(p_index_properties->index_id_type_32);
+    // write index_id_type and index_structure as uint32
+    pack_index_format(p_index_properties);
+    pwrite(fd, &(p_index_properties->index_format_32), sizeof(p_index_properties->index_format_32), offset);
+    offset += sizeof(p_index_properties->index_format_32);
+
+    // Write change_sequence
+    pwrite(fd, &(p_index_properties->change_sequence), sizeof(p_index_properties->change_sequence), offset);
+    offset += sizeof(p_index_properties->change_sequence);
+
+    // Write node_size, order, internal_order and the compressed orders
+    pwrite(fd, &(p_index_properties->node_size), sizeof(p_index_properties->node_size), offset);
+    offset += sizeof(p_index_properties->node_size);
+    pwrite(fd, &(p_index_properties->order), sizeof(p_index_properties->order), offset);
+    offset += sizeof(p_index_properties->order);
+    pwrite(fd, &(p_index_properties->internal_order), sizeof(p_index_properties->internal_order), offset);
+    offset += sizeof(p_index_properties->internal_order);
+    pwrite(fd, &(p_index_properties->compressed_order), sizeof(p_index_properties->compressed_order), offset);
+    offset += sizeof(p_index_properties->compressed_order);
+    pwrite(fd, &(p_index_properties->compressed_internal_order), sizeof(p_index_properties->compressed_internal_order), offset);
+    offset += sizeof(p_index_properties->compressed_internal_order);
 
     // Write key_size
     pwrite(fd, &(p_index_properties->key_size), sizeof(p_index_properties->key_size), offset);
@@ -1235,12 +2861,27 @@ void write_index_properties(INDEX_INFO_T *p_index_info)
 #else  // IS_POSIX_API_SUPPORT
     fseek(p_index_file, 0, SEEK_SET);
 
+    // Write magic and format_version
+    fwrite(&(p_index_properties->magic), sizeof(p_index_properties->magic), 1, p_index_file);
+    fwrite(&(p_index_properties->format_version), sizeof(p_index_properties->format_version), 1, p_index_file);
+
     // Write tag_num & root_tag
     fwrite(&(p_index_properties->tag_num), sizeof(p_index_properties->tag_num), 1, p_index_file);
     fwrite(&(p_index_properties->root_tag), sizeof(p_index_properties->root_tag), 1, p_index_file);
 
-    // write index_id_type as uint32
-    fwrite(&(p_index_properties->index_id_type_32), sizeof(p_index_properties->index_id_type_32), 1, p_index_file);
+    // write index_id_type and index_structure as uint32
+    pack_index_format(p_index_properties);
+    fwrite(&(p_index_properties->index_format_32), sizeof(p_index_properties->index_format_32), 1, p_index_file);
+
+    // Write change_sequence
+    fwrite(&(p_index_properties->change_sequence), sizeof(p_index_properties->change_sequence), 1, p_index_file);
+
+    // Write node_size, order, internal_order and the compressed orders
+    fwrite(&(p_index_properties->node_size), sizeof(p_index_properties->node_size), 1, p_index_file);
+    fwrite(&(p_index_properties->order), sizeof(p_index_properties->order), 1, p_index_file);
+    fwrite(&(p_index_properties->internal_order), sizeof(p_index_properties->internal_order), 1, p_index_file);
+    fwrite(&(p_index_properties->compressed_order), sizeof(p_index_properties->compressed_order), 1, p_index_file);
+    fwrite(&(p_index_properties->compressed_internal_order), sizeof(p_index_properties->compressed_internal_order), 1, p_index_file);
 
     // Write key_size
     fwrite(&(p_index_properties->key_size), sizeof(p_index_properties->key_size), 1, p_index_file);
@@ -1253,14 +2894,27 @@ void write_index_properties(INDEX_INFO_T *p_index_info)
 
 size_t get_index_properties_size(INDEX_PROPERTIES_T *p_index_properties)
 {
-    size_t index_properties_size = 0;
-    index_properties_size += sizeof(p_index_properties->tag_num) + sizeof(p_index_properties->root_tag) + sizeof(p_index_properties->index_id_type);
+    size_t index_properties_size = INDEX_FILE_FORMAT_HEADER_SIZE;
+    index_properties_size += sizeof(p_index_properties->tag_num) + sizeof(p_index_properties->root_tag) + sizeof(p_index_properties->index_format_32) + sizeof(p_index_properties->change_sequence);
+    index_properties_size += sizeof(p_index_properties->node_size) + sizeof(p_index_properties->order) + sizeof(p_index_properties->internal_order);
+    index_properties_size += sizeof(p_index_properties->compressed_order) + sizeof(p_index_properties->compressed_internal_order);
     // key_size & key
     index_properties_size += sizeof(p_index_properties->key_size) + p_index_properties->key_size;
 
     return index_properties_size;
 }
 
+static inline void pack_index_format(INDEX_PROPERTIES_T *p_index_properties)
+{
+    p_index_properties->index_format_32 = ((uint32_t)p_index_properties->index_id_type & INDEX_FORMAT_ID_TYPE_MASK) | ((uint32_t)p_index_properties->index_structure << INDEX_FORMAT_STRUCTURE_SHIFT);
+}
+
+static inline void unpack_index_format(INDEX_PROPERTIES_T *p_index_properties)
+{
+    p_index_properties->index_id_type = (INDEX_ID_TYPE_E)(p_index_properties->index_format_32 & INDEX_FORMAT_ID_TYPE_MASK);
+    p_index_properties->index_structure = (INDEX_STRUCTURE_E)((p_index_properties->index_format_32 >> INDEX_FORMAT_STRUCTURE_SHIFT) & INDEX_FORMAT_STRUCTURE_MASK);
+}
+
 void free_index_properties_resources(INDEX_PROPERTIES_T *p_index_properties)
 {
     if (p_index_properties->p_key)
@@ -1275,57 +2929,105 @@ void close_index_properties(INDEX_PROPERTIES_T *p_index_properties)
     p_index_properties->root_tag = 0;
     p_index_properties->tag_num = 0;
     p_index_properties->key_size = 0;
+    p_index_properties->node_size = 0;
+    p_index_properties->order = 0;
+    p_index_properties->internal_order = 0;
+    p_index_properties->compressed_order = 0;
+    p_index_properties->compressed_internal_order = 0;
     free_index_properties_resources(p_index_properties);
 }
 
-void index_node_init(INDEX_NODE_T *p_index_node, uint32_t tag)
+// Free the node by free_index_node_resources() after using it.
+void index_node_init(INDEX_NODE_T *p_index_node, uint32_t tag, INDEX_PROPERTIES_T *p_index_properties)
 {
+    uint32_t order = (p_index_properties->compressed_order > 0) ? (p_index_properties->compressed_order) : (p_index_properties->order);
+    uint32_t index_id_size = Index_Id_Type_Get_Size(p_index_properties->index_id_type);
+
     memset(p_index_node, 0, sizeof(INDEX_NODE_T));
-    for (uint32_t i = 0; i < INDEX_ORDER; i++)
+
+    p_index_node->order = order;
+    p_index_node->index_id_size = index_id_size;
+    p_index_node->node_size = p_index_properties->node_size;
+    p_index_node->image_size = get_index_node_buffer_size(p_index_properties);
+    p_index_node->p_node_image = calloc(1, p_index_node->image_size);
+    p_index_node->child_tag = (uint32_t *)(p_index_node->p_node_image + (sizeof(uint32_t) * INDEX_NODE_HEADER_FIELD_NUM));
+    p_index_node->p_index_ids = p_index_node->p_node_image + get_index_node_fields_size(order);
+    p_index_node->p_payloads = p_index_node->p_index_ids + (order * index_id_size);
+
+    p_index_node->tag = tag;
+}
+
+// Clear the node and reuse its buffer for another tag.
+void reset_index_node(INDEX_NODE_T *p_index_node, uint32_t tag, INDEX_PROPERTIES_T *p_index_properties)
+{
+    memset(p_index_node->p_node_image, 0, p_index_node->image_size);
+
+    p_index_node->tag = tag;
+    set_index_node_level(p_index_node, 0, p_index_properties);
+    p_index_node->length = 0;
+    p_index_node->parent_tag = 0;
+    p_index_node->next_tag = 0;
+}
+
+// Set the level of the node and the layout of its image.
+// The non-leaf nodes of a separator node B+ tree store internal_order index ids without the payloads.
+// The prefix compressed nodes are decoded into the compressed orders of elements.
+void set_index_node_level(INDEX_NODE_T *p_index_node, uint32_t level, INDEX_PROPERTIES_T *p_index_properties)
+{
+    bool is_separator_node = (level > 0) && (level != INDEX_POSTING_LIST_LEVEL) && (p_index_properties->internal_order > 0);
+    uint32_t order = (is_separator_node) ? (p_index_properties->internal_order) : (p_index_properties->order);
+
+    if (is_index_node_compressed(p_index_properties, level))
     {
-        index_element_init(&(p_index_node->elements[i]));
+        order = (is_separator_node) ? (p_index_properties->compressed_internal_order) : (p_index_properties->compressed_order);
     }
 
-    p_index_node->tag = tag;
+    p_index_node->level = level;
+    p_index_node->order = order;
+    p_index_node->p_index_ids = p_index_node->p_node_image + get_index_node_fields_size(order);
+    p_index_node->p_payloads = (is_separator_node) ? (NULL) : (p_index_node->p_index_ids + (order * p_index_node->index_id_size));
+}
+
+static inline bool is_index_node_layout_matched(INDEX_NODE_T *p_index_node, INDEX_PROPERTIES_T *p_index_properties)
+{
+    // The layout of the node buffer is set by its level after it is matched.
+    return ((p_index_node->p_node_image != NULL) &&
+            (p_index_node->image_size == get_index_node_buffer_size(p_index_properties)) &&
+            (p_index_node->node_size == p_index_properties->node_size) &&
+            (p_index_node->index_id_size == Index_Id_Type_Get_Size(p_index_properties->index_id_type)));
 }
 
 void write_index_node(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node)
 {
-    uint32_t node_tag = p_index_node->tag;
-    off_t node_offset = get_node_offset(&(p_index_info->index_properties), node_tag);
+    off_t node_offset = get_node_offset(&(p_index_info->index_properties), p_index_node->tag);
     FILE *p_index_file = p_index_info->index_file;
+    uint32_t *p_node_header = (uint32_t *)(p_index_node->p_node_image);
+    uint8_t *p_image = p_index_node->p_node_image;
+    bool is_compressed = is_index_node_compressed(&(p_index_info->index_properties), p_index_node->level);
+    // The compressed image is encoded here, node_size is limited by INDEX_MAX_NODE_SIZE.
+    uint8_t compressed_image[(is_compressed) ? (p_index_node->node_size) : (1)];
+
+    // static fields are stored at the beginning of the node image.
+    p_node_header[0] = p_index_node->tag;
+    p_node_header[1] = p_index_node->level;
+    p_node_header[2] = p_index_node->length;
+    p_node_header[3] = p_index_node->parent_tag;
+    p_node_header[4] = p_index_node->next_tag;
+
+    if (is_compressed)
+    {
+        memset(compressed_image, 0, p_index_node->node_size);
+        encode_index_node_image(p_index_node, compressed_image);
+        p_image = compressed_image;
+    }
 
 #if IS_POSIX_API_SUPPORT
     int fd = fileno(p_index_file);
 
-    // write static fields.
-    pwrite(fd, &(p_index_node->tag), sizeof(p_index_node->tag), node_offset);
-    node_offset += sizeof(p_index_node->tag);
-    pwrite(fd, &(p_index_node->level), sizeof(p_index_node->level), node_offset);
-    node_offset += sizeof(p_index_node->level);
-    pwrite(fd, &(p_index_node->length), sizeof(p_index_node->length), node_offset);
-    node_offset += sizeof(p_index_node->length);
-    pwrite(fd, &(p_index_node->parent_tag), sizeof(p_index_node->parent_tag), node_offset);
-    node_offset += sizeof(p_index_node->parent_tag);
-    pwrite(fd, &(p_index_node->next_tag), sizeof(p_index_node->next_tag), node_offset);
-    node_offset += sizeof(p_index_node->next_tag);
-    pwrite(fd, p_index_node->child_tag, sizeof(p_index_node->child_tag[0]) * INDEX_CHILD_TAG_ORDER, node_offset);
-
-    write_index_elements(p_index_info, node_tag, 0, INDEX_ORDER, p_index_node->elements);
+    pwrite(fd, p_image, p_index_node->node_size, node_offset);
 #else
     fseek(p_index_file, node_offset, SEEK_SET);
-
-    // write static fields.
-    fwrite(&(p_index_node->tag), sizeof(p_index_node->tag), 1, p_index_file);
-    fwrite(&(p_index_node->level), sizeof(p_index_node->length), 1, p_index_file);
-    fwrite(&(p_index_node->length), sizeof(p_index_node->length), 1, p_index_file);
-    fwrite(&(p_index_node->parent_tag), sizeof(p_index_node->parent_tag), 1, p_index_file);
-    fwrite(&(p_index_node->next_tag), sizeof(p_index_node->next_tag), 1, p_index_file);
-    fwrite(p_index_node->child_tag, sizeof(p_index_node->child_tag[0]), INDEX_CHILD_TAG_ORDER, p_index_file);
-
-    // write dynamic fields
-    // TODO: only write the changed elements.
-    write_index_elements(p_index_info, node_tag, 0, INDEX_ORDER, p_index_node->elements);
+    fwrite(p_image, p_index_node->node_size, 1, p_index_file);
 
     fflush(p_index_file);
 #endif // IS_POSIX_API_SUPPORT
@@ -1342,587 +3044,3816 @@ bool read_index_node(INDEX_INFO_T *p_index_info, uint32_t tag, INDEX_NODE_T *p_i
     }
 
     FILE *p_index_file = p_index_info->index_file;
-    off_t node_offset = get_node_offset(&(p_index_info->index_properties), tag);
+    INDEX_PROPERTIES_T *p_index_properties = &(p_index_info->index_properties);
+    off_t node_offset = get_node_offset(p_index_properties, tag);
+    uint32_t *p_node_header = NULL;
+    bool has_compressed_nodes = (p_index_properties->compressed_order > 0);
+    // The nodes of an index file with compressed nodes are read here first, node_size is limited by INDEX_MAX_NODE_SIZE.
+    uint8_t file_image[(has_compressed_nodes) ? (p_index_properties->node_size) : (1)];
+    uint8_t *p_image = NULL;
+
+    if (is_index_node_layout_matched(p_index_node, p_index_properties) == false)
+    {
+        // The node buffer is initialized with a different layout, reallocate it.
+        free_index_node_resources(p_index_node);
+        index_node_init(p_index_node, tag, p_index_properties);
+    }
+    p_image = (has_compressed_nodes) ? (file_image) : (p_index_node->p_node_image);
 
 #if IS_POSIX_API_SUPPORT
     int fd = fileno(p_index_file);
 
-    // read static fields
-    pread(fd, &(p_index_node->tag), sizeof(p_index_node->tag), node_offset);
-    node_offset += sizeof(p_index_node->tag);
-    pread(fd, &(p_index_node->level), sizeof(p_index_node->level), node_offset);
-    node_offset += sizeof(p_index_node->level);
-    pread(fd, &(p_index_node->length), sizeof(p_index_node->length), node_offset);
-    node_offset += sizeof(p_index_node->length);
-    pread(fd, &(p_index_node->parent_tag), sizeof(p_index_node->parent_tag), node_offset);
-    node_offset += sizeof(p_index_node->parent_tag);
-    pread(fd, &(p_index_node->next_tag), sizeof(p_index_node->next_tag), node_offset);
-    node_offset += sizeof(p_index_node->next_tag);
-    pread(fd, p_index_node->child_tag, sizeof(p_index_node->child_tag[0]) * INDEX_CHILD_TAG_ORDER, node_offset);
-
+    pread(fd, p_image, p_index_node->node_size, node_offset);
 #else  // IS_POSIX_API_SUPPORT
     fseek(p_index_file, node_offset, SEEK_SET);
-    // read static fields
-    fread(&(p_index_node->tag), sizeof(p_index_node->tag), 1, p_index_file);
-    fread(&(p_index_node->level), sizeof(p_index_node->level), 1, p_index_file);
-    fread(&(p_index_node->length), sizeof(p_index_node->length), 1, p_index_file);
-    fread(&(p_index_node->parent_tag), sizeof(p_index_node->parent_tag), 1, p_index_file);
-    fread(&(p_index_node->next_tag), sizeof(p_index_node->next_tag), 1, p_index_file);
-    fread(p_index_node->child_tag, sizeof(p_index_node->child_tag[0]), INDEX_CHILD_TAG_ORDER, p_index_file);
+    fread(p_image, p_index_node->node_size, 1, p_index_file);
 #endif // IS_POSIX_API_SUPPORT
 
-    // read dynamic fields
-    read_index_elements(p_index_info, tag, 0, INDEX_ORDER, p_index_node->elements);
+    p_node_header = (uint32_t *)(p_index_node->p_node_image);
+    if (has_compressed_nodes)
+    {
+        // The compressed nodes are decoded below, the posting nodes are copied as they are.
+        uint32_t level = 0;
+        bool is_compressed = false;
+
+        memcpy(&level, file_image + sizeof(uint32_t), sizeof(uint32_t));
+        is_compressed = is_index_node_compressed(p_index_properties, level);
+        memset(p_index_node->p_node_image, 0, p_index_node->image_size);
+        memcpy(p_index_node->p_node_image, file_image, (is_compressed) ? (sizeof(uint32_t) * INDEX_NODE_HEADER_FIELD_NUM) : (p_index_node->node_size));
+    }
+
+    p_index_node->tag = p_node_header[0];
+    set_index_node_level(p_index_node, p_node_header[1], p_index_properties);
+    p_index_node->length = p_node_header[2];
+    p_index_node->parent_tag = p_node_header[3];
+    p_index_node->next_tag = p_node_header[4];
+
+    if (is_index_node_compressed(p_index_properties, p_index_node->level))
+    {
+        decode_index_node_image(p_index_node, file_image);
+    }
 
     return true;
 }
 
 off_t get_node_offset(INDEX_PROPERTIES_T *p_index_properties, uint32_t tag)
 {
+    size_t node_size = p_index_properties->node_size;
     size_t index_properties_size = get_index_properties_size(p_index_properties);
-    size_t index_element_size = Index_Id_Type_Get_Size(p_index_properties->index_id_type) + INDEX_PAYLOAD_SIZE;
-    // tag + level + length + parent_tag + next_tag + child_tag[INDEX_CHILD_TAG_ORDER] + elements[INDEX_ORDER]
-    size_t index_node_size = (sizeof(uint32_t) * (INDEX_CHILD_TAG_ORDER + 5)) + (index_element_size * INDEX_ORDER);
+    // Index properties occupy the first node-size-aligned area, so every node starts at a multiple of node_size.
+    size_t index_properties_area_size = ((index_properties_size + node_size - 1) / node_size) * node_size;
 
     // tag is a 1-based number.
-    return (index_properties_size + ((tag - 1) * index_node_size));
+    return (index_properties_area_size + ((tag - 1) * node_size));
 }
 
-void free_index_node_resources(INDEX_NODE_T *p_index_node)
+// tag + level + length + parent_tag + next_tag + child_tag[order + 1]
+size_t get_index_node_fields_size(uint32_t order)
 {
-    for (uint32_t i = 0; i < INDEX_ORDER; i++)
-    {
-        free_index_element_resources(&(p_index_node->elements[i]));
-    }
+    size_t fields_size = sizeof(uint32_t) * (INDEX_NODE_HEADER_FIELD_NUM + order + 1);
+
+    // Align index_ids to 8 bytes, 64-bit index ids can be accessed in place.
+    return (fields_size + 7) & ~((size_t)7);
 }
 
-void index_element_init(INDEX_ELEMENT_T *p_index_element)
+// Bytes of the node image without padding.
+size_t get_index_node_image_size(uint32_t order, uint32_t index_id_size)
 {
-    p_index_element->p_index_id = NULL;
-    memset(p_index_element->index_payload, 0, INDEX_PAYLOAD_SIZE);
+    return get_index_node_fields_size(order) + (order * (index_id_size + INDEX_PAYLOAD_SIZE));
 }
 
-void setup_index_element(INDEX_ELEMENT_T *p_index_element, void *p_index_id, INDEX_ID_TYPE_E index_id_type, void *p_payload, uint32_t payload_size)
+// Max order that a node with node_size bytes can hold.
+uint32_t get_index_order_by_node_size(uint32_t node_size, INDEX_ID_TYPE_E index_id_type)
 {
     uint32_t index_id_size = Index_Id_Type_Get_Size(index_id_type);
-    payload_size = (payload_size > INDEX_PAYLOAD_SIZE) ? INDEX_PAYLOAD_SIZE : payload_size;
-    allocate_index_element_resources(p_index_element, index_id_size);
+    size_t index_element_size = index_id_size + INDEX_PAYLOAD_SIZE;
+    size_t fields_size = get_index_node_fields_size(0);
+    uint32_t order = 0;
 
-    // index_id
-    memcpy(p_index_element->p_index_id, p_index_id, index_id_size);
-    // payload
-    // clear the existed data first.
-    memset(p_index_element->index_payload, 0, INDEX_PAYLOAD_SIZE);
-    if (payload_size > 0 && p_payload != NULL)
+    if (node_size > fields_size)
     {
-        memcpy(p_index_element->index_payload, p_payload, payload_size);
+        // each element also takes a child_tag.
+        order = (node_size - fields_size) / (index_element_size + sizeof(uint32_t));
+    }
+    // The fields are padded, decrease the order until the node image fits.
+    while ((order > INDEX_MIN_ORDER) && (get_index_node_image_size(order, index_id_size) > node_size))
+    {
+        order--;
     }
+
+    return (order < INDEX_MIN_ORDER) ? INDEX_MIN_ORDER : order;
 }
 
-/*
-** Write numbers of index_elements to file.
-** p_index_element array length should greater or equal to the write_length.
-*/
-void write_index_elements(INDEX_INFO_T *p_index_info, uint32_t tag, uint32_t index_element_position, uint32_t write_length, INDEX_ELEMENT_T *p_index_element)
+// Max order that a non-leaf node with node_size bytes can hold, its elements are the separator index ids without the payloads.
+uint32_t get_index_internal_order_by_node_size(uint32_t node_size, INDEX_ID_TYPE_E index_id_type)
 {
-    assert((index_element_position + write_length) <= INDEX_ORDER);
+    uint32_t index_id_size = Index_Id_Type_Get_Size(index_id_type);
+    size_t fields_size = get_index_node_fields_size(0);
+    uint32_t order = 0;
 
-    INDEX_PROPERTIES_T *p_index_properties = &(p_index_info->index_properties);
-    FILE *p_index_file = p_index_info->index_file;
-    off_t index_element_offset = get_index_element_offset(p_index_properties, tag, index_element_position);
-    uint32_t index_id_size = Index_Id_Type_Get_Size(p_index_properties->index_id_type);
+    if (node_size > fields_size)
+    {
+        // each element also takes a child_tag.
+        order = (node_size - fields_size) / (index_id_size + sizeof(uint32_t));
+    }
+    // The fields are padded, decrease the order until the node image fits.
+    while ((order > INDEX_MIN_ORDER) && ((get_index_node_fields_size(order) + (order * index_id_size)) > node_size))
+    {
+        order--;
+    }
 
-    uint8_t zero_buffer[index_id_size];
-    memset(zero_buffer, 0, index_id_size);
+    return (order < INDEX_MIN_ORDER) ? INDEX_MIN_ORDER : order;
+}
 
-#if IS_POSIX_API_SUPPORT
-    int fd = fileno(p_index_file);
+// Prefix compressed node image (leaf and non-leaf nodes of a B+ tree whose index ids are ordered by their leading bytes):
+// tag | level | length | parent_tag | next_tag | child_tag[length + 1] | prefix_size | end_size | prefix | index_id_suffixes[length] | payloads[length]
+// All the index ids share the prefix_size leading bytes and their bytes from end_size are zero, each suffix is the bytes in [prefix_size, end_size).
+// The separators of the non-leaf nodes are truncated by Index_Id_Type_Set_Separator(), so they end early. The non-leaf nodes have no payloads[].
+// The node is decoded into the fixed-size slots when it's read into the node cache, so the searches run in place over the whole index ids.
+static inline size_t get_index_node_compressed_size(uint32_t length, uint32_t prefix_size, uint32_t end_size, bool has_payloads)
+{
+    size_t fields_size = sizeof(uint32_t) * (INDEX_NODE_HEADER_FIELD_NUM + length + 1 + INDEX_NODE_COMPRESSED_FIELD_NUM);
+
+    prefix_size = (prefix_size < end_size) ? (prefix_size) : (end_size);
+    return fields_size + prefix_size + ((size_t)length * (end_size - prefix_size)) + ((has_payloads) ? ((size_t)length * INDEX_PAYLOAD_SIZE) : (0));
+}
+
+// *p_order: max number of elements which fit in a compressed node with node_size bytes whatever the index ids are.
+// *p_compressed_order: max number of elements of the node, the equal index ids take the fewest bytes.
+// The halves of a split node should fit whatever the index ids are, so the compressed order is less than twice the order.
+void get_index_compressed_orders_by_node_size(uint32_t node_size, uint32_t index_id_size, bool has_payloads, uint32_t *p_order, uint32_t *p_compressed_order)
+{
+    size_t fields_size = get_index_node_compressed_size(0, 0, 0, false);
+    // each element also takes a child_tag.
+    size_t element_size = sizeof(uint32_t) + ((has_payloads) ? (INDEX_PAYLOAD_SIZE) : (0));
+    uint32_t order = 0, compressed_order = 0;
 
-    for (uint32_t i = 0; i < write_length; i++)
+    if (node_size > fields_size + index_id_size)
     {
-        // write index_id
-        if (p_index_element[i].p_index_id != NULL)
-        {
-            pwrite(fd, p_index_element[i].p_index_id, index_id_size, index_element_offset);
-        }
-        else
-        {
-            pwrite(fd, zero_buffer, index_id_size, index_element_offset);
-        }
-        index_element_offset += index_id_size;
+        order = (node_size - fields_size) / (element_size + index_id_size);
+        compressed_order = (node_size - fields_size - index_id_size) / element_size;
+    }
+
+    *p_order = order;
+    *p_compressed_order = ((order > 0) && (compressed_order > (2 * order) - 1)) ? ((2 * order) - 1) : (compressed_order);
+}
 
-        // write payload
-        pwrite(fd, p_index_element[i].index_payload, INDEX_PAYLOAD_SIZE, index_element_offset);
-        index_element_offset += INDEX_PAYLOAD_SIZE;
+// The B+ tree nodes of a new index file are prefix compressed if its index ids are ordered by their leading bytes (string and composite).
+// order and internal_order are lowered to the elements fitting in a compressed node whatever the index ids are.
+void set_index_compressed_orders(INDEX_PROPERTIES_T *p_index_properties)
+{
+    uint32_t index_id_size = Index_Id_Type_Get_Size(p_index_properties->index_id_type);
+    uint32_t order = 0, compressed_order = 0, internal_order = 0, compressed_internal_order = 0;
+
+    if (Index_Id_Type_Get_Ordered_Prefix_Size(p_index_properties->index_id_type) == 0)
+    {
+        return;
     }
 
-#else  // IS_POSIX_API_SUPPORT
-    fseek(p_index_file, index_element_offset, SEEK_SET);
-    for (uint32_t i = 0; i < write_length; i++)
+    get_index_compressed_orders_by_node_size(p_index_properties->node_size, index_id_size, true, &order, &compressed_order);
+    get_index_compressed_orders_by_node_size(p_index_properties->node_size, index_id_size, false, &internal_order, &compressed_internal_order);
+    if ((order < INDEX_MIN_ORDER) || (internal_order < INDEX_MIN_ORDER))
     {
-        if (p_index_element[i].p_index_id != NULL)
-        {
-            fwrite(p_index_element[i].p_index_id, index_id_size, 1, p_index_file);
-        }
-        else
-        {
-            fwrite(zero_buffer, index_id_size, 1, p_index_file);
-        }
-        fwrite(p_index_element[i].index_payload, INDEX_PAYLOAD_SIZE, 1, p_index_file);
+        // The node is too small for the compressed fields, keep the uncompressed nodes.
+        return;
     }
 
-    // flush in write_index_node
-    // fflush(p_index_file);
-#endif // IS_POSIX_API_SUPPORT
+    p_index_properties->order = order;
+    p_index_properties->internal_order = internal_order;
+    p_index_properties->compressed_order = compressed_order;
+    p_index_properties->compressed_internal_order = compressed_internal_order;
 }
 
-/*
-** Read numbers of index_elements from file.
-** p_index_element array length should greater or equal to the read_length.
-*/
-void read_index_elements(INDEX_INFO_T *p_index_info, const uint32_t tag, const uint32_t index_element_position, const uint32_t read_length, INDEX_ELEMENT_T *p_index_element)
+// Bytes of the node buffers of the index file, the decoded compressed nodes may be larger than node_size.
+size_t get_index_node_buffer_size(INDEX_PROPERTIES_T *p_index_properties)
 {
-    assert((index_element_position + read_length) <= INDEX_ORDER);
-
-    INDEX_PROPERTIES_T *p_index_properties = &(p_index_info->index_properties);
-    FILE *p_index_file = p_index_info->index_file;
-    off_t index_element_offset = get_index_element_offset(p_index_properties, tag, index_element_position);
     uint32_t index_id_size = Index_Id_Type_Get_Size(p_index_properties->index_id_type);
+    size_t buffer_size = p_index_properties->node_size;
+    size_t leaf_image_size = 0, internal_image_size = 0;
 
-#if IS_POSIX_API_SUPPORT
-    int fd = fileno(p_index_file);
+    if (p_index_properties->compressed_order > 0)
+    {
+        leaf_image_size = get_index_node_image_size(p_index_properties->compressed_order, index_id_size);
+        internal_image_size = get_index_node_fields_size(p_index_properties->compressed_internal_order) + ((size_t)p_index_properties->compressed_internal_order * index_id_size);
+        buffer_size = (leaf_image_size > buffer_size) ? (leaf_image_size) : (buffer_size);
+        buffer_size = (internal_image_size > buffer_size) ? (internal_image_size) : (buffer_size);
+    }
+
+    return buffer_size;
+}
+
+// The posting nodes of a B+ tree with compressed nodes aren't compressed.
+static inline bool is_index_node_compressed(INDEX_PROPERTIES_T *p_index_properties, uint32_t level)
+{
+    return (p_index_properties->compressed_order > 0) && (level != INDEX_POSTING_LIST_LEVEL);
+}
+
+// Narrow the shared leading bytes (*p_prefix_size) and widen the bytes before the trailing zero bytes (*p_end_size) by the index id.
+// p_first_index_id is any index id of the bounded ones, start with index_id_size and 0 before the first index id.
+static inline void add_index_id_bounds(uint32_t index_id_size, const uint8_t *p_first_index_id, const uint8_t *p_index_id, uint32_t *p_prefix_size, uint32_t *p_end_size)
+{
+    uint32_t prefix_size = 0, end_size = index_id_size;
 
-    for (uint32_t i = 0; i < read_length; i++)
+    while ((prefix_size < *p_prefix_size) && (p_index_id[prefix_size] == p_first_index_id[prefix_size]))
     {
-        allocate_index_element_resources(&(p_index_element[i]), index_id_size);
-        // read index_id
-        pread(fd, p_index_element[i].p_index_id, index_id_size, index_element_offset);
-        index_element_offset += index_id_size;
-        // read index_paylolad
-        pread(fd, p_index_element[i].index_payload, INDEX_PAYLOAD_SIZE, index_element_offset);
-        index_element_offset += INDEX_PAYLOAD_SIZE;
+        prefix_size++;
     }
-#else // IS_POSIX_API_SUPPORT
-    fseek(p_index_file, index_element_offset, SEEK_SET);
-    for (uint32_t i = 0; i < read_length; i++)
+    while ((end_size > *p_end_size) && (p_index_id[end_size - 1] == 0))
     {
-        allocate_index_element_resources(&(p_index_element[i]), index_id_size);
-        // read index_id
-        fread(p_index_element[i].p_index_id, index_id_size, 1, p_index_file);
-        // read index_paylolad
-        fread(p_index_element[i].index_payload, INDEX_PAYLOAD_SIZE, 1, p_index_file);
+        end_size--;
     }
-#endif
+
+    *p_prefix_size = prefix_size;
+    *p_end_size = end_size;
 }
 
-off_t get_index_element_offset(INDEX_PROPERTIES_T *p_index_properties, uint32_t tag, uint32_t index_element_position)
+// Add the bounds of the index ids of the node except the [skip_position] one, UINT32_MAX skips none.
+void get_index_node_index_id_bounds(INDEX_NODE_T *p_index_node, uint32_t skip_position, const uint8_t *p_first_index_id, uint32_t *p_prefix_size, uint32_t *p_end_size)
 {
-    uint32_t index_id_size = Index_Id_Type_Get_Size(p_index_properties->index_id_type);
-    off_t index_node_offset = get_node_offset(p_index_properties, tag);
-    // tag + level + length + parent_tag + next_tag + child_tag[INDEX_CHILD_TAG_ORDER]
-    size_t index_before_fields_size = sizeof(uint32_t) * (INDEX_CHILD_TAG_ORDER + 5);
-    size_t index_element_offset_of_node = index_element_position * (index_id_size + (INDEX_PAYLOAD_SIZE * sizeof(uint8_t)));
+    uint32_t index_id_size = p_index_node->index_id_size;
 
-    return index_node_offset + index_before_fields_size + index_element_offset_of_node;
+    // Stop once nothing is shared and nothing ends early, the usual case of the unrelated hash bytes.
+    for (uint32_t i = 0; (i < p_index_node->length) && ((*p_prefix_size > 0) || (*p_end_size < index_id_size)); i++)
+    {
+        if (i != skip_position)
+        {
+            add_index_id_bounds(index_id_size, p_first_index_id, p_index_node->p_index_ids + ((size_t)index_id_size * i), p_prefix_size, p_end_size);
+        }
+    }
 }
 
-void allocate_index_element_resources(INDEX_ELEMENT_T *p_index_element, uint32_t index_id_size)
+// Encode the compressed image of the node into p_image, which has node_size bytes. Return the bytes of the compressed image.
+size_t encode_index_node_image(INDEX_NODE_T *p_index_node, uint8_t *p_image)
 {
-    if (p_index_element->p_index_id)
+    uint32_t index_id_size = p_index_node->index_id_size, length = p_index_node->length;
+    uint32_t prefix_size = index_id_size, end_size = 0, suffix_size = 0;
+    size_t compressed_size = 0;
+    uint8_t *p_position = p_image;
+
+    get_index_node_index_id_bounds(p_index_node, UINT32_MAX, p_index_node->p_index_ids, &prefix_size, &end_size);
+    prefix_size = (prefix_size < end_size) ? (prefix_size) : (end_size);
+    suffix_size = end_size - prefix_size;
+    compressed_size = get_index_node_compressed_size(length, prefix_size, end_size, (p_index_node->p_payloads != NULL));
+    // The insertions and the rebalancing keep the compressed elements fitting in the node.
+    assert(compressed_size <= p_index_node->node_size);
+    if (compressed_size > p_index_node->node_size)
+    {
+        return compressed_size;
+    }
+
+    memcpy(p_position, p_index_node->p_node_image, sizeof(uint32_t) * INDEX_NODE_HEADER_FIELD_NUM);
+    p_position += sizeof(uint32_t) * INDEX_NODE_HEADER_FIELD_NUM;
+    memcpy(p_position, p_index_node->child_tag, sizeof(uint32_t) * (length + 1));
+    p_position += sizeof(uint32_t) * (length + 1);
+    memcpy(p_position, &prefix_size, sizeof(uint32_t));
+    p_position += sizeof(uint32_t);
+    memcpy(p_position, &end_size, sizeof(uint32_t));
+    p_position += sizeof(uint32_t);
+
+    memcpy(p_position, p_index_node->p_index_ids, prefix_size);
+    p_position += prefix_size;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        memcpy(p_position, p_index_node->p_index_ids + ((size_t)index_id_size * i) + prefix_size, suffix_size);
+        p_position += suffix_size;
+    }
+
+    if (p_index_node->p_payloads != NULL)
+    {
+        memcpy(p_position, p_index_node->p_payloads, (size_t)length * INDEX_PAYLOAD_SIZE);
+        p_position += (size_t)length * INDEX_PAYLOAD_SIZE;
+    }
+    assert((size_t)(p_position - p_image) == compressed_size);
+
+    return compressed_size;
+}
+
+// Decode the compressed image into the node, whose header and layout are already set from the image and the rest is zero.
+void decode_index_node_image(INDEX_NODE_T *p_index_node, const uint8_t *p_image)
+{
+    uint32_t index_id_size = p_index_node->index_id_size, length = p_index_node->length;
+    uint32_t prefix_size = 0, end_size = 0, suffix_size = 0;
+    const uint8_t *p_position = p_image + (sizeof(uint32_t) * INDEX_NODE_HEADER_FIELD_NUM);
+    const uint8_t *p_prefix = NULL;
+
+    assert(length <= p_index_node->order);
+    memcpy(p_index_node->child_tag, p_position, sizeof(uint32_t) * (length + 1));
+    p_position += sizeof(uint32_t) * (length + 1);
+    memcpy(&prefix_size, p_position, sizeof(uint32_t));
+    p_position += sizeof(uint32_t);
+    memcpy(&end_size, p_position, sizeof(uint32_t));
+    p_position += sizeof(uint32_t);
+    assert((prefix_size <= end_size) && (end_size <= index_id_size));
+    suffix_size = end_size - prefix_size;
+
+    p_prefix = p_position;
+    p_position += prefix_size;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        uint8_t *p_index_id = p_index_node->p_index_ids + ((size_t)index_id_size * i);
+
+        memcpy(p_index_id, p_prefix, prefix_size);
+        memcpy(p_index_id + prefix_size, p_position, suffix_size);
+        p_position += suffix_size;
+    }
+
+    if (p_index_node->p_payloads != NULL)
+    {
+        memcpy(p_index_node->p_payloads, p_position, (size_t)length * INDEX_PAYLOAD_SIZE);
+    }
+}
+
+void free_index_node_resources(INDEX_NODE_T *p_index_node)
+{
+    if (p_index_node->p_node_image != NULL)
+    {
+        free(p_index_node->p_node_image);
+        p_index_node->p_node_image = NULL;
+    }
+
+    p_index_node->child_tag = NULL;
+    p_index_node->p_index_ids = NULL;
+    p_index_node->p_payloads = NULL;
+    p_index_node->order = 0;
+    p_index_node->node_size = 0;
+    p_index_node->image_size = 0;
+}
+
+void index_node_cache_init(INDEX_NODE_CACHE_T *p_index_node_cache)
+{
+    p_index_node_cache->change_sequence = 0;
+    p_index_node_cache->tick = 0;
+    p_index_node_cache->is_index_properties_dirty = false;
+
+    for (uint32_t i = 0; i < INDEX_NODE_CACHE_BUCKET_NUM; i++)
+    {
+        p_index_node_cache->bucket[i] = INDEX_NODE_CACHE_NULL_ENTRY;
+    }
+
+    // tag = 0 means the entry is unused.
+    for (uint32_t i = 0; i < INDEX_NODE_CACHE_SIZE; i++)
+    {
+        INDEX_NODE_CACHE_ENTRY_T *p_entry = &(p_index_node_cache->entries[i]);
+
+        // node image is allocated when the entry is requested first time.
+        memset(&(p_entry->index_node), 0, sizeof(INDEX_NODE_T));
+        p_entry->pin_count = 0;
+        p_entry->is_dirty = false;
+        p_entry->last_used_tick = 0;
+        p_entry->next_entry = INDEX_NODE_CACHE_NULL_ENTRY;
+    }
+}
+
+static inline void lock_index_node_cache(INDEX_NODE_CACHE_T *p_index_node_cache)
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_lock(&(p_index_node_cache->mutex));
+#endif
+}
+
+static inline void unlock_index_node_cache(INDEX_NODE_CACHE_T *p_index_node_cache)
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_mutex_unlock(&(p_index_node_cache->mutex));
+#endif
+}
+
+static inline uint32_t get_index_node_cache_bucket(uint32_t tag)
+{
+    // Knuth multiplicative hash
+    return (tag * 2654435761u) & (INDEX_NODE_CACHE_BUCKET_NUM - 1);
+}
+
+// Lock the index node cache before using this function.
+INDEX_NODE_CACHE_ENTRY_T *query_index_node_cache_entry(INDEX_NODE_CACHE_T *p_index_node_cache, uint32_t tag)
+{
+    int32_t entry_position = p_index_node_cache->bucket[get_index_node_cache_bucket(tag)];
+
+    while (entry_position != INDEX_NODE_CACHE_NULL_ENTRY)
+    {
+        INDEX_NODE_CACHE_ENTRY_T *p_entry = &(p_index_node_cache->entries[entry_position]);
+        if (p_entry->index_node.tag == tag)
+        {
+            return p_entry;
+        }
+        entry_position = p_entry->next_entry;
+    }
+
+    return NULL;
+}
+
+// Write back (if dirty) and remove the entry from the cache.
+// Lock the index node cache before using this function.
+void evict_index_node_cache_entry(INDEX_INFO_T *p_index_info, INDEX_NODE_CACHE_ENTRY_T *p_entry)
+{
+    INDEX_NODE_CACHE_T *p_index_node_cache = &(p_index_info->index_node_cache);
+    int32_t *p_entry_position = &(p_index_node_cache->bucket[get_index_node_cache_bucket(p_entry->index_node.tag)]);
+
+    assert(p_entry->pin_count == 0);
+
+    if (p_entry->is_dirty)
+    {
+        // Only writers make dirty nodes, and the index file is locked by the writer.
+        write_index_node(p_index_info, &(p_entry->index_node));
+        p_entry->is_dirty = false;
+        // The index file is changed even if no dirty node is left, flush_index_node_cache() increases and writes change_sequence.
+        p_index_info->index_node_cache.is_index_properties_dirty = true;
+    }
+
+    // Unlink from the hash bucket.
+    while (*p_entry_position != INDEX_NODE_CACHE_NULL_ENTRY)
+    {
+        INDEX_NODE_CACHE_ENTRY_T *p_current_entry = &(p_index_node_cache->entries[*p_entry_position]);
+        if (p_current_entry == p_entry)
+        {
+            *p_entry_position = p_entry->next_entry;
+            break;
+        }
+        p_entry_position = &(p_current_entry->next_entry);
+    }
+
+    // Keep the node buffer for the next request.
+    p_entry->index_node.tag = 0;
+    p_entry->next_entry = INDEX_NODE_CACHE_NULL_ENTRY;
+}
+
+// The posting nodes are evicted with the leaf nodes.
+static inline uint32_t get_index_node_eviction_level(INDEX_NODE_T *p_index_node)
+{
+    return (p_index_node->level == INDEX_POSTING_LIST_LEVEL) ? (0) : (p_index_node->level);
+}
+
+// Find an unused entry (or evict one) and link it to the hash bucket of tag.
+// Eviction order: lower level first, then least recently used. The root and upper levels stay resident.
+// Lock the index node cache before using this function.
+INDEX_NODE_CACHE_ENTRY_T *request_index_node_cache_entry(INDEX_INFO_T *p_index_info, uint32_t tag)
+{
+    INDEX_NODE_CACHE_T *p_index_node_cache = &(p_index_info->index_node_cache);
+    INDEX_NODE_CACHE_ENTRY_T *p_victim_entry = NULL;
+    uint32_t bucket = get_index_node_cache_bucket(tag);
+
+    for (uint32_t i = 0; i < INDEX_NODE_CACHE_SIZE; i++)
+    {
+        INDEX_NODE_CACHE_ENTRY_T *p_entry = &(p_index_node_cache->entries[i]);
+
+        if (p_entry->index_node.tag == 0)
+        {
+            // unused entry
+            p_victim_entry = p_entry;
+            break;
+        }
+
+        if (p_entry->pin_count > 0 || p_entry->index_node.tag == p_index_info->index_properties.root_tag)
+        {
+            continue;
+        }
+
+        if ((p_victim_entry == NULL) ||
+            (get_index_node_eviction_level(&(p_entry->index_node)) < get_index_node_eviction_level(&(p_victim_entry->index_node))) ||
+            ((get_index_node_eviction_level(&(p_entry->index_node)) == get_index_node_eviction_level(&(p_victim_entry->index_node))) && (p_entry->last_used_tick < p_victim_entry->last_used_tick)))
+        {
+            p_victim_entry = p_entry;
+        }
+    }
+
+    // All entries are pinned, INDEX_NODE_CACHE_SIZE should be greater than the pinned nodes of a tree operation.
+    assert(p_victim_entry != NULL);
+
+    if (p_victim_entry->index_node.tag != 0)
+    {
+        evict_index_node_cache_entry(p_index_info, p_victim_entry);
+    }
+
+    if (is_index_node_layout_matched(&(p_victim_entry->index_node), &(p_index_info->index_properties)))
+    {
+        reset_index_node(&(p_victim_entry->index_node), tag, &(p_index_info->index_properties));
+    }
+    else
+    {
+        free_index_node_resources(&(p_victim_entry->index_node));
+        index_node_init(&(p_victim_entry->index_node), tag, &(p_index_info->index_properties));
+    }
+    p_victim_entry->pin_count = 0;
+    p_victim_entry->is_dirty = false;
+    p_victim_entry->next_entry = p_index_node_cache->bucket[bucket];
+    p_index_node_cache->bucket[bucket] = p_victim_entry - p_index_node_cache->entries;
+
+    return p_victim_entry;
+}
+
+// Return the pinned cached node, the node is read from the index file if it is not cached.
+// Call release_index_node() after using the node.
+INDEX_NODE_T *fetch_index_node(INDEX_INFO_T *p_index_info, uint32_t tag)
+{
+    INDEX_NODE_CACHE_T *p_index_node_cache = &(p_index_info->index_node_cache);
+    INDEX_NODE_CACHE_ENTRY_T *p_entry = NULL;
+
+    lock_index_node_cache(p_index_node_cache);
+
+    // tag is a 1-index number and it should smaller than the tag number.
+    // tag_num is increased by the latch writer with the cache locked.
+    if (tag == 0 || p_index_info->index_properties.tag_num < tag)
+    {
+        unlock_index_node_cache(p_index_node_cache);
+        return NULL;
+    }
+
+    p_entry = query_index_node_cache_entry(p_index_node_cache, tag);
+    if (p_entry == NULL)
+    {
+        p_entry = request_index_node_cache_entry(p_index_info, tag);
+        read_index_node(p_index_info, tag, &(p_entry->index_node));
+    }
+
+    p_entry->pin_count++;
+    p_entry->last_used_tick = ++(p_index_node_cache->tick);
+
+    unlock_index_node_cache(p_index_node_cache);
+
+    return &(p_entry->index_node);
+}
+
+// Allocate a new tag and return the pinned and dirty empty node.
+INDEX_NODE_T *create_index_node(INDEX_INFO_T *p_index_info)
+{
+    INDEX_NODE_CACHE_T *p_index_node_cache = &(p_index_info->index_node_cache);
+    INDEX_PROPERTIES_T *p_index_properties = &(p_index_info->index_properties);
+    INDEX_NODE_CACHE_ENTRY_T *p_entry = NULL;
+
+    lock_index_node_cache(p_index_node_cache);
+
+    p_index_properties->tag_num++;
+    p_index_node_cache->is_index_properties_dirty = true;
+
+    p_entry = request_index_node_cache_entry(p_index_info, p_index_properties->tag_num);
+    p_entry->pin_count = 1;
+    p_entry->is_dirty = true;
+    p_entry->last_used_tick = ++(p_index_node_cache->tick);
+
+    unlock_index_node_cache(p_index_node_cache);
+
+    return &(p_entry->index_node);
+}
+
+void release_index_node(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node)
+{
+    INDEX_NODE_CACHE_T *p_index_node_cache = &(p_index_info->index_node_cache);
+    INDEX_NODE_CACHE_ENTRY_T *p_entry = (INDEX_NODE_CACHE_ENTRY_T *)p_index_node;
+
+    lock_index_node_cache(p_index_node_cache);
+    assert(p_entry->pin_count > 0);
+    p_entry->pin_count--;
+    unlock_index_node_cache(p_index_node_cache);
+}
+
+// The node will be written back by flush_index_node_cache() or eviction.
+void mark_index_node_dirty(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node)
+{
+    ((INDEX_NODE_CACHE_ENTRY_T *)p_index_node)->is_dirty = true;
+}
+
+void mark_index_properties_dirty(INDEX_INFO_T *p_index_info)
+{
+    p_index_info->index_node_cache.is_index_properties_dirty = true;
+}
+
+// Drop the cached nodes if other processes changed the index file.
+// Lock the index file before using this function.
+void sync_index_node_cache(INDEX_INFO_T *p_index_info)
+{
+    INDEX_NODE_CACHE_T *p_index_node_cache = &(p_index_info->index_node_cache);
+    INDEX_PROPERTIES_T *p_index_properties = &(p_index_info->index_properties);
+    uint32_t change_sequence = 0;
+
+    // The latch writer of this process writes change_sequence with the cache locked.
+    lock_index_node_cache(p_index_node_cache);
+    change_sequence = read_index_change_sequence(p_index_info);
+
+    if (change_sequence != p_index_node_cache->change_sequence)
+    {
+        // Each write operation of other processes changes change_sequence once.
+        p_index_info->index_statistics_info.modified_num += (uint32_t)(change_sequence - p_index_node_cache->change_sequence);
+
+        for (uint32_t i = 0; i < INDEX_NODE_CACHE_SIZE; i++)
+        {
+            INDEX_NODE_CACHE_ENTRY_T *p_entry = &(p_index_node_cache->entries[i]);
+
+            if (p_entry->index_node.tag != 0)
+            {
+                assert(p_entry->is_dirty == false);
+                evict_index_node_cache_entry(p_index_info, p_entry);
+            }
+        }
+
+        // Reload tag_num and root_tag changed by other processes, key and index_id_type never change.
+#if IS_POSIX_API_SUPPORT
+        int fd = fileno(p_index_info->index_file);
+        pread(fd, &(p_index_properties->tag_num), sizeof(p_index_properties->tag_num), INDEX_FILE_FORMAT_HEADER_SIZE);
+        pread(fd, &(p_index_properties->root_tag), sizeof(p_index_properties->root_tag), INDEX_FILE_FORMAT_HEADER_SIZE + sizeof(p_index_properties->tag_num));
+#else  // IS_POSIX_API_SUPPORT
+        fseek(p_index_info->index_file, INDEX_FILE_FORMAT_HEADER_SIZE, SEEK_SET);
+        fread(&(p_index_properties->tag_num), sizeof(p_index_properties->tag_num), 1, p_index_info->index_file);
+        fread(&(p_index_properties->root_tag), sizeof(p_index_properties->root_tag), 1, p_index_info->index_file);
+#endif // IS_POSIX_API_SUPPORT
+        p_index_properties->change_sequence = change_sequence;
+        p_index_node_cache->change_sequence = p_index_properties->change_sequence;
+        p_index_info->index_write_buffer.is_loaded = false;
+    }
+
+    // The write buffer is reloaded with the nodes, it's loaded at the first access of the index file.
+    if ((p_index_info->index_write_buffer.is_loaded == false) && (p_index_properties->index_structure == INDEX_STRUCTURE_BTREE))
+    {
+        load_index_write_buffer(p_index_info);
+    }
+
+    unlock_index_node_cache(p_index_node_cache);
+}
+
+// Write back the dirty nodes and index properties.
+// Lock the index file (write) before using this function.
+void flush_index_node_cache(INDEX_INFO_T *p_index_info)
+{
+    INDEX_NODE_CACHE_T *p_index_node_cache = &(p_index_info->index_node_cache);
+    bool is_changed = p_index_node_cache->is_index_properties_dirty;
+
+    lock_index_node_cache(p_index_node_cache);
+
+    for (uint32_t i = 0; i < INDEX_NODE_CACHE_SIZE; i++)
+    {
+        INDEX_NODE_CACHE_ENTRY_T *p_entry = &(p_index_node_cache->entries[i]);
+
+        if (p_entry->index_node.tag != 0 && p_entry->is_dirty)
+        {
+            write_index_node(p_index_info, &(p_entry->index_node));
+            p_entry->is_dirty = false;
+            is_changed = true;
+        }
+    }
+
+    if (is_changed)
+    {
+        // Notify other processes that the index file has been changed.
+        p_index_info->index_properties.change_sequence++;
+        p_index_node_cache->change_sequence = p_index_info->index_properties.change_sequence;
+        write_index_properties(p_index_info);
+        p_index_node_cache->is_index_properties_dirty = false;
+    }
+
+    unlock_index_node_cache(p_index_node_cache);
+}
+
+// Release all cached nodes. Dirty nodes have been written back by the writer.
+void close_index_node_cache(INDEX_INFO_T *p_index_info)
+{
+    INDEX_NODE_CACHE_T *p_index_node_cache = &(p_index_info->index_node_cache);
+
+    for (uint32_t i = 0; i < INDEX_NODE_CACHE_SIZE; i++)
+    {
+        free_index_node_resources(&(p_index_node_cache->entries[i].index_node));
+    }
+
+    index_node_cache_init(p_index_node_cache);
+}
+
+uint32_t read_index_change_sequence(INDEX_INFO_T *p_index_info)
+{
+    FILE *p_index_file = p_index_info->index_file;
+    INDEX_PROPERTIES_T *p_index_properties = &(p_index_info->index_properties);
+    uint32_t change_sequence = 0;
+    // change_sequence is stored after magic, format_version, tag_num, root_tag and index_id_type.
+    off_t offset = INDEX_FILE_FORMAT_HEADER_SIZE + sizeof(p_index_properties->tag_num) + sizeof(p_index_properties->root_tag) + sizeof(p_index_properties->index_format_32);
+
+#if IS_POSIX_API_SUPPORT
+    int fd = fileno(p_index_file);
+    pread(fd, &change_sequence, sizeof(change_sequence), offset);
+#else  // IS_POSIX_API_SUPPORT
+    fseek(p_index_file, offset, SEEK_SET);
+    fread(&change_sequence, sizeof(change_sequence), 1, p_index_file);
+#endif // IS_POSIX_API_SUPPORT
+
+    return change_sequence;
+}
+
+void index_write_buffer_init(INDEX_WRITE_BUFFER_T *p_index_write_buffer)
+{
+    p_index_write_buffer->file_path[0] = '\0';
+    p_index_write_buffer->write_buffer_file = NULL;
+    p_index_write_buffer->is_loaded = false;
+    p_index_write_buffer->length = 0;
+    p_index_write_buffer->capacity = 0;
+    p_index_write_buffer->p_index_ids = NULL;
+    p_index_write_buffer->p_payloads = NULL;
+}
+
+// The buffered elements have been stored in the write buffer file.
+void close_index_write_buffer(INDEX_WRITE_BUFFER_T *p_index_write_buffer)
+{
+    if (p_index_write_buffer->write_buffer_file != NULL)
+    {
+        fclose(p_index_write_buffer->write_buffer_file);
+    }
+
+    free(p_index_write_buffer->p_index_ids);
+    free(p_index_write_buffer->p_payloads);
+    index_write_buffer_init(p_index_write_buffer);
+}
+
+// Open the write buffer file, create it if is_creating is true.
+// Return false if the write buffer file doesn't exist or can't be opened.
+bool open_index_write_buffer_file(INDEX_WRITE_BUFFER_T *p_index_write_buffer, bool is_creating)
+{
+    if (p_index_write_buffer->write_buffer_file != NULL)
+    {
+        return true;
+    }
+
+    if (p_index_write_buffer->file_path[0] == '\0')
+    {
+        return false;
+    }
+
+#if IS_POSIX_API_SUPPORT
+    int fd = open(p_index_write_buffer->file_path, (is_creating) ? (O_RDWR | O_CREAT) : (O_RDWR), 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    p_index_write_buffer->write_buffer_file = fdopen(fd, "rb+");
+    if (p_index_write_buffer->write_buffer_file == NULL)
+    {
+        close(fd);
+        return false;
+    }
+#else  // IS_POSIX_API_SUPPORT
+    p_index_write_buffer->write_buffer_file = fopen(p_index_write_buffer->file_path, "rb+");
+    if ((p_index_write_buffer->write_buffer_file == NULL) && is_creating)
+    {
+        p_index_write_buffer->write_buffer_file = fopen(p_index_write_buffer->file_path, "wb+");
+    }
+
+    if (p_index_write_buffer->write_buffer_file == NULL)
+    {
+        return false;
+    }
+#endif // IS_POSIX_API_SUPPORT
+
+    return true;
+}
+
+// Make room for element_num elements, the capacity is doubled to append elements one by one.
+bool reserve_index_write_buffer(INDEX_WRITE_BUFFER_T *p_index_write_buffer, uint32_t element_num, uint32_t index_id_size)
+{
+    uint32_t new_capacity = (p_index_write_buffer->capacity == 0) ? (element_num) : (p_index_write_buffer->capacity);
+    uint8_t *p_new_index_ids = NULL, *p_new_payloads = NULL;
+
+    if (element_num <= p_index_write_buffer->capacity)
+    {
+        return true;
+    }
+
+    while (new_capacity < element_num)
+    {
+        new_capacity *= 2;
+    }
+
+    p_new_index_ids = realloc(p_index_write_buffer->p_index_ids, (size_t)new_capacity * index_id_size);
+    if (p_new_index_ids == NULL)
+    {
+        return false;
+    }
+    p_index_write_buffer->p_index_ids = p_new_index_ids;
+
+    p_new_payloads = realloc(p_index_write_buffer->p_payloads, (size_t)new_capacity * INDEX_PAYLOAD_SIZE);
+    if (p_new_payloads == NULL)
+    {
+        return false;
+    }
+    p_index_write_buffer->p_payloads = p_new_payloads;
+
+    p_index_write_buffer->capacity = new_capacity;
+    return true;
+}
+
+// Read the buffered elements from the write buffer file.
+// Lock the index file and the node cache before using this function.
+void load_index_write_buffer(INDEX_INFO_T *p_index_info)
+{
+    INDEX_WRITE_BUFFER_T *p_index_write_buffer = &(p_index_info->index_write_buffer);
+    uint32_t index_id_size = Index_Id_Type_Get_Size(p_index_info->index_properties.index_id_type);
+    uint32_t element_size = index_id_size + INDEX_PAYLOAD_SIZE;
+    uint32_t element_num = 0;
+    uint8_t *p_elements = NULL;
+    bool is_reserved = false;
+    off_t file_size = 0;
+
+    p_index_write_buffer->length = 0;
+    p_index_write_buffer->is_loaded = true;
+
+    if (open_index_write_buffer_file(p_index_write_buffer, false) == false)
+    {
+        return;
+    }
+
+#if IS_POSIX_API_SUPPORT
+    int fd = fileno(p_index_write_buffer->write_buffer_file);
+    file_size = lseek(fd, 0, SEEK_END);
+#else  // IS_POSIX_API_SUPPORT
+    fseek(p_index_write_buffer->write_buffer_file, 0, SEEK_END);
+    file_size = ftell(p_index_write_buffer->write_buffer_file);
+#endif // IS_POSIX_API_SUPPORT
+
+    // A partially written element is ignored.
+    element_num = (file_size > 0) ? (uint32_t)(file_size / element_size) : (0);
+    if (element_num == 0)
+    {
+        return;
+    }
+
+    p_elements = malloc((size_t)element_num * element_size);
+    is_reserved = reserve_index_write_buffer(p_index_write_buffer, element_num, index_id_size);
+    assert((p_elements != NULL) && is_reserved);
+    if ((p_elements == NULL) || (is_reserved == false))
+    {
+        // The elements are kept in the file, load them again at the next access.
+        free(p_elements);
+        p_index_write_buffer->is_loaded = false;
+        return;
+    }
+
+#if IS_POSIX_API_SUPPORT
+    pread(fd, p_elements, (size_t)element_num * element_size, 0);
+#else  // IS_POSIX_API_SUPPORT
+    fseek(p_index_write_buffer->write_buffer_file, 0, SEEK_SET);
+    fread(p_elements, element_size, element_num, p_index_write_buffer->write_buffer_file);
+#endif // IS_POSIX_API_SUPPORT
+
+    // Each element is stored as index id | payload.
+    for (uint32_t i = 0; i < element_num; i++)
+    {
+        memcpy(p_index_write_buffer->p_index_ids + (index_id_size * i), p_elements + (element_size * i), index_id_size);
+        memcpy(p_index_write_buffer->p_payloads + (INDEX_PAYLOAD_SIZE * i), p_elements + (element_size * i) + index_id_size, INDEX_PAYLOAD_SIZE);
+    }
+    p_index_write_buffer->length = element_num;
+
+    free(p_elements);
+}
+
+// Write the buffered elements from start to the end of the write buffer file.
+// The elements after the buffered ones are cut off if is_truncating is true.
+// Lock the index file (write) and the node cache before using this function.
+void write_index_write_buffer_file(INDEX_INFO_T *p_index_info, uint32_t start, bool is_truncating)
+{
+    INDEX_WRITE_BUFFER_T *p_index_write_buffer = &(p_index_info->index_write_buffer);
+    uint32_t index_id_size = Index_Id_Type_Get_Size(p_index_info->index_properties.index_id_type);
+    uint32_t element_size = index_id_size + INDEX_PAYLOAD_SIZE;
+    uint8_t *p_elements = NULL;
+    uint32_t element_num = 0;
+
+    if (open_index_write_buffer_file(p_index_write_buffer, true) == false)
+    {
+        perror("Index write buffer file unavailable: ");
+        return;
+    }
+
+#if !IS_POSIX_API_SUPPORT
+    if (is_truncating)
+    {
+        // Recreate the file and write all the buffered elements.
+        p_index_write_buffer->write_buffer_file = freopen(p_index_write_buffer->file_path, "wb+", p_index_write_buffer->write_buffer_file);
+        assert(p_index_write_buffer->write_buffer_file != NULL);
+        start = 0;
+    }
+#endif // !IS_POSIX_API_SUPPORT
+
+    element_num = p_index_write_buffer->length - start;
+    if (element_num > 0)
+    {
+        p_elements = malloc((size_t)element_num * element_size);
+        assert(p_elements != NULL);
+
+        for (uint32_t i = 0; i < element_num; i++)
+        {
+            memcpy(p_elements + (element_size * i), p_index_write_buffer->p_index_ids + (index_id_size * (start + i)), index_id_size);
+            memcpy(p_elements + (element_size * i) + index_id_size, p_index_write_buffer->p_payloads + (INDEX_PAYLOAD_SIZE * (start + i)), INDEX_PAYLOAD_SIZE);
+        }
+
+#if IS_POSIX_API_SUPPORT
+        pwrite(fileno(p_index_write_buffer->write_buffer_file), p_elements, (size_t)element_num * element_size, (off_t)start * element_size);
+#else  // IS_POSIX_API_SUPPORT
+        fseek(p_index_write_buffer->write_buffer_file, (long)start * element_size, SEEK_SET);
+        fwrite(p_elements, element_size, element_num, p_index_write_buffer->write_buffer_file);
+        fflush(p_index_write_buffer->write_buffer_file);
+#endif // IS_POSIX_API_SUPPORT
+
+        free(p_elements);
+    }
+
+#if IS_POSIX_API_SUPPORT
+    if (is_truncating)
+    {
+        ftruncate(fileno(p_index_write_buffer->write_buffer_file), (off_t)p_index_write_buffer->length * element_size);
+    }
+#endif // IS_POSIX_API_SUPPORT
+}
+
+uint32_t get_index_write_buffer_length(INDEX_INFO_T *p_index_info)
+{
+    INDEX_NODE_CACHE_T *p_index_node_cache = &(p_index_info->index_node_cache);
+    uint32_t length = 0;
+
+    lock_index_node_cache(p_index_node_cache);
+    length = p_index_info->index_write_buffer.length;
+    unlock_index_node_cache(p_index_node_cache);
+
+    return length;
+}
+
+// Append the element to the write buffer and the write buffer file.
+// The readers search the write buffer with the node cache locked, the latch writer can append at the same time.
+// Lock the index file (write) before using this function.
+void append_index_write_buffer_element(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_index_element)
+{
+    INDEX_NODE_CACHE_T *p_index_node_cache = &(p_index_info->index_node_cache);
+    INDEX_WRITE_BUFFER_T *p_index_write_buffer = &(p_index_info->index_write_buffer);
+    uint32_t index_id_size = Index_Id_Type_Get_Size(p_index_info->index_properties.index_id_type);
+
+    lock_index_node_cache(p_index_node_cache);
+
+    if (reserve_index_write_buffer(p_index_write_buffer, p_index_write_buffer->length + 1, index_id_size) == false)
+    {
+        // allocate more memory error.
+        // Error handling: insert the element into the tree.
+        unlock_index_node_cache(p_index_node_cache);
+        insert_index_element(p_index_info, p_index_element);
+        return;
+    }
+
+    memcpy(p_index_write_buffer->p_index_ids + (index_id_size * p_index_write_buffer->length), p_index_element->p_index_id, index_id_size);
+    memcpy(p_index_write_buffer->p_payloads + (INDEX_PAYLOAD_SIZE * p_index_write_buffer->length), p_index_element->index_payload, INDEX_PAYLOAD_SIZE);
+    p_index_write_buffer->length++;
+
+    write_index_write_buffer_file(p_index_info, p_index_write_buffer->length - 1, false);
+    // change_sequence is increased by flush_index_node_cache() to notify other processes.
+    p_index_node_cache->is_index_properties_dirty = true;
+
+    unlock_index_node_cache(p_index_node_cache);
+}
+
+// Remove the first buffered element whose index id and payload are both equal to the inputted ones.
+// Return false if the element isn't buffered.
+// Lock the index file (write) and block the readers before using this function.
+bool remove_index_write_buffer_element(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_index_element)
+{
+    INDEX_NODE_CACHE_T *p_index_node_cache = &(p_index_info->index_node_cache);
+    INDEX_WRITE_BUFFER_T *p_index_write_buffer = &(p_index_info->index_write_buffer);
+    INDEX_ID_TYPE_E index_id_type = p_index_info->index_properties.index_id_type;
+    uint32_t index_id_size = Index_Id_Type_Get_Size(index_id_type);
+    bool is_removed = false;
+
+    lock_index_node_cache(p_index_node_cache);
+
+    for (uint32_t i = 0; i < p_index_write_buffer->length; i++)
+    {
+        if ((Index_Id_Type_Compare(index_id_type, p_index_write_buffer->p_index_ids + (index_id_size * i), p_index_element->p_index_id) == INDEX_ID_COMPARE_EQUAL) &&
+            (memcmp(p_index_write_buffer->p_payloads + (INDEX_PAYLOAD_SIZE * i), p_index_element->index_payload, INDEX_PAYLOAD_SIZE) == 0))
+        {
+            uint32_t move_num = p_index_write_buffer->length - i - 1;
+
+            memmove(p_index_write_buffer->p_index_ids + (index_id_size * i), p_index_write_buffer->p_index_ids + (index_id_size * (i + 1)), (size_t)move_num * index_id_size);
+            memmove(p_index_write_buffer->p_payloads + (INDEX_PAYLOAD_SIZE * i), p_index_write_buffer->p_payloads + (INDEX_PAYLOAD_SIZE * (i + 1)), (size_t)move_num * INDEX_PAYLOAD_SIZE);
+            p_index_write_buffer->length--;
+
+            write_index_write_buffer_file(p_index_info, i, true);
+            p_index_node_cache->is_index_properties_dirty = true;
+            is_removed = true;
+            break;
+        }
+    }
+
+    unlock_index_node_cache(p_index_node_cache);
+
+    return is_removed;
+}
+
+// Insert the buffered elements into the B+ tree sorted by index id, the insertions to the same leaf node are written back once.
+// The tree is written back before the write buffer file is emptied.
+// Lock the index file (write) and block the readers before using this function.
+void merge_index_write_buffer(INDEX_INFO_T *p_index_info)
+{
+    INDEX_NODE_CACHE_T *p_index_node_cache = &(p_index_info->index_node_cache);
+    INDEX_WRITE_BUFFER_T *p_index_write_buffer = &(p_index_info->index_write_buffer);
+    uint32_t *p_positions = NULL;
+
+    if (p_index_write_buffer->length == 0)
+    {
+        return;
+    }
+
+    p_positions = malloc(sizeof(uint32_t) * p_index_write_buffer->length);
+    assert(p_positions != NULL);
+    for (uint32_t i = 0; i < p_index_write_buffer->length; i++)
+    {
+        p_positions[i] = i;
+    }
+    sort_index_element_positions(p_positions, p_index_write_buffer->length, p_index_write_buffer->p_index_ids, p_index_info->index_properties.index_id_type);
+
+    // The equal index ids are inserted in the buffered order, after the ones in the tree.
+    bulk_insert_index_elements(p_index_info, p_index_write_buffer->p_index_ids, p_index_write_buffer->p_payloads, INDEX_PAYLOAD_SIZE, p_positions, p_index_write_buffer->length);
+    flush_index_node_cache(p_index_info);
+
+    lock_index_node_cache(p_index_node_cache);
+    p_index_write_buffer->length = 0;
+    write_index_write_buffer_file(p_index_info, 0, true);
+    p_index_node_cache->is_index_properties_dirty = true;
+    unlock_index_node_cache(p_index_node_cache);
+
+    free(p_positions);
+}
+
+// Return true if two string elements in [lower, upper] are truncated strings sharing the prefix, their lexicographic order is unknown.
+// p_result_index_ids: sorted index ids of the tree elements in the range.
+bool is_index_string_range_order_unknown(INDEX_INFO_T *p_index_info, void *p_lower_index_id, void *p_upper_index_id, uint8_t *p_result_index_ids, uint32_t result_length)
+{
+    uint32_t index_id_size = Index_Id_Type_Get_Size(INDEX_ID_TYPE_STRING);
+    uint8_t *p_buffer_index_ids = NULL, *p_buffer_payloads = NULL;
+    uint32_t buffer_element_num = 0;
+    bool is_unknown = false;
+
+    // The sorted tree elements sharing the prefix are adjacent.
+    for (uint32_t i = 1; (i < result_length) && (is_unknown == false); i++)
+    {
+        is_unknown = Index_Id_Type_Is_String_Order_Unknown(p_result_index_ids + (index_id_size * (i - 1)), p_result_index_ids + (index_id_size * i));
+    }
+
+    if ((is_unknown == false) && (get_index_write_buffer_length(p_index_info) > 0))
+    {
+        // The buffered elements are by insertion order, compare each of them with the other elements.
+        buffer_element_num = collect_index_write_buffer_elements(p_index_info, p_lower_index_id, p_upper_index_id, &p_buffer_index_ids, &p_buffer_payloads);
+        for (uint32_t i = 0; (i < buffer_element_num) && (is_unknown == false); i++)
+        {
+            uint8_t *p_buffer_index_id = p_buffer_index_ids + (index_id_size * i);
+
+            for (uint32_t j = i + 1; (j < buffer_element_num) && (is_unknown == false); j++)
+            {
+                is_unknown = Index_Id_Type_Is_String_Order_Unknown(p_buffer_index_id, p_buffer_index_ids + (index_id_size * j));
+            }
+            for (uint32_t j = 0; (j < result_length) && (is_unknown == false); j++)
+            {
+                is_unknown = Index_Id_Type_Is_String_Order_Unknown(p_buffer_index_id, p_result_index_ids + (index_id_size * j));
+            }
+        }
+        free(p_buffer_index_ids);
+        free(p_buffer_payloads);
+    }
+
+    return is_unknown;
+}
+
+// Copy the buffered elements whose index ids are in [lower, upper], NULL bound means unbounded.
+// return value: number of the copied elements, by insertion order.
+uint32_t collect_index_write_buffer_elements(INDEX_INFO_T *p_index_info, void *p_lower_index_id, void *p_upper_index_id, uint8_t **pp_index_ids, uint8_t **pp_payloads)
+{
+    INDEX_NODE_CACHE_T *p_index_node_cache = &(p_index_info->index_node_cache);
+    INDEX_WRITE_BUFFER_T *p_index_write_buffer = &(p_index_info->index_write_buffer);
+    INDEX_ID_TYPE_E index_id_type = p_index_info->index_properties.index_id_type;
+    uint32_t index_id_size = Index_Id_Type_Get_Size(index_id_type);
+    uint32_t element_num = 0;
+
+    *pp_index_ids = NULL;
+    *pp_payloads = NULL;
+
+    lock_index_node_cache(p_index_node_cache);
+
+    if (p_index_write_buffer->length > 0)
+    {
+        *pp_index_ids = malloc((size_t)p_index_write_buffer->length * index_id_size);
+        *pp_payloads = malloc((size_t)p_index_write_buffer->length * INDEX_PAYLOAD_SIZE);
+    }
+
+    for (uint32_t i = 0; (*pp_index_ids != NULL) && (*pp_payloads != NULL) && (i < p_index_write_buffer->length); i++)
+    {
+        void *p_index_id = p_index_write_buffer->p_index_ids + (index_id_size * i);
+
+        if (((p_lower_index_id != NULL) && (Index_Id_Type_Compare(index_id_type, p_index_id, p_lower_index_id) == INDEX_ID_COMPARE_RIGHT_GREATER)) ||
+            ((p_upper_index_id != NULL) && (Index_Id_Type_Compare(index_id_type, p_index_id, p_upper_index_id) == INDEX_ID_COMPARE_LEFT_GREATER)))
+        {
+            continue;
+        }
+
+        memcpy(*pp_index_ids + (index_id_size * element_num), p_index_id, index_id_size);
+        memcpy(*pp_payloads + (INDEX_PAYLOAD_SIZE * element_num), p_index_write_buffer->p_payloads + (INDEX_PAYLOAD_SIZE * i), INDEX_PAYLOAD_SIZE);
+        element_num++;
+    }
+
+    unlock_index_node_cache(p_index_node_cache);
+
+    return element_num;
+}
+
+// Append the payloads of the buffered elements equal to the target to the search result of the tree.
+// The buffered elements are inserted after the ones in the tree.
+uint8_t *search_index_write_buffer_equal(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_target_index_element, uint8_t *p_search_result, uint32_t *result_length)
+{
+    uint8_t *p_buffer_index_ids = NULL, *p_buffer_payloads = NULL, *p_new_search_result = NULL;
+    uint32_t buffer_element_num = collect_index_write_buffer_elements(p_index_info, p_target_index_element->p_index_id, p_target_index_element->p_index_id, &p_buffer_index_ids, &p_buffer_payloads);
+
+    if (buffer_element_num > 0)
+    {
+        p_new_search_result = realloc(p_search_result, ((size_t)(*result_length) + buffer_element_num) * INDEX_PAYLOAD_SIZE);
+        if (p_new_search_result != NULL)
+        {
+            memcpy(p_new_search_result + (INDEX_PAYLOAD_SIZE * (*result_length)), p_buffer_payloads, (size_t)buffer_element_num * INDEX_PAYLOAD_SIZE);
+            p_search_result = p_new_search_result;
+            *result_length += buffer_element_num;
+        }
+    }
+
+    free(p_buffer_index_ids);
+    free(p_buffer_payloads);
+
+    return p_search_result;
+}
+
+// Merge the payloads of the buffered elements in the range into the search result of the tree, whose index ids are p_search_result_index_ids.
+// The result is sorted by index id, the equal index ids are in insertion order.
+uint8_t *search_index_write_buffer_range(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_lower_index_element, void *p_upper_index_id, uint8_t *p_search_result, uint8_t *p_search_result_index_ids, uint32_t *result_length)
+{
+    INDEX_ID_TYPE_E index_id_type = p_index_info->index_properties.index_id_type;
+    uint32_t index_id_size = Index_Id_Type_Get_Size(index_id_type);
+    uint8_t *p_buffer_index_ids = NULL, *p_buffer_payloads = NULL, *p_merged_search_result = NULL;
+    uint32_t *p_positions = NULL;
+    uint32_t buffer_element_num = collect_index_write_buffer_elements(p_index_info, (p_lower_index_element != NULL) ? (p_lower_index_element->p_index_id) : (NULL), p_upper_index_id, &p_buffer_index_ids, &p_buffer_payloads);
+    uint32_t tree_position = 0, buffer_position = 0, merged_length = 0;
+
+    if (buffer_element_num > 0)
+    {
+        p_positions = malloc(sizeof(uint32_t) * buffer_element_num);
+        p_merged_search_result = malloc(((size_t)(*result_length) + buffer_element_num) * INDEX_PAYLOAD_SIZE);
+    }
+
+    if ((p_positions == NULL) || (p_merged_search_result == NULL))
+    {
+        // No buffered element in the range or allocate memory error.
+        // Error handling: return the search result of the tree.
+        free(p_positions);
+        free(p_merged_search_result);
+        free(p_buffer_index_ids);
+        free(p_buffer_payloads);
+        return p_search_result;
+    }
+
+    for (uint32_t i = 0; i < buffer_element_num; i++)
+    {
+        p_positions[i] = i;
+    }
+    sort_index_element_positions(p_positions, buffer_element_num, p_buffer_index_ids, index_id_type);
+
+    while (buffer_position < buffer_element_num)
+    {
+        uint8_t *p_buffer_index_id = p_buffer_index_ids + (index_id_size * p_positions[buffer_position]);
+        uint32_t run_end = buffer_position + 1;
+
+        // The tree elements equal to the buffered ones are inserted earlier.
+        while ((tree_position < *result_length) && (Index_Id_Type_Compare(index_id_type, p_search_result_index_ids + (index_id_size * tree_position), p_buffer_index_id) != INDEX_ID_COMPARE_LEFT_GREATER))
+        {
+            memcpy(p_merged_search_result + (INDEX_PAYLOAD_SIZE * merged_length), p_search_result + (INDEX_PAYLOAD_SIZE * tree_position), INDEX_PAYLOAD_SIZE);
+            merged_length++;
+            tree_position++;
+        }
+
+        // sort_index_element_positions() puts the equal index ids in reverse input order, copy each run of them backward.
+        while ((run_end < buffer_element_num) && (Index_Id_Type_Compare(index_id_type, p_buffer_index_ids + (index_id_size * p_positions[run_end]), p_buffer_index_id) == INDEX_ID_COMPARE_EQUAL))
+        {
+            run_end++;
+        }
+        for (uint32_t i = run_end; i > buffer_position; i--)
+        {
+            memcpy(p_merged_search_result + (INDEX_PAYLOAD_SIZE * merged_length), p_buffer_payloads + (INDEX_PAYLOAD_SIZE * p_positions[i - 1]), INDEX_PAYLOAD_SIZE);
+            merged_length++;
+        }
+        buffer_position = run_end;
+    }
+
+    if (tree_position < *result_length)
+    {
+        memcpy(p_merged_search_result + (INDEX_PAYLOAD_SIZE * merged_length), p_search_result + (INDEX_PAYLOAD_SIZE * tree_position), (size_t)(*result_length - tree_position) * INDEX_PAYLOAD_SIZE);
+        merged_length += *result_length - tree_position;
+    }
+
+    free(p_positions);
+    free(p_buffer_index_ids);
+    free(p_buffer_payloads);
+    free(p_search_result);
+
+    *result_length = merged_length;
+    return p_merged_search_result;
+}
+
+void index_element_init(INDEX_ELEMENT_T *p_index_element)
+{
+    p_index_element->p_index_id = NULL;
+    memset(p_index_element->index_payload, 0, INDEX_PAYLOAD_SIZE);
+}
+
+void setup_index_element(INDEX_ELEMENT_T *p_index_element, void *p_index_id, INDEX_ID_TYPE_E index_id_type, void *p_payload, uint32_t payload_size)
+{
+    uint32_t index_id_size = Index_Id_Type_Get_Size(index_id_type);
+    payload_size = (payload_size > INDEX_PAYLOAD_SIZE) ? INDEX_PAYLOAD_SIZE : payload_size;
+    allocate_index_element_resources(p_index_element, index_id_size);
+
+    // index_id
+    memcpy(p_index_element->p_index_id, p_index_id, index_id_size);
+    // payload
+    // clear the existed data first.
+    memset(p_index_element->index_payload, 0, INDEX_PAYLOAD_SIZE);
+    if (payload_size > 0 && p_payload != NULL)
+    {
+        memcpy(p_index_element->index_payload, p_payload, payload_size);
+    }
+}
+
+void allocate_index_element_resources(INDEX_ELEMENT_T *p_index_element, uint32_t index_id_size)
+{
+    if (p_index_element->p_index_id)
+    {
+        free_index_element_resources(p_index_element);
+    }
+
+    p_index_element->p_index_id = calloc(1, index_id_size);
+}
+
+void free_index_element_resources(INDEX_ELEMENT_T *p_index_element)
+{
+    if (p_index_element->p_index_id != NULL)
+    {
+        free(p_index_element->p_index_id);
+        p_index_element->p_index_id = NULL;
+    }
+}
+
+static inline void *get_index_node_index_id(INDEX_NODE_T *p_index_node, uint32_t position)
+{
+    return p_index_node->p_index_ids + (position * p_index_node->index_id_size);
+}
+
+// Return NULL if the node stores the separator index ids only.
+static inline uint8_t *get_index_node_payload(INDEX_NODE_T *p_index_node, uint32_t position)
+{
+    return (p_index_node->p_payloads != NULL) ? (p_index_node->p_payloads + (position * INDEX_PAYLOAD_SIZE)) : (NULL);
+}
+
+// Copy the index id and payload into the [position] element of the node.
+// The payload is ignored by the separator nodes.
+void set_index_node_element(INDEX_NODE_T *p_index_node, uint32_t position, void *p_index_id, void *p_payload, uint32_t payload_size)
+{
+    uint8_t *p_node_payload = get_index_node_payload(p_index_node, position);
+    payload_size = (payload_size > INDEX_PAYLOAD_SIZE) ? INDEX_PAYLOAD_SIZE : payload_size;
+
+    memcpy(get_index_node_index_id(p_index_node, position), p_index_id, p_index_node->index_id_size);
+    if (p_node_payload == NULL)
+    {
+        return;
+    }
+    // clear the existed data first.
+    memset(p_node_payload, 0, INDEX_PAYLOAD_SIZE);
+    if (payload_size > 0 && p_payload != NULL)
+    {
+        memcpy(p_node_payload, p_payload, payload_size);
+    }
+}
+
+// Return true if length elements fit in the node, their index ids share prefix_size leading bytes and end before end_size bytes.
+// An uncompressed node fits its order of elements whatever the index ids are.
+static inline bool is_index_node_fit(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node, uint32_t length, uint32_t prefix_size, uint32_t end_size)
+{
+    if (length > p_index_node->order)
+    {
+        return false;
+    }
+    if (is_index_node_compressed(&(p_index_info->index_properties), p_index_node->level) == false)
+    {
+        return true;
+    }
+
+    return get_index_node_compressed_size(length, prefix_size, end_size, (p_index_node->p_payloads != NULL)) <= p_index_node->node_size;
+}
+
+// Return true if the node can take the index id as a new element, or as the [replace_position] element (UINT32_MAX: a new element).
+bool is_index_node_fit_with_index_id(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node, void *p_index_id, uint32_t replace_position)
+{
+    uint32_t index_id_size = p_index_node->index_id_size;
+    uint32_t length = p_index_node->length + ((replace_position == UINT32_MAX) ? (1) : (0));
+    uint32_t prefix_size = index_id_size, end_size = 0;
+
+    if (length > p_index_node->order)
+    {
+        return false;
+    }
+    // Skip the bounds if the elements fit without any shared bytes.
+    if (is_index_node_fit(p_index_info, p_index_node, length, 0, index_id_size))
+    {
+        return true;
+    }
+
+    add_index_id_bounds(index_id_size, p_index_id, p_index_id, &prefix_size, &end_size);
+    get_index_node_index_id_bounds(p_index_node, replace_position, p_index_id, &prefix_size, &end_size);
+
+    return is_index_node_fit(p_index_info, p_index_node, length, prefix_size, end_size);
+}
+
+// Return true if the elements of the node and its right sibling fit in the node, with the separator between them if it's not NULL.
+bool is_index_node_merge_fit(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node, INDEX_NODE_T *p_right_node, void *p_separator_index_id)
+{
+    uint32_t index_id_size = p_index_node->index_id_size;
+    uint32_t length = p_index_node->length + p_right_node->length + ((p_separator_index_id != NULL) ? (1) : (0));
+    uint32_t prefix_size = index_id_size, end_size = 0;
+    uint8_t *p_first_index_id = (p_index_node->length > 0) ? (p_index_node->p_index_ids) : (p_right_node->p_index_ids);
+
+    if (length > p_index_node->order)
+    {
+        return false;
+    }
+    if (is_index_node_fit(p_index_info, p_index_node, length, 0, index_id_size))
+    {
+        return true;
+    }
+
+    if (p_separator_index_id != NULL)
+    {
+        p_first_index_id = p_separator_index_id;
+        add_index_id_bounds(index_id_size, p_first_index_id, p_separator_index_id, &prefix_size, &end_size);
+    }
+    get_index_node_index_id_bounds(p_index_node, UINT32_MAX, p_first_index_id, &prefix_size, &end_size);
+    get_index_node_index_id_bounds(p_right_node, UINT32_MAX, p_first_index_id, &prefix_size, &end_size);
+
+    return is_index_node_fit(p_index_info, p_index_node, length, prefix_size, end_size);
+}
+
+// Return true if an insertion below the node can't split it, any new index id fits in it.
+static inline bool is_index_node_insertion_safe(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node)
+{
+    return is_index_node_fit(p_index_info, p_index_node, p_index_node->length + 1, 0, p_index_node->index_id_size);
+}
+
+// Find the array position in the node where the new element should insert into.
+// Return the minimum element position where the value is equal or greater than the inputed value.
+uint32_t find_element_position_in_the_node(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node, INDEX_ELEMENT_T *p_index_element)
+{
+    // The index ids are stored contiguously in the node image, search them with the type specialized function.
+    uint32_t position = p_index_info->lower_bound_function(p_index_node->p_index_ids, p_index_node->length, p_index_element->p_index_id);
+
+    assert(position <= p_index_node->length);
+    return position;
+}
+
+void split_index_elements_into_two_index_node(uint8_t *p_index_ids_buffer, uint8_t *p_payloads_buffer, uint32_t buffer_length, INDEX_NODE_T *p_index_node_current, INDEX_NODE_T *p_index_node_sibling)
+{
+    uint32_t order = p_index_node_current->order;
+    uint32_t index_id_size = p_index_node_current->index_id_size;
+    assert(buffer_length <= (2 * order));
+
+    uint32_t start_position, copy_length;
+    bool is_leaf_node = (p_index_node_current->child_tag[0] == 0) ? true : false;
+
+    // Copy first half of index elements into current node.
+    start_position = 0;
+    copy_length = buffer_length / 2;
+    memcpy(p_index_node_current->p_index_ids, p_index_ids_buffer, index_id_size * copy_length);
+    // Set the unused index elements into default value.
+    memset(get_index_node_index_id(p_index_node_current, copy_length), 0, index_id_size * (order - copy_length));
+    if (p_index_node_current->p_payloads != NULL)
+    {
+        memcpy(p_index_node_current->p_payloads, p_payloads_buffer, INDEX_PAYLOAD_SIZE * copy_length);
+        memset(get_index_node_payload(p_index_node_current, copy_length), 0, INDEX_PAYLOAD_SIZE * (order - copy_length));
+    }
+    p_index_node_current->length = copy_length;
+
+    // Copy second half of index elements into the sibling node.
+    if (is_leaf_node)
+    {
+        start_position = copy_length;
+        copy_length = buffer_length - copy_length;
+    }
+    else
+    {
+        // If current node and sibling node are not leaf nodes, it doesn't need to copy the [mid] element to sibling node.
+        // The [mid] element should be inserted to parent node.
+        start_position = copy_length + 1;
+        copy_length = buffer_length - copy_length - 1;
+    }
+    memcpy(p_index_node_sibling->p_index_ids, p_index_ids_buffer + (index_id_size * start_position), index_id_size * copy_length);
+    // Set unused elements into default value.
+    memset(get_index_node_index_id(p_index_node_sibling, copy_length), 0, index_id_size * (order - copy_length));
+    if (p_index_node_sibling->p_payloads != NULL)
+    {
+        memcpy(p_index_node_sibling->p_payloads, p_payloads_buffer + (INDEX_PAYLOAD_SIZE * start_position), INDEX_PAYLOAD_SIZE * copy_length);
+        memset(get_index_node_payload(p_index_node_sibling, copy_length), 0, INDEX_PAYLOAD_SIZE * (order - copy_length));
+    }
+    p_index_node_sibling->length = copy_length;
+}
+
+void split_child_tags_into_two_index_node(INDEX_INFO_T *p_index_info, uint32_t *p_child_tag_buffer, uint32_t child_tag_buffer_length, INDEX_NODE_T *p_index_node_current, INDEX_NODE_T *p_index_node_sibling)
+{
+    uint32_t first_half_length = (child_tag_buffer_length / 2) + (child_tag_buffer_length % 2);
+    uint32_t second_half_length = child_tag_buffer_length - first_half_length;
+    INDEX_NODE_T *p_second_half_child_index_node = NULL;
+
+    // Copy first half of child tags to current node.
+    memcpy(p_index_node_current->child_tag, p_child_tag_buffer, sizeof(uint32_t) * first_half_length);
+    memset(&(p_index_node_current->child_tag[first_half_length]), 0, sizeof(uint32_t) * (p_index_node_current->order + 1 - first_half_length));
+    // Copy second half of child tags to sibling node.
+    memcpy(p_index_node_sibling->child_tag, &(p_child_tag_buffer[first_half_length]), sizeof(uint32_t) * second_half_length);
+    // update the parent tag of the second half child nodes to sibling node tag.
+    for (uint32_t i = 0; i < second_half_length; i++)
+    {
+        p_second_half_child_index_node = fetch_index_node(p_index_info, p_index_node_sibling->child_tag[i]);
+        p_second_half_child_index_node->parent_tag = p_index_node_sibling->tag;
+        mark_index_node_dirty(p_index_info, p_second_half_child_index_node);
+        release_index_node(p_index_info, p_second_half_child_index_node);
+    }
+}
+
+// Return the position of child_tag in the child_tag array of the node.
+uint32_t find_child_tag_position_in_the_node(INDEX_NODE_T *p_index_node, uint32_t child_tag)
+{
+    uint32_t position = 0;
+
+    while ((position <= p_index_node->length) && (p_index_node->child_tag[position] != child_tag))
+    {
+        position++;
+    }
+    assert(position <= p_index_node->length);
+
+    return position;
+}
+
+// Insert the element into the leaf node of the path.
+// A full node is split and its [mid] element is inserted into the parent node on the path, up to a new root node.
+// A compressed node is full if its image can't take the element, the separator of a split leaf node is truncated.
+// The nodes on the path are latched exclusively, the new sibling nodes are reachable after the path is released.
+// split_child_tags_into_two_index_node() updates parent_tag of the moved children without latching them, readers don't use parent_tag.
+void insert_index_element_handler(INDEX_INFO_T *p_index_info, INDEX_PATH_T *p_index_path, INDEX_ELEMENT_T *p_index_element)
+{
+    INDEX_PROPERTIES_T *p_index_properties = &(p_index_info->index_properties);
+    INDEX_ELEMENT_T current_index_element = *p_index_element;
+    // The [mid] element of a split is kept here while it's inserted into the parent node.
+    uint64_t mid_index_id_buffer[(INDEX_ID_MAX_SIZE + sizeof(uint64_t) - 1) / sizeof(uint64_t)]; // aligned for any index id type
+    // split_child_tag: the child node which is split into split_child_tag and new_child_tag, 0 if inserting into a leaf node.
+    uint32_t split_child_tag = 0, new_child_tag = 0;
+    uint32_t depth = p_index_path->depth;
+
+    assert(depth > 0);
+    assert(Index_Id_Type_Get_Size(p_index_properties->index_id_type) <= sizeof(mid_index_id_buffer));
+
+    while (depth > 0)
+    {
+        INDEX_NODE_T *p_index_node = p_index_path->p_index_nodes[depth - 1];
+        uint32_t order = p_index_node->order, length = p_index_node->length;
+        uint32_t position = 0, tag_position = 0;
+
+        if (split_child_tag == 0)
+        {
+            position = find_element_position_in_the_node(p_index_info, p_index_node, &current_index_element);
+        }
+        else
+        {
+            // The new child must be next to the split child, the position can't be decided by the duplicated index ids.
+            // The split child was reached from the position of the path.
+            position = p_index_path->positions[depth - 1];
+            assert(p_index_node->child_tag[position] == split_child_tag);
+        }
+        tag_position = position + 1;
+
+        if (is_index_node_fit_with_index_id(p_index_info, p_index_node, current_index_element.p_index_id, UINT32_MAX))
+        {
+            // index_node isn't full
+            // insertion sort
+            insert_element_into_index_node(p_index_node, position, current_index_element.p_index_id, current_index_element.index_payload, tag_position, new_child_tag);
+
+            mark_index_node_dirty(p_index_info, p_index_node);
+            break;
+        }
+
+        // index node is full.
+        // split current node into two nodes and insert the [(length + 1) / 2] element to the parent node.
+        INDEX_NODE_T *p_new_sibling_node = NULL;
+        uint32_t index_id_size = p_index_node->index_id_size;
+        // uint64_t array keeps the buffer aligned for 64-bit index ids.
+        uint64_t index_ids_buffer[(((length + 1) * index_id_size) + sizeof(uint64_t) - 1) / sizeof(uint64_t)];
+        uint8_t *p_index_ids_buffer = (uint8_t *)index_ids_buffer;
+        uint8_t payloads_buffer[(length + 1) * INDEX_PAYLOAD_SIZE];
+        uint32_t child_tags_buffer[length + 2];
+        uint32_t mid_position = (length + 1) / 2;
+        bool is_leaf_node = (p_index_node->child_tag[0] == 0) ? true : false;
+        // The separator nodes have no payloads, payloads_buffer is left unused.
+        bool has_payloads = (p_index_node->p_payloads != NULL) ? true : false;
+
+        // init buffers
+        for (uint32_t i = 0; i < length + 2; i++)
+        {
+            child_tags_buffer[i] = 0;
+        }
+
+        // insert the current node and the new element into buffer by order.
+        if (position > 0)
+        {
+            memcpy(p_index_ids_buffer, p_index_node->p_index_ids, index_id_size * position);
+        }
+        memcpy(p_index_ids_buffer + (index_id_size * position), current_index_element.p_index_id, index_id_size);
+        if (position < length)
+        {
+            memcpy(p_index_ids_buffer + (index_id_size * (position + 1)), get_index_node_index_id(p_index_node, position), index_id_size * (length - position));
+        }
+        if (has_payloads)
+        {
+            memcpy(payloads_buffer, p_index_node->p_payloads, INDEX_PAYLOAD_SIZE * position);
+            memcpy(payloads_buffer + (INDEX_PAYLOAD_SIZE * position), current_index_element.index_payload, INDEX_PAYLOAD_SIZE);
+            memcpy(payloads_buffer + (INDEX_PAYLOAD_SIZE * (position + 1)), get_index_node_payload(p_index_node, position), INDEX_PAYLOAD_SIZE * (length - position));
+        }
+
+        // Insert the current child tags and new_child_tag into buffer by order.
+        // new_child_tag is the child tag that greater than the inputted element.
+        if (tag_position > 0)
+        {
+            memcpy(child_tags_buffer, &(p_index_node->child_tag[0]), sizeof(uint32_t) * tag_position);
+        }
+        child_tags_buffer[tag_position] = new_child_tag;
+        if (tag_position < length + 1)
+        {
+            memcpy(&(child_tags_buffer[tag_position + 1]), &(p_index_node->child_tag[tag_position]), sizeof(uint32_t) * (length + 1 - tag_position));
+        }
+
+        // Create and initialize the sibling Node
+        p_new_sibling_node = create_index_node(p_index_info);
+        set_index_node_level(p_new_sibling_node, p_index_node->level, p_index_properties);
+        p_new_sibling_node->parent_tag = p_index_node->parent_tag;
+        p_new_sibling_node->next_tag = p_index_node->next_tag;
+        p_index_node->next_tag = p_new_sibling_node->tag;
+
+        // Insert first half of the elements in the buffer into current node and insert the second half of the elements into sibling node.
+        // If the current node is a leaf node, copy the [mid] element to new sibling node to keep it in the leaf.
+        // If current node is not a leaf node, we don't have to keep it in any node in the current node level.
+        split_index_elements_into_two_index_node(p_index_ids_buffer, payloads_buffer, length + 1, p_index_node, p_new_sibling_node);
+        if (is_leaf_node == false)
+        {
+            split_child_tags_into_two_index_node(p_index_info, child_tags_buffer, length + 2, p_index_node, p_new_sibling_node);
+        }
+        else
+        {
+            // The posting tags are moved with the leaf elements, child_tag[0] of the leaf nodes stays 0.
+            memcpy(&(p_index_node->child_tag[1]), &(child_tags_buffer[1]), sizeof(uint32_t) * mid_position);
+            memset(&(p_index_node->child_tag[mid_position + 1]), 0, sizeof(uint32_t) * (order - mid_position));
+            memcpy(&(p_new_sibling_node->child_tag[1]), &(child_tags_buffer[mid_position + 1]), sizeof(uint32_t) * (length + 1 - mid_position));
+        }
+
+        // The [mid] element is inserted into the parent node in the next round, copy it out of the buffers of this round.
+        // The separator of compressed leaf nodes is truncated after the first byte differing from the last element of the current node.
+        if (is_leaf_node && is_index_node_compressed(p_index_properties, p_index_node->level))
+        {
+            Index_Id_Type_Set_Separator(p_index_properties->index_id_type, mid_index_id_buffer, p_index_ids_buffer + (index_id_size * (mid_position - 1)), p_index_ids_buffer + (index_id_size * mid_position));
+        }
+        else
+        {
+            memcpy(mid_index_id_buffer, p_index_ids_buffer + (index_id_size * mid_position), index_id_size);
+        }
+        if (has_payloads)
+        {
+            memcpy(current_index_element.index_payload, payloads_buffer + (INDEX_PAYLOAD_SIZE * mid_position), INDEX_PAYLOAD_SIZE);
+        }
+        current_index_element.p_index_id = mid_index_id_buffer;
+        split_child_tag = p_index_node->tag;
+        new_child_tag = p_new_sibling_node->tag;
+
+        if (depth == 1)
+        {
+            // Only the root node is kept on the path while it's full, the root latch is still held.
+            // The root node is split, create a new root node holding the two nodes and the [mid] element.
+            INDEX_NODE_T *p_root_node = create_index_node(p_index_info);
+
+            assert(p_index_path->is_root_latched && (p_index_node->tag == p_index_properties->root_tag));
+            p_root_node->child_tag[0] = split_child_tag;
+            set_index_node_level(p_root_node, p_index_node->level + 1, p_index_properties);
+            insert_element_into_index_node(p_root_node, 0, current_index_element.p_index_id, current_index_element.index_payload, 1, new_child_tag);
+            set_index_root_tag(p_index_info, p_root_node->tag);
+
+            p_index_node->parent_tag = p_root_node->tag;
+            p_new_sibling_node->parent_tag = p_root_node->tag;
+            release_index_node(p_index_info, p_root_node);
+        }
+
+        // The sibling and root nodes are created as dirty, current node and index properties are written back by flush_index_node_cache().
+        mark_index_node_dirty(p_index_info, p_index_node);
+        mark_index_properties_dirty(p_index_info);
+        release_index_node(p_index_info, p_new_sibling_node);
+
+        depth--;
+    }
+}
+
+// Insert the element at position and the child tag at tag_position, the node should not be full.
+// The elements (and child tags) behind them are moved to the next position in the arrays.
+void insert_element_into_index_node(INDEX_NODE_T *p_index_node, uint32_t position, void *p_index_id, void *p_payload, uint32_t tag_position, uint32_t child_tag)
+{
+    uint32_t move_length = p_index_node->length - position;
+    uint32_t tag_move_length = p_index_node->length + 1 - tag_position;
+
+    assert((p_index_node->length < p_index_node->order) && (position <= p_index_node->length) && (tag_position <= p_index_node->length + 1));
+
+    memmove(get_index_node_index_id(p_index_node, position + 1), get_index_node_index_id(p_index_node, position), p_index_node->index_id_size * move_length);
+    if (p_index_node->p_payloads != NULL)
+    {
+        memmove(get_index_node_payload(p_index_node, position + 1), get_index_node_payload(p_index_node, position), INDEX_PAYLOAD_SIZE * move_length);
+    }
+    memmove(&(p_index_node->child_tag[tag_position + 1]), &(p_index_node->child_tag[tag_position]), sizeof(uint32_t) * tag_move_length);
+
+    set_index_node_element(p_index_node, position, p_index_id, p_payload, INDEX_PAYLOAD_SIZE);
+    p_index_node->child_tag[tag_position] = child_tag;
+    p_index_node->length++;
+}
+
+// Remove the element at position and the child tag at tag_position.
+// The elements (and child tags) behind them are moved to the previous position in the arrays.
+void remove_element_from_index_node(INDEX_NODE_T *p_index_node, uint32_t position, uint32_t tag_position)
+{
+    uint32_t move_length = p_index_node->length - position - 1;
+    uint32_t tag_move_length = p_index_node->length - tag_position;
+
+    assert((position < p_index_node->length) && (tag_position <= p_index_node->length));
+
+    memmove(get_index_node_index_id(p_index_node, position), get_index_node_index_id(p_index_node, position + 1), p_index_node->index_id_size * move_length);
+    if (p_index_node->p_payloads != NULL)
+    {
+        memmove(get_index_node_payload(p_index_node, position), get_index_node_payload(p_index_node, position + 1), INDEX_PAYLOAD_SIZE * move_length);
+    }
+    memmove(&(p_index_node->child_tag[tag_position]), &(p_index_node->child_tag[tag_position + 1]), sizeof(uint32_t) * tag_move_length);
+    p_index_node->length--;
+
+    // Set the unused element and child tag into default value.
+    memset(get_index_node_index_id(p_index_node, p_index_node->length), 0, p_index_node->index_id_size);
+    if (p_index_node->p_payloads != NULL)
+    {
+        memset(get_index_node_payload(p_index_node, p_index_node->length), 0, INDEX_PAYLOAD_SIZE);
+    }
+    p_index_node->child_tag[p_index_node->length + 1] = 0;
+}
+
+static inline void latch_index_node(INDEX_NODE_T *p_index_node, bool is_exclusive)
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_rwlock_t *p_latch = &(((INDEX_NODE_CACHE_ENTRY_T *)p_index_node)->latch);
+
+    if (is_exclusive)
+    {
+        pthread_rwlock_wrlock(p_latch);
+    }
+    else
+    {
+        pthread_rwlock_rdlock(p_latch);
+    }
+#endif
+}
+
+static inline void unlatch_index_node(INDEX_NODE_T *p_index_node)
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_rwlock_unlock(&(((INDEX_NODE_CACHE_ENTRY_T *)p_index_node)->latch));
+#endif
+}
+
+// Return the pinned and latched node, call unlatch_and_release_index_node() after using the node.
+INDEX_NODE_T *fetch_and_latch_index_node(INDEX_INFO_T *p_index_info, uint32_t tag, bool is_exclusive)
+{
+    INDEX_NODE_T *p_index_node = fetch_index_node(p_index_info, tag);
+
+    if (p_index_node != NULL)
+    {
+        latch_index_node(p_index_node, is_exclusive);
+    }
+
+    return p_index_node;
+}
+
+void unlatch_and_release_index_node(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node)
+{
+    unlatch_index_node(p_index_node);
+    release_index_node(p_index_info, p_index_node);
+}
+
+static inline void latch_index_root(INDEX_INFO_T *p_index_info, bool is_exclusive)
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_rwlock_t *p_root_latch = &(p_index_info->index_node_cache.root_latch);
+
+    if (is_exclusive)
+    {
+        pthread_rwlock_wrlock(p_root_latch);
+    }
+    else
+    {
+        pthread_rwlock_rdlock(p_root_latch);
+    }
+#endif
+}
+
+static inline void unlatch_index_root(INDEX_INFO_T *p_index_info)
+{
+#if IS_POSIX_API_SUPPORT
+    pthread_rwlock_unlock(&(p_index_info->index_node_cache.root_latch));
+#endif
+}
+
+// The root latch is held exclusively by the writer, root_tag is also read by the cache eviction with the cache locked.
+void set_index_root_tag(INDEX_INFO_T *p_index_info, uint32_t root_tag)
+{
+    INDEX_NODE_CACHE_T *p_index_node_cache = &(p_index_info->index_node_cache);
+
+    lock_index_node_cache(p_index_node_cache);
+    p_index_info->index_properties.root_tag = root_tag;
+    unlock_index_node_cache(p_index_node_cache);
+}
+
+void index_path_init(INDEX_PATH_T *p_index_path, bool is_exclusive)
+{
+    p_index_path->is_exclusive = is_exclusive;
+    p_index_path->is_root_latched = false;
+    p_index_path->depth = 0;
+}
+
+// Descend from the root node to the leaf node where the element should be (or the left most leaf node if the element is NULL),
+// the visited nodes and their child positions are pushed to the path.
+// Latch crabbing: the root latch and the node latches are acquired from top to bottom, a child is latched before its parent is released.
+// A reader keeps the current node only. The writer keeps the full nodes above the current node, which are split if the insertion splits their child.
+// Return false if a node can't be read, the pushed nodes should be released by release_index_path() anyway.
+bool descend_index_path(INDEX_INFO_T *p_index_info, INDEX_PATH_T *p_index_path, INDEX_ELEMENT_T *p_index_element)
+{
+    uint32_t tag = 0;
+
+    latch_index_root(p_index_info, p_index_path->is_exclusive);
+    p_index_path->is_root_latched = true;
+    tag = p_index_info->index_properties.root_tag;
+
+    while (true)
+    {
+        INDEX_NODE_T *p_index_node = fetch_and_latch_index_node(p_index_info, tag, p_index_path->is_exclusive);
+        uint32_t position = 0;
+
+        if (p_index_node == NULL)
+        {
+            return false;
+        }
+
+        assert(p_index_path->depth < INDEX_PATH_MAX_DEPTH);
+        p_index_path->p_index_nodes[p_index_path->depth] = p_index_node;
+        p_index_path->positions[p_index_path->depth] = 0;
+        p_index_path->depth++;
+
+        if ((p_index_path->is_exclusive == false) || is_index_node_insertion_safe(p_index_info, p_index_node))
+        {
+            // The insertion can't split the nodes above a node which isn't full.
+            release_index_path_ancestors(p_index_info, p_index_path);
+        }
+
+        // Check if the leaf node existed or not by child_tag[0].
+        if (p_index_node->child_tag[0] == 0)
+        {
+            return true;
+        }
+
+        // Position is in the range of [0, index_node.length].
+        position = (p_index_element != NULL) ? find_element_position_in_the_node(p_index_info, p_index_node, p_index_element) : (0);
+        p_index_path->positions[p_index_path->depth - 1] = position;
+        tag = p_index_node->child_tag[position];
+    }
+}
+
+// Release the root latch and the nodes above the last node of the path.
+void release_index_path_ancestors(INDEX_INFO_T *p_index_info, INDEX_PATH_T *p_index_path)
+{
+    uint32_t last = p_index_path->depth - 1;
+
+    if (p_index_path->is_root_latched)
+    {
+        unlatch_index_root(p_index_info);
+        p_index_path->is_root_latched = false;
+    }
+
+    for (uint32_t i = 0; i < last; i++)
+    {
+        unlatch_and_release_index_node(p_index_info, p_index_path->p_index_nodes[i]);
+    }
+
+    p_index_path->p_index_nodes[0] = p_index_path->p_index_nodes[last];
+    p_index_path->positions[0] = p_index_path->positions[last];
+    p_index_path->depth = 1;
+}
+
+// Release the nodes of the path from the leaf node to the root node, then the root latch.
+void release_index_path(INDEX_INFO_T *p_index_info, INDEX_PATH_T *p_index_path)
+{
+    while (p_index_path->depth > 0)
+    {
+        p_index_path->depth--;
+        unlatch_and_release_index_node(p_index_info, p_index_path->p_index_nodes[p_index_path->depth]);
+    }
+
+    if (p_index_path->is_root_latched)
+    {
+        unlatch_index_root(p_index_info);
+        p_index_path->is_root_latched = false;
+    }
+}
+
+void insert_index_element(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_index_element)
+{
+    INDEX_PATH_T index_path;
+
+    index_path_init(&index_path, true);
+    if (descend_index_path(p_index_info, &index_path, p_index_element) &&
+        (insert_index_element_into_posting_list(p_index_info, index_path.p_index_nodes[index_path.depth - 1], p_index_element) == false))
+    {
+        insert_index_element_handler(p_index_info, &index_path, p_index_element);
+    }
+    release_index_path(p_index_info, &index_path);
+}
+
+void *search_index_element(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_target_index_element, uint32_t *result_length)
+{
+    INDEX_PATH_T index_path;
+    void *p_search_result = NULL;
+
+    *result_length = 0;
+
+    index_path_init(&index_path, false);
+    if (descend_index_path(p_index_info, &index_path, p_target_index_element))
+    {
+        p_search_result = search_index_element_handler(p_index_info, index_path.p_index_nodes[index_path.depth - 1], p_target_index_element, result_length);
+    }
+    release_index_path(p_index_info, &index_path);
+
+    return p_search_result;
+}
+
+// Collect the payloads of the elements which are equal to the target from the latched leaf node and its next leaf nodes.
+// The next leaf nodes are visited iteratively, each one is latched before the previous one is released.
+uint8_t *search_index_element_handler(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node, INDEX_ELEMENT_T *p_target_index_element, uint32_t *result_length)
+{
+    uint8_t *p_search_result = NULL;
+    INDEX_ID_TYPE_E index_id_type = p_index_info->index_properties.index_id_type;
+    uint32_t position = find_element_position_in_the_node(p_index_info, p_index_node, p_target_index_element);
+    uint32_t compare_equal_length = 0, search_result_buffer_length = 0;
+    INDEX_NODE_T *p_current_index_node = p_index_node;
+    bool is_searching = true;
+
+    while (is_searching)
+    {
+        uint32_t i = 0;
+
+        for (i = position; i < p_current_index_node->length; i++)
+        {
+            uint8_t *p_payloads = get_index_node_payload(p_current_index_node, i), *p_posting_payloads = NULL;
+            uint32_t payload_num = 1;
+
+            if (Index_Id_Type_Compare(index_id_type, p_target_index_element->p_index_id, get_index_node_index_id(p_current_index_node, i)) != INDEX_ID_COMPARE_EQUAL)
+            {
+                break;
+            }
+
+            if (get_index_node_posting_tag(p_current_index_node, i) != 0)
+            {
+                p_posting_payloads = read_index_posting_list(p_index_info, get_index_node_posting_tag(p_current_index_node, i), &payload_num);
+                p_payloads = p_posting_payloads;
+            }
+
+            if (compare_equal_length + payload_num > search_result_buffer_length)
+            {
+                uint32_t new_buffer_length = (search_result_buffer_length == 0) ? (p_current_index_node->length) : (search_result_buffer_length * 2);
+                uint8_t *p_new_search_result = NULL;
+
+                new_buffer_length = (new_buffer_length < compare_equal_length + payload_num) ? (compare_equal_length + payload_num) : (new_buffer_length);
+                p_new_search_result = realloc(p_search_result, new_buffer_length * INDEX_PAYLOAD_SIZE);
+                if (p_new_search_result == NULL)
+                {
+                    // allocate more memory error.
+                    // Error handling: return the collected results.
+                    free(p_posting_payloads);
+                    is_searching = false;
+                    break;
+                }
+                p_search_result = p_new_search_result;
+                search_result_buffer_length = new_buffer_length;
+            }
+
+            // The posting list is newest first, same as the equal elements.
+            if (payload_num > 0)
+            {
+                memcpy(p_search_result + (INDEX_PAYLOAD_SIZE * compare_equal_length), p_payloads, (size_t)payload_num * INDEX_PAYLOAD_SIZE);
+            }
+            compare_equal_length += payload_num;
+            free(p_posting_payloads);
+        }
+
+        // The target may also existed in the next node if the right most element is equal to the target.
+        uint32_t next_tag = (is_searching && (i == p_current_index_node->length)) ? (p_current_index_node->next_tag) : (0);
+        INDEX_NODE_T *p_next_index_node = (next_tag != 0) ? fetch_and_latch_index_node(p_index_info, next_tag, false) : NULL;
+        if (p_current_index_node != p_index_node)
+        {
+            unlatch_and_release_index_node(p_index_info, p_current_index_node);
+        }
+
+        p_current_index_node = p_next_index_node;
+        // Stop if next node doesn't exist or read error.
+        is_searching = (p_current_index_node != NULL);
+        position = 0;
+    }
+
+    // Equal elements are inserted before the existed ones, reverse the result to return them by insertion order.
+    reverse_index_payloads(p_search_result, 0, compare_equal_length);
+
+    *result_length = compare_equal_length;
+    return p_search_result;
+}
+
+// Descend to the leaf node containing the lower bound (or the left most leaf node), then collect the payloads along the leaf nodes
+// until the index id is greater than the upper bound.
+// The index ids of the payloads are also collected into *pp_result_index_ids if it's not NULL.
+uint8_t *search_index_range(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_lower_index_element, void *p_upper_index_id, uint8_t **pp_result_index_ids, uint32_t *result_length)
+{
+    uint8_t *p_search_result = NULL, *p_search_result_index_ids = NULL;
+    INDEX_ID_TYPE_E index_id_type = p_index_info->index_properties.index_id_type;
+    uint32_t index_id_size = Index_Id_Type_Get_Size(index_id_type);
+    INDEX_PATH_T index_path;
+    INDEX_NODE_T *p_index_node = NULL;
+    uint32_t position = 0, search_result_length = 0, search_result_buffer_length = 0, equal_start = 0;
+    void *p_previous_index_id = NULL;
+    uint64_t previous_index_id_buffer[(INDEX_ID_MAX_SIZE + sizeof(uint64_t) - 1) / sizeof(uint64_t)]; // aligned for any index id type
+    bool is_searching = true;
+
+    assert(index_id_size <= sizeof(previous_index_id_buffer));
+
+    index_path_init(&index_path, false);
+    if (descend_index_path(p_index_info, &index_path, p_lower_index_element))
+    {
+        p_index_node = index_path.p_index_nodes[index_path.depth - 1];
+    }
+
+    position = ((p_index_node != NULL) && (p_lower_index_element != NULL)) ? find_element_position_in_the_node(p_index_info, p_index_node, p_lower_index_element) : (0);
+    while (is_searching && (p_index_node != NULL))
+    {
+        INDEX_NODE_T *p_next_index_node = NULL;
+        uint32_t next_tag = 0;
+
+        for (uint32_t i = position; i < p_index_node->length; i++)
+        {
+            void *p_index_id = get_index_node_index_id(p_index_node, i);
+            uint8_t *p_payloads = get_index_node_payload(p_index_node, i), *p_posting_payloads = NULL;
+            uint32_t payload_num = 1;
+
+            if ((p_upper_index_id != NULL) && (Index_Id_Type_Compare(index_id_type, p_index_id, p_upper_index_id) == INDEX_ID_COMPARE_LEFT_GREATER))
+            {
+                is_searching = false;
+                break;
+            }
+
+            if (get_index_node_posting_tag(p_index_node, i) != 0)
+            {
+                p_posting_payloads = read_index_posting_list(p_index_info, get_index_node_posting_tag(p_index_node, i), &payload_num);
+                p_payloads = p_posting_payloads;
+            }
+
+            if (search_result_length + payload_num > search_result_buffer_length)
+            {
+                uint32_t new_buffer_length = (search_result_buffer_length == 0) ? (p_index_node->length) : (search_result_buffer_length * 2);
+                uint8_t *p_new_search_result = NULL;
+
+                new_buffer_length = (new_buffer_length < search_result_length + payload_num) ? (search_result_length + payload_num) : (new_buffer_length);
+                p_new_search_result = realloc(p_search_result, new_buffer_length * INDEX_PAYLOAD_SIZE);
+                if (p_new_search_result == NULL)
+                {
+                    // allocate more memory error.
+                    // Error handling: return the collected results.
+                    free(p_posting_payloads);
+                    is_searching = false;
+                    break;
+                }
+                p_search_result = p_new_search_result;
+
+                if (pp_result_index_ids != NULL)
+                {
+                    uint8_t *p_new_search_result_index_ids = realloc(p_search_result_index_ids, new_buffer_length * index_id_size);
+                    if (p_new_search_result_index_ids == NULL)
+                    {
+                        free(p_posting_payloads);
+                        is_searching = false;
+                        break;
+                    }
+                    p_search_result_index_ids = p_new_search_result_index_ids;
+                }
+                search_result_buffer_length = new_buffer_length;
+            }
+
+            // Equal elements are stored newest first, reverse each run of them to keep the insertion order.
+            if ((p_previous_index_id == NULL) || (Index_Id_Type_Compare(index_id_type, p_index_id, p_previous_index_id) != INDEX_ID_COMPARE_EQUAL))
+            {
+                reverse_index_payloads(p_search_result, equal_start, search_result_length);
+                equal_start = search_result_length;
+                memcpy(previous_index_id_buffer, p_index_id, index_id_size);
+                p_previous_index_id = previous_index_id_buffer;
+            }
+
+            // The posting list is newest first, same as the equal elements.
+            for (uint32_t j = 0; j < payload_num; j++)
+            {
+                memcpy(p_search_result + (INDEX_PAYLOAD_SIZE * search_result_length), p_payloads + (INDEX_PAYLOAD_SIZE * j), INDEX_PAYLOAD_SIZE);
+                if (pp_result_index_ids != NULL)
+                {
+                    // The equal index ids don't need to be reversed.
+                    memcpy(p_search_result_index_ids + (index_id_size * search_result_length), p_index_id, index_id_size);
+                }
+                search_result_length++;
+            }
+            free(p_posting_payloads);
+        }
+
+        // The next node is latched before the current node is released, the leaf node of the path is released with the path.
+        next_tag = (is_searching) ? (p_index_node->next_tag) : (0);
+        p_next_index_node = (next_tag != 0) ? fetch_and_latch_index_node(p_index_info, next_tag, false) : NULL;
+        if (p_index_node != index_path.p_index_nodes[0])
+        {
+            unlatch_and_release_index_node(p_index_info, p_index_node);
+        }
+        p_index_node = p_next_index_node;
+        position = 0;
+    }
+
+    if ((p_index_node != NULL) && (p_index_node != index_path.p_index_nodes[0]))
+    {
+        unlatch_and_release_index_node(p_index_info, p_index_node);
+    }
+    release_index_path(p_index_info, &index_path);
+    reverse_index_payloads(p_search_result, equal_start, search_result_length);
+
+    if (pp_result_index_ids != NULL)
+    {
+        *pp_result_index_ids = p_search_result_index_ids;
+    }
+    *result_length = search_result_length;
+    return p_search_result;
+}
+
+// Reverse the payloads in [start, end).
+void reverse_index_payloads(uint8_t *p_payloads, uint32_t start, uint32_t end)
+{
+    for (uint32_t i = 0; i < ((end - start) / 2); i++)
+    {
+        uint8_t temp_payload[INDEX_PAYLOAD_SIZE];
+        uint8_t *p_front = p_payloads + (INDEX_PAYLOAD_SIZE * (start + i));
+        uint8_t *p_back = p_payloads + (INDEX_PAYLOAD_SIZE * (end - 1 - i));
+
+        memcpy(temp_payload, p_front, INDEX_PAYLOAD_SIZE);
+        memcpy(p_front, p_back, INDEX_PAYLOAD_SIZE);
+        memcpy(p_back, temp_payload, INDEX_PAYLOAD_SIZE);
+    }
+}
+
+// Find the element in the leaf nodes and remove it, then rebalance the leaf node if it underflows.
+// The duplicated index ids may continue in the next leaf nodes, so the leaf nodes are visited until the index id changes.
+bool delete_index_element(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_index_element)
+{
+    INDEX_ID_TYPE_E index_id_type = p_index_info->index_properties.index_id_type;
+    INDEX_NODE_T *p_index_node = fetch_index_node(p_index_info, p_index_info->index_properties.root_tag);
+    uint32_t position = 0, leaf_tag = 0;
+    bool is_searching = true, is_deleted = false;
+
+    // Descend to the first leaf node which may contain the index id.
+    while ((p_index_node != NULL) && (p_index_node->child_tag[0] != 0))
+    {
+        uint32_t child_tag = p_index_node->child_tag[find_element_position_in_the_node(p_index_info, p_index_node, p_index_element)];
+
+        release_index_node(p_index_info, p_index_node);
+        p_index_node = fetch_index_node(p_index_info, child_tag);
+    }
+
+    if (p_index_node != NULL)
+    {
+        position = find_element_position_in_the_node(p_index_info, p_index_node, p_index_element);
+    }
+
+    while ((p_index_node != NULL) && is_searching)
+    {
+        if (position < p_index_node->length)
+        {
+            if (Index_Id_Type_Compare(index_id_type, p_index_element->p_index_id, get_index_node_index_id(p_index_node, position)) != INDEX_ID_COMPARE_EQUAL)
+            {
+                is_searching = false;
+            }
+            else if (get_index_node_posting_tag(p_index_node, position) != 0)
+            {
+                if (remove_index_posting_list_payload(p_index_info, &(p_index_node->child_tag[position + 1]), p_index_element->index_payload))
+                {
+                    // The element is removed with its last payload.
+                    if (get_index_node_posting_tag(p_index_node, position) == 0)
+                    {
+                        remove_element_from_index_node(p_index_node, position, position + 1);
+                        leaf_tag = p_index_node->tag;
+                    }
+                    mark_index_node_dirty(p_index_info, p_index_node);
+                    is_deleted = true;
+                    is_searching = false;
+                }
+                else
+                {
+                    position++;
+                }
+            }
+            else if (memcmp(get_index_node_payload(p_index_node, position), p_index_element->index_payload, INDEX_PAYLOAD_SIZE) == 0)
+            {
+                remove_element_from_index_node(p_index_node, position, position + 1);
+                mark_index_node_dirty(p_index_info, p_index_node);
+                leaf_tag = p_index_node->tag;
+                is_deleted = true;
+                is_searching = false;
+            }
+            else
+            {
+                position++;
+            }
+        }
+        else
+        {
+            // continue to the next leaf node.
+            uint32_t next_tag = p_index_node->next_tag;
+
+            release_index_node(p_index_info, p_index_node);
+            p_index_node = fetch_index_node(p_index_info, next_tag);
+            position = 0;
+        }
+    }
+
+    if (p_index_node != NULL)
+    {
+        release_index_node(p_index_info, p_index_node);
+    }
+
+    if (leaf_tag != 0)
+    {
+        rebalance_index_node(p_index_info, leaf_tag);
+    }
+
+    return is_deleted;
+}
+
+// A non-root node underflows if it contains fewer elements than this.
+static inline uint32_t get_index_node_min_length(uint32_t order)
+{
+    return order / 2;
+}
+
+// Borrow an element from a sibling node, or merge with a sibling node if both siblings can't lend.
+// Merging removes an element from the parent node, so the parent node is checked in the next round.
+// The merged node is detached from the tree, its tag isn't reused.
+// The compressed nodes may not fit the new separator of the parent node or the merged elements, then the node is left underflowed.
+void rebalance_index_node(INDEX_INFO_T *p_index_info, uint32_t tag)
+{
+    INDEX_PROPERTIES_T *p_index_properties = &(p_index_info->index_properties);
+
+    while (tag != 0)
+    {
+        INDEX_NODE_T *p_index_node = fetch_index_node(p_index_info, tag);
+        // A compressed node underflows by the elements which always fit, so it can take the borrowed element.
+        uint32_t order = (is_index_node_compressed(p_index_properties, p_index_node->level) == false) ? (p_index_node->order) :
+                         ((p_index_node->level > 0) ? (p_index_properties->internal_order) : (p_index_properties->order));
+        uint32_t min_length = get_index_node_min_length(order);
+
+        tag = 0;
+        if (p_index_node->parent_tag == 0)
+        {
+            // Root node, the only child becomes the new root.
+            if ((p_index_node->length == 0) && (p_index_node->child_tag[0] != 0))
+            {
+                INDEX_NODE_T *p_child_index_node = fetch_index_node(p_index_info, p_index_node->child_tag[0]);
+
+                p_child_index_node->parent_tag = 0;
+                p_index_info->index_properties.root_tag = p_child_index_node->tag;
+                mark_index_node_dirty(p_index_info, p_child_index_node);
+                mark_index_properties_dirty(p_index_info);
+                release_index_node(p_index_info, p_child_index_node);
+
+                p_index_node->child_tag[0] = 0;
+                mark_index_node_dirty(p_index_info, p_index_node);
+            }
+        }
+        else if (p_index_node->length < min_length)
+        {
+            INDEX_NODE_T *p_parent_node = fetch_index_node(p_index_info, p_index_node->parent_tag);
+            uint32_t position = find_child_tag_position_in_the_node(p_parent_node, p_index_node->tag);
+            INDEX_NODE_T *p_left_node = (position > 0) ? fetch_index_node(p_index_info, p_parent_node->child_tag[position - 1]) : NULL;
+            INDEX_NODE_T *p_right_node = (position < p_parent_node->length) ? fetch_index_node(p_index_info, p_parent_node->child_tag[position + 1]) : NULL;
+
+            bool is_leaf_node = (p_index_node->child_tag[0] == 0);
+
+            assert((p_left_node != NULL) || (p_right_node != NULL));
+
+            // The borrowed element of the left node becomes the separator, so does the next element of the right leaf node.
+            if ((p_left_node != NULL) && (p_left_node->length > min_length) &&
+                is_index_node_fit_with_index_id(p_index_info, p_parent_node, get_index_node_index_id(p_left_node, p_left_node->length - 1), position - 1))
+            {
+                borrow_element_from_left_sibling(p_index_info, p_parent_node, position, p_left_node, p_index_node);
+            }
+            else if ((p_right_node != NULL) && (p_right_node->length > min_length) &&
+                     is_index_node_fit_with_index_id(p_index_info, p_parent_node, get_index_node_index_id(p_right_node, (is_leaf_node) ? (1) : (0)), position))
+            {
+                borrow_element_from_right_sibling(p_index_info, p_parent_node, position, p_index_node, p_right_node);
+            }
+            else if ((p_left_node != NULL) &&
+                     is_index_node_merge_fit(p_index_info, p_left_node, p_index_node, (is_leaf_node) ? (NULL) : (get_index_node_index_id(p_parent_node, position - 1))))
+            {
+                merge_index_node_with_right_sibling(p_index_info, p_parent_node, position - 1, p_left_node, p_index_node);
+                tag = p_parent_node->tag;
+            }
+            else if ((p_right_node != NULL) &&
+                     is_index_node_merge_fit(p_index_info, p_index_node, p_right_node, (is_leaf_node) ? (NULL) : (get_index_node_index_id(p_parent_node, position))))
+            {
+                merge_index_node_with_right_sibling(p_index_info, p_parent_node, position, p_index_node, p_right_node);
+                tag = p_parent_node->tag;
+            }
+
+            if (p_left_node != NULL)
+            {
+                release_index_node(p_index_info, p_left_node);
+            }
+            if (p_right_node != NULL)
+            {
+                release_index_node(p_index_info, p_right_node);
+            }
+            release_index_node(p_index_info, p_parent_node);
+        }
+
+        release_index_node(p_index_info, p_index_node);
+    }
+}
+
+// position: the position of p_index_node in the child tags of the parent node.
+void borrow_element_from_left_sibling(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_parent_node, uint32_t position, INDEX_NODE_T *p_left_node, INDEX_NODE_T *p_index_node)
+{
+    uint32_t last_position = p_left_node->length - 1;
+
+    if (p_index_node->child_tag[0] == 0)
+    {
+        // leaf node: move the last element of the left node, it becomes the separator in the parent node.
+        insert_element_into_index_node(p_index_node, 0, get_index_node_index_id(p_left_node, last_position), get_index_node_payload(p_left_node, last_position), 1, get_index_node_posting_tag(p_left_node, last_position));
+        set_index_node_element(p_parent_node, position - 1, get_index_node_index_id(p_index_node, 0), get_index_node_payload(p_index_node, 0), INDEX_PAYLOAD_SIZE);
+    }
+    else
+    {
+        // non-leaf node: rotate the separator down and the last element of the left node up, with the last child of the left node.
+        uint32_t child_tag = p_left_node->child_tag[p_left_node->length];
+        INDEX_NODE_T *p_child_index_node = fetch_index_node(p_index_info, child_tag);
+
+        insert_element_into_index_node(p_index_node, 0, get_index_node_index_id(p_parent_node, position - 1), get_index_node_payload(p_parent_node, position - 1), 0, child_tag);
+        set_index_node_element(p_parent_node, position - 1, get_index_node_index_id(p_left_node, last_position), get_index_node_payload(p_left_node, last_position), INDEX_PAYLOAD_SIZE);
+
+        p_child_index_node->parent_tag = p_index_node->tag;
+        mark_index_node_dirty(p_index_info, p_child_index_node);
+        release_index_node(p_index_info, p_child_index_node);
+    }
+    remove_element_from_index_node(p_left_node, last_position, last_position + 1);
+
+    mark_index_node_dirty(p_index_info, p_parent_node);
+    mark_index_node_dirty(p_index_info, p_left_node);
+    mark_index_node_dirty(p_index_info, p_index_node);
+}
+
+// position: the position of p_index_node in the child tags of the parent node.
+void borrow_element_from_right_sibling(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_parent_node, uint32_t position, INDEX_NODE_T *p_index_node, INDEX_NODE_T *p_right_node)
+{
+    if (p_index_node->child_tag[0] == 0)
+    {
+        // leaf node: move the first element of the right node, the next element becomes the separator in the parent node.
+        insert_element_into_index_node(p_index_node, p_index_node->length, get_index_node_index_id(p_right_node, 0), get_index_node_payload(p_right_node, 0), p_index_node->length + 1, get_index_node_posting_tag(p_right_node, 0));
+        remove_element_from_index_node(p_right_node, 0, 1);
+        set_index_node_element(p_parent_node, position, get_index_node_index_id(p_right_node, 0), get_index_node_payload(p_right_node, 0), INDEX_PAYLOAD_SIZE);
+    }
+    else
+    {
+        // non-leaf node: rotate the separator down and the first element of the right node up, with the first child of the right node.
+        uint32_t child_tag = p_right_node->child_tag[0];
+        INDEX_NODE_T *p_child_index_node = fetch_index_node(p_index_info, child_tag);
+
+        insert_element_into_index_node(p_index_node, p_index_node->length, get_index_node_index_id(p_parent_node, position), get_index_node_payload(p_parent_node, position), p_index_node->length + 1, child_tag);
+        set_index_node_element(p_parent_node, position, get_index_node_index_id(p_right_node, 0), get_index_node_payload(p_right_node, 0), INDEX_PAYLOAD_SIZE);
+        remove_element_from_index_node(p_right_node, 0, 0);
+
+        p_child_index_node->parent_tag = p_index_node->tag;
+        mark_index_node_dirty(p_index_info, p_child_index_node);
+        release_index_node(p_index_info, p_child_index_node);
+    }
+
+    mark_index_node_dirty(p_index_info, p_parent_node);
+    mark_index_node_dirty(p_index_info, p_index_node);
+    mark_index_node_dirty(p_index_info, p_right_node);
+}
+
+// Move all elements of the right node into p_index_node and remove the separator (position) from the parent node.
+// position: the position of p_index_node in the child tags of the parent node.
+void merge_index_node_with_right_sibling(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_parent_node, uint32_t position, INDEX_NODE_T *p_index_node, INDEX_NODE_T *p_right_node)
+{
+    if (p_index_node->child_tag[0] == 0)
+    {
+        // leaf node
+        assert(p_index_node->length + p_right_node->length <= p_index_node->order);
+        memcpy(get_index_node_index_id(p_index_node, p_index_node->length), p_right_node->p_index_ids, p_index_node->index_id_size * p_right_node->length);
+        memcpy(get_index_node_payload(p_index_node, p_index_node->length), p_right_node->p_payloads, INDEX_PAYLOAD_SIZE * p_right_node->length);
+        memcpy(&(p_index_node->child_tag[p_index_node->length + 1]), &(p_right_node->child_tag[1]), sizeof(uint32_t) * p_right_node->length);
+        p_index_node->length += p_right_node->length;
+    }
+    else
+    {
+        // non-leaf node: the separator comes down between the two nodes.
+        assert(p_index_node->length + 1 + p_right_node->length <= p_index_node->order);
+        insert_element_into_index_node(p_index_node, p_index_node->length, get_index_node_index_id(p_parent_node, position), get_index_node_payload(p_parent_node, position), p_index_node->length + 1, p_right_node->child_tag[0]);
+        for (uint32_t i = 0; i < p_right_node->length; i++)
+        {
+            insert_element_into_index_node(p_index_node, p_index_node->length, get_index_node_index_id(p_right_node, i), get_index_node_payload(p_right_node, i), p_index_node->length + 1, p_right_node->child_tag[i + 1]);
+        }
+
+        // update the parent tag of the moved child nodes.
+        for (uint32_t i = 0; i <= p_right_node->length; i++)
+        {
+            INDEX_NODE_T *p_child_index_node = fetch_index_node(p_index_info, p_right_node->child_tag[i]);
+
+            p_child_index_node->parent_tag = p_index_node->tag;
+            mark_index_node_dirty(p_index_info, p_child_index_node);
+            release_index_node(p_index_info, p_child_index_node);
+        }
+    }
+    p_index_node->next_tag = p_right_node->next_tag;
+    remove_element_from_index_node(p_parent_node, position, position + 1);
+
+    // Detach the right node.
+    reset_index_node(p_right_node, p_right_node->tag, &(p_index_info->index_properties));
+
+    mark_index_node_dirty(p_index_info, p_parent_node);
+    mark_index_node_dirty(p_index_info, p_index_node);
+    mark_index_node_dirty(p_index_info, p_right_node);
+}
+
+// Position 1 should be placed before position 2 in the leaf nodes.
+// Duplicated index ids are placed in the reversed input order, same as inserting them one by one.
+static inline bool is_index_element_position_before(uint32_t position_1, uint32_t position_2, uint8_t *p_index_ids, INDEX_ID_TYPE_E index_id_type)
+{
+    uint32_t index_id_size = Index_Id_Type_Get_Size(index_id_type);
+    INDEX_ID_COMPARE_RESULT_E cmp_result = Index_Id_Type_Compare(index_id_type, p_index_ids + (index_id_size * position_1), p_index_ids + (index_id_size * position_2));
+
+    return (cmp_result == INDEX_ID_COMPARE_RIGHT_GREATER) || ((cmp_result == INDEX_ID_COMPARE_EQUAL) && (position_1 > position_2));
+}
+
+// Bottom-up merge sort of the element positions by the index ids.
+void sort_index_element_positions(uint32_t *p_positions, uint32_t element_num, uint8_t *p_index_ids, INDEX_ID_TYPE_E index_id_type)
+{
+    uint32_t *p_buffer = NULL;
+    uint32_t *p_source = p_positions, *p_destination = NULL;
+
+    if (element_num < 2)
+    {
+        return;
+    }
+
+    p_buffer = malloc(sizeof(uint32_t) * element_num);
+    assert(p_buffer != NULL);
+    p_destination = p_buffer;
+
+    for (uint32_t width = 1; width < element_num; width *= 2)
+    {
+        for (uint32_t start = 0; start < element_num; start += 2 * width)
+        {
+            uint32_t middle = ((element_num - start) > width) ? (start + width) : (element_num);
+            uint32_t end = ((element_num - middle) > width) ? (middle + width) : (element_num);
+            uint32_t left = start, right = middle;
+
+            for (uint32_t i = start; i < end; i++)
+            {
+                if ((left < middle) && ((right >= end) || (is_index_element_position_before(p_source[right], p_source[left], p_index_ids, index_id_type) == false)))
+                {
+                    p_destination[i] = p_source[left++];
+                }
+                else
+                {
+                    p_destination[i] = p_source[right++];
+                }
+            }
+        }
+
+        // swap
+        uint32_t *p_temp = p_source;
+        p_source = p_destination;
+        p_destination = p_temp;
+    }
+
+    if (p_source != p_positions)
+    {
+        memcpy(p_positions, p_source, sizeof(uint32_t) * element_num);
+    }
+    free(p_buffer);
+}
+
+// Return the number of nodes to hold item_num items (elements or child tags), each node holds at most max_item_num items.
+// Every node should hold min_item_num items at least, unless there is only one node.
+uint32_t get_bulk_build_node_num(uint32_t item_num, uint32_t max_item_num, uint32_t min_item_num)
+{
+    uint32_t node_num = (item_num + max_item_num - 1) / max_item_num;
+
+    while ((node_num > 1) && (item_num < (node_num * min_item_num)))
+    {
+        node_num--;
+    }
+
+    return (node_num > 0) ? (node_num) : (1);
+}
+
+// The items are distributed evenly, the first (item_num % node_num) nodes hold one more item.
+static inline uint32_t get_bulk_build_node_item_num(uint32_t item_num, uint32_t node_num, uint32_t node_index)
+{
+    return (item_num / node_num) + ((node_index < (item_num % node_num)) ? 1 : 0);
+}
+
+static inline uint32_t get_bulk_build_node_index_of_item(uint32_t item_num, uint32_t node_num, uint32_t item_index)
+{
+    uint32_t base_item_num = item_num / node_num;
+    uint32_t larger_node_num = item_num % node_num;
+
+    if (item_index < (larger_node_num * (base_item_num + 1)))
+    {
+        return item_index / (base_item_num + 1);
+    }
+    else
+    {
+        return larger_node_num + ((item_index - (larger_node_num * (base_item_num + 1))) / base_item_num);
+    }
+}
+
+// Write the sorted elements into packed leaf nodes, then build the upper levels from the first elements of their child nodes.
+// The index should only contain the empty root node (tag: 1), which is reused as the first leaf node.
+// Nodes are created level by level, so the tags of each level are consecutive and the parent tags are known in advance.
+void bulk_build_index_nodes(INDEX_INFO_T *p_index_info, uint8_t *p_index_ids, uint8_t *p_payloads, uint32_t payload_size, uint32_t *p_positions, uint32_t element_num)
+{
+    INDEX_PROPERTIES_T *p_index_properties = &(p_index_info->index_properties);
+    uint32_t index_id_size = Index_Id_Type_Get_Size(p_index_properties->index_id_type);
+    // Max number of elements in a leaf node, and max number of child tags in a non-leaf node.
+    uint32_t fill_factor = atomic_load(&index_bulk_build_fill_factor);
+    uint32_t max_element_num = (p_index_properties->order * fill_factor) / 100;
+    uint32_t internal_order = (p_index_properties->internal_order > 0) ? (p_index_properties->internal_order) : (p_index_properties->order);
+    uint32_t max_child_num = (internal_order * fill_factor) / 100;
+    uint32_t level_node_num[INDEX_BULK_BUILD_MAX_LEVEL] = {0};
+    uint32_t level_num = 1, level_first_tag = 1, item_index = 0, item_num = 0;
+    // The first element of each node in the current level, which is the separator in the parent node.
+    uint8_t *p_first_index_ids = NULL, *p_first_payloads = NULL;
+    // The last index id of the previous leaf node, the separators of the compressed nodes are truncated after it.
+    uint64_t last_index_id_buffer[(INDEX_ID_MAX_SIZE + sizeof(uint64_t) - 1) / sizeof(uint64_t)] = {0}; // aligned for any index id type
+    // Each leaf element is an element or a run of equal elements gathered into a posting list.
+    uint32_t *p_item_starts = NULL;
+
+    if (element_num == 0)
+    {
+        return;
+    }
+
+    max_element_num = (max_element_num > 0) ? (max_element_num) : (1);
+    max_child_num = ((max_child_num > 0) ? (max_child_num) : (1)) + 1;
+
+    p_item_starts = get_bulk_build_leaf_item_starts(p_index_info, p_index_ids, p_positions, element_num, &item_num);
+    level_node_num[0] = get_bulk_build_node_num(item_num, max_element_num, 1);
+    while (level_node_num[level_num - 1] > 1)
+    {
+        assert(level_num < INDEX_BULK_BUILD_MAX_LEVEL);
+        level_node_num[level_num] = get_bulk_build_node_num(level_node_num[level_num - 1], max_child_num, 2);
+        level_num++;
+    }
+
+    p_first_index_ids = malloc(index_id_size * level_node_num[0]);
+    p_first_payloads = malloc(INDEX_PAYLOAD_SIZE * level_node_num[0]);
+    assert((p_first_index_ids != NULL) && (p_first_payloads != NULL));
+
+    // leaf nodes
+    for (uint32_t i = 0; i < level_node_num[0]; i++)
+    {
+        INDEX_NODE_T *p_index_node = (i == 0) ? fetch_index_node(p_index_info, level_first_tag) : create_index_node(p_index_info);
+        uint32_t length = get_bulk_build_node_item_num(item_num, level_node_num[0], i);
+
+        assert(p_index_node->tag == level_first_tag + i);
+        set_index_node_level(p_index_node, 0, p_index_properties);
+        p_index_node->next_tag = (i + 1 < level_node_num[0]) ? (p_index_node->tag + 1) : (0);
+        p_index_node->parent_tag = (level_num > 1) ? (level_first_tag + level_node_num[0] + get_bulk_build_node_index_of_item(level_node_num[0], level_node_num[1], i)) : (0);
+
+        for (uint32_t j = 0; j < length; j++, item_index++)
+        {
+            uint32_t position = p_positions[p_item_starts[item_index]];
+            // The payloads of a run are written to its posting list after all the tree nodes are created.
+            bool is_run = ((p_item_starts[item_index + 1] - p_item_starts[item_index]) > 1);
+
+            set_index_node_element(p_index_node, j, p_index_ids + (index_id_size * position), (is_run) ? (NULL) : (p_payloads + (payload_size * position)), payload_size);
+        }
+        p_index_node->length = length;
+
+        if ((i > 0) && is_index_node_compressed(p_index_properties, 0))
+        {
+            Index_Id_Type_Set_Separator(p_index_properties->index_id_type, p_first_index_ids + (index_id_size * i), last_index_id_buffer, get_index_node_index_id(p_index_node, 0));
+        }
+        else
+        {
+            memcpy(p_first_index_ids + (index_id_size * i), get_index_node_index_id(p_index_node, 0), index_id_size);
+        }
+        memcpy(last_index_id_buffer, get_index_node_index_id(p_index_node, length - 1), index_id_size);
+        memcpy(p_first_payloads + (INDEX_PAYLOAD_SIZE * i), get_index_node_payload(p_index_node, 0), INDEX_PAYLOAD_SIZE);
+
+        mark_index_node_dirty(p_index_info, p_index_node);
+        release_index_node(p_index_info, p_index_node);
+    }
+    assert(item_index == item_num);
+
+    // non-leaf nodes
+    for (uint32_t level = 1; level < level_num; level++)
+    {
+        uint32_t child_num = level_node_num[level - 1];
+        uint32_t child_first_tag = level_first_tag;
+        uint32_t child_index = 0;
+
+        level_first_tag += child_num;
+        for (uint32_t i = 0; i < level_node_num[level]; i++)
+        {
+            INDEX_NODE_T *p_index_node = create_index_node(p_index_info);
+            uint32_t node_child_num = get_bulk_build_node_item_num(child_num, level_node_num[level], i);
+
+            assert(p_index_node->tag == level_first_tag + i);
+            set_index_node_level(p_index_node, level, p_index_properties);
+            p_index_node->next_tag = (i + 1 < level_node_num[level]) ? (p_index_node->tag + 1) : (0);
+            p_index_node->parent_tag = (level + 1 < level_num) ? (level_first_tag + level_node_num[level] + get_bulk_build_node_index_of_item(level_node_num[level], level_node_num[level + 1], i)) : (0);
+
+            // The first element of each child (except the first child) is the separator.
+            p_index_node->child_tag[0] = child_first_tag + child_index;
+            for (uint32_t j = 1; j < node_child_num; j++)
+            {
+                set_index_node_element(p_index_node, j - 1, p_first_index_ids + (index_id_size * (child_index + j)), p_first_payloads + (INDEX_PAYLOAD_SIZE * (child_index + j)), INDEX_PAYLOAD_SIZE);
+                p_index_node->child_tag[j] = child_first_tag + child_index + j;
+            }
+            p_index_node->length = node_child_num - 1;
+
+            // The first element of the node is the first element of its first child, i <= child_index.
+            memmove(p_first_index_ids + (index_id_size * i), p_first_index_ids + (index_id_size * child_index), index_id_size);
+            memmove(p_first_payloads + (INDEX_PAYLOAD_SIZE * i), p_first_payloads + (INDEX_PAYLOAD_SIZE * child_index), INDEX_PAYLOAD_SIZE);
+            child_index += node_child_num;
+
+            mark_index_node_dirty(p_index_info, p_index_node);
+            release_index_node(p_index_info, p_index_node);
+        }
+        assert(child_index == child_num);
+    }
+
+    // The only node in the top level is the root.
+    p_index_properties->root_tag = level_first_tag;
+    mark_index_properties_dirty(p_index_info);
+
+    if (item_num < element_num)
+    {
+        attach_bulk_build_posting_lists(p_index_info, p_payloads, payload_size, p_positions, p_item_starts, level_node_num[0]);
+    }
+
+    free(p_item_starts);
+    free(p_first_index_ids);
+    free(p_first_payloads);
+}
+
+// Group the sorted elements into the leaf elements, a run of equal index ids as long as the posting list min length is a single leaf element.
+// Return the start of each leaf element in p_positions followed by element_num, there are *p_item_num leaf elements.
+uint32_t *get_bulk_build_leaf_item_starts(INDEX_INFO_T *p_index_info, uint8_t *p_index_ids, uint32_t *p_positions, uint32_t element_num, uint32_t *p_item_num)
+{
+    INDEX_ID_TYPE_E index_id_type = p_index_info->index_properties.index_id_type;
+    uint32_t index_id_size = Index_Id_Type_Get_Size(index_id_type);
+    uint32_t min_length = atomic_load(&index_posting_list_min_length);
+    uint32_t *p_item_starts = malloc(sizeof(uint32_t) * ((size_t)element_num + 1));
+    uint32_t item_num = 0, start = 0;
+
+    assert(p_item_starts != NULL);
+
+    while (start < element_num)
+    {
+        uint32_t end = start + 1;
+
+        while ((min_length > 0) && (end < element_num) &&
+               (Index_Id_Type_Compare(index_id_type, p_index_ids + (index_id_size * p_positions[start]), p_index_ids + (index_id_size * p_positions[end])) == INDEX_ID_COMPARE_EQUAL))
+        {
+            end++;
+        }
+
+        if ((end - start > 1) && (end - start >= min_length))
+        {
+            p_item_starts[item_num++] = start;
+        }
+        else
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                p_item_starts[item_num++] = i;
+            }
+        }
+        start = end;
+    }
+    p_item_starts[item_num] = element_num;
+
+    *p_item_num = item_num;
+    return p_item_starts;
+}
+
+// Create the posting lists of the runs in the leaf nodes written by bulk_build_index_nodes(), the leaf nodes are the first tags.
+void attach_bulk_build_posting_lists(INDEX_INFO_T *p_index_info, uint8_t *p_payloads, uint32_t payload_size, uint32_t *p_positions, uint32_t *p_item_starts, uint32_t leaf_node_num)
+{
+    uint32_t item_index = 0;
+
+    for (uint32_t tag = 1; tag <= leaf_node_num; tag++)
+    {
+        INDEX_NODE_T *p_index_node = fetch_index_node(p_index_info, tag);
+
+        for (uint32_t j = 0; j < p_index_node->length; j++, item_index++)
+        {
+            uint32_t run_length = p_item_starts[item_index + 1] - p_item_starts[item_index];
+            uint8_t *p_run_payloads = NULL;
+
+            if (run_length == 1)
+            {
+                continue;
+            }
+
+            p_run_payloads = calloc(run_length, INDEX_PAYLOAD_SIZE);
+            assert(p_run_payloads != NULL);
+            for (uint32_t k = 0; k < run_length; k++)
+            {
+                memcpy(p_run_payloads + (INDEX_PAYLOAD_SIZE * k), p_payloads + (payload_size * p_positions[p_item_starts[item_index] + k]), payload_size);
+            }
+            p_index_node->child_tag[j + 1] = create_index_posting_list(p_index_info, p_run_payloads, run_length);
+            free(p_run_payloads);
+        }
+
+        mark_index_node_dirty(p_index_info, p_index_node);
+        release_index_node(p_index_info, p_index_node);
+    }
+}
+
+// Insert the sorted elements one by one into a non-empty index.
+// The elements are inserted from the last one, so duplicated index ids are inserted in the input order.
+void bulk_insert_index_elements(INDEX_INFO_T *p_index_info, uint8_t *p_index_ids, uint8_t *p_payloads, uint32_t payload_size, uint32_t *p_positions, uint32_t element_num)
+{
+    uint32_t index_id_size = Index_Id_Type_Get_Size(p_index_info->index_properties.index_id_type);
+    INDEX_ELEMENT_T index_element;
+
+    for (uint32_t i = element_num; i > 0; i--)
+    {
+        uint32_t position = p_positions[i - 1];
+
+        // The element refers to the input array, there is no resource to free.
+        index_element.p_index_id = p_index_ids + (index_id_size * position);
+        memset(index_element.index_payload, 0, INDEX_PAYLOAD_SIZE);
+        memcpy(index_element.index_payload, p_payloads + (payload_size * position), payload_size);
+
+        insert_index_element(p_index_info, &index_element);
+    }
+}
+
+// Posting list (B+ tree):
+// The payloads of an index id which is duplicated many times are stored in a chain of posting nodes instead of the leaf elements.
+// The leaf element keeps the index id and the tag of the first posting node in child_tag[position + 1], child_tag[0] of a leaf node is always 0.
+// The posting nodes are linked by next_tag from the newest payloads, same as the order of the equal elements in the leaf nodes.
+// Posting node image: tag | level | length | parent_tag | next_tag | encoded_size | encoded payloads
+
+// Return the tag of the first posting node of the [position] element of a leaf node, 0 if the payload is stored in the element.
+static inline uint32_t get_index_node_posting_tag(INDEX_NODE_T *p_index_node, uint32_t position)
+{
+    return p_index_node->child_tag[position + 1];
+}
+
+static inline uint8_t *get_index_posting_node_data(INDEX_NODE_T *p_index_node)
+{
+    return p_index_node->p_node_image + (sizeof(uint32_t) * (INDEX_NODE_HEADER_FIELD_NUM + 1));
+}
+
+// Bytes of the encoded payloads a posting node can hold.
+static inline uint32_t get_index_posting_node_capacity(INDEX_NODE_T *p_index_node)
+{
+    return p_index_node->node_size - (sizeof(uint32_t) * (INDEX_NODE_HEADER_FIELD_NUM + 1));
+}
+
+// 7 bits per byte from the lowest bits, the highest bit is set if more bytes follow.
+static inline uint32_t encode_index_varint(uint8_t *p_buffer, uint64_t value)
+{
+    uint32_t size = 0;
+
+    while (value >= 0x80U)
+    {
+        p_buffer[size++] = (uint8_t)(value | 0x80U);
+        value >>= 7;
+    }
+    p_buffer[size++] = (uint8_t)value;
+
+    return size;
+}
+
+static inline uint32_t decode_index_varint(const uint8_t *p_buffer, uint64_t *p_value)
+{
+    uint32_t size = 0;
+    uint64_t value = 0;
+
+    do
+    {
+        value |= (uint64_t)(p_buffer[size] & 0x7FU) << (7 * size);
+    } while (p_buffer[size++] & 0x80U);
+
+    *p_value = value;
+    return size;
+}
+
+// Encode the payloads into the buffer from the first one until the next one doesn't fit in buffer_size bytes.
+// Return the number of the encoded payloads, their bytes are stored in *p_encoded_size.
+uint32_t encode_index_posting_payloads(uint8_t *p_buffer, uint32_t buffer_size, uint8_t *p_payloads, uint32_t payload_num, uint32_t *p_encoded_size)
+{
+    uint64_t previous_words[INDEX_POSTING_WORD_NUM] = {0};
+    uint32_t encoded_size = 0, encoded_num = 0;
+
+    for (encoded_num = 0; encoded_num < payload_num; encoded_num++)
+    {
+        uint8_t payload_buffer[INDEX_POSTING_WORD_NUM * INDEX_VARINT_MAX_SIZE];
+        uint32_t payload_size = 0;
+
+        for (uint32_t i = 0; i < INDEX_POSTING_WORD_NUM; i++)
+        {
+            uint32_t word_size = ((INDEX_PAYLOAD_SIZE - (sizeof(uint64_t) * i)) < sizeof(uint64_t)) ? (INDEX_PAYLOAD_SIZE - (sizeof(uint64_t) * i)) : (sizeof(uint64_t));
+            uint64_t word = 0, delta = 0;
+
+            memcpy(&word, p_payloads + (INDEX_PAYLOAD_SIZE * encoded_num) + (sizeof(uint64_t) * i), word_size);
+            // zigzag: the small negative differences are encoded as small numbers.
+            delta = word - previous_words[i];
+            payload_size += encode_index_varint(payload_buffer + payload_size, (delta << 1) ^ ((uint64_t)0 - (delta >> 63)));
+            previous_words[i] = word;
+        }
+
+        if (encoded_size + payload_size > buffer_size)
+        {
+            break;
+        }
+        memcpy(p_buffer + encoded_size, payload_buffer, payload_size);
+        encoded_size += payload_size;
+    }
+
+    *p_encoded_size = encoded_size;
+    return encoded_num;
+}
+
+void decode_index_posting_payloads(const uint8_t *p_buffer, uint8_t *p_payloads, uint32_t payload_num)
+{
+    uint64_t previous_words[INDEX_POSTING_WORD_NUM] = {0};
+    uint32_t offset = 0;
+
+    for (uint32_t n = 0; n < payload_num; n++)
+    {
+        for (uint32_t i = 0; i < INDEX_POSTING_WORD_NUM; i++)
+        {
+            uint32_t word_size = ((INDEX_PAYLOAD_SIZE - (sizeof(uint64_t) * i)) < sizeof(uint64_t)) ? (INDEX_PAYLOAD_SIZE - (sizeof(uint64_t) * i)) : (sizeof(uint64_t));
+            uint64_t zigzag = 0;
+
+            offset += decode_index_varint(p_buffer + offset, &zigzag);
+            previous_words[i] += (zigzag >> 1) ^ ((uint64_t)0 - (zigzag & 1));
+            memcpy(p_payloads + (INDEX_PAYLOAD_SIZE * n) + (sizeof(uint64_t) * i), &(previous_words[i]), word_size);
+        }
+    }
+}
+
+// Replace the payloads of the posting node by the leading payloads which fit in it, return the number of the stored payloads.
+// If is_partial is false, the node is kept unchanged and 0 is returned unless all the payloads fit in it.
+uint32_t set_index_posting_node_payloads(INDEX_NODE_T *p_index_node, uint8_t *p_payloads, uint32_t payload_num, bool is_partial)
+{
+    uint32_t capacity = get_index_posting_node_capacity(p_index_node);
+    uint8_t encoded_buffer[capacity];
+    uint32_t encoded_size = 0, encoded_num = encode_index_posting_payloads(encoded_buffer, capacity, p_payloads, payload_num, &encoded_size);
+
+    if ((is_partial == false) && (encoded_num < payload_num))
+    {
+        return 0;
+    }
+
+    memcpy(get_index_posting_node_data(p_index_node) - sizeof(uint32_t), &encoded_size, sizeof(uint32_t));
+    memcpy(get_index_posting_node_data(p_index_node), encoded_buffer, encoded_size);
+    memset(get_index_posting_node_data(p_index_node) + encoded_size, 0, capacity - encoded_size);
+    p_index_node->length = encoded_num;
+
+    return encoded_num;
+}
+
+// Create the posting nodes holding the payloads (newest first), return the tag of the first posting node.
+uint32_t create_index_posting_list(INDEX_INFO_T *p_index_info, uint8_t *p_payloads, uint32_t payload_num)
+{
+    INDEX_NODE_T *p_previous_node = NULL;
+    uint32_t head_tag = 0, stored_num = 0;
+
+    while (stored_num < payload_num)
+    {
+        INDEX_NODE_T *p_posting_node = create_index_node(p_index_info);
+
+        set_index_node_level(p_posting_node, INDEX_POSTING_LIST_LEVEL, &(p_index_info->index_properties));
+        stored_num += set_index_posting_node_payloads(p_posting_node, p_payloads + (INDEX_PAYLOAD_SIZE * stored_num), payload_num - stored_num, true);
+        assert(p_posting_node->length > 0);
+
+        if (p_previous_node == NULL)
+        {
+            head_tag = p_posting_node->tag;
+        }
+        else
+        {
+            p_previous_node->next_tag = p_posting_node->tag;
+            release_index_node(p_index_info, p_previous_node);
+        }
+        p_previous_node = p_posting_node;
+    }
+
+    if (p_previous_node != NULL)
+    {
+        release_index_node(p_index_info, p_previous_node);
+    }
+
+    return head_tag;
+}
+
+// Insert the payload before the other payloads of the posting list.
+// A new first posting node is created if the first posting node is full, *p_head_tag is updated to it.
+void prepend_index_posting_list(INDEX_INFO_T *p_index_info, uint32_t *p_head_tag, void *p_payload)
+{
+    INDEX_NODE_T *p_head_node = fetch_index_node(p_index_info, *p_head_tag);
+    uint8_t *p_payloads = NULL;
+
+    assert(p_head_node != NULL);
+
+    p_payloads = malloc((size_t)(p_head_node->length + 1) * INDEX_PAYLOAD_SIZE);
+    assert(p_payloads != NULL);
+    memcpy(p_payloads, p_payload, INDEX_PAYLOAD_SIZE);
+    decode_index_posting_payloads(get_index_posting_node_data(p_head_node), p_payloads + INDEX_PAYLOAD_SIZE, p_head_node->length);
+
+    if (set_index_posting_node_payloads(p_head_node, p_payloads, p_head_node->length + 1, false) > 0)
+    {
+        mark_index_node_dirty(p_index_info, p_head_node);
+    }
+    else
+    {
+        uint32_t new_head_tag = create_index_posting_list(p_index_info, p_payloads, 1);
+        INDEX_NODE_T *p_new_head_node = fetch_index_node(p_index_info, new_head_tag);
+
+        p_new_head_node->next_tag = *p_head_tag;
+        mark_index_node_dirty(p_index_info, p_new_head_node);
+        release_index_node(p_index_info, p_new_head_node);
+        *p_head_tag = new_head_tag;
+    }
+
+    free(p_payloads);
+    release_index_node(p_index_info, p_head_node);
+}
+
+// Remove the payload from the posting list, the posting node left empty is detached from the list.
+// *p_head_tag is updated if the first posting node is detached, it becomes 0 if the posting list is empty.
+// Return false if the payload doesn't exist.
+bool remove_index_posting_list_payload(INDEX_INFO_T *p_index_info, uint32_t *p_head_tag, void *p_payload)
+{
+    INDEX_NODE_T *p_previous_node = NULL;
+    uint32_t tag = *p_head_tag;
+    bool is_removed = false;
+
+    while ((tag != 0) && (is_removed == false))
+    {
+        INDEX_NODE_T *p_posting_node = fetch_index_node(p_index_info, tag);
+        uint8_t *p_payloads = NULL;
+
+        if (p_posting_node == NULL)
+        {
+            break;
+        }
+
+        p_payloads = malloc((size_t)p_posting_node->length * INDEX_PAYLOAD_SIZE);
+        assert(p_payloads != NULL);
+        decode_index_posting_payloads(get_index_posting_node_data(p_posting_node), p_payloads, p_posting_node->length);
+
+        for (uint32_t i = 0; i < p_posting_node->length; i++)
+        {
+            if (memcmp(p_payloads + (INDEX_PAYLOAD_SIZE * i), p_payload, INDEX_PAYLOAD_SIZE) == 0)
+            {
+                uint32_t payload_num = p_posting_node->length - 1;
+
+                memmove(p_payloads + (INDEX_PAYLOAD_SIZE * i), p_payloads + (INDEX_PAYLOAD_SIZE * (i + 1)), (size_t)(payload_num - i) * INDEX_PAYLOAD_SIZE);
+                // The difference of the neighbors never takes more bytes than the two differences, the rest still fits.
+                set_index_posting_node_payloads(p_posting_node, p_payloads, payload_num, true);
+                assert(p_posting_node->length == payload_num);
+                mark_index_node_dirty(p_index_info, p_posting_node);
+                is_removed = true;
+                break;
+            }
+        }
+        free(p_payloads);
+
+        tag = p_posting_node->next_tag;
+        if (is_removed && (p_posting_node->length == 0))
+        {
+            // Detach the empty posting node, its tag isn't reused.
+            if (p_previous_node != NULL)
+            {
+                p_previous_node->next_tag = tag;
+                mark_index_node_dirty(p_index_info, p_previous_node);
+            }
+            else
+            {
+                *p_head_tag = tag;
+            }
+            p_posting_node->next_tag = 0;
+        }
+
+        if (p_previous_node != NULL)
+        {
+            release_index_node(p_index_info, p_previous_node);
+        }
+        p_previous_node = p_posting_node;
+    }
+
+    if (p_previous_node != NULL)
+    {
+        release_index_node(p_index_info, p_previous_node);
+    }
+
+    return is_removed;
+}
+
+// Return the payloads of the posting list (newest first) in an array of *p_payload_num payloads, free it after using it.
+uint8_t *read_index_posting_list(INDEX_INFO_T *p_index_info, uint32_t head_tag, uint32_t *p_payload_num)
+{
+    uint8_t *p_payloads = NULL;
+    uint32_t payload_num = 0, tag = head_tag;
+
+    while (tag != 0)
+    {
+        INDEX_NODE_T *p_posting_node = fetch_index_node(p_index_info, tag);
+        uint8_t *p_new_payloads = NULL;
+
+        if (p_posting_node == NULL)
+        {
+            break;
+        }
+
+        p_new_payloads = realloc(p_payloads, ((size_t)payload_num + p_posting_node->length) * INDEX_PAYLOAD_SIZE);
+        if (p_new_payloads == NULL)
+        {
+            // Error handling: return the collected payloads.
+            release_index_node(p_index_info, p_posting_node);
+            break;
+        }
+        p_payloads = p_new_payloads;
+        decode_index_posting_payloads(get_index_posting_node_data(p_posting_node), p_payloads + (INDEX_PAYLOAD_SIZE * payload_num), p_posting_node->length);
+        payload_num += p_posting_node->length;
+
+        tag = p_posting_node->next_tag;
+        release_index_node(p_index_info, p_posting_node);
+    }
+
+    *p_payload_num = payload_num;
+    return p_payloads;
+}
+
+// Insert the element into the posting list of its index id if the leaf node already holds the index id (or the next leaf node holds it first),
+// and the run of the equal elements is long enough to be gathered into a posting list.
+// The leaf node is latched exclusively, the next leaf node is also latched if it's visited.
+// Return false if the element should be inserted into the leaf node.
+bool insert_index_element_into_posting_list(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_leaf_node, INDEX_ELEMENT_T *p_index_element)
+{
+    INDEX_ID_TYPE_E index_id_type = p_index_info->index_properties.index_id_type;
+    uint32_t min_length = atomic_load(&index_posting_list_min_length);
+    INDEX_NODE_T *p_index_node = p_leaf_node;
+    uint32_t position = 0, run_length = 0;
+    bool is_inserted = false;
+
+    if (min_length == 0)
+    {
+        return false;
+    }
+
+    position = find_element_position_in_the_node(p_index_info, p_leaf_node, p_index_element);
+    if ((position == p_leaf_node->length) && (p_leaf_node->next_tag != 0))
+    {
+        // The index id equal to the separator is placed at the beginning of the next leaf node.
+        p_index_node = fetch_and_latch_index_node(p_index_info, p_leaf_node->next_tag, true);
+        position = 0;
+    }
+
+    if ((p_index_node != NULL) && (position < p_index_node->length) &&
+        (Index_Id_Type_Compare(index_id_type, p_index_element->p_index_id, get_index_node_index_id(p_index_node, position)) == INDEX_ID_COMPARE_EQUAL))
+    {
+        if (get_index_node_posting_tag(p_index_node, position) != 0)
+        {
+            prepend_index_posting_list(p_index_info, &(p_index_node->child_tag[position + 1]), p_index_element->index_payload);
+            mark_index_node_dirty(p_index_info, p_index_node);
+            is_inserted = true;
+        }
+        else
+        {
+            // Count the equal elements without posting lists.
+            while ((position + run_length < p_index_node->length) && (get_index_node_posting_tag(p_index_node, position + run_length) == 0) &&
+                   (Index_Id_Type_Compare(index_id_type, p_index_element->p_index_id, get_index_node_index_id(p_index_node, position + run_length)) == INDEX_ID_COMPARE_EQUAL))
+            {
+                run_length++;
+            }
+
+            if (run_length + 1 >= min_length)
+            {
+                gather_index_elements_into_posting_list(p_index_info, p_index_node, position, run_length, p_index_element);
+                is_inserted = true;
+            }
+        }
+    }
+
+    if ((p_index_node != NULL) && (p_index_node != p_leaf_node))
+    {
+        unlatch_and_release_index_node(p_index_info, p_index_node);
+    }
+
+    return is_inserted;
+}
+
+// Replace the run of the equal elements from position by a single element, whose posting list holds the new element and the run.
+void gather_index_elements_into_posting_list(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_leaf_node, uint32_t position, uint32_t run_length, INDEX_ELEMENT_T *p_index_element)
+{
+    uint8_t *p_payloads = malloc((size_t)(run_length + 1) * INDEX_PAYLOAD_SIZE);
+    uint32_t head_tag = 0;
+
+    assert((p_payloads != NULL) && (run_length > 0));
+
+    // The new element is the newest one.
+    memcpy(p_payloads, p_index_element->index_payload, INDEX_PAYLOAD_SIZE);
+    memcpy(p_payloads + INDEX_PAYLOAD_SIZE, get_index_node_payload(p_leaf_node, position), (size_t)run_length * INDEX_PAYLOAD_SIZE);
+    head_tag = create_index_posting_list(p_index_info, p_payloads, run_length + 1);
+    free(p_payloads);
+
+    for (uint32_t i = 1; i < run_length; i++)
+    {
+        remove_element_from_index_node(p_leaf_node, position + 1, position + 2);
+    }
+    memset(get_index_node_payload(p_leaf_node, position), 0, INDEX_PAYLOAD_SIZE);
+    p_leaf_node->child_tag[position + 1] = head_tag;
+
+    mark_index_node_dirty(p_index_info, p_leaf_node);
+}
+
+// Index statistics:
+// The statistics are collected by a scan of the index when they're requested the first time, and again after enough elements are changed.
+// The B+ tree leaf nodes are scanned in order, each histogram bucket is a run of them holding about the same number of elements.
+// The readers may collect the statistics at the same time, the last collected ones are kept.
+
+void index_statistics_info_init(INDEX_STATISTICS_INFO_T *p_index_statistics_info)
+{
+    p_index_statistics_info->is_collected = false;
+    memset(&(p_index_statistics_info->statistics), 0, sizeof(INDEX_STATISTICS_T));
+    p_index_statistics_info->modified_num = 0;
+    p_index_statistics_info->p_bucket_bounds = NULL;
+    p_index_statistics_info->p_bucket_element_nums = NULL;
+    p_index_statistics_info->p_bucket_distinct_nums = NULL;
+}
+
+void free_index_statistics_info_resources(INDEX_STATISTICS_INFO_T *p_index_statistics_info)
+{
+    free(p_index_statistics_info->p_bucket_bounds);
+    free(p_index_statistics_info->p_bucket_element_nums);
+    free(p_index_statistics_info->p_bucket_distinct_nums);
+    index_statistics_info_init(p_index_statistics_info);
+}
+
+// Count the inserted or deleted elements since the statistics were collected.
+void add_index_statistics_modified_num(INDEX_INFO_T *p_index_info, uint64_t modified_num)
+{
+    lock_index_node_cache(&(p_index_info->index_node_cache));
+    p_index_info->index_statistics_info.modified_num += modified_num;
+    unlock_index_node_cache(&(p_index_info->index_node_cache));
+}
+
+// Lock the node cache before using this function.
+static inline bool is_index_statistics_stale(INDEX_STATISTICS_INFO_T *p_index_statistics_info)
+{
+    return (p_index_statistics_info->is_collected == false) ||
+           ((p_index_statistics_info->modified_num > 0) &&
+            ((p_index_statistics_info->modified_num * 100) >= (p_index_statistics_info->statistics.element_num * INDEX_STATISTICS_STALE_PERCENT)));
+}
+
+// Collect the statistics if they're stale, the index file should be locked (read) and the node cache synchronized.
+void update_index_statistics(INDEX_INFO_T *p_index_info)
+{
+    INDEX_NODE_CACHE_T *p_index_node_cache = &(p_index_info->index_node_cache);
+    INDEX_STATISTICS_INFO_T index_statistics_info;
+    bool is_stale = false;
+
+    lock_index_node_cache(p_index_node_cache);
+    is_stale = is_index_statistics_stale(&(p_index_info->index_statistics_info));
+    unlock_index_node_cache(p_index_node_cache);
+
+    if (is_stale == false)
+    {
+        return;
+    }
+
+    // The nodes are scanned without the cache mutex, which is locked by fetching each node.
+    index_statistics_info_init(&index_statistics_info);
+    if (p_index_info->index_properties.index_structure == INDEX_STRUCTURE_HASH)
     {
-        free_index_element_resources(p_index_element);
+        collect_hash_index_statistics(p_index_info, &index_statistics_info);
+    }
+    else
+    {
+        collect_index_statistics(p_index_info, &index_statistics_info);
     }
 
-    p_index_element->p_index_id = calloc(1, index_id_size);
+    lock_index_node_cache(p_index_node_cache);
+    free_index_statistics_info_resources(&(p_index_info->index_statistics_info));
+    p_index_info->index_statistics_info = index_statistics_info;
+    unlock_index_node_cache(p_index_node_cache);
 }
 
-void free_index_element_resources(INDEX_ELEMENT_T *p_index_element)
+// Return the number of payloads in the posting list.
+uint32_t get_index_posting_list_length(INDEX_INFO_T *p_index_info, uint32_t head_tag)
 {
-    if (p_index_element->p_index_id != NULL)
+    uint32_t length = 0, tag = head_tag;
+
+    while (tag != 0)
     {
-        free(p_index_element->p_index_id);
-        p_index_element->p_index_id = NULL;
-    }
-}
+        INDEX_NODE_T *p_posting_node = fetch_index_node(p_index_info, tag);
 
-// Deep copy index element
-void deep_copy_index_element(INDEX_ELEMENT_T *p_dest_index_element, INDEX_ELEMENT_T *p_src_index_element, INDEX_ID_TYPE_E index_id_type)
-{
-    uint32_t index_id_size = Index_Id_Type_Get_Size(index_id_type);
+        if (p_posting_node == NULL)
+        {
+            break;
+        }
 
-    free_index_element_resources(p_dest_index_element);
-    allocate_index_element_resources(p_dest_index_element, index_id_type);
+        length += p_posting_node->length;
+        tag = p_posting_node->next_tag;
+        release_index_node(p_index_info, p_posting_node);
+    }
 
-    memcpy(p_dest_index_element->p_index_id, p_src_index_element->p_index_id, index_id_size);
-    memcpy(p_dest_index_element->index_payload, p_src_index_element->index_payload, INDEX_PAYLOAD_SIZE);
+    return length;
 }
 
-// Find the array position in the node where the new element should insert into.
-// Return the minimum element position where the value is equal or greater than the inputed value.
-uint32_t find_element_position_in_the_node(INDEX_NODE_T *p_index_node, INDEX_ELEMENT_T *p_index_element, INDEX_ID_TYPE_E index_id_type)
+// Scan the leaf nodes from the first one, the leaf nodes are latched in turn like the range search.
+// The elements are summarized by segments: each leaf node is a segment, and each element with a posting list is a segment by itself,
+// so a heavily duplicated index id gets its own buckets.
+void collect_index_statistics(INDEX_INFO_T *p_index_info, INDEX_STATISTICS_INFO_T *p_index_statistics_info)
 {
-    // binary search index_element position.
-    // find equal or upper bound (ceiling child_tag in the node)
-    uint32_t start = 0;
-    uint32_t end = p_index_node->length; // [start, end)
+    INDEX_ID_TYPE_E index_id_type = p_index_info->index_properties.index_id_type;
+    uint32_t index_id_size = Index_Id_Type_Get_Size(index_id_type);
+    INDEX_PATH_T index_path;
+    INDEX_NODE_T *p_index_node = NULL;
+    // The first and the last index ids, number of elements and number of the new index ids of each segment.
+    uint8_t *p_segment_bounds = NULL;
+    uint64_t *p_segment_element_nums = NULL, *p_segment_distinct_nums = NULL;
+    uint32_t segment_num = 0, segment_buffer_length = 0;
+    void *p_previous_index_id = NULL;
+    uint64_t previous_index_id_buffer[(INDEX_ID_MAX_SIZE + sizeof(uint64_t) - 1) / sizeof(uint64_t)]; // aligned for any index id type
+    bool is_scanning = true;
+
+    assert(index_id_size <= sizeof(previous_index_id_buffer));
+
+    index_path_init(&index_path, false);
+    if (descend_index_path(p_index_info, &index_path, NULL))
+    {
+        p_index_node = index_path.p_index_nodes[index_path.depth - 1];
+    }
 
-    while (start < end)
+    while (is_scanning && (p_index_node != NULL))
     {
-        uint32_t mid = start + ((end - start) / 2);
-        INDEX_ID_COMPARE_RESULT_E cmp_result = Index_Id_Type_Compare(index_id_type, p_index_element->p_index_id, p_index_node->elements[mid].p_index_id);
+        INDEX_NODE_T *p_next_index_node = NULL;
+        uint32_t next_tag = 0;
 
-        if (cmp_result == INDEX_ID_COMPARE_LEFT_GREATER)
+        for (uint32_t i = 0; is_scanning && (i < p_index_node->length); i++)
         {
-            // grater than [mid]
-            start = mid + 1;
+            void *p_index_id = get_index_node_index_id(p_index_node, i);
+            uint32_t posting_tag = get_index_node_posting_tag(p_index_node, i);
+
+            if ((i == 0) || (posting_tag != 0) || (get_index_node_posting_tag(p_index_node, i - 1) != 0))
+            {
+                if (segment_num == segment_buffer_length)
+                {
+                    uint32_t new_buffer_length = (segment_buffer_length == 0) ? (INDEX_STATISTICS_HISTOGRAM_BUCKET_NUM) : (segment_buffer_length * 2);
+                    uint8_t *p_new_bounds = realloc(p_segment_bounds, (size_t)new_buffer_length * index_id_size * 2);
+                    uint64_t *p_new_element_nums = NULL, *p_new_distinct_nums = NULL;
+
+                    p_segment_bounds = (p_new_bounds != NULL) ? (p_new_bounds) : (p_segment_bounds);
+                    p_new_element_nums = (p_new_bounds != NULL) ? realloc(p_segment_element_nums, sizeof(uint64_t) * new_buffer_length) : (NULL);
+                    p_segment_element_nums = (p_new_element_nums != NULL) ? (p_new_element_nums) : (p_segment_element_nums);
+                    p_new_distinct_nums = (p_new_element_nums != NULL) ? realloc(p_segment_distinct_nums, sizeof(uint64_t) * new_buffer_length) : (NULL);
+                    p_segment_distinct_nums = (p_new_distinct_nums != NULL) ? (p_new_distinct_nums) : (p_segment_distinct_nums);
+
+                    if (p_new_distinct_nums == NULL)
+                    {
+                        // allocate more memory error.
+                        // Error handling: build the statistics by the scanned segments.
+                        is_scanning = false;
+                        break;
+                    }
+                    segment_buffer_length = new_buffer_length;
+                }
+
+                memcpy(p_segment_bounds + ((size_t)index_id_size * segment_num * 2), p_index_id, index_id_size);
+                p_segment_element_nums[segment_num] = 0;
+                p_segment_distinct_nums[segment_num] = 0;
+                segment_num++;
+            }
+
+            memcpy(p_segment_bounds + ((size_t)index_id_size * ((segment_num * 2) - 1)), p_index_id, index_id_size);
+            p_segment_element_nums[segment_num - 1] += (posting_tag != 0) ? get_index_posting_list_length(p_index_info, posting_tag) : (1);
+            if ((p_previous_index_id == NULL) || (Index_Id_Type_Compare(index_id_type, p_index_id, p_previous_index_id) != INDEX_ID_COMPARE_EQUAL))
+            {
+                p_segment_distinct_nums[segment_num - 1]++;
+                memcpy(previous_index_id_buffer, p_index_id, index_id_size);
+                p_previous_index_id = previous_index_id_buffer;
+            }
         }
-        else
+
+        // The next node is latched before the current node is released, the leaf node of the path is released with the path.
+        next_tag = (is_scanning) ? (p_index_node->next_tag) : (0);
+        p_next_index_node = (next_tag != 0) ? fetch_and_latch_index_node(p_index_info, next_tag, false) : NULL;
+        if (p_index_node != index_path.p_index_nodes[0])
         {
-            // Smaller or equals to [mid]
-            end = mid;
+            unlatch_and_release_index_node(p_index_info, p_index_node);
         }
+        p_index_node = p_next_index_node;
+    }
+
+    if ((p_index_node != NULL) && (p_index_node != index_path.p_index_nodes[0]))
+    {
+        unlatch_and_release_index_node(p_index_info, p_index_node);
     }
-    assert((start == end) && (start <= p_index_node->length));
-    return start;
+    release_index_path(p_index_info, &index_path);
+
+    build_index_statistics_histogram(p_index_statistics_info, index_id_size, p_segment_bounds, p_segment_element_nums, p_segment_distinct_nums, segment_num);
+    p_index_statistics_info->is_collected = true;
+
+    free(p_segment_bounds);
+    free(p_segment_element_nums);
+    free(p_segment_distinct_nums);
 }
 
-void split_index_elements_into_two_index_node(INDEX_ELEMENT_T *p_index_element_buffer, uint32_t index_element_buffer_length, INDEX_NODE_T *p_index_node_current, INDEX_NODE_T *p_index_node_sibling)
+// Group the segments in order into at most INDEX_STATISTICS_HISTOGRAM_BUCKET_NUM buckets of about the same number of elements.
+// A bucket starts at the first segment after the previous buckets hold their share of the elements, or at a segment larger than a share.
+void build_index_statistics_histogram(INDEX_STATISTICS_INFO_T *p_index_statistics_info, uint32_t index_id_size, uint8_t *p_segment_bounds, uint64_t *p_segment_element_nums, uint64_t *p_segment_distinct_nums, uint32_t segment_num)
 {
-    assert(index_element_buffer_length <= (2 * INDEX_ORDER));
-
-    uint32_t start_position, copy_length;
-    bool is_leaf_node = (p_index_node_current->child_tag[0] == 0) ? true : false;
+    INDEX_STATISTICS_T *p_index_statistics = &(p_index_statistics_info->statistics);
+    uint32_t max_bucket_num = (segment_num < INDEX_STATISTICS_HISTOGRAM_BUCKET_NUM) ? (segment_num) : (INDEX_STATISTICS_HISTOGRAM_BUCKET_NUM);
+    uint32_t bucket_num = 0;
+    uint64_t scanned_element_num = 0;
 
-    // Copy first half of index elements into current node.
-    start_position = 0;
-    copy_length = index_element_buffer_length / 2;
-    // p_index_id: shallow copy
-    memcpy(p_index_node_current->elements, p_index_element_buffer, sizeof(INDEX_ELEMENT_T) * copy_length);
-    for (uint32_t i = copy_length; i < INDEX_ORDER; i++)
+    for (uint32_t i = 0; i < segment_num; i++)
     {
-        p_index_node_current->elements[i].p_index_id = NULL;
-        memset(p_index_node_current->elements[i].index_payload, 0, INDEX_PAYLOAD_SIZE);
+        p_index_statistics->element_num += p_segment_element_nums[i];
+        p_index_statistics->distinct_num += p_segment_distinct_nums[i];
     }
-    // TODO: Set the unused index elements into default value.
-    p_index_node_current->length = copy_length;
 
-    // Copy second half of index elements into the sibling node.
-    if (is_leaf_node)
+    if (max_bucket_num == 0)
     {
-        start_position = copy_length;
-        copy_length = index_element_buffer_length - copy_length;
+        return;
     }
-    else
+
+    p_index_statistics_info->p_bucket_bounds = malloc((size_t)index_id_size * max_bucket_num * 2);
+    p_index_statistics_info->p_bucket_element_nums = malloc(sizeof(uint64_t) * max_bucket_num);
+    p_index_statistics_info->p_bucket_distinct_nums = malloc(sizeof(uint64_t) * max_bucket_num);
+    if ((p_index_statistics_info->p_bucket_bounds == NULL) || (p_index_statistics_info->p_bucket_element_nums == NULL) || (p_index_statistics_info->p_bucket_distinct_nums == NULL))
     {
-        // If current node and sibling node are not leaf nodes, it doesn't need to copy the [mid] element to sibling node.
-        // The [mid] element should be inserted to parent node.
-        start_position = copy_length + 1;
-        copy_length = index_element_buffer_length - copy_length - 1;
+        // Error handling: the statistics have no histogram.
+        free(p_index_statistics_info->p_bucket_bounds);
+        free(p_index_statistics_info->p_bucket_element_nums);
+        free(p_index_statistics_info->p_bucket_distinct_nums);
+        p_index_statistics_info->p_bucket_bounds = NULL;
+        p_index_statistics_info->p_bucket_element_nums = NULL;
+        p_index_statistics_info->p_bucket_distinct_nums = NULL;
+        return;
     }
-    // p_index_id: shallow copy
-    memcpy(p_index_node_sibling->elements, &(p_index_element_buffer[start_position]), sizeof(INDEX_ELEMENT_T) * copy_length);
-    for (uint32_t i = copy_length; i < INDEX_ORDER; i++)
+
+    for (uint32_t i = 0; i < segment_num; i++)
     {
-        p_index_node_sibling->elements[i].p_index_id = NULL;
-        memset(p_index_node_sibling->elements[i].index_payload, 0, INDEX_PAYLOAD_SIZE);
-    }
-    // Set unused elements into default value.
-    p_index_node_sibling->length = copy_length;
-}
+        bool is_share_scanned = ((scanned_element_num * max_bucket_num) >= (p_index_statistics->element_num * bucket_num));
+        bool is_large_segment = ((p_segment_element_nums[i] * max_bucket_num) >= p_index_statistics->element_num);
 
-void split_child_tags_into_two_index_node(INDEX_INFO_T *p_index_info, uint32_t *p_child_tag_buffer, uint32_t child_tag_buffer_length, INDEX_NODE_T *p_index_node_current, INDEX_NODE_T *p_index_node_sibling)
-{
-    uint32_t first_half_length = (child_tag_buffer_length / 2) + (child_tag_buffer_length % 2);
-    uint32_t second_half_length = child_tag_buffer_length - first_half_length;
-    INDEX_NODE_T second_half_child_index_node;
+        if ((bucket_num == 0) || ((bucket_num < max_bucket_num) && (is_share_scanned || is_large_segment)))
+        {
+            memcpy(p_index_statistics_info->p_bucket_bounds + ((size_t)index_id_size * bucket_num * 2), p_segment_bounds + ((size_t)index_id_size * i * 2), index_id_size);
+            p_index_statistics_info->p_bucket_element_nums[bucket_num] = 0;
+            p_index_statistics_info->p_bucket_distinct_nums[bucket_num] = 0;
+            bucket_num++;
+        }
 
-    // Copy first half of child tags to current node.
-    memcpy(p_index_node_current->child_tag, p_child_tag_buffer, sizeof(uint32_t) * first_half_length);
-    // Copy second half of child tags to sibling node.
-    memcpy(p_index_node_sibling->child_tag, &(p_child_tag_buffer[first_half_length]), sizeof(uint32_t) * second_half_length);
-    // update the parent tag of the second half child nodes to sibling node tag.
-    for (uint32_t i = 0; i < second_half_length; i++)
-    {
-        index_node_init(&second_half_child_index_node, p_index_node_sibling->child_tag[i]);
-        read_index_node(p_index_info, p_index_node_sibling->child_tag[i], &second_half_child_index_node);
-        second_half_child_index_node.parent_tag = p_index_node_sibling->tag;
-        write_index_node(p_index_info, &second_half_child_index_node);
-        free_index_node_resources(&second_half_child_index_node);
+        memcpy(p_index_statistics_info->p_bucket_bounds + ((size_t)index_id_size * ((bucket_num * 2) - 1)), p_segment_bounds + ((size_t)index_id_size * ((i * 2) + 1)), index_id_size);
+        p_index_statistics_info->p_bucket_element_nums[bucket_num - 1] += p_segment_element_nums[i];
+        p_index_statistics_info->p_bucket_distinct_nums[bucket_num - 1] += p_segment_distinct_nums[i];
+        scanned_element_num += p_segment_element_nums[i];
     }
+
+    p_index_statistics->histogram_bucket_num = bucket_num;
 }
 
-void insert_index_element_handler(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node, INDEX_ELEMENT_T *p_index_element, uint32_t new_child_tag)
+// Scan the buckets of the hash index, the equal index ids are always in the same bucket.
+// The index ids of each bucket are sorted to count the distinct ones.
+void collect_hash_index_statistics(INDEX_INFO_T *p_index_info, INDEX_STATISTICS_INFO_T *p_index_statistics_info)
 {
     INDEX_ID_TYPE_E index_id_type = p_index_info->index_properties.index_id_type;
-    uint32_t position = find_element_position_in_the_node(p_index_node, p_index_element, index_id_type);
-    uint32_t tag_position = position + 1;
-    INDEX_PROPERTIES_T *p_index_properties = &(p_index_info->index_properties);
+    uint32_t index_id_size = Index_Id_Type_Get_Size(index_id_type);
+    INDEX_STATISTICS_T *p_index_statistics = &(p_index_statistics_info->statistics);
+    INDEX_NODE_T *p_root_directory_node = fetch_index_node(p_index_info, p_index_info->index_properties.root_tag);
+    uint8_t *p_index_ids = NULL;
+    uint32_t *p_positions = NULL;
+    uint32_t buffer_length = 0;
+
+    p_index_statistics_info->is_collected = true;
+    if (p_root_directory_node == NULL)
+    {
+        return;
+    }
 
-    if (p_index_node->length >= INDEX_ORDER)
+    for (uint32_t bucket = 0; bucket < p_root_directory_node->length; bucket++)
     {
-        // index node is full.
-        // split current node into two nodes and insert the [INDEX_ORDER / 2] element to the parent node.
-        INDEX_NODE_T parent_node, new_sibling_node;
-        INDEX_ELEMENT_T index_elements_buffer[INDEX_ORDER + 1];
-        uint32_t child_tags_buffer[INDEX_CHILD_TAG_ORDER + 1];
-        uint32_t mid_position = (INDEX_ORDER + 1) / 2;
-        bool is_leaf_node = (p_index_node->child_tag[0] == 0) ? true : false;
+        INDEX_NODE_T *p_index_node = fetch_index_node(p_index_info, get_hash_index_bucket_tag(p_index_info, p_root_directory_node, bucket));
+        uint32_t element_num = 0;
 
-        // init buffers
-        for (uint32_t i = 0; i < INDEX_ORDER + 1; i++)
+        while (p_index_node != NULL)
         {
-            index_element_init(&(index_elements_buffer[i]));
+            uint32_t next_tag = p_index_node->next_tag;
+
+            if (element_num + p_index_node->length > buffer_length)
+            {
+                uint32_t new_buffer_length = element_num + p_index_node->length + buffer_length;
+                uint8_t *p_new_index_ids = realloc(p_index_ids, (size_t)new_buffer_length * index_id_size);
+                uint32_t *p_new_positions = (p_new_index_ids != NULL) ? realloc(p_positions, sizeof(uint32_t) * new_buffer_length) : (NULL);
+
+                p_index_ids = (p_new_index_ids != NULL) ? (p_new_index_ids) : (p_index_ids);
+                p_positions = (p_new_positions != NULL) ? (p_new_positions) : (p_positions);
+                if (p_new_positions == NULL)
+                {
+                    // allocate more memory error.
+                    // Error handling: count the elements of the bucket as distinct index ids.
+                    p_index_statistics->element_num += p_index_node->length;
+                    p_index_statistics->distinct_num += p_index_node->length;
+                    release_index_node(p_index_info, p_index_node);
+                    p_index_node = (next_tag != 0) ? fetch_index_node(p_index_info, next_tag) : NULL;
+                    continue;
+                }
+                buffer_length = new_buffer_length;
+            }
+
+            memcpy(p_index_ids + ((size_t)index_id_size * element_num), p_index_node->p_index_ids, (size_t)index_id_size * p_index_node->length);
+            element_num += p_index_node->length;
+
+            release_index_node(p_index_info, p_index_node);
+            p_index_node = (next_tag != 0) ? fetch_index_node(p_index_info, next_tag) : NULL;
         }
-        for (uint32_t i = 0; i < INDEX_CHILD_TAG_ORDER + 1; i++)
+
+        for (uint32_t i = 0; i < element_num; i++)
         {
-            child_tags_buffer[i] = 0;
+            p_positions[i] = i;
         }
+        sort_index_element_positions(p_positions, element_num, p_index_ids, index_id_type);
 
-        // insert the current node and the new element into buffer by order.
-        if (position > 0)
+        for (uint32_t i = 0; i < element_num; i++)
         {
-            // p_index_id: shallow copy
-            memcpy(index_elements_buffer, &(p_index_node->elements[0]), sizeof(INDEX_ELEMENT_T) * position);
+            if ((i == 0) || (Index_Id_Type_Compare(index_id_type, p_index_ids + ((size_t)index_id_size * p_positions[i]), p_index_ids + ((size_t)index_id_size * p_positions[i - 1])) != INDEX_ID_COMPARE_EQUAL))
+            {
+                p_index_statistics->distinct_num++;
+            }
         }
-        // deep copy the inserted element.
-        deep_copy_index_element(&(index_elements_buffer[position]), p_index_element, p_index_properties->index_id_type);
-        if (position < INDEX_ORDER)
+        p_index_statistics->element_num += element_num;
+    }
+
+    release_index_node(p_index_info, p_root_directory_node);
+    free(p_index_ids);
+    free(p_positions);
+}
+
+// Estimate the number of the collected elements whose index ids are in [lower, upper], NULL bound means unbounded.
+// The buckets covered by the range are counted entirely, the bucket partially covered by an equal range counts its average elements per index id,
+// and the bucket partially covered by other ranges counts half of its elements.
+// A hash index has no histogram, it estimates the equal range by the average elements per index id.
+uint64_t estimate_index_statistics_range(INDEX_INFO_T *p_index_info, void *p_lower_index_id, void *p_upper_index_id)
+{
+    INDEX_NODE_CACHE_T *p_index_node_cache = &(p_index_info->index_node_cache);
+    INDEX_STATISTICS_INFO_T *p_index_statistics_info = &(p_index_info->index_statistics_info);
+    INDEX_ID_TYPE_E index_id_type = p_index_info->index_properties.index_id_type;
+    uint32_t index_id_size = Index_Id_Type_Get_Size(index_id_type);
+    bool is_equal = (p_lower_index_id != NULL) && (p_upper_index_id != NULL) && (Index_Id_Type_Compare(index_id_type, p_lower_index_id, p_upper_index_id) == INDEX_ID_COMPARE_EQUAL);
+    uint64_t estimated_num = 0;
+
+    lock_index_node_cache(p_index_node_cache);
+
+    if (p_index_info->index_properties.index_structure == INDEX_STRUCTURE_HASH)
+    {
+        if (is_equal && (p_index_statistics_info->statistics.distinct_num > 0))
         {
-            // p_index_id: shallow copy
-            memcpy(&(index_elements_buffer[position + 1]), &(p_index_node->elements[position]), sizeof(INDEX_ELEMENT_T) * (INDEX_ORDER - position));
+            estimated_num = p_index_statistics_info->statistics.element_num / p_index_statistics_info->statistics.distinct_num;
         }
+    }
 
-        // Insert the current child tags and new_child_tag into buffer by order.
-        // new_child_tag is the child tag that greater than the inputted element.
-        if (tag_position > 0)
+    for (uint32_t i = 0; i < p_index_statistics_info->statistics.histogram_bucket_num; i++)
+    {
+        void *p_bucket_lower_index_id = p_index_statistics_info->p_bucket_bounds + ((size_t)index_id_size * i * 2);
+        void *p_bucket_upper_index_id = p_index_statistics_info->p_bucket_bounds + ((size_t)index_id_size * ((i * 2) + 1));
+        uint64_t bucket_element_num = p_index_statistics_info->p_bucket_element_nums[i];
+        uint64_t bucket_distinct_num = p_index_statistics_info->p_bucket_distinct_nums[i];
+
+        if ((p_upper_index_id != NULL) && (Index_Id_Type_Compare(index_id_type, p_bucket_lower_index_id, p_upper_index_id) == INDEX_ID_COMPARE_LEFT_GREATER))
         {
-            memcpy(child_tags_buffer, &(p_index_node->child_tag[0]), sizeof(uint32_t) * tag_position);
+            break;
         }
-        child_tags_buffer[tag_position] = new_child_tag;
-        if (tag_position < INDEX_CHILD_TAG_ORDER)
+        if ((p_lower_index_id != NULL) && (Index_Id_Type_Compare(index_id_type, p_lower_index_id, p_bucket_upper_index_id) == INDEX_ID_COMPARE_LEFT_GREATER))
         {
-            memcpy(&(child_tags_buffer[tag_position + 1]), &(p_index_node->child_tag[tag_position]), sizeof(uint32_t) * (INDEX_CHILD_TAG_ORDER - tag_position));
+            continue;
         }
 
-        // Create and initialize the sibling Node
-        p_index_properties->tag_num++;
-        index_node_init(&new_sibling_node, p_index_properties->tag_num);
-        new_sibling_node.level = p_index_node->level;
-        new_sibling_node.parent_tag = p_index_node->parent_tag;
-        new_sibling_node.next_tag = p_index_node->next_tag;
-        p_index_node->next_tag = new_sibling_node.tag;
-
-        // Create or load parent node.
-        if (p_index_node->parent_tag == 0)
+        if (((p_lower_index_id == NULL) || (Index_Id_Type_Compare(index_id_type, p_lower_index_id, p_bucket_lower_index_id) != INDEX_ID_COMPARE_LEFT_GREATER)) &&
+            ((p_upper_index_id == NULL) || (Index_Id_Type_Compare(index_id_type, p_bucket_upper_index_id, p_upper_index_id) != INDEX_ID_COMPARE_LEFT_GREATER)))
         {
-            // no parent node, create a new one.
-            p_index_properties->tag_num++;
-            index_node_init(&parent_node, p_index_properties->tag_num);
-            parent_node.child_tag[0] = p_index_node->tag;
-            parent_node.level = p_index_node->level + 1;
-            p_index_properties->root_tag = parent_node.tag;
-
-            p_index_node->parent_tag = parent_node.tag;
-            new_sibling_node.parent_tag = parent_node.tag;
+            estimated_num += bucket_element_num;
         }
-        else
+        else if (is_equal)
         {
-            index_node_init(&parent_node, p_index_node->parent_tag);
-            read_index_node(p_index_info, p_index_node->parent_tag, &parent_node);
+            // The bucket continuing the index id of the previous bucket may have no new index id.
+            estimated_num += bucket_element_num / ((bucket_distinct_num > 0) ? (bucket_distinct_num) : (1));
         }
-
-        // Insert first half of the elements in the buffer into current node and insert the second half of the elements into sibling node.
-        // If the current node is a leaf node, copy the [mid] element to new sibling node to keep it in the leaf.
-        // If current node is not a leaf node, we don't have to keep it in any node in the current node level.
-        split_index_elements_into_two_index_node(index_elements_buffer, INDEX_ORDER + 1, p_index_node, &new_sibling_node);
-        // Because all the child tag in the leaef node is 0, no need to set non-0 value to them.
-        if (is_leaf_node == false)
+        else
         {
-            split_child_tags_into_two_index_node(p_index_info, child_tags_buffer, INDEX_CHILD_TAG_ORDER + 1, p_index_node, &new_sibling_node);
+            estimated_num += bucket_element_num / 2;
         }
+    }
 
-        // write sibling node into file
-        write_index_node(p_index_info, &new_sibling_node);
+    unlock_index_node_cache(p_index_node_cache);
 
-        // write current node into file.
-        write_index_node(p_index_info, p_index_node);
+    return estimated_num;
+}
 
-        // TODO: update index properties only when close index.
-        write_index_properties(p_index_info);
+// Hash index (linear hashing):
+// The root node is the root directory, its length is the number of buckets and child_tag[] are the tags of the directory nodes.
+// child_tag[] of each directory node are the tags of the primary bucket nodes, its length is the number of the buckets it holds.
+// A bucket is a chain of bucket nodes linked by next_tag, the elements are appended to the last node by insertion order.
+// The bucket which is pointed by the split pointer is split into itself and a new bucket whenever an overflow node is created.
 
-        // Insert the [mid] element to the parent node.
-        insert_index_element_handler(p_index_info, &parent_node, &(index_elements_buffer[mid_position]), new_sibling_node.tag);
-        // the above function will write parent node into file.
+// Initialize the first node as the root directory, and write the first directory node and the first bucket node.
+void create_new_hash_index_nodes(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_root_directory_node)
+{
+    INDEX_PROPERTIES_T *p_index_properties = &(p_index_info->index_properties);
+    INDEX_NODE_T directory_node, bucket_node;
 
-        // free resources of sibling, parnet node, and [mid] element if current node is not a leaf node.
-        free_index_node_resources(&new_sibling_node);
-        free_index_node_resources(&parent_node);
-        // If current node is not a leaf node, the [mid] element would not existed in the current node or the sibling node.
-        // And the resource would not be freed.
-        if (is_leaf_node == false)
-        {
-            free_index_element_resources(&(index_elements_buffer[mid_position]));
-        }
+    index_node_init(&directory_node, ++(p_index_properties->tag_num), p_index_properties);
+    index_node_init(&bucket_node, ++(p_index_properties->tag_num), p_index_properties);
+
+    p_root_directory_node->level = INDEX_HASH_ROOT_DIRECTORY_LEVEL;
+    p_root_directory_node->length = 1;
+    p_root_directory_node->child_tag[0] = directory_node.tag;
+
+    directory_node.level = INDEX_HASH_DIRECTORY_LEVEL;
+    directory_node.length = 1;
+    directory_node.child_tag[0] = bucket_node.tag;
+
+    bucket_node.level = INDEX_HASH_BUCKET_LEVEL;
+
+    write_index_node(p_index_info, &directory_node);
+    write_index_node(p_index_info, &bucket_node);
+
+    free_index_node_resources(&directory_node);
+    free_index_node_resources(&bucket_node);
+}
+
+static inline uint64_t get_hash_index_id_hash(INDEX_INFO_T *p_index_info, void *p_index_id)
+{
+    INDEX_ID_TYPE_E index_id_type = p_index_info->index_properties.index_id_type;
+    uint64_t index_id_buffer[(INDEX_ID_MAX_SIZE + sizeof(uint64_t) - 1) / sizeof(uint64_t)]; // aligned for any index id type
+    uint32_t index_id_size = Index_Id_Type_Get_Size(index_id_type);
+
+    assert(index_id_size <= sizeof(index_id_buffer));
+    memcpy(index_id_buffer, p_index_id, index_id_size);
+
+    // -0.0 is equal to 0.0, they should be in the same bucket.
+    if ((index_id_type == INDEX_ID_TYPE_FLOAT) && (*(float *)index_id_buffer == 0.0f))
+    {
+        *(float *)index_id_buffer = 0.0f;
     }
-    else
+    else if ((index_id_type == INDEX_ID_TYPE_DOUBLE) && (*(double *)index_id_buffer == 0.0))
     {
-        // index_node isn't full
-        // insertion sort
-        for (uint32_t i = p_index_node->length; i > position; i--)
-        {
-            void *temp_ptr = NULL;
+        *(double *)index_id_buffer = 0.0;
+    }
 
-            // move the elements in the node which greater than the inserted element to the next position in the array.
-            // swap dynamic resources (malloc): p_index_id.
-            temp_ptr = p_index_node->elements[i].p_index_id;
-            p_index_node->elements[i].p_index_id = p_index_node->elements[i - 1].p_index_id;
-            p_index_node->elements[i - 1].p_index_id = temp_ptr;
-            // copy static resources: index_payload.
-            memcpy(&(p_index_node->elements[i].index_payload), &(p_index_node->elements[i - 1].index_payload), INDEX_PAYLOAD_SIZE);
-            // move child_tags
-            p_index_node->child_tag[i + 1] = p_index_node->child_tag[i];
-        }
-        // deep copy inserted index element
-        deep_copy_index_element(&(p_index_node->elements[position]), p_index_element, p_index_properties->index_id_type);
-        p_index_node->child_tag[tag_position] = new_child_tag;
-        p_index_node->length++;
+    return Hash64((uint8_t *)index_id_buffer, index_id_size);
+}
+
+// Address the hash value by the lower bits, the buckets behind the split pointer use one more bit.
+static inline uint32_t get_hash_index_bucket(uint32_t bucket_num, uint64_t hash_value)
+{
+    uint32_t mask = 1;
+    uint32_t bucket = 0;
+
+    while (mask < bucket_num)
+    {
+        mask <<= 1;
+    }
+    mask--;
 
-        // write current node into file.
-        write_index_node(p_index_info, p_index_node);
+    bucket = (uint32_t)(hash_value & mask);
+    if (bucket >= bucket_num)
+    {
+        bucket &= (mask >> 1);
     }
+
+    return bucket;
 }
 
-void insert_index_element(INDEX_INFO_T *p_index_info, uint32_t tag, INDEX_ELEMENT_T *p_index_element)
+// The root directory holds (order + 1) directory nodes and each of them holds (order + 1) buckets.
+// The buckets are not split anymore after the number reaches the limit, the chains grow instead.
+static inline uint32_t get_hash_index_max_bucket_num(uint32_t order)
 {
-    INDEX_NODE_T index_node;
-    index_node_init(&index_node, tag);
+    return (order + 1) * (order + 1);
+}
 
-    if (read_index_node(p_index_info, tag, &index_node) == false)
+uint32_t get_hash_index_bucket_tag(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_root_directory_node, uint32_t bucket)
+{
+    uint32_t directory_capacity = p_index_info->index_properties.order + 1;
+    INDEX_NODE_T *p_directory_node = fetch_index_node(p_index_info, p_root_directory_node->child_tag[bucket / directory_capacity]);
+    uint32_t bucket_tag = 0;
+
+    if (p_directory_node != NULL)
     {
-        return;
+        bucket_tag = p_directory_node->child_tag[bucket % directory_capacity];
+        release_index_node(p_index_info, p_directory_node);
     }
 
-    // Check if the leaf node existed or not by child_tag[0], and process if reached leaf node.
-    if (index_node.child_tag[0] != 0)
+    return bucket_tag;
+}
+
+// Append the element to the last node of the bucket.
+// Return true if a new overflow node is created for the element.
+bool append_hash_index_element(INDEX_INFO_T *p_index_info, uint32_t bucket_tag, void *p_index_id, void *p_payload)
+{
+    INDEX_NODE_T *p_index_node = fetch_index_node(p_index_info, bucket_tag);
+    bool is_overflowed = false;
+
+    if (p_index_node == NULL)
     {
-        // Current node is not a leaf node.
-        // find the insert position (and also the child_tag position).
-        // Position is in the range of [0, index_node.length].
-        INDEX_ID_TYPE_E index_id_type = p_index_info->index_properties.index_id_type;
-        uint32_t position = find_element_position_in_the_node(&index_node, p_index_element, index_id_type);
-        insert_index_element(p_index_info, index_node.child_tag[position], p_index_element);
+        return false;
     }
-    else
+
+    while (p_index_node->next_tag != 0)
+    {
+        uint32_t next_tag = p_index_node->next_tag;
+
+        release_index_node(p_index_info, p_index_node);
+        p_index_node = fetch_index_node(p_index_info, next_tag);
+    }
+
+    if (p_index_node->length == p_index_node->order)
     {
-        // Current node is a leaf node.
-        insert_index_element_handler(p_index_info, &index_node, p_index_element, 0);
+        INDEX_NODE_T *p_overflow_node = create_index_node(p_index_info);
+
+        p_overflow_node->level = INDEX_HASH_BUCKET_LEVEL;
+        p_index_node->next_tag = p_overflow_node->tag;
+        mark_index_node_dirty(p_index_info, p_index_node);
+        release_index_node(p_index_info, p_index_node);
+
+        p_index_node = p_overflow_node;
+        is_overflowed = true;
     }
 
-    free_index_node_resources(&index_node);
+    set_index_node_element(p_index_node, p_index_node->length, p_index_id, p_payload, INDEX_PAYLOAD_SIZE);
+    p_index_node->length++;
+    mark_index_node_dirty(p_index_info, p_index_node);
+    release_index_node(p_index_info, p_index_node);
+
+    return is_overflowed;
 }
 
-void *search_index_element(INDEX_INFO_T *p_index_info, uint32_t tag, INDEX_ELEMENT_T *p_target_index_element, uint32_t *result_length)
+void insert_hash_index_element(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_index_element)
 {
-    INDEX_NODE_T index_node;
-    index_node_init(&index_node, tag);
+    INDEX_NODE_T *p_root_directory_node = fetch_index_node(p_index_info, p_index_info->index_properties.root_tag);
+    uint32_t bucket = 0;
 
-    if (read_index_node(p_index_info, tag, &index_node) == false)
+    if (p_root_directory_node == NULL)
     {
-        *result_length = 0;
-        return NULL;
+        return;
+    }
+
+    bucket = get_hash_index_bucket(p_root_directory_node->length, get_hash_index_id_hash(p_index_info, p_index_element->p_index_id));
+    if (append_hash_index_element(p_index_info, get_hash_index_bucket_tag(p_index_info, p_root_directory_node, bucket), p_index_element->p_index_id, p_index_element->index_payload) &&
+        (p_root_directory_node->length < get_hash_index_max_bucket_num(p_index_info->index_properties.order)))
+    {
+        split_hash_index_bucket(p_index_info, p_root_directory_node);
     }
 
-    if (index_node.child_tag[0] != 0)
+    release_index_node(p_index_info, p_root_directory_node);
+}
+
+// Add a new bucket and move the elements of the bucket pointed by the split pointer which belong to the new bucket.
+// The remaining elements are compacted in place by their order, and the emptied overflow nodes are detached (their tags are not reused).
+void split_hash_index_bucket(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_root_directory_node)
+{
+    uint32_t directory_capacity = p_index_info->index_properties.order + 1;
+    uint32_t new_bucket = p_root_directory_node->length;
+    uint32_t split_bucket = new_bucket;
+    uint32_t new_bucket_tag = 0, split_bucket_tag = 0, keep_position = 0;
+    INDEX_NODE_T *p_directory_node = NULL, *p_new_bucket_node = NULL, *p_keep_node = NULL, *p_index_node = NULL;
+
+    // The split pointer is the number of buckets minus the highest power of 2 which isn't greater than it.
+    while ((split_bucket & (split_bucket - 1)) != 0)
+    {
+        split_bucket &= (split_bucket - 1);
+    }
+    split_bucket = new_bucket - split_bucket;
+    split_bucket_tag = get_hash_index_bucket_tag(p_index_info, p_root_directory_node, split_bucket);
+
+    // Register the new bucket into the directory.
+    p_new_bucket_node = create_index_node(p_index_info);
+    p_new_bucket_node->level = INDEX_HASH_BUCKET_LEVEL;
+    new_bucket_tag = p_new_bucket_node->tag;
+    if ((new_bucket % directory_capacity) == 0)
     {
-        // non-leaf
-        INDEX_ID_TYPE_E index_id_type = p_index_info->index_properties.index_id_type;
-        uint32_t position = find_element_position_in_the_node(&index_node, p_target_index_element, index_id_type);
-        return search_index_element(p_index_info, index_node.child_tag[position], p_target_index_element, result_length);
+        p_directory_node = create_index_node(p_index_info);
+        p_directory_node->level = INDEX_HASH_DIRECTORY_LEVEL;
+        p_root_directory_node->child_tag[new_bucket / directory_capacity] = p_directory_node->tag;
     }
     else
     {
-        // leaf-node
-        return search_index_element_handler(p_index_info, &index_node, p_target_index_element, result_length);
+        p_directory_node = fetch_index_node(p_index_info, p_root_directory_node->child_tag[new_bucket / directory_capacity]);
+    }
+    p_directory_node->child_tag[new_bucket % directory_capacity] = new_bucket_tag;
+    p_directory_node->length++;
+    mark_index_node_dirty(p_index_info, p_directory_node);
+    release_index_node(p_index_info, p_directory_node);
+    release_index_node(p_index_info, p_new_bucket_node);
+
+    p_root_directory_node->length++;
+    mark_index_node_dirty(p_index_info, p_root_directory_node);
+
+    // Redistribute the elements of the split bucket.
+    p_keep_node = fetch_index_node(p_index_info, split_bucket_tag);
+    p_index_node = fetch_index_node(p_index_info, split_bucket_tag);
+    while (p_index_node != NULL)
+    {
+        uint32_t next_tag = p_index_node->next_tag;
+
+        for (uint32_t i = 0; i < p_index_node->length; i++)
+        {
+            void *p_index_id = get_index_node_index_id(p_index_node, i);
+            uint8_t *p_payload = get_index_node_payload(p_index_node, i);
+
+            if (get_hash_index_bucket(p_root_directory_node->length, get_hash_index_id_hash(p_index_info, p_index_id)) == new_bucket)
+            {
+                append_hash_index_element(p_index_info, new_bucket_tag, p_index_id, p_payload);
+                continue;
+            }
+
+            // The kept elements never pass the read position, move to the next node only when the current one is full.
+            if (keep_position == p_keep_node->order)
+            {
+                uint32_t keep_next_tag = p_keep_node->next_tag;
+
+                p_keep_node->length = keep_position;
+                mark_index_node_dirty(p_index_info, p_keep_node);
+                release_index_node(p_index_info, p_keep_node);
+                p_keep_node = fetch_index_node(p_index_info, keep_next_tag);
+                keep_position = 0;
+            }
+            if ((p_keep_node != p_index_node) || (keep_position != i))
+            {
+                set_index_node_element(p_keep_node, keep_position, p_index_id, p_payload, INDEX_PAYLOAD_SIZE);
+            }
+            keep_position++;
+        }
+
+        release_index_node(p_index_info, p_index_node);
+        p_index_node = (next_tag != 0) ? fetch_index_node(p_index_info, next_tag) : NULL;
     }
 
-    free_index_node_resources(&index_node);
+    // Clear the moved elements and detach the nodes behind the last kept node.
+    for (uint32_t i = keep_position; i < p_keep_node->length; i++)
+    {
+        memset(get_index_node_index_id(p_keep_node, i), 0, p_keep_node->index_id_size);
+        memset(get_index_node_payload(p_keep_node, i), 0, INDEX_PAYLOAD_SIZE);
+    }
+    p_keep_node->length = keep_position;
+    p_keep_node->next_tag = 0;
+    mark_index_node_dirty(p_index_info, p_keep_node);
+    release_index_node(p_index_info, p_keep_node);
 }
 
-uint8_t *search_index_element_handler(INDEX_INFO_T *p_index_info, INDEX_NODE_T *p_index_node, INDEX_ELEMENT_T *p_target_index_element, uint32_t *result_length)
+uint8_t *search_hash_index_element(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_target_index_element, uint32_t *result_length)
 {
-    uint8_t *p_search_result = NULL;
     INDEX_ID_TYPE_E index_id_type = p_index_info->index_properties.index_id_type;
-    uint32_t position = find_element_position_in_the_node(p_index_node, p_target_index_element, index_id_type);
-    uint32_t compare_equal_length = 0, i = 0, match_end_position = 0;
-    bool only_current_node_result = true;
+    INDEX_NODE_T *p_root_directory_node = fetch_index_node(p_index_info, p_index_info->index_properties.root_tag);
+    INDEX_NODE_T *p_index_node = NULL;
+    uint8_t *p_search_result = NULL;
+    uint32_t search_result_length = 0, search_result_buffer_length = 0;
+    bool is_searching = true;
 
-    for (i = position; i < p_index_node->length; i++)
+    *result_length = 0;
+    if (p_root_directory_node == NULL)
     {
-        if (Index_Id_Type_Compare(index_id_type, p_target_index_element->p_index_id, p_index_node->elements[i].p_index_id) == INDEX_ID_COMPARE_EQUAL)
-        {
-            match_end_position = i;
-            compare_equal_length++;
-        }
-        else
-        {
-            break;
-        }
+        return NULL;
     }
 
-    if ((i == p_index_node->length) && (p_index_node->next_tag != 0))
-    {
-        // The target node may also existed in the next node, search next node.
-        INDEX_NODE_T next_index_node;
-        uint8_t *next_index_node_search_result = NULL;
+    p_index_node = fetch_index_node(p_index_info,
+                                    get_hash_index_bucket_tag(p_index_info, p_root_directory_node, get_hash_index_bucket(p_root_directory_node->length, get_hash_index_id_hash(p_index_info, p_target_index_element->p_index_id))));
+    release_index_node(p_index_info, p_root_directory_node);
 
-        index_node_init(&next_index_node, p_index_node->next_tag);
+    while (is_searching && (p_index_node != NULL))
+    {
+        uint32_t next_tag = 0;
 
-        if (read_index_node(p_index_info, p_index_node->next_tag, &next_index_node) == true)
+        for (uint32_t i = 0; i < p_index_node->length; i++)
         {
-            next_index_node_search_result = search_index_element_handler(p_index_info, &next_index_node, p_target_index_element, result_length);
-            compare_equal_length += *result_length;
-            p_search_result = realloc(next_index_node_search_result, compare_equal_length * INDEX_PAYLOAD_SIZE);
-            if (p_search_result == NULL)
+            if (Index_Id_Type_Compare(index_id_type, p_target_index_element->p_index_id, get_index_node_index_id(p_index_node, i)) != INDEX_ID_COMPARE_EQUAL)
             {
-                // allocate more memory error.
-                // Error handling: return next search result, and doesn't attach current result.
-                return next_index_node_search_result;
+                continue;
             }
-            only_current_node_result = false;
-        }
-        else
-        {
-            // read next node error
-            only_current_node_result = true;
+
+            if (search_result_length == search_result_buffer_length)
+            {
+                uint32_t new_buffer_length = (search_result_buffer_length == 0) ? (p_index_node->length) : (search_result_buffer_length * 2);
+                uint8_t *p_new_search_result = realloc(p_search_result, new_buffer_length * INDEX_PAYLOAD_SIZE);
+                if (p_new_search_result == NULL)
+                {
+                    // allocate more memory error.
+                    // Error handling: return the collected results.
+                    is_searching = false;
+                    break;
+                }
+                p_search_result = p_new_search_result;
+                search_result_buffer_length = new_buffer_length;
+            }
+
+            memcpy(p_search_result + (INDEX_PAYLOAD_SIZE * search_result_length), get_index_node_payload(p_index_node, i), INDEX_PAYLOAD_SIZE);
+            search_result_length++;
         }
 
-        free_index_node_resources(&next_index_node);
+        next_tag = (is_searching) ? (p_index_node->next_tag) : (0);
+        release_index_node(p_index_info, p_index_node);
+        p_index_node = (next_tag != 0) ? fetch_index_node(p_index_info, next_tag) : NULL;
+    }
+
+    if (p_index_node != NULL)
+    {
+        release_index_node(p_index_info, p_index_node);
+    }
+
+    *result_length = search_result_length;
+    return p_search_result;
+}
+
+// Delete the first element in the bucket whose index id and payload are both equal to the inputted ones.
+// An emptied overflow node is unlinked from the bucket, the buckets are never merged.
+bool delete_hash_index_element(INDEX_INFO_T *p_index_info, INDEX_ELEMENT_T *p_index_element)
+{
+    INDEX_ID_TYPE_E index_id_type = p_index_info->index_properties.index_id_type;
+    INDEX_NODE_T *p_root_directory_node = fetch_index_node(p_index_info, p_index_info->index_properties.root_tag);
+    INDEX_NODE_T *p_previous_node = NULL, *p_index_node = NULL;
+    bool is_deleted = false;
+
+    if (p_root_directory_node == NULL)
+    {
+        return false;
     }
 
-    if (only_current_node_result == true)
+    p_index_node = fetch_index_node(p_index_info,
+                                    get_hash_index_bucket_tag(p_index_info, p_root_directory_node, get_hash_index_bucket(p_root_directory_node->length, get_hash_index_id_hash(p_index_info, p_index_element->p_index_id))));
+    release_index_node(p_index_info, p_root_directory_node);
+
+    while ((is_deleted == false) && (p_index_node != NULL))
     {
-        // The right most element is not equal to the target.
-        // No need to search next node.
-        // Or next node doesn't exist.
-        // Or next node read error.
-        *result_length = 0;
-        if (compare_equal_length > 0)
+        uint32_t next_tag = p_index_node->next_tag;
+
+        for (uint32_t i = 0; i < p_index_node->length; i++)
         {
-            p_search_result = malloc(compare_equal_length * INDEX_PAYLOAD_SIZE);
-            if (p_search_result == NULL)
+            if ((Index_Id_Type_Compare(index_id_type, p_index_element->p_index_id, get_index_node_index_id(p_index_node, i)) == INDEX_ID_COMPARE_EQUAL) &&
+                (memcmp(get_index_node_payload(p_index_node, i), p_index_element->index_payload, INDEX_PAYLOAD_SIZE) == 0))
             {
-                // Allocate memory error
-                // return NULL pointer and length = 0
-                return NULL;
+                remove_element_from_index_node(p_index_node, i, i);
+                mark_index_node_dirty(p_index_info, p_index_node);
+                is_deleted = true;
+                break;
             }
         }
+
+        if (is_deleted && (p_index_node->length == 0) && (p_previous_node != NULL))
+        {
+            p_previous_node->next_tag = p_index_node->next_tag;
+            mark_index_node_dirty(p_index_info, p_previous_node);
+        }
+
+        if (p_previous_node != NULL)
+        {
+            release_index_node(p_index_info, p_previous_node);
+        }
+        p_previous_node = p_index_node;
+        p_index_node = ((is_deleted == false) && (next_tag != 0)) ? fetch_index_node(p_index_info, next_tag) : NULL;
     }
 
-    for (i = *result_length; i < compare_equal_length; i++, match_end_position--)
+    if (p_previous_node != NULL)
     {
-        memcpy(p_search_result + (INDEX_PAYLOAD_SIZE * i), p_index_node->elements[match_end_position].index_payload, INDEX_PAYLOAD_SIZE);
+        release_index_node(p_index_info, p_previous_node);
     }
 
-    *result_length = compare_equal_length;
-    return p_search_result;
+    return is_deleted;
 }
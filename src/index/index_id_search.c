@@ -0,0 +1,373 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+
+#include "index_id_search.h"
+#include "index_id_type.h"
+#include "hash.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define INDEX_ID_SEARCH_X86_SIMD_SUPPORT (1)
+#include <immintrin.h>
+#else
+#define INDEX_ID_SEARCH_X86_SIMD_SUPPORT (0)
+#endif
+
+// The binary search narrows the range down to this number of index ids,
+// then the index ids in the range are compared and counted at once.
+#ifndef INDEX_ID_SEARCH_LINEAR_RANGE
+#define INDEX_ID_SEARCH_LINEAR_RANGE (16)
+#endif
+
+// HASH_VALUE_T is searched as uint32, HASH64_VALUE_T is searched as uint64.
+_Static_assert(sizeof(HASH_VALUE_T) == sizeof(uint32_t), "HASH_VALUE_T should be searched as uint32");
+_Static_assert(sizeof(HASH64_VALUE_T) == sizeof(uint64_t), "HASH64_VALUE_T should be searched as uint64");
+
+/*
+** Branchless binary search on the sorted array, then count the index ids smaller than the target in the last range.
+** p_base[0, range_length) always contains the lower bound position, all index ids before p_base are smaller than the target.
+*/
+#define INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(function_name, value_type, count_less_function, function_attribute) \
+    function_attribute static uint32_t function_name(const void *p_index_ids, uint32_t length, const void *p_target) \
+    {                                                                                                              \
+        const value_type *p_ids = (const value_type *)p_index_ids;                                                 \
+        const value_type *p_base = p_ids;                                                                          \
+        value_type target = *(const value_type *)p_target;                                                         \
+        uint32_t range_length = length;                                                                            \
+                                                                                                                   \
+        while (range_length > INDEX_ID_SEARCH_LINEAR_RANGE)                                                        \
+        {                                                                                                          \
+            uint32_t half = range_length / 2;                                                                      \
+            p_base = (p_base[half] < target) ? (p_base + half) : (p_base);                                         \
+            range_length -= half;                                                                                  \
+        }                                                                                                          \
+                                                                                                                   \
+        return (uint32_t)(p_base - p_ids) + count_less_function(p_base, range_length, target);                     \
+    }
+
+#define INDEX_ID_SEARCH_NO_ATTRIBUTE
+
+// Scalar count, the comparison result is added without branch.
+#define INDEX_ID_SEARCH_COUNT_LESS_SCALAR_FUNCTION(function_name, value_type)                  \
+    static inline uint32_t function_name(const value_type *p_ids, uint32_t length, value_type target) \
+    {                                                                                          \
+        uint32_t count = 0;                                                                    \
+        for (uint32_t i = 0; i < length; i++)                                                  \
+        {                                                                                      \
+            count += (p_ids[i] < target);                                                      \
+        }                                                                                      \
+        return count;                                                                          \
+    }
+
+INDEX_ID_SEARCH_COUNT_LESS_SCALAR_FUNCTION(count_less_uint32_scalar, uint32_t)
+INDEX_ID_SEARCH_COUNT_LESS_SCALAR_FUNCTION(count_less_int32_scalar, int32_t)
+INDEX_ID_SEARCH_COUNT_LESS_SCALAR_FUNCTION(count_less_uint64_scalar, uint64_t)
+INDEX_ID_SEARCH_COUNT_LESS_SCALAR_FUNCTION(count_less_int64_scalar, int64_t)
+INDEX_ID_SEARCH_COUNT_LESS_SCALAR_FUNCTION(count_less_float_scalar, float)
+INDEX_ID_SEARCH_COUNT_LESS_SCALAR_FUNCTION(count_less_double_scalar, double)
+
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_uint32_scalar, uint32_t, count_less_uint32_scalar, INDEX_ID_SEARCH_NO_ATTRIBUTE)
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_int32_scalar, int32_t, count_less_int32_scalar, INDEX_ID_SEARCH_NO_ATTRIBUTE)
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_uint64_scalar, uint64_t, count_less_uint64_scalar, INDEX_ID_SEARCH_NO_ATTRIBUTE)
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_int64_scalar, int64_t, count_less_int64_scalar, INDEX_ID_SEARCH_NO_ATTRIBUTE)
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_float_scalar, float, count_less_float_scalar, INDEX_ID_SEARCH_NO_ATTRIBUTE)
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_double_scalar, double, count_less_double_scalar, INDEX_ID_SEARCH_NO_ATTRIBUTE)
+
+// String and composite index ids are compared by bytes, so only the scalar binary search is provided.
+static uint32_t lower_bound_string_scalar(const void *p_index_ids, uint32_t length, const void *p_target)
+{
+    const INDEX_ID_STRING_T *p_ids = (const INDEX_ID_STRING_T *)p_index_ids;
+    uint32_t low = 0, high = length;
+
+    while (low < high)
+    {
+        uint32_t middle = low + (high - low) / 2;
+
+        if (Index_Id_Type_Compare(INDEX_ID_TYPE_STRING, (void *)&(p_ids[middle]), (void *)p_target) == INDEX_ID_COMPARE_RIGHT_GREATER)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+static uint32_t lower_bound_composite_scalar(const void *p_index_ids, uint32_t length, const void *p_target)
+{
+    const INDEX_ID_COMPOSITE_T *p_ids = (const INDEX_ID_COMPOSITE_T *)p_index_ids;
+    uint32_t low = 0, high = length;
+
+    while (low < high)
+    {
+        uint32_t middle = low + (high - low) / 2;
+
+        if (Index_Id_Type_Compare(INDEX_ID_TYPE_COMPOSITE, (void *)&(p_ids[middle]), (void *)p_target) == INDEX_ID_COMPARE_RIGHT_GREATER)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+#if INDEX_ID_SEARCH_X86_SIMD_SUPPORT
+#define INDEX_ID_SEARCH_SSE_ATTRIBUTE __attribute__((target("sse4.2,popcnt")))
+#define INDEX_ID_SEARCH_AVX2_ATTRIBUTE __attribute__((target("avx2,popcnt")))
+
+// Unsigned integers are compared as signed integers after flipping the sign bit.
+#define INDEX_ID_SEARCH_SIGN_BIT_32 ((int32_t)0x80000000)
+#define INDEX_ID_SEARCH_SIGN_BIT_64 ((int64_t)0x8000000000000000ULL)
+
+/* SSE4.2: 4 x 32-bit or 2 x 64-bit lanes */
+
+INDEX_ID_SEARCH_SSE_ATTRIBUTE static inline uint32_t count_less_uint32_sse(const uint32_t *p_ids, uint32_t length, uint32_t target)
+{
+    const __m128i sign_bit = _mm_set1_epi32(INDEX_ID_SEARCH_SIGN_BIT_32);
+    const __m128i target_vector = _mm_xor_si128(_mm_set1_epi32((int32_t)target), sign_bit);
+    uint32_t count = 0, i = 0;
+
+    for (; i + 4 <= length; i += 4)
+    {
+        __m128i id_vector = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(p_ids + i)), sign_bit);
+        count += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(target_vector, id_vector))));
+    }
+    return count + count_less_uint32_scalar(p_ids + i, length - i, target);
+}
+
+INDEX_ID_SEARCH_SSE_ATTRIBUTE static inline uint32_t count_less_int32_sse(const int32_t *p_ids, uint32_t length, int32_t target)
+{
+    const __m128i target_vector = _mm_set1_epi32(target);
+    uint32_t count = 0, i = 0;
+
+    for (; i + 4 <= length; i += 4)
+    {
+        __m128i id_vector = _mm_loadu_si128((const __m128i *)(p_ids + i));
+        count += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(target_vector, id_vector))));
+    }
+    return count + count_less_int32_scalar(p_ids + i, length - i, target);
+}
+
+INDEX_ID_SEARCH_SSE_ATTRIBUTE static inline uint32_t count_less_uint64_sse(const uint64_t *p_ids, uint32_t length, uint64_t target)
+{
+    const __m128i sign_bit = _mm_set1_epi64x(INDEX_ID_SEARCH_SIGN_BIT_64);
+    const __m128i target_vector = _mm_xor_si128(_mm_set1_epi64x((int64_t)target), sign_bit);
+    uint32_t count = 0, i = 0;
+
+    for (; i + 2 <= length; i += 2)
+    {
+        __m128i id_vector = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(p_ids + i)), sign_bit);
+        count += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(target_vector, id_vector))));
+    }
+    return count + count_less_uint64_scalar(p_ids + i, length - i, target);
+}
+
+INDEX_ID_SEARCH_SSE_ATTRIBUTE static inline uint32_t count_less_int64_sse(const int64_t *p_ids, uint32_t length, int64_t target)
+{
+    const __m128i target_vector = _mm_set1_epi64x(target);
+    uint32_t count = 0, i = 0;
+
+    for (; i + 2 <= length; i += 2)
+    {
+        __m128i id_vector = _mm_loadu_si128((const __m128i *)(p_ids + i));
+        count += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(target_vector, id_vector))));
+    }
+    return count + count_less_int64_scalar(p_ids + i, length - i, target);
+}
+
+INDEX_ID_SEARCH_SSE_ATTRIBUTE static inline uint32_t count_less_float_sse(const float *p_ids, uint32_t length, float target)
+{
+    const __m128 target_vector = _mm_set1_ps(target);
+    uint32_t count = 0, i = 0;
+
+    for (; i + 4 <= length; i += 4)
+    {
+        count += __builtin_popcount(_mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(p_ids + i), target_vector)));
+    }
+    return count + count_less_float_scalar(p_ids + i, length - i, target);
+}
+
+INDEX_ID_SEARCH_SSE_ATTRIBUTE static inline uint32_t count_less_double_sse(const double *p_ids, uint32_t length, double target)
+{
+    const __m128d target_vector = _mm_set1_pd(target);
+    uint32_t count = 0, i = 0;
+
+    for (; i + 2 <= length; i += 2)
+    {
+        count += __builtin_popcount(_mm_movemask_pd(_mm_cmplt_pd(_mm_loadu_pd(p_ids + i), target_vector)));
+    }
+    return count + count_less_double_scalar(p_ids + i, length - i, target);
+}
+
+/* AVX2: 8 x 32-bit or 4 x 64-bit lanes */
+
+INDEX_ID_SEARCH_AVX2_ATTRIBUTE static inline uint32_t count_less_uint32_avx2(const uint32_t *p_ids, uint32_t length, uint32_t target)
+{
+    const __m256i sign_bit = _mm256_set1_epi32(INDEX_ID_SEARCH_SIGN_BIT_32);
+    const __m256i target_vector = _mm256_xor_si256(_mm256_set1_epi32((int32_t)target), sign_bit);
+    uint32_t count = 0, i = 0;
+
+    for (; i + 8 <= length; i += 8)
+    {
+        __m256i id_vector = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(p_ids + i)), sign_bit);
+        count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(target_vector, id_vector))));
+    }
+    return count + count_less_uint32_scalar(p_ids + i, length - i, target);
+}
+
+INDEX_ID_SEARCH_AVX2_ATTRIBUTE static inline uint32_t count_less_int32_avx2(const int32_t *p_ids, uint32_t length, int32_t target)
+{
+    const __m256i target_vector = _mm256_set1_epi32(target);
+    uint32_t count = 0, i = 0;
+
+    for (; i + 8 <= length; i += 8)
+    {
+        __m256i id_vector = _mm256_loadu_si256((const __m256i *)(p_ids + i));
+        count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(target_vector, id_vector))));
+    }
+    return count + count_less_int32_scalar(p_ids + i, length - i, target);
+}
+
+INDEX_ID_SEARCH_AVX2_ATTRIBUTE static inline uint32_t count_less_uint64_avx2(const uint64_t *p_ids, uint32_t length, uint64_t target)
+{
+    const __m256i sign_bit = _mm256_set1_epi64x(INDEX_ID_SEARCH_SIGN_BIT_64);
+    const __m256i target_vector = _mm256_xor_si256(_mm256_set1_epi64x((int64_t)target), sign_bit);
+    uint32_t count = 0, i = 0;
+
+    for (; i + 4 <= length; i += 4)
+    {
+        __m256i id_vector = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(p_ids + i)), sign_bit);
+        count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(target_vector, id_vector))));
+    }
+    return count + count_less_uint64_scalar(p_ids + i, length - i, target);
+}
+
+INDEX_ID_SEARCH_AVX2_ATTRIBUTE static inline uint32_t count_less_int64_avx2(const int64_t *p_ids, uint32_t length, int64_t target)
+{
+    const __m256i target_vector = _mm256_set1_epi64x(target);
+    uint32_t count = 0, i = 0;
+
+    for (; i + 4 <= length; i += 4)
+    {
+        __m256i id_vector = _mm256_loadu_si256((const __m256i *)(p_ids + i));
+        count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(target_vector, id_vector))));
+    }
+    return count + count_less_int64_scalar(p_ids + i, length - i, target);
+}
+
+INDEX_ID_SEARCH_AVX2_ATTRIBUTE static inline uint32_t count_less_float_avx2(const float *p_ids, uint32_t length, float target)
+{
+    const __m256 target_vector = _mm256_set1_ps(target);
+    uint32_t count = 0, i = 0;
+
+    for (; i + 8 <= length; i += 8)
+    {
+        count += __builtin_popcount(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p_ids + i), target_vector, _CMP_LT_OQ)));
+    }
+    return count + count_less_float_scalar(p_ids + i, length - i, target);
+}
+
+INDEX_ID_SEARCH_AVX2_ATTRIBUTE static inline uint32_t count_less_double_avx2(const double *p_ids, uint32_t length, double target)
+{
+    const __m256d target_vector = _mm256_set1_pd(target);
+    uint32_t count = 0, i = 0;
+
+    for (; i + 4 <= length; i += 4)
+    {
+        count += __builtin_popcount(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(p_ids + i), target_vector, _CMP_LT_OQ)));
+    }
+    return count + count_less_double_scalar(p_ids + i, length - i, target);
+}
+
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_uint32_sse, uint32_t, count_less_uint32_sse, INDEX_ID_SEARCH_SSE_ATTRIBUTE)
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_int32_sse, int32_t, count_less_int32_sse, INDEX_ID_SEARCH_SSE_ATTRIBUTE)
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_uint64_sse, uint64_t, count_less_uint64_sse, INDEX_ID_SEARCH_SSE_ATTRIBUTE)
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_int64_sse, int64_t, count_less_int64_sse, INDEX_ID_SEARCH_SSE_ATTRIBUTE)
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_float_sse, float, count_less_float_sse, INDEX_ID_SEARCH_SSE_ATTRIBUTE)
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_double_sse, double, count_less_double_sse, INDEX_ID_SEARCH_SSE_ATTRIBUTE)
+
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_uint32_avx2, uint32_t, count_less_uint32_avx2, INDEX_ID_SEARCH_AVX2_ATTRIBUTE)
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_int32_avx2, int32_t, count_less_int32_avx2, INDEX_ID_SEARCH_AVX2_ATTRIBUTE)
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_uint64_avx2, uint64_t, count_less_uint64_avx2, INDEX_ID_SEARCH_AVX2_ATTRIBUTE)
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_int64_avx2, int64_t, count_less_int64_avx2, INDEX_ID_SEARCH_AVX2_ATTRIBUTE)
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_float_avx2, float, count_less_float_avx2, INDEX_ID_SEARCH_AVX2_ATTRIBUTE)
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION(lower_bound_double_avx2, double, count_less_double_avx2, INDEX_ID_SEARCH_AVX2_ATTRIBUTE)
+#endif // INDEX_ID_SEARCH_X86_SIMD_SUPPORT
+
+// [index_id_type][isa], NULL means not supported.
+static const INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION_T index_id_search_lower_bound_function[INDEX_ID_TYPE_NUM][INDEX_ID_SEARCH_ISA_NUM] = {
+#if INDEX_ID_SEARCH_X86_SIMD_SUPPORT
+    [INDEX_ID_TYPE_HASH] = {lower_bound_uint32_scalar, lower_bound_uint32_sse, lower_bound_uint32_avx2},
+    [INDEX_ID_TYPE_UINT32] = {lower_bound_uint32_scalar, lower_bound_uint32_sse, lower_bound_uint32_avx2},
+    [INDEX_ID_TYPE_INT32] = {lower_bound_int32_scalar, lower_bound_int32_sse, lower_bound_int32_avx2},
+    [INDEX_ID_TYPE_UINT64] = {lower_bound_uint64_scalar, lower_bound_uint64_sse, lower_bound_uint64_avx2},
+    [INDEX_ID_TYPE_INT64] = {lower_bound_int64_scalar, lower_bound_int64_sse, lower_bound_int64_avx2},
+    [INDEX_ID_TYPE_FLOAT] = {lower_bound_float_scalar, lower_bound_float_sse, lower_bound_float_avx2},
+    [INDEX_ID_TYPE_DOUBLE] = {lower_bound_double_scalar, lower_bound_double_sse, lower_bound_double_avx2},
+    [INDEX_ID_TYPE_STRING] = {lower_bound_string_scalar},
+    [INDEX_ID_TYPE_HASH64] = {lower_bound_uint64_scalar, lower_bound_uint64_sse, lower_bound_uint64_avx2},
+    [INDEX_ID_TYPE_COMPOSITE] = {lower_bound_composite_scalar},
+#else
+    [INDEX_ID_TYPE_HASH] = {lower_bound_uint32_scalar},
+    [INDEX_ID_TYPE_UINT32] = {lower_bound_uint32_scalar},
+    [INDEX_ID_TYPE_INT32] = {lower_bound_int32_scalar},
+    [INDEX_ID_TYPE_UINT64] = {lower_bound_uint64_scalar},
+    [INDEX_ID_TYPE_INT64] = {lower_bound_int64_scalar},
+    [INDEX_ID_TYPE_FLOAT] = {lower_bound_float_scalar},
+    [INDEX_ID_TYPE_DOUBLE] = {lower_bound_double_scalar},
+    [INDEX_ID_TYPE_STRING] = {lower_bound_string_scalar},
+    [INDEX_ID_TYPE_HASH64] = {lower_bound_uint64_scalar},
+    [INDEX_ID_TYPE_COMPOSITE] = {lower_bound_composite_scalar},
+#endif
+};
+
+static bool is_index_id_search_isa_supported(INDEX_ID_SEARCH_ISA_E isa)
+{
+    switch (isa)
+    {
+    case INDEX_ID_SEARCH_ISA_SCALAR:
+        return true;
+#if INDEX_ID_SEARCH_X86_SIMD_SUPPORT
+    case INDEX_ID_SEARCH_ISA_SSE:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+    case INDEX_ID_SEARCH_ISA_AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#endif
+    default:
+        return false;
+    }
+}
+
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION_T Index_Id_Search_Get_Lower_Bound_Function(INDEX_ID_TYPE_E index_id_type)
+{
+    INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION_T lower_bound_function = NULL;
+
+    // Try the widest instruction set first.
+    for (int32_t isa = INDEX_ID_SEARCH_ISA_NUM - 1; (isa >= 0) && (lower_bound_function == NULL); isa--)
+    {
+        lower_bound_function = Index_Id_Search_Get_Lower_Bound_Function_By_Isa(index_id_type, (INDEX_ID_SEARCH_ISA_E)isa);
+    }
+
+    assert(lower_bound_function != NULL);
+    return lower_bound_function;
+}
+
+INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION_T Index_Id_Search_Get_Lower_Bound_Function_By_Isa(INDEX_ID_TYPE_E index_id_type, INDEX_ID_SEARCH_ISA_E isa)
+{
+    if ((index_id_type >= INDEX_ID_TYPE_NUM) || (isa >= INDEX_ID_SEARCH_ISA_NUM) || (is_index_id_search_isa_supported(isa) == false))
+    {
+        return NULL;
+    }
+
+    return index_id_search_lower_bound_function[index_id_type][isa];
+}
@@ -1,4 +1,5 @@
 #include <stdint.h>
+#include <string.h>
 #include <assert.h>
 
 #include "index_id_type.h"
@@ -11,6 +12,9 @@ INDEX_ID_COMPARE_RESULT_E index_id_type_uint64_compare(void *value1, void *value
 INDEX_ID_COMPARE_RESULT_E index_id_type_int64_compare(void *value1, void *value2);
 INDEX_ID_COMPARE_RESULT_E index_id_type_float_compare(void *value1, void *value2);
 INDEX_ID_COMPARE_RESULT_E index_id_type_double_compare(void *value1, void *value2);
+INDEX_ID_COMPARE_RESULT_E index_id_type_string_compare(void *value1, void *value2);
+INDEX_ID_COMPARE_RESULT_E index_id_type_hash64_compare(void *value1, void *value2);
+INDEX_ID_COMPARE_RESULT_E index_id_type_composite_compare(void *value1, void *value2);
 
 static const uint32_t index_id_type_size[] = {
 #ifdef INDEX_ID_TYPE_CONFIG
@@ -39,6 +43,12 @@ INDEX_ID_COMPARE_RESULT_E Index_Id_Type_Compare(INDEX_ID_TYPE_E index_id_type, v
         return index_id_type_float_compare(value1, value2);
     case INDEX_ID_TYPE_DOUBLE:
         return index_id_type_double_compare(value1, value2);
+    case INDEX_ID_TYPE_STRING:
+        return index_id_type_string_compare(value1, value2);
+    case INDEX_ID_TYPE_HASH64:
+        return index_id_type_hash64_compare(value1, value2);
+    case INDEX_ID_TYPE_COMPOSITE:
+        return index_id_type_composite_compare(value1, value2);
     default:
         assert(false);
         break;
@@ -57,6 +67,227 @@ uint32_t Index_Id_Type_Get_Size(INDEX_ID_TYPE_E index_id_type)
     }
 }
 
+uint32_t Index_Id_Type_Get_Ordered_Prefix_Size(INDEX_ID_TYPE_E index_id_type)
+{
+    switch (index_id_type)
+    {
+    case INDEX_ID_TYPE_STRING:
+        return INDEX_ID_STRING_PREFIX_SIZE;
+    case INDEX_ID_TYPE_COMPOSITE:
+        return INDEX_ID_COMPOSITE_PREFIX_SIZE;
+    default:
+        // The numbers are stored in the native byte order, the hash values are ordered as numbers.
+        return 0;
+    }
+}
+
+bool Index_Id_Type_Set_Separator(INDEX_ID_TYPE_E index_id_type, void *p_separator, void *p_left_index_id, void *p_right_index_id)
+{
+    uint8_t *p_left_bytes = (uint8_t *)p_left_index_id, *p_right_bytes = (uint8_t *)p_right_index_id;
+    uint32_t index_id_size = Index_Id_Type_Get_Size(index_id_type);
+    uint32_t ordered_prefix_size = Index_Id_Type_Get_Ordered_Prefix_Size(index_id_type);
+    uint32_t differing_position = 0;
+
+    while ((differing_position < ordered_prefix_size) && (p_left_bytes[differing_position] == p_right_bytes[differing_position]))
+    {
+        differing_position++;
+    }
+
+    if (differing_position == ordered_prefix_size)
+    {
+        memmove(p_separator, p_right_index_id, index_id_size);
+        return false;
+    }
+
+    // The right index id is greater at the differing byte, the zero bytes after it keep the separator not greater than the right one.
+    assert(p_left_bytes[differing_position] < p_right_bytes[differing_position]);
+    memmove(p_separator, p_right_index_id, differing_position + 1);
+    memset((uint8_t *)p_separator + differing_position + 1, 0, index_id_size - differing_position - 1);
+    return true;
+}
+
+void Index_Id_Type_Set_String(void *p_index_id, const uint8_t *p_string, uint32_t string_size)
+{
+    INDEX_ID_STRING_T *p_string_id = (INDEX_ID_STRING_T *)p_index_id;
+    uint32_t string_length = strnlen((const char *)p_string, string_size);
+    uint32_t prefix_length = (string_length < INDEX_ID_STRING_PREFIX_SIZE) ? (string_length) : (INDEX_ID_STRING_PREFIX_SIZE);
+
+    // Zero padding keeps the lexicographic order of the strings shorter than the prefix.
+    memset(p_string_id, 0, sizeof(INDEX_ID_STRING_T));
+    memcpy(p_string_id->prefix, p_string, prefix_length);
+    p_string_id->hash_value = Hash64((uint8_t *)p_string, string_length);
+}
+
+bool Index_Id_Type_Is_String_Complete(void *p_index_id)
+{
+    INDEX_ID_STRING_T *p_string_id = (INDEX_ID_STRING_T *)p_index_id;
+
+    return (p_string_id->prefix[INDEX_ID_STRING_PREFIX_SIZE - 1] == 0);
+}
+
+bool Index_Id_Type_Is_String_Range_Bound(void *p_index_id)
+{
+    INDEX_ID_STRING_T *p_string_id = (INDEX_ID_STRING_T *)p_index_id;
+
+    // The prefix range bounds are before or after all the strings sharing their prefix, whatever the hashes are.
+    return Index_Id_Type_Is_String_Complete(p_index_id) || (p_string_id->hash_value == 0) || (p_string_id->hash_value == UINT64_MAX);
+}
+
+bool Index_Id_Type_Is_String_Order_Unknown(void *p_index_id_1, void *p_index_id_2)
+{
+    INDEX_ID_STRING_T *p_string_id_1 = (INDEX_ID_STRING_T *)p_index_id_1, *p_string_id_2 = (INDEX_ID_STRING_T *)p_index_id_2;
+
+    return (Index_Id_Type_Is_String_Complete(p_index_id_1) == false) &&
+           (memcmp(p_string_id_1->prefix, p_string_id_2->prefix, INDEX_ID_STRING_PREFIX_SIZE) == 0) &&
+           (p_string_id_1->hash_value != p_string_id_2->hash_value);
+}
+
+bool Index_Id_Type_Set_String_Prefix_Range(void *p_lower_index_id, void *p_upper_index_id, const uint8_t *p_prefix, uint32_t prefix_size)
+{
+    INDEX_ID_STRING_T *p_lower_string_id = (INDEX_ID_STRING_T *)p_lower_index_id;
+    INDEX_ID_STRING_T *p_upper_string_id = (INDEX_ID_STRING_T *)p_upper_index_id;
+    uint32_t prefix_length = strnlen((const char *)p_prefix, prefix_size);
+    bool is_exact = (prefix_length <= INDEX_ID_STRING_PREFIX_SIZE);
+
+    if (!is_exact)
+    {
+        prefix_length = INDEX_ID_STRING_PREFIX_SIZE;
+    }
+
+    // lower: the prefix followed by the smallest bytes, upper: the prefix followed by the greatest bytes.
+    memset(p_lower_string_id, 0, sizeof(INDEX_ID_STRING_T));
+    memcpy(p_lower_string_id->prefix, p_prefix, prefix_length);
+    p_lower_string_id->hash_value = 0;
+
+    memset(p_upper_string_id, 0, sizeof(INDEX_ID_STRING_T));
+    memset(p_upper_string_id->prefix, UINT8_MAX, INDEX_ID_STRING_PREFIX_SIZE);
+    memcpy(p_upper_string_id->prefix, p_prefix, prefix_length);
+    p_upper_string_id->hash_value = UINT64_MAX;
+
+    return is_exact;
+}
+
+uint32_t Index_Id_Type_Get_Composite_Column_Max_Size(uint32_t value_size)
+{
+    // Numbers are encoded in at most 64 bits, strings are encoded with a terminating '\0'.
+    return ((value_size > sizeof(uint64_t)) ? value_size : sizeof(uint64_t)) + 1;
+}
+
+uint32_t Index_Id_Type_Encode_Composite_Column(uint8_t *p_buffer, INDEX_ID_TYPE_E column_index_id_type, const void *p_value, uint32_t value_size)
+{
+    uint64_t bits = 0;
+    uint32_t bits_size = 0;
+
+    switch (column_index_id_type)
+    {
+    case INDEX_ID_TYPE_UINT32:
+    {
+        uint32_t value = 0;
+        memcpy(&value, p_value, sizeof(uint32_t));
+        bits = value;
+        bits_size = sizeof(uint32_t);
+        break;
+    }
+    case INDEX_ID_TYPE_INT32:
+    {
+        // Flip the sign bit so the negative values are ordered before the positive values.
+        uint32_t value = 0;
+        memcpy(&value, p_value, sizeof(uint32_t));
+        bits = value ^ ((uint32_t)1 << 31);
+        bits_size = sizeof(uint32_t);
+        break;
+    }
+    case INDEX_ID_TYPE_UINT64:
+    {
+        memcpy(&bits, p_value, sizeof(uint64_t));
+        bits_size = sizeof(uint64_t);
+        break;
+    }
+    case INDEX_ID_TYPE_INT64:
+    {
+        memcpy(&bits, p_value, sizeof(uint64_t));
+        bits ^= ((uint64_t)1 << 63);
+        bits_size = sizeof(uint64_t);
+        break;
+    }
+    case INDEX_ID_TYPE_FLOAT:
+    {
+        // Negative values are inverted so the greater magnitudes are ordered first, -0.0 is encoded as 0.0.
+        float value = 0;
+        uint32_t value_bits = 0;
+        memcpy(&value, p_value, sizeof(float));
+        value = (value == 0) ? 0 : value;
+        memcpy(&value_bits, &value, sizeof(uint32_t));
+        bits = (value_bits & ((uint32_t)1 << 31)) ? (uint32_t)(~value_bits) : (value_bits | ((uint32_t)1 << 31));
+        bits_size = sizeof(uint32_t);
+        break;
+    }
+    case INDEX_ID_TYPE_DOUBLE:
+    {
+        double value = 0;
+        memcpy(&value, p_value, sizeof(double));
+        value = (value == 0) ? 0 : value;
+        memcpy(&bits, &value, sizeof(uint64_t));
+        bits = (bits & ((uint64_t)1 << 63)) ? (~bits) : (bits | ((uint64_t)1 << 63));
+        bits_size = sizeof(uint64_t);
+        break;
+    }
+    case INDEX_ID_TYPE_STRING:
+    {
+        // The terminating '\0' orders a string before the longer strings starting with it.
+        uint32_t string_length = strnlen((const char *)p_value, value_size);
+        memcpy(p_buffer, p_value, string_length);
+        p_buffer[string_length] = 0;
+        return string_length + 1;
+    }
+    default:
+        return 0;
+    }
+
+    // Big-endian bytes compare by memcmp() in the order of the values.
+    for (uint32_t i = 0; i < bits_size; i++)
+    {
+        p_buffer[i] = (uint8_t)(bits >> (8 * (bits_size - 1 - i)));
+    }
+
+    return bits_size;
+}
+
+void Index_Id_Type_Set_Composite(void *p_index_id, const uint8_t *p_encoded_columns, uint32_t encoded_columns_size)
+{
+    INDEX_ID_COMPOSITE_T *p_composite_id = (INDEX_ID_COMPOSITE_T *)p_index_id;
+    uint32_t prefix_length = (encoded_columns_size < INDEX_ID_COMPOSITE_PREFIX_SIZE) ? (encoded_columns_size) : (INDEX_ID_COMPOSITE_PREFIX_SIZE);
+
+    memset(p_composite_id, 0, sizeof(INDEX_ID_COMPOSITE_T));
+    memcpy(p_composite_id->prefix, p_encoded_columns, prefix_length);
+    p_composite_id->hash_value = Hash64((uint8_t *)p_encoded_columns, encoded_columns_size);
+}
+
+bool Index_Id_Type_Set_Composite_Prefix_Range(void *p_lower_index_id, void *p_upper_index_id, const uint8_t *p_encoded_prefix, uint32_t encoded_prefix_size)
+{
+    INDEX_ID_COMPOSITE_T *p_lower_composite_id = (INDEX_ID_COMPOSITE_T *)p_lower_index_id;
+    INDEX_ID_COMPOSITE_T *p_upper_composite_id = (INDEX_ID_COMPOSITE_T *)p_upper_index_id;
+    uint32_t prefix_length = encoded_prefix_size;
+    bool is_exact = (prefix_length <= INDEX_ID_COMPOSITE_PREFIX_SIZE);
+
+    if (!is_exact)
+    {
+        prefix_length = INDEX_ID_COMPOSITE_PREFIX_SIZE;
+    }
+
+    // lower: the prefix followed by the smallest bytes, upper: the prefix followed by the greatest bytes.
+    memset(p_lower_composite_id, 0, sizeof(INDEX_ID_COMPOSITE_T));
+    memcpy(p_lower_composite_id->prefix, p_encoded_prefix, prefix_length);
+    p_lower_composite_id->hash_value = 0;
+
+    memset(p_upper_composite_id, 0, sizeof(INDEX_ID_COMPOSITE_T));
+    memset(p_upper_composite_id->prefix, UINT8_MAX, INDEX_ID_COMPOSITE_PREFIX_SIZE);
+    memcpy(p_upper_composite_id->prefix, p_encoded_prefix, prefix_length);
+    p_upper_composite_id->hash_value = UINT64_MAX;
+
+    return is_exact;
+}
+
 INDEX_ID_COMPARE_RESULT_E index_id_type_hash_compare(void *value1, void *value2)
 {
     HASH_VALUE_T hash_1 = *(HASH_VALUE_T *)value1, hash_2 = *(HASH_VALUE_T *)value2;
@@ -188,4 +419,63 @@ INDEX_ID_COMPARE_RESULT_E index_id_type_double_compare(void *value1, void *value
         // val_1 == val_2
         return INDEX_ID_COMPARE_EQUAL;
     }
+}
+
+INDEX_ID_COMPARE_RESULT_E index_id_type_string_compare(void *value1, void *value2)
+{
+    INDEX_ID_STRING_T *p_string_id_1 = (INDEX_ID_STRING_T *)value1, *p_string_id_2 = (INDEX_ID_STRING_T *)value2;
+    int prefix_compare_result = memcmp(p_string_id_1->prefix, p_string_id_2->prefix, INDEX_ID_STRING_PREFIX_SIZE);
+
+    if (prefix_compare_result > 0)
+    {
+        return INDEX_ID_COMPARE_LEFT_GREATER;
+    }
+    else if (prefix_compare_result < 0)
+    {
+        return INDEX_ID_COMPARE_RIGHT_GREATER;
+    }
+    else
+    {
+        // The strings share the prefix, break the tie by the hash values.
+        return index_id_type_hash64_compare(&(p_string_id_1->hash_value), &(p_string_id_2->hash_value));
+    }
+}
+
+INDEX_ID_COMPARE_RESULT_E index_id_type_hash64_compare(void *value1, void *value2)
+{
+    HASH64_VALUE_T hash_1 = *(HASH64_VALUE_T *)value1, hash_2 = *(HASH64_VALUE_T *)value2;
+
+    if (hash_1 > hash_2)
+    {
+        return INDEX_ID_COMPARE_LEFT_GREATER;
+    }
+    else if (hash_1 < hash_2)
+    {
+        return INDEX_ID_COMPARE_RIGHT_GREATER;
+    }
+    else
+    {
+        // hash_1 == hash_2
+        return INDEX_ID_COMPARE_EQUAL;
+    }
+}
+
+INDEX_ID_COMPARE_RESULT_E index_id_type_composite_compare(void *value1, void *value2)
+{
+    INDEX_ID_COMPOSITE_T *p_composite_id_1 = (INDEX_ID_COMPOSITE_T *)value1, *p_composite_id_2 = (INDEX_ID_COMPOSITE_T *)value2;
+    int prefix_compare_result = memcmp(p_composite_id_1->prefix, p_composite_id_2->prefix, INDEX_ID_COMPOSITE_PREFIX_SIZE);
+
+    if (prefix_compare_result > 0)
+    {
+        return INDEX_ID_COMPARE_LEFT_GREATER;
+    }
+    else if (prefix_compare_result < 0)
+    {
+        return INDEX_ID_COMPARE_RIGHT_GREATER;
+    }
+    else
+    {
+        // The encoded columns share the prefix, break the tie by the hash values.
+        return index_id_type_hash64_compare(&(p_composite_id_1->hash_value), &(p_composite_id_2->hash_value));
+    }
 }
\ No newline at end of file
@@ -3,12 +3,13 @@
 #include <stdint.h>
 #include <inttypes.h>
 #include <unistd.h>
+#include <sys/wait.h>
 
 #define __FACILEDB_TEST__
 // #define __PRINT_DETAILS__
 
 #define ENABLE_DB_INDEX (1)
-#define DB_SET_INFO_INSTANCE_NUM (1)
+#define DB_SET_INFO_INSTANCE_NUM (2)
 // #define FACILEDB_BLOCK_DATA_SIZE ((16 + 6 + 6) * 2 - 4) // 52
 #define FACILEDB_BLOCK_DATA_SIZE (50) // 49 ~
 // Definition for buffer length in search operation.
@@ -253,7 +254,6 @@ void test_faciledb_insert_case1()
         }
         free(p_db_records_info);
 
-        fclose(db_set_info.file);
         free_db_set_info_resources(&db_set_info);
     }
 
@@ -356,7 +356,6 @@ void test_faciledb_insert_case2()
         }
         free(p_db_records_info);
 
-        fclose(db_set_info.file);
         free_db_set_info_resources(&db_set_info);
     }
 
@@ -530,7 +529,6 @@ void test_faciledb_insert_case4()
             free(p_db_records_info);
         }
 
-        fclose(db_set_info.file);
         free_db_set_info_resources(&db_set_info);
     }
 
@@ -647,7 +645,6 @@ void test_faciledb_insert_case3()
         }
         free(p_db_records_info);
 
-        fclose(db_set_info.file);
         free_db_set_info_resources(&db_set_info);
     }
 
@@ -849,7 +846,6 @@ void test_faciledb_insert_case5()
         }
         free(p_db_records_info);
 
-        fclose(db_set_info.file);
         free_db_set_info_resources(&db_set_info);
     }
     test_end(case_name);
@@ -1748,6 +1744,137 @@ void test_faciledb_delete_case2()
     test_end(case_name);
 }
 
+void test_faciledb_open_set_file_case1()
+{
+    char case_name[] = "test_faciledb_open_set_file_case1";
+    test_start(case_name);
+
+    // The set files are kept open by LRU, the least recently used set is closed to open the third set.
+    char db_set_names[3][32] = {"test_faciledb_open_set_file_a", "test_faciledb_open_set_file_b", "test_faciledb_open_set_file_c"};
+    const uint32_t data_num = 4;
+    uint32_t values[4], result_data_num[3] = {0};
+    FACILEDB_RECORD_T records[4];
+    FACILEDB_DATA_T data[4];
+    FACILEDB_DATA_T *p_faciledb_data_array[3] = {NULL};
+    // 0: a and b are interleaved, 1: c is opened, 2: the open set files are limited to 1.
+    bool is_loaded[3][3] = {{false}};
+
+    for (uint32_t i = 0; i < data_num; i++)
+    {
+        values[i] = i;
+        records[i] = (FACILEDB_RECORD_T){.key_size = 2, .p_key = (void *)"v", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &(values[i])};
+        data[i] = (FACILEDB_DATA_T){.record_num = 1, .p_data_records = &(records[i])};
+    }
+
+    FacileDB_Api_Init(test_faciledb_directory);
+    for (uint32_t i = 0; i < data_num; i++)
+    {
+        FacileDB_Api_Insert_Data(db_set_names[i % 2], &(data[i]));
+    }
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        is_loaded[0][i] = (query_db_set_info_instance(db_set_names[i], strlen(db_set_names[i])) != NULL);
+    }
+
+    FacileDB_Api_Insert_Data(db_set_names[2], &(data[0]));
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        is_loaded[1][i] = (query_db_set_info_instance(db_set_names[i], strlen(db_set_names[i])) != NULL);
+    }
+
+    FacileDB_Api_Set_Open_Set_File_Num(1);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        p_faciledb_data_array[i] = FacileDB_Api_Search_Equal(db_set_names[i], &(records[0]), &(result_data_num[i]));
+    }
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        is_loaded[2][i] = (query_db_set_info_instance(db_set_names[i], strlen(db_set_names[i])) != NULL);
+    }
+    FacileDB_Api_Set_Open_Set_File_Num(DB_SET_INFO_INSTANCE_NUM);
+    FacileDB_Api_Close();
+
+    // Check
+    {
+        assert(is_loaded[0][0] && is_loaded[0][1] && !is_loaded[0][2]);
+        assert(!is_loaded[1][0] && is_loaded[1][1] && is_loaded[1][2]);
+        assert(!is_loaded[2][0] && !is_loaded[2][1] && is_loaded[2][2]);
+        check_faciledb_search_result(p_faciledb_data_array[0], result_data_num[0], &(data[0]), 1);
+        assert(result_data_num[1] == 0);
+        check_faciledb_search_result(p_faciledb_data_array[2], result_data_num[2], &(data[0]), 1);
+    }
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        for (uint32_t j = 0; j < result_data_num[i]; j++)
+        {
+            FacileDB_Api_Free_Data_Buffer(&(p_faciledb_data_array[i][j]));
+            free(p_faciledb_data_array[i][j].p_data_records);
+        }
+        free(p_faciledb_data_array[i]);
+    }
+
+    test_end(case_name);
+}
+
+void test_faciledb_open_set_file_case2()
+{
+    char case_name[] = "test_faciledb_open_set_file_case2";
+    test_start(case_name);
+
+    // A set file of another format version is not opened, it's opened again after the version is restored.
+    char db_set_name[] = "test_faciledb_open_set_file_case2";
+    char db_set_file_path[FACILEDB_FILE_PATH_BUFFER_LENGTH] = {0};
+    uint32_t value = 1, format_version = 0;
+    uint32_t insert_data_num[2] = {0}, result_data_num[2] = {0};
+    FACILEDB_RECORD_T record = {.key_size = 2, .p_key = (void *)"v", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &value};
+    FACILEDB_DATA_T data = {.record_num = 1, .p_data_records = &record};
+    FACILEDB_DATA_T *p_faciledb_data_array[2] = {NULL};
+    int fd = -1;
+
+    FacileDB_Api_Init(test_faciledb_directory);
+    FacileDB_Api_Insert_Data(db_set_name, &data);
+    get_db_set_file_path_by_db_set_name(db_set_name, db_set_file_path);
+    FacileDB_Api_Close();
+
+    // The format version is stored after the magic number.
+    fd = open(db_set_file_path, O_RDWR);
+    format_version = DB_SET_FILE_FORMAT_VERSION + 1;
+    pwrite(fd, &format_version, sizeof(format_version), sizeof(uint32_t));
+
+    FacileDB_Api_Init(test_faciledb_directory);
+    insert_data_num[0] = FacileDB_Api_Insert_Data(db_set_name, &data);
+    p_faciledb_data_array[0] = FacileDB_Api_Search_Equal(db_set_name, &record, &(result_data_num[0]));
+    FacileDB_Api_Close();
+
+    format_version = DB_SET_FILE_FORMAT_VERSION;
+    pwrite(fd, &format_version, sizeof(format_version), sizeof(uint32_t));
+    close(fd);
+
+    FacileDB_Api_Init(test_faciledb_directory);
+    insert_data_num[1] = FacileDB_Api_Insert_Data(db_set_name, &data);
+    p_faciledb_data_array[1] = FacileDB_Api_Search_Equal(db_set_name, &record, &(result_data_num[1]));
+    FacileDB_Api_Close();
+
+    // Check
+    {
+        assert(insert_data_num[0] == 0);
+        assert(p_faciledb_data_array[0] == NULL);
+        assert(result_data_num[0] == 0);
+        assert(insert_data_num[1] == 1);
+        assert(result_data_num[1] == 2);
+    }
+
+    for (uint32_t i = 0; i < result_data_num[1]; i++)
+    {
+        FacileDB_Api_Free_Data_Buffer(&(p_faciledb_data_array[1][i]));
+        free(p_faciledb_data_array[1][i].p_data_records);
+    }
+    free(p_faciledb_data_array[1]);
+
+    test_end(case_name);
+}
+
 #if ENABLE_DB_INDEX
 void test_faciledb_make_index_and_search_case1()
 {
@@ -2208,6 +2335,999 @@ void test_faciledb_make_index_insert_and_search_case1()
 
 #endif
 
+void test_faciledb_make_index_delete_and_search_case1()
+{
+    char case_name[] = "test_faciledb_make_index_delete_and_search_case1";
+    test_start(case_name);
+
+    char db_set_name[] = "test_faciledb_make_index_delete_and_search_case1";
+    uint32_t values[3] = {1, 1, 2};
+    FACILEDB_RECORD_T records[3];
+    FACILEDB_DATA_T data[3];
+    uint32_t delete_data_num = 0, index_result_length[2] = {0}, data_num = 0, deleted_data_num = 0;
+    void *p_index_result[2] = {NULL};
+    FACILEDB_DATA_T *p_faciledb_data_array = NULL, *p_deleted_faciledb_data_array = NULL;
+    char *p_index_key = set_db_index_key(db_set_name, strlen(db_set_name), "a", 2);
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        records[i].key_size = 2; // 'a' and '\0'
+        records[i].p_key = (void *)"a";
+        records[i].value_size = sizeof(uint32_t);
+        records[i].record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32;
+        records[i].p_value = &(values[i]);
+        data[i].record_num = 1;
+        data[i].p_data_records = &(records[i]);
+    }
+
+    FacileDB_Api_Init(test_faciledb_directory);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        FacileDB_Api_Insert_Data(db_set_name, &(data[i]));
+    }
+
+    // make index, then delete the data with a == 1.
+    FacileDB_Api_Make_Record_Index(db_set_name, &(records[0]));
+    delete_data_num = FacileDB_Api_Delete_Equal(db_set_name, &(records[0]));
+
+    // The index elements of the deleted data are kept for the earlier snapshots, the indexed search skips the deleted data.
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        p_index_result[i] = Index_Api_Search_Equal(p_index_key, &(values[i + 1]), INDEX_ID_TYPE_UINT32, &(index_result_length[i]));
+    }
+    p_faciledb_data_array = FacileDB_Api_Search_Equal(db_set_name, &(records[2]), &data_num);
+    p_deleted_faciledb_data_array = FacileDB_Api_Search_Equal(db_set_name, &(records[0]), &deleted_data_num);
+    FacileDB_Api_Close();
+
+    // Check
+    {
+        assert(delete_data_num == 2);
+        assert(index_result_length[0] == 2);
+        assert(index_result_length[1] == 1);
+        check_faciledb_search_result(p_faciledb_data_array, data_num, &(data[2]), 1);
+        assert(deleted_data_num == 0);
+        assert(p_deleted_faciledb_data_array == NULL);
+    }
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        Index_Api_Free_Search_Result(p_index_result[i]);
+    }
+    for (uint32_t j = 0; j < data_num; j++)
+    {
+        FacileDB_Api_Free_Data_Buffer(&(p_faciledb_data_array[j]));
+    }
+    free(p_faciledb_data_array);
+    free(p_index_key);
+
+    test_end(case_name);
+}
+
+void test_faciledb_make_index_and_search_numeric_case1()
+{
+    char case_name[] = "test_faciledb_make_index_and_search_numeric_case1";
+    test_start(case_name);
+
+    char db_set_name[] = "test_faciledb_make_index_and_search_numeric_case1";
+    const uint32_t data_num = 4, record_num = 5;
+    int32_t int32_values[4];
+    uint64_t uint64_values[4];
+    int64_t int64_values[4];
+    float float_values[4];
+    double double_values[4];
+    FACILEDB_RECORD_T records[4][5];
+    FACILEDB_DATA_T data[4];
+    // The odd data match the records of data[1].
+    FACILEDB_DATA_T expected_data_result[2];
+    uint32_t result_data_num[2][5] = {0};
+    FACILEDB_DATA_T *p_faciledb_data_array[2][5];
+
+    for (uint32_t i = 0; i < data_num; i++)
+    {
+        int32_values[i] = -(int32_t)(i % 2);
+        uint64_values[i] = (0x100000000ULL * (i % 2)) + 7;
+        int64_values[i] = -(int64_t)(i % 2) * (1LL << 40);
+        float_values[i] = 0.5f * (i % 2);
+        double_values[i] = -1.25 * (i % 2);
+
+        records[i][0] = (FACILEDB_RECORD_T){.key_size = 4, .p_key = (void *)"i32", .value_size = sizeof(int32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_INT32, .p_value = &(int32_values[i])};
+        records[i][1] = (FACILEDB_RECORD_T){.key_size = 4, .p_key = (void *)"u64", .value_size = sizeof(uint64_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT64, .p_value = &(uint64_values[i])};
+        records[i][2] = (FACILEDB_RECORD_T){.key_size = 4, .p_key = (void *)"i64", .value_size = sizeof(int64_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_INT64, .p_value = &(int64_values[i])};
+        records[i][3] = (FACILEDB_RECORD_T){.key_size = 2, .p_key = (void *)"f", .value_size = sizeof(float), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_FLOAT, .p_value = &(float_values[i])};
+        records[i][4] = (FACILEDB_RECORD_T){.key_size = 2, .p_key = (void *)"d", .value_size = sizeof(double), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_DOUBLE, .p_value = &(double_values[i])};
+        data[i].record_num = record_num;
+        data[i].p_data_records = records[i];
+    }
+    expected_data_result[0] = data[1];
+    expected_data_result[1] = data[3];
+
+    FacileDB_Api_Init(test_faciledb_directory);
+    for (uint32_t i = 0; i < data_num; i++)
+    {
+        FacileDB_Api_Insert_Data(db_set_name, &(data[i]));
+    }
+
+    // search sequentially, then make the indexes and search again.
+    for (uint32_t round = 0; round < 2; round++)
+    {
+        for (uint32_t j = 0; j < record_num; j++)
+        {
+            if (round == 1)
+            {
+                assert(FacileDB_Api_Make_Record_Index(db_set_name, &(records[1][j])));
+            }
+            p_faciledb_data_array[round][j] = FacileDB_Api_Search_Equal(db_set_name, &(records[1][j]), &(result_data_num[round][j]));
+        }
+    }
+    FacileDB_Api_Close();
+
+    // Check
+    for (uint32_t round = 0; round < 2; round++)
+    {
+        for (uint32_t j = 0; j < record_num; j++)
+        {
+            check_faciledb_search_result(p_faciledb_data_array[round][j], result_data_num[round][j], expected_data_result, 2);
+
+            for (uint32_t k = 0; k < result_data_num[round][j]; k++)
+            {
+                FacileDB_Api_Free_Data_Buffer(&(p_faciledb_data_array[round][j][k]));
+            }
+            free(p_faciledb_data_array[round][j]);
+        }
+    }
+
+    test_end(case_name);
+}
+
+void test_faciledb_make_index_and_search_string_case1()
+{
+    char case_name[] = "test_faciledb_make_index_and_search_string_case1";
+    test_start(case_name);
+
+    // set[0]: string index made by FacileDB_Api_Make_Record_Index.
+    // set[1]: 32-bit hash index created before the data are inserted, as the string indexes made by the former versions.
+    // set[2]: 64-bit hash index created before the data are inserted.
+    char db_set_name[3][64] = {"test_faciledb_make_index_and_search_string_case1", "test_faciledb_make_index_and_search_string_case1_hash", "test_faciledb_make_index_and_search_string_case1_hash64"};
+    char values[4][40] = {"long_string_sharing_the_prefix_a", "long_string_sharing_the_prefix_b", "short", "long_string_sharing_the_prefix_a"};
+    FACILEDB_RECORD_T records[4];
+    FACILEDB_DATA_T data[4];
+    FACILEDB_DATA_T expected_data_result[2];
+    uint32_t result_data_num[3][2] = {0}, prefix_result_length = 0;
+    FACILEDB_DATA_T *p_faciledb_data_array[3][2];
+    INDEX_ID_TYPE_E index_id_type[3];
+    INDEX_ID_TYPE_E dummy_index_id_type[3] = {INDEX_ID_TYPE_INVALID, INDEX_ID_TYPE_HASH, INDEX_ID_TYPE_HASH64};
+    INDEX_ID_STRING_T lower_index_id, upper_index_id;
+    HASH64_VALUE_T dummy_hash_value = 0;
+    DB_INDEX_PAYLOAD_T dummy_payload = {0};
+    void *p_prefix_result = NULL;
+    char *p_index_key[3];
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        records[i] = (FACILEDB_RECORD_T){.key_size = 2, .p_key = (void *)"s", .value_size = strlen(values[i]) + 1, .record_value_type = FACILEDB_RECORD_VALUE_TYPE_STRING, .p_value = values[i]};
+        data[i].record_num = 1;
+        data[i].p_data_records = &(records[i]);
+    }
+    expected_data_result[0] = data[0];
+    expected_data_result[1] = data[3];
+
+    FacileDB_Api_Init(test_faciledb_directory);
+    for (uint32_t set = 0; set < 3; set++)
+    {
+        p_index_key[set] = set_db_index_key(db_set_name[set], strlen(db_set_name[set]), "s", 2);
+        if (set > 0)
+        {
+            Index_Api_Insert_Element(p_index_key[set], &dummy_hash_value, dummy_index_id_type[set], &dummy_payload, sizeof(DB_INDEX_PAYLOAD_T));
+            Index_Api_Delete_Element(p_index_key[set], &dummy_hash_value, dummy_index_id_type[set], &dummy_payload, sizeof(DB_INDEX_PAYLOAD_T));
+        }
+
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            FacileDB_Api_Insert_Data(db_set_name[set], &(data[i]));
+        }
+        if (set == 0)
+        {
+            assert(FacileDB_Api_Make_Record_Index(db_set_name[set], &(records[0])));
+        }
+        index_id_type[set] = Index_Api_Get_Index_Id_Type(p_index_key[set]);
+
+        // The equal strings are verified by the records, the string sharing the prefix isn't matched.
+        p_faciledb_data_array[set][0] = FacileDB_Api_Search_Equal(db_set_name[set], &(records[0]), &(result_data_num[set][0]));
+        p_faciledb_data_array[set][1] = FacileDB_Api_Search_Equal(db_set_name[set], &(records[2]), &(result_data_num[set][1]));
+    }
+
+    // Prefix search on the string index, the strings sharing the truncated prefix are in hash order and rejected.
+    Index_Id_Type_Set_String_Prefix_Range(&lower_index_id, &upper_index_id, (uint8_t *)"long", 4);
+    assert(Index_Api_Search_Range(p_index_key[0], &lower_index_id, &upper_index_id, INDEX_ID_TYPE_STRING, &prefix_result_length) == NULL);
+    assert(prefix_result_length == 0);
+    Index_Id_Type_Set_String_Prefix_Range(&lower_index_id, &upper_index_id, (uint8_t *)"sho", 3);
+    p_prefix_result = Index_Api_Search_Range(p_index_key[0], &lower_index_id, &upper_index_id, INDEX_ID_TYPE_STRING, &prefix_result_length);
+    FacileDB_Api_Close();
+
+    // Check
+    {
+        assert(index_id_type[0] == INDEX_ID_TYPE_STRING);
+        assert(index_id_type[1] == INDEX_ID_TYPE_HASH);
+        assert(index_id_type[2] == INDEX_ID_TYPE_HASH64);
+        assert(prefix_result_length == 1);
+
+        for (uint32_t set = 0; set < 3; set++)
+        {
+            check_faciledb_search_result(p_faciledb_data_array[set][0], result_data_num[set][0], expected_data_result, 2);
+            check_faciledb_search_result(p_faciledb_data_array[set][1], result_data_num[set][1], &(data[2]), 1);
+        }
+    }
+
+    for (uint32_t set = 0; set < 3; set++)
+    {
+        for (uint32_t j = 0; j < 2; j++)
+        {
+            for (uint32_t k = 0; k < result_data_num[set][j]; k++)
+            {
+                FacileDB_Api_Free_Data_Buffer(&(p_faciledb_data_array[set][j][k]));
+            }
+            free(p_faciledb_data_array[set][j]);
+        }
+        free(p_index_key[set]);
+    }
+    Index_Api_Free_Search_Result(p_prefix_result);
+
+    test_end(case_name);
+}
+
+void test_faciledb_make_covering_index_and_search_case1()
+{
+    char case_name[] = "test_faciledb_make_covering_index_and_search_case1";
+    test_start(case_name);
+
+    // set[0]: covers the "name" records, set[1]: covers all the records.
+    char db_set_name[2][64] = {"test_faciledb_make_covering_index_and_search_case1", "test_faciledb_make_covering_index_and_search_case1_all"};
+    const uint32_t data_num = 6, id_num = 3;
+    uint32_t ids[6], ages[6], target_id = 0, missing_age = 20;
+    char names[6][16];
+    FACILEDB_RECORD_T records[6][3], covered_records[6][2];
+    FACILEDB_DATA_T data[6], expected_data_result[2], expected_covered_result[2];
+    FACILEDB_RECORD_T id_record = {.key_size = 3, .p_key = (void *)"id", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &target_id};
+    FACILEDB_RECORD_T age_record = {.key_size = 4, .p_key = (void *)"age", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &missing_age};
+    FACILEDB_RECORD_T name_key = {.key_size = 5, .p_key = (void *)"name"};
+    FACILEDB_DATA_T *p_faciledb_data_array[2][3];
+    uint32_t result_data_num[2][3] = {0}, delete_data_num[2] = {0};
+
+    for (uint32_t i = 0; i < data_num; i++)
+    {
+        ids[i] = i % id_num;
+        ages[i] = 20 + i;
+        sprintf(names[i], "name_%u", i);
+        records[i][0] = (FACILEDB_RECORD_T){.key_size = 3, .p_key = (void *)"id", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &(ids[i])};
+        records[i][1] = (FACILEDB_RECORD_T){.key_size = 5, .p_key = (void *)"name", .value_size = strlen(names[i]) + 1, .record_value_type = FACILEDB_RECORD_VALUE_TYPE_STRING, .p_value = names[i]};
+        records[i][2] = (FACILEDB_RECORD_T){.key_size = 4, .p_key = (void *)"age", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &(ages[i])};
+        covered_records[i][0] = records[i][0];
+        covered_records[i][1] = records[i][1];
+        data[i] = (FACILEDB_DATA_T){.record_num = 3, .p_data_records = records[i]};
+    }
+    // id 0: data[0] and data[3], id 1 is deleted.
+    expected_data_result[0] = data[0];
+    expected_data_result[1] = data[3];
+    expected_covered_result[0] = (FACILEDB_DATA_T){.record_num = 2, .p_data_records = covered_records[0]};
+    expected_covered_result[1] = (FACILEDB_DATA_T){.record_num = 2, .p_data_records = covered_records[3]};
+
+    FacileDB_Api_Init(test_faciledb_directory);
+    for (uint32_t set = 0; set < 2; set++)
+    {
+        // The existed data are stored by making the index, and the rest are stored by the insertions.
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            FacileDB_Api_Insert_Data(db_set_name[set], &(data[i]));
+        }
+        assert(FacileDB_Api_Make_Covering_Record_Index(db_set_name[set], &id_record, &name_key, (set == 0) ? 1 : 0));
+        for (uint32_t i = 4; i < data_num; i++)
+        {
+            FacileDB_Api_Insert_Data(db_set_name[set], &(data[i]));
+        }
+
+        target_id = 1;
+        delete_data_num[set] = FacileDB_Api_Delete_Equal(db_set_name[set], &id_record);
+        target_id = 0;
+
+        p_faciledb_data_array[set][0] = FacileDB_Api_Search_Equal(db_set_name[set], &id_record, &(result_data_num[set][0]));
+        p_faciledb_data_array[set][1] = FacileDB_Api_Search_Equal_Covered(db_set_name[set], &id_record, &(result_data_num[set][1]));
+        // The age records aren't indexed.
+        p_faciledb_data_array[set][2] = FacileDB_Api_Search_Equal_Covered(db_set_name[set], &age_record, &(result_data_num[set][2]));
+    }
+    FacileDB_Api_Close();
+
+    // Check
+    {
+        for (uint32_t set = 0; set < 2; set++)
+        {
+            assert(delete_data_num[set] == 2);
+            check_faciledb_search_result(p_faciledb_data_array[set][0], result_data_num[set][0], expected_data_result, 2);
+            check_faciledb_search_result(p_faciledb_data_array[set][1], result_data_num[set][1], (set == 0) ? expected_covered_result : expected_data_result, 2);
+            assert((p_faciledb_data_array[set][2] == NULL) && (result_data_num[set][2] == 0));
+        }
+    }
+
+    for (uint32_t set = 0; set < 2; set++)
+    {
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            for (uint32_t k = 0; k < result_data_num[set][j]; k++)
+            {
+                FacileDB_Api_Free_Data_Buffer(&(p_faciledb_data_array[set][j][k]));
+                free(p_faciledb_data_array[set][j][k].p_data_records);
+            }
+            free(p_faciledb_data_array[set][j]);
+        }
+    }
+
+    test_end(case_name);
+}
+
+void test_faciledb_index_catalog_case1()
+{
+    char case_name[] = "test_faciledb_index_catalog_case1";
+    test_start(case_name);
+
+    // The index is made by another process after the set is loaded by this process, it's found by the version of the catalog file.
+    char db_set_name[] = "test_faciledb_index_catalog_case1";
+    const uint32_t data_num = 8;
+    uint32_t ids[8], target_id = 0, result_data_num = 0, index_result_length = 0;
+    FACILEDB_RECORD_T records[8];
+    FACILEDB_DATA_T data[8], expected_data_result[4];
+    FACILEDB_RECORD_T id_record = {.key_size = 3, .p_key = (void *)"id", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &target_id};
+    FACILEDB_DATA_T *p_faciledb_data_array = NULL;
+    void *p_index_result = NULL;
+    char *p_index_key = set_db_index_key(db_set_name, strlen(db_set_name), "id", 3);
+    uint32_t catalog_entry_num[2] = {0};
+    int child_status = -1;
+    pid_t pid = 0;
+
+    for (uint32_t i = 0; i < data_num; i++)
+    {
+        ids[i] = i % 2;
+        records[i] = (FACILEDB_RECORD_T){.key_size = 3, .p_key = (void *)"id", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &(ids[i])};
+        data[i] = (FACILEDB_DATA_T){.record_num = 1, .p_data_records = &(records[i])};
+    }
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        expected_data_result[i] = data[i * 2];
+    }
+
+    FacileDB_Api_Init(test_faciledb_directory);
+    for (uint32_t i = 0; i < data_num / 2; i++)
+    {
+        FacileDB_Api_Insert_Data(db_set_name, &(data[i]));
+    }
+    catalog_entry_num[0] = db_set_info_instance[0].index_catalog.entry_num;
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0)
+    {
+        // Another process opens the db again and makes the index.
+        FacileDB_Api_Close();
+        FacileDB_Api_Init(test_faciledb_directory);
+        child_status = FacileDB_Api_Make_Record_Index(db_set_name, &id_record) ? 0 : 1;
+        FacileDB_Api_Close();
+        _exit(child_status);
+    }
+    assert(pid > 0);
+    waitpid(pid, &child_status, 0);
+
+    // The rest of the data are inserted into the index made by the other process.
+    for (uint32_t i = data_num / 2; i < data_num; i++)
+    {
+        FacileDB_Api_Insert_Data(db_set_name, &(data[i]));
+    }
+    catalog_entry_num[1] = db_set_info_instance[0].index_catalog.entry_num;
+    p_faciledb_data_array = FacileDB_Api_Search_Equal(db_set_name, &id_record, &result_data_num);
+    p_index_result = Index_Api_Search_Equal(p_index_key, &target_id, INDEX_ID_TYPE_UINT32, &index_result_length);
+    FacileDB_Api_Close();
+
+    // Check
+    {
+        assert(WIFEXITED(child_status) && (WEXITSTATUS(child_status) == 0));
+        assert(catalog_entry_num[0] == 0);
+        assert(catalog_entry_num[1] == 1);
+        assert(index_result_length == 4);
+        check_faciledb_search_result(p_faciledb_data_array, result_data_num, expected_data_result, 4);
+    }
+
+    for (uint32_t i = 0; i < result_data_num; i++)
+    {
+        FacileDB_Api_Free_Data_Buffer(&(p_faciledb_data_array[i]));
+        free(p_faciledb_data_array[i].p_data_records);
+    }
+    free(p_faciledb_data_array);
+    Index_Api_Free_Search_Result(p_index_result);
+    free(p_index_key);
+
+    test_end(case_name);
+}
+
+void test_faciledb_make_composite_index_and_search_case1()
+{
+    char case_name[] = "test_faciledb_make_composite_index_and_search_case1";
+    test_start(case_name);
+
+    // The composite index (city, age, name) is searched by the index id of all the keys or the range of the leading keys.
+    char db_set_name[] = "test_faciledb_make_composite_index_and_search_case1";
+    const uint32_t data_num = 13;
+    char names[13][4];
+    int32_t ages[13], target_age = 0;
+    FACILEDB_RECORD_T records[13][3];
+    FACILEDB_DATA_T data[13], expected_data_result[6];
+    FACILEDB_RECORD_T composite_records[3] = {
+        {.key_size = 5, .p_key = (void *)"city", .record_value_type = FACILEDB_RECORD_VALUE_TYPE_STRING},
+        {.key_size = 4, .p_key = (void *)"age", .record_value_type = FACILEDB_RECORD_VALUE_TYPE_INT32},
+        {.key_size = 5, .p_key = (void *)"name", .record_value_type = FACILEDB_RECORD_VALUE_TYPE_STRING}};
+    // The records of a search could be in any order.
+    FACILEDB_RECORD_T target_records[3] = {
+        {.key_size = 4, .p_key = (void *)"age", .value_size = sizeof(int32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_INT32, .p_value = &target_age},
+        {.key_size = 5, .p_key = (void *)"city", .value_size = 6, .record_value_type = FACILEDB_RECORD_VALUE_TYPE_STRING, .p_value = (void *)"tokyo"},
+        {.key_size = 5, .p_key = (void *)"name", .value_size = 4, .record_value_type = FACILEDB_RECORD_VALUE_TYPE_STRING, .p_value = (void *)"n10"}};
+    FACILEDB_RECORD_T city_record = {.key_size = 5, .p_key = (void *)"city", .value_size = 7, .record_value_type = FACILEDB_RECORD_VALUE_TYPE_STRING, .p_value = (void *)"taipei"};
+    FACILEDB_RECORD_T name_record = {.key_size = 5, .p_key = (void *)"name", .value_size = 4, .record_value_type = FACILEDB_RECORD_VALUE_TYPE_STRING, .p_value = (void *)"n04"};
+    // 0: (age, city) sequentially before the index is made, 1: (age, city) by the prefix, 2: (age, city, name) by the index id, 3: city by the prefix, 4: (age, city) after the deletion.
+    // The indexed results are in the order of the value tuples, the data without the name is the first one of its prefix.
+    FACILEDB_DATA_T *p_faciledb_data_array[5] = {NULL};
+    uint32_t result_data_num[5] = {0};
+    const uint32_t expected_data_positions[5][6] = {{4}, {12, 4, 10}, {10}, {3, 9, 1, 7, 5, 11}, {12, 10}};
+    const uint32_t expected_data_num[5] = {1, 3, 1, 6, 2};
+    char *p_index_key = NULL;
+    uint32_t index_element_num[2] = {0};
+    void *p_index_result[2] = {NULL};
+
+    // Even data are in tokyo, the ages are -1, 0 and 1, the last data is 0 years old without a name.
+    for (uint32_t i = 0; i < data_num; i++)
+    {
+        sprintf(names[i], "n%02u", i);
+        ages[i] = (i < data_num - 1) ? (int32_t)(i % 3) - 1 : 0;
+        records[i][0] = (FACILEDB_RECORD_T){.key_size = 5, .p_key = (void *)"city", .value_size = (i % 2) ? 7 : 6, .record_value_type = FACILEDB_RECORD_VALUE_TYPE_STRING, .p_value = (i % 2) ? (void *)"taipei" : (void *)"tokyo"};
+        records[i][1] = (FACILEDB_RECORD_T){.key_size = 4, .p_key = (void *)"age", .value_size = sizeof(int32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_INT32, .p_value = &(ages[i])};
+        records[i][2] = (FACILEDB_RECORD_T){.key_size = 5, .p_key = (void *)"name", .value_size = 4, .record_value_type = FACILEDB_RECORD_VALUE_TYPE_STRING, .p_value = names[i]};
+        data[i] = (FACILEDB_DATA_T){.record_num = (i < data_num - 1) ? 3 : 2, .p_data_records = records[i]};
+    }
+
+    FacileDB_Api_Init(test_faciledb_directory);
+    // The data are too few to read them by an index at the default cost of the random reads.
+    FacileDB_Api_Set_Search_Plan_Random_Block_Cost(0);
+    p_index_key = set_db_composite_index_key(&((DB_SET_PROPERTIES_T){.set_name_size = strlen(db_set_name), .p_set_name = db_set_name}),
+                                             (DB_COMPOSITE_COLUMN_T[3]){{.key_length = 4, .p_key = "city"}, {.key_length = 3, .p_key = "age"}, {.key_length = 4, .p_key = "name"}}, 3);
+
+    // Half of the data are indexed by the bulk build, the others are inserted into the index.
+    for (uint32_t i = 0; i < data_num / 2; i++)
+    {
+        FacileDB_Api_Insert_Data(db_set_name, &(data[i]));
+    }
+    // A composite index has more than one key, (age, city) is searched sequentially before the index is made.
+    assert(FacileDB_Api_Make_Composite_Record_Index(db_set_name, composite_records, 1) == false);
+    p_faciledb_data_array[0] = FacileDB_Api_Search_Equal_Records(db_set_name, target_records, 2, &(result_data_num[0]));
+
+    assert(FacileDB_Api_Make_Composite_Record_Index(db_set_name, composite_records, 3));
+    for (uint32_t i = data_num / 2; i < data_num; i++)
+    {
+        FacileDB_Api_Insert_Data(db_set_name, &(data[i]));
+    }
+    p_index_result[0] = Index_Api_Search_Range(p_index_key, NULL, NULL, INDEX_ID_TYPE_COMPOSITE, &(index_element_num[0]));
+
+    p_faciledb_data_array[1] = FacileDB_Api_Search_Equal_Records(db_set_name, target_records, 2, &(result_data_num[1]));
+    p_faciledb_data_array[2] = FacileDB_Api_Search_Equal_Records(db_set_name, target_records, 3, &(result_data_num[2]));
+    p_faciledb_data_array[3] = FacileDB_Api_Search_Equal(db_set_name, &city_record, &(result_data_num[3]));
+    assert(FacileDB_Api_Delete_Equal(db_set_name, &name_record) == 1);
+    p_faciledb_data_array[4] = FacileDB_Api_Search_Equal_Records(db_set_name, target_records, 2, &(result_data_num[4]));
+    p_index_result[1] = Index_Api_Search_Range(p_index_key, NULL, NULL, INDEX_ID_TYPE_COMPOSITE, &(index_element_num[1]));
+    FacileDB_Api_Set_Search_Plan_Random_Block_Cost(DB_SEARCH_PLAN_RANDOM_BLOCK_COST);
+    FacileDB_Api_Close();
+
+    // Check
+    {
+        assert(index_element_num[0] == data_num);
+        // The element of the deleted data is kept for the earlier snapshots.
+        assert(index_element_num[1] == data_num);
+        for (uint32_t i = 0; i < 5; i++)
+        {
+            for (uint32_t j = 0; j < expected_data_num[i]; j++)
+            {
+                expected_data_result[j] = data[expected_data_positions[i][j]];
+            }
+            check_faciledb_search_result(p_faciledb_data_array[i], result_data_num[i], expected_data_result, expected_data_num[i]);
+        }
+    }
+
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        for (uint32_t j = 0; j < result_data_num[i]; j++)
+        {
+            FacileDB_Api_Free_Data_Buffer(&(p_faciledb_data_array[i][j]));
+            free(p_faciledb_data_array[i][j].p_data_records);
+        }
+        free(p_faciledb_data_array[i]);
+    }
+    Index_Api_Free_Search_Result(p_index_result[0]);
+    Index_Api_Free_Search_Result(p_index_result[1]);
+    free(p_index_key);
+
+    test_end(case_name);
+}
+
+void test_faciledb_search_plan_case1()
+{
+    char case_name[] = "test_faciledb_search_plan_case1";
+    test_start(case_name);
+
+    // The frequent group is read sequentially, an id is read by its index.
+    char db_set_name[] = "test_faciledb_search_plan_case1";
+    const uint32_t data_num = 200;
+    uint32_t ids[200], groups[200], target_id = 7, target_group = 0, result_data_num[2] = {0}, expected_data_num = 0;
+    FACILEDB_RECORD_T records[200][2];
+    FACILEDB_DATA_T data[200], expected_data_result[200];
+    // {group, id}
+    FACILEDB_RECORD_T target_records[2] = {
+        {.key_size = 6, .p_key = (void *)"group", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &target_group},
+        {.key_size = 3, .p_key = (void *)"id", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &target_id}};
+    FACILEDB_RECORD_T name_record = {.key_size = 5, .p_key = (void *)"name", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &target_id};
+    // 0: group, 1: id, 2: {group, id}, 3: name which isn't indexed.
+    FACILEDB_SEARCH_PLAN_T search_plans[4];
+    FACILEDB_DATA_T *p_faciledb_data_array[2] = {NULL};
+
+    // 4 of 5 data are in group 0.
+    for (uint32_t i = 0; i < data_num; i++)
+    {
+        ids[i] = i;
+        groups[i] = (i % 5 == 0) ? i : 0;
+        records[i][0] = (FACILEDB_RECORD_T){.key_size = 6, .p_key = (void *)"group", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &(groups[i])};
+        records[i][1] = (FACILEDB_RECORD_T){.key_size = 3, .p_key = (void *)"id", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &(ids[i])};
+        data[i] = (FACILEDB_DATA_T){.record_num = 2, .p_data_records = records[i]};
+        if (groups[i] == 0)
+        {
+            expected_data_result[expected_data_num++] = data[i];
+        }
+    }
+
+    FacileDB_Api_Init(test_faciledb_directory);
+    for (uint32_t i = 0; i < data_num; i++)
+    {
+        FacileDB_Api_Insert_Data(db_set_name, &(data[i]));
+    }
+    assert(FacileDB_Api_Make_Record_Index(db_set_name, &(target_records[0])));
+    assert(FacileDB_Api_Make_Record_Index(db_set_name, &(target_records[1])));
+
+    assert(FacileDB_Api_Explain_Search_Equal_Records(db_set_name, &(target_records[0]), 1, &(search_plans[0])));
+    assert(FacileDB_Api_Explain_Search_Equal_Records(db_set_name, &(target_records[1]), 1, &(search_plans[1])));
+    assert(FacileDB_Api_Explain_Search_Equal_Records(db_set_name, target_records, 2, &(search_plans[2])));
+    assert(FacileDB_Api_Explain_Search_Equal_Records(db_set_name, &name_record, 1, &(search_plans[3])));
+    p_faciledb_data_array[0] = FacileDB_Api_Search_Equal(db_set_name, &(target_records[0]), &(result_data_num[0]));
+    p_faciledb_data_array[1] = FacileDB_Api_Search_Equal_Records(db_set_name, target_records, 2, &(result_data_num[1]));
+    FacileDB_Api_Close();
+
+    // Check
+    {
+        assert(search_plans[0].search_plan == FACILEDB_SEARCH_PLAN_SEQUENTIAL);
+        assert(search_plans[0].estimated_cost == search_plans[0].sequential_cost);
+        assert(search_plans[0].sequential_cost == data_num);
+        assert(search_plans[1].search_plan == FACILEDB_SEARCH_PLAN_INDEXED);
+        assert(search_plans[1].estimated_data_num <= 2);
+        assert(search_plans[1].estimated_cost < search_plans[1].sequential_cost);
+        assert(search_plans[2].search_plan == FACILEDB_SEARCH_PLAN_INDEXED);
+        assert(search_plans[2].record_position == 1);
+        assert(search_plans[3].search_plan == FACILEDB_SEARCH_PLAN_SEQUENTIAL);
+
+        check_faciledb_search_result(p_faciledb_data_array[0], result_data_num[0], expected_data_result, expected_data_num);
+        check_faciledb_search_result(p_faciledb_data_array[1], result_data_num[1], &(data[target_id]), 1);
+    }
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        for (uint32_t j = 0; j < result_data_num[i]; j++)
+        {
+            FacileDB_Api_Free_Data_Buffer(&(p_faciledb_data_array[i][j]));
+            free(p_faciledb_data_array[i][j].p_data_records);
+        }
+        free(p_faciledb_data_array[i]);
+    }
+
+    test_end(case_name);
+}
+
+void test_faciledb_snapshot_case1()
+{
+    char case_name[] = "test_faciledb_snapshot_case1";
+    test_start(case_name);
+
+    // The snapshot taken before the insert and the delete ignores both of them.
+    char db_set_name[] = "test_faciledb_snapshot_case1";
+    uint32_t values[4] = {1, 2, 1, 1};
+    FACILEDB_RECORD_T records[4];
+    FACILEDB_DATA_T data[4];
+    FACILEDB_RECORD_T search_record = {.key_size = 2, .p_key = (void *)"a", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &(values[0])};
+    DB_SET_INFO_T *p_db_set_info = NULL;
+    // 0: before the insert and the delete, 1: after them.
+    DB_SET_SNAPSHOT_T db_set_snapshots[2];
+    DB_RECORD_INFO_T target_db_record;
+    DB_DATA_INFO_T *p_db_data_infos[2] = {NULL};
+    uint32_t result_data_num[2] = {0}, delete_data_num = 0;
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        records[i] = (FACILEDB_RECORD_T){.key_size = 2, .p_key = (void *)"a", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &(values[i])};
+        data[i] = (FACILEDB_DATA_T){.record_num = 1, .p_data_records = &(records[i])};
+    }
+    db_record_info_init(&target_db_record);
+    shallow_assign_faciledb_record_to_db_record_info(&target_db_record, &search_record);
+
+    FacileDB_Api_Init(test_faciledb_directory);
+    FacileDB_Api_Insert_Data(db_set_name, &(data[0]));
+    FacileDB_Api_Insert_Data(db_set_name, &(data[1]));
+
+    p_db_set_info = load_and_lock_db_set_info(db_set_name);
+    read_db_set_snapshot(p_db_set_info, &(db_set_snapshots[0]));
+    unlock_db_set_info_sync(p_db_set_info);
+
+    // data 0 and 2 are deleted, data 3 is inserted after the delete.
+    FacileDB_Api_Insert_Data(db_set_name, &(data[2]));
+    delete_data_num = FacileDB_Api_Delete_Equal(db_set_name, &search_record);
+    FacileDB_Api_Insert_Data(db_set_name, &(data[3]));
+
+    p_db_set_info = load_and_lock_db_set_info(db_set_name);
+    read_db_set_snapshot(p_db_set_info, &(db_set_snapshots[1]));
+    unlock_db_set_info_sync(p_db_set_info);
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        p_db_data_infos[i] = search_db_data_sequential(p_db_set_info, &(db_set_snapshots[i]), &target_db_record, FACILEDB_RECORD_VALUE_TYPE_COMPARE_EQUAL, &(result_data_num[i]));
+    }
+    FacileDB_Api_Close();
+
+    // Check
+    {
+        assert(delete_data_num == 2);
+        assert(db_set_snapshots[0].block_num == 2);
+        assert(db_set_snapshots[1].block_num == 4);
+        assert(db_set_snapshots[1].delete_sequence == db_set_snapshots[0].delete_sequence + 1);
+
+        assert(result_data_num[0] == 1);
+        assert(p_db_data_infos[0][0].data_tag == 1);
+        assert(result_data_num[1] == 1);
+        assert(p_db_data_infos[1][0].data_tag == 4);
+    }
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        for (uint32_t j = 0; j < result_data_num[i]; j++)
+        {
+            free_db_data_info_resources(&(p_db_data_infos[i][j]));
+            free(p_db_data_infos[i][j].p_db_record_info);
+        }
+        free(p_db_data_infos[i]);
+    }
+
+    test_end(case_name);
+}
+
+// Appender thread of test_faciledb_append_case1, arg is the data inserted by the thread.
+void *test_faciledb_append_case1_appender(void *arg)
+{
+    FACILEDB_DATA_T *p_data = (FACILEDB_DATA_T *)arg;
+
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        FacileDB_Api_Insert_Data("test_faciledb_append_case1", p_data);
+    }
+
+    return NULL;
+}
+
+void test_faciledb_append_case1()
+{
+    char case_name[] = "test_faciledb_append_case1";
+    test_start(case_name);
+
+    // The appender threads write their reserved blocks together, the blocks reserved by a dead process are skipped.
+    char db_set_name[] = "test_faciledb_append_case1";
+    char text[] = "The data spans some blocks of the set file.";
+    uint32_t thread_ids[4];
+    FACILEDB_RECORD_T records[4][2];
+    FACILEDB_DATA_T data[4];
+    pthread_t threads[4];
+    FACILEDB_DATA_T *p_faciledb_data_array[4] = {NULL};
+    uint32_t result_data_num[4] = {0};
+    DB_SET_INFO_T *p_db_set_info = NULL;
+    DB_DATA_INFO_T db_data_info;
+    DB_SET_PROPERTIES_T db_set_properties;
+    uint64_t data_block_num = 0;
+    pid_t pid = 0;
+    int child_status = 0;
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        thread_ids[i] = i;
+        records[i][0] = (FACILEDB_RECORD_T){.key_size = 2, .p_key = (void *)"t", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &(thread_ids[i])};
+        records[i][1] = (FACILEDB_RECORD_T){.key_size = 5, .p_key = (void *)"text", .value_size = sizeof(text), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_STRING, .p_value = text};
+        data[i] = (FACILEDB_DATA_T){.record_num = 2, .p_data_records = records[i]};
+    }
+    db_data_info_init(&db_data_info);
+    shallow_assign_faciledb_data_to_db_data_info(&db_data_info, &(data[0]));
+    data_block_num = get_db_data_block_num(&db_data_info);
+    free(db_data_info.p_db_record_info);
+
+    FacileDB_Api_Init(test_faciledb_directory);
+    FacileDB_Api_Insert_Data(db_set_name, &(data[0]));
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0)
+    {
+        // Another process reserves the blocks and exits before publishing them.
+        DB_BLOCK_RESERVATION_T db_block_reservation;
+
+        FacileDB_Api_Close();
+        FacileDB_Api_Init(test_faciledb_directory);
+        p_db_set_info = load_and_lock_db_set_info(db_set_name);
+        db_set_info_sync_snapshot_write_wait(p_db_set_info, true);
+        reserve_db_set_blocks(p_db_set_info, &db_block_reservation, data_block_num);
+        _exit(0);
+    }
+    assert(pid > 0);
+    waitpid(pid, &child_status, 0);
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        pthread_create(&(threads[i]), NULL, test_faciledb_append_case1_appender, &(data[i]));
+    }
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        p_faciledb_data_array[i] = FacileDB_Api_Search_Equal(db_set_name, &(records[i][0]), &(result_data_num[i]));
+    }
+    p_db_set_info = load_and_lock_db_set_info(db_set_name);
+    db_set_properties = p_db_set_info->db_set_properties;
+    unlock_db_set_info_sync(p_db_set_info);
+    FacileDB_Api_Close();
+
+    // Check
+    {
+        assert(WIFEXITED(child_status) && (WEXITSTATUS(child_status) == 0));
+        assert(data_block_num > 1);
+        // The first data, the dead reservation and the data of the threads.
+        assert(db_set_properties.block_num == data_block_num * (1 + 1 + 4 * 8));
+        assert(db_set_properties.reserved_block_num == db_set_properties.block_num);
+        assert(db_set_properties.valid_record_num == 1 + 1 + 4 * 8);
+
+        assert(result_data_num[0] == 8 + 1);
+        for (uint32_t i = 1; i < 4; i++)
+        {
+            assert(result_data_num[i] == 8);
+            for (uint32_t j = 0; j < result_data_num[i]; j++)
+            {
+                check_faciledb_search_result(&(p_faciledb_data_array[i][j]), 1, &(data[i]), 1);
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        for (uint32_t j = 0; j < result_data_num[i]; j++)
+        {
+            FacileDB_Api_Free_Data_Buffer(&(p_faciledb_data_array[i][j]));
+            free(p_faciledb_data_array[i][j].p_data_records);
+        }
+        free(p_faciledb_data_array[i]);
+    }
+
+    test_end(case_name);
+}
+
+#if ENABLE_DB_INDEX
+void test_faciledb_snapshot_case2()
+{
+    char case_name[] = "test_faciledb_snapshot_case2";
+    test_start(case_name);
+
+    // The indexed, covered and composite searches by the snapshot taken before the delete still find the deleted data.
+    // set 0: index a, set 1: covering index a, set 2: composite index a + b.
+    char *db_set_name[3] = {"test_faciledb_snapshot_case2_index", "test_faciledb_snapshot_case2_covering", "test_faciledb_snapshot_case2_composite"};
+    uint32_t values[4] = {1, 2, 1, 1};
+    uint32_t b_value = 1;
+    FACILEDB_RECORD_T records[4][2];
+    FACILEDB_DATA_T data[4];
+    FACILEDB_RECORD_T search_records[2] = {
+        {.key_size = 2, .p_key = (void *)"a", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &(values[0])},
+        {.key_size = 2, .p_key = (void *)"b", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &b_value}};
+    DB_SET_INFO_T *p_db_set_info = NULL;
+    // 0: before the insert and the delete, 1: after them.
+    DB_SET_SNAPSHOT_T db_set_snapshots[2];
+    DB_RECORD_INFO_T target_db_records[2];
+    DB_DATA_INFO_T *p_db_data_infos[3][2] = {{NULL}};
+    uint32_t result_data_num[3][2] = {{0}}, delete_data_num[3] = {0};
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        records[i][0] = (FACILEDB_RECORD_T){.key_size = 2, .p_key = (void *)"a", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &(values[i])};
+        records[i][1] = (FACILEDB_RECORD_T){.key_size = 2, .p_key = (void *)"b", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &b_value};
+        data[i] = (FACILEDB_DATA_T){.record_num = 2, .p_data_records = records[i]};
+    }
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        db_record_info_init(&(target_db_records[i]));
+        shallow_assign_faciledb_record_to_db_record_info(&(target_db_records[i]), &(search_records[i]));
+    }
+
+    FacileDB_Api_Init(test_faciledb_directory);
+    for (uint32_t set = 0; set < 3; set++)
+    {
+        FacileDB_Api_Insert_Data(db_set_name[set], &(data[0]));
+        FacileDB_Api_Insert_Data(db_set_name[set], &(data[1]));
+        if (set == 0)
+        {
+            assert(FacileDB_Api_Make_Record_Index(db_set_name[set], &(search_records[0])));
+        }
+        else if (set == 1)
+        {
+            assert(FacileDB_Api_Make_Covering_Record_Index(db_set_name[set], &(search_records[0]), NULL, 0));
+        }
+        else
+        {
+            assert(FacileDB_Api_Make_Composite_Record_Index(db_set_name[set], search_records, 2));
+        }
+
+        p_db_set_info = load_and_lock_db_set_info(db_set_name[set]);
+        read_db_set_snapshot(p_db_set_info, &(db_set_snapshots[0]));
+        unlock_db_set_info_sync(p_db_set_info);
+
+        // data 0 and 2 are deleted, data 3 is inserted after the delete.
+        FacileDB_Api_Insert_Data(db_set_name[set], &(data[2]));
+        delete_data_num[set] = FacileDB_Api_Delete_Equal(db_set_name[set], &(search_records[0]));
+        FacileDB_Api_Insert_Data(db_set_name[set], &(data[3]));
+
+        p_db_set_info = load_and_lock_db_set_info(db_set_name[set]);
+        read_db_set_snapshot(p_db_set_info, &(db_set_snapshots[1]));
+        unlock_db_set_info_sync(p_db_set_info);
+
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            if (set < 2)
+            {
+                p_db_data_infos[set][i] = search_db_data_indexed(p_db_set_info, &(db_set_snapshots[i]), &(target_db_records[0]), FACILEDB_RECORD_VALUE_TYPE_COMPARE_EQUAL, &(result_data_num[set][i]), set == 1);
+            }
+            else
+            {
+                uint32_t leading_column_num = 0;
+                DB_INDEX_CATALOG_ENTRY_T *p_db_index_catalog_entry = query_db_composite_index_catalog_entry(p_db_set_info, target_db_records, 2, &leading_column_num);
+
+                assert(p_db_index_catalog_entry != NULL && leading_column_num == 2);
+                p_db_data_infos[set][i] = search_db_data_composite(p_db_set_info, &(db_set_snapshots[i]), p_db_index_catalog_entry, target_db_records, 2, &(result_data_num[set][i]));
+            }
+        }
+    }
+    FacileDB_Api_Close();
+
+    // Check
+    {
+        for (uint32_t set = 0; set < 3; set++)
+        {
+            assert(delete_data_num[set] == 2);
+
+            assert(result_data_num[set][0] == 1);
+            assert(p_db_data_infos[set][0][0].data_tag == 1);
+            assert(result_data_num[set][1] == 1);
+            assert(p_db_data_infos[set][1][0].data_tag == 4);
+        }
+    }
+
+    for (uint32_t set = 0; set < 3; set++)
+    {
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            for (uint32_t j = 0; j < result_data_num[set][i]; j++)
+            {
+                free_db_data_info_resources(&(p_db_data_infos[set][i][j]));
+                free(p_db_data_infos[set][i][j].p_db_record_info);
+            }
+            free(p_db_data_infos[set][i]);
+        }
+    }
+
+    test_end(case_name);
+}
+
+void test_faciledb_append_case2()
+{
+    char case_name[] = "test_faciledb_append_case2";
+    test_start(case_name);
+
+    // The covering entries written by a dead appender are not found by the covered search after its blocks are skipped.
+    char db_set_name[] = "test_faciledb_append_case2";
+    uint32_t values[3] = {0, 1, 2};
+    FACILEDB_RECORD_T records[3];
+    FACILEDB_DATA_T data[3];
+    FACILEDB_DATA_T *p_faciledb_data_array[3] = {NULL};
+    uint32_t result_data_num[3] = {0}, covered_data_num[3] = {0};
+    DB_SET_INFO_T *p_db_set_info = NULL;
+    DB_SET_PROPERTIES_T db_set_properties;
+    pid_t pid = 0;
+    int child_status = 0;
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        records[i] = (FACILEDB_RECORD_T){.key_size = 2, .p_key = (void *)"v", .value_size = sizeof(uint32_t), .record_value_type = FACILEDB_RECORD_VALUE_TYPE_UINT32, .p_value = &(values[i])};
+        data[i] = (FACILEDB_DATA_T){.record_num = 1, .p_data_records = &(records[i])};
+    }
+
+    FacileDB_Api_Init(test_faciledb_directory);
+    FacileDB_Api_Insert_Data(db_set_name, &(data[0]));
+    FacileDB_Api_Make_Covering_Record_Index(db_set_name, &(records[0]), NULL, 0);
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0)
+    {
+        // Another process writes the blocks and the index entries of data 1, and exits before publishing them.
+        DB_BLOCK_RESERVATION_T db_block_reservation;
+        DB_DATA_INFO_T db_data_info;
+
+        FacileDB_Api_Close();
+        FacileDB_Api_Init(test_faciledb_directory);
+        p_db_set_info = load_and_lock_db_set_info(db_set_name);
+        db_set_info_sync_snapshot_write_wait(p_db_set_info, true);
+        reserve_db_set_blocks(p_db_set_info, &db_block_reservation, 1);
+        unlock_db_set_info_sync(p_db_set_info);
+
+        db_data_info_init(&db_data_info);
+        shallow_assign_faciledb_data_to_db_data_info(&db_data_info, &(data[1]));
+        insert_db_data(p_db_set_info, &db_data_info, &db_block_reservation);
+        _exit(0);
+    }
+    assert(pid > 0);
+    waitpid(pid, &child_status, 0);
+
+    FacileDB_Api_Insert_Data(db_set_name, &(data[2]));
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        FACILEDB_DATA_T *p_covered_data_array = FacileDB_Api_Search_Equal_Covered(db_set_name, &(records[i]), &(covered_data_num[i]));
+
+        for (uint32_t j = 0; j < covered_data_num[i]; j++)
+        {
+            FacileDB_Api_Free_Data_Buffer(&(p_covered_data_array[j]));
+            free(p_covered_data_array[j].p_data_records);
+        }
+        free(p_covered_data_array);
+        p_faciledb_data_array[i] = FacileDB_Api_Search_Equal(db_set_name, &(records[i]), &(result_data_num[i]));
+    }
+    p_db_set_info = load_and_lock_db_set_info(db_set_name);
+    db_set_properties = p_db_set_info->db_set_properties;
+    unlock_db_set_info_sync(p_db_set_info);
+    FacileDB_Api_Close();
+
+    // Check
+    {
+        assert(WIFEXITED(child_status) && (WEXITSTATUS(child_status) == 0));
+        assert(db_set_properties.block_num == 3);
+        assert(db_set_properties.skipped_block_tag == 2);
+
+        assert((covered_data_num[0] == 1) && (covered_data_num[1] == 0) && (covered_data_num[2] == 1));
+        assert((result_data_num[0] == 1) && (result_data_num[1] == 0) && (result_data_num[2] == 1));
+        check_faciledb_search_result(p_faciledb_data_array[2], result_data_num[2], &(data[2]), 1);
+    }
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        for (uint32_t j = 0; j < result_data_num[i]; j++)
+        {
+            FacileDB_Api_Free_Data_Buffer(&(p_faciledb_data_array[i][j]));
+            free(p_faciledb_data_array[i][j].p_data_records);
+        }
+        free(p_faciledb_data_array[i]);
+    }
+
+    test_end(case_name);
+}
+#endif
+
 int main()
 {
     test_faciledb_init_and_close();
@@ -2223,11 +3343,24 @@ int main()
 
     test_faciledb_delete_case1();
     test_faciledb_delete_case2();
+    test_faciledb_open_set_file_case1();
+    test_faciledb_open_set_file_case2();
+    test_faciledb_snapshot_case1();
+    test_faciledb_append_case1();
 
 #if ENABLE_DB_INDEX
     test_faciledb_make_index_and_search_case1();
     test_faciledb_make_index_and_search_case2();
 
     test_faciledb_make_index_insert_and_search_case1();
+    test_faciledb_make_index_delete_and_search_case1();
+    test_faciledb_make_index_and_search_numeric_case1();
+    test_faciledb_make_index_and_search_string_case1();
+    test_faciledb_make_covering_index_and_search_case1();
+    test_faciledb_index_catalog_case1();
+    test_faciledb_make_composite_index_and_search_case1();
+    test_faciledb_search_plan_case1();
+    test_faciledb_snapshot_case2();
+    test_faciledb_append_case2();
 #endif
 }
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 #include <assert.h>
 
 #include "hash.c"
@@ -25,7 +26,47 @@ void test_hash()
     HASH_VALUE_T expected = 0x0b886aff;
 
     // printf("0x%llx\n", result);
-    assert(Hash_Compare(result, expected) == HASH_VALUE_COMPARE_EQUAL);
+    assert(Hash_Api_Compare(result, expected) == HASH_VALUE_COMPARE_EQUAL);
+
+    test_end(case_name);
+}
+
+void test_hash64()
+{
+    char case_name[] = "hash64";
+
+    test_start(case_name);
+
+    uint8_t buffer[160];
+    HASH64_VALUE_T results[129];
+
+    for (uint32_t i = 0; i < sizeof(buffer); i++)
+    {
+        buffer[i] = (uint8_t)(i * 7 + 1);
+    }
+
+    // Every length goes through a different path of reading the words, and the results should be different.
+    for (uint32_t length = 0; length <= 128; length++)
+    {
+        results[length] = Hash64(buffer, length);
+        for (uint32_t i = 0; i < length; i++)
+        {
+            assert(results[i] != results[length]);
+        }
+
+        // The result doesn't depend on the alignment of the input.
+        memmove(buffer + 3, buffer, length);
+        assert(Hash64(buffer + 3, length) == results[length]);
+        memmove(buffer, buffer + 3, length);
+    }
+
+    // A single bit change of the input changes the result.
+    for (uint32_t i = 0; i < 128; i++)
+    {
+        buffer[i] ^= 0x10;
+        assert(Hash64(buffer, 128) != results[128]);
+        buffer[i] ^= 0x10;
+    }
 
     test_end(case_name);
 }
@@ -33,4 +74,5 @@ void test_hash()
 int main()
 {
     test_hash();
+    test_hash64();
 }
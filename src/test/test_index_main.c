@@ -8,6 +8,10 @@
 #define INDEX_TEST (1)
 #define INDEX_ORDER (3)
 #define INDEX_PAYLOAD_SIZE (8)
+// The nodes in the index files are checked right after the insertions, test_index_write_buffer() enables the write buffer.
+#define INDEX_WRITE_BUFFER_ELEMENT_NUM (0)
+// The duplicated index ids are checked as separate elements, test_index_posting_list() enables the posting lists.
+#define INDEX_POSTING_LIST_MIN_LENGTH (0)
 
 #include "index.c"
 
@@ -35,6 +39,7 @@ void check_index_properties(INDEX_PROPERTIES_T *p_index_properties_1, INDEX_PROP
     assert(p_index_properties_1->tag_num == p_index_properties_2->tag_num);
     assert(p_index_properties_1->root_tag == p_index_properties_2->root_tag);
     assert(p_index_properties_1->index_id_type == p_index_properties_2->index_id_type);
+    assert(p_index_properties_1->order == p_index_properties_2->order);
     assert(p_index_properties_1->key_size == p_index_properties_2->key_size);
     assert(memcmp(p_index_properties_1->p_key, p_index_properties_2->p_key, p_index_properties_1->key_size) == 0);
 }
@@ -53,11 +58,11 @@ void check_index_node(INDEX_NODE_T *p_index_node_1, INDEX_NODE_T *p_index_node_2
     assert(p_index_node_1->child_tag[0] == p_index_node_2->child_tag[0]);
     for (uint32_t i = 0; i < p_index_node_1->length; i++)
     {
-        assert(memcmp(p_index_node_1->elements[i].p_index_id, p_index_node_2->elements[i].p_index_id, index_id_size) == 0);
+        assert(memcmp(get_index_node_index_id(p_index_node_1, i), get_index_node_index_id(p_index_node_2, i), index_id_size) == 0);
         // No need to check the element payload of non-leaf node.
         if (is_leaf_node)
         {
-            assert(memcmp(p_index_node_1->elements[i].index_payload, p_index_node_2->elements[i].index_payload, INDEX_PAYLOAD_SIZE) == 0);
+            assert(memcmp(get_index_node_payload(p_index_node_1, i), get_index_node_payload(p_index_node_2, i), INDEX_PAYLOAD_SIZE) == 0);
         }
         assert((p_index_node_1->child_tag[i + 1]) == (p_index_node_2->child_tag[i + 1]));
     }
@@ -78,13 +83,13 @@ void check_index_node(INDEX_NODE_T *p_index_node_1, INDEX_NODE_T *p_index_node_2
 //     {
 //         if (index_id_type == INDEX_ID_TYPE_UINT32)
 //         {
-//             uint32_t index_id = *((uint32_t *)p_index_node->elements[i].p_index_id);
+//             uint32_t index_id = *((uint32_t *)get_index_node_index_id(p_index_node, i));
 //             printf("element_index_id[%d]: %d\n", i, index_id);
 //         }
 
 //         if (INDEX_PAYLOAD_SIZE > 0)
 //         {
-//             printf("\telement_payload_first_char: %c\n", *((char *)(p_index_node->elements[i].index_payload)));
+//             printf("\telement_payload_first_char: %c\n", *((char *)get_index_node_payload(p_index_node, i)));
 //         }
 //     }
 // }
@@ -135,19 +140,20 @@ void test_index_insert_case1()
         expected_index_properties.tag_num = 1;
         expected_index_properties.root_tag = 1;
         expected_index_properties.index_id_type = index_id_type;
+        expected_index_properties.order = INDEX_ORDER;
         expected_index_properties.key_size = strlen(index_key);
         allocate_index_properties_resources(&expected_index_properties, expected_index_properties.key_size);
-        memcpy(expected_index_properties.p_key, index_key, strlen(index_key) + 1);
+        memcpy(expected_index_properties.p_key, index_key, strlen(index_key));
         check_index_properties(&(index_info.index_properties), &expected_index_properties);
 
         // check index node
-        index_node_init(&index_node, 1);
+        index_node_init(&index_node, 1, &(index_info.index_properties));
         read_index_node(&index_info, 1, &index_node);
 
-        index_node_init(&expected_index_node, 1);
+        index_node_init(&expected_index_node, 1, &(index_info.index_properties));
         expected_index_node.level = 0;
         expected_index_node.length = 1;
-        setup_index_element(&(expected_index_node.elements[0]), &target, index_id_type, payload, strlen(payload) * sizeof(char));
+        set_index_node_element(&expected_index_node, 0, &target, payload, strlen(payload) * sizeof(char));
         check_index_node(&index_node, &expected_index_node, index_id_type);
 
         // free check items
@@ -188,6 +194,7 @@ void test_index_insert_case11()
         INDEX_PROPERTIES_T expected_index_properties;
         INDEX_NODE_T index_node, expected_index_node;
 
+        index_info_init(&index_info);
         get_test_index_file_path(test_index_file_path, index_key);
         index_info.index_file = fopen(test_index_file_path, "rb");
         assert(index_info.index_file != NULL);
@@ -197,46 +204,47 @@ void test_index_insert_case11()
         expected_index_properties.tag_num = 8;
         expected_index_properties.root_tag = 8;
         expected_index_properties.index_id_type = index_id_type;
+        expected_index_properties.order = INDEX_ORDER;
         expected_index_properties.key_size = strlen(index_key);
         allocate_index_properties_resources(&expected_index_properties, expected_index_properties.key_size);
-        memcpy(expected_index_properties.p_key, index_key, strlen(index_key) + 1);
+        memcpy(expected_index_properties.p_key, index_key, strlen(index_key));
         check_index_properties(&(index_info.index_properties), &expected_index_properties);
 
         // check index nodes
         // Index node tag 1 (leaf node)
-        index_node_init(&index_node, 1);
+        index_node_init(&index_node, 1, &(index_info.index_properties));
         read_index_node(&index_info, 1, &index_node);
         // print_index_node(&index_node, index_id_type);
-        index_node_init(&expected_index_node, 1);
+        index_node_init(&expected_index_node, 1, &(index_info.index_properties));
         expected_index_node.level = 0;
         expected_index_node.length = 2;
         expected_index_node.parent_tag = 3;
         expected_index_node.next_tag = 2;
-        setup_index_element(&(expected_index_node.elements[0]), &(target[0]), index_id_type, payload[0], strlen(payload[0]) * sizeof(char));
-        setup_index_element(&(expected_index_node.elements[1]), &(target[1]), index_id_type, payload[1], strlen(payload[1]) * sizeof(char));
+        set_index_node_element(&expected_index_node, 0, &(target[0]), payload[0], strlen(payload[0]) * sizeof(char));
+        set_index_node_element(&expected_index_node, 1, &(target[1]), payload[1], strlen(payload[1]) * sizeof(char));
         check_index_node(&index_node, &expected_index_node, index_id_type);
 
         free_index_node_resources(&index_node);
         free_index_node_resources(&expected_index_node);
 
         // Index node tag 2 (leaf node)
-        index_node_init(&index_node, 2);
-        index_node_init(&expected_index_node, 2);
+        index_node_init(&index_node, 2, &(index_info.index_properties));
+        index_node_init(&expected_index_node, 2, &(index_info.index_properties));
         read_index_node(&index_info, 2, &index_node);
         expected_index_node.level = 0;
         expected_index_node.length = 2;
         expected_index_node.parent_tag = 3;
         expected_index_node.next_tag = 4;
-        setup_index_element(&(expected_index_node.elements[0]), &(target[2]), index_id_type, payload[2], strlen(payload[2]) * sizeof(char));
-        setup_index_element(&(expected_index_node.elements[1]), &(target[3]), index_id_type, payload[3], strlen(payload[3]) * sizeof(char));
+        set_index_node_element(&expected_index_node, 0, &(target[2]), payload[2], strlen(payload[2]) * sizeof(char));
+        set_index_node_element(&expected_index_node, 1, &(target[3]), payload[3], strlen(payload[3]) * sizeof(char));
         check_index_node(&index_node, &expected_index_node, index_id_type);
 
         free_index_node_resources(&index_node);
         free_index_node_resources(&expected_index_node);
 
         // Index node tag 3 (non-leaf node)
-        index_node_init(&index_node, 3);
-        index_node_init(&expected_index_node, 3);
+        index_node_init(&index_node, 3, &(index_info.index_properties));
+        index_node_init(&expected_index_node, 3, &(index_info.index_properties));
         read_index_node(&index_info, 3, &index_node);
         expected_index_node.level = 1;
         expected_index_node.length = 2;
@@ -245,86 +253,86 @@ void test_index_insert_case11()
         expected_index_node.child_tag[0] = 1;
         expected_index_node.child_tag[1] = 2;
         expected_index_node.child_tag[2] = 4;
-        setup_index_element(&(expected_index_node.elements[0]), &(target[2]), index_id_type, NULL, 0);
-        setup_index_element(&(expected_index_node.elements[1]), &(target[4]), index_id_type, NULL, 0);
+        set_index_node_element(&expected_index_node, 0, &(target[2]), NULL, 0);
+        set_index_node_element(&expected_index_node, 1, &(target[4]), NULL, 0);
         check_index_node(&index_node, &expected_index_node, index_id_type);
 
         free_index_node_resources(&index_node);
         free_index_node_resources(&expected_index_node);
 
         // Index node tag 4 (leaf node)
-        index_node_init(&index_node, 4);
+        index_node_init(&index_node, 4, &(index_info.index_properties));
         read_index_node(&index_info, 4, &index_node);
-        index_node_init(&expected_index_node, 4);
+        index_node_init(&expected_index_node, 4, &(index_info.index_properties));
         expected_index_node.level = 0;
         expected_index_node.length = 2;
         expected_index_node.parent_tag = 3;
         expected_index_node.next_tag = 5;
-        setup_index_element(&(expected_index_node.elements[0]), &(target[4]), index_id_type, payload[4], strlen(payload[4]) * sizeof(char));
-        setup_index_element(&(expected_index_node.elements[1]), &(target[5]), index_id_type, payload[5], strlen(payload[5]) * sizeof(char));
+        set_index_node_element(&expected_index_node, 0, &(target[4]), payload[4], strlen(payload[4]) * sizeof(char));
+        set_index_node_element(&expected_index_node, 1, &(target[5]), payload[5], strlen(payload[5]) * sizeof(char));
         check_index_node(&index_node, &expected_index_node, index_id_type);
 
         free_index_node_resources(&index_node);
         free_index_node_resources(&expected_index_node);
 
         // Index node tag 5 (leaf node)
-        index_node_init(&index_node, 5);
+        index_node_init(&index_node, 5, &(index_info.index_properties));
         read_index_node(&index_info, 5, &index_node);
-        index_node_init(&expected_index_node, 5);
+        index_node_init(&expected_index_node, 5, &(index_info.index_properties));
         expected_index_node.level = 0;
         expected_index_node.length = 2;
         expected_index_node.parent_tag = 7;
         expected_index_node.next_tag = 6;
-        setup_index_element(&(expected_index_node.elements[0]), &(target[6]), index_id_type, payload[6], strlen(payload[6]) * sizeof(char));
-        setup_index_element(&(expected_index_node.elements[1]), &(target[7]), index_id_type, payload[7], strlen(payload[7]) * sizeof(char));
+        set_index_node_element(&expected_index_node, 0, &(target[6]), payload[6], strlen(payload[6]) * sizeof(char));
+        set_index_node_element(&expected_index_node, 1, &(target[7]), payload[7], strlen(payload[7]) * sizeof(char));
         check_index_node(&index_node, &expected_index_node, index_id_type);
 
         free_index_node_resources(&index_node);
         free_index_node_resources(&expected_index_node);
 
         // Index node tag 6 (leaf node)
-        index_node_init(&index_node, 6);
+        index_node_init(&index_node, 6, &(index_info.index_properties));
         read_index_node(&index_info, 6, &index_node);
-        index_node_init(&expected_index_node, 6);
+        index_node_init(&expected_index_node, 6, &(index_info.index_properties));
         expected_index_node.level = 0;
         expected_index_node.length = 3;
         expected_index_node.parent_tag = 7;
         expected_index_node.next_tag = 0;
-        setup_index_element(&(expected_index_node.elements[0]), &(target[8]), index_id_type, payload[8], strlen(payload[8]) * sizeof(char));
-        setup_index_element(&(expected_index_node.elements[1]), &(target[9]), index_id_type, payload[9], strlen(payload[9]) * sizeof(char));
-        setup_index_element(&(expected_index_node.elements[2]), &(target[10]), index_id_type, payload[10], strlen(payload[10]) * sizeof(char));
+        set_index_node_element(&expected_index_node, 0, &(target[8]), payload[8], strlen(payload[8]) * sizeof(char));
+        set_index_node_element(&expected_index_node, 1, &(target[9]), payload[9], strlen(payload[9]) * sizeof(char));
+        set_index_node_element(&expected_index_node, 2, &(target[10]), payload[10], strlen(payload[10]) * sizeof(char));
         check_index_node(&index_node, &expected_index_node, index_id_type);
 
         free_index_node_resources(&index_node);
         free_index_node_resources(&expected_index_node);
 
         // Index node tag 7 (non-leaf node)
-        index_node_init(&index_node, 7);
+        index_node_init(&index_node, 7, &(index_info.index_properties));
         read_index_node(&index_info, 7, &index_node);
-        index_node_init(&expected_index_node, 7);
+        index_node_init(&expected_index_node, 7, &(index_info.index_properties));
         expected_index_node.level = 1;
         expected_index_node.length = 1;
         expected_index_node.parent_tag = 8;
         expected_index_node.next_tag = 0;
         expected_index_node.child_tag[0] = 5;
         expected_index_node.child_tag[1] = 6;
-        setup_index_element(&(expected_index_node.elements[0]), &(target[8]), index_id_type, payload[8], strlen(payload[8]) * sizeof(char));
+        set_index_node_element(&expected_index_node, 0, &(target[8]), payload[8], strlen(payload[8]) * sizeof(char));
         check_index_node(&index_node, &expected_index_node, index_id_type);
 
         free_index_node_resources(&index_node);
         free_index_node_resources(&expected_index_node);
 
         // Index node tag 8 (root node)
-        index_node_init(&index_node, 8);
+        index_node_init(&index_node, 8, &(index_info.index_properties));
         read_index_node(&index_info, 8, &index_node);
-        index_node_init(&expected_index_node, 8);
+        index_node_init(&expected_index_node, 8, &(index_info.index_properties));
         expected_index_node.level = 2;
         expected_index_node.length = 1;
         expected_index_node.parent_tag = 0;
         expected_index_node.next_tag = 0;
         expected_index_node.child_tag[0] = 3;
         expected_index_node.child_tag[1] = 7;
-        setup_index_element(&(expected_index_node.elements[0]), &(target[6]), index_id_type, payload[6], strlen(payload[6]) * sizeof(char));
+        set_index_node_element(&expected_index_node, 0, &(target[6]), payload[6], strlen(payload[6]) * sizeof(char));
         check_index_node(&index_node, &expected_index_node, index_id_type);
 
         free_index_node_resources(&index_node);
@@ -456,6 +464,1260 @@ void test_index_search_case11()
     test_end(case_name);
 }
 
+void test_index_search_duplicated_ids()
+{
+    char case_name[] = "test_index_search_duplicated_ids";
+    test_start(case_name);
+
+    char p_index_key[] = "test_index_search_duplicated_ids";
+    INDEX_ID_TYPE_E index_id_type = INDEX_ID_TYPE_UINT32;
+    const uint32_t element_num = 300, target_num = 2;
+    uint32_t expected_length[2] = {0};
+    uint32_t result_length[2] = {0};
+    void *result[2];
+
+    // Duplicated ids are split into many leaf nodes, and the same id becomes the separator of several child nodes.
+    Index_Api_Init(test_index_directory);
+    for (uint32_t i = 0; i < element_num; i++)
+    {
+        uint32_t target = ((i * 37) % element_num) % target_num;
+        char payload[INDEX_PAYLOAD_SIZE] = {0};
+
+        payload[0] = (char)target;
+        Index_Api_Insert_Element(p_index_key, &target, index_id_type, payload, INDEX_PAYLOAD_SIZE);
+        expected_length[target]++;
+    }
+    for (uint32_t target = 0; target < target_num; target++)
+    {
+        result[target] = Index_Api_Search_Equal(p_index_key, &target, index_id_type, &(result_length[target]));
+    }
+    Index_Api_Close();
+
+    // check
+    {
+        for (uint32_t target = 0; target < target_num; target++)
+        {
+            assert(result_length[target] == expected_length[target]);
+            for (uint32_t i = 0; i < result_length[target]; i++)
+            {
+                assert(((char *)result[target])[INDEX_PAYLOAD_SIZE * i] == (char)target);
+            }
+        }
+    } // check
+
+    for (uint32_t target = 0; target < target_num; target++)
+    {
+        Index_Api_Free_Search_Result(result[target]);
+    }
+
+    test_end(case_name);
+}
+
+// Map the test value into the index id type monotonically, unsigned ids also cover the values with the top bit set.
+void set_test_index_id(void *p_index_id, INDEX_ID_TYPE_E index_id_type, int32_t value)
+{
+    switch (index_id_type)
+    {
+    case INDEX_ID_TYPE_HASH:
+    case INDEX_ID_TYPE_UINT32:
+        *(uint32_t *)p_index_id = (uint32_t)(value + 50) * 0x02000000U;
+        break;
+    case INDEX_ID_TYPE_INT32:
+        *(int32_t *)p_index_id = value * 0x01000000;
+        break;
+    case INDEX_ID_TYPE_UINT64:
+    case INDEX_ID_TYPE_HASH64:
+        *(uint64_t *)p_index_id = (uint64_t)(value + 50) * 0x0200000000000000ULL;
+        break;
+    case INDEX_ID_TYPE_INT64:
+        *(int64_t *)p_index_id = (int64_t)value * 0x0100000000000000LL;
+        break;
+    case INDEX_ID_TYPE_FLOAT:
+        *(float *)p_index_id = (float)value * 0.5f;
+        break;
+    case INDEX_ID_TYPE_DOUBLE:
+        *(double *)p_index_id = (double)value * 0.5;
+        break;
+    case INDEX_ID_TYPE_STRING:
+    {
+        char string[16];
+        sprintf(string, "%03d", value + 50);
+        Index_Id_Type_Set_String(p_index_id, (uint8_t *)string, sizeof(string));
+        break;
+    }
+    case INDEX_ID_TYPE_COMPOSITE:
+    {
+        // (value, "x") keeps the order of the values by the encoded int32 column.
+        uint8_t encoded_columns[16];
+        uint32_t encoded_columns_size = Index_Id_Type_Encode_Composite_Column(encoded_columns, INDEX_ID_TYPE_INT32, &value, sizeof(value));
+        encoded_columns_size += Index_Id_Type_Encode_Composite_Column(encoded_columns + encoded_columns_size, INDEX_ID_TYPE_STRING, "x", sizeof("x"));
+        Index_Id_Type_Set_Composite(p_index_id, encoded_columns, encoded_columns_size);
+        break;
+    }
+    default:
+        assert(0);
+    }
+}
+
+void test_index_id_search_lower_bound()
+{
+    char case_name[] = "test_index_id_search_lower_bound";
+    test_start(case_name);
+
+    const uint32_t max_length = 70;
+    int32_t values[70];
+    // large enough for all index id types
+    uint64_t index_ids[70 * INDEX_ID_MAX_SIZE / sizeof(uint64_t)];
+    uint64_t target_index_id[INDEX_ID_MAX_SIZE / sizeof(uint64_t)];
+
+    for (uint32_t index_id_type = 0; index_id_type < INDEX_ID_TYPE_NUM; index_id_type++)
+    {
+        uint32_t index_id_size = Index_Id_Type_Get_Size(index_id_type);
+
+        for (uint32_t isa = 0; isa < INDEX_ID_SEARCH_ISA_NUM; isa++)
+        {
+            INDEX_ID_SEARCH_LOWER_BOUND_FUNCTION_T lower_bound_function = Index_Id_Search_Get_Lower_Bound_Function_By_Isa(index_id_type, isa);
+
+            if (lower_bound_function == NULL)
+            {
+                // not supported by the CPU
+                assert(isa != INDEX_ID_SEARCH_ISA_SCALAR);
+                continue;
+            }
+
+            for (uint32_t length = 0; length <= max_length; length++)
+            {
+                // Sorted values in [-40, 40] with duplicates.
+                for (uint32_t i = 0; i < length; i++)
+                {
+                    values[i] = -40 + (int32_t)((i * 80) / max_length) + (int32_t)(i % 3 == 0);
+                    set_test_index_id((uint8_t *)index_ids + (i * index_id_size), index_id_type, values[i]);
+                }
+
+                // Targets before, between, equal to and after the index ids.
+                for (int32_t target = -45; target <= 45; target++)
+                {
+                    uint32_t expected_position = 0;
+
+                    for (uint32_t i = 0; i < length; i++)
+                    {
+                        expected_position += (values[i] < target);
+                    }
+                    set_test_index_id(target_index_id, index_id_type, target);
+                    assert(lower_bound_function(index_ids, length, target_index_id) == expected_position);
+                }
+            }
+        }
+    }
+
+    test_end(case_name);
+}
+
+void test_index_bulk_build()
+{
+    char case_name[] = "test_index_bulk_build";
+    test_start(case_name);
+
+    char p_index_key[] = "test_index_bulk_build";
+    INDEX_ID_TYPE_E index_id_type = INDEX_ID_TYPE_UINT32;
+    const uint32_t element_num = 1000, id_num = 500, appended_element_num = 3;
+    uint32_t index_ids[1000], payloads[1000];
+    uint32_t appended_index_ids[3] = {9, 9, 9}, appended_payloads[3] = {1001, 1002, 1003};
+    uint32_t inserted_index_id = 7, inserted_payload = 1000;
+
+    // Each index id appears twice, in a scattered order.
+    for (uint32_t i = 0; i < element_num; i++)
+    {
+        index_ids[i] = (i * 7919) % id_num;
+        payloads[i] = i;
+    }
+
+    Index_Api_Init(test_index_directory);
+    Index_Api_Set_Bulk_Build_Fill_Factor(100);
+    Index_Api_Bulk_Build(p_index_key, index_id_type, index_ids, payloads, sizeof(uint32_t), element_num);
+    Index_Api_Set_Bulk_Build_Fill_Factor(INDEX_BULK_BUILD_FILL_FACTOR);
+
+    // check the packed nodes
+    {
+        char index_file_path[INDEX_FILE_PATH_BUFFER_LENGTH] = {0};
+        INDEX_INFO_T index_info;
+
+        index_info_init(&index_info);
+        get_test_index_file_path(index_file_path, p_index_key);
+        index_info.index_file = fopen(index_file_path, "rb");
+        assert(index_info.index_file != NULL);
+        read_index_properties(&index_info);
+
+        // 334 leaf nodes with 3 elements, then 84, 21, 6, 2 and 1 non-leaf nodes with 4 child tags.
+        assert(index_info.index_properties.tag_num == 448);
+        assert(index_info.index_properties.root_tag == 448);
+
+        close_index_info(&index_info);
+    } // check
+
+    // Insert after the bulk build, and bulk build into the non-empty index.
+    Index_Api_Insert_Element(p_index_key, &inserted_index_id, index_id_type, &inserted_payload, sizeof(uint32_t));
+    Index_Api_Bulk_Build(p_index_key, index_id_type, appended_index_ids, appended_payloads, sizeof(uint32_t), appended_element_num);
+
+    // check
+    {
+        for (uint32_t target = 0; target < id_num; target++)
+        {
+            uint32_t result_length = 0, expected_length = 0;
+            uint8_t *result = Index_Api_Search_Equal(p_index_key, &target, index_id_type, &result_length);
+
+            // Payloads are returned in the input order.
+            for (uint32_t i = 0; i < element_num; i++)
+            {
+                if (index_ids[i] == target)
+                {
+                    assert(expected_length < result_length);
+                    assert(memcmp(result + (INDEX_PAYLOAD_SIZE * expected_length), &(payloads[i]), sizeof(uint32_t)) == 0);
+                    expected_length++;
+                }
+            }
+            if (target == inserted_index_id)
+            {
+                assert(memcmp(result + (INDEX_PAYLOAD_SIZE * expected_length), &inserted_payload, sizeof(uint32_t)) == 0);
+                expected_length++;
+            }
+            for (uint32_t i = 0; i < appended_element_num; i++)
+            {
+                if (appended_index_ids[i] == target)
+                {
+                    assert(memcmp(result + (INDEX_PAYLOAD_SIZE * expected_length), &(appended_payloads[i]), sizeof(uint32_t)) == 0);
+                    expected_length++;
+                }
+            }
+            assert(result_length == expected_length);
+
+            Index_Api_Free_Search_Result(result);
+        }
+    } // check
+
+    Index_Api_Close();
+
+    test_end(case_name);
+}
+
+// Check the parent tags, the underflow and the order of the subtree, return the number of elements in the leaf nodes.
+uint32_t check_index_subtree(INDEX_INFO_T *p_index_info, uint32_t tag, uint32_t parent_tag)
+{
+    INDEX_NODE_T index_node;
+    uint32_t element_num = 0;
+
+    index_node_init(&index_node, tag, &(p_index_info->index_properties));
+    assert(read_index_node(p_index_info, tag, &index_node));
+    assert(index_node.parent_tag == parent_tag);
+    assert((parent_tag == 0) || (index_node.length >= get_index_node_min_length(index_node.order)));
+
+    for (uint32_t i = 1; i < index_node.length; i++)
+    {
+        assert(*(uint32_t *)get_index_node_index_id(&index_node, i - 1) <= *(uint32_t *)get_index_node_index_id(&index_node, i));
+    }
+
+    if (index_node.child_tag[0] == 0)
+    {
+        element_num = index_node.length;
+    }
+    else
+    {
+        for (uint32_t i = 0; i <= index_node.length; i++)
+        {
+            element_num += check_index_subtree(p_index_info, index_node.child_tag[i], tag);
+        }
+    }
+
+    free_index_node_resources(&index_node);
+    return element_num;
+}
+
+void check_index_tree(char *p_index_key, uint32_t expected_element_num)
+{
+    char index_file_path[INDEX_FILE_PATH_BUFFER_LENGTH] = {0};
+    INDEX_INFO_T index_info;
+
+    index_info_init(&index_info);
+    get_test_index_file_path(index_file_path, p_index_key);
+    index_info.index_file = fopen(index_file_path, "rb");
+    assert(index_info.index_file != NULL);
+    read_index_properties(&index_info);
+
+    assert(check_index_subtree(&index_info, index_info.index_properties.root_tag, 0) == expected_element_num);
+
+    close_index_info(&index_info);
+}
+
+void test_index_delete_element()
+{
+    char case_name[] = "test_index_delete_element";
+    test_start(case_name);
+
+    char p_index_key[] = "test_index_delete_element";
+    INDEX_ID_TYPE_E index_id_type = INDEX_ID_TYPE_UINT32;
+    const uint32_t element_num = 400, id_num = 100;
+    uint32_t missing_index_id = id_num, missing_payload = element_num;
+    uint32_t remaining_num = element_num;
+    bool is_deleted[400] = {false};
+
+    Index_Api_Init(test_index_directory);
+    for (uint32_t i = 0; i < element_num; i++)
+    {
+        uint32_t index_id = (i * 13) % id_num;
+        Index_Api_Insert_Element(p_index_key, &index_id, index_id_type, &i, sizeof(uint32_t));
+    }
+
+    // Delete the elements which don't exist.
+    assert(Index_Api_Delete_Element(p_index_key, &missing_index_id, index_id_type, &missing_payload, sizeof(uint32_t)) == false);
+    missing_index_id = 0;
+    assert(Index_Api_Delete_Element(p_index_key, &missing_index_id, index_id_type, &missing_payload, sizeof(uint32_t)) == false);
+    assert(Index_Api_Delete_Element("test_index_delete_element_missing", &missing_index_id, index_id_type, &missing_payload, sizeof(uint32_t)) == false);
+
+    // Delete two thirds of the elements in a scattered order, then delete the rest.
+    for (uint32_t round = 0; round < 2; round++)
+    {
+        for (uint32_t k = 0; k < element_num; k++)
+        {
+            uint32_t i = (k * 7) % element_num;
+            uint32_t index_id = (i * 13) % id_num;
+
+            if (is_deleted[i] || ((round == 0) && (i % 3 == 0)))
+            {
+                continue;
+            }
+
+            assert(Index_Api_Delete_Element(p_index_key, &index_id, index_id_type, &i, sizeof(uint32_t)));
+            is_deleted[i] = true;
+            remaining_num--;
+        }
+
+        // check
+        {
+            for (uint32_t target = 0; target < id_num; target++)
+            {
+                uint32_t result_length = 0, expected_length = 0;
+                uint8_t *result = Index_Api_Search_Equal(p_index_key, &target, index_id_type, &result_length);
+
+                for (uint32_t i = 0; i < element_num; i++)
+                {
+                    if (((i * 13) % id_num == target) && (is_deleted[i] == false))
+                    {
+                        assert(expected_length < result_length);
+                        assert(memcmp(result + (INDEX_PAYLOAD_SIZE * expected_length), &i, sizeof(uint32_t)) == 0);
+                        expected_length++;
+                    }
+                }
+                assert(result_length == expected_length);
+
+                Index_Api_Free_Search_Result(result);
+            }
+            check_index_tree(p_index_key, remaining_num);
+        } // check
+    }
+    Index_Api_Close();
+
+    assert(remaining_num == 0);
+
+    test_end(case_name);
+}
+
+// The uint32 payload at the position of the search result.
+uint32_t get_test_index_payload(uint8_t *p_result, uint32_t position)
+{
+    uint32_t payload = 0;
+    memcpy(&payload, p_result + (INDEX_PAYLOAD_SIZE * position), sizeof(uint32_t));
+    return payload;
+}
+
+void test_index_search_range()
+{
+    char case_name[] = "test_index_search_range";
+    test_start(case_name);
+
+    char p_index_key[] = "test_index_search_range";
+    INDEX_ID_TYPE_E index_id_type = INDEX_ID_TYPE_STRING;
+    const uint32_t element_num = 200, long_string_num = 5;
+    char strings[205][40];
+    INDEX_ID_STRING_T index_id, lower_index_id, upper_index_id;
+    uint32_t result_length = 0;
+    uint8_t *result = NULL;
+
+    // Every short string is inserted twice, the long strings share the leading INDEX_ID_STRING_PREFIX_SIZE bytes.
+    for (uint32_t i = 0; i < element_num; i++)
+    {
+        sprintf(strings[i], "key_%03u", (i * 37) % (element_num / 2));
+    }
+    for (uint32_t i = element_num; i < element_num + long_string_num; i++)
+    {
+        sprintf(strings[i], "long_prefix_shared_by_all_%u", i);
+    }
+
+    Index_Api_Init(test_index_directory);
+    assert(Index_Api_Get_Index_Id_Type(p_index_key) == INDEX_ID_TYPE_INVALID);
+    for (uint32_t i = 0; i < element_num + long_string_num; i++)
+    {
+        Index_Id_Type_Set_String(&index_id, (uint8_t *)strings[i], sizeof(strings[i]));
+        Index_Api_Insert_Element(p_index_key, &index_id, index_id_type, &i, sizeof(uint32_t));
+    }
+    assert(Index_Api_Get_Index_Id_Type(p_index_key) == INDEX_ID_TYPE_STRING);
+
+    // The long strings are ordered by hash, a range covering more than one of them is rejected.
+    result = Index_Api_Search_Range(p_index_key, NULL, NULL, index_id_type, &result_length);
+    assert((result == NULL) && (result_length == 0));
+
+    // Sorted iteration: the short strings are in lexicographic order, and the equal ones are in insertion order.
+    Index_Id_Type_Set_String(&upper_index_id, (uint8_t *)"key_099", 8);
+    result = Index_Api_Search_Range(p_index_key, NULL, &upper_index_id, index_id_type, &result_length);
+    assert(result_length == element_num);
+    for (uint32_t i = 1; i < result_length; i++)
+    {
+        int compare_result = strcmp(strings[get_test_index_payload(result, i - 1)], strings[get_test_index_payload(result, i)]);
+        assert((compare_result < 0) || ((compare_result == 0) && (get_test_index_payload(result, i - 1) < get_test_index_payload(result, i))));
+    }
+    Index_Api_Free_Search_Result(result);
+
+    // Range, both bounds are included.
+    Index_Id_Type_Set_String(&lower_index_id, (uint8_t *)"key_010", 8);
+    Index_Id_Type_Set_String(&upper_index_id, (uint8_t *)"key_019", 8);
+    result = Index_Api_Search_Range(p_index_key, &lower_index_id, &upper_index_id, index_id_type, &result_length);
+    assert(result_length == 20);
+    for (uint32_t i = 0; i < result_length; i++)
+    {
+        assert((strcmp(strings[get_test_index_payload(result, i)], "key_010") >= 0) && (strcmp(strings[get_test_index_payload(result, i)], "key_019") <= 0));
+    }
+    Index_Api_Free_Search_Result(result);
+
+    // Prefix
+    assert(Index_Id_Type_Set_String_Prefix_Range(&lower_index_id, &upper_index_id, (uint8_t *)"key_05", 6));
+    result = Index_Api_Search_Range(p_index_key, &lower_index_id, &upper_index_id, index_id_type, &result_length);
+    assert(result_length == 20);
+    for (uint32_t i = 0; i < result_length; i++)
+    {
+        assert(strncmp(strings[get_test_index_payload(result, i)], "key_05", 6) == 0);
+    }
+    Index_Api_Free_Search_Result(result);
+
+    // The prefix longer than the string index id matches all the long strings in hash order, the range is rejected.
+    assert(Index_Id_Type_Set_String_Prefix_Range(&lower_index_id, &upper_index_id, (uint8_t *)"long_prefix_shared_by_all_201", 30) == false);
+    result = Index_Api_Search_Range(p_index_key, &lower_index_id, &upper_index_id, index_id_type, &result_length);
+    assert((result == NULL) && (result_length == 0));
+
+    // A truncated string is not a range bound.
+    Index_Id_Type_Set_String(&lower_index_id, (uint8_t *)strings[element_num], sizeof(strings[element_num]));
+    Index_Id_Type_Set_String(&upper_index_id, (uint8_t *)strings[element_num], sizeof(strings[element_num]));
+    assert(Index_Id_Type_Is_String_Range_Bound(&lower_index_id) == false);
+    result = Index_Api_Search_Range(p_index_key, &lower_index_id, &upper_index_id, index_id_type, &result_length);
+    assert((result == NULL) && (result_length == 0));
+
+    // The range ending before the long strings is in a known order.
+    Index_Id_Type_Set_String(&lower_index_id, (uint8_t *)"key_099", 8);
+    Index_Id_Type_Set_String(&upper_index_id, (uint8_t *)"long_prefix", 12);
+    result = Index_Api_Search_Range(p_index_key, &lower_index_id, &upper_index_id, index_id_type, &result_length);
+    assert(result_length == 2);
+    Index_Api_Free_Search_Result(result);
+
+    // Empty range
+    Index_Id_Type_Set_String(&lower_index_id, (uint8_t *)"key_999", 8);
+    Index_Id_Type_Set_String(&upper_index_id, (uint8_t *)"key_050", 8);
+    result = Index_Api_Search_Range(p_index_key, &lower_index_id, &upper_index_id, index_id_type, &result_length);
+    assert((result == NULL) && (result_length == 0));
+    Index_Api_Close();
+
+    Index_Id_Type_Set_String(&index_id, (uint8_t *)strings[0], sizeof(strings[0]));
+    assert(Index_Id_Type_Is_String_Complete(&index_id));
+    Index_Id_Type_Set_String(&index_id, (uint8_t *)strings[element_num], sizeof(strings[element_num]));
+    assert(Index_Id_Type_Is_String_Complete(&index_id) == false);
+
+    test_end(case_name);
+}
+
+void test_hash_index()
+{
+    char case_name[] = "test_hash_index";
+    test_start(case_name);
+
+    char p_index_key[] = "test_hash_index";
+    char index_file_path[INDEX_FILE_PATH_BUFFER_LENGTH] = {0};
+    INDEX_ID_TYPE_E index_id_type = INDEX_ID_TYPE_UINT32;
+    const uint32_t element_num = 400, id_num = 150;
+    uint32_t missing_index_id = id_num, result_length = 0;
+    bool is_deleted[400] = {false};
+    INDEX_INFO_T index_info;
+    uint8_t *result = NULL;
+
+    Index_Api_Init(test_index_directory);
+    Index_Api_Set_Index_Structure(INDEX_STRUCTURE_HASH);
+    for (uint32_t i = 0; i < element_num; i++)
+    {
+        uint32_t index_id = (i * 13) % id_num;
+        Index_Api_Insert_Element(p_index_key, &index_id, index_id_type, &i, sizeof(uint32_t));
+    }
+    // The existed index file keeps its structure.
+    Index_Api_Set_Index_Structure(INDEX_STRUCTURE_BTREE);
+
+    // The buckets are split up to the limit, and the rest elements are in the overflow nodes.
+    index_info_init(&index_info);
+    get_test_index_file_path(index_file_path, p_index_key);
+    index_info.index_file = fopen(index_file_path, "rb");
+    assert(index_info.index_file != NULL);
+    read_index_properties(&index_info);
+    assert(index_info.index_properties.index_structure == INDEX_STRUCTURE_HASH);
+    assert(index_info.index_properties.index_id_type == index_id_type);
+    close_index_info(&index_info);
+
+    // Delete a third of the elements, then check the rest are returned by insertion order.
+    for (uint32_t round = 0; round < 2; round++)
+    {
+        for (uint32_t target = 0; target < id_num; target++)
+        {
+            uint32_t expected_length = 0;
+
+            result = Index_Api_Search_Equal(p_index_key, &target, index_id_type, &result_length);
+            for (uint32_t i = 0; i < element_num; i++)
+            {
+                if (((i * 13) % id_num == target) && (is_deleted[i] == false))
+                {
+                    assert(expected_length < result_length);
+                    assert(get_test_index_payload(result, expected_length) == i);
+                    expected_length++;
+                }
+            }
+            assert(result_length == expected_length);
+            Index_Api_Free_Search_Result(result);
+        }
+
+        for (uint32_t k = 0; (round == 0) && (k < element_num); k++)
+        {
+            uint32_t i = (k * 7) % element_num;
+            uint32_t index_id = (i * 13) % id_num;
+
+            if (i % 3 == 0)
+            {
+                assert(Index_Api_Delete_Element(p_index_key, &index_id, index_id_type, &i, sizeof(uint32_t)));
+                assert(Index_Api_Delete_Element(p_index_key, &index_id, index_id_type, &i, sizeof(uint32_t)) == false);
+                is_deleted[i] = true;
+            }
+        }
+    }
+
+    result = Index_Api_Search_Equal(p_index_key, &missing_index_id, index_id_type, &result_length);
+    assert((result == NULL) && (result_length == 0));
+    // A hash index doesn't support the range search.
+    result = Index_Api_Search_Range(p_index_key, NULL, NULL, index_id_type, &result_length);
+    assert((result == NULL) && (result_length == 0));
+    Index_Api_Close();
+
+    test_end(case_name);
+}
+
+void test_index_open_index_files()
+{
+    char case_name[] = "test_index_open_index_files";
+    test_start(case_name);
+
+    char *p_index_keys[] = {"test_open_index_file_a", "test_open_index_file_b", "test_open_index_file_c"};
+    INDEX_ID_TYPE_E index_id_type = INDEX_ID_TYPE_UINT32;
+    const uint32_t key_num = 3;
+    uint32_t element_num = 300;
+    uint32_t result_length = 0;
+    uint8_t *result = NULL;
+
+    Index_Api_Init(test_index_directory);
+    Index_Api_Set_Open_Index_File_Num(2);
+
+    // Alternate between two index keys, both index files stay open.
+    for (uint32_t i = 0; i < element_num; i++)
+    {
+        Index_Api_Insert_Element(p_index_keys[i % 2], &i, index_id_type, &i, sizeof(uint32_t));
+    }
+    assert(query_index_info_instance(p_index_keys[0], strlen(p_index_keys[0])) != NULL);
+    assert(query_index_info_instance(p_index_keys[1], strlen(p_index_keys[1])) != NULL);
+
+    // The least recently used index file is closed to open the third one.
+    Index_Api_Insert_Element(p_index_keys[2], &element_num, index_id_type, &element_num, sizeof(uint32_t));
+    assert(query_index_info_instance(p_index_keys[0], strlen(p_index_keys[0])) == NULL);
+    assert(query_index_info_instance(p_index_keys[1], strlen(p_index_keys[1])) != NULL);
+    assert(query_index_info_instance(p_index_keys[2], strlen(p_index_keys[2])) != NULL);
+
+    // Every index file is reopened once per round with a single open index file.
+    for (uint32_t open_index_file_num = 1; open_index_file_num <= key_num; open_index_file_num++)
+    {
+        Index_Api_Set_Open_Index_File_Num(open_index_file_num);
+        for (uint32_t i = 0; i < element_num; i++)
+        {
+            result = Index_Api_Search_Equal(p_index_keys[i % 2], &i, index_id_type, &result_length);
+            assert((result_length == 1) && (get_test_index_payload(result, 0) == i));
+            Index_Api_Free_Search_Result(result);
+
+            result = Index_Api_Search_Equal(p_index_keys[(i + 1) % 2], &i, index_id_type, &result_length);
+            assert((result == NULL) && (result_length == 0));
+        }
+        result = Index_Api_Search_Equal(p_index_keys[2], &element_num, index_id_type, &result_length);
+        assert((result_length == 1) && (get_test_index_payload(result, 0) == element_num));
+        Index_Api_Free_Search_Result(result);
+    }
+
+    Index_Api_Set_Open_Index_File_Num(INDEX_INFO_INSTANCE_NUM);
+    Index_Api_Close();
+
+    test_end(case_name);
+}
+
+void test_index_format_version()
+{
+    char case_name[] = "test_index_format_version";
+    test_start(case_name);
+
+    char index_key[] = "test_index_format_version";
+    char test_index_file_path[INDEX_FILE_PATH_BUFFER_LENGTH] = {0};
+    INDEX_ID_TYPE_E index_id_type = INDEX_ID_TYPE_UINT32;
+    uint32_t index_id = 7, old_format_version = INDEX_FILE_FORMAT_VERSION - 1;
+    uint32_t result_length = 0;
+    uint8_t *result = NULL;
+    FILE *p_index_file = NULL;
+
+    Index_Api_Init(test_index_directory);
+    Index_Api_Insert_Element(index_key, &index_id, index_id_type, &index_id, sizeof(uint32_t));
+    Index_Api_Close();
+
+    // Rewrite the format version as an older one.
+    get_test_index_file_path(test_index_file_path, index_key);
+    p_index_file = fopen(test_index_file_path, "rb+");
+    assert(p_index_file != NULL);
+    fseek(p_index_file, sizeof(uint32_t), SEEK_SET);
+    fwrite(&old_format_version, sizeof(old_format_version), 1, p_index_file);
+    fclose(p_index_file);
+
+    // The index file is not opened, the operations fail without changing it.
+    Index_Api_Init(test_index_directory);
+    assert(Index_Api_Get_Index_Id_Type(index_key) == INDEX_ID_TYPE_INVALID);
+    Index_Api_Insert_Element(index_key, &index_id, index_id_type, &index_id, sizeof(uint32_t));
+    result = Index_Api_Search_Equal(index_key, &index_id, index_id_type, &result_length);
+    assert((result == NULL) && (result_length == 0));
+    assert(Index_Api_Delete_Element(index_key, &index_id, index_id_type, &index_id, sizeof(uint32_t)) == false);
+    assert(query_index_info_instance(index_key, strlen(index_key)) == NULL);
+    Index_Api_Close();
+
+    test_end(case_name);
+}
+
+void test_index_write_buffer()
+{
+    char case_name[] = "test_index_write_buffer";
+    test_start(case_name);
+
+    char p_index_key[] = "test_index_write_buffer";
+    char write_buffer_file_path[INDEX_FILE_PATH_BUFFER_LENGTH] = {0};
+    INDEX_ID_TYPE_E index_id_type = INDEX_ID_TYPE_UINT32;
+    const uint32_t write_buffer_size = 4, element_num = 30, id_num = 3;
+    uint32_t result_length = 0, index_id = 0, payload = 0;
+    uint8_t *result = NULL;
+    INDEX_INFO_T *p_index_info = NULL;
+    struct stat file_stat;
+
+    Index_Api_Init(test_index_directory);
+    Index_Api_Set_Write_Buffer_Size(write_buffer_size);
+    get_index_write_buffer_file_path_by_index_key(write_buffer_file_path, p_index_key);
+
+    // The elements are buffered until the write buffer is full, the tree is still empty.
+    for (uint32_t i = 0; i < write_buffer_size; i++)
+    {
+        index_id = i % id_num;
+        Index_Api_Insert_Element(p_index_key, &index_id, index_id_type, &i, sizeof(uint32_t));
+    }
+    p_index_info = query_index_info_instance(p_index_key, strlen(p_index_key));
+    assert(p_index_info->index_write_buffer.length == write_buffer_size);
+    assert((stat(write_buffer_file_path, &file_stat) == 0) && (file_stat.st_size == write_buffer_size * (sizeof(uint32_t) + INDEX_PAYLOAD_SIZE)));
+    assert(p_index_info->index_properties.tag_num == 1);
+
+    // The next insertion merges the write buffer into the tree.
+    for (uint32_t i = write_buffer_size; i < element_num; i++)
+    {
+        index_id = i % id_num;
+        Index_Api_Insert_Element(p_index_key, &index_id, index_id_type, &i, sizeof(uint32_t));
+    }
+    assert(p_index_info->index_write_buffer.length == ((element_num - 1) % write_buffer_size) + 1);
+    assert(p_index_info->index_properties.tag_num > 1);
+
+    // The tree and the write buffer are searched together, the equal index ids are in insertion order.
+    for (index_id = 0; index_id < id_num; index_id++)
+    {
+        result = Index_Api_Search_Equal(p_index_key, &index_id, index_id_type, &result_length);
+        assert(result_length == element_num / id_num);
+        for (uint32_t i = 0; i < result_length; i++)
+        {
+            assert(get_test_index_payload(result, i) == index_id + (i * id_num));
+        }
+        Index_Api_Free_Search_Result(result);
+    }
+
+    result = Index_Api_Search_Range(p_index_key, NULL, NULL, index_id_type, &result_length);
+    assert(result_length == element_num);
+    for (uint32_t i = 0; i < result_length; i++)
+    {
+        assert(get_test_index_payload(result, i) == ((i % (element_num / id_num)) * id_num) + (i / (element_num / id_num)));
+    }
+    Index_Api_Free_Search_Result(result);
+
+    // Delete a buffered element and an element in the tree.
+    payload = element_num - 1;
+    index_id = payload % id_num;
+    assert(Index_Api_Delete_Element(p_index_key, &index_id, index_id_type, &payload, sizeof(uint32_t)));
+    assert(Index_Api_Delete_Element(p_index_key, &index_id, index_id_type, &payload, sizeof(uint32_t)) == false);
+    payload = 0;
+    index_id = 0;
+    assert(Index_Api_Delete_Element(p_index_key, &index_id, index_id_type, &payload, sizeof(uint32_t)));
+    assert(p_index_info->index_write_buffer.length == ((element_num - 1) % write_buffer_size));
+
+    // The buffered elements are loaded from the write buffer file after reopening.
+    Index_Api_Close();
+    Index_Api_Init(test_index_directory);
+    for (index_id = 0; index_id < id_num; index_id++)
+    {
+        result = Index_Api_Search_Equal(p_index_key, &index_id, index_id_type, &result_length);
+        assert(result_length == (element_num / id_num) - ((index_id == 0) || (index_id == (element_num - 1) % id_num)));
+        Index_Api_Free_Search_Result(result);
+    }
+
+    // Inserting into the tree directly merges the elements left in the write buffer first.
+    Index_Api_Set_Write_Buffer_Size(0);
+    payload = element_num;
+    Index_Api_Insert_Element(p_index_key, &index_id, index_id_type, &payload, sizeof(uint32_t));
+    p_index_info = query_index_info_instance(p_index_key, strlen(p_index_key));
+    assert(p_index_info->index_write_buffer.length == 0);
+    assert((stat(write_buffer_file_path, &file_stat) == 0) && (file_stat.st_size == 0));
+    result = Index_Api_Search_Range(p_index_key, NULL, NULL, index_id_type, &result_length);
+    assert((result_length == element_num - 1) && (get_test_index_payload(result, result_length - 1) == element_num));
+    Index_Api_Free_Search_Result(result);
+
+    Index_Api_Set_Write_Buffer_Size(INDEX_WRITE_BUFFER_ELEMENT_NUM);
+    Index_Api_Close();
+
+    test_end(case_name);
+}
+
+void test_index_node_size()
+{
+    char case_name[] = "test_index_node_size";
+    test_start(case_name);
+
+    char p_index_key[] = "test_index_node_size";
+    INDEX_ID_TYPE_E index_id_type = INDEX_ID_TYPE_UINT32;
+    const uint32_t node_size = 512;
+    uint32_t element_num = 1000;
+    uint32_t result_length = 0;
+    uint8_t *result = NULL;
+    INDEX_INFO_T *p_index_info = NULL;
+
+    // The orders are derived from the node size instead of INDEX_ORDER.
+    Index_Api_Init(test_index_directory);
+    Index_Api_Set_Node_Size(node_size);
+    for (uint32_t i = 0; i < element_num; i++)
+    {
+        Index_Api_Insert_Element(p_index_key, &i, index_id_type, &i, sizeof(uint32_t));
+    }
+
+    // A leaf node holds (4 + 8) bytes elements and a non-leaf node holds 4 bytes separators after the node header and child tags.
+    p_index_info = query_index_info_instance(p_index_key, strlen(p_index_key));
+    assert(p_index_info->index_properties.node_size == node_size);
+    assert(p_index_info->index_properties.order == 30);
+    assert(p_index_info->index_properties.internal_order == 60);
+    assert(p_index_info->index_properties.tag_num > 1);
+
+    // The orders are read from the index file after reopening, the node size of the new index files doesn't change them.
+    Index_Api_Close();
+    Index_Api_Init(test_index_directory);
+    Index_Api_Set_Node_Size(0);
+    result = Index_Api_Search_Range(p_index_key, NULL, NULL, index_id_type, &result_length);
+    assert(result_length == element_num);
+    for (uint32_t i = 0; i < result_length; i++)
+    {
+        assert(get_test_index_payload(result, i) == i);
+    }
+    Index_Api_Free_Search_Result(result);
+
+    p_index_info = query_index_info_instance(p_index_key, strlen(p_index_key));
+    assert(p_index_info->index_properties.node_size == node_size);
+    assert(p_index_info->index_properties.order == 30);
+    assert(p_index_info->index_properties.internal_order == 60);
+
+    // Insert after reopening, the new nodes have the same layout.
+    Index_Api_Insert_Element(p_index_key, &element_num, index_id_type, &element_num, sizeof(uint32_t));
+    result = Index_Api_Search_Equal(p_index_key, &element_num, index_id_type, &result_length);
+    assert((result_length == 1) && (get_test_index_payload(result, 0) == element_num));
+    Index_Api_Free_Search_Result(result);
+
+    // The node size is limited to the range, the new index files take the nearest bound.
+    Index_Api_Set_Node_Size(1);
+    assert(atomic_load(&index_node_size) == INDEX_MIN_NODE_SIZE);
+    Index_Api_Set_Node_Size(UINT32_MAX);
+    assert(atomic_load(&index_node_size) == INDEX_MAX_NODE_SIZE);
+    Index_Api_Set_Node_Size(0);
+
+    Index_Api_Close();
+
+    test_end(case_name);
+}
+
+void test_index_separator_node()
+{
+    char case_name[] = "test_index_separator_node";
+    test_start(case_name);
+
+    char p_index_key[] = "test_index_separator_node";
+    INDEX_ID_TYPE_E index_id_type = INDEX_ID_TYPE_UINT32;
+    const uint32_t element_num = 60;
+    uint32_t result_length = 0, child_tag = 0;
+    uint8_t *result = NULL;
+    INDEX_INFO_T *p_index_info = NULL;
+    INDEX_NODE_T *p_index_node = NULL;
+
+    Index_Api_Init(test_index_directory);
+    for (uint32_t i = 0; i < element_num; i++)
+    {
+        Index_Api_Insert_Element(p_index_key, &i, index_id_type, &i, sizeof(uint32_t));
+    }
+
+    // The new B+ tree index file stores the separator index ids only in the non-leaf nodes, told by internal_order instead of a format flag.
+    p_index_info = query_index_info_instance(p_index_key, strlen(p_index_key));
+    assert(p_index_info->index_properties.index_format_32 == (((uint32_t)INDEX_STRUCTURE_BTREE << INDEX_FORMAT_STRUCTURE_SHIFT) | index_id_type));
+    assert(p_index_info->index_properties.internal_order == INDEX_ORDER);
+
+    p_index_node = fetch_index_node(p_index_info, p_index_info->index_properties.root_tag);
+    while (p_index_node->level > 0)
+    {
+        assert((p_index_node->p_payloads == NULL) && (p_index_node->order == p_index_info->index_properties.internal_order));
+        child_tag = p_index_node->child_tag[0];
+        release_index_node(p_index_info, p_index_node);
+        p_index_node = fetch_index_node(p_index_info, child_tag);
+    }
+    assert(p_index_node->p_payloads != NULL);
+    assert((get_test_index_payload(p_index_node->p_payloads, 0) == 0) && (p_index_node->next_tag != 0));
+    release_index_node(p_index_info, p_index_node);
+
+    // Merge and borrow the non-leaf nodes by deleting the odd index ids.
+    for (uint32_t i = 1; i < element_num; i += 2)
+    {
+        assert(Index_Api_Delete_Element(p_index_key, &i, index_id_type, &i, sizeof(uint32_t)));
+    }
+
+    // The layout is decided by the index file after reopening.
+    Index_Api_Close();
+    Index_Api_Init(test_index_directory);
+    result = Index_Api_Search_Range(p_index_key, NULL, NULL, index_id_type, &result_length);
+    assert(result_length == element_num / 2);
+    for (uint32_t i = 0; i < result_length; i++)
+    {
+        assert(get_test_index_payload(result, i) == i * 2);
+    }
+    Index_Api_Free_Search_Result(result);
+    p_index_info = query_index_info_instance(p_index_key, strlen(p_index_key));
+    assert(p_index_info->index_properties.internal_order == INDEX_ORDER);
+
+    Index_Api_Close();
+
+    test_end(case_name);
+}
+
+void test_index_prefix_compression()
+{
+    char case_name[] = "test_index_prefix_compression";
+    test_start(case_name);
+
+    char p_index_key[] = "test_index_prefix_compression";
+    INDEX_ID_TYPE_E index_id_type = INDEX_ID_TYPE_STRING;
+    const uint32_t node_size = 512, element_num = 1000;
+    char string[INDEX_ID_STRING_PREFIX_SIZE] = {0};
+    INDEX_ID_STRING_T index_id;
+    uint32_t result_length = 0, max_leaf_length = 0;
+    uint8_t *result = NULL;
+    INDEX_INFO_T *p_index_info = NULL;
+    INDEX_PROPERTIES_T *p_index_properties = NULL;
+
+    // The clustered strings share the leading bytes, they are inserted out of order.
+    Index_Api_Init(test_index_directory);
+    Index_Api_Set_Node_Size(node_size);
+    for (uint32_t i = 0; i < element_num; i++)
+    {
+        uint32_t value = (i * 37) % element_num;
+
+        sprintf(string, "compressed_key_%05u", value);
+        Index_Id_Type_Set_String(&index_id, (uint8_t *)string, sizeof(string));
+        Index_Api_Insert_Element(p_index_key, &index_id, index_id_type, &value, sizeof(uint32_t));
+    }
+
+    // The compressed nodes hold more elements than the orders, which fit whatever the index ids are.
+    p_index_info = query_index_info_instance(p_index_key, strlen(p_index_key));
+    p_index_properties = &(p_index_info->index_properties);
+    assert(p_index_properties->compressed_order > p_index_properties->order);
+    assert(p_index_properties->compressed_internal_order > p_index_properties->internal_order);
+    for (uint32_t tag = 1; tag <= p_index_properties->tag_num; tag++)
+    {
+        INDEX_NODE_T *p_index_node = fetch_index_node(p_index_info, tag);
+
+        if (p_index_node->level == 0)
+        {
+            max_leaf_length = (p_index_node->length > max_leaf_length) ? (p_index_node->length) : (max_leaf_length);
+        }
+        else
+        {
+            // The separators are truncated after the first byte differing from the left elements, the hash bytes are dropped.
+            for (uint32_t i = 0; i < p_index_node->length; i++)
+            {
+                assert(((INDEX_ID_STRING_T *)get_index_node_index_id(p_index_node, i))->hash_value == 0);
+            }
+        }
+        release_index_node(p_index_info, p_index_node);
+    }
+    assert(max_leaf_length > p_index_properties->order);
+
+    // The nodes are decoded when they are read after reopening.
+    Index_Api_Close();
+    Index_Api_Init(test_index_directory);
+    Index_Api_Set_Node_Size(0);
+    for (uint32_t i = 0; i < element_num; i++)
+    {
+        sprintf(string, "compressed_key_%05u", i);
+        Index_Id_Type_Set_String(&index_id, (uint8_t *)string, sizeof(string));
+        result = Index_Api_Search_Equal(p_index_key, &index_id, index_id_type, &result_length);
+        assert((result_length == 1) && (get_test_index_payload(result, 0) == i));
+        Index_Api_Free_Search_Result(result);
+    }
+    result = Index_Api_Search_Range(p_index_key, NULL, NULL, index_id_type, &result_length);
+    assert(result_length == element_num);
+    for (uint32_t i = 0; i < result_length; i++)
+    {
+        assert(get_test_index_payload(result, i) == i);
+    }
+    Index_Api_Free_Search_Result(result);
+
+    // Borrow and merge the compressed nodes.
+    for (uint32_t i = 0; i < element_num; i++)
+    {
+        if (i % 10 != 0)
+        {
+            sprintf(string, "compressed_key_%05u", i);
+            Index_Id_Type_Set_String(&index_id, (uint8_t *)string, sizeof(string));
+            assert(Index_Api_Delete_Element(p_index_key, &index_id, index_id_type, &i, sizeof(uint32_t)));
+        }
+    }
+    Index_Api_Close();
+
+    Index_Api_Init(test_index_directory);
+    result = Index_Api_Search_Range(p_index_key, NULL, NULL, index_id_type, &result_length);
+    assert(result_length == element_num / 10);
+    for (uint32_t i = 0; i < result_length; i++)
+    {
+        assert(get_test_index_payload(result, i) == i * 10);
+    }
+    Index_Api_Free_Search_Result(result);
+    Index_Api_Close();
+
+    test_end(case_name);
+}
+
+void test_index_posting_list()
+{
+    char case_name[] = "test_index_posting_list";
+    test_start(case_name);
+
+    char p_index_key[] = "test_index_posting_list";
+    char p_bulk_index_key[] = "test_index_posting_list_bulk";
+    INDEX_ID_TYPE_E index_id_type = INDEX_ID_TYPE_UINT32;
+    const uint32_t min_length = 4, element_num = 150, id_num = 3, unique_id_start = 1000, unique_id_num = 30, bulk_run_num = 100;
+    uint32_t result_length = 0, index_id = 0, payload = 0, posting_tag = 0;
+    uint32_t bulk_index_ids[element_num], bulk_payloads[element_num];
+    uint8_t *result = NULL;
+    INDEX_INFO_T *p_index_info = NULL;
+    INDEX_NODE_T *p_index_node = NULL;
+
+    Index_Api_Init(test_index_directory);
+    Index_Api_Set_Posting_List_Min_Length(min_length);
+
+    // Low cardinality index ids with unique index ids between them.
+    for (uint32_t i = 0; i < element_num; i++)
+    {
+        index_id = i % id_num;
+        Index_Api_Insert_Element(p_index_key, &index_id, index_id_type, &i, sizeof(uint32_t));
+        if (i < unique_id_num)
+        {
+            index_id = unique_id_start + i;
+            Index_Api_Insert_Element(p_index_key, &index_id, index_id_type, &index_id, sizeof(uint32_t));
+        }
+    }
+
+    // The equal index ids are returned by insertion order.
+    for (index_id = 0; index_id < id_num; index_id++)
+    {
+        result = Index_Api_Search_Equal(p_index_key, &index_id, index_id_type, &result_length);
+        assert(result_length == element_num / id_num);
+        for (uint32_t i = 0; i < result_length; i++)
+        {
+            assert(get_test_index_payload(result, i) == index_id + (i * id_num));
+        }
+        Index_Api_Free_Search_Result(result);
+    }
+
+    // The payloads of the first index id are in the posting list of the first leaf element, more of them are held by a posting node than a leaf node.
+    p_index_info = query_index_info_instance(p_index_key, strlen(p_index_key));
+    p_index_node = fetch_index_node(p_index_info, p_index_info->index_properties.root_tag);
+    while (p_index_node->level > 0)
+    {
+        uint32_t child_tag = p_index_node->child_tag[0];
+        release_index_node(p_index_info, p_index_node);
+        p_index_node = fetch_index_node(p_index_info, child_tag);
+    }
+    assert(p_index_node->child_tag[0] == 0);
+    posting_tag = get_index_node_posting_tag(p_index_node, 0);
+    release_index_node(p_index_info, p_index_node);
+    assert(posting_tag != 0);
+    p_index_node = fetch_index_node(p_index_info, posting_tag);
+    assert((p_index_node->level == INDEX_POSTING_LIST_LEVEL) && (p_index_node->length > INDEX_ORDER));
+    release_index_node(p_index_info, p_index_node);
+
+    // The range search expands the posting lists.
+    result = Index_Api_Search_Range(p_index_key, NULL, NULL, index_id_type, &result_length);
+    assert(result_length == element_num + unique_id_num);
+    for (uint32_t i = 0; i < element_num; i++)
+    {
+        assert(get_test_index_payload(result, i) == ((i % (element_num / id_num)) * id_num) + (i / (element_num / id_num)));
+    }
+    for (uint32_t i = 0; i < unique_id_num; i++)
+    {
+        assert(get_test_index_payload(result, element_num + i) == unique_id_start + i);
+    }
+    Index_Api_Free_Search_Result(result);
+
+    // Delete the payloads from the posting lists, the index id is removed with its last payload.
+    index_id = 1;
+    for (payload = index_id; payload < element_num; payload += id_num * 2)
+    {
+        assert(Index_Api_Delete_Element(p_index_key, &index_id, index_id_type, &payload, sizeof(uint32_t)));
+    }
+    assert(Index_Api_Delete_Element(p_index_key, &index_id, index_id_type, &(uint32_t){index_id}, sizeof(uint32_t)) == false);
+    index_id = 2;
+    for (payload = index_id; payload < element_num; payload += id_num)
+    {
+        assert(Index_Api_Delete_Element(p_index_key, &index_id, index_id_type, &payload, sizeof(uint32_t)));
+    }
+
+    // The posting lists are read from the index file after reopening.
+    Index_Api_Close();
+    Index_Api_Init(test_index_directory);
+    index_id = 1;
+    result = Index_Api_Search_Equal(p_index_key, &index_id, index_id_type, &result_length);
+    assert(result_length == element_num / id_num / 2);
+    for (uint32_t i = 0; i < result_length; i++)
+    {
+        assert(get_test_index_payload(result, i) == index_id + id_num + (i * id_num * 2));
+    }
+    Index_Api_Free_Search_Result(result);
+    index_id = 2;
+    result = Index_Api_Search_Equal(p_index_key, &index_id, index_id_type, &result_length);
+    assert((result_length == 0) && (result == NULL));
+    result = Index_Api_Search_Range(p_index_key, NULL, NULL, index_id_type, &result_length);
+    assert(result_length == (element_num / id_num) + (element_num / id_num / 2) + unique_id_num);
+    Index_Api_Free_Search_Result(result);
+
+    // The bulk build gathers the runs into the posting lists, the short runs stay as elements.
+    for (uint32_t i = 0; i < bulk_run_num + (min_length - 1); i++)
+    {
+        bulk_index_ids[i] = (i < bulk_run_num) ? (i % 2) : (unique_id_start);
+        bulk_payloads[i] = i;
+    }
+    Index_Api_Bulk_Build(p_bulk_index_key, index_id_type, bulk_index_ids, bulk_payloads, sizeof(uint32_t), bulk_run_num + (min_length - 1));
+    for (index_id = 0; index_id < 2; index_id++)
+    {
+        result = Index_Api_Search_Equal(p_bulk_index_key, &index_id, index_id_type, &result_length);
+        assert(result_length == bulk_run_num / 2);
+        for (uint32_t i = 0; i < result_length; i++)
+        {
+            assert(get_test_index_payload(result, i) == index_id + (i * 2));
+        }
+        Index_Api_Free_Search_Result(result);
+    }
+    result = Index_Api_Search_Range(p_bulk_index_key, NULL, NULL, index_id_type, &result_length);
+    assert(result_length == bulk_run_num + (min_length - 1));
+    for (uint32_t i = 0; i < min_length - 1; i++)
+    {
+        assert(get_test_index_payload(result, bulk_run_num + i) == bulk_run_num + i);
+    }
+    Index_Api_Free_Search_Result(result);
+    p_index_info = query_index_info_instance(p_bulk_index_key, strlen(p_bulk_index_key));
+    p_index_node = fetch_index_node(p_index_info, 1);
+    assert((p_index_node->level == 0) && (get_index_node_posting_tag(p_index_node, 0) != 0));
+    release_index_node(p_index_info, p_index_node);
+
+    Index_Api_Set_Posting_List_Min_Length(INDEX_POSTING_LIST_MIN_LENGTH);
+    Index_Api_Close();
+
+    test_end(case_name);
+}
+
+void test_index_statistics()
+{
+    char case_name[] = "test_index_statistics";
+    test_start(case_name);
+
+    char p_index_key[] = "test_index_statistics";
+    char p_hash_index_key[] = "test_index_statistics_hash";
+    char p_missing_index_key[] = "test_index_statistics_missing";
+    INDEX_ID_TYPE_E index_id_type = INDEX_ID_TYPE_UINT32;
+    const uint32_t heavy_id_num = 600, unique_id_start = 1000, unique_id_num = 400, added_num = 200, hash_element_num = 300, hash_id_num = 30;
+    uint32_t index_id = 0, lower_index_id = 0, upper_index_id = 0;
+    uint64_t estimated_num = 0;
+    INDEX_STATISTICS_T index_statistics;
+
+    Index_Api_Init(test_index_directory);
+    Index_Api_Set_Posting_List_Min_Length(4);
+
+    // A heavy index id in a posting list and the unique index ids after it.
+    for (uint32_t i = 0; i < heavy_id_num; i++)
+    {
+        index_id = 0;
+        Index_Api_Insert_Element(p_index_key, &index_id, index_id_type, &i, sizeof(uint32_t));
+        if (i < unique_id_num)
+        {
+            index_id = unique_id_start + i;
+            Index_Api_Insert_Element(p_index_key, &index_id, index_id_type, &i, sizeof(uint32_t));
+        }
+    }
+
+    assert(Index_Api_Get_Statistics(p_index_key, index_id_type, &index_statistics));
+    assert(index_statistics.element_num == heavy_id_num + unique_id_num);
+    assert(index_statistics.distinct_num == 1 + unique_id_num);
+    assert((index_statistics.histogram_bucket_num > 1) && (index_statistics.histogram_bucket_num <= INDEX_STATISTICS_HISTOGRAM_BUCKET_NUM));
+
+    // The heavy index id covers most of the buckets, each unique index id shares a bucket with the others.
+    index_id = 0;
+    estimated_num = Index_Api_Estimate_Range(p_index_key, &index_id, &index_id, index_id_type);
+    assert((estimated_num >= heavy_id_num * 8 / 10) && (estimated_num <= heavy_id_num * 12 / 10));
+    index_id = unique_id_start + (unique_id_num / 2);
+    estimated_num = Index_Api_Estimate_Range(p_index_key, &index_id, &index_id, index_id_type);
+    assert(estimated_num <= unique_id_num / 10);
+    lower_index_id = unique_id_start;
+    upper_index_id = unique_id_start + unique_id_num - 1;
+    estimated_num = Index_Api_Estimate_Range(p_index_key, &lower_index_id, &upper_index_id, index_id_type);
+    assert((estimated_num >= unique_id_num * 8 / 10) && (estimated_num <= unique_id_num * 12 / 10));
+    assert(Index_Api_Estimate_Range(p_index_key, NULL, NULL, index_id_type) == heavy_id_num + unique_id_num);
+    upper_index_id = unique_id_start + unique_id_num;
+    assert(Index_Api_Estimate_Range(p_index_key, &upper_index_id, NULL, index_id_type) == 0);
+
+    // The statistics are collected again after enough elements are inserted.
+    for (uint32_t i = 0; i < added_num; i++)
+    {
+        index_id = unique_id_start + unique_id_num;
+        Index_Api_Insert_Element(p_index_key, &index_id, index_id_type, &i, sizeof(uint32_t));
+    }
+    assert(Index_Api_Get_Statistics(p_index_key, index_id_type, &index_statistics));
+    assert(index_statistics.element_num == heavy_id_num + unique_id_num + added_num);
+    assert(index_statistics.distinct_num == 2 + unique_id_num);
+
+    // A hash index estimates the equal search by the average elements per index id.
+    Index_Api_Set_Index_Structure(INDEX_STRUCTURE_HASH);
+    for (uint32_t i = 0; i < hash_element_num; i++)
+    {
+        index_id = i % hash_id_num;
+        Index_Api_Insert_Element(p_hash_index_key, &index_id, index_id_type, &i, sizeof(uint32_t));
+    }
+    Index_Api_Set_Index_Structure(INDEX_STRUCTURE_BTREE);
+    assert(Index_Api_Get_Statistics(p_hash_index_key, index_id_type, &index_statistics));
+    assert((index_statistics.element_num == hash_element_num) && (index_statistics.distinct_num == hash_id_num) && (index_statistics.histogram_bucket_num == 0));
+    index_id = 0;
+    assert(Index_Api_Estimate_Range(p_hash_index_key, &index_id, &index_id, index_id_type) == hash_element_num / hash_id_num);
+    assert(Index_Api_Estimate_Range(p_hash_index_key, NULL, NULL, index_id_type) == 0);
+
+    assert(Index_Api_Get_Statistics(p_missing_index_key, index_id_type, &index_statistics) == false);
+    assert(Index_Api_Estimate_Range(p_missing_index_key, NULL, NULL, index_id_type) == 0);
+
+    Index_Api_Set_Posting_List_Min_Length(INDEX_POSTING_LIST_MIN_LENGTH);
+    Index_Api_Close();
+
+    test_end(case_name);
+}
+
+#define TEST_LATCH_ELEMENT_NUM (1000)
+#define TEST_LATCH_READER_NUM (3)
+
+char test_latch_index_key[] = "test_index_latch";
+
+// Insert the odd index ids while the readers search the even ones.
+void *test_index_latch_writer(void *p_arg)
+{
+    for (uint32_t i = 1; i < TEST_LATCH_ELEMENT_NUM; i += 2)
+    {
+        Index_Api_Insert_Element(test_latch_index_key, &i, INDEX_ID_TYPE_UINT32, &i, sizeof(uint32_t));
+    }
+
+    return NULL;
+}
+
+void *test_index_latch_reader(void *p_arg)
+{
+    uint32_t lower_index_id = 0, upper_index_id = TEST_LATCH_ELEMENT_NUM, result_length = 0;
+    uint8_t *result = NULL;
+
+    for (uint32_t round = 0; round < 3; round++)
+    {
+        for (uint32_t i = 0; i < TEST_LATCH_ELEMENT_NUM; i += 2)
+        {
+            result = Index_Api_Search_Equal(test_latch_index_key, &i, INDEX_ID_TYPE_UINT32, &result_length);
+            assert((result_length == 1) && (get_test_index_payload(result, 0) == i));
+            Index_Api_Free_Search_Result(result);
+        }
+
+        // The even index ids are always returned, the odd ones inserted so far are between them.
+        result = Index_Api_Search_Range(test_latch_index_key, &lower_index_id, &upper_index_id, INDEX_ID_TYPE_UINT32, &result_length);
+        assert((result_length >= TEST_LATCH_ELEMENT_NUM / 2) && (result_length <= TEST_LATCH_ELEMENT_NUM));
+        for (uint32_t i = 1; i < result_length; i++)
+        {
+            assert(get_test_index_payload(result, i - 1) < get_test_index_payload(result, i));
+        }
+        Index_Api_Free_Search_Result(result);
+    }
+
+    return NULL;
+}
+
+void test_index_latch_concurrency()
+{
+    char case_name[] = "test_index_latch_concurrency";
+    test_start(case_name);
+
+    pthread_t writer_thread, reader_threads[TEST_LATCH_READER_NUM];
+    uint32_t result_length = 0;
+    uint8_t *result = NULL;
+
+    Index_Api_Init(test_index_directory);
+    for (uint32_t i = 0; i < TEST_LATCH_ELEMENT_NUM; i += 2)
+    {
+        Index_Api_Insert_Element(test_latch_index_key, &i, INDEX_ID_TYPE_UINT32, &i, sizeof(uint32_t));
+    }
+
+    pthread_create(&writer_thread, NULL, test_index_latch_writer, NULL);
+    for (uint32_t i = 0; i < TEST_LATCH_READER_NUM; i++)
+    {
+        pthread_create(&reader_threads[i], NULL, test_index_latch_reader, NULL);
+    }
+    pthread_join(writer_thread, NULL);
+    for (uint32_t i = 0; i < TEST_LATCH_READER_NUM; i++)
+    {
+        pthread_join(reader_threads[i], NULL);
+    }
+
+    for (uint32_t i = 0; i < TEST_LATCH_ELEMENT_NUM; i++)
+    {
+        result = Index_Api_Search_Equal(test_latch_index_key, &i, INDEX_ID_TYPE_UINT32, &result_length);
+        assert((result_length == 1) && (get_test_index_payload(result, 0) == i));
+        Index_Api_Free_Search_Result(result);
+    }
+    // No reader or writer is left.
+    assert(check_index_info_status(query_index_info_instance(test_latch_index_key, strlen(test_latch_index_key)), INDEX_INFO_STATUS_READY));
+    Index_Api_Close();
+
+    test_end(case_name);
+}
+
 int main()
 {
     test_index_init_and_close();
@@ -464,6 +1726,21 @@ int main()
     test_index_key_exists();
     test_index_search_case1();
     test_index_search_case11();
+    test_index_search_duplicated_ids();
+    test_index_id_search_lower_bound();
+    test_index_bulk_build();
+    test_index_delete_element();
+    test_index_search_range();
+    test_hash_index();
+    test_index_open_index_files();
+    test_index_format_version();
+    test_index_latch_concurrency();
+    test_index_write_buffer();
+    test_index_node_size();
+    test_index_separator_node();
+    test_index_prefix_compression();
+    test_index_posting_list();
+    test_index_statistics();
 
     return 0;
 }
@@ -1,9 +1,20 @@
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "hash.h"
 
+// Seed and secrets of the 64-bit hash, odd 64-bit constants with balanced bits.
+#define HASH64_SEED (0x5d7a3c1e9b28f46dULL)
+static const uint64_t hash64_secret[4] = {0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL};
+
 HASH_VALUE_T djb_hash(uint8_t *p_str, uint32_t length);
+HASH64_VALUE_T word_hash64(uint8_t *p_str, uint32_t length, uint64_t seed);
+static inline void hash64_multiply(uint64_t *p_low, uint64_t *p_high);
+static inline uint64_t hash64_mix(uint64_t value1, uint64_t value2);
+static inline uint64_t hash64_read_64(uint8_t *p_str);
+static inline uint64_t hash64_read_32(uint8_t *p_str);
+static inline uint64_t hash64_read_small(uint8_t *p_str, uint32_t length);
 
 
 HASH_VALUE_T Hash(uint8_t *p_str, uint32_t length)
@@ -11,6 +22,11 @@ HASH_VALUE_T Hash(uint8_t *p_str, uint32_t length)
     return djb_hash(p_str, length);
 }
 
+HASH64_VALUE_T Hash64(uint8_t *p_str, uint32_t length)
+{
+    return word_hash64(p_str, length, HASH64_SEED);
+}
+
 HASH_VALUE_T djb_hash(uint8_t *p_str, uint32_t length)
 {
     HASH_VALUE_T hash_value = 5381;
@@ -39,3 +55,117 @@ HASH_VALUE_COMPARE_RESULT_E Hash_Api_Compare(HASH_VALUE_T val1, HASH_VALUE_T val
         return HASH_VALUE_COMPARE_EQUAL;
     }
 }
+
+// Multiply-mix hash in the wyhash style: 16 bytes are consumed by one 64x64->128 bit multiplication,
+// and inputs of 48 bytes or more are hashed by three independent lanes.
+HASH64_VALUE_T word_hash64(uint8_t *p_str, uint32_t length, uint64_t seed)
+{
+    uint64_t value1 = 0, value2 = 0;
+
+    seed ^= hash64_mix(seed ^ hash64_secret[0], hash64_secret[1]);
+
+    if (length <= 16)
+    {
+        if (length >= 4)
+        {
+            // Two overlapped 4-byte reads from both ends cover [4, 16] bytes.
+            uint32_t offset = (length >> 3) << 2;
+            value1 = (hash64_read_32(p_str) << 32) | hash64_read_32(p_str + offset);
+            value2 = (hash64_read_32(p_str + length - 4) << 32) | hash64_read_32(p_str + length - 4 - offset);
+        }
+        else if (length > 0)
+        {
+            value1 = hash64_read_small(p_str, length);
+        }
+    }
+    else
+    {
+        uint32_t remaining_length = length;
+
+        if (remaining_length >= 48)
+        {
+            uint64_t seed1 = seed, seed2 = seed;
+
+            do
+            {
+                seed = hash64_mix(hash64_read_64(p_str) ^ hash64_secret[1], hash64_read_64(p_str + 8) ^ seed);
+                seed1 = hash64_mix(hash64_read_64(p_str + 16) ^ hash64_secret[2], hash64_read_64(p_str + 24) ^ seed1);
+                seed2 = hash64_mix(hash64_read_64(p_str + 32) ^ hash64_secret[3], hash64_read_64(p_str + 40) ^ seed2);
+                p_str += 48;
+                remaining_length -= 48;
+            } while (remaining_length >= 48);
+
+            seed ^= seed1 ^ seed2;
+        }
+
+        while (remaining_length > 16)
+        {
+            seed = hash64_mix(hash64_read_64(p_str) ^ hash64_secret[1], hash64_read_64(p_str + 8) ^ seed);
+            p_str += 16;
+            remaining_length -= 16;
+        }
+
+        // The last 16 bytes, overlapped with the hashed ones if remaining_length < 16.
+        value1 = hash64_read_64(p_str + remaining_length - 16);
+        value2 = hash64_read_64(p_str + remaining_length - 8);
+    }
+
+    value1 ^= hash64_secret[1];
+    value2 ^= seed;
+    hash64_multiply(&value1, &value2);
+
+    return hash64_mix(value1 ^ hash64_secret[0] ^ length, value2 ^ hash64_secret[1]);
+}
+
+// 128-bit product of *p_low and *p_high, the low half is written to *p_low and the high half to *p_high.
+static inline void hash64_multiply(uint64_t *p_low, uint64_t *p_high)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t product = (__uint128_t)(*p_low) * (*p_high);
+
+    *p_low = (uint64_t)product;
+    *p_high = (uint64_t)(product >> 64);
+#else
+    uint64_t a_high = *p_low >> 32, a_low = (uint32_t)(*p_low), b_high = *p_high >> 32, b_low = (uint32_t)(*p_high);
+    uint64_t high_high = a_high * b_high, high_low = a_high * b_low, low_high = a_low * b_high, low_low = a_low * b_low;
+    uint64_t middle = high_low + (low_low >> 32) + (uint32_t)low_high;
+
+    *p_low = (middle << 32) | (uint32_t)low_low;
+    *p_high = high_high + (middle >> 32) + (low_high >> 32);
+#endif
+}
+
+static inline uint64_t hash64_mix(uint64_t value1, uint64_t value2)
+{
+    hash64_multiply(&value1, &value2);
+    return value1 ^ value2;
+}
+
+// Words are read in little-endian order, so the hash values are the same on every platform.
+static inline uint64_t hash64_read_64(uint8_t *p_str)
+{
+    uint64_t value = 0;
+
+    memcpy(&value, p_str, sizeof(value));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+static inline uint64_t hash64_read_32(uint8_t *p_str)
+{
+    uint32_t value = 0;
+
+    memcpy(&value, p_str, sizeof(value));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    value = __builtin_bswap32(value);
+#endif
+    return value;
+}
+
+// 1 ~ 3 bytes
+static inline uint64_t hash64_read_small(uint8_t *p_str, uint32_t length)
+{
+    return ((uint64_t)p_str[0] << 16) | ((uint64_t)p_str[length >> 1] << 8) | (uint64_t)p_str[length - 1];
+}